@@ -30,7 +30,9 @@
 #include <TObjArray.h>
 #include <TRandom.h>
 #include <TVector3.h>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <list>
 #include <vector>
 
@@ -54,17 +56,23 @@ void R3BCalifaCrystalCal2Cluster::SetRectangularWindow(Float_t thetaL, Float_t p
 
     fThetaLimit = thetaL;
     fPhiLimit = phiL;
+    fNeighboursOutdated = kTRUE;
 };
 
 void R3BCalifaCrystalCal2Cluster::SetRoundWindow(Double_t window)
 {
     fWindowAlg = "Round";
     fRoundWindow = window;
+    fNeighboursOutdated = kTRUE;
 };
 
 bool compareByEnergy(R3BCalifaCrystalCalData* a, R3BCalifaCrystalCalData* b) { return a->GetEnergy() > b->GetEnergy(); }
 
-bool isInside(vector<uint16_t>& vec, Int_t cryId) { return find(vec.begin(), vec.end(), cryId) != vec.end(); }
+// usedFlags holds one flag per uint16_t crystal ID, i.e. it contains the same IDs as the list of used crystals
+bool isInside(const vector<bool>& usedFlags, Int_t cryId)
+{
+    return cryId >= 0 && cryId < static_cast<Int_t>(usedFlags.size()) && usedFlags[cryId];
+}
 
 bool R3BCalifaCrystalCal2Cluster::InsideClusterWindow(TVector3 mother, TVector3 crystal)
 {
@@ -79,50 +87,98 @@ bool R3BCalifaCrystalCal2Cluster::InsideClusterWindow(TVector3 mother, TVector3
         return 0;
 }
 
-void RemoveUsedCrystals(vector<uint16_t>& used,
-                        vector<R3BCalifaCrystalCalData*>& all,
-                        vector<R3BCalifaCrystalCalData*>& proton,
-                        vector<R3BCalifaCrystalCalData*>& gamma,
-                        vector<R3BCalifaCrystalCalData*>& saturated)
+// Index into the crystal angle table, with the same treatment of double reading channels and invalid IDs as in
+// R3BCalifaGeometry::GetAngles(). Returns -1 for invalid IDs.
+Int_t R3BCalifaCrystalCal2Cluster::GetAngleIndex(Int_t cryId) const
 {
+    const Int_t nCrystals = fCrystalAngles ? fCrystalAngles->size() : 0;
+    if (cryId > nCrystals && cryId <= 2 * nCrystals)
+        cryId -= nCrystals;
+    return (cryId >= 1 && cryId <= nCrystals) ? cryId - 1 : -1;
+}
 
-    for (int p = 0; p < used.size(); p++)
-    {
-        for (int s = 0; s < all.size(); s++)
+const TVector3& R3BCalifaCrystalCal2Cluster::GetCrystalAngles(Int_t cryId) const
+{
+    const static TVector3 invalid(NAN, NAN, NAN);
+    const auto index = GetAngleIndex(cryId);
+    return index < 0 ? invalid : (*fCrystalAngles)[index];
+}
 
-            if (all.at(s)->GetCrystalId() == used.at(p))
-                all.erase(all.begin() + s);
-    }
+bool R3BCalifaCrystalCal2Cluster::IsNeighbour(Int_t motherId, Int_t cryId) const
+{
+    const auto motherIndex = GetAngleIndex(motherId);
+    const auto index = GetAngleIndex(cryId);
+    if (motherIndex < 0 || index < 0)
+        return false; // NAN angles are never inside the window
+    const auto& neighbours = fNeighbours[motherIndex];
+    return binary_search(neighbours.begin(), neighbours.end(), static_cast<uint16_t>(index));
+}
 
-    for (int p = 0; p < used.size(); p++)
+// Evaluates the cluster window once for all pairs of crystals. The decisions are exactly those of
+// InsideClusterWindow() on the angles of R3BCalifaGeometry::GetAngles()
+void R3BCalifaCrystalCal2Cluster::BuildNeighbourLists()
+{
+    fCrystalAngles = &R3BCalifaGeometry::Instance()->GetAngleTable();
+    const auto& angles = *fCrystalAngles;
+    const auto nCrystals = angles.size();
+
+    // Unit vectors and a slightly larger window to skip most pairs of the round window quickly. NAN never skips.
+    vector<TVector3> units(nCrystals);
+    vector<Double_t> theta(nCrystals), phi(nCrystals);
+    for (size_t i = 0; i < nCrystals; i++)
     {
-        for (int s = 0; s < gamma.size(); s++)
-
-            if (gamma.at(s)->GetCrystalId() == used.at(p))
-                gamma.erase(gamma.begin() + s);
+        units[i] = angles[i].Mag2() > 0 ? angles[i].Unit() : TVector3(NAN, NAN, NAN);
+        theta[i] = angles[i].Theta();
+        phi[i] = angles[i].Phi();
     }
+    const Double_t margin = 1e-6;
+    const Double_t minCos = fRoundWindow + margin < TMath::Pi() ? cos(fRoundWindow + margin) : -2.;
 
-    for (int p = 0; p < used.size(); p++)
-    {
-        for (int s = 0; s < proton.size(); s++)
+    const bool isRound = fWindowAlg == "Round";
+    const bool isRectangular = fWindowAlg == "Rectangular";
 
-            if (proton.at(s)->GetCrystalId() == used.at(p))
-                proton.erase(proton.begin() + s);
+    fNeighbours.assign(nCrystals, vector<uint16_t>());
+    size_t nPairs = 0;
+    for (size_t m = 0; m < nCrystals; m++)
+    {
+        for (size_t c = 0; c < nCrystals; c++)
+        {
+            bool inside = false;
+            if (isRound)
+                inside = !(units[m].Dot(units[c]) < minCos) && angles[m].Angle(angles[c]) <= fRoundWindow;
+            else if (isRectangular)
+                inside = (abs(theta[m] - theta[c]) < fThetaLimit) && (abs(phi[m] - phi[c]) < fPhiLimit);
+
+            if (inside)
+                fNeighbours[m].push_back(c);
+        }
+        nPairs += fNeighbours[m].size();
     }
+    fNeighboursOutdated = kFALSE;
 
-    for (int p = 0; p < used.size(); p++)
-    {
-        for (int s = 0; s < saturated.size(); s++)
+    R3BLOG(info, fWindowAlg << " cluster window: " << nPairs << " neighbour pairs for " << nCrystals << " crystals");
+}
 
-            if (saturated.at(s)->GetCrystalId() == used.at(p))
-                saturated.erase(saturated.begin() + s);
-    }
+void RemoveUsedCrystals(const vector<bool>& usedFlags,
+                        vector<R3BCalifaCrystalCalData*>& all,
+                        vector<R3BCalifaCrystalCalData*>& proton,
+                        vector<R3BCalifaCrystalCalData*>& gamma,
+                        vector<R3BCalifaCrystalCalData*>& saturated)
+{
+    auto isUsed = [&](R3BCalifaCrystalCalData* crystal) { return isInside(usedFlags, crystal->GetCrystalId()); };
+
+    // stable, the vectors stay sorted by energy
+    all.erase(remove_if(all.begin(), all.end(), isUsed), all.end());
+    gamma.erase(remove_if(gamma.begin(), gamma.end(), isUsed), gamma.end());
+    proton.erase(remove_if(proton.begin(), proton.end(), isUsed), proton.end());
+    saturated.erase(remove_if(saturated.begin(), saturated.end(), isUsed), saturated.end());
 }
 
 void addCrystal2Cluster(struct califa_candidate* cluster,
                         R3BCalifaCrystalCalData* crystalCal,
                         string range,
                         vector<uint16_t>* usedCrystals,
+                        vector<bool>* usedFlags,
                         uint16_t totalCrystals)
 {
     cluster->energy += crystalCal->GetEnergy();
@@ -137,6 +193,9 @@ void addCrystal2Cluster(struct califa_candidate* cluster,
 
     if (range == "proton")
         usedCrystals->push_back(crystalCal->GetCrystalId() - totalCrystals);
+
+    (*usedFlags)[static_cast<uint16_t>(crystalCal->GetCrystalId())] = true;
+    (*usedFlags)[usedCrystals->back()] = true;
 }
 
 R3BCalifaCrystalCal2Cluster::R3BCalifaCrystalCal2Cluster()
@@ -234,6 +293,9 @@ InitStatus R3BCalifaCrystalCal2Cluster::Init()
         posCor.Print();
     }
 
+    fUsedFlags.assign(numeric_limits<uint16_t>::max() + 1, false);
+    BuildNeighbourLists();
+
     if (fRand)
     {
         R3BLOG_IF(fatal, !fHistoFile, "Randomization file not found");
@@ -269,6 +331,9 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
 
     R3BLOG(debug1, "Crystal hits at start:" << numCrystalHits);
 
+    if (fNeighboursOutdated)
+        BuildNeighbourLists();
+
     vector<R3BCalifaCrystalCalData*> allCrystalVec;
     vector<R3BCalifaCrystalCalData*> protonCandidatesVec;
     vector<R3BCalifaCrystalCalData*> gammaCandidatesVec;
@@ -326,7 +391,7 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
     std::sort(protonCandidatesVec.begin(), protonCandidatesVec.end(), compareByEnergy);
     std::sort(allCrystalVec.begin(), allCrystalVec.end(), compareByEnergy);
 
-    TVector3 mother_angles, angles;
+    TVector3 mother_angles;
     Double_t fRandTheta = 0., fRandPhi = 0.;
 
     while (protonCandidatesVec.size())
@@ -335,14 +400,8 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
 
         califa_candidate cluster = { motherId, vector<uint16_t>(), 0.0, 0.0, 0.0, 0.0, 0.0 };
 
-        if (motherId <= fTotalCrystals)
-        {
-            mother_angles = R3BCalifaGeometry::Instance()->GetAngles(motherId);
-        }
-        else
-        {
-            mother_angles = R3BCalifaGeometry::Instance()->GetAngles(motherId - fTotalCrystals);
-        }
+        const Int_t motherGeoId = motherId <= fTotalCrystals ? motherId : motherId - fTotalCrystals;
+        mother_angles = GetCrystalAngles(motherGeoId);
 
         if (fRand)
         {
@@ -366,40 +425,37 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
 
         cluster.time = protonCandidatesVec.at(0)->GetTime();
 
-        addCrystal2Cluster(&cluster, protonCandidatesVec.at(0), "proton", &usedCrystals, fTotalCrystals);
+        addCrystal2Cluster(&cluster, protonCandidatesVec.at(0), "proton", &usedCrystals, &fUsedFlags, fTotalCrystals);
 
         for (Int_t j = 0; j < allCrystalVec.size(); j++)
         {
             Int_t thisCryId = allCrystalVec.at(j)->GetCrystalId();
             Float_t thisEnergy = allCrystalVec.at(j)->GetEnergy();
 
-            if (thisCryId > fTotalCrystals && !isInside(usedCrystals, thisCryId) && !fSimulation)
+            if (thisCryId > fTotalCrystals && !isInside(fUsedFlags, thisCryId) && !fSimulation)
             {
 
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId - fTotalCrystals);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "proton", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId - fTotalCrystals))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "proton", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
 
-            if (thisCryId <= fTotalCrystals && !isInside(usedCrystals, thisCryId) && !std::isnan(thisEnergy) &&
+            if (thisCryId <= fTotalCrystals && !isInside(fUsedFlags, thisCryId) && !std::isnan(thisEnergy) &&
                 !fSimulation)
             {
 
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "gamma", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
 
             /* ------- Simulation ------- */
-            if (!isInside(usedCrystals, thisCryId) && fSimulation)
+            if (!isInside(fUsedFlags, thisCryId) && fSimulation)
             {
 
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "gamma", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
         }
 
@@ -407,7 +463,7 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
             cluster.crystalList, cluster.energy, cluster.nf, cluster.ns, cluster.theta, cluster.phi, cluster.time, 0);
 
         RemoveUsedCrystals(
-            usedCrystals, allCrystalVec, protonCandidatesVec, gammaCandidatesVec, saturatedCandidatesVec);
+            fUsedFlags, allCrystalVec, protonCandidatesVec, gammaCandidatesVec, saturatedCandidatesVec);
     }
 
     /*------ Gamma Clusters ------- */
@@ -417,11 +473,8 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
 
         califa_candidate cluster = { motherId, vector<uint16_t>(), 0.0, 0.0, 0.0, 0.0, 0.0 };
 
-        if (motherId <= fTotalCrystals)
-            mother_angles = R3BCalifaGeometry::Instance()->GetAngles(motherId);
-
-        else
-            mother_angles = R3BCalifaGeometry::Instance()->GetAngles(motherId - fTotalCrystals);
+        const Int_t motherGeoId = motherId <= fTotalCrystals ? motherId : motherId - fTotalCrystals;
+        mother_angles = GetCrystalAngles(motherGeoId);
 
         if (fRand)
         {
@@ -445,18 +498,17 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
 
         cluster.time = gammaCandidatesVec.at(0)->GetTime();
 
-        addCrystal2Cluster(&cluster, gammaCandidatesVec.at(0), "gamma", &usedCrystals, fTotalCrystals);
+        addCrystal2Cluster(&cluster, gammaCandidatesVec.at(0), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
 
         for (Int_t j = 0; j < allCrystalVec.size(); j++)
         {
             Int_t thisCryId = allCrystalVec.at(j)->GetCrystalId();
 
-            if (thisCryId <= fTotalCrystals && !isInside(usedCrystals, thisCryId) && !fSimulation)
+            if (thisCryId <= fTotalCrystals && !isInside(fUsedFlags, thisCryId) && !fSimulation)
             {
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "gamma", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
         }
 
@@ -464,12 +516,11 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
         {
             Int_t thisCryId = allCrystalVec.at(j)->GetCrystalId();
 
-            if (thisCryId > fTotalCrystals && !isInside(usedCrystals, thisCryId) && !fSimulation)
+            if (thisCryId > fTotalCrystals && !isInside(fUsedFlags, thisCryId) && !fSimulation)
             {
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId - fTotalCrystals);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "proton", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId - fTotalCrystals))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "proton", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
         }
 
@@ -477,13 +528,12 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
         {
             Int_t thisCryId = allCrystalVec.at(j)->GetCrystalId();
 
-            if (!isInside(usedCrystals, thisCryId) && fSimulation)
+            if (!isInside(fUsedFlags, thisCryId) && fSimulation)
             {
 
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "gamma", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
         }
 
@@ -491,7 +541,7 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
             cluster.crystalList, cluster.energy, cluster.nf, cluster.ns, cluster.theta, cluster.phi, cluster.time, 1);
 
         RemoveUsedCrystals(
-            usedCrystals, allCrystalVec, protonCandidatesVec, gammaCandidatesVec, saturatedCandidatesVec);
+            fUsedFlags, allCrystalVec, protonCandidatesVec, gammaCandidatesVec, saturatedCandidatesVec);
     }
 
     /* ----------- Saturation Clusters ----------- */
@@ -501,7 +551,8 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
 
         califa_candidate cluster = { motherId, vector<uint16_t>(), 0.0, 0.0, 0.0, 0.0, 0.0 };
 
-        mother_angles = R3BCalifaGeometry::Instance()->GetAngles(motherId);
+        const Int_t motherGeoId = motherId;
+        mother_angles = GetCrystalAngles(motherGeoId);
 
         if (fRand)
         {
@@ -516,26 +567,24 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
         }
         cluster.time = saturatedCandidatesVec.at(0)->GetTime();
 
-        addCrystal2Cluster(&cluster, saturatedCandidatesVec.at(0), "gamma", &usedCrystals, fTotalCrystals);
+        addCrystal2Cluster(&cluster, saturatedCandidatesVec.at(0), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
 
         for (Int_t j = 0; j < allCrystalVec.size(); j++)
         {
             Int_t thisCryId = allCrystalVec.at(j)->GetCrystalId();
 
-            if (thisCryId > fTotalCrystals && !isInside(usedCrystals, thisCryId))
+            if (thisCryId > fTotalCrystals && !isInside(fUsedFlags, thisCryId))
             {
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId - fTotalCrystals);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "proton", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId - fTotalCrystals))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "proton", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
 
-            if (thisCryId <= fTotalCrystals && !isInside(usedCrystals, thisCryId))
+            if (thisCryId <= fTotalCrystals && !isInside(fUsedFlags, thisCryId))
             {
-                angles = R3BCalifaGeometry::Instance()->GetAngles(thisCryId);
-
-                if (InsideClusterWindow(mother_angles, angles))
-                    addCrystal2Cluster(&cluster, allCrystalVec.at(j), "gamma", &usedCrystals, fTotalCrystals);
+                if (IsNeighbour(motherGeoId, thisCryId))
+                    addCrystal2Cluster(
+                        &cluster, allCrystalVec.at(j), "gamma", &usedCrystals, &fUsedFlags, fTotalCrystals);
             }
         }
 
@@ -543,9 +592,13 @@ void R3BCalifaCrystalCal2Cluster::Exec(Option_t* /*opt*/)
             cluster.crystalList, cluster.energy, cluster.nf, cluster.ns, cluster.theta, cluster.phi, cluster.time, 2);
 
         RemoveUsedCrystals(
-            usedCrystals, allCrystalVec, protonCandidatesVec, gammaCandidatesVec, saturatedCandidatesVec);
+            fUsedFlags, allCrystalVec, protonCandidatesVec, gammaCandidatesVec, saturatedCandidatesVec);
     }
 
+    // Only the flags of this event are set
+    for (const auto cryId : usedCrystals)
+        fUsedFlags[cryId] = false;
+
     return;
 }
 
@@ -23,6 +23,8 @@
 
 #include <TH2F.h>
 #include <TVector3.h>
+#include <cstdint>
+#include <vector>
 
 class TClonesArray;
 class R3BTGeoPar;
@@ -114,6 +116,20 @@ class R3BCalifaCrystalCal2Cluster : public FairTask
     TString fWindowAlg;
     Float_t fThetaLimit;
     Float_t fPhiLimit;
+
+    // Crystal positions of R3BCalifaGeometry::GetAngleTable() and, for each of them, the sorted table indices of all
+    // crystals inside the cluster window. Rebuilt when the window changes.
+    const std::vector<TVector3>* fCrystalAngles = nullptr; //!
+    std::vector<std::vector<uint16_t>> fNeighbours;        //!
+    Bool_t fNeighboursOutdated = kTRUE;                    //!
+    // Flags of the used crystals of the current event, indexed by crystal ID
+    std::vector<bool> fUsedFlags; //!
+
+    void BuildNeighbourLists();
+    Int_t GetAngleIndex(Int_t cryId) const;
+    const TVector3& GetCrystalAngles(Int_t cryId) const;
+    bool IsNeighbour(Int_t motherId, Int_t cryId) const;
+
     /** Private method AddCluster
     **
     ** Adds a CalifaCluster to the ClusterCollection
@@ -187,6 +187,20 @@ void R3BCalifaGeometry::GetAngles(int iD, double* polar, double* azimuthal, doub
     }
 }
 
+const std::vector<TVector3>& R3BCalifaGeometry::GetAngleTable()
+{
+    if (fAngleTable.size() != static_cast<size_t>(fNumCrystals / 2))
+    {
+        fAngleTable.clear();
+        fAngleTable.reserve(fNumCrystals / 2);
+        for (int iD = 1; iD <= fNumCrystals / 2; iD++)
+        {
+            fAngleTable.push_back(GetAngles(iD));
+        }
+    }
+    return fAngleTable;
+}
+
 std::string R3BCalifaGeometry::GetCrystalVolumePath(int iD)
 {
     int alveolusCopy = -1;
@@ -356,11 +370,22 @@ int R3BCalifaGeometry::GetCrystalId(const std::string volumePath)
         return 0;
     }
 
-    int crystalId = 0;
     bool isCCSI = m[1].str() == "Alveolus_CCSI"; // Adding CEPA CSI
     int alvType = std::stoi(m[2].str());         // converting to int the alveolus type
     int alveolusCopy = std::stoi(m[3].str());    // converting to int the alveolus copy
     int cryType = std::stoi(m[5].str());         // converting to int the crystal type
+
+    int crystalId = GetCrystalId(isCCSI, alvType, alveolusCopy, cryType);
+    if (crystalId == 0)
+    {
+        LOG(info) << "path=" << volumePath;
+    }
+    return crystalId;
+}
+
+int R3BCalifaGeometry::GetCrystalId(bool isCCSI, int alvType, int alveolusCopy, int cryType)
+{
+    int crystalId = 0;
     bool invalid = kFALSE;
 
     // cryType runs from 1 to 4 while alvType runs from 1 to 23, otherwise invaled
@@ -373,7 +398,6 @@ int R3BCalifaGeometry::GetCrystalId(const std::string volumePath)
     {
         R3BLOG(error, "Wrong crystal numbers (1)");
         LOG(info) << "---- cryType: " << cryType << "   alvType: " << alvType;
-        LOG(info) << "path=" << volumePath;
         return 0;
     }
 
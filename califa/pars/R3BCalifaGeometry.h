@@ -22,6 +22,7 @@
 #include <TVector3.h>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 class TGeoNavigator;
 
@@ -64,6 +65,14 @@ class R3BCalifaGeometry : public TObject
      */
     void GetAngles(int iD, double* polar, double* azimuthal, double* rho);
 
+    /**
+     * Gets positions of all crystals at once, as returned by GetAngles(iD) for iD = 1 ... GetNbCrystals() / 2.
+     * The table is filled on the first call, set the reference point before.
+     *
+     * @return Vector with the position of crystal iD at index iD - 1 (NAN components for invalid crystals)
+     */
+    const std::vector<TVector3>& GetAngleTable();
+
     /**
      * Gets volume path of crystal with given ID.
      *
@@ -80,6 +89,18 @@ class R3BCalifaGeometry : public TObject
      */
     int GetCrystalId(const std::string volumePath);
 
+    /**
+     * Gets crystal ID from the numbers encoded in the volume path, i.e. from
+     * the names and the copy number of the alveolus and crystal volumes.
+     *
+     * @param isCCSI CEPA CsI alveolus (Alveolus_CCSI_*)
+     * @param alvType Alveolus type (Alveolus_<alvType>)
+     * @param alveolusCopy Copy number of the alveolus
+     * @param cryType Crystal type (Crystal_*_<cryType>)
+     * @return Crystal ID, 0 on error
+     */
+    int GetCrystalId(bool isCCSI, int alvType, int alveolusCopy, int cryType);
+
     /**
      * Calculate the distance of a given straight track through the active detector volume (crystal(s)). Usefull for
      * iPhos.
@@ -131,6 +152,7 @@ class R3BCalifaGeometry : public TObject
     bool IsInitialize = false;
     TVector3 fRefPoint;
     TFile* f;
+    std::vector<TVector3> fAngleTable; //!
 
   public:
     ClassDefOverride(R3BCalifaGeometry, 9);
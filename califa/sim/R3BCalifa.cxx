@@ -24,10 +24,13 @@
 #include <TClonesArray.h>
 #include <TGeoManager.h>
 #include <TGeoNode.h>
+#include <TGeoVolume.h>
 #include <TParticle.h>
 #include <TVirtualMC.h>
 
+#include <functional>
 #include <iostream>
+#include <regex>
 #include <stdlib.h>
 
 R3BCalifa::R3BCalifa()
@@ -49,6 +52,9 @@ R3BCalifa::R3BCalifa(const std::string& geoFile, const TGeoCombiTrans& combi)
 
 R3BCalifa::~R3BCalifa()
 {
+    R3BLOG_IF(error,
+              fNCrystalIdMismatches > 0,
+              fNCrystalIdMismatches << " crystal IDs of the copy number lookup differ from the volume path");
     if (fCalifaCollection)
     {
         fCalifaCollection->Delete();
@@ -69,12 +75,117 @@ void R3BCalifa::Initialize()
     {
         R3BLOG(error, "Califa geometry not found");
     }
+
+    BuildCrystalIdTable();
     return;
 }
 
+void R3BCalifa::BuildCrystalIdTable()
+{
+    fCrystalVolumes.clear();
+    fAlveolusVolumes.clear();
+
+    // names of the volumes as matched by R3BCalifaGeometry::GetCrystalId(volumePath)
+    static const std::regex alveolusRe("(Alveolus|Alveolus_CCSI)_([0-9]+)");
+    static const std::regex crystalRe("(Crystal|Crystal_CCSI)_[^_]+_([0-9]+)");
+
+    auto getVolId = [](const char* name)
+    {
+        const int volId = TVirtualMC::GetMC()->VolId(name);
+        return volId > 0 ? volId : 0;
+    };
+
+    int nCrystalVolumes = 0;
+    std::function<void(TGeoVolume*, int)> addCrystals = [&](TGeoVolume* mother, int level)
+    {
+        for (int i = 0; i < mother->GetNdaughters(); i++)
+        {
+            auto* volume = mother->GetNode(i)->GetVolume();
+            std::cmatch m;
+            const int volId = std::regex_match(volume->GetName(), m, crystalRe) ? getVolId(volume->GetName()) : 0;
+            if (volId > 0)
+            {
+                if (fCrystalVolumes.size() <= static_cast<size_t>(volId))
+                {
+                    fCrystalVolumes.resize(volId + 1);
+                }
+                auto& crystal = fCrystalVolumes[volId];
+                if (crystal.cryType == 0)
+                {
+                    crystal = { std::stoi(m[2].str()), level };
+                    nCrystalVolumes++;
+                }
+                else if (crystal.alveolusLevel != level)
+                {
+                    // the copy numbers are not unique, use the volume path
+                    crystal.alveolusLevel = -1;
+                }
+            }
+            addCrystals(volume, level + 1);
+        }
+    };
+
+    TIter next(gGeoManager->GetListOfVolumes());
+    while (auto* volume = dynamic_cast<TGeoVolume*>(next()))
+    {
+        std::cmatch m;
+        const int volId = std::regex_match(volume->GetName(), m, alveolusRe) ? getVolId(volume->GetName()) : 0;
+        if (volId == 0)
+        {
+            continue;
+        }
+        if (fAlveolusVolumes.size() <= static_cast<size_t>(volId))
+        {
+            fAlveolusVolumes.resize(volId + 1);
+        }
+        fAlveolusVolumes[volId] = { std::stoi(m[2].str()), m[1].str() == "Alveolus_CCSI" };
+        addCrystals(volume, 1);
+    }
+
+    R3BLOG(info,
+           "Crystal ID lookup for " << nCrystalVolumes << " crystal volumes"
+                                    << (fValidateCrystalId ? ", validated with the volume path" : ""));
+}
+
+int R3BCalifa::GetCurrentCrystalId()
+{
+    auto* mc = TVirtualMC::GetMC();
+    int copy = 0;
+    const int volId = mc->CurrentVolID(copy);
+
+    int crystalId = -1;
+    if (volId > 0 && static_cast<size_t>(volId) < fCrystalVolumes.size() && fCrystalVolumes[volId].alveolusLevel > 0)
+    {
+        const auto& crystal = fCrystalVolumes[volId];
+        int alveolusCopy = 0;
+        const int alvId = mc->CurrentVolOffID(crystal.alveolusLevel, alveolusCopy);
+        if (alvId > 0 && static_cast<size_t>(alvId) < fAlveolusVolumes.size() && fAlveolusVolumes[alvId].alvType > 0)
+        {
+            const auto& alveolus = fAlveolusVolumes[alvId];
+            crystalId = R3BCalifaGeometry::Instance()->GetCrystalId(
+                alveolus.isCCSI, alveolus.alvType, alveolusCopy, crystal.cryType);
+        }
+    }
+
+    if (crystalId < 0 || fValidateCrystalId)
+    {
+        const int pathCrystalId = R3BCalifaGeometry::Instance()->GetCrystalId(mc->CurrentVolPath());
+        if (crystalId >= 0 && crystalId != pathCrystalId)
+        {
+            R3BLOG_IF(error,
+                      fNCrystalIdMismatches < 10,
+                      "Crystal ID " << crystalId << " from the copy numbers, " << pathCrystalId << " from the path "
+                                    << mc->CurrentVolPath());
+            fNCrystalIdMismatches++;
+        }
+        crystalId = pathCrystalId;
+    }
+    return crystalId;
+}
+
 Bool_t R3BCalifa::ProcessHits(FairVolume* vol)
 {
-    int crystalId = R3BCalifaGeometry::Instance()->GetCrystalId(TVirtualMC::GetMC()->CurrentVolPath());
+    int crystalId = GetCurrentCrystalId();
 
     if (TVirtualMC::GetMC()->IsTrackEntering())
     {
@@ -21,6 +21,7 @@
 #include <TLorentzVector.h>
 #include <map>
 #include <string>
+#include <vector>
 
 class TClonesArray;
 class R3BCalifaPoint;
@@ -107,6 +108,9 @@ class R3BCalifa : public R3BDetector
 
     void Initialize() override;
 
+    /** Compare every crystal ID of the copy number lookup with the volume path parser (slow) **/
+    void SetCrystalIdValidation(bool validate = true) { fValidateCrystalId = validate; }
+
   private:
     /** Track information to be stored until the track leaves the
     active volume. **/
@@ -126,6 +130,35 @@ class R3BCalifa : public R3BDetector
     // Selecting the geometry of the CALIFA calorimeter (final BARREL+iPhos: 2021)
     int fGeometryVersion = 2021;
 
+    // Crystal ID lookup by MC volume ID and copy number, built in Initialize() from the geometry
+    struct CrystalVolume
+    {
+        int cryType = 0;        // crystal type from the volume name, 0 if not a crystal volume
+        int alveolusLevel = -1; // levels between crystal and alveolus, -1 if ambiguous
+    };
+    struct AlveolusVolume
+    {
+        int alvType = 0; // alveolus type from the volume name, 0 if not an alveolus volume
+        bool isCCSI = false;
+    };
+    std::vector<CrystalVolume> fCrystalVolumes;   //!  indexed by MC volume ID
+    std::vector<AlveolusVolume> fAlveolusVolumes; //!  indexed by MC volume ID
+    bool fValidateCrystalId = false;              //!
+    int fNCrystalIdMismatches = 0;                //!
+
+    /** Private method BuildCrystalIdTable
+     **
+     ** Fills the crystal and alveolus volume tables
+     **/
+    void BuildCrystalIdTable();
+
+    /** Private method GetCurrentCrystalId
+     **
+     ** Crystal ID of the current step from the copy numbers of the volume
+     ** stack, falls back to the volume path parser for unknown volumes
+     **/
+    int GetCurrentCrystalId();
+
     /** Private method AddPoint
      **
      ** Adds a CalifaPoint to the HitCollection
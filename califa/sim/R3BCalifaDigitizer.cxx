@@ -115,7 +115,6 @@ InitStatus R3BCalifaDigitizer::Init()
 
     fCalifaCryCalDataCA = new TClonesArray("R3BCalifaCrystalCalData");
     rootman->Register("CalifaCrystalCalData", "CALIFA Crystal Cal", fCalifaCryCalDataCA, true);
-    // output_data.init();
 
     SetParameter();
     return kSUCCESS;
@@ -124,12 +123,16 @@ InitStatus R3BCalifaDigitizer::Init()
 void R3BCalifaDigitizer::Exec(Option_t*)
 {
     // Reset entries for output
-    // output_data.clear();
     if (fCalifaCryCalDataCA)
         fCalifaCryCalDataCA->Clear();
 
+    Digitize(*fCalifaPointDataCA, *fCalifaCryCalDataCA);
+}
+
+void R3BCalifaDigitizer::Digitize(const TClonesArray& points, TClonesArray& crystalCals)
+{
     // Reading the Input -- Point data --
-    const int nHits = fCalifaPointDataCA->GetEntriesFast();
+    const int nHits = points.GetEntriesFast();
     if (!nHits)
         return;
 
@@ -139,7 +142,7 @@ void R3BCalifaDigitizer::Exec(Option_t*)
     R3BCalifaPoint** pointData = nullptr;
     pointData = new R3BCalifaPoint*[nHits];
     for (int i = 0; i < nHits; i++)
-        pointData[i] = dynamic_cast<R3BCalifaPoint*>(fCalifaPointDataCA->At(i));
+        pointData[i] = dynamic_cast<R3BCalifaPoint*>(points.At(i));
 
     int crystalId = 0;
     double Nf = 0.;
@@ -169,41 +172,37 @@ void R3BCalifaDigitizer::Exec(Option_t*)
             Ns = tf_dNs_dE(dE_dx) * energy;
         }
 
-        int nCrystalCals = 0;
-        if (fCalifaCryCalDataCA != nullptr)
-            nCrystalCals = fCalifaCryCalDataCA->GetEntriesFast();
+        const int nCrystalCals = crystalCals.GetEntriesFast();
         bool existHit = false;
         if (nCrystalCals == 0)
-            AddCrystalCal(crystalId, energy, Nf, Ns, time, energy);
+            AddCrystalCal(crystalCals, crystalId, energy, Nf, Ns, time, energy);
         else
         {
             for (int j = 0; j < nCrystalCals; j++)
             {
-                if ((dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->GetCrystalId() == crystalId)
+                if ((dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->GetCrystalId() == crystalId)
                 {
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->AddMoreEnergy(energy);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->AddMoreTot(energy);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->AddMoreNf(Nf);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->AddMoreNs(Ns);
-                    if ((dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->GetTime() > time)
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->AddMoreEnergy(energy);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->AddMoreTot(energy);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->AddMoreNf(Nf);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->AddMoreNs(Ns);
+                    if ((dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->GetTime() > time)
                     {
-                        (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(j)))->SetTime(time);
+                        (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(j)))->SetTime(time);
                     }
                     existHit = true; // to avoid the creation of a new CrystalHit
                     break;
                 }
             }
             if (!existHit)
-                AddCrystalCal(crystalId, energy, Nf, Ns, time, energy);
+                AddCrystalCal(crystalCals, crystalId, energy, Nf, Ns, time, energy);
         }
     }
 
     if (pointData)
         delete[] pointData;
 
-    int nCrystalCals = 0;
-    if (fCalifaCryCalDataCA != nullptr)
-        nCrystalCals = fCalifaCryCalDataCA->GetEntriesFast();
+    const int nCrystalCals = crystalCals.GetEntriesFast();
 
     if (nCrystalCals == 0)
     {
@@ -212,35 +211,19 @@ void R3BCalifaDigitizer::Exec(Option_t*)
 
     if (fRealConfig == true)
     {
-        FillRealConfig(nCrystalCals);
+        FillRealConfig(crystalCals, nCrystalCals);
     }
     else if (fFullProtonRange == true)
     {
-        FillIdealConfigWithProtonRange(nCrystalCals);
+        FillIdealConfigWithProtonRange(crystalCals, nCrystalCals);
     }
     else
     {
-        FillIdealConfig(nCrystalCals);
+        FillIdealConfig(crystalCals, nCrystalCals);
     }
-
-    /*
-            int nCrysCals = fCalifaCryCalDataCA->GetEntriesFast();
-            for (int i = 0; i < nCrysCals; i++)
-            {
-
-                auto tempCal = dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i));
-
-                R3BCalifaCrystalCalData hit(tempCal->GetCrystalId(),
-                                            tempCal->GetEnergy(),
-                                            tempCal->GetNf(),
-                                            tempCal->GetNs(),
-                                            tempCal->GetTime(),
-                                            tempCal->GetToTEnergy());
-                output_data.get().push_back(hit);
-            }*/
 }
 
-void R3BCalifaDigitizer::FillRealConfig(int nCrystalCals)
+void R3BCalifaDigitizer::FillRealConfig(TClonesArray& crystalCals, int nCrystalCals)
 {
     double tempE = 0;
     double tempNf = 0;
@@ -251,8 +234,8 @@ void R3BCalifaDigitizer::FillRealConfig(int nCrystalCals)
 
     for (int i = 0; i < nCrystalCals; i++)
     {
-        tempCryID = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetCrystalId();
-        tempE = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetEnergy();
+        tempCryID = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetCrystalId();
+        tempE = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetEnergy();
 
         inUse = fSim_Par->GetInUse(tempCryID - 1);
         fResolution = fSim_Par->GetResolution(tempCryID - 1);
@@ -261,19 +244,19 @@ void R3BCalifaDigitizer::FillRealConfig(int nCrystalCals)
         if (inUse && parThres < tempE * 1000.)
         { // Thresholds are in KeV!!
 
-            (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(ExpResSmearing(tempE));
+            (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(ExpResSmearing(tempE));
             if (fComponentRes > 0)
             {
-                tempNf = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetNf();
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(CompSmearing(tempNf));
-                tempNs = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetNs();
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(CompSmearing(tempNs));
+                tempNf = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetNf();
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(CompSmearing(tempNf));
+                tempNs = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetNs();
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(CompSmearing(tempNs));
             }
         }
         else
         {
-            fCalifaCryCalDataCA->RemoveAt(i); // remove from CalData those below threshold
-            fCalifaCryCalDataCA->Compress();
+            crystalCals.RemoveAt(i); // remove from CalData those below threshold
+            crystalCals.Compress();
             nCrystalCals--;
             i--;
             continue;
@@ -281,7 +264,7 @@ void R3BCalifaDigitizer::FillRealConfig(int nCrystalCals)
     }
 }
 
-void R3BCalifaDigitizer::FillIdealConfig(int nCrystalCals)
+void R3BCalifaDigitizer::FillIdealConfig(TClonesArray& crystalCals, int nCrystalCals)
 {
     double tempE = 0;
     double realE = 0;
@@ -293,11 +276,11 @@ void R3BCalifaDigitizer::FillIdealConfig(int nCrystalCals)
 
     for (int i = 0; i < nCrystalCals; i++)
     {
-        tempCryID = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetCrystalId();
+        tempCryID = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetCrystalId();
 
-        tempE = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetEnergy();
-        tempNf = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetNf();
-        tempNs = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetNs();
+        tempE = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetEnergy();
+        tempNf = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetNf();
+        tempNs = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetNs();
 
         realE = tempE;
         realNf = tempNf;
@@ -305,8 +288,8 @@ void R3BCalifaDigitizer::FillIdealConfig(int nCrystalCals)
 
         if (tempE < fThreshold)
         {
-            fCalifaCryCalDataCA->RemoveAt(i);
-            fCalifaCryCalDataCA->Compress();
+            crystalCals.RemoveAt(i);
+            crystalCals.Compress();
             nCrystalCals--; // remove from CalData those below threshold
             i--;
             continue;
@@ -323,34 +306,34 @@ void R3BCalifaDigitizer::FillIdealConfig(int nCrystalCals)
 
             if (tempE >= fGammaSaturation && fGammaSaturation > 0 && fGammaResolution > 0)
             {
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))
                     ->SetEnergy(ExpResSmearing(fGammaSaturation));
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))
                     ->SetNf(ExpResSmearing(fGammaSaturation));
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))
                     ->SetNs(ExpResSmearing(fGammaSaturation));
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
             }
             else if (tempE >= fGammaSaturation && fGammaSaturation > 0 && fGammaResolution == 0)
             {
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(fGammaSaturation);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(fGammaSaturation);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(fGammaSaturation);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(fGammaSaturation);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(fGammaSaturation);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(fGammaSaturation);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
             }
             else if (fGammaResolution > 0)
             {
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(realE);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(realNf);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(realNs);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(realE);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(realNf);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(realNs);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
             }
             else if (fGammaResolution == 0)
             {
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(realE);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(realNf);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(realNs);
-                (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(realE);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(realNf);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(realNs);
+                (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
             }
 
             // Proton branch
@@ -361,9 +344,10 @@ void R3BCalifaDigitizer::FillIdealConfig(int nCrystalCals)
                     fResolution = fProtonResolution;
                     realE = ExpResSmearing(tempE);
                 }
-                auto time = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetTime();
+                auto time = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetTime();
 
-                AddCrystalCal(tempCryID + fNumCrystals,
+                AddCrystalCal(crystalCals,
+                              tempCryID + fNumCrystals,
                               ((realE >= fProtonSaturation && fProtonSaturation > 0) ? fProtonSaturation : realE),
                               realNf,
                               realNs,
@@ -377,7 +361,7 @@ void R3BCalifaDigitizer::FillIdealConfig(int nCrystalCals)
     }
 }
 
-void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(int nCrystalCals)
+void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(TClonesArray& crystalCals, int nCrystalCals)
 {
     double tempE = 0;
     double realE = 0;
@@ -389,11 +373,11 @@ void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(int nCrystalCals)
 
     for (int i = 0; i < nCrystalCals; i++)
     {
-        tempCryID = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetCrystalId();
+        tempCryID = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetCrystalId();
 
-        tempE = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetEnergy();
-        tempNf = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetNf();
-        tempNs = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetNs();
+        tempE = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetEnergy();
+        tempNf = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetNf();
+        tempNs = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetNs();
 
         realE = tempE;
         realNf = tempNf;
@@ -401,8 +385,8 @@ void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(int nCrystalCals)
 
         if (tempE < fThreshold)
         {
-            fCalifaCryCalDataCA->RemoveAt(i);
-            fCalifaCryCalDataCA->Compress();
+            crystalCals.RemoveAt(i);
+            crystalCals.Compress();
             nCrystalCals--; // remove from CalData those below threshold
             i--;
             continue;
@@ -421,34 +405,34 @@ void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(int nCrystalCals)
 
                 if (tempE >= fGammaSaturation && fGammaSaturation > 0 && fGammaResolution > 0)
                 {
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))
                         ->SetEnergy(ExpResSmearing(fGammaSaturation));
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))
                         ->SetNf(ExpResSmearing(fGammaSaturation));
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))
                         ->SetNs(ExpResSmearing(fGammaSaturation));
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
                 }
                 else if (tempE >= fGammaSaturation && fGammaSaturation > 0 && fGammaResolution == 0)
                 {
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(fGammaSaturation);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(fGammaSaturation);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(fGammaSaturation);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(fGammaSaturation);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(fGammaSaturation);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(fGammaSaturation);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
                 }
                 else if (fGammaResolution > 0)
                 {
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(realE);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(realNf);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(realNs);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(realE);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(realNf);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(realNs);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
                 }
                 else if (fGammaResolution == 0)
                 {
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetEnergy(realE);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNf(realNf);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetNs(realNs);
-                    (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->SetToTEnergy(realE);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetEnergy(realE);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNf(realNf);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetNs(realNs);
+                    (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->SetToTEnergy(realE);
                 }
             }
             // Proton branch
@@ -457,9 +441,10 @@ void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(int nCrystalCals)
                 fResolution = fProtonResolution;
                 realE = ExpResSmearing(tempE);
             }
-            auto time = (dynamic_cast<R3BCalifaCrystalCalData*>(fCalifaCryCalDataCA->At(i)))->GetTime();
+            auto time = (dynamic_cast<R3BCalifaCrystalCalData*>(crystalCals.At(i)))->GetTime();
 
-            AddCrystalCal(tempCryID + fNumCrystals,
+            AddCrystalCal(crystalCals,
+                          tempCryID + fNumCrystals,
                           ((realE >= fProtonSaturation && fProtonSaturation > 0) ? fProtonSaturation : realE),
                           realNf,
                           realNs,
@@ -467,8 +452,8 @@ void R3BCalifaDigitizer::FillIdealConfigWithProtonRange(int nCrystalCals)
 
             if (tempCryID <= barrelCrystals)
             {
-                fCalifaCryCalDataCA->RemoveAt(i);
-                fCalifaCryCalDataCA->Compress();
+                crystalCals.RemoveAt(i);
+                crystalCals.Compress();
                 nCrystalCals--; // remove from CalData those below threshold
                 i--;
             }
@@ -492,7 +477,8 @@ void R3BCalifaDigitizer::SetRealConfig(bool isRealSet)
     R3BLOG(info, "To " << isRealSet);
 }
 
-R3BCalifaCrystalCalData* R3BCalifaDigitizer::AddCrystalCal(int cryid,
+R3BCalifaCrystalCalData* R3BCalifaDigitizer::AddCrystalCal(TClonesArray& crystalCals,
+                                                           int cryid,
                                                            double energy,
                                                            double Nf,
                                                            double Ns,
@@ -506,15 +492,8 @@ R3BCalifaCrystalCalData* R3BCalifaDigitizer::AddCrystalCal(int cryid,
                                                        << ", Ns=" << Ns << ", Time=" << time
                                                        << ", ToT energy=" << tot_energy);
     }
-    if (fCalifaCryCalDataCA != nullptr)
-    {
-        return new ((*fCalifaCryCalDataCA)[fCalifaCryCalDataCA->GetEntriesFast()])
-            R3BCalifaCrystalCalData(cryid, energy, Nf, Ns, time, tot_energy);
-    }
-    else
-    {
-        return nullptr;
-    }
+    return new (crystalCals[crystalCals.GetEntriesFast()])
+        R3BCalifaCrystalCalData(cryid, energy, Nf, Ns, time, tot_energy);
 }
 
 void R3BCalifaDigitizer::SetExpGammaEnergyRes(double crysRes)
@@ -540,8 +519,8 @@ double R3BCalifaDigitizer::NUSmearing(double inputEnergy)
     // Very simple preliminary scheme where the NU is introduced as a flat random
     // distribution with limits fNonUniformity (%) of the energy value.
     //
-    return gRandom->Uniform(inputEnergy - inputEnergy * fNonUniformity / 100.,
-                            inputEnergy + inputEnergy * fNonUniformity / 100.);
+    return GetRandom()->Uniform(inputEnergy - inputEnergy * fNonUniformity / 100.,
+                                inputEnergy + inputEnergy * fNonUniformity / 100.);
 }
 
 void R3BCalifaDigitizer::SetNonUniformity(Double_t nonU)
@@ -570,7 +549,7 @@ double R3BCalifaDigitizer::ExpResSmearing(double inputEnergy)
     else if (fResolution > 0)
     {
         // Energy in MeV
-        double randomIs = gRandom->Gaus(0., inputEnergy * fResolution * 1. / (235.5 * sqrt(inputEnergy)));
+        double randomIs = GetRandom()->Gaus(0., inputEnergy * fResolution * 1. / (235.5 * sqrt(inputEnergy)));
         return inputEnergy + randomIs;
     }
     else
@@ -591,7 +570,7 @@ double R3BCalifaDigitizer::CompSmearing(double inputComponent)
     else if (fComponentRes > 0)
     {
         // Energy in MeV
-        double randomIs = gRandom->Gaus(0, inputComponent * fComponentRes * 1. / (235.5 * sqrt(inputComponent)));
+        double randomIs = GetRandom()->Gaus(0, inputComponent * fComponentRes * 1. / (235.5 * sqrt(inputComponent)));
         return inputComponent + randomIs;
     }
     else
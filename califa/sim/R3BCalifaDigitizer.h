@@ -23,6 +23,7 @@
 #include <R3BCalifaPoint.h>
 #include <R3BIOConnector.h>
 #include <Rtypes.h>
+#include <TRandom.h>
 #include <string>
 
 class TClonesArray;
@@ -90,11 +91,31 @@ class R3BCalifaDigitizer : public FairTask
      **/
     void SetNonUniformity(double nonU);
 
-  private:
+    /** Public method SetRandomGenerator
+     **
+     ** Random generator for the smearing, gRandom if not set (not owned)
+     **/
+    void SetRandomGenerator(TRandom* rnd) { fRandom = rnd; }
+
+    /** Public method SetParameter
+     **
+     ** Reads the number of crystals and the parameters of the real
+     ** configuration. Called by Init, or before Digitize without a FairRun.
+     **/
     void SetParameter();
-    void FillRealConfig(int nbcry);
-    void FillIdealConfig(int nbcry);
-    void FillIdealConfigWithProtonRange(int nbcry);
+
+    /** Public method Digitize
+     **
+     ** Adds the CrystalCals of the CalifaPoints of one event to crystalCals.
+     ** Used by Exec and by R3BCalifaDigitizingWorker in parallel threads.
+     **/
+    void Digitize(const TClonesArray& points, TClonesArray& crystalCals);
+
+  private:
+    void FillRealConfig(TClonesArray& crystalCals, int nbcry);
+    void FillIdealConfig(TClonesArray& crystalCals, int nbcry);
+    void FillIdealConfigWithProtonRange(TClonesArray& crystalCals, int nbcry);
+    TRandom* GetRandom() const { return fRandom != nullptr ? fRandom : gRandom; }
 
     // Input array
     TClonesArray* fCalifaPointDataCA = nullptr;
@@ -119,6 +140,7 @@ class R3BCalifaDigitizer : public FairTask
     int fNumCrystals = 2544; // Real number of crystals, since Feb. 2024
 
     R3BCalifaCrystalPars4Sim* fSim_Par = nullptr; // Parameter Container for a Realistic Simulation
+    TRandom* fRandom = nullptr;                   //! Random generator, gRandom if not set
 
     /** Private method NUSmearing
      **
@@ -146,7 +168,8 @@ class R3BCalifaDigitizer : public FairTask
     /**
      ** Private method AddCrystalCal
      **/
-    R3BCalifaCrystalCalData* AddCrystalCal(int crysid,
+    R3BCalifaCrystalCalData* AddCrystalCal(TClonesArray& crystalCals,
+                                           int crysid,
                                            double energy,
                                            double Nf,
                                            double Ns,
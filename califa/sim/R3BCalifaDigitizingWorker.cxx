@@ -0,0 +1,32 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BCalifaDigitizingWorker.h"
+#include "R3BException.h"
+
+#include <TClonesArray.h>
+
+R3BCalifaDigitizingWorker::R3BCalifaDigitizingWorker(std::unique_ptr<R3BCalifaDigitizer> digitizer, TRandom3& rnd)
+    : fDigitizer(std::move(digitizer))
+{
+    if (fDigitizer == nullptr)
+    {
+        throw R3B::logic_error("R3BCalifaDigitizingWorker: No digitizer");
+    }
+    fDigitizer->SetRandomGenerator(&rnd);
+}
+
+void R3BCalifaDigitizingWorker::Digitize(const TClonesArray& points, TClonesArray& crystalCals)
+{
+    fDigitizer->Digitize(points, crystalCals);
+}
@@ -0,0 +1,41 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BCALIFADIGITIZINGWORKER_H
+#define R3BCALIFADIGITIZINGWORKER_H 1
+
+#include <R3BCalifaDigitizer.h>
+#include <R3BParallelDigitizer.h>
+#include <memory>
+
+/**
+ * CALIFA digitization in a worker thread of R3BParallelDigitizer
+ *
+ * Each worker owns a configured R3BCalifaDigitizer, whose SetParameter()
+ * has to be called before (on the main thread). The smearing draws its
+ * random numbers from the generator of the worker.
+ *   Input:  TClonesArray("R3BCalifaPoint")
+ *   Output: TClonesArray("R3BCalifaCrystalCalData")
+ */
+class R3BCalifaDigitizingWorker : public R3BDigitizingWorker
+{
+  public:
+    R3BCalifaDigitizingWorker(std::unique_ptr<R3BCalifaDigitizer> digitizer, TRandom3& rnd);
+
+    void Digitize(const TClonesArray& points, TClonesArray& crystalCals) override;
+
+  private:
+    std::unique_ptr<R3BCalifaDigitizer> fDigitizer;
+};
+
+#endif /* R3BCALIFADIGITIZINGWORKER_H */
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BCalifaCrystalCalData.h"
+#include "R3BCalifaDigitizer.h"
+#include "R3BCalifaDigitizingWorker.h"
+#include "R3BCalifaPoint.h"
+#include "R3BParallelDigitizer.h"
+#include "R3BShared.h"
+#include "gtest/gtest.h"
+#include <FairRootManager.h>
+#include <TClonesArray.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TVector3.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    constexpr auto InputFileName = "testCalifaParallelDigitizer_sim.root";
+    constexpr int NEvents = 200;
+    // gamma and proton range of the default number of crystals
+    constexpr int NCrystals = 2 * 2544;
+
+    using CrystalCal = std::tuple<uint16_t, double, double, double, ULong64_t, double>;
+
+    void WriteInputFile()
+    {
+        auto file = R3B::make_rootfile(InputFileName, "RECREATE");
+        auto* tree = new TTree(FairRootManager::GetTreeName(), "test"); // NOLINT
+        tree->SetDirectory(file.get());
+        auto points = TClonesArray{ "R3BCalifaPoint" };
+        auto* address = &points;
+        tree->Branch("CalifaPoint", &address);
+
+        auto engine = std::mt19937{ 1 };
+        auto crystal = std::uniform_int_distribution<int>{ 1, NCrystals };
+        auto multiplicity = std::uniform_int_distribution<int>{ 0, 8 };
+        auto energy = std::uniform_real_distribution<double>{ 1e-4, 2e-2 }; // GeV
+        auto tof = std::uniform_real_distribution<double>{ 1., 20. };
+        for (int event = 0; event < NEvents; ++event)
+        {
+            points.Clear();
+            const auto nPoints = multiplicity(engine);
+            for (int index = 0; index < nPoints; ++index)
+            {
+                // the same crystal may be hit several times
+                new (points[index]) R3BCalifaPoint(index,
+                                                   0,
+                                                   22,
+                                                   crystal(engine),
+                                                   TVector3{ 0., 0., 30. },
+                                                   TVector3{ 0., 0., 0.01 },
+                                                   tof(engine),
+                                                   2.,
+                                                   energy(engine));
+            }
+            tree->Fill();
+        }
+        file->cd();
+        tree->Write();
+        tree->ResetBranchAddresses();
+    }
+
+    auto Digitize(unsigned int nThreads) -> std::string
+    {
+        const auto outputFileName = "testCalifaParallelDigitizer_" + std::to_string(nThreads) + ".root";
+        auto digitizer = R3BParallelDigitizer(InputFileName, outputFileName);
+        digitizer.SetNThreads(nThreads);
+        digitizer.SetBatchSize(7);
+        digitizer.SetSeed(42);
+        digitizer.AddDetector("CalifaPoint",
+                              "CalifaCrystalCalData",
+                              "R3BCalifaCrystalCalData",
+                              [](TRandom3& rnd) -> std::unique_ptr<R3BDigitizingWorker>
+                              {
+                                  // SetParameter() is not called, it needs the geometry. The default number of
+                                  // crystals is used instead.
+                                  auto califaDigitizer = std::make_unique<R3BCalifaDigitizer>();
+                                  califaDigitizer->SetExpGammaEnergyRes(5.);
+                                  califaDigitizer->SetExpProtonEnergyRes(2.);
+                                  califaDigitizer->SetComponentRes(1.);
+                                  califaDigitizer->SetDetectionThreshold(0.0005);
+                                  return std::make_unique<R3BCalifaDigitizingWorker>(std::move(califaDigitizer), rnd);
+                              });
+        digitizer.Run();
+        return outputFileName;
+    }
+
+    auto ReadOutputFile(const std::string& fileName) -> std::vector<std::vector<CrystalCal>>
+    {
+        auto file = R3B::make_rootfile(fileName.c_str(), "READ");
+        auto* tree = file->Get<TTree>(FairRootManager::GetTreeName());
+        auto* crystalCals = new TClonesArray("R3BCalifaCrystalCalData"); // NOLINT
+        tree->SetBranchAddress("CalifaCrystalCalData", &crystalCals);
+
+        auto events = std::vector<std::vector<CrystalCal>>{};
+        for (Long64_t event = 0; event < tree->GetEntries(); ++event)
+        {
+            tree->GetEntry(event);
+            auto& cals = events.emplace_back();
+            for (int index = 0; index < crystalCals->GetEntriesFast(); ++index)
+            {
+                const auto& cal = *static_cast<R3BCalifaCrystalCalData*>(crystalCals->At(index));
+                cals.emplace_back(
+                    cal.GetCrystalId(), cal.GetEnergy(), cal.GetNf(), cal.GetNs(), cal.GetTime(), cal.GetToTEnergy());
+            }
+        }
+        tree->ResetBranchAddresses();
+        delete crystalCals; // NOLINT
+        return events;
+    }
+
+    TEST(testCalifaParallelDigitizer, threads_identical)
+    {
+        WriteInputFile();
+        const auto serialFileName = Digitize(1);
+        const auto threadedFileName = Digitize(4);
+
+        const auto serial = ReadOutputFile(serialFileName);
+        const auto threaded = ReadOutputFile(threadedFileName);
+        ASSERT_EQ(serial.size(), static_cast<size_t>(NEvents));
+        auto nCrystalCals = size_t{ 0 };
+        for (const auto& cals : serial)
+        {
+            nCrystalCals += cals.size();
+        }
+        EXPECT_GT(nCrystalCals, 0U);
+        EXPECT_EQ(serial, threaded);
+
+        std::remove(InputFileName);
+        std::remove(serialFileName.c_str());
+        std::remove(threadedFileName.c_str());
+    }
+} // namespace
@@ -428,15 +428,15 @@ void R3BBunchedFiberCal2Hit::S515()
                 Double_t tot_ns = 0.;
                 if (side_i == 0)
                 {
-                    cur_cal_ns = fTimeStitch->GetTime(cur_cal->GetTime_ns() - cur_cal_trig_ns, "clocktdc", "clocktdc");
-                    lead_ns = fTimeStitch->GetTime(lead->GetTime_ns() - lead_trig_ns, "clocktdc", "clocktdc");
-                    tot_ns = fTimeStitch->GetTime(cur_cal_ns - lead_ns, "clocktdc", "clocktdc");
+                    cur_cal_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(cur_cal->GetTime_ns() - cur_cal_trig_ns);
+                    lead_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(lead->GetTime_ns() - lead_trig_ns);
+                    tot_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(cur_cal_ns - lead_ns);
                 }
                 else
                 {
-                    cur_cal_ns = fTimeStitch->GetTime(cur_cal->GetTime_ns() - cur_cal_trig_ns, "tamex", "tamex");
-                    lead_ns = fTimeStitch->GetTime(lead->GetTime_ns() - lead_trig_ns, "tamex", "tamex");
-                    tot_ns = fTimeStitch->GetTime(cur_cal_ns - lead_ns, "tamex", "tamex");
+                    cur_cal_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(cur_cal->GetTime_ns() - cur_cal_trig_ns);
+                    lead_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(lead->GetTime_ns() - lead_trig_ns);
+                    tot_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(cur_cal_ns - lead_ns);
                 }
 
                  auto fiber_id = (lead->GetChannel() - 1) * fChPerSub[1] + 1;
@@ -647,15 +647,15 @@ void R3BBunchedFiberCal2Hit::Standard()
             Double_t tot_ns = 0.;
             if (side_i == 0)
             {
-                cur_cal_ns = fTimeStitch->GetTime(cur_cal->GetTime_ns() - cur_cal_trig_ns, "clocktdc", "clocktdc");
-                lead_ns = fTimeStitch->GetTime(lead->GetTime_ns() - lead_trig_ns, "clocktdc", "clocktdc");
-                tot_ns = fTimeStitch->GetTime(cur_cal_ns - lead_ns, "clocktdc", "clocktdc");
+                cur_cal_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(cur_cal->GetTime_ns() - cur_cal_trig_ns);
+                lead_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(lead->GetTime_ns() - lead_trig_ns);
+                tot_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(cur_cal_ns - lead_ns);
             }
             else
             {
-                cur_cal_ns = fTimeStitch->GetTime(cur_cal->GetTime_ns() - cur_cal_trig_ns, "tamex", "tamex");
-                lead_ns = fTimeStitch->GetTime(lead->GetTime_ns() - lead_trig_ns, "tamex", "tamex");
-                tot_ns = fTimeStitch->GetTime(cur_cal_ns - lead_ns, "tamex", "tamex");
+                cur_cal_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(cur_cal->GetTime_ns() - cur_cal_trig_ns);
+                lead_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(lead->GetTime_ns() - lead_trig_ns);
+                tot_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(cur_cal_ns - lead_ns);
             }
 
             if (side_i == 1)
@@ -116,6 +116,8 @@ InitStatus R3BBunchedFiberMapped2Cal::Init()
     mgr->Register(fName + "Cal", fName + " cal data", fCalItems, !fOnline);
     mgr->Register(fName + "TriggerCal", fName + " trigger data", fCalTriggerItems, !fOnline);
 
+    BuildTCalLookups();
+
     return kSUCCESS;
 }
 
@@ -152,9 +154,26 @@ void R3BBunchedFiberMapped2Cal::SetParContainers()
 InitStatus R3BBunchedFiberMapped2Cal::ReInit()
 {
     SetParContainers();
+    BuildTCalLookups();
     return kSUCCESS;
 }
 
+void R3BBunchedFiberMapped2Cal::BuildTCalLookups()
+{
+    auto build = [](R3BTCalLookup& lookup, R3BTCalPar* par, R3BTCalLookup::Type type)
+    {
+        lookup.Clear();
+        if (par && par->GetNumModulePar() > 0)
+        {
+            lookup.Build(par, type);
+        }
+    };
+    // MAPMTs are read out by clock TDCs, single PMTs by Tamex (VFTX-like fine time)
+    build(fMAPMTTCalLookup, fMAPMTTCalPar, R3BTCalLookup::Type::ClockTDC);
+    build(fMAPMTTrigTCalLookup, fMAPMTTrigTCalPar, R3BTCalLookup::Type::ClockTDC);
+    build(fSPMTTCalLookup, fSPMTTCalPar, R3BTCalLookup::Type::VFTX);
+}
+
 void R3BBunchedFiberMapped2Cal::Exec(Option_t* option)
 {
     auto mapped_num = fMappedItems->GetEntriesFast();
@@ -171,16 +190,18 @@ void R3BBunchedFiberMapped2Cal::Exec(Option_t* option)
         R3BLOG(debug, "Channel=" << channel << ":Edge=" << (mapped->IsLeading() ? "Leading" : "Trailing") << '.');
 
         // Fetch tcal parameters.
-        R3BTCalModulePar* par;
+        const R3BTCalLookup* lookup;
+        const R3BTCalLookup::Channel* par;
         if (mapped->IsMAPMTTrigger())
         {
-            par = fMAPMTTrigTCalPar->GetModuleParAt(1, channel, 1);
+            lookup = &fMAPMTTrigTCalLookup;
+            par = lookup->GetChannel(1, channel, 1);
         }
         else
         {
             auto tcal_channel_i = channel * 2 - (mapped->IsLeading() ? 1 : 0);
-            par = mapped->IsMAPMT() ? fMAPMTTCalPar->GetModuleParAt(1, tcal_channel_i, 1)
-                                    : fSPMTTCalPar->GetModuleParAt(1, tcal_channel_i, 1);
+            lookup = mapped->IsMAPMT() ? &fMAPMTTCalLookup : &fSPMTTCalLookup;
+            par = lookup->GetChannel(1, tcal_channel_i, 1);
         }
         if (!par)
         {
@@ -200,7 +221,7 @@ void R3BBunchedFiberMapped2Cal::Exec(Option_t* option)
         Double_t time_ns = -1;
         if (mapped->IsMAPMT() || mapped->IsMAPMTTrigger())
         {
-            auto fine_ns = par->GetTimeClockTDC(fine_raw);
+            auto fine_ns = lookup->GetTime(*par, fine_raw);
             R3BLOG(debug, "Fine raw=" << fine_raw << " -> ns=" << fine_ns << '.');
             if (fine_ns < 0. || fine_ns > fClockFreq)
             {
@@ -225,7 +246,7 @@ void R3BBunchedFiberMapped2Cal::Exec(Option_t* option)
             //		(mapped->IsLeading() ? -fine_ns : fine_ns);
             // new clock TDC firmware need here a minus
             // time_ns = mapped->GetCoarse() * fTamexFreq - fine_ns;
-            auto fine_ns = par->GetTimeVFTX(fine_raw);
+            auto fine_ns = lookup->GetTime(*par, fine_raw);
             if (fine_ns < 0. || fine_ns > fTamexFreq)
             {
                 R3BLOG(error,
@@ -21,6 +21,7 @@
 #define R3BBUNCHEDFIBERMAPPED2CAL 1
 
 #include "FairTask.h"
+#include "R3BTCalLookup.h"
 #include "Rtypes.h"
 #include <R3BTCalEngine.h>
 #include <string.h>
@@ -117,6 +118,9 @@ class R3BBunchedFiberMapped2Cal : public FairTask
     R3BTCalPar* fMAPMTTCalPar;
     R3BTCalPar* fMAPMTTrigTCalPar;
     R3BTCalPar* fSPMTTCalPar;
+    R3BTCalLookup fMAPMTTCalLookup;     //!
+    R3BTCalLookup fMAPMTTrigTCalLookup; //!
+    R3BTCalLookup fSPMTTCalLookup;      //!
     TClonesArray* fMappedItems;
     TClonesArray* fCalItems;
     TClonesArray* fCalTriggerItems;
@@ -124,6 +128,8 @@ class R3BBunchedFiberMapped2Cal : public FairTask
     Double_t fTamexFreq;
     Int_t fnEvents;
 
+    void BuildTCalLookups();
+
   public:
     ClassDef(R3BBunchedFiberMapped2Cal, 4)
 };
@@ -330,9 +330,9 @@ void R3BFiberMAPMTCal2Hit::Exec(Option_t* option)
             lead_trig_ns = trig_time[fMapPar->GetTrigMap(side_i + 1, chlead_i + 1)];
 
             auto cur_cal_ns =
-                fTimeStitch->GetTime(cur_cal_trail->GetTime_ns() - cur_cal_trig_ns, "clocktdc", "clocktdc");
-            lead_ns = fTimeStitch->GetTime(lead->GetTime_ns() - lead_trig_ns, "clocktdc", "clocktdc");
-            tot_ns = fTimeStitch->GetTime(cur_cal_ns - lead_ns, "clocktdc", "clocktdc");
+                fTimeStitch->GetTime<R3B::TDC::ClockTDC>(cur_cal_trail->GetTime_ns() - cur_cal_trig_ns);
+            lead_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(lead->GetTime_ns() - lead_trig_ns);
+            tot_ns = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(cur_cal_ns - lead_ns);
 
             lead_raw = lead->GetTime_ns();
             trail_raw = cur_cal_trail->GetTime_ns();
@@ -389,10 +389,10 @@ void R3BFiberMAPMTCal2Hit::Exec(Option_t* option)
                     auto tot_up = up_tot.tot_ns;
                     Double_t t_down = down_tot.lead_ns;
                     Double_t t_up = up_tot.lead_ns;
-                    Double_t dtime = fTimeStitch->GetTime(t_up - t_down, "clocktdc", "clocktdc");
-                    Double_t tof =
-                        fHeader ? fTimeStitch->GetTime((t_up + t_down) / 2. - fHeader->GetTStart(), "vftx", "clocktdc")
-                                : (t_up + t_down) / 2.;
+                    Double_t dtime = fTimeStitch->GetTime<R3B::TDC::ClockTDC>(t_up - t_down);
+                    Double_t tof = fHeader ? fTimeStitch->GetTime<R3B::TDC::Vftx, R3B::TDC::ClockTDC>(
+                                                 (t_up + t_down) / 2. - fHeader->GetTStart())
+                                           : (t_up + t_down) / 2.;
 
                     // Fill histograms for gain match, offset and sync.
                     if (fWrite)
@@ -68,6 +68,8 @@ InitStatus R3BFiberMAPMTMapped2Cal::Init()
     mgr->Register(fName + "Cal", "Fiber Cal Data", fCalItems, !fOnline);
     mgr->Register(fName + "TriggerCal", "Fiber TriggerCal Data", fCalTriggerItems, !fOnline);
 
+    BuildTCalLookups();
+
     return kSUCCESS;
 }
 
@@ -91,9 +93,24 @@ void R3BFiberMAPMTMapped2Cal::SetParContainers()
 InitStatus R3BFiberMAPMTMapped2Cal::ReInit()
 {
     SetParContainers();
+    BuildTCalLookups();
     return kSUCCESS;
 }
 
+void R3BFiberMAPMTMapped2Cal::BuildTCalLookups()
+{
+    auto build = [](R3BTCalLookup& lookup, R3BTCalPar* par)
+    {
+        lookup.Clear();
+        if (par && par->GetNumModulePar() > 0)
+        {
+            lookup.Build(par, R3BTCalLookup::Type::ClockTDC);
+        }
+    };
+    build(fMAPMTTCalLookup, fMAPMTTCalPar);
+    build(fMAPMTTrigTCalLookup, fMAPMTTrigTCalPar);
+}
+
 void R3BFiberMAPMTMapped2Cal::Exec(Option_t* option)
 {
     auto mapped_num = fMappedItems->GetEntriesFast();
@@ -113,15 +130,18 @@ void R3BFiberMAPMTMapped2Cal::Exec(Option_t* option)
                           << ":Edge=" << (mapped->IsLeading() ? "Leading" : "Trailing") << '.');
 
         // Fetch tcal parameters.
-        R3BTCalModulePar* par;
+        const R3BTCalLookup* lookup;
+        const R3BTCalLookup::Channel* par;
         if (mapped->IsTrigger())
         {
-            par = fMAPMTTrigTCalPar->GetModuleParAt(1, channel, 1);
+            lookup = &fMAPMTTrigTCalLookup;
+            par = lookup->GetChannel(1, channel, 1);
         }
         else
         {
             auto tcal_channel_i = channel * 2 - (mapped->IsLeading() ? 1 : 0);
-            par = fMAPMTTCalPar->GetModuleParAt(1, tcal_channel_i, mapped->GetSide());
+            lookup = &fMAPMTTCalLookup;
+            par = lookup->GetChannel(1, tcal_channel_i, mapped->GetSide());
         }
         if (!par)
         {
@@ -136,7 +156,7 @@ void R3BFiberMAPMTMapped2Cal::Exec(Option_t* option)
             // TODO: Is this really ok?
             continue;
         }
-        auto fine_ns = par->GetTimeClockTDC(fine_raw);
+        auto fine_ns = lookup->GetTime(*par, fine_raw);
         R3BLOG(debug, "Fine raw=" << fine_raw << " -> ns=" << fine_ns << '.');
 
         // we have to differ between single PMT which is on Tamex and MAPMT which is on clock TDC
@@ -22,6 +22,7 @@
 
 #include <TClonesArray.h>
 #include "FairTask.h"
+#include "R3BTCalLookup.h"
 #include <R3BTCalEngine.h>
 
 class R3BTCalPar;
@@ -93,6 +94,8 @@ class R3BFiberMAPMTMapped2Cal : public FairTask
     TString fName;
     R3BTCalPar* fMAPMTTCalPar;
     R3BTCalPar* fMAPMTTrigTCalPar;
+    R3BTCalLookup fMAPMTTCalLookup;     //!
+    R3BTCalLookup fMAPMTTrigTCalLookup; //!
     TClonesArray* fMappedItems;
     TClonesArray* fCalItems;
     TClonesArray* fCalTriggerItems;
@@ -105,6 +108,8 @@ class R3BFiberMAPMTMapped2Cal : public FairTask
     // Double_t tmaxfib23a[256] = { -4096 };
     // Double_t tminfib23a[256] = { 4096 };
 
+    void BuildTCalLookups();
+
   public:
     ClassDef(R3BFiberMAPMTMapped2Cal, 1)
 };
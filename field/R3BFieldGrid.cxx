@@ -0,0 +1,132 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BFieldGrid.h"
+
+R3BFieldGrid::R3BFieldGrid(const R3BFieldGrid& other) { *this = other; }
+
+R3BFieldGrid& R3BFieldGrid::operator=(const R3BFieldGrid& other)
+{
+    if (this != &other)
+    {
+        set_geometry(other._nx, other._ny, other._nz, other._min, other._max, other._step);
+        _nodes = other._nodes;
+        // an owned copy points to its own nodes, an attached one shares the external memory
+        _data = other.is_owner() ? _nodes.data() : other._data;
+    }
+    return *this;
+}
+
+void R3BFieldGrid::set_geometry(int nx,
+                                int ny,
+                                int nz,
+                                const double min[3],
+                                const double max[3],
+                                const double step[3])
+{
+    _nx = nx;
+    _ny = ny;
+    _nz = nz;
+    for (int i = 0; i < 3; i++)
+    {
+        _min[i] = min[i];
+        _max[i] = max[i];
+        _step[i] = step[i];
+    }
+}
+
+void R3BFieldGrid::init(int nx, int ny, int nz, const double min[3], const double max[3], const double step[3])
+{
+    set_geometry(nx, ny, nz, min, max, step);
+    _nodes.assign(size(), Node{});
+    _data = _nodes.data();
+}
+
+void R3BFieldGrid::attach(int nx,
+                          int ny,
+                          int nz,
+                          const double min[3],
+                          const double max[3],
+                          const double step[3],
+                          const Node* nodes)
+{
+    set_geometry(nx, ny, nz, min, max, step);
+    _nodes.clear();
+    _nodes.shrink_to_fit();
+    _data = nodes;
+}
+
+void R3BFieldGrid::clear()
+{
+    _nx = _ny = _nz = 0;
+    _nodes.clear();
+    _nodes.shrink_to_fit();
+    _data = nullptr;
+}
+
+bool R3BFieldGrid::interpolate(double x, double y, double z, double b[3]) const
+{
+    if (!(x >= _min[0] && x < _max[0] && y >= _min[1] && y < _max[1] && z >= _min[2] && z < _max[2]))
+    {
+        b[0] = b[1] = b[2] = 0.;
+        return false;
+    }
+
+    // Grid cell and relative distance from the lower grid point (in cell units)
+    const int ix = int((x - _min[0]) / _step[0]);
+    const int iy = int((y - _min[1]) / _step[1]);
+    const int iz = int((z - _min[2]) / _step[2]);
+    const double dx = (x - _min[0]) / _step[0] - double(ix);
+    const double dy = (y - _min[1]) / _step[1] - double(iy);
+    const double dz = (z - _min[2]) / _step[2] - double(iz);
+
+    const std::size_t sx = static_cast<std::size_t>(_ny) * _nz;
+    const std::size_t sy = _nz;
+    const Node* c = &_data[index(ix, iy, iz)];
+    const auto& h000 = c[0].b;
+    const auto& h100 = c[sx].b;
+    const auto& h010 = c[sy].b;
+    const auto& h110 = c[sx + sy].b;
+    const auto& h001 = c[1].b;
+    const auto& h101 = c[sx + 1].b;
+    const auto& h011 = c[sy + 1].b;
+    const auto& h111 = c[sx + sy + 1].b;
+
+    // Same order of operations as the former per-component interpolation,
+    // first along x, then y, then z.
+    alignas(NLanes * sizeof(double)) double res[NLanes];
+    for (int k = 0; k < NLanes; k++)
+    {
+        const double hb00 = h000[k] + (h100[k] - h000[k]) * dx;
+        const double hb10 = h010[k] + (h110[k] - h010[k]) * dx;
+        const double hb01 = h001[k] + (h101[k] - h001[k]) * dx;
+        const double hb11 = h011[k] + (h111[k] - h011[k]) * dx;
+        const double hc0 = hb00 + (hb10 - hb00) * dy;
+        const double hc1 = hb01 + (hb11 - hb01) * dy;
+        res[k] = hc0 + (hc1 - hc0) * dz;
+    }
+    b[0] = res[0];
+    b[1] = res[1];
+    b[2] = res[2];
+    return true;
+}
+
+std::size_t R3BFieldGrid::interpolate(const double* xyz, std::size_t n, double* b) const
+{
+    std::size_t n_inside = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        n_inside += interpolate(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2], &b[3 * i]) ? 1 : 0;
+    }
+    return n_inside;
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BFIELDGRID_H
+#define R3BFIELDGRID_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Regular 3D grid of field vectors with trilinear interpolation.
+//
+// The three components of a grid node are stored next to each other (padded
+// to four doubles, i.e. two nodes per 64 byte cache line), so that the eight
+// corners of a cell are eight aligned loads and all components are
+// interpolated at once in 4-wide lanes, which the compiler maps to SIMD
+// registers. All query methods are const and hence safe to call from
+// several threads concurrently.
+//
+// The nodes are either owned by the grid (init) or live in external memory,
+// e.g. a memory-mapped field map file (attach), which must then outlive the
+// grid or be detached with clear().
+
+class R3BFieldGrid
+{
+  public:
+    static constexpr int NLanes = 4;
+
+    struct alignas(NLanes * sizeof(double)) Node
+    {
+        std::array<double, NLanes> b;
+    };
+
+    R3BFieldGrid() = default;
+    R3BFieldGrid(const R3BFieldGrid& other);
+    R3BFieldGrid& operator=(const R3BFieldGrid& other);
+    R3BFieldGrid(R3BFieldGrid&&) = default;
+    R3BFieldGrid& operator=(R3BFieldGrid&&) = default;
+    ~R3BFieldGrid() = default;
+
+    // Allocates nx * ny * nz nodes set to zero. Points are inside the grid if
+    // min <= x < max in every dimension, max must not exceed the last node.
+    void init(int nx,
+              int ny,
+              int nz,
+              const double min[3],
+              const double max[3],
+              const double step[3]);
+
+    // Same as init, but uses nx * ny * nz nodes from external memory
+    // instead of allocating them. set_node must not be called afterwards.
+    void attach(int nx,
+                int ny,
+                int nz,
+                const double min[3],
+                const double max[3],
+                const double step[3],
+                const Node* nodes);
+
+    void clear();
+
+    bool empty() const { return _data == nullptr; }
+
+    bool is_owner() const { return !_nodes.empty(); }
+
+    std::size_t size() const { return static_cast<std::size_t>(_nx) * _ny * _nz; }
+
+    int get_n(int dim) const { return dim == 0 ? _nx : (dim == 1 ? _ny : _nz); }
+    double get_min(int dim) const { return _min[dim]; }
+    double get_max(int dim) const { return _max[dim]; }
+    double get_step(int dim) const { return _step[dim]; }
+
+    const Node* data() const { return _data; }
+
+    void set_node(int ix, int iy, int iz, double bx, double by, double bz)
+    {
+        _nodes[index(ix, iy, iz)].b = { bx, by, bz, 0. };
+    }
+
+    const Node& get_node(int ix, int iy, int iz) const { return _data[index(ix, iy, iz)]; }
+
+    // Field at a point in grid coordinates. Returns false (and a zero field)
+    // outside of the grid.
+    bool interpolate(double x, double y, double z, double b[3]) const;
+
+    // Batch version: xyz and b hold n consecutive (x, y, z) triplets.
+    // Returns the number of points inside the grid.
+    std::size_t interpolate(const double* xyz, std::size_t n, double* b) const;
+
+  private:
+    std::size_t index(int ix, int iy, int iz) const
+    {
+        return (static_cast<std::size_t>(ix) * _ny + iy) * _nz + iz;
+    }
+
+    int _nx = 0;
+    int _ny = 0;
+    int _nz = 0;
+    double _min[3] = { 0., 0., 0. };
+    double _max[3] = { 0., 0., 0. };
+    double _step[3] = { 1., 1., 1. };
+    std::vector<Node> _nodes;
+    const Node* _data = nullptr;
+
+    void set_geometry(int nx, int ny, int nz, const double min[3], const double max[3], const double step[3]);
+};
+
+#endif // R3BFIELDGRID_H
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BFieldMapFile.h"
+#include "R3BException.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr char Magic[8] = { 'R', '3', 'B', 'F', 'M', 'A', 'P', '\0' };
+
+    std::string system_error(const std::string& what, const std::string& file_name)
+    {
+        return what + " " + file_name + ": " + std::strerror(errno);
+    }
+} // namespace
+
+void R3BFieldMapFile::write(const std::string& file_name, const R3BFieldGrid& grid)
+{
+    if (grid.empty())
+    {
+        throw R3B::runtime_error("Cannot write an empty field grid to " + file_name);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.header_size = sizeof(Header);
+    header.byte_order = ByteOrderMark;
+    for (int i = 0; i < 3; i++)
+    {
+        header.n[i] = grid.get_n(i);
+        header.min[i] = grid.get_min(i);
+        header.max[i] = grid.get_max(i);
+        header.step[i] = grid.get_step(i);
+    }
+    header.n_nodes = grid.size();
+
+    std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw R3B::runtime_error(system_error("Cannot create field map file", file_name));
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(grid.data()), grid.size() * sizeof(R3BFieldGrid::Node));
+    file.close();
+    if (!file)
+    {
+        throw R3B::runtime_error(system_error("Failed to write field map file", file_name));
+    }
+}
+
+bool R3BFieldMapFile::is_field_map_file(const std::string& file_name)
+{
+    std::ifstream file(file_name, std::ios::binary);
+    char magic[sizeof(Magic)] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, Magic, sizeof(Magic)) == 0;
+}
+
+void R3BFieldMapFile::open(const std::string& file_name, R3BFieldGrid& grid)
+{
+    close();
+
+    const int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw R3B::runtime_error(system_error("Cannot open field map file", file_name));
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0)
+    {
+        ::close(fd);
+        throw R3B::runtime_error(system_error("Cannot stat field map file", file_name));
+    }
+    const auto size = static_cast<std::size_t>(file_stat.st_size);
+    if (size < sizeof(Header))
+    {
+        ::close(fd);
+        throw R3B::runtime_error("Field map file " + file_name + " is too short");
+    }
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (address == MAP_FAILED)
+    {
+        throw R3B::runtime_error(system_error("Cannot map field map file", file_name));
+    }
+    _address = address;
+    _size = size;
+
+    const Header* header = get_header();
+    std::string error;
+    if (std::memcmp(header->magic, Magic, sizeof(Magic)) != 0)
+    {
+        error = "is not a binary field map";
+    }
+    else if (header->version != Version)
+    {
+        error = "has version " + std::to_string(header->version) + ", expected " + std::to_string(Version);
+    }
+    else if (header->byte_order != ByteOrderMark)
+    {
+        error = "was written with a different byte order";
+    }
+    else if (header->header_size != sizeof(Header) || header->n[0] < 2 || header->n[1] < 2 || header->n[2] < 2 ||
+             header->n_nodes != static_cast<std::uint64_t>(header->n[0]) * header->n[1] * header->n[2] ||
+             size != sizeof(Header) + header->n_nodes * sizeof(R3BFieldGrid::Node))
+    {
+        error = "has an inconsistent size";
+    }
+    if (!error.empty())
+    {
+        close();
+        throw R3B::runtime_error("Field map file " + file_name + " " + error);
+    }
+
+    grid.attach(header->n[0],
+                header->n[1],
+                header->n[2],
+                header->min,
+                header->max,
+                header->step,
+                reinterpret_cast<const R3BFieldGrid::Node*>(static_cast<const char*>(_address) + sizeof(Header)));
+}
+
+void R3BFieldMapFile::close()
+{
+    if (_address != nullptr)
+    {
+        munmap(_address, _size);
+        _address = nullptr;
+        _size = 0;
+    }
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BFIELDMAPFILE_H
+#define R3BFIELDMAPFILE_H
+
+#include "R3BFieldGrid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Versioned binary field map file.
+//
+// The file consists of a fixed 128 byte header followed by the nodes of a
+// R3BFieldGrid in their in-memory layout, i.e. (Bx, By, Bz, 0) doubles in
+// x, y, z order. The file is mapped read-only into memory and the grid is
+// attached to the mapping, so loading does not copy or parse anything and
+// all processes on a node share the same page-cache pages.
+//
+// Only files written on a machine with the same byte order can be read.
+
+class R3BFieldMapFile
+{
+  public:
+    static constexpr std::uint32_t Version = 1;
+    static constexpr std::uint32_t ByteOrderMark = 0x01020304;
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t header_size;
+        std::uint32_t byte_order;
+        std::int32_t n[3];
+        double min[3];
+        double max[3];
+        double step[3];
+        std::uint64_t n_nodes;
+        char reserved[16];
+    };
+    static_assert(sizeof(Header) == 128, "field map header must keep its size");
+    static_assert(sizeof(Header) % alignof(R3BFieldGrid::Node) == 0, "field map nodes must be aligned");
+
+    R3BFieldMapFile() = default;
+    ~R3BFieldMapFile() { close(); }
+    R3BFieldMapFile(const R3BFieldMapFile&) = delete;
+    R3BFieldMapFile& operator=(const R3BFieldMapFile&) = delete;
+    R3BFieldMapFile(R3BFieldMapFile&&) = delete;
+    R3BFieldMapFile& operator=(R3BFieldMapFile&&) = delete;
+
+    // Writes the grid to a binary file. Throws R3B::runtime_error on failure.
+    static void write(const std::string& file_name, const R3BFieldGrid& grid);
+
+    // Whether the file starts with the binary field map signature
+    static bool is_field_map_file(const std::string& file_name);
+
+    // Maps the file and attaches the grid to it. Throws R3B::runtime_error if
+    // the file cannot be mapped or is not a valid field map. The grid must be
+    // cleared or re-attached before the file is closed.
+    void open(const std::string& file_name, R3BFieldGrid& grid);
+
+    void close();
+
+    bool is_open() const { return _address != nullptr; }
+
+    const Header* get_header() const { return static_cast<const Header*>(_address); }
+
+    std::size_t get_file_size() const { return _size; }
+
+  private:
+    void* _address = nullptr;
+    std::size_t _size = 0;
+};
+
+#endif // R3BFIELDMAPFILE_H
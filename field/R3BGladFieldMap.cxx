@@ -98,6 +98,10 @@ R3BGladFieldMap::R3BGladFieldMap(const TString& mapName, const TString& fileType
     {
         fFileName += ".root";
     }
+    else if (fileType[0] == 'B')
+    {
+        fFileName += ".fmap";
+    }
     else
     {
         fFileName += ".dat";
@@ -183,10 +187,15 @@ void R3BGladFieldMap::Init()
         ReadAsciiFile(fFileName);
     else if (fFileName.EndsWith(".root"))
         ReadRootFile(fFileName);
+    else if (fFileName.EndsWith(".fmap"))
+        ReadBinaryFile(fFileName);
     else
     {
         R3BLOG(fatal, "No proper file name defined! (" << fFileName.Data() << ")");
     }
+    if (!fMapFile.is_open())
+        FillGrid();
+    UpdateRotation();
     Print();
 }
 // -----------   Get x component of the field   ---------------------------
@@ -223,11 +232,52 @@ Double_t R3BGladFieldMap::GetBz(Double_t x, Double_t y, Double_t z)
  * Input lab coordinates where the field should be calculated.
  * Returns B field vector with rotated components (in Tesla units)
  */
-TVector3 R3BGladFieldMap::GetBtrans(Double_t x, Double_t y, Double_t z)
+TVector3 R3BGladFieldMap::GetBtrans(Double_t x, Double_t y, Double_t z) const
 {
     TVector3 localPoint(x, y, z);
     localPoint += (*gTrans);
+    localPoint.Transform(fInvRotation);
+
+    Double_t b[3];
+    if (!fGrid.interpolate(localPoint.X(), localPoint.Y(), localPoint.Z(), b))
+    {
+        return TVector3(0., 0., 0.);
+    }
+
+    // Set total B vector and transform accordingly
+    TVector3 B(b[0] * fScale, b[1] * fScale, b[2] * fScale);
+    B.Transform(fRotation);
+
+    return B;
+}
+
+// -----------   Get all components of the field   -----------------------
+//
+void R3BGladFieldMap::GetFieldValue(const Double_t point[3], Double_t* bField)
+{
+    TVector3 B = GetBtrans(point[0], point[1], point[2]);
+    bField[0] = B.X() * 10.0; // should be in kGaus units
+    bField[1] = B.Y() * 10.0;
+    bField[2] = B.Z() * 10.0;
+}
 
+// -----------   Get the field for a batch of points   --------------------
+//
+void R3BGladFieldMap::GetFieldValues(const Double_t* points, Int_t n, Double_t* bField) const
+{
+    for (Int_t i = 0; i < n; i++)
+    {
+        TVector3 B = GetBtrans(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+        bField[3 * i] = B.X() * 10.0;
+        bField[3 * i + 1] = B.Y() * 10.0;
+        bField[3 * i + 2] = B.Z() * 10.0;
+    }
+}
+
+// -----------   Field rotation from the Euler angles   -------------------
+//
+void R3BGladFieldMap::UpdateRotation()
+{
     TRotation r;
     // First Euler rotation around Y axis (default: -14 deg)
     r.RotateY(fYAngle * TMath::DegToRad());
@@ -248,65 +298,35 @@ TVector3 R3BGladFieldMap::GetBtrans(Double_t x, Double_t y, Double_t z)
     // final rotation around local Z axis
     r.Rotate(fZAngle * TMath::DegToRad(), v3_localZ);
 
-    auto rr = r.Inverse();
-    localPoint.Transform(rr);
-
-    Int_t ix = 0;
-    Int_t iy = 0;
-    Int_t iz = 0;
-    Double_t dx = 0.;
-    Double_t dy = 0.;
-    Double_t dz = 0.;
-
-    TVector3 B(0., 0., 0.);
+    fRotation = r;
+    fInvRotation = r.Inverse();
+}
 
-    if (!IsInside(localPoint.X(), localPoint.Y(), localPoint.Z(), ix, iy, iz, dx, dy, dz))
+// -----------   Copy the field arrays into the interpolation grid   ------
+//
+void R3BGladFieldMap::FillGrid()
+{
+    const Double_t min[3] = { fXmin, fYmin, fZmin };
+    const Double_t max[3] = { fXmax, fYmax, fZmax };
+    const Double_t step[3] = { fXstep, fYstep, fZstep };
+    fGrid.init(fNx, fNy, fNz, min, max, step);
+    for (Int_t ix = 0; ix < fNx; ix++)
     {
-        return B;
+        for (Int_t iy = 0; iy < fNy; iy++)
+        {
+            for (Int_t iz = 0; iz < fNz; iz++)
+            {
+                Int_t index = ix * fNy * fNz + iy * fNz + iz;
+                fGrid.set_node(ix, iy, iz, fBx->At(index), fBy->At(index), fBz->At(index));
+            }
+        }
     }
 
-    Double_t Bx = 0;
-    Double_t By = 0;
-    Double_t Bz = 0;
-
-    // Get Bx field values at grid cell corners
-    fHa[0][0][0] = fBx->At(ix * fNy * fNz + iy * fNz + iz);
-    fHa[1][0][0] = fBx->At((ix + 1) * fNy * fNz + iy * fNz + iz);
-    fHa[0][1][0] = fBx->At(ix * fNy * fNz + (iy + 1) * fNz + iz);
-    fHa[1][1][0] = fBx->At((ix + 1) * fNy * fNz + (iy + 1) * fNz + iz);
-    fHa[0][0][1] = fBx->At(ix * fNy * fNz + iy * fNz + (iz + 1));
-    fHa[1][0][1] = fBx->At((ix + 1) * fNy * fNz + iy * fNz + (iz + 1));
-    fHa[0][1][1] = fBx->At(ix * fNy * fNz + (iy + 1) * fNz + (iz + 1));
-    fHa[1][1][1] = fBx->At((ix + 1) * fNy * fNz + (iy + 1) * fNz + (iz + 1));
-    Bx = Interpolate(dx, dy, dz);
-
-    // Get By field values at grid cell corners
-    fHa[0][0][0] = fBy->At(ix * fNy * fNz + iy * fNz + iz);
-    fHa[1][0][0] = fBy->At((ix + 1) * fNy * fNz + iy * fNz + iz);
-    fHa[0][1][0] = fBy->At(ix * fNy * fNz + (iy + 1) * fNz + iz);
-    fHa[1][1][0] = fBy->At((ix + 1) * fNy * fNz + (iy + 1) * fNz + iz);
-    fHa[0][0][1] = fBy->At(ix * fNy * fNz + iy * fNz + (iz + 1));
-    fHa[1][0][1] = fBy->At((ix + 1) * fNy * fNz + iy * fNz + (iz + 1));
-    fHa[0][1][1] = fBy->At(ix * fNy * fNz + (iy + 1) * fNz + (iz + 1));
-    fHa[1][1][1] = fBy->At((ix + 1) * fNy * fNz + (iy + 1) * fNz + (iz + 1));
-    By = Interpolate(dx, dy, dz);
-
-    // Get Bz field values at grid cell corners
-    fHa[0][0][0] = fBz->At(ix * fNy * fNz + iy * fNz + iz);
-    fHa[1][0][0] = fBz->At((ix + 1) * fNy * fNz + iy * fNz + iz);
-    fHa[0][1][0] = fBz->At(ix * fNy * fNz + (iy + 1) * fNz + iz);
-    fHa[1][1][0] = fBz->At((ix + 1) * fNy * fNz + (iy + 1) * fNz + iz);
-    fHa[0][0][1] = fBz->At(ix * fNy * fNz + iy * fNz + (iz + 1));
-    fHa[1][0][1] = fBz->At((ix + 1) * fNy * fNz + iy * fNz + (iz + 1));
-    fHa[0][1][1] = fBz->At(ix * fNy * fNz + (iy + 1) * fNz + (iz + 1));
-    fHa[1][1][1] = fBz->At((ix + 1) * fNy * fNz + (iy + 1) * fNz + (iz + 1));
-    Bz = Interpolate(dx, dy, dz);
-
-    // Set total B vector and transform accordingly
-    B.SetXYZ(Bx * fScale, By * fScale, Bz * fScale);
-    B.Transform(r);
-
-    return B;
+    // The grid holds a copy of the field, the arrays are not needed anymore
+    delete fBx;
+    delete fBy;
+    delete fBz;
+    fBx = fBy = fBz = nullptr;
 }
 
 // -----------   Check whether a point is inside the map   ----------------
@@ -396,8 +416,8 @@ void R3BGladFieldMap::WriteAsciiFile(const TString& fileName)
                     Double_t perc = TMath::Nint(100. * index / nTot);
                     cout << "\b\b\b\b\b\b" << setw(3) << perc << " % " << flush;
                 }
-                mapFile << fBx->At(index) / factor << " " << fBy->At(index) / factor << " " << fBz->At(index) / factor
-                        << endl;
+                const auto& node = fGrid.get_node(ix, iy, iz);
+                mapFile << node.b[0] / factor << " " << node.b[1] / factor << " " << node.b[2] / factor << endl;
             } // z-Loop
         }     // y-Loop
     }         // x-Loop
@@ -405,6 +425,23 @@ void R3BGladFieldMap::WriteAsciiFile(const TString& fileName)
     mapFile.close();
 }
 
+// ----------   Write the map to a binary file   --------------------------
+//
+void R3BGladFieldMap::WriteBinaryFile(const TString& fileName)
+{
+    R3BLOG(info, "Writing field map to binary file " << fileName.Data());
+    try
+    {
+        R3BFieldMapFile::write(fileName.Data(), fGrid);
+    }
+    catch (const std::exception& e)
+    {
+        R3BLOG(error, e.what());
+        return;
+    }
+    R3BLOG(info, "   " << fGrid.size() << " written");
+}
+
 // -----  Set the position of the field centre in global coordinates  -----
 //
 void R3BGladFieldMap::SetPosition(Double_t x, Double_t y, Double_t z)
@@ -477,6 +514,8 @@ void R3BGladFieldMap::Reset()
     fNy = 0;
     fNz = 0;
     fScale = 1.;
+    fGrid.clear();
+    fMapFile.close();
     if (fBx)
     {
         delete fBx;
@@ -674,23 +713,36 @@ void R3BGladFieldMap::ReadRootFile(const TString& fileName)
 
     return;
 }
-
-// ------------   Interpolation in a grid cell (private)  -----------------
-Double_t R3BGladFieldMap::Interpolate(Double_t dx, Double_t dy, Double_t dz)
+// -----   Map field from binary file (private)   -------------------------
+//
+void R3BGladFieldMap::ReadBinaryFile(const TString& fileName)
 {
+    R3BLOG(info, "Mapping field map from binary file " << fileName.Data());
+    try
+    {
+        fMapFile.open(fileName.Data(), fGrid);
+    }
+    catch (const std::exception& e)
+    {
+        R3BLOG(fatal, e.what());
+        return;
+    }
 
-    // Interpolate in x coordinate
-    fHb[0][0] = fHa[0][0][0] + (fHa[1][0][0] - fHa[0][0][0]) * dx;
-    fHb[1][0] = fHa[0][1][0] + (fHa[1][1][0] - fHa[0][1][0]) * dx;
-    fHb[0][1] = fHa[0][0][1] + (fHa[1][0][1] - fHa[0][0][1]) * dx;
-    fHb[1][1] = fHa[0][1][1] + (fHa[1][1][1] - fHa[0][1][1]) * dx;
-
-    // Interpolate in y coordinate
-    fHc[0] = fHb[0][0] + (fHb[1][0] - fHb[0][0]) * dy;
-    fHc[1] = fHb[0][1] + (fHb[1][1] - fHb[0][1]) * dy;
-
-    // Interpolate in z coordinate
-    return fHc[0] + (fHc[1] - fHc[0]) * dz;
+    // the grid parameters are the same as for a map read from an ASCII or ROOT file,
+    // the field value arrays are not filled
+    fNx = fGrid.get_n(0);
+    fNy = fGrid.get_n(1);
+    fNz = fGrid.get_n(2);
+    fXmin = fGrid.get_min(0);
+    fYmin = fGrid.get_min(1);
+    fZmin = fGrid.get_min(2);
+    fXmax = fGrid.get_max(0);
+    fYmax = fGrid.get_max(1);
+    fZmax = fGrid.get_max(2);
+    fXstep = fGrid.get_step(0);
+    fYstep = fGrid.get_step(1);
+    fZstep = fGrid.get_step(2);
+    R3BLOG(info, "   " << fGrid.size() << " entries mapped");
 }
 // ------------------------------------------------------------------------
 
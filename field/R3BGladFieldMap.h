@@ -15,6 +15,8 @@
 #define R3BGLADFIELDMAP_H 1
 
 #include "FairField.h"
+#include "R3BFieldGrid.h"
+#include "R3BFieldMapFile.h"
 #include "R3BFieldPar.h"
 #include "TRotation.h"
 #include "TString.h"
@@ -31,7 +33,7 @@ class R3BGladFieldMap : public FairField
 
     /** Standard constructor
      ** @param name       Name of field map file without extension
-     ** @param fileType   R = ROOT file, A = ASCII
+     ** @param fileType   R = ROOT file, A = ASCII, B = binary (memory-mapped)
      **/
     R3BGladFieldMap(const TString& mapName, const TString& fileType = "A");
 
@@ -55,8 +57,20 @@ class R3BGladFieldMap : public FairField
     virtual Double_t GetBy(Double_t x, Double_t y, Double_t z);
     virtual Double_t GetBz(Double_t x, Double_t y, Double_t z);
 
+    /** Get all field components at once [kG], thread-safe
+     ** @param point     Point coordinates (global) [cm]
+     ** @param bField    Field components [kG]
+     **/
+    virtual void GetFieldValue(const Double_t point[3], Double_t* bField);
+
+    /** Batch version of GetFieldValue, thread-safe
+     ** @param points    n consecutive (x, y, z) triplets (global) [cm]
+     ** @param bField    n consecutive (Bx, By, Bz) triplets [kG]
+     **/
+    void GetFieldValues(const Double_t* points, Int_t n, Double_t* bField) const;
+
     // special function for the field transformation
-    TVector3 GetBtrans(Double_t x, Double_t y, Double_t z);
+    TVector3 GetBtrans(Double_t x, Double_t y, Double_t z) const;
 
     /** Determine whether a point is inside the field map
      ** @param x,y,z              Point coordinates (global) [cm]
@@ -77,6 +91,10 @@ class R3BGladFieldMap : public FairField
     /** Write the field map to an ASCII file **/
     void WriteAsciiFile(const TString& fileName);
 
+    /** Write the field map to a binary file (.fmap), which is memory-mapped
+     ** when read. Can be used to convert ASCII or ROOT maps after Init(). **/
+    void WriteBinaryFile(const TString& fileName);
+
     /** Set the position (in cm) of the field origin in lab **/
     virtual void SetPosition(Double_t x, Double_t y, Double_t z);
 
@@ -86,9 +104,21 @@ class R3BGladFieldMap : public FairField
 
     /* Set Euler rotation angles of the field (in degrees)
      * default fYAngle = -14 deg, fXAngle=0, fZAngle=0 */
-    virtual void SetXAngle(Double_t a) { fXAngle = a; };
-    virtual void SetYAngle(Double_t a) { fYAngle = a; };
-    virtual void SetZAngle(Double_t a) { fZAngle = a; };
+    virtual void SetXAngle(Double_t a)
+    {
+        fXAngle = a;
+        UpdateRotation();
+    };
+    virtual void SetYAngle(Double_t a)
+    {
+        fYAngle = a;
+        UpdateRotation();
+    };
+    virtual void SetZAngle(Double_t a)
+    {
+        fZAngle = a;
+        UpdateRotation();
+    };
 
     /** Accessors to field parameters in local coordinate system **/
     Double_t GetXmin() const { return fXmin; }
@@ -117,11 +147,14 @@ class R3BGladFieldMap : public FairField
     /** Accessor to global scaling factor  **/
     Double_t GetScale() const { return fScale; }
 
-    /** Accessors to the field value arrays **/
+    /** Accessors to the field value arrays (released once the grid is filled, see GetGrid()) **/
     TArrayD* GetBx() const { return fBx; }
     TArrayD* GetBy() const { return fBy; }
     TArrayD* GetBz() const { return fBz; }
 
+    /** Accessor to the interleaved field grid used for the interpolation **/
+    const R3BFieldGrid& GetGrid() const { return fGrid; }
+
     /** Accessor to field map file **/
     TString GetFileName() { return fFileName; }
 
@@ -138,10 +171,14 @@ class R3BGladFieldMap : public FairField
     /** Read field map from a ROOT file **/
     void ReadRootFile(const TString& fileName);
 
-    /** Get field values by interpolation of the grid.
-     ** @param dx,dy,dz  Relative distance from grid point [cell units]
-     **/
-    Double_t Interpolate(Double_t dx, Double_t dy, Double_t dz);
+    /** Map a binary field map file (read-only, shared between processes) **/
+    void ReadBinaryFile(const TString& fileName);
+
+    /** Fill the interleaved grid from fBx, fBy and fBz and release the arrays **/
+    void FillGrid();
+
+    /** Recalculate the field rotation from the Euler angles **/
+    void UpdateRotation();
 
     /** Map file name **/
     TString fFileName;
@@ -170,11 +207,15 @@ class R3BGladFieldMap : public FairField
     TArrayD* fBy; //!
     TArrayD* fBz; //!
 
-    /** Variables for temporary storage
-     ** Used in the very frequently called method GetFieldValue  **/
-    Double_t fHa[2][2][2]; //! Field at corners of a grid cell
-    Double_t fHb[2][2];    //! Interpolated field (2-dim)
-    Double_t fHc[2];       //! Interpolated field (1-dim)
+    /** Interleaved (Bx, By, Bz) grid used for the interpolation **/
+    R3BFieldGrid fGrid; //!
+
+    /** Memory-mapped binary field map, if read from one **/
+    R3BFieldMapFile fMapFile; //!
+
+    /** Field rotation and its inverse, see UpdateRotation() **/
+    TRotation fRotation;    //!
+    TRotation fInvRotation; //!
 
     // local transformation
     TRotation* gRot;  //!
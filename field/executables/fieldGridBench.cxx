@@ -0,0 +1,167 @@
+#include "R3BFieldGrid.h"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fmt/format.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr int Nx = 81;
+    constexpr int Ny = 41;
+    constexpr int Nz = 121;
+    constexpr double Min[3] = { -200., -100., -300. };
+    constexpr double Max[3] = { 200., 100., 300. };
+
+    // Per-component layout and interpolation as used by R3BGladFieldMap before the grid was introduced
+    class ReferenceMap
+    {
+      public:
+        std::vector<double> bx, by, bz;
+        double step[3];
+
+        double interpolate(const std::vector<double>& f, int ix, int iy, int iz, double dx, double dy, double dz) const
+        {
+            double ha[2][2][2];
+            for (int i = 0; i < 2; i++)
+                for (int j = 0; j < 2; j++)
+                    for (int k = 0; k < 2; k++)
+                        ha[i][j][k] = f[(ix + i) * Ny * Nz + (iy + j) * Nz + (iz + k)];
+            double hb[2][2];
+            hb[0][0] = ha[0][0][0] + (ha[1][0][0] - ha[0][0][0]) * dx;
+            hb[1][0] = ha[0][1][0] + (ha[1][1][0] - ha[0][1][0]) * dx;
+            hb[0][1] = ha[0][0][1] + (ha[1][0][1] - ha[0][0][1]) * dx;
+            hb[1][1] = ha[0][1][1] + (ha[1][1][1] - ha[0][1][1]) * dx;
+            double hc[2];
+            hc[0] = hb[0][0] + (hb[1][0] - hb[0][0]) * dy;
+            hc[1] = hb[0][1] + (hb[1][1] - hb[0][1]) * dy;
+            return hc[0] + (hc[1] - hc[0]) * dz;
+        }
+
+        bool get(double x, double y, double z, double b[3]) const
+        {
+            b[0] = b[1] = b[2] = 0.;
+            if (!(x >= Min[0] && x < Max[0] && y >= Min[1] && y < Max[1] && z >= Min[2] && z < Max[2]))
+                return false;
+            int ix = int((x - Min[0]) / step[0]);
+            int iy = int((y - Min[1]) / step[1]);
+            int iz = int((z - Min[2]) / step[2]);
+            double dx = (x - Min[0]) / step[0] - double(ix);
+            double dy = (y - Min[1]) / step[1] - double(iy);
+            double dz = (z - Min[2]) / step[2] - double(iz);
+            b[0] = interpolate(bx, ix, iy, iz, dx, dy, dz);
+            b[1] = interpolate(by, ix, iy, iz, dx, dy, dz);
+            b[2] = interpolate(bz, ix, iy, iz, dx, dy, dz);
+            return true;
+        }
+    };
+} // namespace
+
+// Time per point of the per-component interpolation of R3BGladFieldMap before, of the interleaved
+// R3BFieldGrid for single points and of its batch interpolation, on a map of the size of the GLAD map.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of the field grid interpolation" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("pointNum,n", po::value<int>()->default_value(200000), "set number of points");
+    desc.add_options()("repeat", po::value<int>()->default_value(10), "set number of passes over the points");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "fieldGridBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto pointNum = static_cast<size_t>(varMap["pointNum"].as<int>());
+    const auto repeat = varMap["repeat"].as<int>();
+
+    auto ref = ReferenceMap{};
+    auto grid = R3BFieldGrid{};
+    const double step[3] = { (Max[0] - Min[0]) / (Nx - 1), (Max[1] - Min[1]) / (Ny - 1), (Max[2] - Min[2]) / (Nz - 1) };
+    std::copy(step, step + 3, ref.step);
+    grid.init(Nx, Ny, Nz, Min, Max, step);
+
+    auto rng = std::mt19937_64{ 1234 };
+    auto field = std::uniform_real_distribution<double>{ -2., 2. };
+    ref.bx.resize(Nx * Ny * Nz);
+    ref.by.resize(Nx * Ny * Nz);
+    ref.bz.resize(Nx * Ny * Nz);
+    for (int ix = 0; ix < Nx; ix++)
+        for (int iy = 0; iy < Ny; iy++)
+            for (int iz = 0; iz < Nz; iz++)
+            {
+                const int index = ix * Ny * Nz + iy * Nz + iz;
+                ref.bx[index] = field(rng);
+                ref.by[index] = field(rng);
+                ref.bz[index] = field(rng);
+                grid.set_node(ix, iy, iz, ref.bx[index], ref.by[index], ref.bz[index]);
+            }
+
+    // mostly inside, some points outside of the map
+    auto pos = std::uniform_real_distribution<double>{ -1.1, 1.1 };
+    auto points = std::vector<double>(3 * pointNum);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        points[i] = pos(rng) * Max[i % 3];
+    }
+
+    using Clock = std::chrono::steady_clock;
+    double sumRef = 0.;
+    double sumGrid = 0.;
+    double sumBatch = 0.;
+    double b[3];
+    auto batch = std::vector<double>(points.size());
+
+    const auto t0 = Clock::now();
+    for (int r = 0; r < repeat; r++)
+        for (size_t i = 0; i < pointNum; i++)
+        {
+            ref.get(points[3 * i], points[3 * i + 1], points[3 * i + 2], b);
+            sumRef += b[0] + b[1] + b[2];
+        }
+    const auto t1 = Clock::now();
+    for (int r = 0; r < repeat; r++)
+        for (size_t i = 0; i < pointNum; i++)
+        {
+            grid.interpolate(points[3 * i], points[3 * i + 1], points[3 * i + 2], b);
+            sumGrid += b[0] + b[1] + b[2];
+        }
+    const auto t2 = Clock::now();
+    for (int r = 0; r < repeat; r++)
+    {
+        grid.interpolate(points.data(), pointNum, batch.data());
+        for (const auto value : batch)
+        {
+            sumBatch += value;
+        }
+    }
+    const auto t3 = Clock::now();
+
+    if (sumRef != sumGrid)
+    {
+        std::cerr << "fieldGridBench: The grid gives a different field than the per-component interpolation"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto nsPerPoint = [&](auto dt)
+    { return std::chrono::duration<double, std::nano>(dt).count() / static_cast<double>(pointNum * repeat); };
+    fmt::print("{:<28} {:>8.2f} ns/point\n", "per-component interpolation", nsPerPoint(t1 - t0));
+    fmt::print("{:<28} {:>8.2f} ns/point\n", "interleaved grid", nsPerPoint(t2 - t1));
+    fmt::print("{:<28} {:>8.2f} ns/point (sum {:.6g})\n", "interleaved grid, batch", nsPerPoint(t3 - t2), sumBatch);
+    return 0;
+}
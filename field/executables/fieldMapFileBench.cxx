@@ -0,0 +1,124 @@
+#include "R3BException.h"
+#include "R3BFieldGrid.h"
+#include "R3BFieldMapFile.h"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    void WriteRandomMap(const std::string& fileName, int nx, int ny, int nz)
+    {
+        const double min[3] = { -200., -100., -300. };
+        const double max[3] = { 200., 100., 300. };
+        const double step[3] = {
+            (max[0] - min[0]) / (nx - 1), (max[1] - min[1]) / (ny - 1), (max[2] - min[2]) / (nz - 1)
+        };
+        auto grid = R3BFieldGrid{};
+        grid.init(nx, ny, nz, min, max, step);
+        auto rng = std::mt19937_64{ 42 };
+        auto field = std::uniform_real_distribution<double>{ -2., 2. };
+        for (int ix = 0; ix < nx; ix++)
+            for (int iy = 0; iy < ny; iy++)
+                for (int iz = 0; iz < nz; iz++)
+                    grid.set_node(ix, iy, iz, field(rng), field(rng), field(rng));
+        R3BFieldMapFile::write(fileName, grid);
+    }
+} // namespace
+
+// Time to map a binary field map and touch all its nodes, compared to reading the whole file into memory,
+// which is the lower bound for any loader that keeps its own copy of the map.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of binary field map files" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("inputFile",
+                       po::value<std::string>()->default_value(""),
+                       "map this field map file instead of a random one");
+    desc.add_options()("nx", po::value<int>()->default_value(201), "set number of nodes in x of the random map");
+    desc.add_options()("ny", po::value<int>()->default_value(101), "set number of nodes in y of the random map");
+    desc.add_options()("nz", po::value<int>()->default_value(301), "set number of nodes in z of the random map");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "fieldMapFileBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto inputFileName = varMap["inputFile"].as<std::string>();
+    const auto isRandomMap = inputFileName.empty();
+    const auto fileName = isRandomMap ? std::string{ "fieldMapFileBench.fmap" } : inputFileName;
+
+    using Clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+    try
+    {
+        if (isRandomMap)
+        {
+            const auto start = Clock::now();
+            WriteRandomMap(fileName, varMap["nx"].as<int>(), varMap["ny"].as<int>(), varMap["nz"].as<int>());
+            fmt::print("{:<28} {:>10.2f} ms\n", "created random map", ms(Clock::now() - start).count());
+        }
+
+        const auto startMap = Clock::now();
+        auto file = R3BFieldMapFile{};
+        auto mapped = R3BFieldGrid{};
+        file.open(fileName, mapped);
+        auto sum = 0.;
+        for (std::size_t idx = 0; idx < mapped.size(); idx++)
+        {
+            sum += mapped.data()[idx].b[0];
+        }
+        const auto timeMap = Clock::now() - startMap;
+        const auto fileSize = file.get_file_size();
+        const auto nNodes = mapped.size();
+        mapped.clear();
+        file.close();
+
+        const auto startRead = Clock::now();
+        auto content = std::vector<char>(fileSize);
+        auto input = std::ifstream{ fileName, std::ios::binary };
+        input.read(content.data(), static_cast<std::streamsize>(content.size()));
+        const auto timeRead = Clock::now() - startRead;
+
+        fmt::print("{:<28} {:>10.2f} ms ({} nodes, sum {:.6g})\n",
+                   "mapped and touched",
+                   ms(timeMap).count(),
+                   nNodes,
+                   sum);
+        fmt::print("{:<28} {:>10.2f} ms ({:.1f} MB)\n",
+                   "read into memory",
+                   ms(timeRead).count(),
+                   static_cast<double>(fileSize) / (1024. * 1024.));
+    }
+    catch (const R3B::runtime_error& err)
+    {
+        std::cerr << "fieldMapFileBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (isRandomMap)
+    {
+        std::remove(fileName.c_str());
+    }
+    return 0;
+}
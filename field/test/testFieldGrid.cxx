@@ -0,0 +1,159 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BFieldGrid.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr int Nx = 81;
+    constexpr int Ny = 41;
+    constexpr int Nz = 121;
+    constexpr double Min[3] = { -200., -100., -300. };
+    constexpr double Max[3] = { 200., 100., 300. };
+
+    // Per-component layout and interpolation as used by R3BGladFieldMap before the grid was introduced
+    class ReferenceMap
+    {
+      public:
+        std::vector<double> bx, by, bz;
+        double step[3];
+
+        double interpolate(const std::vector<double>& f, int ix, int iy, int iz, double dx, double dy, double dz) const
+        {
+            double ha[2][2][2];
+            for (int i = 0; i < 2; i++)
+                for (int j = 0; j < 2; j++)
+                    for (int k = 0; k < 2; k++)
+                        ha[i][j][k] = f[(ix + i) * Ny * Nz + (iy + j) * Nz + (iz + k)];
+            double hb[2][2];
+            hb[0][0] = ha[0][0][0] + (ha[1][0][0] - ha[0][0][0]) * dx;
+            hb[1][0] = ha[0][1][0] + (ha[1][1][0] - ha[0][1][0]) * dx;
+            hb[0][1] = ha[0][0][1] + (ha[1][0][1] - ha[0][0][1]) * dx;
+            hb[1][1] = ha[0][1][1] + (ha[1][1][1] - ha[0][1][1]) * dx;
+            double hc[2];
+            hc[0] = hb[0][0] + (hb[1][0] - hb[0][0]) * dy;
+            hc[1] = hb[0][1] + (hb[1][1] - hb[0][1]) * dy;
+            return hc[0] + (hc[1] - hc[0]) * dz;
+        }
+
+        bool get(double x, double y, double z, double b[3]) const
+        {
+            b[0] = b[1] = b[2] = 0.;
+            if (!(x >= Min[0] && x < Max[0] && y >= Min[1] && y < Max[1] && z >= Min[2] && z < Max[2]))
+                return false;
+            int ix = int((x - Min[0]) / step[0]);
+            int iy = int((y - Min[1]) / step[1]);
+            int iz = int((z - Min[2]) / step[2]);
+            double dx = (x - Min[0]) / step[0] - double(ix);
+            double dy = (y - Min[1]) / step[1] - double(iy);
+            double dz = (z - Min[2]) / step[2] - double(iz);
+            b[0] = interpolate(bx, ix, iy, iz, dx, dy, dz);
+            b[1] = interpolate(by, ix, iy, iz, dx, dy, dz);
+            b[2] = interpolate(bz, ix, iy, iz, dx, dy, dz);
+            return true;
+        }
+    };
+
+    class testFieldGrid : public ::testing::Test
+    {
+      protected:
+        ReferenceMap ref_;
+        R3BFieldGrid grid_;
+        std::vector<double> points_;
+
+        void SetUp() override
+        {
+            const double step[3] = {
+                (Max[0] - Min[0]) / (Nx - 1), (Max[1] - Min[1]) / (Ny - 1), (Max[2] - Min[2]) / (Nz - 1)
+            };
+            std::copy(step, step + 3, ref_.step);
+            grid_.init(Nx, Ny, Nz, Min, Max, step);
+
+            auto rng = std::mt19937_64{ 1234 };
+            auto field = std::uniform_real_distribution<double>{ -2., 2. };
+            ref_.bx.resize(Nx * Ny * Nz);
+            ref_.by.resize(Nx * Ny * Nz);
+            ref_.bz.resize(Nx * Ny * Nz);
+            for (int ix = 0; ix < Nx; ix++)
+                for (int iy = 0; iy < Ny; iy++)
+                    for (int iz = 0; iz < Nz; iz++)
+                    {
+                        const int index = ix * Ny * Nz + iy * Nz + iz;
+                        ref_.bx[index] = field(rng);
+                        ref_.by[index] = field(rng);
+                        ref_.bz[index] = field(rng);
+                        grid_.set_node(ix, iy, iz, ref_.bx[index], ref_.by[index], ref_.bz[index]);
+                    }
+
+            // mostly inside, some points outside of the map
+            auto pos = std::uniform_real_distribution<double>{ -1.1, 1.1 };
+            points_.resize(3 * 200000);
+            for (size_t i = 0; i < points_.size(); i++)
+            {
+                points_[i] = pos(rng) * Max[i % 3];
+            }
+        }
+    };
+
+    TEST_F(testFieldGrid, same_as_per_component_interpolation)
+    {
+        for (size_t i = 0; i < points_.size(); i += 3)
+        {
+            double b_ref[3];
+            double b[3];
+            const bool ref_inside = ref_.get(points_[i], points_[i + 1], points_[i + 2], b_ref);
+            ASSERT_EQ(ref_inside, grid_.interpolate(points_[i], points_[i + 1], points_[i + 2], b));
+            ASSERT_EQ(b_ref[0], b[0]);
+            ASSERT_EQ(b_ref[1], b[1]);
+            ASSERT_EQ(b_ref[2], b[2]);
+        }
+    }
+
+    TEST_F(testFieldGrid, batch_interpolation)
+    {
+        const size_t n = points_.size() / 3;
+        std::vector<double> b(points_.size());
+        size_t n_inside = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double b_ref[3];
+            n_inside += ref_.get(points_[3 * i], points_[3 * i + 1], points_[3 * i + 2], b_ref) ? 1 : 0;
+        }
+        EXPECT_EQ(n_inside, grid_.interpolate(points_.data(), n, b.data()));
+        for (size_t i = 0; i < n; i++)
+        {
+            double b_single[3];
+            grid_.interpolate(points_[3 * i], points_[3 * i + 1], points_[3 * i + 2], b_single);
+            ASSERT_EQ(b_single[0], b[3 * i]);
+            ASSERT_EQ(b_single[1], b[3 * i + 1]);
+            ASSERT_EQ(b_single[2], b[3 * i + 2]);
+        }
+    }
+
+    TEST_F(testFieldGrid, edges)
+    {
+        double b[3];
+        // last node is not part of the map, as before
+        EXPECT_FALSE(grid_.interpolate(Max[0], 0., 0., b));
+        EXPECT_EQ(0., b[0]);
+        EXPECT_TRUE(grid_.interpolate(Min[0], Min[1], Min[2], b));
+        EXPECT_EQ(ref_.bx[0], b[0]);
+        EXPECT_EQ(ref_.by[0], b[1]);
+        EXPECT_EQ(ref_.bz[0], b[2]);
+    }
+} // namespace
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BException.h"
+#include "R3BFieldGrid.h"
+#include "R3BFieldMapFile.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace
+{
+    class testFieldMapFile : public ::testing::Test
+    {
+      protected:
+        R3BFieldGrid grid_;
+        std::string file_name_ = "testFieldMapFile.fmap";
+
+        void SetUp() override
+        {
+            const double min[3] = { -100., -50., -150. };
+            const double max[3] = { 100., 50., 150. };
+            const double step[3] = { 5., 5., 5. };
+            const int n[3] = { 41, 21, 61 };
+            grid_.init(n[0], n[1], n[2], min, max, step);
+            auto rng = std::mt19937_64{ 42 };
+            auto field = std::uniform_real_distribution<double>{ -2., 2. };
+            for (int ix = 0; ix < n[0]; ix++)
+                for (int iy = 0; iy < n[1]; iy++)
+                    for (int iz = 0; iz < n[2]; iz++)
+                        grid_.set_node(ix, iy, iz, field(rng), field(rng), field(rng));
+            R3BFieldMapFile::write(file_name_, grid_);
+        }
+
+        void TearDown() override { std::remove(file_name_.c_str()); }
+    };
+
+    TEST_F(testFieldMapFile, round_trip)
+    {
+        ASSERT_TRUE(R3BFieldMapFile::is_field_map_file(file_name_));
+
+        R3BFieldMapFile file;
+        R3BFieldGrid mapped;
+        file.open(file_name_, mapped);
+        ASSERT_TRUE(file.is_open());
+        EXPECT_FALSE(mapped.is_owner());
+        ASSERT_EQ(grid_.size(), mapped.size());
+        for (int dim = 0; dim < 3; dim++)
+        {
+            EXPECT_EQ(grid_.get_n(dim), mapped.get_n(dim));
+            EXPECT_EQ(grid_.get_min(dim), mapped.get_min(dim));
+            EXPECT_EQ(grid_.get_max(dim), mapped.get_max(dim));
+            EXPECT_EQ(grid_.get_step(dim), mapped.get_step(dim));
+        }
+
+        auto rng = std::mt19937_64{ 7 };
+        auto pos = std::uniform_real_distribution<double>{ -1.1, 1.1 };
+        for (int i = 0; i < 100000; i++)
+        {
+            const double x = pos(rng) * 100.;
+            const double y = pos(rng) * 50.;
+            const double z = pos(rng) * 150.;
+            double b[3];
+            double b_mapped[3];
+            ASSERT_EQ(grid_.interpolate(x, y, z, b), mapped.interpolate(x, y, z, b_mapped));
+            ASSERT_EQ(b[0], b_mapped[0]);
+            ASSERT_EQ(b[1], b_mapped[1]);
+            ASSERT_EQ(b[2], b_mapped[2]);
+        }
+
+        // a copy of an attached grid shares the mapping
+        R3BFieldGrid copy = mapped;
+        EXPECT_EQ(mapped.data(), copy.data());
+        mapped.clear();
+        file.close();
+        EXPECT_FALSE(file.is_open());
+    }
+
+    TEST_F(testFieldMapFile, invalid_files)
+    {
+        R3BFieldMapFile file;
+        R3BFieldGrid mapped;
+        EXPECT_THROW(file.open("does_not_exist.fmap", mapped), R3B::runtime_error);
+
+        // truncated file
+        {
+            std::ifstream in(file_name_, std::ios::binary);
+            std::string content(1000, '\0');
+            in.read(&content[0], content.size());
+            std::ofstream out(file_name_, std::ios::binary | std::ios::trunc);
+            out.write(content.data(), content.size());
+        }
+        EXPECT_TRUE(R3BFieldMapFile::is_field_map_file(file_name_));
+        EXPECT_THROW(file.open(file_name_, mapped), R3B::runtime_error);
+        EXPECT_FALSE(file.is_open());
+        EXPECT_TRUE(mapped.empty());
+
+        // wrong signature
+        {
+            std::ofstream out(file_name_, std::ios::binary | std::ios::trunc);
+            out << std::string(256, 'x');
+        }
+        EXPECT_FALSE(R3BFieldMapFile::is_field_map_file(file_name_));
+        EXPECT_THROW(file.open(file_name_, mapped), R3B::runtime_error);
+    }
+} // namespace
@@ -96,14 +96,14 @@ Double_t R3BLosProvideTStart::GetTStart() const
         if (losTriggerCalData.back()->GetTimeV_ns(0) > 0.)
         {
             R3BLOG(debug1, "CalData with VFTX trigger info for LOS");
-            return fTimeStitch->GetTime(
-                losCalData.back()->GetMeanTimeVFTX() - losTriggerCalData.back()->GetTimeV_ns(0), "vftx", "vftx");
+            return fTimeStitch->GetTime<R3B::TDC::Vftx>(
+                losCalData.back()->GetMeanTimeVFTX() - losTriggerCalData.back()->GetTimeV_ns(0));
         }
         else
         {
             R3BLOG(debug1, "CalData with Tamex trigger info for LOS");
-            return fTimeStitch->GetTime(
-                losCalData.back()->GetMeanTimeVFTX() - losTriggerCalData.back()->GetTimeL_ns(0), "vftx", "tamex");
+            return fTimeStitch->GetTime<R3B::TDC::Vftx, R3B::TDC::Tamex>(
+                losCalData.back()->GetMeanTimeVFTX() - losTriggerCalData.back()->GetTimeL_ns(0));
         }
     }
 }
@@ -124,7 +124,7 @@ Double_t R3BLosProvideTStart::GetTStartTrigHit() const
     {
 	for (auto it = losHitData.rbegin(); it != losHitData.rend(); ++it)
 	{
-		Double_t tref_t = fTimeStitch->GetTime((*it)->GetTime() - losTriggerData.front()->GetRawTimeNs(), "vftx", "vftx");
+		Double_t tref_t = fTimeStitch->GetTime<R3B::TDC::Vftx>((*it)->GetTime() - losTriggerData.front()->GetRawTimeNs());
 		if(tref_t > edgeL && tref_t < edgeR)
 			return tref_t;
 	}   
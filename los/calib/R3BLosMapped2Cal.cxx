@@ -119,6 +119,8 @@ InitStatus R3BLosMapped2Cal::Init()
         fCalTriggerItems->Clear();
     }
 
+    fTcalLookup.Build(fTcalPar, R3BTCalLookup::Type::VFTX);
+
     return kSUCCESS;
 }
 
@@ -137,6 +139,7 @@ void R3BLosMapped2Cal::SetParContainers()
 InitStatus R3BLosMapped2Cal::ReInit()
 {
     SetParContainers();
+    fTcalLookup.Build(fTcalPar, R3BTCalLookup::Type::VFTX);
     return kSUCCESS;
 }
 
@@ -195,7 +198,7 @@ void R3BLosMapped2Cal::Exec(Option_t* option)
 
         if (iType < 3)
         {
-            R3BTCalModulePar* par = fTcalPar->GetModuleParAt(iDet, iCha, iType + 1);
+            auto* par = fTcalLookup.GetChannel(iDet, iCha, iType + 1);
 
             if (!par)
             {
@@ -205,7 +208,7 @@ void R3BLosMapped2Cal::Exec(Option_t* option)
 
             // Convert TDC to [ns] ...
 
-            times_raw_ns = par->GetTimeVFTX(hit->GetTimeFine());
+            times_raw_ns = fTcalLookup.GetTime(*par, hit->GetTimeFine());
 
             if (times_raw_ns < 0. || times_raw_ns > fClockFreq || IS_NAN(times_raw_ns))
             {
@@ -466,7 +469,7 @@ void R3BLosMapped2Cal::Exec(Option_t* option)
             }
 
             // Tcal parameters.
-            auto par = fTcalPar->GetModuleParAt(2 + iDetector, iChannel, iType);
+            auto par = fTcalLookup.GetChannel(2 + iDetector, iChannel, iType);
             if (!par)
             {
                 R3BLOG(warn, "Trigger Tcal par not found.");
@@ -474,7 +477,7 @@ void R3BLosMapped2Cal::Exec(Option_t* option)
             }
 
             // Convert TDC to [ns] ...
-            Double_t time_ns = par->GetTimeVFTX(mapped->GetTimeFine());
+            Double_t time_ns = fTcalLookup.GetTime(*par, mapped->GetTimeFine());
             // ... and subtract it from the next clock cycle.
             if (time_ns > 0.)
             {
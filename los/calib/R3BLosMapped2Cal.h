@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "FairTask.h"
+#include "R3BTCalLookup.h"
 
 class TClonesArray;
 class TH1F;
@@ -130,8 +131,9 @@ class R3BLosMapped2Cal : public FairTask
 
     Int_t fNofCalItems; /**< Number of produced time items per event. */
 
-    R3BTCalPar* fTcalPar; /**< TCAL parameter container. */
-    UInt_t fNofTcalPars;  /**< Number of modules in parameter file. */
+    R3BTCalPar* fTcalPar;       /**< TCAL parameter container. */
+    R3BTCalLookup fTcalLookup;  //!< Flat TCAL table, rebuilt in Init()/ReInit().
+    UInt_t fNofTcalPars;        /**< Number of modules in parameter file. */
 
     // check for trigger should be done globablly (somewhere else)
     R3BEventHeader* header; /**< Event header. */
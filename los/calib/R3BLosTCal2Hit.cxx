@@ -300,7 +300,7 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
                 if (typ == 0)
                 {
                     Double_t t_ref = 0.;
-                    t_ref = fTimeStitch->GetTime(rawTime - trigTime[typ], "vftx", "vftx");
+                    t_ref = fTimeStitch->GetTime<R3B::TDC::Vftx>(rawTime - trigTime[typ]);
                     if (fabs((avg_v[d][i] / v_npmt[d][i]) - t_ref) < fWindowV)
                     {
                         v_npmt[d][i]++;
@@ -310,7 +310,7 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
                             return;
                         }
                         vTime[d * 8 + ch - 1][i] = rawTime;
-                        avg_v[d][i] += fTimeStitch->GetTime(rawTime - trigTime[typ], "vftx", "vftx");
+                        avg_v[d][i] += fTimeStitch->GetTime<R3B::TDC::Vftx>(rawTime - trigTime[typ]);
                         tHit[d * 8 * 3 + (ch - 1) * 3 + typ][i] = true;
                         inHit = true;
                     }
@@ -320,8 +320,8 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
                     if (v_npmt[d][i] != 8)
                         continue;
                     Double_t t_ref = 0., tdiff = 0.;
-                    t_ref = fTimeStitch->GetTime(rawTime - trigTime[typ], "tamex", "tamex");
-                    tdiff = fTimeStitch->GetTime(t_ref - avg_v[d][i] / 8., "tamex", "vftx");
+                    t_ref = fTimeStitch->GetTime<R3B::TDC::Tamex>(rawTime - trigTime[typ]);
+                    tdiff = fTimeStitch->GetTime<R3B::TDC::Tamex, R3B::TDC::Vftx>(t_ref - avg_v[d][i] / 8.);
                     if (tdiff > fLEMatchParams->GetAt(fNumParamsTamexLE * (ch - 1) + 0) &&
                         tdiff < fLEMatchParams->GetAt(fNumParamsTamexLE * (ch - 1) + 1) && tle_npmt[d][i] < 8)
                     {
@@ -340,7 +340,7 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
                             break;
                         }
                         TLeTime[d * 8 + ch - 1][i] = rawTime;
-                        avg_t[d][i] += fTimeStitch->GetTime(rawTime - trigTime[typ], "tamex", "tamex");
+                        avg_t[d][i] += fTimeStitch->GetTime<R3B::TDC::Tamex>(rawTime - trigTime[typ]);
                         tHit[d * 8 * 3 + (ch - 1) * 3 + typ][i] = true;
                         hitNo = i;
                         detNo = d;
@@ -352,8 +352,8 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
                     if (tle_npmt[d][i] != 8)
                         continue;
                     Double_t t_ref = 0., tdiff = 0.;
-                    t_ref = fTimeStitch->GetTime(rawTime - trigTime[1], "tamex", "tamex");
-                    tdiff = fTimeStitch->GetTime(t_ref - avg_t[d][i] / 8., "tamex", "tamex");
+                    t_ref = fTimeStitch->GetTime<R3B::TDC::Tamex>(rawTime - trigTime[1]);
+                    tdiff = fTimeStitch->GetTime<R3B::TDC::Tamex>(t_ref - avg_t[d][i] / 8.);
                     if (tdiff > fTEMatchParams->GetAt(fNumParamsTamexTE * (ch - 1) + 0) &&
                         tdiff < fTEMatchParams->GetAt(fNumParamsTamexTE * (ch - 1) + 1) && tte_npmt[d][i] < 8)
                     {
@@ -387,7 +387,7 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
             vTime[(det - 1) * 8 + ch - 1][hits[det - 1]] = rawTime;
             tHit[(det - 1) * 8 * 3 + (ch - 1) * 3 + typ][hits[det - 1]] = true;
             v_npmt[(det - 1)][hits[det - 1]]++;
-            avg_v[(det - 1)][hits[det - 1]] += fTimeStitch->GetTime(rawTime - trigTime[typ], "vftx", "vftx");
+            avg_v[(det - 1)][hits[det - 1]] += fTimeStitch->GetTime<R3B::TDC::Vftx>(rawTime - trigTime[typ]);
             hits[det - 1]++;
         }
     }
@@ -419,9 +419,9 @@ void R3BLosTCal2Hit::Exec(Option_t* option)
                 for (Int_t pm = 0; pm < 8; pm++)
                 {
                     Double_t tle_ref = 0., tte_ref = 0.;
-                    tle_ref = fTimeStitch->GetTime(TLeTime[d * 8 + pm][i] - trigTime[1], "tamex", "tamex");
-                    tte_ref = fTimeStitch->GetTime(TTeTime[d * 8 + pm][i] - trigTime[1], "tamex", "tamex");
-                    tot += fTimeStitch->GetTime(tte_ref - tle_ref, "tamex", "tamex");
+                    tle_ref = fTimeStitch->GetTime<R3B::TDC::Tamex>(TLeTime[d * 8 + pm][i] - trigTime[1]);
+                    tte_ref = fTimeStitch->GetTime<R3B::TDC::Tamex>(TTeTime[d * 8 + pm][i] - trigTime[1]);
+                    tot += fTimeStitch->GetTime<R3B::TDC::Tamex>(tte_ref - tle_ref);
                 }
                 tot = tot / 8.;
                 Z = tot * fp1 + fp0;
@@ -18,11 +18,8 @@
 
 // ROOT headers
 #include "TClonesArray.h"
-#include "TDecompSVD.h"
 #include "TMath.h"
-#include "TMatrixD.h"
 #include "TRandom.h"
-#include "TVectorD.h"
 
 // Fair headers
 #include "FairLogger.h"
@@ -103,7 +100,9 @@ void R3BMusicCal2Hit::SetParameter()
     for (Int_t i = 0; i < fNumAnodes; i++)
     {
         fStatusAnodes[i] = fCal_Par->GetInUse(i + 1);
+        fPosAnodes[i] = fCal_Par->GetAnodePos(i + 1);
     }
+    fAngleFit.SetPositions(fPosAnodes, fNumAnodes);
 
     fNumParams = fCal_Par->GetNumParZFit(); // Number of Parameters
     LOG(info) << "R3BMusicCal2Hit::SetParameter() Nb parameters for charge-Z: " << fNumParams;
@@ -223,13 +222,14 @@ void R3BMusicCal2Hit::Exec(Option_t*)
     Double_t nba = 0., theta = 0., Esum = 0.;
     // calculate truncated dE from 8 anodes, MUSIC
     fNumAnodesAngleFit = 0;
+    fAngleFit.Clear();
     for (Int_t j = 0; j < fNumAnodes; j++)
     {
         if (energyperanode[j] > 0. && fStatusAnodes[j] == 1)
         {
             Esum = Esum + energyperanode[j];
             good_dt[fNumAnodesAngleFit] = dt[j];
-            fPosAnodes[fNumAnodesAngleFit] = fCal_Par->GetAnodePos(j + 1);
+            fAngleFit.Add(j, dt[j]);
             fNumAnodesAngleFit++;
             nba++;
         }
@@ -240,25 +240,14 @@ void R3BMusicCal2Hit::Exec(Option_t*)
 
     if (fNumAnodesAngleFit > 2 && Esum / nba > 0.)
     {
-        fPosZ.Use(fNumAnodesAngleFit, fPosAnodes);
-        TMatrixD A(fNumAnodesAngleFit, 2);
-        TMatrixDColumn(A, 0) = 1.0;
-        TMatrixDColumn(A, 1) = fPosZ;
-
-        // singular value decomposition of matrix A
-        //(generalizes the eigendecomposition of a square normal matrix with an orthonormal eigenbasis
-        // to any m × n matrix)
-        TDecompSVD svd(A);
-        Bool_t ok;
-        TVectorD dt_r;
-        dt_r.Use(fNumAnodesAngleFit, good_dt);
-        TVectorD c_svd_r = svd.Solve(dt_r, ok);
-        theta = c_svd_r[1];
+        Double_t offset = 0.;
+        fAngleFit.Solve(offset, theta);
 
         Double_t sqrtEsum_nba_rot = fy0_point + (theta * 1000 - fx0_point) * sin(frot_ang) +
                                     (TMath::Sqrt(Esum / nba) - fy0_point) * cos(frot_ang);
         Double_t Esum_nba_rot = sqrtEsum_nba_rot * sqrtEsum_nba_rot;
-        Double_t zhit = fZ0 + fZ1 * sqrtEsum_nba_rot + fZ2 * Esum_nba_rot;
+        const Float_t zpar[3] = { fZ0, fZ1, fZ2 };
+        Double_t zhit = R3B::IonChamber::Polynomial(sqrtEsum_nba_rot, zpar, 3);
         if (zhit > 0)
             AddHitData(theta, zhit, Esum_nba_rot);
     }
@@ -298,13 +287,14 @@ void R3BMusicCal2Hit::ExecSim(int nHits)
     Double_t nba = 0., theta = 0., Esum = 0.;
     // calculate truncated dE from 8 anodes, MUSIC
     fNumAnodesAngleFit = 0;
+    fAngleFit.Clear();
     for (Int_t j = 0; j < fNumAnodes; j++)
     {
         if (energyperanode[j] > 0. && fStatusAnodes[j] == 1)
         {
             Esum = Esum + energyperanode[j];
             good_dt[fNumAnodesAngleFit] = dt[j];
-            fPosAnodes[fNumAnodesAngleFit] = fCal_Par->GetAnodePos(j + 1);
+            fAngleFit.Add(j, dt[j]);
             fNumAnodesAngleFit++;
             nba++;
         }
@@ -312,16 +302,8 @@ void R3BMusicCal2Hit::ExecSim(int nHits)
 
     if (Esum / nba > 0.)
     {
-        fPosZ.Use(fNumAnodesAngleFit, fPosAnodes);
-        TMatrixD A(fNumAnodesAngleFit, 2);
-        TMatrixDColumn(A, 0) = 1.0;
-        TMatrixDColumn(A, 1) = fPosZ;
-        TDecompSVD svd(A);
-        Bool_t ok;
-        TVectorD dt_r;
-        dt_r.Use(fNumAnodesAngleFit, good_dt);
-        TVectorD c_svd_r = svd.Solve(dt_r, ok);
-        theta = c_svd_r[1];
+        Double_t offset = 0.;
+        fAngleFit.Solve(offset, theta);
 
         Double_t zhit = fZ0 + fZ1 * TMath::Sqrt(Esum / nba);
 
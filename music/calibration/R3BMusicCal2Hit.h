@@ -21,9 +21,9 @@
 #define R3BMusicCal2Hit_H
 
 #include "FairTask.h"
+#include "R3BIonChamberFit.h"
 #include "R3BMusicHitData.h"
 #include "TH1F.h"
-#include "TVectorD.h"
 #include <TRandom.h>
 
 class TClonesArray;
@@ -76,7 +76,7 @@ class R3BMusicCal2Hit : public FairTask
     TArrayF* CalAngCorParams;
     Int_t fStatusAnodes[8]; // Status anodes
     Double_t fPosAnodes[8]; // Position-Z of each anode
-    TVectorD fPosZ;
+    R3B::IonChamber::LineFit<8> fAngleFit; //! Drift time vs position of the anodes
     bool fSim;
     Bool_t fOnline; // Don't store data for online
 
@@ -13,10 +13,8 @@
 
 // ROOT headers
 #include "TClonesArray.h"
-#include "TDecompSVD.h"
 #include "TMath.h"
 #include "TRandom.h"
-#include "TVectorD.h"
 
 // Fair headers
 #include "FairLogger.h"
@@ -113,6 +111,20 @@ void R3BMusliCal2Hit::SetParameters()
     fZHitParams = new TArrayD();
     fZHitParams->Set(fNumTypes);
     fZHitParams = fHit_Par->GetZHitParams();
+
+    // GetPosZ() gives the center of the chamber in cm
+    // width of one anode is 25. mm -> one pair is 50.
+    // starts the theta calculation in the middle of the second pair
+    //                              i.e.  125 mm. upstream GetPosZ()
+    if (fMusliGeo_Par)
+    {
+        Double_t musliZpos[6];
+        for (Int_t i = 0; i < 6; i++)
+        {
+            musliZpos[i] = fMusliGeo_Par->GetPosZ() * 10. - 125. + i * 50.; // [mm]
+        }
+        fThetaFit.SetPositions(musliZpos, 6);
+    }
 }
 
 // -----   Public method Init   --------------------------------------------
@@ -265,28 +277,16 @@ void R3BMusliCal2Hit::Exec(Option_t* option)
         if (type == 1 && nba[type - 1] == 8)
         { // one ion only along the full Z path in the music
 
-            Double_t musliZpos[6];
-            Double_t musliXpos[6];
-            for (int i = 0; i < 6; i++)
+            fThetaFit.Clear();
+            for (Int_t i = 0; i < 6; i++)
+            {
+                fThetaFit.Add(i, dt_cal[0][i + 1]); // only mult_cal[i] == 1 is selected
+            }
+            Double_t offset = 0., slope = 0.;
+            if (fThetaFit.Solve(offset, slope))
             {
-                // GetPosZ() gives the center of the chamber in cm
-                // width of one anode is 25. mm -> one pair is 50.
-                // starts the theta calculation in the middle of the second pair
-                //                              i.e.  125 mm. upstream GetPosZ()
-                musliZpos[i] = fMusliGeo_Par->GetPosZ() * 10. - 125. + i * 50.; // [mm]
-                musliXpos[i] = dt_cal[0][i + 1];                                // only mult_cal[i] == 1 is selected
+                theta_hit[type - 1] = TMath::ATan(slope);
             }
-            TVectorD VectX;
-            VectX.Use(6, musliXpos);
-            TVectorD VectZ;
-            VectZ.Use(6, musliZpos);
-            TMatrixD MatXZ(6, 2);
-            TMatrixDColumn(MatXZ, 0) = 1.0;
-            TMatrixDColumn(MatXZ, 1) = VectZ;
-            TDecompSVD svdFit(MatXZ);
-            Bool_t bFit;
-            const TVectorD VectSvdFit = svdFit.Solve(VectX, bFit);
-            theta_hit[type - 1] = TMath::ATan(VectSvdFit[1]);
         }
 
         if (nba[type - 1] > 0)
@@ -299,10 +299,7 @@ void R3BMusliCal2Hit::Exec(Option_t* option)
         }
         if (e_hit[type - 1] > 0)
         {
-            z_hit[type - 1] = SqrtE2Z(sqrt(e_hit[type - 1]),
-                                      fZHitParams->GetAt((type - 1) * fNumZ),
-                                      fZHitParams->GetAt((type - 1) * fNumZ + 1),
-                                      fZHitParams->GetAt((type - 1) * fNumZ + 2));
+            z_hit[type - 1] = SqrtE2Z(sqrt(e_hit[type - 1]), fZHitParams->GetArray() + (type - 1) * fNumZ);
             AddHitData(type, e_hit[type - 1], z_hit[type - 1], x_hit[type - 1], theta_hit[type - 1]);
         }
     }
@@ -18,6 +18,7 @@
 
 #include "FairTask.h"
 #include "R3BFrsData.h"
+#include "R3BIonChamberFit.h"
 #include "R3BMusliCalData.h"
 #include "R3BMusliHitData.h"
 
@@ -70,10 +71,7 @@ class R3BMusliCal2Hit : public FairTask
     void SetParameters();
     Double_t BetaCorr_pol1(Double_t beta, Double_t p0, Double_t p1) { return p0 + p1 * beta; }
     Double_t BetaCorr_std(Double_t beta, Double_t p0, Double_t p1) { return p0 + p1 * pow(beta, -5. / 3.); }
-    Double_t SqrtE2Z(Double_t SqrtE, Double_t p0, Double_t p1, Double_t p2)
-    {
-        return p0 + p1 * SqrtE + p2 * SqrtE * SqrtE;
-    }
+    Double_t SqrtE2Z(Double_t SqrtE, const Double_t* p) { return R3B::IonChamber::Polynomial(SqrtE, p, 3); }
 
     //    R3BEventHeader* header; /**< Event header. */
 
@@ -102,6 +100,7 @@ class R3BMusliCal2Hit : public FairTask
     Double_t dt_cal[MAX_MULT_MUSLI][MAX_NUM_GROUPS_CAL];
     Double_t x_hit[MAX_NUM_TYPES_HIT];
     Double_t theta_hit[MAX_NUM_TYPES_HIT];
+    R3B::IonChamber::LineFit<6> fThetaFit; //! Drift time vs position of the anode pairs 2 to 7
 
     R3BMusliHitPar* fHit_Par;      /**< Parameter container. > */
     R3BTGeoPar* fMusliGeo_Par;     /**< Parameter container. > */
@@ -0,0 +1,498 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BMWPCPADPLANE_H
+#define R3BMWPCPADPLANE_H 1
+
+#include "TMath.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Hit reconstruction of the pad planes of the MWPCs, shared by the Cal2Hit
+ * tasks of MWPC0, MWPC1, MWPC2 and MWPC3.
+ *
+ * Each detector is described by a layout struct with its number of pads, pad
+ * widths, active size and the number of planes measuring X. PadPlane<Layout>
+ * collects the cal hits of one event into fixed-size charge rows and into
+ * lists in input order, then finds the pads of maximum charge and the
+ * positions with the hyperbolic secant of the induced charge:
+ *
+ *     auto pads = R3B::Mwpc::PadPlane<R3B::Mwpc::Mwpc3>{};
+ *     pads.Clear();
+ *     pads.Add(plane, pad, q); // for every cal hit
+ *     for (const auto& hit : pads.ReconstructSingleHit()) { ... }
+ *
+ * Planes 1 (and 2 for two X planes) measure X, all other planes Y.
+ */
+namespace R3B::Mwpc
+{
+    struct Mwpc0
+    {
+        static constexpr int pads_x = 64;
+        static constexpr int pads_y = 64;
+        static constexpr double pad_width_x = 3.125; // mm
+        static constexpr double pad_width_y = 3.125; // mm
+        static constexpr double size_x = 200.;       // mm
+        static constexpr double size_y = 200.;       // mm
+        static constexpr int x_planes = 1;
+        static constexpr int first_peak_pad = 2; // lowest pad accepted as maximum of a single hit
+        using Charge = int;                      // type of the charge rows
+    };
+
+    struct Mwpc1
+    {
+        static constexpr int pads_x = 64;
+        static constexpr int pads_y = 40;
+        static constexpr double pad_width_x = 3.125;
+        static constexpr double pad_width_y = 5.;
+        static constexpr double size_x = 200.;
+        static constexpr double size_y = 200.;
+        static constexpr int x_planes = 2; // X up and X down
+        static constexpr int first_peak_pad = 2;
+        using Charge = int;
+    };
+
+    struct Mwpc2 : Mwpc1
+    {
+    };
+
+    struct Mwpc3
+    {
+        static constexpr int pads_x = 288;
+        static constexpr int pads_y = 120;
+        static constexpr double pad_width_x = 3.125;
+        static constexpr double pad_width_y = 5.;
+        static constexpr double size_x = 900.;
+        static constexpr double size_y = 600.;
+        static constexpr int x_planes = 1;
+        static constexpr int first_peak_pad = 1;
+        using Charge = double;
+    };
+
+    // Pad with the maximum charge, pad -1 if there is none
+    struct Peak
+    {
+        int pad = -1;
+        double q = 0.;
+    };
+
+    struct Hit
+    {
+        double x = 0.;
+        double y = 0.;
+        int plane = 0; // X plane of the two hit reconstruction with two X planes
+    };
+
+    // Position value of the two hit reconstruction for a peak below threshold or without neighbours
+    inline constexpr double NoPosition = -1000.;
+
+    /**
+     * Charges of the pads of one plane. Clear() is a fill of a fixed-size
+     * array, which the compiler turns into vector stores. Pads outside of
+     * the row are not stored and read back as zero.
+     */
+    template <typename Charge, int Size>
+    class PadRow
+    {
+      public:
+        void Clear() { fQ.fill(Charge{}); }
+
+        void Set(int pad, double q)
+        {
+            if (IsInside(pad))
+            {
+                fQ[pad] = static_cast<Charge>(q);
+            }
+        }
+
+        void Add(int pad, double q)
+        {
+            if (IsInside(pad))
+            {
+                fQ[pad] = static_cast<Charge>(fQ[pad] + q);
+            }
+        }
+
+        [[nodiscard]] auto operator[](int pad) const -> double
+        {
+            return IsInside(pad) ? static_cast<double>(fQ[pad]) : 0.;
+        }
+
+        [[nodiscard]] static constexpr auto IsInside(int pad) -> bool { return pad >= 0 && pad < Size; }
+
+      private:
+        std::array<Charge, Size> fQ{};
+    };
+
+    /**
+     * Charges and pads of the hits of one plane in input order, as structure of
+     * arrays. The peaks are found by a linear scan instead of sorting pairs of
+     * charge and pad: First() is the hit of largest charge, Next() the one of
+     * largest charge once the charges around a peak are set to zero. Equal
+     * charges are resolved by input order, as a stable sort does.
+     */
+    class HitList
+    {
+      public:
+        void Clear()
+        {
+            fQ.clear();
+            fPad.clear();
+        }
+
+        void Add(int pad, double q)
+        {
+            fQ.push_back(q);
+            fPad.push_back(pad);
+        }
+
+        [[nodiscard]] auto GetSize() const -> std::size_t { return fQ.size(); }
+        [[nodiscard]] auto IsEmpty() const -> bool { return fQ.empty(); }
+
+        [[nodiscard]] auto First() const -> Peak
+        {
+            if (fQ.empty())
+            {
+                return {};
+            }
+            auto const idx = FirstOf(fQ, MaxOf(fQ));
+            return { fPad[idx], fQ[idx] };
+        }
+
+        // Peak after setting the charges of the pads within the window around the given peak to zero
+        [[nodiscard]] auto Next(const Peak& peak, int window = 3) -> Peak
+        {
+            if (fQ.empty())
+            {
+                return {};
+            }
+            fMasked.resize(fQ.size());
+            for (std::size_t idx = 0; idx < fQ.size(); ++idx)
+            {
+                fMasked[idx] = std::abs(fPad[idx] - peak.pad) <= window ? 0. : fQ[idx];
+            }
+            auto const qmax = MaxOf(fMasked);
+            auto best = FirstOf(fMasked, qmax);
+            // among equal charges, the ones set to zero keep their order by charge
+            for (auto idx = best + 1; idx < fQ.size(); ++idx)
+            {
+                if (fMasked[idx] == qmax && fQ[idx] > fQ[best])
+                {
+                    best = idx;
+                }
+            }
+            return { fPad[best], qmax };
+        }
+
+      private:
+        std::vector<double> fQ;
+        std::vector<int> fPad;
+        std::vector<double> fMasked;
+
+        // Maximum over four independent lanes without branches
+        [[nodiscard]] static auto MaxOf(const std::vector<double>& values) -> double
+        {
+            constexpr std::size_t lanes = 4;
+            auto lane = std::array<double, lanes>{};
+            lane.fill(values.front());
+            auto const size = values.size();
+            auto idx = std::size_t{};
+            for (; idx + lanes <= size; idx += lanes)
+            {
+                for (std::size_t ilane = 0; ilane < lanes; ++ilane)
+                {
+                    lane[ilane] = std::max(lane[ilane], values[idx + ilane]);
+                }
+            }
+            for (; idx < size; ++idx)
+            {
+                lane[0] = std::max(lane[0], values[idx]);
+            }
+            return std::max(std::max(lane[0], lane[1]), std::max(lane[2], lane[3]));
+        }
+
+        [[nodiscard]] static auto FirstOf(const std::vector<double>& values, double value) -> std::size_t
+        {
+            return static_cast<std::size_t>(std::find(values.begin(), values.end(), value) - values.begin());
+        }
+    };
+
+    template <typename Layout>
+    class PadPlane
+    {
+      public:
+        using Charge = typename Layout::Charge;
+        static_assert(Layout::x_planes == 1 || Layout::x_planes == 2, "MWPC with one or two X planes");
+
+        PadPlane()
+        {
+            fHits.reserve(2);
+            Clear();
+        }
+
+        void Clear()
+        {
+            fX.Clear();
+            fY.Clear();
+            fYList.Clear();
+            for (int plane = 0; plane < Layout::x_planes; ++plane)
+            {
+                fXPlane[plane].Clear();
+                fXList[plane].Clear();
+            }
+            fPeakX = {};
+            fPeakY = {};
+        }
+
+        // Adds a cal hit, pads count from 0
+        void Add(int plane, int pad, double q)
+        {
+            if (IsXPlane(plane))
+            {
+                if constexpr (Layout::x_planes == 2)
+                {
+                    // FIXME: in November this should be OK!
+                    fX.Add(pad, q); // sum of X up and X down
+                }
+                else
+                {
+                    fX.Set(pad, q);
+                }
+                fXPlane[plane - 1].Set(pad, q);
+                fXList[plane - 1].Add(pad, q);
+                if (q > fPeakX.q)
+                {
+                    fPeakX = { pad, q };
+                }
+            }
+            else
+            {
+                fY.Set(pad, q);
+                fYList.Add(pad, q);
+                if (q > fPeakY.q && plane == 3)
+                {
+                    fPeakY = { pad, q };
+                }
+            }
+        }
+
+        /**
+         * One hit from the pads of maximum charge in X and in Y, over all X planes.
+         * A position without charge on both neighbours is NaN. With
+         * centreOfGravityY the Y position is the centre of gravity of the three pads.
+         */
+        [[nodiscard]] auto ReconstructSingleHit(bool centreOfGravityY = false) -> const std::vector<Hit>&
+        {
+            fHits.clear();
+            auto const padx = fPeakX.pad;
+            auto const pady = fPeakY.pad;
+            if (padx < Layout::first_peak_pad || pady < Layout::first_peak_pad || padx + 1 >= Layout::pads_x ||
+                pady + 1 >= Layout::pads_y || fPeakX.q <= 0 || fPeakY.q <= 0)
+            {
+                return fHits;
+            }
+
+            auto hit = Hit{ NAN, NAN };
+            auto const qleft = fX[padx - 1];
+            auto const qright = fX[padx + 1];
+            if (qleft > 0 && qright > 0)
+            {
+                hit.x = PositionX(fPeakX.q, padx, qleft, qright);
+            }
+            auto const qdown = fY[pady - 1];
+            auto const qup = fY[pady + 1];
+            // TODO: check if systematic statistics loss is experiment specific, put general solution if not
+            if (centreOfGravityY)
+            {
+                hit.y = PositionYCoG(fPeakY.q, pady, qdown, qup);
+            }
+            else if (qdown > 0 && qup > 0)
+            {
+                hit.y = PositionY(fPeakY.q, pady, qdown, qup);
+            }
+            fHits.push_back(hit);
+            return fHits;
+        }
+
+        /**
+         * Up to two hits from the largest and the second largest charge in X and in Y,
+         * the second one being at least four pads away from the first one. Peaks
+         * up to a charge of 10 give NoPosition.
+         */
+        [[nodiscard]] auto ReconstructTwoHits() -> const std::vector<Hit>&
+        {
+            fHits.clear();
+            if constexpr (Layout::x_planes == 2)
+            {
+                ReconstructTwoHitsTwoPlanes();
+            }
+            else
+            {
+                ReconstructTwoHitsOnePlane();
+            }
+            return fHits;
+        }
+
+        [[nodiscard]] static auto PositionX(double qmax, int padmax, double qleft, double qright) -> double
+        {
+            return -1. * padmax * Layout::pad_width_x + (Layout::size_x / 2) - (Layout::pad_width_x / 2) -
+                   Displacement(Layout::pad_width_x, qmax, qleft, qright); // Left is positive and right negative
+        }
+
+        // Without charge on one of the neighbours the position is the centre of the pad
+        [[nodiscard]] static auto PositionY(double qmax, int padmax, double qdown, double qup) -> double
+        {
+            auto const a2 = (qdown != 0 && qup != 0) ? Displacement(Layout::pad_width_y, qmax, qdown, qup) : 0.;
+            return (padmax * Layout::pad_width_y - (Layout::size_y / 2) + (Layout::pad_width_y / 2) + a2);
+        }
+
+        [[nodiscard]] static auto PositionYCoG(double qmax, int padmax, double qdown, double qup) -> double
+        {
+            auto const pos1 = PadCentreY(padmax - 1);
+            auto const pos2 = PadCentreY(padmax);
+            auto const pos3 = PadCentreY(padmax + 1);
+            return (pos1 * qdown + pos2 * qmax + pos3 * qup) / (qmax + qdown + qup);
+        }
+
+        [[nodiscard]] static constexpr auto IsXPlane(int plane) -> bool
+        {
+            return plane >= 1 && plane <= Layout::x_planes;
+        }
+
+        [[nodiscard]] auto GetPeakX() const -> const Peak& { return fPeakX; }
+        [[nodiscard]] auto GetPeakY() const -> const Peak& { return fPeakY; }
+
+      private:
+        PadRow<Charge, Layout::pads_x> fX; // X planes summed
+        PadRow<Charge, Layout::pads_y> fY;
+        std::array<PadRow<Charge, Layout::pads_x>, Layout::x_planes> fXPlane;
+        std::array<HitList, Layout::x_planes> fXList;
+        HitList fYList;
+        Peak fPeakX;
+        Peak fPeakY;
+        std::vector<Hit> fHits;
+
+        // Shift of the hit from the centre of the pad of maximum charge
+        [[nodiscard]] static auto Displacement(double width, double qmax, double q1, double q2) -> double
+        {
+            auto const a3 =
+                TMath::Pi() * width / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / q1) + TMath::Sqrt(qmax / q2))));
+            return (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / q1) - TMath::Sqrt(qmax / q2)) /
+                                                     (2 * TMath::SinH(TMath::Pi() * width / a3)));
+        }
+
+        [[nodiscard]] static auto PadCentreY(int pad) -> double
+        {
+            return pad * Layout::pad_width_y - (Layout::size_y / 2) + (Layout::pad_width_y / 2);
+        }
+
+        [[nodiscard]] static auto TwoHitX(const PadRow<Charge, Layout::pads_x>& row, double qmax, int pad) -> double
+        {
+            auto const qleft = row[pad - 1];
+            auto const qright = row[pad + 1];
+            return (qmax > 10 && qleft > 0 && qright > 0) ? PositionX(qmax, pad, qleft, qright) : NoPosition;
+        }
+
+        [[nodiscard]] auto TwoHitY(double qmax, int pad) const -> double
+        {
+            auto const qdown = fY[pad - 1];
+            auto const qup = fY[pad + 1];
+            if constexpr (Layout::x_planes == 1)
+            {
+                if (qdown <= 0 || qup <= 0)
+                {
+                    return NoPosition;
+                }
+            }
+            return qmax > 10 ? PositionY(qmax, pad, qdown, qup) : NoPosition;
+        }
+
+        // Both hits need a peak in X and in Y
+        void ReconstructTwoHitsOnePlane()
+        {
+            auto& xList = fXList[0];
+            if (xList.IsEmpty() || fYList.IsEmpty())
+            {
+                return;
+            }
+            auto const peakx1 = xList.First();
+            auto const peaky1 = fYList.First();
+            auto const peakx2 = xList.Next(peakx1);
+            auto const peaky2 = fYList.Next(peaky1);
+            for (const auto& [peakx, peaky] : { std::pair{ peakx1, peaky1 }, std::pair{ peakx2, peaky2 } })
+            {
+                if (peakx.pad + 1 < Layout::pads_x && peaky.pad + 1 < Layout::pads_y)
+                {
+                    fHits.push_back({ TwoHitX(fXPlane[0], peakx.q, peakx.pad), TwoHitY(peaky.q, peaky.pad) });
+                }
+            }
+        }
+
+        // Each X peak is taken from the plane with the larger charge, in units of Charge.
+        // The two hits are always stored, positions without peak are zero.
+        void ReconstructTwoHitsTwoPlanes()
+        {
+            if ((fXList[0].IsEmpty() && fXList[1].IsEmpty()) || fYList.IsEmpty())
+            {
+                return;
+            }
+            auto const truncate = [](Peak peak) -> Peak
+            { return { peak.pad, static_cast<double>(static_cast<Charge>(peak.q)) }; };
+            auto peak = std::array<Peak, 2>{ truncate(fXList[0].First()), truncate(fXList[1].First()) };
+            auto hit1 = Hit{};
+            auto hit2 = Hit{};
+
+            // first and second plane ordered by their largest charge
+            auto const first = peak[0].q > peak[1].q ? 0 : (peak[1].q > peak[0].q ? 1 : -1);
+            if (first >= 0 && peak[0].pad + 1 < Layout::pads_x && peak[1].pad + 1 < Layout::pads_x)
+            {
+                auto const second = 1 - first;
+                hit1.x = TwoHitX(fXPlane[first], peak[first].q, peak[first].pad);
+                hit1.plane = first + 1;
+
+                peak[first] = truncate(fXList[first].Next(peak[first]));
+                for (auto const plane : { first, second })
+                {
+                    auto const other = 1 - plane;
+                    if (peak[plane].q > peak[other].q && peak[plane].pad + 1 < Layout::pads_x)
+                    {
+                        hit2.x = TwoHitX(fXPlane[plane], peak[plane].q, peak[plane].pad);
+                        hit2.plane = plane + 1;
+                        break;
+                    }
+                }
+            }
+
+            auto const peaky1 = fYList.First();
+            if (peaky1.pad + 1 < Layout::pads_y)
+            {
+                hit1.y = TwoHitY(peaky1.q, peaky1.pad);
+            }
+            auto const peaky2 = fYList.Next(peaky1);
+            if (peaky2.pad + 1 < Layout::pads_y)
+            {
+                hit2.y = TwoHitY(peaky2.q, peaky2.pad);
+            }
+            fHits.push_back(hit1);
+            fHits.push_back(hit2);
+        }
+    };
+} // namespace R3B::Mwpc
+
+#endif /* R3BMWPCPADPLANE_H */
@@ -0,0 +1,207 @@
+#include "R3BMwpcPadPlane.h"
+#include "TRandom3.h"
+#include <algorithm>
+#include <array>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cmath>
+#include <fmt/format.h>
+#include <iostream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct CalHit
+    {
+        int plane;
+        int pad;
+        double q;
+    };
+
+    using Event = std::vector<CalHit>;
+
+    auto SplitNumbers(const std::string& list) -> std::vector<int>
+    {
+        auto numbers = std::vector<int>{};
+        auto stream = std::istringstream{ list };
+        for (auto item = std::string{}; std::getline(stream, item, ',');)
+        {
+            numbers.push_back(std::stoi(item));
+        }
+        return numbers;
+    }
+
+    // Ions piled up within the readout window, each inducing a charge cluster on every plane
+    template <typename Layout>
+    auto MakeEvents(int nEvents, int nIons, TRandom3& random) -> std::vector<Event>
+    {
+        auto events = std::vector<Event>(nEvents);
+        for (auto& event : events)
+        {
+            auto addCluster = [&](int plane, int nPads, double centre, double q0)
+            {
+                auto const centrePad = static_cast<int>(std::floor(centre));
+                for (int pad = centrePad - 4; pad <= centrePad + 4; ++pad)
+                {
+                    auto const q = q0 / std::pow(std::cosh((pad + 0.5 - centre) / 1.5), 2) + random.Gaus(0., 2.);
+                    if (pad >= 0 && pad < nPads && q > 1.)
+                    {
+                        event.push_back({ plane, pad, static_cast<float>(q) });
+                    }
+                }
+            };
+            for (int ion = 0; ion < nIons; ++ion)
+            {
+                auto const q0 = random.Uniform(100., 3000.);
+                auto const x = random.Uniform(0., Layout::pads_x);
+                for (int plane = 1; plane <= Layout::x_planes; ++plane)
+                {
+                    addCluster(plane, Layout::pads_x, x, q0);
+                }
+                addCluster(3, Layout::pads_y, random.Uniform(0., Layout::pads_y), q0);
+            }
+        }
+        return events;
+    }
+
+    // Peak search of the Cal2Hit tasks before R3BMwpcPadPlane: pairs of charge and pad sorted per plane
+    auto SortedPairs(const std::vector<Event>& events) -> double
+    {
+        auto const byCharge = [](const std::pair<double, int>& x, const std::pair<double, int>& y)
+        { return x.first > y.first; };
+        auto sum = 0.;
+        std::array<std::vector<std::pair<double, int>>, 3> pairs; // per plane
+        for (const auto& event : events)
+        {
+            for (auto& plane : pairs)
+            {
+                plane.clear();
+            }
+            for (const auto& cal : event)
+            {
+                pairs[cal.plane - 1].emplace_back(cal.q, cal.pad);
+            }
+            for (auto& plane : pairs)
+            {
+                if (plane.empty())
+                {
+                    continue;
+                }
+                std::sort(plane.begin(), plane.end(), byCharge);
+                auto const padmax = plane[0].second;
+                sum += plane[0].first;
+                for (auto& pair : plane)
+                {
+                    if (std::abs(pair.second - padmax) <= 3)
+                    {
+                        pair.first = 0.;
+                    }
+                }
+                std::sort(plane.begin(), plane.end(), byCharge);
+                sum += plane[0].first;
+            }
+        }
+        return sum;
+    }
+
+    template <typename Layout>
+    auto PadPlane(const std::vector<Event>& events, bool twoHits) -> double
+    {
+        auto pads = R3B::Mwpc::PadPlane<Layout>{};
+        auto sum = 0.;
+        for (const auto& event : events)
+        {
+            pads.Clear();
+            for (const auto& cal : event)
+            {
+                pads.Add(cal.plane, cal.pad, cal.q);
+            }
+            for (const auto& hit : twoHits ? pads.ReconstructTwoHits() : pads.ReconstructSingleHit())
+            {
+                sum += (std::isnan(hit.x) ? 0. : hit.x) + (std::isnan(hit.y) ? 0. : hit.y);
+            }
+        }
+        return sum;
+    }
+
+    template <typename Function>
+    void Time(std::string_view name, int64_t nEvents, double triggerRate, Function&& function)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        auto const sum = function();
+        auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        auto const rate = static_cast<double>(nEvents) / seconds;
+        fmt::print("{0:<32} {1:>10.3f} s {2:>12.0f} events/s {3:>8.2f} x {4:.0f} Hz   ({5:.3g})\n",
+                   name,
+                   seconds,
+                   rate,
+                   rate / triggerRate,
+                   triggerRate,
+                   sum);
+    }
+
+    template <typename Layout>
+    void Run(std::string_view name, const std::vector<int>& ionNums, int nEvents, double triggerRate)
+    {
+        auto random = TRandom3(1234);
+        for (auto const nIons : ionNums)
+        {
+            auto const events = MakeEvents<Layout>(nEvents, nIons, random);
+            auto nCalHits = std::size_t{};
+            for (const auto& event : events)
+            {
+                nCalHits += event.size();
+            }
+            fmt::print("{0}, {1} ions per event, {2:.1f} cal hits per event\n",
+                       name,
+                       nIons,
+                       static_cast<double>(nCalHits) / nEvents);
+            Time("  sorted pairs, peaks only", nEvents, triggerRate, [&] { return SortedPairs(events); });
+            Time("  pad plane, single hit", nEvents, triggerRate, [&] { return PadPlane<Layout>(events, false); });
+            Time("  pad plane, two hits", nEvents, triggerRate, [&] { return PadPlane<Layout>(events, true); });
+        }
+    }
+} // namespace
+
+// Event rate of the hit reconstruction of R3BMwpcPadPlane for increasing pile-up, compared with the
+// sorting of charge and pad pairs of the Cal2Hit tasks before, whose time is spent in the peak search alone.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of the MWPC pad plane reconstruction" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("eventNum,n", po::value<int>()->default_value(200000), "set number of events");
+    desc.add_options()("ions",
+                       po::value<std::string>()->default_value("1,4,16"),
+                       "set comma separated numbers of ions per event");
+    desc.add_options()("rate", po::value<double>()->default_value(50000.), "set trigger rate to compare with in Hz");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "mwpcPadPlaneBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto eventNum = varMap["eventNum"].as<int>();
+    const auto ionList = varMap["ions"].as<std::string>();
+    const auto triggerRate = varMap["rate"].as<double>();
+
+    auto const ionNums = SplitNumbers(ionList);
+    Run<R3B::Mwpc::Mwpc1>("MWPC1", ionNums, eventNum, triggerRate);
+    Run<R3B::Mwpc::Mwpc3>("MWPC3", ionNums, eventNum, triggerRate);
+    return 0;
+}
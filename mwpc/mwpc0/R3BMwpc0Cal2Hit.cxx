@@ -18,7 +18,6 @@
 
 // ROOT headers
 #include "TClonesArray.h"
-#include "TMath.h"
 
 // FAIR headers
 #include "FairLogger.h"
@@ -42,9 +41,6 @@ R3BMwpc0Cal2Hit::R3BMwpc0Cal2Hit(const char* name, Int_t iVerbose)
     : FairTask(name, iVerbose)
     , fMwpcCalDataCA(NULL)
     , fMwpcHitDataCA(NULL)
-    , fwx(3.125)   // in mm
-    , fwy(3.125)   // in mm
-    , fSize(200.0) // in mm
     , fOnline(kFALSE)
 {
 }
@@ -97,86 +93,18 @@ void R3BMwpc0Cal2Hit::Exec(Option_t* option)
     if (nHits == 0)
         return;
 
-    // Data from cal level
-    R3BMwpcCalData** calData;
-    calData = new R3BMwpcCalData*[nHits];
-    Int_t planeId;
-    Int_t padId;
-    Int_t padmx = -1, padmy = -1;
-    Double_t q = 0., qmx = 0., qmy = 0., qleft = 0., qright = 0., qdown = 0., qup = 0.;
-    Double_t x = NAN, y = NAN;
-
-    for (Int_t i = 0; i < Mw0PadsX; i++)
-        fx[i] = 0;
-    for (Int_t i = 0; i < Mw0PadsY; i++)
-        fy[i] = 0;
-
+    fPads.Clear();
     for (Int_t i = 0; i < nHits; i++)
     {
-        calData[i] = dynamic_cast<R3BMwpcCalData*>(fMwpcCalDataCA->At(i));
-        planeId = calData[i]->GetPlane();
-        padId = calData[i]->GetPad() - 1;
-        q = calData[i]->GetQ();
-        if (planeId == 1)
-            fx[padId] = q;
-        else
-            fy[padId] = q;
-        if (q > qmx && planeId == 1)
-        {
-            qmx = q;
-            padmx = padId;
-        }
-        if (q > qmy && planeId == 3)
-        {
-            qmy = q;
-            padmy = padId;
-        }
+        auto* calData = dynamic_cast<R3BMwpcCalData*>(fMwpcCalDataCA->At(i));
+        fPads.Add(calData->GetPlane(), calData->GetPad() - 1, calData->GetQ());
     }
     // Add Hit data ----
-    if (padmx > 1 && padmy > 1 && padmx + 1 < Mw0PadsX && padmy + 1 < Mw0PadsY && qmx > 0 && qmy > 0)
-    {
-        // Obtain position X ----
-        qleft = (Double_t)fx[padmx - 1];
-        qright = (Double_t)fx[padmx + 1];
-        // std::cout<<qleft<<" "<<qright<<std::endl;
-        if (qleft > 0 && qright > 0)
-            x = GetPositionX(qmx, padmx, qleft, qright);
-
-        // Obtain position Y ----
-        qdown = fy[padmy - 1];
-        qup = fy[padmy + 1];
-        if (qdown > 0 && qup > 0)
-            y = GetPositionY(qmy, padmy, qdown, qup);
-        // std::cout << x << " " << y << std::endl;
-        AddHitData(x, y);
-    }
-    if (calData)
-        delete[] calData;
+    for (const auto& hit : fPads.ReconstructSingleHit())
+        AddHitData(hit.x, hit.y);
     return;
 }
 
-// -----   Protected method to obtain the position X ----------------------------
-Double_t R3BMwpc0Cal2Hit::GetPositionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright)
-{
-    Double_t a3 = TMath::Pi() * fwx / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qleft) + TMath::Sqrt(qmax / qright))));
-    // Double_t a2 =gRandom->Uniform(-fwx / 2, fwx / 2);
-    Double_t a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qleft) - TMath::Sqrt(qmax / qright)) /
-                                                    (2 * TMath::SinH(TMath::Pi() * fwx / a3)));
-
-    return (-1. * padmax * fwx + (fSize / 2) - (fwx / 2) - a2); // Left is positive and right negative
-}
-
-// -----   Protected method to obtain the position Y ----------------------------
-Double_t R3BMwpc0Cal2Hit::GetPositionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup)
-{
-    Double_t a3 = TMath::Pi() * fwy / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qdown) + TMath::Sqrt(qmax / qup))));
-    // Double_t a2 =gRandom->Uniform(-fwy / 2, fwy / 2);
-    Double_t a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qdown) - TMath::Sqrt(qmax / qup)) /
-                                                    (2 * TMath::SinH(TMath::Pi() * fwy / a3)));
-
-    return (padmax * fwy - (fSize / 2) + (fwy / 2) + a2);
-}
-
 // -----   Public method Reset   ------------------------------------------------
 void R3BMwpc0Cal2Hit::Reset()
 {
@@ -22,12 +22,10 @@
 #include "FairTask.h"
 #include "R3BMwpcCalData.h"
 #include "R3BMwpcHitData.h"
+#include "R3BMwpcPadPlane.h"
 #include "TH1F.h"
 #include <TRandom.h>
 
-#define Mw0PadsX 64
-#define Mw0PadsY 64
-
 class TClonesArray;
 
 class R3BMwpc0Cal2Hit : public FairTask
@@ -59,10 +57,7 @@ class R3BMwpc0Cal2Hit : public FairTask
     void SetOnline(Bool_t option) { fOnline = option; }
 
   private:
-    Double_t fSize; // Detector size in X and Y
-    Double_t fwx;   // Pad width in X
-    Double_t fwy;   // Pad width in Y
-    Int_t fx[Mw0PadsX], fy[Mw0PadsY];
+    R3B::Mwpc::PadPlane<R3B::Mwpc::Mwpc0> fPads; //! Pad charges of the event
 
     Bool_t fOnline; // Don't store data for online
 
@@ -73,11 +68,6 @@ class R3BMwpc0Cal2Hit : public FairTask
     // Adds a SofMwpcHitData to the MwpcHitCollection
     R3BMwpcHitData* AddHitData(Double_t x, Double_t y);
 
-    /** Private method to obtain the position X **/
-    Double_t GetPositionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright);
-    /** Private method to obtain the position Y **/
-    Double_t GetPositionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup);
-
   public:
     // Class definition
     ClassDef(R3BMwpc0Cal2Hit, 1)
@@ -23,14 +23,10 @@
 #include "FairTask.h"
 #include "R3BMwpcCalData.h"
 #include "R3BMwpcHitData.h"
+#include "R3BMwpcPadPlane.h"
 #include "TH1F.h"
 #include <TRandom.h>
 
-#define Mw1PadsX 64
-#define Mw1PadsY 40
-
-// Mw1PadsX 64
-
 using namespace std;
 
 class TClonesArray;
@@ -76,10 +72,7 @@ class R3BMwpc1Cal2Hit : public FairTask
 
     R3BEventHeader* header; /**< Event header. */
 
-    Double_t fSize; // Detector size in X and Y
-    Double_t fwx;   // Pad width in X
-    Double_t fwy;   // Pad width in Y
-    Int_t fx[Mw1PadsX], fx_p1[Mw1PadsX], fx_p2[Mw1PadsX], fy[Mw1PadsY];
+    R3B::Mwpc::PadPlane<R3B::Mwpc::Mwpc1> fPads; //! Pad charges of the event
 
     Bool_t fOnline; // Don't store data for online
     Int_t fExpId;
@@ -91,12 +84,8 @@ class R3BMwpc1Cal2Hit : public FairTask
     // Adds a MwpcHitData to the MwpcHitCollection
     R3BMwpcHitData* AddHitData(Double_t x, Double_t y, Int_t plane = 1);
 
-    /** Private method to obtain the position X **/
-    Double_t GetPositionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright);
-    /** Private method to obtain the position Y **/
-    Double_t GetPositionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup);
-    /** Private method to obtain the position Y **/
-    [[nodiscard]] Double_t GetPositionYCoG(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup) const;
+    /** Private method to fill the pad planes with the cal data **/
+    void FillPads();
 
   public:
     // Class definition
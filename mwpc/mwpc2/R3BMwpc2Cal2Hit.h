@@ -23,14 +23,12 @@
 #include "FairTask.h"
 #include "R3BMwpcCalData.h"
 #include "R3BMwpcHitData.h"
+#include "R3BMwpcPadPlane.h"
 #include "TH1F.h"
 #include <TRandom.h>
 
 using namespace std;
 
-#define Mw2PadsX 64
-#define Mw2PadsY 40
-// Mw2PadsX 64
 class TClonesArray;
 class R3BEventHeader;
 
@@ -74,12 +72,7 @@ class R3BMwpc2Cal2Hit : public FairTask
 
     R3BEventHeader* header; /**< Event header. */
 
-    Double_t fSize; // Detector size in X and Y
-    Double_t fwx;   // Pad width in X
-    Double_t fwy;   // Pad width in Y
-    // vector<pair<Int_t, Int_t>> fPairX;
-    // vector<pair<Int_t, Int_t>> fPairY;
-    Int_t fx[Mw2PadsX], fx_p1[Mw2PadsX], fx_p2[Mw2PadsX], fy[Mw2PadsY];
+    R3B::Mwpc::PadPlane<R3B::Mwpc::Mwpc2> fPads; //! Pad charges of the event
 
     Bool_t fOnline; // Don't store data for online
     Int_t fExpId;
@@ -91,11 +84,8 @@ class R3BMwpc2Cal2Hit : public FairTask
     // Adds a MwpcHitData to the MwpcHitCollection
     R3BMwpcHitData* AddHitData(Double_t x, Double_t y, Int_t plane = 1);
 
-    // bool sortPairs(const pair<Double_t, Int_t> &x, const pair<Double_t, Int_t> &y);
-    /** Private method to obtain the position X **/
-    Double_t GetPositionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright);
-    /** Private method to obtain the position Y **/
-    Double_t GetPositionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup);
+    /** Private method to fill the pad planes with the cal data **/
+    void FillPads();
 
   public:
     // Class definition
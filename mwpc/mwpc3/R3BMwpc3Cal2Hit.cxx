@@ -36,6 +36,8 @@
 #include "R3BMwpcCalData.h"
 #include "R3BMwpcHitData.h"
 
+using Mwpc3Pads = R3B::Mwpc::PadPlane<R3B::Mwpc::Mwpc3>;
+
 bool compare(pair<int, int> p1, pair<int, int> p2) { return p1.second < p2.second; }
 
 /* ---- R3BMwpc3Cal2Hit: Default Constructor ---- */
@@ -51,10 +53,6 @@ R3BMwpc3Cal2Hit::R3BMwpc3Cal2Hit(const char* name, Int_t iVerbose)
     , fMwpcCalDataCA(NULL)
     , fMwpcHitDataCA(NULL)
     , fTofWallHitDataCA(NULL)
-    , fwy(5.000)
-    , fwx(3.125)
-    , fSizeX(900.0)
-    , fSizeY(600.0) // in mm
     , fOnline(kFALSE)
     , fTofWallMatching(kFALSE)
     , fExpId(0)
@@ -115,8 +113,6 @@ InitStatus R3BMwpc3Cal2Hit::Init()
 /* ----   Public method ReInit   ---- */
 InitStatus R3BMwpc3Cal2Hit::ReInit() { return kSUCCESS; }
 
-bool sortPairs(const pair<Double_t, Int_t>& x, const pair<Double_t, Int_t>& y) { return x.first > y.first; }
-
 /* ----   Public method Execution   ---- */
 void R3BMwpc3Cal2Hit::Exec(Option_t* option)
 {
@@ -146,86 +142,9 @@ void R3BMwpc3Cal2Hit::S467()
 
     else
     {
-        // Reading the Input -- Cal Data --
-        Int_t nHits = fMwpcCalDataCA->GetEntriesFast();
-        if (nHits == 0)
-            return;
-
-        // Data from cal level
-        R3BMwpcCalData** calData = new R3BMwpcCalData*[nHits];
-        Int_t planeId = 0;
-        Int_t padId = 0;
-        Int_t padmx = -1, padmy = -1;
-        Double_t q = 0., qmx = 0., qmy = 0., qleft = 0., qright = 0., qdown = 0., qup = 0.;
-        Double_t x = NAN, y = NAN;
-
-        vector<double> vQX, vQY;
-        vector<int> vStripX, vStripY;
-        vQX.clear();
-        vQY.clear();
-        vStripX.clear();
-        vStripY.clear();
-
-        for (Int_t i = 0; i < Mw3PadsX; i++)
-            fx[i] = 0;
-        for (Int_t i = 0; i < Mw3PadsY; i++)
-            fy[i] = 0;
-
-        for (Int_t i = 0; i < nHits; i++)
-        {
-            calData[i] = (R3BMwpcCalData*)(fMwpcCalDataCA->At(i));
-            planeId = calData[i]->GetPlane();
-            padId = calData[i]->GetPad() - 1;
-            q = calData[i]->GetQ();
-            if (planeId == 1)
-            {
-                fx[padId] = q;
-                vQX.push_back(q);
-                vStripX.push_back(padId);
-            }
-            else
-            {
-                fy[padId] = q;
-                vQY.push_back(q);
-                vStripY.push_back(padId);
-            }
-
-            if (q > qmx && planeId == 1)
-            {
-                qmx = q;
-                padmx = padId;
-            }
-            if (q > qmy && planeId == 3)
-            {
-                qmy = q;
-                padmy = padId;
-            }
-        }
-        // Add Hit data ----
-        if (padmx > 0 && padmy > 0 && padmx + 1 < Mw3PadsX && padmy + 1 < Mw3PadsY && qmx > 0 && qmy > 0)
-        {
-            // Obtain position X ----
-            qleft = (Double_t)fx[padmx - 1];
-            qright = (Double_t)fx[padmx + 1];
-            // std::cout<<qleft<<" "<<qright<<std::endl;
-            if (qleft > 0 && qright > 0)
-                x = GetPositionX(qmx, padmx, qleft, qright);
-            // x = FittedHyperbolicSecant("X",vQX,vStripX,qmx,padmx);
-
-            // Obtain position Y ----
-            qdown = fy[padmy - 1];
-            qup = fy[padmy + 1];
-            // if(padmy==64) std::cout << padmy << " " << qmy << " " << qdown << " " << qup << std::endl;
-            // if(padmy==63) std::cout << padmy << " " << qmy << " " << qdown << " " << qup << std::endl;
-            if (qdown > 0 && qup > 0)
-                y = GetPositionY(qmy, padmy, qdown, qup);
-            // y = FittedHyperbolicSecant("Y",vQY,vStripY,qmy,padmy);
-
-            AddHitData(x, y);
-        }
-
-        if (calData)
-            delete[] calData;
+        FillPads();
+        for (const auto& hit : fPads.ReconstructSingleHit())
+            AddHitData(hit.x, hit.y);
     }
     return;
 }
@@ -241,156 +160,28 @@ void R3BMwpc3Cal2Hit::S455()
 
     else
     {
-        // Reading the Input -- Cal Data --
-        Int_t nHits = fMwpcCalDataCA->GetEntriesFast();
-        R3BMwpcCalData** calData = new R3BMwpcCalData*[nHits];
-
-        Int_t planeId = 0;
-        Int_t padId = 0;
-        Double_t q = 0;
-        Int_t padmx1 = -1, padmy1 = -1, padmx2 = -1, padmy2 = -1;
-        Double_t qmx1 = 0., qmy1 = 0., qleft1 = 0., qright1 = 0., qdown1 = 0., qup1 = 0.;
-        Double_t qmx2 = 0., qmy2 = 0., qleft2 = 0., qright2 = 0., qdown2 = 0., qup2 = 0.;
-        Double_t x1 = 0., y1 = 0., x2 = 0., y2 = 0.;
-        Int_t nx = 0, ny = 0;
-
-        vector<pair<Double_t, Int_t>> QpadX, QpadY;
-        QpadX.clear();
-        QpadY.clear();
-        Bool_t xexists = false;
-        Bool_t yexists = false;
-        // Double_t fx[Mw3PadsX], fy[Mw3PadsY];
-
-        for (Int_t i = 0; i < Mw3PadsX; i++)
-            fx[i] = 0;
-        for (Int_t i = 0; i < Mw3PadsY; i++)
-            fy[i] = 0;
-        for (Int_t i = 0; i < nHits; i++)
-        {
-            calData[i] = (R3BMwpcCalData*)(fMwpcCalDataCA->At(i));
-            planeId = calData[i]->GetPlane();
-            padId = calData[i]->GetPad() - 1;
-            q = calData[i]->GetQ();
-            // cout << "i = " << i << ", q = " << q << ", padId = " << padId << ", planeId = " << planeId << endl;
-            pair<Double_t, Int_t> hit_pair = make_pair(q, padId);
-            if (planeId == 1)
-            {
-                fx[padId] = q;
-                QpadX.push_back(hit_pair);
-                xexists = true;
-                nx = nx + 1;
-            }
-            else
-            {
-                fy[padId] = q;
-                QpadY.push_back(hit_pair);
-                yexists = true;
-                ny = ny + 1;
-            }
-        }
-
-        if (xexists == true && yexists == true)
-        {
-            sort(QpadX.begin(), QpadX.end(), sortPairs); // el vector se ordena por el primer elemento de cada par
-            qmx1 = QpadX[0].first;
-            padmx1 = QpadX[0].second;
-            // cout << "qmx1 = " << qmx1 << ", padmx1 = " << padmx1 << endl;
-
-            sort(QpadY.begin(), QpadY.end(), sortPairs);
-            qmy1 = QpadY[0].first;
-            padmy1 = QpadY[0].second;
-            // cout << "qmy1 = " << qmy1 << ", padmy1 = " << padmy1 << endl;
-
-            if (padmx1 + 1 < Mw3PadsX && padmy1 + 1 < Mw3PadsY)
-            {
-                // Obtain position X for 1st charge----
-                qleft1 = fx[padmx1 - 1];
-                qright1 = fx[padmx1 + 1];
-                if (qmx1 > 10 && qleft1 > 0 && qright1 > 0)
-                {
-                    x1 = GetPositionX(qmx1, padmx1, qleft1, qright1);
-                }
-                else
-                    x1 = -1000.;
-
-                // Obtain position Y for 1st charge ----
-                qdown1 = fy[padmy1 - 1];
-                qup1 = fy[padmy1 + 1];
-                if (qmy1 > 10 && qdown1 > 0 && qup1 > 0)
-                {
-                    y1 = GetPositionY(qmy1, padmy1, qdown1, qup1);
-                }
-                else
-                    y1 = -1000.;
-
-                // if (x1!=0 && y1!=0){
-                AddHitData(x1, y1);
-                //}
-            }
-
-            for (Int_t i = 0; i < nx; i++)
-            {
-                if (QpadX[i].second == padmx1 - 3 || QpadX[i].second == padmx1 - 2 || QpadX[i].second == padmx1 - 1 ||
-                    QpadX[i].second == padmx1 || QpadX[i].second == padmx1 + 1 || QpadX[i].second == padmx1 + 2 ||
-                    QpadX[i].second == padmx1 + 3)
-                {
-                    QpadX[i].first = 0.;
-                }
-            }
-            for (Int_t i = 0; i < ny; i++)
-            {
-                if (QpadY[i].second == padmy1 - 3 || QpadY[i].second == padmy1 - 2 || QpadY[i].second == padmy1 - 1 ||
-                    QpadY[i].second == padmy1 || QpadY[i].second == padmy1 + 1 || QpadY[i].second == padmy1 + 2 ||
-                    QpadY[i].second == padmy1 + 3)
-                {
-                    QpadY[i].first = 0.;
-                }
-            }
-            sort(QpadX.begin(), QpadX.end(), sortPairs);
-            qmx2 = QpadX[0].first;
-            padmx2 = QpadX[0].second;
-            // cout << "qmx2 = " << qmx2 << ", padmx2 = " << padmx2 << endl;
-
-            sort(QpadY.begin(), QpadY.end(), sortPairs);
-            qmy2 = QpadY[0].first;
-            padmy2 = QpadY[0].second;
-            // cout << "qmy2 = " << qmy2 << ", padmy2 = " << padmy2 << endl;
-
-            if (padmx2 + 1 < Mw3PadsX && padmy2 + 1 < Mw3PadsY)
-            {
-                // Obtain position X for 2nd charge----
-                qleft2 = fx[padmx2 - 1];
-                qright2 = fx[padmx2 + 1];
-                if (qmx2 > 10 && qleft2 > 0 && qright2 > 0)
-                {
-                    x2 = GetPositionX(qmx2, padmx2, qleft2, qright2);
-                }
-                else
-                    x2 = -1000;
-
-                // Obtain position Y for 2nd charge ----
-                qdown2 = fy[padmy2 - 1];
-                qup2 = fy[padmy2 + 1];
-                if (qmy2 > 10 && qdown2 > 0 && qup2 > 0)
-                {
-                    y2 = GetPositionY(qmy2, padmy2, qdown2, qup2);
-                }
-                else
-                    y2 = -1000.;
-                // if (x2!=0 && y2!=0){
-                AddHitData(x2, y2);
-                //}
-            }
-
-        } // Condition if (xexists == true && yexists == true)
-
-        if (calData)
-            delete[] calData;
+        FillPads();
+        // Hits of the largest and of the second largest charge in X and Y
+        for (const auto& hit : fPads.ReconstructTwoHits())
+            AddHitData(hit.x, hit.y);
     }
 
     return;
 }
 
+// -----   Private method FillPads   --------------------------------------------
+void R3BMwpc3Cal2Hit::FillPads()
+{
+    fPads.Clear();
+    // Reading the Input -- Cal Data --
+    Int_t nHits = fMwpcCalDataCA->GetEntriesFast();
+    for (Int_t i = 0; i < nHits; i++)
+    {
+        auto* calData = (R3BMwpcCalData*)(fMwpcCalDataCA->At(i));
+        fPads.Add(calData->GetPlane(), calData->GetPad() - 1, calData->GetQ());
+    }
+}
+
 /* ---- Fitted Hyperbolic Secant ---- */
 Double_t R3BMwpc3Cal2Hit::FittedHyperbolicSecant(string XorY,
                                                  vector<double> vQ,
@@ -431,10 +222,11 @@ Double_t R3BMwpc3Cal2Hit::FittedHyperbolicSecant(string XorY,
     delete g;
     Double_t pospad = f->GetParameter(1);
 
+    using Layout = R3B::Mwpc::Mwpc3;
     if (XorY == "Y")
-        pos = pospad * fwy - fSizeY / 2 + fwy / 2;
+        pos = pospad * Layout::pad_width_y - Layout::size_y / 2 + Layout::pad_width_y / 2;
     if (XorY == "X")
-        pos = -(pospad * fwx - fSizeX / 2 + fwx / 2);
+        pos = -(pospad * Layout::pad_width_x - Layout::size_x / 2 + Layout::pad_width_x / 2);
 
     return pos;
 }
@@ -543,9 +335,9 @@ void R3BMwpc3Cal2Hit::ReconstructHitWithTofWallMatching()
         int qmax = hit[1].second;
         int padmax = hit[1].first;
         int qright = hit[2].second;
-        if (padmax > 0 && padmax + 1 < Mw3PadsX && qmax > 0 && qleft > 0 && qright > 0)
+        if (padmax > 0 && padmax + 1 < R3B::Mwpc::Mwpc3::pads_x && qmax > 0 && qleft > 0 && qright > 0)
         {
-            x = GetPositionX(qmax, padmax, qleft, qright);
+            x = Mwpc3Pads::PositionX(qmax, padmax, qleft, qright);
             Xpos.push_back(x);
         }
     }
@@ -560,9 +352,9 @@ void R3BMwpc3Cal2Hit::ReconstructHitWithTofWallMatching()
         int qmax = hit[1].second;
         int padmax = hit[1].first;
         int qup = hit[2].second;
-        if (padmax > 0 && padmax + 1 < Mw3PadsY && qmax > 0 && qdown > 0 && qup > 0)
+        if (padmax > 0 && padmax + 1 < R3B::Mwpc::Mwpc3::pads_y && qmax > 0 && qdown > 0 && qup > 0)
         {
-            y = GetPositionY(qmax, padmax, qdown, qup);
+            y = Mwpc3Pads::PositionY(qmax, padmax, qdown, qup);
             Ypos.push_back(y);
         }
     }
@@ -661,28 +453,6 @@ double R3BMwpc3Cal2Hit::GetChargeMax(vector<pair<int, int>> p1)
     return Qmax;
 }
 
-/* ----   Protected method to obtain the position X ---- */
-Double_t R3BMwpc3Cal2Hit::GetPositionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright)
-{
-    Double_t a3 = TMath::Pi() * fwx / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qleft) + TMath::Sqrt(qmax / qright))));
-    // Double_t a2 = gRandom->Uniform(-fwx / 2,fwx / 2);
-    Double_t a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qleft) - TMath::Sqrt(qmax / qright)) /
-                                                    (2 * TMath::SinH(TMath::Pi() * fwx / a3)));
-
-    return (-1. * padmax * fwx + (fSizeX / 2) - (fwx / 2) - a2); // Left is positive and right negative
-}
-
-/* ----   Protected method to obtain the position Y ---- */
-Double_t R3BMwpc3Cal2Hit::GetPositionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup)
-{
-    Double_t a3 = TMath::Pi() * fwy / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qdown) + TMath::Sqrt(qmax / qup))));
-    // Double_t a2 = gRandom->Uniform(-fwy / 2, fwy / 2);
-    Double_t a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qdown) - TMath::Sqrt(qmax / qup)) /
-                                                    (2 * TMath::SinH(TMath::Pi() * fwy / a3)));
-
-    return (padmax * fwy - (fSizeY / 2) + (fwy / 2) + a2);
-}
-
 /* ----   Public method Reset  ---- */
 void R3BMwpc3Cal2Hit::Reset()
 {
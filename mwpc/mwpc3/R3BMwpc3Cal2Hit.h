@@ -24,15 +24,13 @@
 #include "FairTask.h"
 #include "R3BMwpcCalData.h"
 #include "R3BMwpcHitData.h"
+#include "R3BMwpcPadPlane.h"
 #include "R3BSofTofWHitData.h"
 #include "TH1F.h"
 #include <TRandom.h>
 
 using namespace std;
 
-#define Mw3PadsX 288
-#define Mw3PadsY 120
-
 class TClonesArray;
 class R3BEventHeader;
 
@@ -76,11 +74,7 @@ class R3BMwpc3Cal2Hit : public FairTask
 
     R3BEventHeader* header; /**< Event header. */
 
-    Double_t fSizeX; // Detector size in X and Y
-    Double_t fSizeY; // Detector size in X and Y
-    Double_t fwx;    // Pad width in X
-    Double_t fwy;    // Pad width in Y
-    Double_t fx[Mw3PadsX], fy[Mw3PadsY];
+    R3B::Mwpc::PadPlane<R3B::Mwpc::Mwpc3> fPads; //! Pad charges of the event
     vector<Int_t> fQX;
     vector<Int_t> fQY;
     vector<Int_t> fPadX;
@@ -112,10 +106,8 @@ class R3BMwpc3Cal2Hit : public FairTask
     vector<pair<int, int>> FindCluster(vector<pair<int, int>>& p1);
     /** **/
     void ReconstructHitWithTofWallMatching();
-    /** Private method to obtain the position X **/
-    Double_t GetPositionX(Double_t qmax, Int_t padmax, Double_t qleft, Double_t qright);
-    /** Private method to obtain the position Y **/
-    Double_t GetPositionY(Double_t qmax, Int_t padmax, Double_t qdown, Double_t qup);
+    /** Private method to fill the pad planes with the cal data **/
+    void FillPads();
 
     Double_t FittedHyperbolicSecant(string XorY, vector<double> vQ, vector<int> vStrip, int Qmax, int StripMax);
 
@@ -0,0 +1,437 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BMwpcPadPlane.h"
+#include "TMath.h"
+#include "TRandom3.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace R3B::Mwpc;
+
+    struct CalHit
+    {
+        int plane;
+        int pad;
+        double q;
+    };
+
+    using Event = std::vector<CalHit>;
+
+    // Reconstruction of the Cal2Hit tasks before the pad plane engine. Neighbours
+    // outside of the plane read as zero, the tasks read outside of their arrays.
+    template <typename Layout>
+    class Reference
+    {
+      public:
+        using Charge = typename Layout::Charge;
+        using Pairs = std::vector<std::pair<double, int>>;
+
+        static auto PositionX(double qmax, int padmax, double qleft, double qright) -> double
+        {
+            const double fwx = Layout::pad_width_x;
+            const double fSize = Layout::size_x;
+            double a3 =
+                TMath::Pi() * fwx / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qleft) + TMath::Sqrt(qmax / qright))));
+            double a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qleft) - TMath::Sqrt(qmax / qright)) /
+                                                          (2 * TMath::SinH(TMath::Pi() * fwx / a3)));
+            return (-1. * padmax * fwx + (fSize / 2) - (fwx / 2) - a2);
+        }
+
+        static auto PositionY(double qmax, int padmax, double qdown, double qup) -> double
+        {
+            const double fwy = Layout::pad_width_y;
+            const double fSize = Layout::size_y;
+            double a2 = 0;
+            if (qdown != 0 && qup != 0)
+            {
+                double a3 =
+                    TMath::Pi() * fwy / (TMath::ACosH(0.5 * (TMath::Sqrt(qmax / qdown) + TMath::Sqrt(qmax / qup))));
+                a2 = (a3 / TMath::Pi()) * TMath::ATanH((TMath::Sqrt(qmax / qdown) - TMath::Sqrt(qmax / qup)) /
+                                                       (2 * TMath::SinH(TMath::Pi() * fwy / a3)));
+            }
+            return (padmax * fwy - (fSize / 2) + (fwy / 2) + a2);
+        }
+
+        static auto PositionYCoG(double qmax, int padmax, double qdown, double qup) -> double
+        {
+            const double fwy = Layout::pad_width_y;
+            const double fSize = Layout::size_y;
+            const double pos1 = (padmax - 1) * fwy - (fSize / 2) + (fwy / 2);
+            const double pos2 = padmax * fwy - (fSize / 2) + (fwy / 2);
+            const double pos3 = (padmax + 1) * fwy - (fSize / 2) + (fwy / 2);
+            return (pos1 * qdown + pos2 * qmax + pos3 * qup) / (qmax + qdown + qup);
+        }
+
+        // S467 and MWPC0
+        static auto SingleHit(const Event& event, bool cog = false) -> std::vector<Hit>
+        {
+            auto fx = std::vector<Charge>(Layout::pads_x, 0);
+            auto fy = std::vector<Charge>(Layout::pads_y, 0);
+            int padmx = -1, padmy = -1;
+            double qmx = 0., qmy = 0.;
+            for (const auto& cal : event)
+            {
+                const double q = cal.q;
+                const bool isX = cal.plane == 1 || (Layout::x_planes == 2 && cal.plane == 2);
+                if (isX && Layout::x_planes == 2)
+                    fx[cal.pad] += q;
+                else if (isX)
+                    fx[cal.pad] = q;
+                else
+                    fy[cal.pad] = q;
+                if (q > qmx && isX)
+                {
+                    qmx = q;
+                    padmx = cal.pad;
+                }
+                if (q > qmy && cal.plane == 3)
+                {
+                    qmy = q;
+                    padmy = cal.pad;
+                }
+            }
+            auto hits = std::vector<Hit>{};
+            const int minPad = Layout::first_peak_pad - 1;
+            if (padmx > minPad && padmy > minPad && padmx + 1 < Layout::pads_x && padmy + 1 < Layout::pads_y &&
+                qmx > 0 && qmy > 0)
+            {
+                double x = NAN, y = NAN;
+                double qleft = (double)fx[padmx - 1];
+                double qright = (double)fx[padmx + 1];
+                if (qleft > 0 && qright > 0)
+                    x = PositionX(qmx, padmx, qleft, qright);
+                double qdown = fy[padmy - 1];
+                double qup = fy[padmy + 1];
+                if (cog)
+                    y = PositionYCoG(qmy, padmy, qdown, qup);
+                else if (qdown > 0 && qup > 0)
+                    y = PositionY(qmy, padmy, qdown, qup);
+                hits.push_back({ x, y });
+            }
+            return hits;
+        }
+
+        // std::sort leaves the order of equal charges unspecified, the engine keeps the input order
+        static void Sort(Pairs& pairs)
+        {
+            std::stable_sort(pairs.begin(),
+                             pairs.end(),
+                             [](const std::pair<double, int>& x, const std::pair<double, int>& y)
+                             { return x.first > y.first; });
+        }
+
+        static void Mask(Pairs& pairs, int padmax)
+        {
+            for (auto& pair : pairs)
+            {
+                if (pair.second >= padmax - 3 && pair.second <= padmax + 3)
+                    pair.first = 0.;
+            }
+        }
+
+        static auto At(const std::vector<Charge>& row, int pad) -> double
+        {
+            return (pad >= 0 && pad < static_cast<int>(row.size())) ? row[pad] : 0.;
+        }
+
+        // S455 of MWPC3
+        static auto TwoHitsOnePlane(const Event& event) -> std::vector<Hit>
+        {
+            auto fx = std::vector<Charge>(Layout::pads_x, 0);
+            auto fy = std::vector<Charge>(Layout::pads_y, 0);
+            Pairs QpadX, QpadY;
+            for (const auto& cal : event)
+            {
+                if (cal.plane == 1)
+                {
+                    fx[cal.pad] = cal.q;
+                    QpadX.emplace_back(cal.q, cal.pad);
+                }
+                else
+                {
+                    fy[cal.pad] = cal.q;
+                    QpadY.emplace_back(cal.q, cal.pad);
+                }
+            }
+            auto hits = std::vector<Hit>{};
+            if (QpadX.empty() || QpadY.empty())
+                return hits;
+
+            auto addHit = [&](double qmx, int padmx, double qmy, int padmy)
+            {
+                if (padmx + 1 < Layout::pads_x && padmy + 1 < Layout::pads_y)
+                {
+                    double x = -1000., y = -1000.;
+                    double qleft = At(fx, padmx - 1), qright = At(fx, padmx + 1);
+                    if (qmx > 10 && qleft > 0 && qright > 0)
+                        x = PositionX(qmx, padmx, qleft, qright);
+                    double qdown = At(fy, padmy - 1), qup = At(fy, padmy + 1);
+                    if (qmy > 10 && qdown > 0 && qup > 0)
+                        y = PositionY(qmy, padmy, qdown, qup);
+                    hits.push_back({ x, y });
+                }
+            };
+            Sort(QpadX);
+            Sort(QpadY);
+            const auto [qmx1, padmx1] = QpadX[0];
+            const auto [qmy1, padmy1] = QpadY[0];
+            addHit(qmx1, padmx1, qmy1, padmy1);
+            Mask(QpadX, padmx1);
+            Mask(QpadY, padmy1);
+            Sort(QpadX);
+            Sort(QpadY);
+            addHit(QpadX[0].first, QpadX[0].second, QpadY[0].first, QpadY[0].second);
+            return hits;
+        }
+
+        // S455 of MWPC1 and MWPC2
+        static auto TwoHitsTwoPlanes(const Event& event) -> std::vector<Hit>
+        {
+            std::vector<Charge> fx_p[2] = { std::vector<Charge>(Layout::pads_x, 0),
+                                            std::vector<Charge>(Layout::pads_x, 0) };
+            auto fy = std::vector<Charge>(Layout::pads_y, 0);
+            Pairs QpadX_p[2], QpadY;
+            for (const auto& cal : event)
+            {
+                if (cal.plane == 1 || cal.plane == 2)
+                {
+                    fx_p[cal.plane - 1][cal.pad] = cal.q;
+                    QpadX_p[cal.plane - 1].emplace_back(cal.q, cal.pad);
+                }
+                if (cal.plane == 3)
+                {
+                    fy[cal.pad] = cal.q;
+                    QpadY.emplace_back(cal.q, cal.pad);
+                }
+            }
+            auto hits = std::vector<Hit>{};
+            if ((QpadX_p[0].empty() && QpadX_p[1].empty()) || QpadY.empty())
+                return hits;
+
+            Charge qmx_p[2] = { 0, 0 };
+            int padmx_p[2] = { -1, -1 };
+            for (int p = 0; p < 2; ++p)
+            {
+                if (!QpadX_p[p].empty())
+                {
+                    Sort(QpadX_p[p]);
+                    qmx_p[p] = QpadX_p[p][0].first;
+                    padmx_p[p] = QpadX_p[p][0].second;
+                }
+            }
+            double x1 = 0., y1 = 0., x2 = 0., y2 = 0.;
+            int planex1 = 0, planex2 = 0;
+            auto positionX = [&](int p, double qmx)
+            {
+                const int padmx = padmx_p[p];
+                const double qleft = At(fx_p[p], padmx - 1);
+                const double qright = At(fx_p[p], padmx + 1);
+                return (qmx > 10 && qleft > 0 && qright > 0) ? PositionX(qmx, padmx, qleft, qright) : -1000.;
+            };
+            for (int a = 0; a < 2; ++a)
+            {
+                const int b = 1 - a;
+                if (qmx_p[a] > qmx_p[b] && padmx_p[0] + 1 < Layout::pads_x && padmx_p[1] + 1 < Layout::pads_x)
+                {
+                    x1 = positionX(a, qmx_p[a]);
+                    planex1 = a + 1;
+                    Mask(QpadX_p[a], padmx_p[a]);
+                    Sort(QpadX_p[a]);
+                    qmx_p[a] = QpadX_p[a][0].first;
+                    padmx_p[a] = QpadX_p[a][0].second;
+                    if (qmx_p[a] > qmx_p[b] && padmx_p[a] + 1 < Layout::pads_x)
+                    {
+                        x2 = positionX(a, qmx_p[a]);
+                        planex2 = a + 1;
+                    }
+                    else if (qmx_p[b] > qmx_p[a] && padmx_p[b] + 1 < Layout::pads_x)
+                    {
+                        x2 = positionX(b, qmx_p[b]);
+                        planex2 = b + 1;
+                    }
+                    break;
+                }
+            }
+            Sort(QpadY);
+            double qmy1 = QpadY[0].first;
+            int padmy1 = QpadY[0].second;
+            if (padmy1 + 1 < Layout::pads_y)
+                y1 = qmy1 > 10 ? PositionY(qmy1, padmy1, At(fy, padmy1 - 1), At(fy, padmy1 + 1)) : -1000.;
+            Mask(QpadY, padmy1);
+            Sort(QpadY);
+            double qmy2 = QpadY[0].first;
+            int padmy2 = QpadY[0].second;
+            if (padmy2 + 1 < Layout::pads_y)
+                y2 = qmy2 > 10 ? PositionY(qmy2, padmy2, At(fy, padmy2 - 1), At(fy, padmy2 + 1)) : -1000.;
+            hits.push_back({ x1, y1, planex1 });
+            hits.push_back({ x2, y2, planex2 });
+            return hits;
+        }
+    };
+
+    // Ions with charge clusters on the X and Y planes and some noise, charges as Float_t in the cal data
+    template <typename Layout>
+    auto RandomEvent(TRandom3& random, int nIons) -> Event
+    {
+        auto event = Event{};
+        auto addCluster = [&](int plane, int nPads, double centre, double q0)
+        {
+            auto const width = random.Uniform(0.8, 2.5);
+            auto const centrePad = static_cast<int>(std::floor(centre));
+            auto const size = static_cast<int>(random.Integer(4)) + 1;
+            for (int pad = centrePad - size; pad <= centrePad + size; ++pad)
+            {
+                if (pad < 0 || pad >= nPads)
+                    continue;
+                auto const arg = (pad + 0.5 - centre) / width;
+                auto const q = q0 / std::pow(std::cosh(arg), 2) + random.Gaus(0., 2.);
+                if (q > 1.)
+                    event.push_back({ plane, pad, static_cast<float>(q) });
+            }
+        };
+        for (int ion = 0; ion < nIons; ++ion)
+        {
+            auto const q0 = random.Uniform(5., 3000.);
+            auto const x = random.Uniform(-0.5, Layout::pads_x + 0.5);
+            for (int plane = 1; plane <= Layout::x_planes; ++plane)
+            {
+                addCluster(plane, Layout::pads_x, x + random.Gaus(0., 0.2), q0 * random.Uniform(0.5, 1.));
+            }
+            addCluster(3, Layout::pads_y, random.Uniform(-0.5, Layout::pads_y + 0.5), q0);
+        }
+        auto const nNoise = static_cast<int>(random.Poisson(1.));
+        for (int idx = 0; idx < nNoise; ++idx)
+        {
+            auto const plane = random.Integer(2) == 0 ? 1 : 3;
+            auto const nPads = plane == 1 ? Layout::pads_x : Layout::pads_y;
+            auto const pad = static_cast<int>(random.Integer(nPads));
+            event.push_back({ plane, pad, static_cast<float>(random.Uniform(1., 50.)) });
+        }
+        std::shuffle(event.begin(), event.end(), std::default_random_engine(random.Integer(1000000)));
+        return event;
+    }
+
+    void ExpectSamePosition(double expected, double actual)
+    {
+        if (std::isnan(expected))
+        {
+            EXPECT_TRUE(std::isnan(actual));
+        }
+        else
+        {
+            EXPECT_DOUBLE_EQ(expected, actual);
+        }
+    }
+
+    void ExpectSameHits(const std::vector<Hit>& expected, const std::vector<Hit>& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t idx = 0; idx < expected.size(); ++idx)
+        {
+            ExpectSamePosition(expected[idx].x, actual[idx].x);
+            ExpectSamePosition(expected[idx].y, actual[idx].y);
+            EXPECT_EQ(expected[idx].plane, actual[idx].plane);
+        }
+    }
+
+    template <typename Layout>
+    auto Fill(PadPlane<Layout>& pads, const Event& event) -> PadPlane<Layout>&
+    {
+        pads.Clear();
+        for (const auto& cal : event)
+        {
+            pads.Add(cal.plane, cal.pad, cal.q);
+        }
+        return pads;
+    }
+
+    template <typename Layout>
+    void CompareWithReference(bool cog = false)
+    {
+        auto random = TRandom3(4711);
+        auto pads = PadPlane<Layout>{};
+        for (int entry = 0; entry < 5000; ++entry)
+        {
+            auto const event = RandomEvent<Layout>(random, 1 + entry % 3);
+            ExpectSameHits(Reference<Layout>::SingleHit(event, cog), Fill(pads, event).ReconstructSingleHit(cog));
+            if constexpr (Layout::x_planes == 2)
+            {
+                ExpectSameHits(Reference<Layout>::TwoHitsTwoPlanes(event), Fill(pads, event).ReconstructTwoHits());
+            }
+            else
+            {
+                ExpectSameHits(Reference<Layout>::TwoHitsOnePlane(event), Fill(pads, event).ReconstructTwoHits());
+            }
+        }
+    }
+
+    TEST(testMwpcPadPlane, Mwpc0AsBefore) { CompareWithReference<Mwpc0>(); }
+
+    TEST(testMwpcPadPlane, Mwpc1AsBefore)
+    {
+        CompareWithReference<Mwpc1>();
+        CompareWithReference<Mwpc1>(true);
+    }
+
+    TEST(testMwpcPadPlane, Mwpc2AsBefore) { CompareWithReference<Mwpc2>(); }
+
+    TEST(testMwpcPadPlane, Mwpc3AsBefore) { CompareWithReference<Mwpc3>(); }
+
+    TEST(testMwpcPadPlane, RowOutsideIsZero)
+    {
+        auto row = PadRow<int, 64>{};
+        row.Set(-1, 10.);
+        row.Set(64, 10.);
+        row.Set(3, 12.7);
+        row.Add(3, 1.6);
+        EXPECT_EQ(row[-1], 0.);
+        EXPECT_EQ(row[64], 0.);
+        EXPECT_EQ(row[3], 13.);
+        row.Clear();
+        EXPECT_EQ(row[3], 0.);
+    }
+
+    TEST(testMwpcPadPlane, PeaksInInputOrder)
+    {
+        auto list = HitList{};
+        EXPECT_EQ(list.First().pad, -1);
+        using Hits = std::vector<std::pair<int, double>>;
+        for (const auto& [pad, q] : Hits{ { 10, 5. }, { 20, 8. }, { 21, 8. }, { 40, 3. }, { 41, 8. }, { 5, 1. } })
+        {
+            list.Add(pad, q);
+        }
+        auto const first = list.First();
+        EXPECT_EQ(first.pad, 20);
+        EXPECT_EQ(first.q, 8.);
+        auto const next = list.Next(first);
+        EXPECT_EQ(next.pad, 41);
+        EXPECT_EQ(next.q, 8.);
+
+        // all pads within the window: the first of the largest charges, with zero charge
+        auto cluster = HitList{};
+        for (const auto& [pad, q] : Hits{ { 30, 2. }, { 31, 9. }, { 32, 4. }, { 33, 9. } })
+        {
+            cluster.Add(pad, q);
+        }
+        auto const masked = cluster.Next(cluster.First());
+        EXPECT_EQ(masked.pad, 31);
+        EXPECT_EQ(masked.q, 0.);
+    }
+} // namespace
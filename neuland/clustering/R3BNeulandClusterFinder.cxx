@@ -14,9 +14,25 @@
 #include "R3BNeulandClusterFinder.h"
 #include "FairLogger.h"
 #include <algorithm>
+#include <climits>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
+namespace
+{
+    // Cell index such that |a - b| < d implies neighbouring or equal cells of a and b
+    int GetCell(const Double_t value, const Double_t width)
+    {
+        const auto cell = std::floor(value / width);
+        if (!(std::abs(cell) < INT_MAX / 2))
+        {
+            return 0; // also catches NaN, such hits never satisfy the condition anyway
+        }
+        return static_cast<int>(cell);
+    }
+} // namespace
+
 R3BNeulandClusterFinder::R3BNeulandClusterFinder(const Double_t dx,
                                                  const Double_t dy,
                                                  const Double_t dz,
@@ -27,11 +43,18 @@ R3BNeulandClusterFinder::R3BNeulandClusterFinder(const Double_t dx,
     , fDigis(input)
     , fClusters(output)
 {
-    fClusteringEngine.SetClusteringCondition([=](const R3BNeulandHit& a, const R3BNeulandHit& b) {
+    const auto clusteringCondition = [=](const R3BNeulandHit& a, const R3BNeulandHit& b)
+    {
         return std::abs(a.GetPosition().X() - b.GetPosition().X()) < dx &&
                std::abs(a.GetPosition().Y() - b.GetPosition().Y()) < dy &&
                std::abs(a.GetPosition().Z() - b.GetPosition().Z()) < dz && std::abs(a.GetT() - b.GetT()) < dt;
-    });
+    };
+    fClusteringEngine.SetClusteringCondition(clusteringCondition);
+    fGridClusteringEngine.SetClusteringCondition(clusteringCondition);
+    // Cells in x and y as well would cost more lookups than they save evaluations of the condition
+    fGridClusteringEngine.SetKeyFunction(
+        [=](const R3BNeulandHit& hit)
+        { return std::array<int, 2>{ GetCell(hit.GetPosition().Z(), dz), GetCell(hit.GetT(), dt) }; });
 }
 
 InitStatus R3BNeulandClusterFinder::Init()
@@ -49,7 +72,8 @@ void R3BNeulandClusterFinder::Exec(Option_t*)
     const auto nDigis = digis.size();
 
     // Group them using the clustering condition set above: vector of digis -> vector of vector of digis
-    auto clusteredDigis = fClusteringEngine.Clusterize(digis);
+    auto clusteredDigis =
+        fUseGridClustering ? fGridClusteringEngine.Clusterize(digis) : fClusteringEngine.Clusterize(digis);
     const auto nClusters = clusteredDigis.size();
 
     LOG(debug) << "R3BNeulandClusterFinder - nDigis nCluster:" << nDigis << " " << nClusters;
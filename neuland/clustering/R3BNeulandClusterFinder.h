@@ -19,6 +19,9 @@
  * @author Jan Mayer
  *
  * For each event, get the R3BNeulandHits and group them into R3BNeulandClusters using the Neuland Clustering Engine.
+ * By default, events with at least 200 hits are clustered with the grid clustering engine, which only compares hits in
+ * neighbouring (z, t) cells, i.e. groups of planes and time buckets, and finds the same clusters. Smaller events, the
+ * common case, are faster with the comparison of all pairs.
  *   Input:  Branch NeulandHits    = TClonesArray("R3BNeulandDigi")
  *   Output: Branch NeulandClusters = TClonesArray("R3BNeulandCluster")
  *
@@ -27,6 +30,7 @@
 #include <TClonesArray.h>
 #include "ClusteringEngine.h"
 #include "FairTask.h"
+#include "GridClusteringEngine.h"
 #include "R3BNeulandCluster.h"
 #include "R3BNeulandHit.h"
 #include "TCAConnector.h"
@@ -55,8 +59,13 @@ class R3BNeulandClusterFinder : public FairTask
   public:
     void Exec(Option_t*) override;
 
+    // false: compare all pairs of hits (ClusteringEngine) instead of hits in neighbouring cells only
+    void SetUseGridClustering(bool use) { fUseGridClustering = use; }
+
   private:
     Neuland::ClusteringEngine<R3BNeulandHit> fClusteringEngine;
+    Neuland::GridClusteringEngine<R3BNeulandHit, 2> fGridClusteringEngine;
+    bool fUseGridClustering = true;
     TCAInputConnector<R3BNeulandHit> fDigis;
     TCAOutputConnector<R3BNeulandCluster> fClusters;
 
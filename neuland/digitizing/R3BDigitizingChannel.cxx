@@ -38,6 +38,12 @@ namespace R3B::Digitizing
 
     auto Channel::HasFired() -> bool { return (!GetSignals().empty()); }
 
+    void Channel::Reset()
+    {
+        InvalidateSignals();
+        InvalidateTrigTime();
+    }
+
     auto Channel::GetTrigTime() -> double
     {
         if (!fTrigTime.valid())
@@ -68,6 +68,8 @@ namespace R3B::Digitizing
 
         virtual void AddHit(Hit hit) = 0;
         virtual auto HasFired() -> bool;
+        // removes all hits for the next event, containers should keep their capacity
+        virtual void Reset();
 
         // Getters:
         virtual auto GetTrigTime() -> double;
@@ -22,6 +22,12 @@ namespace R3B::Digitizing::Neuland
             m_Signals.emplace_back(signal);
         }
 
+        void Reset() override
+        {
+            Digitizing::Channel::Reset();
+            m_Signals.clear();
+        }
+
         void AttachToPaddle(Digitizing::Paddle* paddle) override {}
 
       private:
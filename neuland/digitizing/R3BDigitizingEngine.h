@@ -18,10 +18,12 @@
 #include "R3BDigitizingChannel.h"
 #include "R3BDigitizingPaddle.h"
 #include "Rtypes.h"
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace R3B::Digitizing
 {
@@ -38,6 +40,11 @@ namespace R3B::Digitizing
 
         virtual void DepositLight(int paddle_id, double time, double light, double dist) = 0;
         [[nodiscard]] virtual auto GetTriggerTime() const -> double = 0;
+        // paddles with light deposits since the last Reset(), sorted by paddle ID
+        [[nodiscard]] virtual auto GetPaddles() const -> const std::vector<Paddle*>& = 0;
+        // clears the paddles of the current event, which stay allocated for the next ones
+        virtual void Reset() = 0;
+        // moves the paddles of the current event out of the engine, which has to rebuild them
         virtual auto ExtractPaddles() -> std::map<int, std::unique_ptr<Paddle>> = 0;
         virtual void Init() = 0;
     };
@@ -75,9 +82,21 @@ namespace R3B::Digitizing
       private:
         UsePaddle<PaddleClass> paddleClass_;
         UseChannel<ChannelClass> channelClass_;
-        std::map<int, std::unique_ptr<Paddle>> paddles;
+        // paddle pool indexed by paddle ID, paddles and channels are reused in every event
+        std::vector<std::unique_ptr<Paddle>> paddlePool_;
+        std::vector<bool> isActive_;
+        mutable std::vector<Paddle*> activePaddles_;
+        mutable bool isSorted_ = true;
         InitFunc initFunc_;
 
+        auto BuildPaddle(int paddle_id) -> std::unique_ptr<Paddle>
+        {
+            auto newPaddle = paddleClass_.BuildPaddle(paddle_id);
+            newPaddle->SetChannel(channelClass_.BuildChannel(Digitizing::ChannelSide::left));
+            newPaddle->SetChannel(channelClass_.BuildChannel(Digitizing::ChannelSide::right));
+            return newPaddle;
+        }
+
       public:
         DigitizingEngine(
             const UsePaddle<PaddleClass>& p_paddleClass,
@@ -92,31 +111,89 @@ namespace R3B::Digitizing
 
         void DepositLight(int paddle_id, double time, double light, double dist) override
         {
-            if (paddles.find(paddle_id) == paddles.end())
+            if (paddle_id < 0)
+            {
+                LOG(fatal) << "DigitizingEngine: invalid paddle ID " << paddle_id;
+                return;
+            }
+            const auto index = static_cast<size_t>(paddle_id);
+            if (index >= paddlePool_.size())
+            {
+                paddlePool_.resize(index + 1);
+                isActive_.resize(index + 1, false);
+            }
+
+            auto& paddle = paddlePool_[index];
+            if (!paddle)
+            {
+                paddle = BuildPaddle(paddle_id);
+            }
+            if (!isActive_[index])
+            {
+                isActive_[index] = true;
+                isSorted_ = isSorted_ && (activePaddles_.empty() || activePaddles_.back()->GetPaddleID() < paddle_id);
+                activePaddles_.push_back(paddle.get());
+            }
+            paddle->DepositLight({ time, light, dist });
+        }
+
+        [[nodiscard]] auto GetPaddles() const -> const std::vector<Paddle*>& override
+        {
+            if (!isSorted_)
             {
-                auto newPaddle = paddleClass_.BuildPaddle(paddle_id);
-                newPaddle->SetChannel(channelClass_.BuildChannel(Digitizing::ChannelSide::left));
-                newPaddle->SetChannel(channelClass_.BuildChannel(Digitizing::ChannelSide::right));
-                paddles[paddle_id] = std::move(newPaddle);
+                std::sort(activePaddles_.begin(),
+                          activePaddles_.end(),
+                          [](const auto* left, const auto* right)
+                          { return left->GetPaddleID() < right->GetPaddleID(); });
+                isSorted_ = true;
             }
-            paddles.at(paddle_id)->DepositLight({ time, light, dist });
+            return activePaddles_;
         }
 
         [[nodiscard]] auto GetTriggerTime() const -> double override
         {
+            const auto& paddles = GetPaddles();
             auto min_element = std::min_element(paddles.begin(),
                                                 paddles.end(),
-                                                [](const auto& left, const auto& right)
-                                                { return left.second->GetTrigTime() < right.second->GetTrigTime(); });
-            return (min_element == paddles.end()) ? NAN : min_element->second->GetTrigTime();
+                                                [](const auto* left, const auto* right)
+                                                { return left->GetTrigTime() < right->GetTrigTime(); });
+            return (min_element == paddles.end()) ? NAN : (*min_element)->GetTrigTime();
+        }
+
+        void Reset() override
+        {
+            for (auto* paddle : activePaddles_)
+            {
+                paddle->Reset();
+                isActive_[paddle->GetPaddleID()] = false;
+            }
+            activePaddles_.clear();
+            isSorted_ = true;
         }
 
         [[nodiscard]] auto ExtractPaddles() -> std::map<int, std::unique_ptr<Paddle>> override
         {
-            return std::move(paddles);
+            auto paddles = std::map<int, std::unique_ptr<Paddle>>{};
+            for (auto* paddle : activePaddles_)
+            {
+                const auto paddle_id = paddle->GetPaddleID();
+                isActive_[paddle_id] = false;
+                paddles.emplace(paddle_id, std::move(paddlePool_[paddle_id]));
+            }
+            activePaddles_.clear();
+            isSorted_ = true;
+            return paddles;
         }
 
-        void Init() override { initFunc_(); }
+        void Init() override
+        {
+            // channels read their parameters when they are attached to a paddle
+            paddlePool_.clear();
+            isActive_.clear();
+            activePaddles_.clear();
+            isSorted_ = true;
+            initFunc_();
+        }
         void SetInit(const InitFunc& initFunc) { initFunc_ = initFunc; }
     };
 
@@ -47,6 +47,13 @@ namespace R3B::Digitizing
         fRightChannel->AddHit(channelHits.right);
     }
 
+    void Paddle::Reset()
+    {
+        fSignals.invalidate();
+        fLeftChannel->Reset();
+        fRightChannel->Reset();
+    }
+
     auto Paddle::HasFired() const -> bool
     {
         if (!fLeftChannel || !fRightChannel)
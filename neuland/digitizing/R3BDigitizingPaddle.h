@@ -79,6 +79,8 @@ namespace R3B::Digitizing
         auto operator=(Paddle&& other) -> Paddle& = delete;
 
         void DepositLight(const Hit& hit);
+        // removes all hits of both channels for the next event
+        void Reset();
 
         void SetChannel(std::unique_ptr<Channel> channel);
         void SetSignalCouplingStrategy(const SignalCouplingStrategy& strategy) { fSignalCouplingStrategy = strategy; }
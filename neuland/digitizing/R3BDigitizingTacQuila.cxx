@@ -47,6 +47,16 @@ namespace R3B::Digitizing::Neuland::TacQuila
         cachedFirstHitOverThresh.invalidate();
     }
 
+    void Channel::Reset()
+    {
+        Digitizing::Channel::Reset();
+        fPMTHits.clear();
+        cachedFirstHitOverThresh.invalidate();
+        cachedQDC.invalidate();
+        cachedTDC.invalidate();
+        cachedEnergy.invalidate();
+    }
+
     bool Channel::HasFired()
     {
         if (!cachedFirstHitOverThresh.valid())
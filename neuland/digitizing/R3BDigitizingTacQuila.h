@@ -44,6 +44,7 @@ namespace R3B::Digitizing::Neuland::TacQuila
         explicit Channel(ChannelSide, const TacQuila::Params& = TACQUILA_DEFAULT_PARAM);
         ~Channel() override = default;
         void AddHit(Hit newHit) override;
+        void Reset() override;
         bool HasFired() override;
         double GetQDC();
         double GetTDC();
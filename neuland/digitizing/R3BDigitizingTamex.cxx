@@ -232,6 +232,13 @@ namespace R3B::Digitizing::Neuland::Tamex
         fPMTPeaks.emplace_back(newHit, *this);
     }
 
+    void Channel::Reset()
+    {
+        Digitizing::Channel::Reset();
+        fPMTPeaks.clear();
+        fFQTPeaks.clear();
+    }
+
     auto Channel::CreateSignal(const Peak& peak) const -> Signal
     {
         auto peakQdc = peak.GetQDC();
@@ -276,10 +283,11 @@ namespace R3B::Digitizing::Neuland::Tamex
         peaks.erase(it_end, peaks.end());
     }
 
-    auto Channel::ConstructFQTPeaks(std::vector<PMTPeak>& pmtPeaks) -> std::vector<Peak>
+    void Channel::ConstructFQTPeaks(std::vector<PMTPeak>& pmtPeaks)
     {
-        auto FQTPeaks = std::vector<Peak>{};
-        FQTPeaks.reserve(pmtPeaks.size());
+        // fFQTPeaks is refilled in place to keep its capacity over events
+        fFQTPeaks.clear();
+        fFQTPeaks.reserve(pmtPeaks.size());
 
         // sorting pmt peaks according to time:
         std::sort(pmtPeaks.begin(), pmtPeaks.end());
@@ -288,14 +296,13 @@ namespace R3B::Digitizing::Neuland::Tamex
         ApplyThreshold(pmtPeaks);
         for (auto const& peak : pmtPeaks)
         {
-            FQTPeaks.emplace_back(peak, this);
+            fFQTPeaks.emplace_back(peak, this);
         }
-        return FQTPeaks;
     }
 
     auto Channel::ConstructSignals() -> Signals
     {
-        fFQTPeaks = ConstructFQTPeaks(fPMTPeaks);
+        ConstructFQTPeaks(fPMTPeaks);
         // signal pileup:
         PeakPilingUp(fFQTPeaks);
 
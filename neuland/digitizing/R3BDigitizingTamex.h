@@ -129,6 +129,7 @@ namespace R3B::Digitizing::Neuland::Tamex
         {
         }
         void AddHit(Hit /*hit*/) override;
+        void Reset() override;
 
         // Getters:
         auto GetPar() -> Tamex::Params& { return par_; }
@@ -157,7 +158,7 @@ namespace R3B::Digitizing::Neuland::Tamex
         auto ToUnSatQdc(double) const -> double;
         template <typename Peak>
         void ApplyThreshold(/* inout */ std::vector<Peak>&);
-        auto ConstructFQTPeaks(std::vector<PMTPeak>& pmtPeaks) -> std::vector<Peak>;
+        void ConstructFQTPeaks(std::vector<PMTPeak>& pmtPeaks);
         template <typename Peak>
         static void PeakPilingUp(/* inout */ std::vector<Peak>& peaks);
     };
@@ -93,11 +93,36 @@ InitStatus R3BNeulandDigitizer::Init()
 void R3BNeulandDigitizer::Exec(Option_t* /*option*/)
 {
     fHits.Reset();
+    fDigitizingEngine->Reset();
+
+    const Double_t triggerTime =
+        DigitizeEvent(*fDigitizingEngine, *fNeulandGeoPar, fPoints.Retrieve(), fHitFilters, fEventHits);
+    const auto& paddles = fDigitizingEngine->GetPaddles();
+
+    // Fill control histograms
+    hMultOne->Fill(static_cast<int>(
+        std::count_if(paddles.begin(), paddles.end(), [](const auto* paddle) { return paddle->HasHalfFired(); })));
+
+    hMultTwo->Fill(static_cast<int>(
+        std::count_if(paddles.begin(), paddles.end(), [](const auto* paddle) { return paddle->HasFired(); })));
+
+    hRLTimeToTrig->Fill(triggerTime);
+
+    fHits.Insert(fEventHits);
+
+    LOG(debug) << "R3BNeulandDigitizer: produced " << fHits.Size() << " hits";
+}
+
+auto R3BNeulandDigitizer::DigitizeEvent(Digitizing::DigitizingEngineInterface& engine,
+                                        const R3BNeulandGeoPar& geoPar,
+                                        const std::vector<R3BNeulandPoint*>& points,
+                                        const Filterable<R3BNeulandHit&>& filters,
+                                        std::vector<R3BNeulandHit>& hits) -> double
+{
     const auto GeVToMeVFac = 1000.;
 
-    std::map<UInt_t, Double_t> paddleEnergyDeposit;
     // Look at each Land Point, if it deposited energy in the scintillator, store it with reference to the bar
-    for (const auto& point : fPoints.Retrieve())
+    for (const auto* point : points)
     {
         if (point->GetEnergyLoss() > 0.)
         {
@@ -105,7 +130,7 @@ void R3BNeulandDigitizer::Exec(Option_t* /*option*/)
 
             // Convert position of point to paddle-coordinates, including any rotation or translation
             const TVector3 position = point->GetPosition();
-            const TVector3 converted_position = fNeulandGeoPar->ConvertToLocalCoordinates(position, paddleID);
+            const TVector3 converted_position = geoPar.ConvertToLocalCoordinates(position, paddleID);
             LOG(debug2) << "NeulandDigitizer: Point in paddle " << paddleID
                         << " with global position XYZ: " << position.X() << " " << position.Y() << " " << position.Z();
             LOG(debug2) << "NeulandDigitizer: Converted to local position XYZ: " << converted_position.X() << " "
@@ -114,38 +139,28 @@ void R3BNeulandDigitizer::Exec(Option_t* /*option*/)
             // Within the paddle frame, the relevant distance of the light from the pmt is always given by the
             // X-Coordinate
             const Double_t dist = converted_position.X();
-            fDigitizingEngine->DepositLight(paddleID, point->GetTime(), point->GetLightYield() * GeVToMeVFac, dist);
-            paddleEnergyDeposit[paddleID] += point->GetEnergyLoss() * GeVToMeVFac;
+            engine.DepositLight(paddleID, point->GetTime(), point->GetLightYield() * GeVToMeVFac, dist);
         } // eloss
     }     // points
 
-    const Double_t triggerTime = fDigitizingEngine->GetTriggerTime();
-    const auto paddles = fDigitizingEngine->ExtractPaddles();
-
-    // Fill control histograms
-    hMultOne->Fill(static_cast<int>(std::count_if(
-        paddles.begin(), paddles.end(), [](const auto& keyValue) { return keyValue.second->HasHalfFired(); })));
-
-    hMultTwo->Fill(static_cast<int>(std::count_if(
-        paddles.begin(), paddles.end(), [](const auto& keyValue) { return keyValue.second->HasFired(); })));
-
-    hRLTimeToTrig->Fill(triggerTime);
+    const Double_t triggerTime = engine.GetTriggerTime();
 
     // Create Hits
-    for (const auto& [paddleID, paddle] : paddles)
+    for (const auto* paddle : engine.GetPaddles())
     {
         if (!paddle->HasFired())
         {
             continue;
         }
+        const auto paddleID = paddle->GetPaddleID();
 
-        auto signals = paddle->GetSignals();
+        const auto& signals = paddle->GetSignals();
 
-        for (const auto signal : signals)
+        for (const auto& signal : signals)
         {
             const TVector3 hitPositionLocal = TVector3(signal.position, 0., 0.);
-            const TVector3 hitPositionGlobal = fNeulandGeoPar->ConvertToGlobalCoordinates(hitPositionLocal, paddleID);
-            const TVector3 hitPixel = fNeulandGeoPar->ConvertGlobalToPixel(hitPositionGlobal);
+            const TVector3 hitPositionGlobal = geoPar.ConvertToGlobalCoordinates(hitPositionLocal, paddleID);
+            const TVector3 hitPixel = geoPar.ConvertGlobalToPixel(hitPositionGlobal);
 
             R3BNeulandHit hit(paddleID,
                               signal.leftChannel.tdc,
@@ -157,16 +172,16 @@ void R3BNeulandDigitizer::Exec(Option_t* /*option*/)
                               hitPositionGlobal,
                               hitPixel);
 
-            if (fHitFilters.IsValid(hit))
+            if (filters.IsValid(hit))
             {
-                fHits.Insert(std::move(hit));
                 LOG(debug) << "Adding neuland hit with id = " << paddleID << ", time = " << signal.time
                            << ", energy = " << signal.energy;
+                hits.push_back(std::move(hit));
             }
         } // loop over all hits for each paddle
     }     // loop over paddles
 
-    LOG(debug) << "R3BNeulandDigitizer: produced " << fHits.Size() << " hits";
+    return triggerTime;
 }
 
 void R3BNeulandDigitizer::Finish()
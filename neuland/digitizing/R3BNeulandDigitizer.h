@@ -83,6 +83,15 @@ class R3BNeulandDigitizer : public FairTask
     void SetEngine(std::unique_ptr<Digitizing::DigitizingEngineInterface> engine);
     void AddFilter(const Filterable<R3BNeulandHit&>::Filter& filter) { fHitFilters.Add(filter); }
 
+    // Applies the detector response to the points of one event and appends the accepted hits. The paddles of the
+    // event stay in the engine. Also used by R3BNeulandDigitizingWorker in parallel threads, hence it must only read
+    // the geometry and the filters. Returns the trigger time.
+    static auto DigitizeEvent(Digitizing::DigitizingEngineInterface& engine,
+                              const R3BNeulandGeoPar& geoPar,
+                              const std::vector<R3BNeulandPoint*>& points,
+                              const Filterable<R3BNeulandHit&>& filters,
+                              std::vector<R3BNeulandHit>& hits) -> double;
+
   private:
     TCAInputConnector<R3BNeulandPoint> fPoints;
     TCAOutputConnector<R3BNeulandHit> fHits;
@@ -90,6 +99,7 @@ class R3BNeulandDigitizer : public FairTask
     std::unique_ptr<Digitizing::DigitizingEngineInterface> fDigitizingEngine; // owning
 
     Filterable<R3BNeulandHit&> fHitFilters;
+    std::vector<R3BNeulandHit> fEventHits; //!
 
     R3BNeulandGeoPar* fNeulandGeoPar = nullptr; // non-owning
 
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BNeulandDigitizingWorker.h"
+#include "R3BDigitizingPaddleNeuland.h"
+#include "R3BNeulandDigitizer.h"
+#include "R3BNeulandGeoPar.h"
+#include <TClonesArray.h>
+
+namespace Digitizing = R3B::Digitizing;
+using NeulandPaddle = Digitizing::Neuland::NeulandPaddle;
+using TamexChannel = Digitizing::Neuland::Tamex::Channel;
+using TacquilaChannel = Digitizing::Neuland::TacQuila::Channel;
+using Digitizing::UseChannel;
+using Digitizing::UsePaddle;
+
+R3BNeulandDigitizingWorker::R3BNeulandDigitizingWorker(const R3BNeulandGeoPar& geoPar,
+                                                       const Digitizing::Neuland::Tamex::Params& par,
+                                                       TRandom3& rnd)
+    : fNeulandGeoPar(geoPar)
+    , fTamexPar(std::make_unique<Digitizing::Neuland::Tamex::Params>(par))
+{
+    fTamexPar->fRnd = &rnd;
+    fDigitizingEngine = Digitizing::CreateEngine(UsePaddle<NeulandPaddle>(), UseChannel<TamexChannel>(*fTamexPar));
+    fDigitizingEngine->Init();
+}
+
+R3BNeulandDigitizingWorker::R3BNeulandDigitizingWorker(const R3BNeulandGeoPar& geoPar,
+                                                       const Digitizing::Neuland::TacQuila::Params& par,
+                                                       TRandom3& rnd)
+    : fNeulandGeoPar(geoPar)
+    , fTacQuilaPar(std::make_unique<Digitizing::Neuland::TacQuila::Params>(par))
+{
+    // non-owning, the generator belongs to R3BParallelDigitizer
+    fTacQuilaPar->fRnd = std::shared_ptr<TRandom3>(std::shared_ptr<TRandom3>{}, &rnd);
+    fDigitizingEngine =
+        Digitizing::CreateEngine(UsePaddle<NeulandPaddle>(), UseChannel<TacquilaChannel>(*fTacQuilaPar));
+    fDigitizingEngine->Init();
+}
+
+void R3BNeulandDigitizingWorker::Digitize(const TClonesArray& points, TClonesArray& hits)
+{
+    fDigitizingEngine->Reset();
+
+    fPoints.clear();
+    const auto nPoints = points.GetEntriesFast();
+    for (int idx = 0; idx < nPoints; ++idx)
+    {
+        fPoints.push_back(static_cast<R3BNeulandPoint*>(points.At(idx))); // NOLINT
+    }
+
+    fHits.clear();
+    R3BNeulandDigitizer::DigitizeEvent(*fDigitizingEngine, fNeulandGeoPar, fPoints, fHitFilters, fHits);
+    for (auto& hit : fHits)
+    {
+        new (hits[hits.GetEntriesFast()]) R3BNeulandHit(std::move(hit));
+    }
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include "Filterable.h"
+#include "R3BDigitizingEngine.h"
+#include "R3BDigitizingTacQuila.h"
+#include "R3BDigitizingTamex.h"
+#include "R3BNeulandHit.h"
+#include "R3BNeulandPoint.h"
+#include "R3BParallelDigitizer.h"
+#include <memory>
+#include <vector>
+
+class R3BNeulandGeoPar;
+
+/**
+ * NeuLAND digitization in a worker thread of R3BParallelDigitizer
+ *
+ * Applies the same detector response as R3BNeulandDigitizer::Exec with its own digitizing engine. The channel
+ * parameters are copied and draw their random numbers from the generator of the worker. The geometry and the
+ * HitPar of the Tamex channels are shared between all workers and only read.
+ *   Input:  TClonesArray("R3BNeulandPoint")
+ *   Output: TClonesArray("R3BNeulandHit")
+ */
+class R3BNeulandDigitizingWorker : public R3BDigitizingWorker
+{
+  public:
+    R3BNeulandDigitizingWorker(const R3BNeulandGeoPar& geoPar,
+                               const R3B::Digitizing::Neuland::Tamex::Params& par,
+                               TRandom3& rnd);
+    R3BNeulandDigitizingWorker(const R3BNeulandGeoPar& geoPar,
+                               const R3B::Digitizing::Neuland::TacQuila::Params& par,
+                               TRandom3& rnd);
+
+    void AddFilter(const Filterable<R3BNeulandHit&>::Filter& filter) { fHitFilters.Add(filter); }
+    void Digitize(const TClonesArray& points, TClonesArray& hits) override;
+
+  private:
+    const R3BNeulandGeoPar& fNeulandGeoPar;
+    // referenced by the channels of the engine
+    std::unique_ptr<R3B::Digitizing::Neuland::Tamex::Params> fTamexPar;
+    std::unique_ptr<R3B::Digitizing::Neuland::TacQuila::Params> fTacQuilaPar;
+    std::unique_ptr<R3B::Digitizing::DigitizingEngineInterface> fDigitizingEngine;
+    Filterable<R3BNeulandHit&> fHitFilters;
+    std::vector<R3BNeulandPoint*> fPoints;
+    std::vector<R3BNeulandHit> fHits;
+};
@@ -0,0 +1,154 @@
+#include "ClusteringEngine.h"
+#include "GridClusteringEngine.h"
+#include "R3BProgramOptions.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fmt/format.h>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    // Hits with the clustering condition and cell size of R3BNeulandClusterFinder
+    struct Hit
+    {
+        double x;
+        double y;
+        double z;
+        double t;
+    };
+
+    constexpr double ClusterDX = 7.5;
+    constexpr double ClusterDY = 7.5;
+    constexpr double ClusterDZ = 15.;
+    constexpr double ClusterDT = 1.;
+
+    auto SplitNumbers(const std::string& list) -> std::vector<int>
+    {
+        auto numbers = std::vector<int>{};
+        auto stream = std::istringstream{ list };
+        for (auto item = std::string{}; std::getline(stream, item, ',');)
+        {
+            numbers.push_back(std::stoi(item));
+        }
+        return numbers;
+    }
+
+    // Several showers of neighbouring bars in a NeuLAND-like volume
+    auto MakeEvent(std::mt19937& rng, int nHits) -> std::vector<Hit>
+    {
+        const int nShowers = std::max(1, nHits / 8);
+        auto transverse = std::uniform_real_distribution<double>(-125., 125.);
+        auto depth = std::uniform_real_distribution<double>(0., 300.);
+        auto time = std::uniform_real_distribution<double>(0., 15.);
+        auto spread = std::normal_distribution<double>(0., 6.);
+        auto timeSpread = std::normal_distribution<double>(0., 0.7);
+        auto shower = std::uniform_int_distribution<int>(0, nShowers - 1);
+
+        auto centers = std::vector<Hit>{};
+        for (int idx = 0; idx < nShowers; ++idx)
+        {
+            centers.push_back({ transverse(rng), transverse(rng), depth(rng), time(rng) });
+        }
+        auto hits = std::vector<Hit>{};
+        for (int idx = 0; idx < nHits; ++idx)
+        {
+            const auto& center = centers[shower(rng)];
+            hits.push_back({ center.x + spread(rng),
+                             center.y + spread(rng),
+                             center.z + 2. * spread(rng),
+                             center.t + timeSpread(rng) });
+        }
+        return hits;
+    }
+
+    template <typename Engine>
+    auto Time(Engine& engine, std::vector<std::vector<Hit>> events, std::size_t& nClusters) -> double
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& hits : events)
+        {
+            nClusters += engine.Clusterize(hits).size();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(events.size());
+    }
+} // namespace
+
+// Time per event of the pairwise ClusteringEngine and of the GridClusteringEngine for increasing hit multiplicities,
+// to find the number of hits above which the grid pays off (GridClusteringEngine::SetMinGridSize).
+auto main(int argc, const char** argv) -> int
+{
+    auto programOptions = R3B::ProgramOptions("options for the benchmark of the NeuLAND clustering engines");
+    auto help = programOptions.Create_Option<bool>("help,h", "help message", false);
+    auto hitList = programOptions.Create_Option<std::string>(
+        "hits", "set comma separated numbers of hits per event", "10,25,50,100,150,200,300,400,800");
+    auto hitNum = programOptions.Create_Option<int>("hitNum", "set total number of hits per multiplicity", 200000);
+
+    if (!programOptions.Verify(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (help->value())
+    {
+        std::cout << programOptions.Get_DescRef() << std::endl;
+        return 0;
+    }
+
+    auto nEvaluations = std::size_t{};
+    const auto condition = [&nEvaluations](const Hit& first, const Hit& second)
+    {
+        ++nEvaluations;
+        return std::abs(first.x - second.x) < ClusterDX && std::abs(first.y - second.y) < ClusterDY &&
+               std::abs(first.z - second.z) < ClusterDZ && std::abs(first.t - second.t) < ClusterDT;
+    };
+    const auto key = [](const Hit& hit)
+    {
+        return std::array<int, 2>{ static_cast<int>(std::floor(hit.z / ClusterDZ)),
+                                   static_cast<int>(std::floor(hit.t / ClusterDT)) };
+    };
+    auto engine = Neuland::ClusteringEngine<Hit>(condition);
+    auto gridEngine = Neuland::GridClusteringEngine<Hit, 2>(condition, key);
+    gridEngine.SetMinGridSize(0);
+
+    auto rng = std::mt19937{ 1 };
+    fmt::print("{:>6} {:>14} {:>14} {:>14} {:>14}\n",
+               "hits",
+               "pairwise [us]",
+               "evaluations",
+               "grid [us]",
+               "evaluations");
+    for (const auto nHits : SplitNumbers(hitList->value()))
+    {
+        const auto nEvents = std::max(20, hitNum->value() / nHits);
+        auto events = std::vector<std::vector<Hit>>{};
+        for (int idx = 0; idx < nEvents; ++idx)
+        {
+            events.push_back(MakeEvent(rng, nHits));
+        }
+
+        auto nClusters = std::size_t{};
+        nEvaluations = 0;
+        const auto pairwiseTime = Time(engine, events, nClusters);
+        const auto pairwiseEvaluations = nEvaluations / nEvents;
+        auto nGridClusters = std::size_t{};
+        nEvaluations = 0;
+        const auto gridTime = Time(gridEngine, events, nGridClusters);
+        if (nClusters != nGridClusters)
+        {
+            std::cerr << "clusteringBench: The engines found different numbers of clusters" << std::endl;
+            return EXIT_FAILURE;
+        }
+        fmt::print("{:>6} {:>14.1f} {:>14} {:>14.1f} {:>14}\n",
+                   nHits,
+                   pairwiseTime,
+                   pairwiseEvaluations,
+                   gridTime,
+                   nEvaluations / nEvents);
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "R3BNeulandDenseModel.h"
+#include "R3BProgramOptions.h"
+#include <chrono>
+#include <fmt/format.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    auto RandomLayer(std::mt19937& rng,
+                     std::size_t nInputs,
+                     std::size_t nOutputs,
+                     R3BNeulandDenseModel::Activation activation) -> R3BNeulandDenseModel::Layer
+    {
+        auto dist = std::normal_distribution<double>(0., 0.3);
+        auto layer = R3BNeulandDenseModel::Layer{};
+        layer.nInputs = nInputs;
+        layer.nOutputs = nOutputs;
+        layer.activation = activation;
+        layer.weights.resize(nInputs * nOutputs);
+        layer.bias.resize(nOutputs);
+        for (auto& weight : layer.weights)
+        {
+            weight = dist(rng);
+        }
+        for (auto& bias : layer.bias)
+        {
+            bias = dist(rng);
+        }
+        return layer;
+    }
+} // namespace
+
+// Time per event of R3BNeulandDenseModel::Predict for all clusters of an event, either for a given model file
+// or for a random model of the size of the neutron models (features -> hidden -> hidden -> 2).
+auto main(int argc, const char** argv) -> int
+{
+    auto programOptions = R3B::ProgramOptions("options for the benchmark of the NeuLAND dense model");
+    auto help = programOptions.Create_Option<bool>("help,h", "help message", false);
+    auto modelFile =
+        programOptions.Create_Option<std::string>("model", "use this model file instead of a random one", "");
+    auto featureNum = programOptions.Create_Option<int>("features", "set number of features of the random model", 10);
+    auto hiddenNum = programOptions.Create_Option<int>("hidden", "set number of nodes per hidden layer", 64);
+    auto clusterNum = programOptions.Create_Option<int>("clusters", "set number of clusters per event", 30);
+    auto eventNum = programOptions.Create_Option<int>("eventNum,n", "set number of events", 10000);
+
+    if (!programOptions.Verify(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (help->value())
+    {
+        std::cout << programOptions.Get_DescRef() << std::endl;
+        return 0;
+    }
+
+    auto rng = std::mt19937{ 1 };
+    auto model = R3BNeulandDenseModel{};
+    try
+    {
+        if (!modelFile->value().empty())
+        {
+            model.Load(modelFile->value());
+        }
+        else
+        {
+            const auto nFeatures = static_cast<std::size_t>(featureNum->value());
+            const auto nHidden = static_cast<std::size_t>(hiddenNum->value());
+            model.SetScaler(std::vector<double>(nFeatures, 1.), std::vector<double>(nFeatures, 2.));
+            model.AddLayer(RandomLayer(rng, nFeatures, nHidden, R3BNeulandDenseModel::Activation::relu));
+            model.AddLayer(RandomLayer(rng, nHidden, nHidden, R3BNeulandDenseModel::Activation::relu));
+            model.AddLayer(RandomLayer(rng, nHidden, 2, R3BNeulandDenseModel::Activation::softmax));
+        }
+    }
+    catch (const std::runtime_error& err)
+    {
+        std::cerr << "denseModelBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto nClusters = static_cast<std::size_t>(clusterNum->value());
+    const auto nEvents = eventNum->value();
+    auto dist = std::normal_distribution<double>(0., 0.3);
+    auto inputs = std::vector<double>(nClusters * model.GetNInputs());
+    for (auto& input : inputs)
+    {
+        input = dist(rng);
+    }
+    auto outputs = std::vector<double>(nClusters * model.GetNOutputs());
+
+    auto sum = 0.;
+    const auto start = std::chrono::steady_clock::now();
+    for (int event = 0; event < nEvents; ++event)
+    {
+        inputs[event % inputs.size()] += 1e-3;
+        model.Predict(inputs.data(), nClusters, outputs.data());
+        sum += outputs.back();
+    }
+    const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+
+    fmt::print("R3BNeulandDenseModel: {:.2f} us per event with {} clusters (checksum {:.6g})\n",
+               elapsed.count() / nEvents,
+               nClusters,
+               sum);
+    return 0;
+}
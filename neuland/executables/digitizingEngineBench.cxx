@@ -0,0 +1,128 @@
+#include "R3BDigitizingEngine.h"
+#include "R3BDigitizingPaddleNeuland.h"
+#include "R3BDigitizingTamex.h"
+#include "R3BProgramOptions.h"
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace Digitizing = R3B::Digitizing;
+    using Digitizing::UseChannel;
+    using Digitizing::UsePaddle;
+    using Digitizing::Neuland::NeulandPaddle;
+    using TamexChannel = Digitizing::Neuland::Tamex::Channel;
+    using TamexPar = Digitizing::Neuland::Tamex::Params;
+
+    struct Deposit
+    {
+        int paddleID;
+        double time;
+        double light;
+        double dist;
+    };
+
+    // events with deposits in a NeuLAND of the given number of paddles
+    auto GenerateEvents(int nEvents, int depositsPerEvent, int nPaddles) -> std::vector<std::vector<Deposit>>
+    {
+        auto rnd = std::mt19937{ 42 }; // NOLINT
+        auto paddle = std::uniform_int_distribution<int>{ 1, nPaddles };
+        auto time = std::uniform_real_distribution<double>{ 10., 200. };
+        auto light = std::exponential_distribution<double>{ 0.2 };
+        auto dist = std::uniform_real_distribution<double>{ -125., 125. };
+
+        auto events = std::vector<std::vector<Deposit>>(nEvents);
+        for (auto& event : events)
+        {
+            // hits are clustered in a few neighbouring paddles
+            for (int idx = 0; idx < depositsPerEvent; ++idx)
+            {
+                const auto center = paddle(rnd);
+                event.push_back({ std::min(nPaddles, center + idx % 3), time(rnd), light(rnd), dist(rnd) });
+            }
+        }
+        return events;
+    }
+} // namespace
+
+// Event rate of the digitizing engine with new paddles in every event (ExtractPaddles) and with the paddles
+// kept in the pool of the engine between the events (Reset and GetPaddles).
+auto main(int argc, const char** argv) -> int
+{
+    auto programOptions = R3B::ProgramOptions("options for the benchmark of the NeuLAND digitizing engine");
+    auto help = programOptions.Create_Option<bool>("help,h", "help message", false);
+    auto eventNum = programOptions.Create_Option<int>("eventNum,n", "set number of events", 20000);
+    auto depositNum = programOptions.Create_Option<int>("deposits", "set number of deposits per event", 40);
+    auto paddleNum = programOptions.Create_Option<int>("paddles", "set number of paddles", 1300);
+
+    if (!programOptions.Verify(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (help->value())
+    {
+        std::cout << programOptions.Get_DescRef() << std::endl;
+        return 0;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto nEvents = eventNum->value();
+    const auto events = GenerateEvents(nEvents, depositNum->value(), paddleNum->value());
+
+    auto par = TamexPar{ TamexChannel::GetDefaultRandomGen() };
+    auto engine = Digitizing::CreateEngine(UsePaddle<NeulandPaddle>(), UseChannel<TamexChannel>(par));
+    engine->Init();
+
+    auto nSignals = size_t{};
+    auto processPaddles = [&nSignals](const auto& paddles, auto getPaddle)
+    {
+        for (const auto& item : paddles)
+        {
+            const auto& paddle = getPaddle(item);
+            if (paddle.HasFired())
+            {
+                nSignals += paddle.GetSignals().size();
+            }
+        }
+    };
+
+    const auto t0 = Clock::now();
+    for (const auto& event : events)
+    {
+        for (const auto& deposit : event)
+        {
+            engine->DepositLight(deposit.paddleID, deposit.time, deposit.light, deposit.dist);
+        }
+        engine->GetTriggerTime();
+        processPaddles(engine->ExtractPaddles(), [](const auto& keyValue) -> auto& { return *keyValue.second; });
+    }
+    const auto newSignals = nSignals;
+
+    const auto t1 = Clock::now();
+    for (const auto& event : events)
+    {
+        engine->Reset();
+        for (const auto& deposit : event)
+        {
+            engine->DepositLight(deposit.paddleID, deposit.time, deposit.light, deposit.dist);
+        }
+        engine->GetTriggerTime();
+        processPaddles(engine->GetPaddles(), [](const auto* paddle) -> auto& { return *paddle; });
+    }
+    const auto t2 = Clock::now();
+
+    auto eventsPerSecond = [nEvents](auto dt) { return nEvents / std::chrono::duration<double>(dt).count(); };
+    fmt::print("{:<24} {:>12.0f} events/s ({} signals)\n",
+               "new paddles per event",
+               eventsPerSecond(t1 - t0),
+               newSignals);
+    fmt::print("{:<24} {:>12.0f} events/s ({} signals)\n",
+               "paddle pool",
+               eventsPerSecond(t2 - t1),
+               nSignals - newSignals);
+    return 0;
+}
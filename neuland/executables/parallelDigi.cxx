@@ -0,0 +1,149 @@
+#include "FairFileHeader.h"
+#include "FairParRootFileIo.h"
+#include "FairRunAna.h"
+#include "FairRuntimeDb.h"
+#include "R3BCalifaDigitizer.h"
+#include "R3BCalifaDigitizingWorker.h"
+#include "R3BDigitizingTacQuila.h"
+#include "R3BDigitizingTamex.h"
+#include "R3BNeulandDigitizingWorker.h"
+#include "R3BNeulandGeoPar.h"
+#include "R3BParallelDigitizer.h"
+#include "R3BProgramOptions.h"
+#include "R3BShared.h"
+#include "TStopwatch.h"
+#include <boost/program_options.hpp>
+
+namespace Digitizing = R3B::Digitizing;
+using TamexChannel = Digitizing::Neuland::Tamex::Channel;
+
+// Digitizes NeulandPoints (and CalifaPoint) of a simulation file on several threads. The output file contains only
+// the digitized branches and can be added as a friend to the simulation file in R3BFileSource2.
+auto main(int argc, const char** argv) -> int
+{
+    auto timer = TStopwatch{};
+    timer.Start();
+
+    auto programOptions = R3B::ProgramOptions("options for parallel digitization of neuland and califa points");
+    auto help = programOptions.Create_Option<bool>("help,h", "help message", false);
+    auto channelName =
+        programOptions.Create_Option<std::string>("channel", R"(set the channel name. e.g. "tamex")", "tacquila");
+    auto simuFileName =
+        programOptions.Create_Option<std::string>("simuFile", "set the filename of simulation input", "simu.root");
+    auto paraFileName =
+        programOptions.Create_Option<std::string>("paraFile", "set the filename of parameter sink", "para.root");
+    auto digiFileName =
+        programOptions.Create_Option<std::string>("digiFile", "set the filename of digitization output", "digi.root");
+    auto logLevel = programOptions.Create_Option<std::string>("logLevel,v", "set log level of fairlog", "error");
+    auto eventNum = programOptions.Create_Option<int>("eventNum,n", "set total event number", 0);
+    auto hitLevelPar =
+        programOptions.Create_Option<std::string>("hitLevelPar", "set the name of hit level parameter if needed.", "");
+    auto threadNum = programOptions.Create_Option<int>("threads,j", "set number of threads (0: all cores)", 0);
+    auto batchSize =
+        programOptions.Create_Option<int>("batchSize", "set number of events per random stream", 100); // NOLINT
+    auto seed = programOptions.Create_Option<int>("seed", "set seed of the random streams", 1);
+    auto califa = programOptions.Create_Option<bool>("califa", "digitize CalifaPoint as well", false);
+    auto califaGammaRes =
+        programOptions.Create_Option<double>("califaGammaRes", "set califa energy resolution in % @ 1 MeV", 0.);
+    auto califaProtonRes =
+        programOptions.Create_Option<double>("califaProtonRes", "set califa energy resolution for protons", 0.);
+    auto califaThreshold =
+        programOptions.Create_Option<double>("califaThreshold", "set califa detection threshold", 0.);
+
+    if (!programOptions.Verify(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (help->value())
+    {
+        std::cout << programOptions.Get_DescRef() << std::endl;
+        return 0;
+    }
+
+    FairLogger::GetLogger()->SetLogScreenLevel(logLevel->value().c_str());
+
+    // parameters are read on the main thread with the runtime database of an analysis run
+    auto run = std::make_unique<FairRunAna>();
+    auto* rtdb = run->GetRuntimeDb();
+    auto fileio = std::make_unique<FairParRootFileIo>();
+    fileio->open(paraFileName->value().c_str());
+    rtdb->setFirstInput(fileio.release());
+
+    auto* neulandGeoPar = dynamic_cast<R3BNeulandGeoPar*>(rtdb->getContainer("R3BNeulandGeoPar"));
+    if (not hitLevelPar->value().empty())
+    {
+        rtdb->getContainer(hitLevelPar->value().c_str());
+    }
+
+    auto runID = 0U;
+    {
+        auto simuFile = R3B::make_rootfile(simuFileName->value().c_str());
+        if (auto* header = simuFile->Get<FairFileHeader>("FileHeader"); header != nullptr)
+        {
+            runID = header->GetRunId();
+        }
+    }
+    rtdb->initContainers(runID);
+    if (neulandGeoPar == nullptr)
+    {
+        LOG(fatal) << "parallelDigi: No R3BNeulandGeoPar";
+        return EXIT_FAILURE;
+    }
+    if (not hitLevelPar->value().empty())
+    {
+        TamexChannel::GetHitPar(hitLevelPar->value());
+    }
+
+    auto tamexParameter = Digitizing::Neuland::Tamex::Params{ TamexChannel::GetDefaultRandomGen() };
+    tamexParameter.fPMTThresh = 1.;
+    tamexParameter.fTimeMin = 1.;
+    const auto tacquilaParameter = Digitizing::Neuland::TacQuila::Params{};
+
+    if (channelName->value() != "tamex" && channelName->value() != "tacquila")
+    {
+        LOG(error) << "parallelDigi: Unknown channel " << channelName->value();
+        return EXIT_FAILURE;
+    }
+
+    auto digitizer = R3BParallelDigitizer(simuFileName->value(), digiFileName->value());
+    digitizer.SetNThreads(static_cast<unsigned int>(std::max(0, threadNum->value())));
+    digitizer.SetBatchSize(static_cast<unsigned int>(std::max(1, batchSize->value())));
+    digitizer.SetSeed(static_cast<uint64_t>(seed->value()));
+
+    digitizer.AddDetector("NeulandPoints",
+                          "NeulandHits",
+                          "R3BNeulandHit",
+                          [&](TRandom3& rnd) -> std::unique_ptr<R3BDigitizingWorker>
+                          {
+                              if (channelName->value() == "tamex")
+                              {
+                                  return std::make_unique<R3BNeulandDigitizingWorker>(
+                                      *neulandGeoPar, tamexParameter, rnd);
+                              }
+                              return std::make_unique<R3BNeulandDigitizingWorker>(
+                                  *neulandGeoPar, tacquilaParameter, rnd);
+                          });
+
+    if (califa->value())
+    {
+        digitizer.AddDetector("CalifaPoint",
+                              "CalifaCrystalCalData",
+                              "R3BCalifaCrystalCalData",
+                              [&](TRandom3& rnd) -> std::unique_ptr<R3BDigitizingWorker>
+                              {
+                                  auto califaDigitizer = std::make_unique<R3BCalifaDigitizer>();
+                                  califaDigitizer->SetExpGammaEnergyRes(califaGammaRes->value());
+                                  califaDigitizer->SetExpProtonEnergyRes(califaProtonRes->value());
+                                  califaDigitizer->SetDetectionThreshold(califaThreshold->value());
+                                  califaDigitizer->SetParameter();
+                                  return std::make_unique<R3BCalifaDigitizingWorker>(std::move(califaDigitizer), rnd);
+                              });
+    }
+
+    digitizer.Run(eventNum->value());
+
+    timer.Stop();
+    std::cout << "Macro finished successfully." << std::endl;
+    std::cout << "Real time: " << timer.RealTime() << "s, CPU time: " << timer.CpuTime() << "s" << std::endl;
+}
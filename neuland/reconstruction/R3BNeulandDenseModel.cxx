@@ -0,0 +1,365 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BNeulandDenseModel.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+/* File format (plain text, whitespace separated, '#' starts a comment until the end of the line):
+ *
+ *   R3BNeulandDenseModel 1
+ *   scaler <n>                                    (optional)
+ *   <n means> <n scales>
+ *   dense <nInputs> <nOutputs> <activation>       (once per layer)
+ *   <nInputs x nOutputs weights, row-major> <nOutputs biases>
+ *   reference <nSamples> <tolerance>              (optional)
+ *   <nInputs raw inputs> <nOutputs expected outputs> (per sample)
+ *   end
+ */
+
+namespace
+{
+    constexpr int FormatVersion = 1;
+
+    class TokenReader
+    {
+      public:
+        explicit TokenReader(std::istream& input)
+            : fInput(input)
+        {
+        }
+
+        std::string Next()
+        {
+            std::string token;
+            while (fInput >> token)
+            {
+                if (token.front() != '#')
+                {
+                    return token;
+                }
+                fInput.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            }
+            throw std::runtime_error("R3BNeulandDenseModel: Unexpected end of model file");
+        }
+
+        template <typename T>
+        T Next()
+        {
+            const auto token = Next();
+            std::istringstream stream(token);
+            T value{};
+            if (!(stream >> value) || !stream.eof())
+            {
+                throw std::runtime_error("R3BNeulandDenseModel: Cannot parse '" + token + "' in model file");
+            }
+            return value;
+        }
+
+        void Fill(std::vector<double>& values, std::size_t n)
+        {
+            values.resize(n);
+            for (auto& value : values)
+            {
+                value = Next<double>();
+            }
+        }
+
+      private:
+        std::istream& fInput;
+    };
+
+    void Activate(R3BNeulandDenseModel::Activation activation, double* x, std::size_t n)
+    {
+        using Activation = R3BNeulandDenseModel::Activation;
+        switch (activation)
+        {
+            case Activation::linear:
+                break;
+            case Activation::relu:
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    x[j] = std::max(x[j], 0.);
+                }
+                break;
+            case Activation::sigmoid:
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    x[j] = 1. / (1. + std::exp(-x[j]));
+                }
+                break;
+            case Activation::tanh:
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    x[j] = std::tanh(x[j]);
+                }
+                break;
+            case Activation::softmax:
+            {
+                const double max = *std::max_element(x, x + n);
+                double sum = 0.;
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    x[j] = std::exp(x[j] - max);
+                    sum += x[j];
+                }
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    x[j] /= sum;
+                }
+                break;
+            }
+        }
+    }
+} // namespace
+
+void R3BNeulandDenseModel::Load(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Cannot open model file " + filename);
+    }
+    Load(file);
+}
+
+void R3BNeulandDenseModel::Load(std::istream& input)
+{
+    Clear();
+    TokenReader reader(input);
+
+    if (reader.Next() != "R3BNeulandDenseModel")
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Not a model file");
+    }
+    if (const auto version = reader.Next<int>(); version != FormatVersion)
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Unsupported model file version " + std::to_string(version));
+    }
+
+    for (auto section = reader.Next(); section != "end"; section = reader.Next())
+    {
+        if (section == "scaler")
+        {
+            const auto n = reader.Next<std::size_t>();
+            std::vector<double> mean;
+            std::vector<double> scale;
+            reader.Fill(mean, n);
+            reader.Fill(scale, n);
+            SetScaler(std::move(mean), std::move(scale));
+        }
+        else if (section == "dense")
+        {
+            Layer layer;
+            layer.nInputs = reader.Next<std::size_t>();
+            layer.nOutputs = reader.Next<std::size_t>();
+            layer.activation = ParseActivation(reader.Next());
+            reader.Fill(layer.weights, layer.nInputs * layer.nOutputs);
+            reader.Fill(layer.bias, layer.nOutputs);
+            AddLayer(std::move(layer));
+        }
+        else if (section == "reference")
+        {
+            if (IsEmpty())
+            {
+                throw std::runtime_error("R3BNeulandDenseModel: Reference samples must follow the layers");
+            }
+            const auto nSamples = reader.Next<std::size_t>();
+            fReferenceTolerance = reader.Next<double>();
+            fReferenceInputs.resize(nSamples * GetNInputs());
+            fReferenceOutputs.resize(nSamples * GetNOutputs());
+            for (std::size_t s = 0; s < nSamples; s++)
+            {
+                for (std::size_t i = 0; i < GetNInputs(); i++)
+                {
+                    fReferenceInputs[s * GetNInputs() + i] = reader.Next<double>();
+                }
+                for (std::size_t j = 0; j < GetNOutputs(); j++)
+                {
+                    fReferenceOutputs[s * GetNOutputs() + j] = reader.Next<double>();
+                }
+            }
+        }
+        else
+        {
+            throw std::runtime_error("R3BNeulandDenseModel: Unknown section '" + section + "' in model file");
+        }
+    }
+
+    if (IsEmpty())
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Model file contains no layers");
+    }
+    CheckReference();
+}
+
+void R3BNeulandDenseModel::SetScaler(std::vector<double> mean, std::vector<double> scale)
+{
+    if (mean.size() != scale.size() || (!IsEmpty() && mean.size() != GetNInputs()))
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Scaler does not match the number of inputs");
+    }
+    if (std::find(scale.cbegin(), scale.cend(), 0.) != scale.cend())
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Scaler with zero scale");
+    }
+    fMean = std::move(mean);
+    fScale = std::move(scale);
+}
+
+void R3BNeulandDenseModel::AddLayer(Layer layer)
+{
+    if (layer.nInputs == 0 || layer.nOutputs == 0 || layer.weights.size() != layer.nInputs * layer.nOutputs ||
+        layer.bias.size() != layer.nOutputs)
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Inconsistent layer dimensions");
+    }
+    const auto nInputs = IsEmpty() ? fMean.size() : GetNOutputs();
+    if (nInputs != 0 && nInputs != layer.nInputs)
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Layer with " + std::to_string(layer.nInputs) +
+                                 " inputs does not fit " + std::to_string(nInputs) + " outputs of the previous step");
+    }
+    fLayers.push_back(std::move(layer));
+}
+
+void R3BNeulandDenseModel::Clear()
+{
+    fMean.clear();
+    fScale.clear();
+    fLayers.clear();
+    fReferenceInputs.clear();
+    fReferenceOutputs.clear();
+    fReferenceTolerance = 0.;
+}
+
+void R3BNeulandDenseModel::Predict(const double* inputs, std::size_t nSamples, double* outputs) const
+{
+    if (IsEmpty())
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Predict called without a model");
+    }
+
+    const auto nInputs = GetNInputs();
+    std::vector<double> current(inputs, inputs + nSamples * nInputs);
+    if (!fMean.empty())
+    {
+        for (std::size_t s = 0; s < nSamples; s++)
+        {
+            auto* x = current.data() + s * nInputs;
+            for (std::size_t i = 0; i < nInputs; i++)
+            {
+                x[i] = (x[i] - fMean[i]) / fScale[i];
+            }
+        }
+    }
+
+    std::vector<double> next;
+    for (const auto& layer : fLayers)
+    {
+        next.resize(nSamples * layer.nOutputs);
+        for (std::size_t s = 0; s < nSamples; s++)
+        {
+            const auto* x = current.data() + s * layer.nInputs;
+            auto* y = next.data() + s * layer.nOutputs;
+            std::copy(layer.bias.cbegin(), layer.bias.cend(), y);
+            for (std::size_t i = 0; i < layer.nInputs; i++)
+            {
+                const auto xi = x[i];
+                const auto* w = layer.weights.data() + i * layer.nOutputs;
+                for (std::size_t j = 0; j < layer.nOutputs; j++)
+                {
+                    y[j] += xi * w[j];
+                }
+            }
+            Activate(layer.activation, y, layer.nOutputs);
+        }
+        std::swap(current, next);
+    }
+
+    std::copy(current.cbegin(), current.cend(), outputs);
+}
+
+std::vector<double> R3BNeulandDenseModel::Predict(const std::vector<double>& inputs) const
+{
+    if (IsEmpty() || inputs.size() % GetNInputs() != 0)
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Input size does not match the model");
+    }
+    const auto nSamples = inputs.size() / GetNInputs();
+    std::vector<double> outputs(nSamples * GetNOutputs());
+    Predict(inputs.data(), nSamples, outputs.data());
+    return outputs;
+}
+
+std::size_t R3BNeulandDenseModel::GetNReferenceSamples() const
+{
+    return IsEmpty() ? 0 : fReferenceInputs.size() / GetNInputs();
+}
+
+double R3BNeulandDenseModel::GetReferenceDeviation() const
+{
+    if (GetNReferenceSamples() == 0)
+    {
+        return 0.;
+    }
+    const auto outputs = Predict(fReferenceInputs);
+    double deviation = 0.;
+    for (std::size_t k = 0; k < outputs.size(); k++)
+    {
+        deviation = std::max(deviation, std::abs(outputs[k] - fReferenceOutputs[k]));
+    }
+    return deviation;
+}
+
+void R3BNeulandDenseModel::CheckReference() const
+{
+    const auto deviation = GetReferenceDeviation();
+    if (!(deviation <= fReferenceTolerance))
+    {
+        throw std::runtime_error("R3BNeulandDenseModel: Model output deviates from the reference samples by " +
+                                 std::to_string(deviation) + " (tolerance " + std::to_string(fReferenceTolerance) +
+                                 ")");
+    }
+}
+
+R3BNeulandDenseModel::Activation R3BNeulandDenseModel::ParseActivation(const std::string& name)
+{
+    if (name == "linear" || name == "identity")
+    {
+        return Activation::linear;
+    }
+    if (name == "relu")
+    {
+        return Activation::relu;
+    }
+    if (name == "sigmoid" || name == "logistic")
+    {
+        return Activation::sigmoid;
+    }
+    if (name == "tanh")
+    {
+        return Activation::tanh;
+    }
+    if (name == "softmax")
+    {
+        return Activation::softmax;
+    }
+    throw std::runtime_error("R3BNeulandDenseModel: Unsupported activation " + name);
+}
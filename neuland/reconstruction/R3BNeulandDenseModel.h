@@ -0,0 +1,94 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BNEULANDDENSEMODEL_H
+#define R3BNEULANDDENSEMODEL_H
+
+/** Neuland Dense Model
+ * Feed-forward neural network (standard scaler + dense layers) evaluated in C++.
+ *
+ * The weights are exported from a trained Keras model or scikit-learn MLPClassifier with
+ * export_dense_model.py. The exported file can carry reference samples with the output of the
+ * Python model, which are checked when the file is loaded.
+ *
+ * Predict() scores a whole batch of samples (e.g. all clusters of an event) layer by layer, so the
+ * inner loops run over contiguous weight rows and can be vectorized by the compiler. It does not
+ * modify the model and may be called concurrently.
+ */
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+class R3BNeulandDenseModel
+{
+  public:
+    enum class Activation
+    {
+        linear,
+        relu,
+        sigmoid,
+        tanh,
+        softmax
+    };
+
+    struct Layer
+    {
+        std::size_t nInputs = 0;
+        std::size_t nOutputs = 0;
+        Activation activation = Activation::linear;
+        std::vector<double> weights; // nInputs x nOutputs, row-major (Keras kernel layout)
+        std::vector<double> bias;    // nOutputs
+    };
+
+    R3BNeulandDenseModel() = default;
+    explicit R3BNeulandDenseModel(const std::string& filename) { Load(filename); }
+
+    void Load(const std::string& filename);
+    void Load(std::istream& input);
+
+    // x -> (x - mean) / scale for each input before the first layer
+    void SetScaler(std::vector<double> mean, std::vector<double> scale);
+    void AddLayer(Layer layer);
+    void Clear();
+
+    bool IsEmpty() const { return fLayers.empty(); }
+    std::size_t GetNInputs() const { return fLayers.empty() ? 0 : fLayers.front().nInputs; }
+    std::size_t GetNOutputs() const { return fLayers.empty() ? 0 : fLayers.back().nOutputs; }
+    const std::vector<Layer>& GetLayers() const { return fLayers; }
+
+    // inputs: nSamples x GetNInputs(), outputs: nSamples x GetNOutputs(), both row-major
+    void Predict(const double* inputs, std::size_t nSamples, double* outputs) const;
+    std::vector<double> Predict(const std::vector<double>& inputs) const;
+
+    // Largest absolute deviation from the reference samples stored in the model file
+    double GetReferenceDeviation() const;
+    std::size_t GetNReferenceSamples() const;
+
+    static Activation ParseActivation(const std::string& name);
+
+  private:
+    std::vector<double> fMean;
+    std::vector<double> fScale;
+    std::vector<Layer> fLayers;
+
+    std::vector<double> fReferenceInputs;
+    std::vector<double> fReferenceOutputs;
+    double fReferenceTolerance = 0.;
+
+    void CheckReference() const;
+};
+
+#endif // R3BNEULANDDENSEMODEL_H
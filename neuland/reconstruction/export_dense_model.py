@@ -0,0 +1,119 @@
+#! /usr/bin/env python3
+# Export a trained NeuLAND model for R3BNeulandDenseModel, i.e. for R3BNeulandNeutronsDense and
+# R3BNeulandMultiplicityDense, which evaluate it in C++ without a Python interpreter.
+#
+# Keras model + joblib StandardScaler (as used by R3BNeulandNeutronsKeras):
+#   export_dense_model.py --keras model.h5 --scaler scaler.joblib -o neutrons.dense
+# scikit-learn MLPClassifier, optionally in a Pipeline after a StandardScaler (R3BNeulandMultiplicityScikit):
+#   export_dense_model.py --sklearn model.joblib -o multiplicity.dense
+#
+# The outputs of the Python model for a set of reference inputs are written to the file as well and
+# are compared with the C++ evaluation whenever the model is loaded. Reference inputs are read from a
+# CSV file (--reference, one sample per row, raw unscaled features) or sampled around the scaler mean.
+
+import argparse
+import sys
+
+import numpy as np
+
+
+def keras_layers(model):
+    layers = []
+    for layer in model.layers:
+        kind = type(layer).__name__
+        if kind in ("InputLayer", "Dropout"):
+            continue
+        if kind != "Dense":
+            sys.exit(f"export_dense_model.py: Unsupported Keras layer {kind}")
+        kernel, bias = layer.get_weights()
+        layers.append((kernel, bias, layer.activation.__name__))
+    return layers
+
+
+def sklearn_layers(mlp):
+    if mlp.out_activation_ not in ("logistic", "softmax", "identity"):
+        sys.exit(f"export_dense_model.py: Unsupported output activation {mlp.out_activation_}")
+    n = len(mlp.coefs_)
+    layers = [
+        (mlp.coefs_[i], mlp.intercepts_[i], mlp.activation if i < n - 1 else mlp.out_activation_) for i in range(n)
+    ]
+    if mlp.out_activation_ == "logistic" and mlp.coefs_[-1].shape[1] == 1:
+        # predict_proba returns [1 - p, p]: softmax over the logits [0, z] gives the same
+        kernel, bias, _ = layers[-1]
+        layers[-1] = (np.hstack([np.zeros_like(kernel), kernel]), np.concatenate([[0.0], bias]), "softmax")
+    return layers
+
+
+def write_model(filename, mean, scale, layers, inputs, outputs, tolerance):
+    def row(values):
+        return " ".join(repr(float(v)) for v in np.ravel(values))
+
+    with open(filename, "w") as f:
+        f.write("R3BNeulandDenseModel 1\n")
+        if mean is not None:
+            f.write(f"scaler {len(mean)}\n{row(mean)}\n{row(scale)}\n")
+        for kernel, bias, activation in layers:
+            f.write(f"dense {kernel.shape[0]} {kernel.shape[1]} {activation}\n")
+            for weights in kernel:
+                f.write(row(weights) + "\n")
+            f.write(row(bias) + "\n")
+        f.write(f"reference {len(inputs)} {tolerance!r}\n")
+        for x, y in zip(inputs, outputs):
+            f.write(f"{row(x)} {row(y)}\n")
+        f.write("end\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Export a NeuLAND model for R3BNeulandDenseModel")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--keras", help="Keras model file")
+    source.add_argument("--sklearn", help="joblib file with an MLPClassifier or a Pipeline ending in one")
+    parser.add_argument("--scaler", help="joblib file with the StandardScaler of the Keras model")
+    parser.add_argument("--reference", help="CSV file with reference inputs")
+    parser.add_argument("--samples", type=int, default=100, help="number of generated reference inputs")
+    parser.add_argument("--tolerance", type=float, default=1e-4, help="allowed deviation of the C++ outputs")
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    import joblib
+
+    scaler = joblib.load(args.scaler) if args.scaler else None
+    if args.keras:
+        from tensorflow import keras
+
+        model = keras.models.load_model(args.keras)
+        layers = keras_layers(model)
+        predict = lambda x: model.predict(scaler.transform(x) if scaler else x, verbose=0)
+    else:
+        model = joblib.load(args.sklearn)
+        mlp = model
+        if hasattr(model, "steps"):
+            first = type(model.steps[0][1]).__name__
+            if len(model.steps) > 2 or (len(model.steps) == 2 and first != "StandardScaler"):
+                sys.exit("export_dense_model.py: Only Pipeline(StandardScaler, MLPClassifier) is supported")
+            scaler = model.steps[0][1] if len(model.steps) == 2 else None
+            mlp = model.steps[-1][1]
+        if type(mlp).__name__ != "MLPClassifier":
+            sys.exit(f"export_dense_model.py: Unsupported model {type(mlp).__name__}, only MLPClassifier")
+        layers = sklearn_layers(mlp)
+        predict = model.predict_proba
+
+    n_inputs = layers[0][0].shape[0]
+    mean = scaler.mean_ if scaler is not None else None
+    scale = scaler.scale_ if scaler is not None else None
+
+    if args.reference:
+        inputs = np.loadtxt(args.reference, delimiter=",", ndmin=2)
+    else:
+        rng = np.random.default_rng(42)
+        center = mean if mean is not None else np.zeros(n_inputs)
+        width = scale if scale is not None else np.ones(n_inputs)
+        inputs = center + width * rng.standard_normal((args.samples, n_inputs))
+    outputs = np.asarray(predict(inputs), dtype=np.float64)
+
+    write_model(args.output, mean, scale, layers, inputs, outputs, args.tolerance)
+    print(f"export_dense_model.py: Wrote {len(layers)} layers and {len(inputs)} reference samples to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
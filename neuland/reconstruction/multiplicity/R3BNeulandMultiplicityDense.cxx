@@ -0,0 +1,107 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BNeulandMultiplicityDense.h"
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include <array>
+#include <numeric>
+#include <string>
+#include <utility>
+
+R3BNeulandMultiplicityDense::R3BNeulandMultiplicityDense(TString model, TString input, TString output)
+    : FairTask("R3BNeulandMultiplicityDense")
+    , fModelFile(std::move(model))
+    , fFirstMultiplicity(1)
+    , fClusters(std::move(input))
+    , fMultiplicity(new R3BNeulandMultiplicity())
+    , fOutputName(std::move(output))
+{
+}
+
+R3BNeulandMultiplicityDense::~R3BNeulandMultiplicityDense() { delete fMultiplicity; }
+
+InitStatus R3BNeulandMultiplicityDense::Init()
+{
+    try
+    {
+        fModel.Load(fModelFile.Data());
+    }
+    catch (const std::exception& e)
+    {
+        LOG(fatal) << e.what();
+        return kFATAL;
+    }
+    if (fModel.GetNInputs() != NFeatures || fFirstMultiplicity < 0 ||
+        static_cast<std::size_t>(fFirstMultiplicity) + fModel.GetNOutputs() > NEULAND_MAX_MULT)
+    {
+        LOG(fatal) << "R3BNeulandMultiplicityDense: Model " << fModelFile << " with " << fModel.GetNInputs()
+                   << " inputs and " << fModel.GetNOutputs() << " outputs does not fit " << NFeatures
+                   << " features and multiplicities " << fFirstMultiplicity << " to " << NEULAND_MAX_MULT - 1;
+        return kFATAL;
+    }
+    LOG(info) << "R3BNeulandMultiplicityDense: Loaded " << fModelFile << " with " << fModel.GetLayers().size()
+              << " layers, reference deviation " << fModel.GetReferenceDeviation() << " on "
+              << fModel.GetNReferenceSamples() << " samples";
+
+    // Input
+    fClusters.Init();
+
+    // Output
+    auto ioman = FairRootManager::Instance();
+    if (ioman == nullptr)
+    {
+        LOG(fatal) << "R3BNeulandMultiplicityDense: No FairRootManager";
+        return kFATAL;
+    }
+    ioman->RegisterAny(fOutputName, fMultiplicity, true);
+
+    return kSUCCESS;
+}
+
+void R3BNeulandMultiplicityDense::Exec(Option_t*)
+{
+    fMultiplicity->m.fill(0.);
+    const auto clusters = fClusters.Retrieve();
+    const int nClusters = clusters.size();
+
+    if (nClusters == 0)
+    {
+        LOG(debug) << "R3BNeulandMultiplicityDense::Exec 0 Clusters -> Mult 0";
+        fMultiplicity->m[0] = 1.;
+        return;
+    }
+
+    const int nHits = std::accumulate(
+        clusters.cbegin(), clusters.cend(), 0, [](size_t s, const R3BNeulandCluster* c) { return s + c->GetSize(); });
+    const int Edep = (int)std::accumulate(
+        clusters.cbegin(), clusters.cend(), 0., [](Double_t s, const R3BNeulandCluster* c) { return s + c->GetE(); });
+
+    // Same (integer) features as passed to the scikit-learn model
+    const std::array<double, NFeatures> features = { static_cast<double>(nHits),
+                                                     static_cast<double>(nClusters),
+                                                     static_cast<double>(Edep) };
+    fModel.Predict(features.data(), 1, fMultiplicity->m.data() + fFirstMultiplicity);
+
+    if (FairLogger::GetLogger()->IsLogNeeded(fair::Severity::debug))
+    {
+        LOG(debug) << "R3BNeulandMultiplicityDense::Exec "
+                   << std::accumulate(fMultiplicity->m.cbegin(),
+                                      fMultiplicity->m.cend(),
+                                      std::string(),
+                                      [](std::string a, double b) { return std::move(a) + ", " + std::to_string(b); });
+    }
+}
+
+ClassImp(R3BNeulandMultiplicityDense)
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BROOT_R3BNEULANDMULTIPLICITYDENSE_H
+#define R3BROOT_R3BNEULANDMULTIPLICITYDENSE_H
+
+/** Neuland multiplicity from a dense neural network evaluated in C++.
+ * Drop-in replacement for R3BNeulandMultiplicityScikit without the Python interpreter: the scikit-learn
+ * MLPClassifier is exported with export_dense_model.py.
+ */
+
+#include "FairTask.h"
+#include "R3BNeulandCluster.h"
+#include "R3BNeulandDenseModel.h"
+#include "R3BNeulandMultiplicity.h"
+#include "TCAConnector.h"
+
+class R3BNeulandMultiplicityDense : public FairTask
+{
+  public:
+    static constexpr std::size_t NFeatures = 3;
+
+    R3BNeulandMultiplicityDense(TString model,
+                                TString inputCluster = "NeulandClusters",
+                                TString output = "NeulandMultiplicity");
+    ~R3BNeulandMultiplicityDense() override;
+
+    void Exec(Option_t*) override;
+
+    // Multiplicity of the first model output. The models trained so far have no case "0" -> 1
+    void SetFirstMultiplicity(int m) { fFirstMultiplicity = m; }
+
+  protected:
+    InitStatus Init() override;
+
+  private:
+    const TString fModelFile;
+    R3BNeulandDenseModel fModel; //!
+    int fFirstMultiplicity;
+
+    TCAInputConnector<R3BNeulandCluster> fClusters;
+    R3BNeulandMultiplicity* fMultiplicity;
+    TString fOutputName;
+
+    ClassDefOverride(R3BNeulandMultiplicityDense, 0)
+};
+
+#endif // R3BROOT_R3BNEULANDMULTIPLICITYDENSE_H
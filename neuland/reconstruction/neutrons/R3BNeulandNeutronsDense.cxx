@@ -0,0 +1,142 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BNeulandNeutronsDense.h"
+#include "FairLogger.h"
+#include "FairRootManager.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+R3BNeulandNeutronsDense::R3BNeulandNeutronsDense(TString model, TString inputMult, TString inputCluster, TString output)
+    : FairTask("R3BNeulandNeutronsDense")
+    , fModelFile(std::move(model))
+    , fInputMult(std::move(inputMult))
+    , fMultiplicity(nullptr)
+    , fClusters(std::move(inputCluster))
+    , fNeutrons(std::move(output))
+    , fMinProb(0.1)
+    , fOutputIndex(1)
+{
+}
+
+InitStatus R3BNeulandNeutronsDense::Init()
+{
+    auto ioman = FairRootManager::Instance();
+    if (ioman == nullptr)
+    {
+        LOG(fatal) << "R3BNeulandNeutronsDense: No FairRootManager";
+        return kFATAL;
+    }
+
+    try
+    {
+        fModel.Load(fModelFile.Data());
+    }
+    catch (const std::exception& e)
+    {
+        LOG(fatal) << e.what();
+        return kFATAL;
+    }
+    if (fModel.GetNInputs() != NFeatures || fModel.GetNOutputs() <= fOutputIndex)
+    {
+        LOG(fatal) << "R3BNeulandNeutronsDense: Model " << fModelFile << " with " << fModel.GetNInputs()
+                   << " inputs and " << fModel.GetNOutputs() << " outputs does not fit " << NFeatures
+                   << " features and output index " << fOutputIndex;
+        return kFATAL;
+    }
+    LOG(info) << "R3BNeulandNeutronsDense: Loaded " << fModelFile << " with " << fModel.GetLayers().size()
+              << " layers, reference deviation " << fModel.GetReferenceDeviation() << " on "
+              << fModel.GetNReferenceSamples() << " samples";
+
+    fMultiplicity = ioman->InitObjectAs<const R3BNeulandMultiplicity*>(fInputMult);
+    if (fMultiplicity == nullptr)
+    {
+        throw std::runtime_error(("R3BNeulandNeutronsDense: R3BNeulandMultiplicity " + fInputMult +
+                                  " could not be provided by the FairRootManager")
+                                     .Data());
+    }
+
+    fClusters.Init();
+    fNeutrons.Init();
+    return kSUCCESS;
+}
+
+void R3BNeulandNeutronsDense::GetFeatures(const R3BNeulandCluster& cluster, double* features)
+{
+    const auto position = cluster.GetPosition();
+    features[0] = cluster.GetT();
+    features[1] = cluster.GetE();
+    features[2] = cluster.GetSize();
+    features[3] = cluster.GetEToF();
+    features[4] = cluster.GetEnergyMoment();
+    features[5] = cluster.GetLastHit().GetT() - cluster.GetFirstHit().GetT();
+    features[6] = cluster.GetMaxEnergyHit().GetE();
+    features[7] = position.X();
+    features[8] = position.Y();
+    features[9] = position.Z();
+}
+
+void R3BNeulandNeutronsDense::Exec(Option_t*)
+{
+    fNeutrons.Reset();
+
+    const auto clusters = fClusters.Retrieve();
+    const auto nClusters = clusters.size();
+    if (nClusters == 0)
+    {
+        return;
+    }
+
+    // Score all clusters of the event at once
+    fFeatures.resize(nClusters * NFeatures);
+    for (size_t i = 0; i < nClusters; i++)
+    {
+        GetFeatures(*clusters[i], &fFeatures[i * NFeatures]);
+    }
+    fScores.resize(nClusters * fModel.GetNOutputs());
+    fModel.Predict(fFeatures.data(), nClusters, fScores.data());
+
+    std::vector<ClusterWithProba> cwps;
+    cwps.reserve(nClusters);
+    for (size_t i = 0; i < nClusters; i++)
+    {
+        cwps.push_back(ClusterWithProba{ clusters[i], fScores[i * fModel.GetNOutputs() + fOutputIndex] });
+    }
+
+    // Sort scored clusters, high probability first
+    std::sort(cwps.begin(), cwps.end(), std::greater<ClusterWithProba>());
+
+    if (FairLogger::GetLogger()->IsLogNeeded(fair::Severity::debug))
+    {
+        LOG(debug) << "R3BNeulandNeutronsDense::Exec";
+        for (const auto& cwp : cwps)
+        {
+            LOG(debug) << cwp.c->GetPosition().X() << "\t" << cwp.p << "\t";
+        }
+    }
+
+    // With the multiplicity from somewhere else, take the n clusters with the highest prob as neutrons
+    const auto mult = fMultiplicity->GetMultiplicity();
+    for (size_t n = 0; n < cwps.size() && n < mult; n++)
+    {
+        if (cwps.at(n).p > fMinProb)
+        {
+            fNeutrons.Insert(R3BNeulandNeutron(*(cwps.at(n).c)));
+        }
+    }
+}
+
+ClassImp(R3BNeulandNeutronsDense)
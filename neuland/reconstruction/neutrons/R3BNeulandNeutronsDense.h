@@ -0,0 +1,79 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BROOT_R3BNEULANDNEUTRONSDENSE_H
+#define R3BROOT_R3BNEULANDNEUTRONSDENSE_H
+
+/** Neuland neutron cluster selection with a dense neural network evaluated in C++.
+ * Drop-in replacement for R3BNeulandNeutronsKeras without the Python interpreter: the Keras model and
+ * scaler are exported with export_dense_model.py. All clusters of an event are scored in one call.
+ */
+
+#include "FairTask.h"
+#include "R3BNeulandCluster.h"
+#include "R3BNeulandDenseModel.h"
+#include "R3BNeulandMultiplicity.h"
+#include "R3BNeulandNeutron.h"
+#include "TCAConnector.h"
+#include <vector>
+
+class R3BNeulandNeutronsDense : public FairTask
+{
+  public:
+    static constexpr std::size_t NFeatures = 10;
+
+    R3BNeulandNeutronsDense(TString model,
+                            TString inputMult = "NeulandMultiplicity",
+                            TString inputCluster = "NeulandClusters",
+                            TString output = "NeulandNeutrons");
+    ~R3BNeulandNeutronsDense() override = default;
+    void Exec(Option_t*) override;
+
+    void SetMinProb(double p) { fMinProb = p; }
+    // Column of the model output used as neutron probability, [:, 1] for the Keras models
+    void SetOutputIndex(std::size_t i) { fOutputIndex = i; }
+
+    // Same features, in the same order, as used for training the Keras models
+    static void GetFeatures(const R3BNeulandCluster& cluster, double* features);
+
+  protected:
+    InitStatus Init() override;
+
+  private:
+    const TString fModelFile;
+    R3BNeulandDenseModel fModel; //!
+
+    const TString fInputMult;                    //!
+    const R3BNeulandMultiplicity* fMultiplicity; //!
+
+    TCAInputConnector<R3BNeulandCluster> fClusters;  //!
+    TCAOutputConnector<R3BNeulandNeutron> fNeutrons; //!
+    double fMinProb;
+    std::size_t fOutputIndex;
+
+    std::vector<double> fFeatures; //!
+    std::vector<double> fScores;   //!
+
+    struct ClusterWithProba
+    {
+        R3BNeulandCluster* c;
+        double p;
+
+        bool operator>(const ClusterWithProba& o) const { return this->p > o.p; }
+    };
+
+    ClassDefOverride(R3BNeulandNeutronsDense, 0)
+};
+
+#endif // R3BROOT_R3BNEULANDNEUTRONSDENSE_H
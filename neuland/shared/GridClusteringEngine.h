@@ -0,0 +1,256 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef NEULANDGRIDCLUSTERINGENGINEH
+#define NEULANDGRIDCLUSTERINGENGINEH
+
+#include "ClusteringEngine.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Neuland
+{
+
+    /* Clustering engine with the same result as ClusteringEngine, but which only tests candidates from neighbouring
+     * grid cells instead of all unclustered objects.
+     * In addition to the clustering condition, it requires a key function that maps each object to an integer cell in
+     * NDim dimensions (e.g. plane, bar and time bucket). The key function must be chosen such that two objects which
+     * satisfy the clustering condition are never more than one cell apart in any dimension. For a condition of the
+     * form |a - b| < d this is fulfilled by the cell floor(a / d).
+     * Clusters are built by a breadth-first search starting from the first unclustered object, where the condition is
+     * evaluated as f(member, candidate) like in ClusteringEngine. For symmetric conditions, both engines find the same
+     * clusters (connected components); only the order within and of the clusters may differ.
+     * For a fixed density of objects per cell, the number of evaluations of the condition grows linearly with n
+     * instead of quadratically as for ClusteringEngine. */
+    template <typename T, std::size_t NDim = 3>
+    class GridClusteringEngine
+    {
+        static_assert(NDim > 0, "GridClusteringEngine requires at least one key dimension");
+
+      public:
+        using Key = std::array<int, NDim>;
+        using BinaryPredicate = std::function<bool(const T&, const T&)>;
+        using KeyFunction = std::function<Key(const T&)>;
+
+      private:
+        BinaryPredicate f;
+        KeyFunction key;
+        /* Below this number of objects, the bookkeeping of the cells costs more than testing all pairs. For NeuLAND
+         * showers with the cells of R3BNeulandClusterFinder, both take the same time at 150 to 200 hits
+         * (clusteringBench); the grid only pays off for larger multiplicities. */
+        std::size_t min_grid_size = 200;
+        ClusteringEngine<T> pairwise_engine;
+
+        /* The unclustered objects of one cell are the range [begin, end) of the objects sorted by their key.
+         * Clustered objects are swapped to the front of the range and begin is moved past them. */
+        struct Cell
+        {
+            Key key;
+            std::size_t begin;
+            std::size_t end;
+            std::size_t neighbours_begin; // range in the list of neighbour cells, filled on first use
+            std::size_t neighbours_end;
+            bool has_neighbours;
+        };
+
+        // All combinations of -1, 0 and +1 in the dimensions except the last one
+        static std::vector<Key> make_prefix_offsets()
+        {
+            std::vector<Key> offsets;
+            std::size_t n_offsets = 1;
+            for (std::size_t dim = 0; dim + 1 < NDim; dim++)
+            {
+                n_offsets *= 3;
+            }
+            for (std::size_t i = 0; i < n_offsets; i++)
+            {
+                Key offset{};
+                auto rest = i;
+                for (std::size_t dim = 0; dim + 1 < NDim; dim++)
+                {
+                    offset[dim] = static_cast<int>(rest % 3) - 1;
+                    rest /= 3;
+                }
+                offsets.push_back(offset);
+            }
+            return offsets;
+        }
+        std::vector<Key> prefix_offsets = make_prefix_offsets();
+
+        /* Appends the indices of all cells whose keys differ by at most one from center in every dimension. As the
+         * cells are sorted by key, the neighbours which share the components except the last one are a contiguous
+         * range, which is found with one binary search. */
+        void find_neighbours(const Key& center, const std::vector<Cell>& cells, std::vector<std::size_t>& out) const
+        {
+            constexpr auto last_dim = NDim - 1;
+            for (const auto& offset : prefix_offsets)
+            {
+                Key lower;
+                for (std::size_t dim = 0; dim < last_dim; dim++)
+                {
+                    lower[dim] = center[dim] + offset[dim];
+                }
+                lower[last_dim] = center[last_dim] - 1;
+                auto it = std::lower_bound(
+                    cells.cbegin(), cells.cend(), lower, [](const Cell& cell, const Key& k) { return cell.key < k; });
+                for (; it != cells.cend(); it++)
+                {
+                    if (!std::equal(lower.cbegin(), lower.cbegin() + last_dim, it->key.cbegin()) ||
+                        it->key[last_dim] > center[last_dim] + 1)
+                    {
+                        break;
+                    }
+                    out.push_back(static_cast<std::size_t>(it - cells.cbegin()));
+                }
+            }
+        }
+
+      public:
+        /* As for ClusteringEngine, a "bad_function_call" will be thrown upon calling clusterize if the clustering
+         * condition or the key function is not set. */
+        GridClusteringEngine() = default;
+        GridClusteringEngine(const BinaryPredicate& _f, const KeyFunction& _key)
+            : f(_f)
+            , key(_key)
+            , pairwise_engine(_f)
+        {
+        }
+
+        void SetClusteringCondition(const BinaryPredicate& _f)
+        {
+            f = _f;
+            pairwise_engine.SetClusteringCondition(_f);
+        }
+        void SetKeyFunction(const KeyFunction& _key) { key = _key; }
+
+        /* Inputs with less objects are clustered by ClusteringEngine, which tests all pairs. The clusters are the same
+         * in both cases. */
+        void SetMinGridSize(std::size_t size) { min_grid_size = size; }
+
+        bool SatisfiesClusteringCondition(const T& a, const T& b) const { return f(a, b); }
+
+        std::vector<std::vector<T>> Clusterize(std::vector<T>& from) const
+        {
+            if (from.size() < min_grid_size)
+            {
+                return pairwise_engine.Clusterize(from);
+            }
+
+            const std::size_t n = from.size();
+            // Group the objects by cell, cells sorted by key and objects in input order within a cell
+            std::vector<std::pair<Key, std::size_t>> entries(n);
+            for (std::size_t i = 0; i < n; i++)
+            {
+                entries[i] = { key(from[i]), i };
+            }
+            std::sort(entries.begin(), entries.end());
+
+            std::vector<Cell> cells;
+            cells.reserve(n);
+            std::vector<std::size_t> sorted(n);
+            std::vector<std::size_t> cell_of(n);
+            std::vector<std::size_t> position(n); // position of each object in sorted
+            for (std::size_t i = 0; i < n; i++)
+            {
+                const auto& [cell_key, idx] = entries[i];
+                if (cells.empty() || !(cells.back().key == cell_key))
+                {
+                    cells.push_back(Cell{ cell_key, i, i, 0, 0, false });
+                }
+                cells.back().end = i + 1;
+                sorted[i] = idx;
+                cell_of[idx] = cells.size() - 1;
+                position[idx] = i;
+            }
+
+            // Non-empty neighbour cells (including the cell itself) are searched once per cell
+            std::vector<std::size_t> neighbours;
+            neighbours.reserve(2 * cells.size());
+            const auto get_neighbours = [&](const std::size_t c) -> Cell&
+            {
+                auto& cell = cells[c];
+                if (!cell.has_neighbours)
+                {
+                    cell.neighbours_begin = neighbours.size();
+                    find_neighbours(cell.key, cells, neighbours);
+                    cell.neighbours_end = neighbours.size();
+                    cell.has_neighbours = true;
+                }
+                return cell;
+            };
+
+            std::vector<std::vector<T>> out;
+            std::vector<std::size_t> members;
+            members.reserve(n);
+            const auto add_member = [&](const std::size_t idx)
+            {
+                auto& cell = cells[cell_of[idx]];
+                const auto front = sorted[cell.begin];
+                std::swap(sorted[position[idx]], sorted[cell.begin]);
+                std::swap(position[idx], position[front]);
+                cell.begin++;
+                members.push_back(idx);
+            };
+            const auto is_clustered = [&](const std::size_t idx)
+            { return position[idx] < cells[cell_of[idx]].begin; };
+
+            for (std::size_t seed = 0; seed < n; seed++)
+            {
+                if (is_clustered(seed))
+                {
+                    continue;
+                }
+
+                // Breadth-first search: members grows while it is iterated over, such that new members are seeds as
+                // well
+                members.clear();
+                add_member(seed);
+                for (std::size_t m = 0; m < members.size(); m++)
+                {
+                    const T& a = from[members[m]];
+                    const auto& cell = get_neighbours(cell_of[members[m]]);
+                    for (auto nb = cell.neighbours_begin; nb < cell.neighbours_end; nb++)
+                    {
+                        const auto& neighbour = cells[neighbours[nb]];
+                        // add_member swaps the object at begin, which was already tested, to position i
+                        for (auto i = neighbour.begin; i < neighbour.end; i++)
+                        {
+                            const auto b = sorted[i];
+                            if (f(a, from[b]))
+                            {
+                                add_member(b);
+                            }
+                        }
+                    }
+                }
+
+                std::vector<T> cluster;
+                cluster.reserve(members.size());
+                for (const auto idx : members)
+                {
+                    cluster.push_back(std::move(from[idx]));
+                }
+                out.push_back(std::move(cluster));
+            }
+            return out;
+        }
+    };
+
+}; // namespace Neuland
+
+#endif // NEULANDGRIDCLUSTERINGENGINEH
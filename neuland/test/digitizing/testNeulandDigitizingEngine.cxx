@@ -0,0 +1,159 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BDigitizingChannelMock.h"
+#include "R3BDigitizingEngine.h"
+#include "R3BDigitizingPaddleMock.h"
+#include "R3BDigitizingPaddleNeuland.h"
+#include "R3BDigitizingTamex.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace Digitizing = R3B::Digitizing;
+    using Digitizing::UseChannel;
+    using Digitizing::UsePaddle;
+    using Digitizing::Neuland::MockChannel;
+    using Digitizing::Neuland::MockPaddle;
+    using Digitizing::Neuland::NeulandPaddle;
+    using TamexChannel = Digitizing::Neuland::Tamex::Channel;
+    using TamexPar = Digitizing::Neuland::Tamex::Params;
+
+    struct Deposit
+    {
+        int paddleID;
+        double time;
+        double light;
+        double dist;
+    };
+
+    // events with deposits in a 13 double plane NeuLAND (1300 paddles)
+    auto GenerateEvents(int nEvents, int depositsPerEvent) -> std::vector<std::vector<Deposit>>
+    {
+        auto rnd = std::mt19937{ 42 }; // NOLINT
+        auto paddle = std::uniform_int_distribution<int>{ 1, 1300 };
+        auto time = std::uniform_real_distribution<double>{ 10., 200. };
+        auto light = std::exponential_distribution<double>{ 0.2 };
+        auto dist = std::uniform_real_distribution<double>{ -125., 125. };
+
+        auto events = std::vector<std::vector<Deposit>>(nEvents);
+        for (auto& event : events)
+        {
+            // hits are clustered in a few neighbouring paddles
+            for (int idx = 0; idx < depositsPerEvent; ++idx)
+            {
+                const auto center = paddle(rnd);
+                event.push_back({ std::min(1300, center + idx % 3), time(rnd), light(rnd), dist(rnd) });
+            }
+        }
+        return events;
+    }
+
+    auto GetIDs(const std::vector<Digitizing::Paddle*>& paddles) -> std::vector<int>
+    {
+        auto ids = std::vector<int>{};
+        for (const auto* paddle : paddles)
+        {
+            ids.push_back(paddle->GetPaddleID());
+        }
+        return ids;
+    }
+
+    TEST(testDigitizingEngine, paddles_are_sorted_and_reused) // NOLINT
+    {
+        auto engine = Digitizing::CreateEngine(UsePaddle<MockPaddle>(), UseChannel<MockChannel>());
+        engine->Init();
+
+        engine->DepositLight(7, 20., 10., 0.);
+        engine->DepositLight(3, 25., 10., 0.);
+        engine->DepositLight(7, 30., 10., 0.);
+        ASSERT_EQ(GetIDs(engine->GetPaddles()), (std::vector<int>{ 3, 7 }));
+        auto* paddle7 = engine->GetPaddles().back();
+        EXPECT_EQ(paddle7->GetLeftChannel()->GetPaddle(), paddle7);
+
+        engine->Reset();
+        EXPECT_TRUE(engine->GetPaddles().empty());
+        EXPECT_TRUE(std::isnan(engine->GetTriggerTime()));
+
+        engine->DepositLight(7, 40., 10., 0.);
+        ASSERT_EQ(engine->GetPaddles().size(), 1);
+        EXPECT_EQ(engine->GetPaddles().front(), paddle7) << "paddle was not reused";
+        EXPECT_EQ(engine->GetPaddles().front()->GetSignals().size(), 1) << "hits of the last event were not cleared";
+    }
+
+    TEST(testDigitizingEngine, extract_paddles_rebuilds_pool) // NOLINT
+    {
+        auto engine = Digitizing::CreateEngine(UsePaddle<MockPaddle>(), UseChannel<MockChannel>());
+        engine->Init();
+
+        engine->DepositLight(5, 20., 10., 0.);
+        auto paddles = engine->ExtractPaddles();
+        ASSERT_EQ(paddles.size(), 1);
+        EXPECT_EQ(paddles.begin()->first, 5);
+        EXPECT_TRUE(engine->GetPaddles().empty());
+
+        engine->DepositLight(5, 30., 10., 0.);
+        ASSERT_EQ(engine->GetPaddles().size(), 1);
+        EXPECT_NE(engine->GetPaddles().front(), paddles.at(5).get());
+        EXPECT_EQ(engine->GetPaddles().front()->GetSignals().size(), 1);
+    }
+
+    // The pool has to give the same paddle signals as paddles built in each event
+    TEST(testDigitizingEngine, same_signals_as_new_paddles) // NOLINT
+    {
+        auto rndPool = TRandom3{ 1 };
+        auto rndNew = TRandom3{ 1 };
+        auto parPool = TamexPar{ rndPool };
+        auto parNew = TamexPar{ rndNew };
+        auto pooled = Digitizing::CreateEngine(UsePaddle<NeulandPaddle>(), UseChannel<TamexChannel>(parPool));
+        auto rebuilt = Digitizing::CreateEngine(UsePaddle<NeulandPaddle>(), UseChannel<TamexChannel>(parNew));
+        pooled->Init();
+        rebuilt->Init();
+
+        for (const auto& event : GenerateEvents(200, 30))
+        {
+            pooled->Reset();
+            for (const auto& deposit : event)
+            {
+                pooled->DepositLight(deposit.paddleID, deposit.time, deposit.light, deposit.dist);
+                rebuilt->DepositLight(deposit.paddleID, deposit.time, deposit.light, deposit.dist);
+            }
+            ASSERT_EQ(pooled->GetTriggerTime(), rebuilt->GetTriggerTime());
+
+            const auto& pooledPaddles = pooled->GetPaddles();
+            const auto rebuiltPaddles = rebuilt->ExtractPaddles();
+            ASSERT_EQ(pooledPaddles.size(), rebuiltPaddles.size());
+            auto rebuiltIt = rebuiltPaddles.begin();
+            for (const auto* paddle : pooledPaddles)
+            {
+                ASSERT_EQ(paddle->GetPaddleID(), rebuiltIt->first);
+                ASSERT_EQ(paddle->HasFired(), rebuiltIt->second->HasFired());
+                if (paddle->HasFired())
+                {
+                    const auto& signals = paddle->GetSignals();
+                    const auto& expected = rebuiltIt->second->GetSignals();
+                    ASSERT_EQ(signals.size(), expected.size());
+                    for (size_t idx = 0; idx < signals.size(); ++idx)
+                    {
+                        EXPECT_EQ(signals[idx].energy, expected[idx].energy);
+                        EXPECT_EQ(signals[idx].time, expected[idx].time);
+                        EXPECT_EQ(signals[idx].position, expected[idx].position);
+                    }
+                }
+                ++rebuiltIt;
+            }
+        }
+    }
+} // namespace
@@ -12,7 +12,11 @@
  ******************************************************************************/
 
 #include "ClusteringEngine.h"
+#include "GridClusteringEngine.h"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
 #include <stdexcept>
 #include <vector>
 
@@ -73,4 +77,139 @@ namespace
         EXPECT_FALSE(clusterer.SatisfiesClusteringCondition(1, 3));
     }
 
+    TEST(testGridClusteringEngine, basic_int_clustering)
+    {
+        auto clusterer = Neuland::GridClusteringEngine<int, 1>(
+            [](const int& a, const int& b) { return std::abs(b - a) <= 1; },
+            [](const int& a) { return std::array<int, 1>{ a / 2 }; });
+        clusterer.SetMinGridSize(0);
+
+        std::vector<int> digis{ 1, 2, 3, 7, 8, 9, 10, 12 };
+        auto clusters = clusterer.Clusterize(digis);
+
+        std::vector<std::vector<int>> expected = { { 1, 2, 3 }, { 7, 8, 9, 10 }, { 12 } };
+
+        EXPECT_EQ(clusters, expected);
+    }
+
+    TEST(testGridClusteringEngine, clustering_condition_not_set)
+    {
+        auto clusterer = Neuland::GridClusteringEngine<int, 1>();
+        clusterer.SetKeyFunction([](const int& a) { return std::array<int, 1>{ a }; });
+        std::vector<int> digis{ 1, 2, 3, 7, 8, 9, 10, 12 };
+        EXPECT_ANY_THROW(clusterer.Clusterize(digis));
+        clusterer.SetMinGridSize(0);
+        EXPECT_ANY_THROW(clusterer.Clusterize(digis));
+    }
+
+    // Hits with the clustering condition and cell size of R3BNeulandClusterFinder
+    struct DummyHit
+    {
+        int id;
+        double x;
+        double y;
+        double z;
+        double t;
+    };
+
+    constexpr double ClusterDX = 7.5;
+    constexpr double ClusterDY = 7.5;
+    constexpr double ClusterDZ = 15.;
+    constexpr double ClusterDT = 1.;
+
+    bool DummyHitCondition(const DummyHit& a, const DummyHit& b)
+    {
+        return std::abs(a.x - b.x) < ClusterDX && std::abs(a.y - b.y) < ClusterDY && std::abs(a.z - b.z) < ClusterDZ &&
+               std::abs(a.t - b.t) < ClusterDT;
+    }
+
+    // Same cells as in R3BNeulandClusterFinder: plane and time bucket
+    std::array<int, 2> DummyHitKey(const DummyHit& hit)
+    {
+        return { static_cast<int>(std::floor(hit.z / ClusterDZ)), static_cast<int>(std::floor(hit.t / ClusterDT)) };
+    }
+
+    // Several showers of neighbouring bars in a NeuLAND-like volume
+    std::vector<DummyHit> MakeEvent(std::mt19937& rng, int n_hits)
+    {
+        const int n_showers = std::max(1, n_hits / 8);
+        std::uniform_real_distribution<double> transverse(-125., 125.);
+        std::uniform_real_distribution<double> depth(0., 300.);
+        std::uniform_real_distribution<double> time(0., 15.);
+        std::normal_distribution<double> spread(0., 6.);
+        std::normal_distribution<double> time_spread(0., 0.7);
+        std::uniform_int_distribution<int> shower(0, n_showers - 1);
+
+        std::vector<DummyHit> centers;
+        for (int i = 0; i < n_showers; i++)
+        {
+            centers.push_back({ -1, transverse(rng), transverse(rng), depth(rng), time(rng) });
+        }
+        std::vector<DummyHit> hits;
+        for (int i = 0; i < n_hits; i++)
+        {
+            const auto& c = centers[shower(rng)];
+            hits.push_back({ i, c.x + spread(rng), c.y + spread(rng), c.z + 2. * spread(rng), c.t + time_spread(rng) });
+        }
+        return hits;
+    }
+
+    // Clusters as sorted lists of hit ids, sorted by their first id
+    std::vector<std::vector<int>> Normalize(const std::vector<std::vector<DummyHit>>& clusters)
+    {
+        std::vector<std::vector<int>> ids;
+        for (const auto& cluster : clusters)
+        {
+            std::vector<int> cluster_ids;
+            for (const auto& hit : cluster)
+            {
+                cluster_ids.push_back(hit.id);
+            }
+            std::sort(cluster_ids.begin(), cluster_ids.end());
+            ids.push_back(cluster_ids);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    TEST(testGridClusteringEngine, same_clusters_as_clustering_engine)
+    {
+        auto engine = Neuland::ClusteringEngine<DummyHit>(DummyHitCondition);
+        auto grid_engine = Neuland::GridClusteringEngine<DummyHit, 2>(DummyHitCondition, DummyHitKey);
+        grid_engine.SetMinGridSize(0);
+
+        std::mt19937 rng(4242);
+        for (int event = 0; event < 200; event++)
+        {
+            auto hits = MakeEvent(rng, 1 + event * 3);
+            auto hits_copy = hits;
+            const auto clusters = Normalize(engine.Clusterize(hits));
+            const auto grid_clusters = Normalize(grid_engine.Clusterize(hits_copy));
+            ASSERT_EQ(clusters, grid_clusters);
+        }
+    }
+
+    TEST(testGridClusteringEngine, small_events_clustered_pairwise)
+    {
+        // below the minimum grid size, even the order of the clusters is the one of ClusteringEngine
+        auto engine = Neuland::ClusteringEngine<DummyHit>(DummyHitCondition);
+        auto grid_engine = Neuland::GridClusteringEngine<DummyHit, 2>(DummyHitCondition, DummyHitKey);
+        grid_engine.SetMinGridSize(100);
+
+        std::mt19937 rng(1);
+        auto hits = MakeEvent(rng, 99);
+        auto hits_copy = hits;
+        const auto clusters = engine.Clusterize(hits);
+        const auto grid_clusters = grid_engine.Clusterize(hits_copy);
+        ASSERT_EQ(clusters.size(), grid_clusters.size());
+        for (std::size_t idx = 0; idx < clusters.size(); idx++)
+        {
+            ASSERT_EQ(clusters[idx].size(), grid_clusters[idx].size());
+            for (std::size_t hit = 0; hit < clusters[idx].size(); hit++)
+            {
+                EXPECT_EQ(clusters[idx][hit].id, grid_clusters[idx][hit].id);
+            }
+        }
+    }
+
 } // namespace
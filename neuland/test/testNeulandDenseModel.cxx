@@ -0,0 +1,179 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BNeulandDenseModel.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // 2 inputs -> 3 relu -> 2 softmax, scaler (x - 1) / 2
+    const char* const SmallModel = R"(R3BNeulandDenseModel 1
+        # comments are ignored
+        scaler 2
+        1 1
+        2 2
+        dense 2 3 relu
+        1 -1 0.5
+        2 1 -0.5
+        0 0.5 -1
+        dense 3 2 softmax
+        1 0
+        0 1
+        -1 1
+        0.1 -0.1
+    )";
+
+    std::vector<double> SmallModelReference(double x0, double x1)
+    {
+        const double s0 = (x0 - 1.) / 2.;
+        const double s1 = (x1 - 1.) / 2.;
+        const double h0 = std::max(0., s0 * 1. + s1 * 2. + 0.);
+        const double h1 = std::max(0., s0 * -1. + s1 * 1. + 0.5);
+        const double h2 = std::max(0., s0 * 0.5 + s1 * -0.5 - 1.);
+        const double z0 = h0 - h2 + 0.1;
+        const double z1 = h1 + h2 - 0.1;
+        const double e0 = std::exp(z0);
+        const double e1 = std::exp(z1);
+        return { e0 / (e0 + e1), e1 / (e0 + e1) };
+    }
+
+    R3BNeulandDenseModel LoadModel(const std::string& text)
+    {
+        std::istringstream input(text);
+        R3BNeulandDenseModel model;
+        model.Load(input);
+        return model;
+    }
+
+    TEST(testNeulandDenseModel, hand_computed_network)
+    {
+        const auto model = LoadModel(std::string(SmallModel) + "end\n");
+        ASSERT_EQ(model.GetNInputs(), 2);
+        ASSERT_EQ(model.GetNOutputs(), 2);
+
+        const std::vector<double> inputs = { 1., 1., 3., 5., -2., 4., 10., -7. };
+        const auto outputs = model.Predict(inputs);
+        ASSERT_EQ(outputs.size(), inputs.size());
+        for (size_t s = 0; s < inputs.size() / 2; s++)
+        {
+            const auto expected = SmallModelReference(inputs[2 * s], inputs[2 * s + 1]);
+            EXPECT_NEAR(outputs[2 * s], expected[0], 1e-14);
+            EXPECT_NEAR(outputs[2 * s + 1], expected[1], 1e-14);
+        }
+    }
+
+    TEST(testNeulandDenseModel, batch_equals_single_samples)
+    {
+        const auto model = LoadModel(std::string(SmallModel) + "end\n");
+        std::mt19937 rng(7);
+        std::normal_distribution<double> dist(0., 5.);
+        std::vector<double> inputs(2 * 100);
+        for (auto& x : inputs)
+        {
+            x = dist(rng);
+        }
+
+        const auto batch = model.Predict(inputs);
+        for (size_t s = 0; s < 100; s++)
+        {
+            const auto single = model.Predict({ inputs[2 * s], inputs[2 * s + 1] });
+            EXPECT_EQ(single[0], batch[2 * s]);
+            EXPECT_EQ(single[1], batch[2 * s + 1]);
+        }
+    }
+
+    TEST(testNeulandDenseModel, reference_samples)
+    {
+        const auto good = SmallModelReference(3., 5.);
+        std::ostringstream text;
+        text.precision(17);
+        text << SmallModel << "reference 1 1e-9\n3 5 " << good[0] << " " << good[1] << "\nend\n";
+        const auto model = LoadModel(text.str());
+        EXPECT_EQ(model.GetNReferenceSamples(), 1);
+        EXPECT_LT(model.GetReferenceDeviation(), 1e-12);
+
+        std::ostringstream bad;
+        bad << SmallModel << "reference 1 1e-9\n3 5 " << good[0] + 1e-3 << " " << good[1] << "\nend\n";
+        EXPECT_THROW(LoadModel(bad.str()), std::runtime_error);
+    }
+
+    TEST(testNeulandDenseModel, malformed_files)
+    {
+        EXPECT_THROW(LoadModel("R3BNeulandDenseModel 2\nend\n"), std::runtime_error);
+        EXPECT_THROW(LoadModel("R3BNeulandDenseModel 1\nend\n"), std::runtime_error);
+        EXPECT_THROW(LoadModel("R3BNeulandDenseModel 1\ndense 2 1 relu\n1 2\n"), std::runtime_error);
+        EXPECT_THROW(LoadModel("R3BNeulandDenseModel 1\ndense 2 1 swish\n1 2 0\nend\n"), std::runtime_error);
+        EXPECT_THROW(LoadModel("R3BNeulandDenseModel 1\ndense 2 1 relu\n1 x 0\nend\n"), std::runtime_error);
+        // second layer does not fit the first one
+        EXPECT_THROW(LoadModel("R3BNeulandDenseModel 1\ndense 1 2 relu\n1 1 0 0\ndense 3 1 relu\n1 1 1 0\nend\n"),
+                     std::runtime_error);
+        EXPECT_THROW(R3BNeulandDenseModel("does/not/exist.dense"), std::runtime_error);
+    }
+
+    TEST(testNeulandDenseModel, softmax_outputs_of_random_model)
+    {
+        // Size of the neutron models: 10 features -> 64 -> 64 -> 2, scoring 30 clusters per event
+        constexpr size_t nFeatures = 10;
+        constexpr size_t nHidden = 64;
+        constexpr size_t nClusters = 30;
+
+        std::mt19937 rng(1);
+        std::normal_distribution<double> dist(0., 0.3);
+        auto random_layer = [&](size_t nIn, size_t nOut, R3BNeulandDenseModel::Activation activation)
+        {
+            R3BNeulandDenseModel::Layer layer;
+            layer.nInputs = nIn;
+            layer.nOutputs = nOut;
+            layer.activation = activation;
+            layer.weights.resize(nIn * nOut);
+            layer.bias.resize(nOut);
+            for (auto& w : layer.weights)
+            {
+                w = dist(rng);
+            }
+            for (auto& b : layer.bias)
+            {
+                b = dist(rng);
+            }
+            return layer;
+        };
+
+        R3BNeulandDenseModel model;
+        model.SetScaler(std::vector<double>(nFeatures, 1.), std::vector<double>(nFeatures, 2.));
+        model.AddLayer(random_layer(nFeatures, nHidden, R3BNeulandDenseModel::Activation::relu));
+        model.AddLayer(random_layer(nHidden, nHidden, R3BNeulandDenseModel::Activation::relu));
+        model.AddLayer(random_layer(nHidden, 2, R3BNeulandDenseModel::Activation::softmax));
+        ASSERT_EQ(model.GetNInputs(), nFeatures);
+        ASSERT_EQ(model.GetNOutputs(), 2);
+
+        std::vector<double> inputs(nClusters * nFeatures);
+        for (auto& x : inputs)
+        {
+            x = dist(rng);
+        }
+        std::vector<double> outputs(nClusters * 2);
+        model.Predict(inputs.data(), nClusters, outputs.data());
+        for (size_t c = 0; c < nClusters; c++)
+        {
+            EXPECT_GE(outputs[2 * c], 0.);
+            EXPECT_GE(outputs[2 * c + 1], 0.);
+            EXPECT_NEAR(outputs[2 * c] + outputs[2 * c + 1], 1., 1e-12);
+        }
+    }
+} // namespace
@@ -26,6 +26,7 @@
 #pragma link C++ class R3BDataPropagator+;
 #pragma link C++ class R3BFileSource+;
 #pragma link C++ class R3BFileSource2+;
+#pragma link C++ class R3BColumnarWriter+;
 #pragma link C++ class R3BEventHeaderPropagator+;
 #pragma link C++ class R3BLogger+;
 #pragma link C++ class R3BTcutPar+;
@@ -35,4 +36,6 @@
 #pragma link C++ class R3BMSOffsetPar+;
 #pragma link C++ class R3BMSOffsetFinder+;
 #pragma link C++ class R3BTprevTnext+;
+#pragma link C++ class R3BProfiledTask+;
+#pragma link C++ class R3BTaskProfiler+;
 #endif
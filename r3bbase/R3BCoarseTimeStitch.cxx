@@ -19,59 +19,42 @@
 
 // Standard constructur
 R3BCoarseTimeStitch::R3BCoarseTimeStitch()
-    : fRange1(2048 * 1000. / 200.)           // ns
-    , fRange2(2048 * 1000. / 200.)           // ns
-    , fRangeTamex(2048 * 1000. / 200.)       // ns
-    , fRangeTrb(2048 * 1000. / 200.)         // ns
-    , fRangeVftx(8192 * 1000. / 200.)        // ns
-    , fRangeClockTDC(4096 * 1000. / 250.)    // ns
-    , fRangeClockTDC150(4096 * 1000. / 150.) // ns
+    : fRange1(R3B::TDC::range_ns<R3B::TDC::Tamex>)                 // ns
+    , fRange2(R3B::TDC::range_ns<R3B::TDC::Tamex>)                 // ns
+    , fRangeTamex(R3B::TDC::range_ns<R3B::TDC::Tamex>)             // ns
+    , fRangeVftx(R3B::TDC::range_ns<R3B::TDC::Vftx>)               // ns
+    , fRangeTrb(R3B::TDC::range_ns<R3B::TDC::Trb>)                 // ns
+    , fRangeClockTDC(R3B::TDC::range_ns<R3B::TDC::ClockTDC>)       // ns
+    , fRangeClockTDC150(R3B::TDC::range_ns<R3B::TDC::ClockTDC150>) // ns
 {
 }
 
-Double_t R3BCoarseTimeStitch::GetTime(Double_t time, TString name1, TString name2)
+Double_t R3BCoarseTimeStitch::GetRange(const TString& name) const
 {
-    if (name1 == "tamex")
-    {
-        fRange1 = fRangeTamex;
-    }
-    else if (name1 == "trb")
+    if (name == "tamex")
     {
-        fRange1 = fRangeTrb;
+        return fRangeTamex;
     }
-    else if (name1 == "vftx")
+    if (name == "trb")
     {
-        fRange1 = fRangeVftx;
+        return fRangeTrb;
     }
-    else if (name1 == "clocktdc")
+    if (name == "vftx")
     {
-        fRange1 = fRangeClockTDC;
+        return fRangeVftx;
     }
-    else
+    if (name == "clocktdc")
     {
-        R3BLOG(fatal, "Module " << name1 << " does not exist.");
+        return fRangeClockTDC;
     }
+    R3BLOG(fatal, "Module " << name << " does not exist.");
+    return 0.;
+}
 
-    if (name2 == "tamex")
-    {
-        fRange2 = fRangeTamex;
-    }
-    else if (name2 == "trb")
-    {
-        fRange2 = fRangeTrb;
-    }
-    else if (name2 == "vftx")
-    {
-        fRange2 = fRangeVftx;
-    }
-    else if (name2 == "clocktdc")
-    {
-        fRange2 = fRangeClockTDC;
-    }
-    else
-    {
-        R3BLOG(fatal, "Module " << name2 << " does not exist.");
-    }
+Double_t R3BCoarseTimeStitch::GetTime(Double_t time, TString name1, TString name2)
+{
+    fRange1 = GetRange(name1);
+    fRange2 = GetRange(name2);
 
     Double_t c1 = TMath::Min(fRange1, fRange2);
     Double_t c2 = TMath::Max(fRange1, fRange2);
@@ -14,6 +14,7 @@
 #ifndef R3BCoarseTimeStitch_H
 #define R3BCoarseTimeStitch_H 1
 
+#include "R3BTDCTraits.h"
 #include "TObject.h"
 #include "TString.h"
 #include <Rtypes.h>
@@ -31,12 +32,19 @@ class R3BCoarseTimeStitch : public TObject
     Float_t GetRange2() const { return fRange2; }
     Double_t GetTime(Double_t, TString name1 = "tamex", TString name2 = "tamex");
 
+    // Same as GetTime(time, name1, name2) with the modules given as types of R3BTDCTraits.h,
+    // e.g. GetTime<R3B::TDC::Tamex, R3B::TDC::Vftx>(time). Ranges 1 and 2 are not updated.
+    template <typename TDC1, typename TDC2 = TDC1>
+    static Double_t GetTime(Double_t time) { return R3B::TDC::Stitch<TDC1, TDC2>(time); }
+
     void SetRange1(Float_t range) { fRange1 = range; }
     void SetRange2(Float_t range) { fRange2 = range; }
 
     void SetClockTDC150() { fRangeClockTDC = fRangeClockTDC150; }
 
   private:
+    Double_t GetRange(const TString& name) const;
+
     Double_t fRange1;
     Double_t fRange2;
     Double_t fRangeTamex;
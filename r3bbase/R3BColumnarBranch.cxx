@@ -0,0 +1,399 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BColumnarBranch.h"
+#include "R3BException.h"
+#include "R3BLogger.h"
+
+#include <TClass.h>
+#include <TClonesArray.h>
+#include <TDataMember.h>
+#include <TDataType.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TList.h>
+#include <TNamed.h>
+#include <TRealData.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <fmt/format.h>
+
+class R3BColumnarBranch::Column
+{
+  public:
+    Column(std::string name, std::string member, Long_t offset)
+        : fName(std::move(name))
+        , fMember(std::move(member))
+        , fOffset(offset)
+    {
+    }
+    virtual ~Column() = default;
+    Column(const Column&) = delete;
+    Column(Column&&) = delete;
+    Column& operator=(const Column&) = delete;
+    Column& operator=(Column&&) = delete;
+
+    virtual void CreateBranch(TTree& tree) = 0;
+    virtual void SetBranchAddress(TTree& tree) = 0;
+    virtual void Clear() = 0;
+    virtual void Fill(const char* object) = 0;
+    // writes the value of the object with index into the member
+    virtual void Restore(char* object, std::size_t index) const = 0;
+    [[nodiscard]] virtual auto GetSize() const -> std::size_t = 0;
+
+    [[nodiscard]] auto GetName() const -> const std::string& { return fName; }
+    [[nodiscard]] auto GetMember() const -> const std::string& { return fMember; }
+    [[nodiscard]] auto IsConnected() const -> bool { return fConnected; }
+    void SetConnected(bool connected) { fConnected = connected; }
+
+  protected:
+    [[nodiscard]] auto GetOffset() const -> Long_t { return fOffset; }
+
+  private:
+    std::string fName;   // "<branch>.<member>"
+    std::string fMember; // name of the member, with the names of enclosing members
+    Long_t fOffset = 0;  // offset of the member in the object
+    bool fConnected = false;
+};
+
+template <typename Stored, typename Member>
+class R3BColumnarBranch::ColumnImpl : public Column
+{
+  public:
+    using Column::Column;
+
+    void CreateBranch(TTree& tree) override { tree.Branch(GetName().c_str(), &fValues); }
+    void SetBranchAddress(TTree& tree) override
+    {
+        tree.SetBranchStatus(GetName().c_str(), true);
+        tree.SetBranchAddress(GetName().c_str(), &fAddress);
+    }
+    void Clear() override { fValues.clear(); }
+    void Fill(const char* object) override
+    {
+        fValues.push_back(static_cast<Stored>(*reinterpret_cast<const Member*>(object + GetOffset())));
+    }
+    void Restore(char* object, std::size_t index) const override
+    {
+        *reinterpret_cast<Member*>(object + GetOffset()) = static_cast<Member>(fValues[index]);
+    }
+    [[nodiscard]] auto GetSize() const -> std::size_t override { return fValues.size(); }
+
+  private:
+    std::vector<Stored> fValues;
+    std::vector<Stored>* fAddress = &fValues; // TTree needs the address of a pointer when reading
+};
+
+R3BColumnarBranch::R3BColumnarBranch(std::string name, TClass* dataClass)
+    : fName(std::move(name))
+    , fClass(dataClass)
+{
+    if (fClass == nullptr || !fClass->InheritsFrom(TObject::Class()))
+    {
+        throw R3B::logic_error(fmt::format("Branch {} does not hold TObjects and cannot be stored in columns", fName));
+    }
+    AddColumns();
+}
+
+R3BColumnarBranch::R3BColumnarBranch(std::string name, const std::string& className)
+    : R3BColumnarBranch(std::move(name), TClass::GetClass(className.c_str()))
+{
+}
+
+R3BColumnarBranch::~R3BColumnarBranch() = default;
+R3BColumnarBranch::R3BColumnarBranch(R3BColumnarBranch&&) noexcept = default;
+R3BColumnarBranch& R3BColumnarBranch::operator=(R3BColumnarBranch&&) noexcept = default;
+
+void R3BColumnarBranch::AddColumns()
+{
+    fClass->BuildRealData();
+    for (auto* realData : TRangeDynCast<TRealData>(fClass->GetListOfRealData()))
+    {
+        auto* member = realData->GetDataMember();
+        // fUniqueID and fBits
+        if (member == nullptr || member->GetClass() == TObject::Class())
+        {
+            continue;
+        }
+        if (!member->IsPersistent() || member->IsaPointer() || member->GetArrayDim() > 0)
+        {
+            R3BLOG(debug, fmt::format("Member {0} of {1} is not stored", realData->GetName(), fClass->GetName()));
+            continue;
+        }
+
+        auto const makeColumn = [&](auto stored, auto value) -> std::unique_ptr<Column>
+        {
+            using Column_t = ColumnImpl<decltype(stored), decltype(value)>;
+            return std::make_unique<Column_t>(
+                fmt::format("{0}.{1}", fName, realData->GetName()), realData->GetName(), realData->GetThisOffset());
+        };
+
+        auto column = std::unique_ptr<Column>{};
+        if (member->IsEnum())
+        {
+            column = makeColumn(Int_t{}, Int_t{});
+        }
+        else if (member->IsBasic() && member->GetDataType() != nullptr)
+        {
+            switch (member->GetDataType()->GetType())
+            {
+                case kChar_t:
+                    column = makeColumn(Char_t{}, Char_t{});
+                    break;
+                case kUChar_t:
+                    column = makeColumn(UChar_t{}, UChar_t{});
+                    break;
+                case kShort_t:
+                    column = makeColumn(Short_t{}, Short_t{});
+                    break;
+                case kUShort_t:
+                    column = makeColumn(UShort_t{}, UShort_t{});
+                    break;
+                case kInt_t:
+                    column = makeColumn(Int_t{}, Int_t{});
+                    break;
+                case kUInt_t:
+                    column = makeColumn(UInt_t{}, UInt_t{});
+                    break;
+                case kLong_t:
+                    column = makeColumn(Long64_t{}, Long_t{});
+                    break;
+                case kULong_t:
+                    column = makeColumn(ULong64_t{}, ULong_t{});
+                    break;
+                case kLong64_t:
+                    column = makeColumn(Long64_t{}, Long64_t{});
+                    break;
+                case kULong64_t:
+                    column = makeColumn(ULong64_t{}, ULong64_t{});
+                    break;
+                case kFloat_t:
+                case kFloat16_t:
+                    column = makeColumn(Float_t{}, Float_t{});
+                    break;
+                case kDouble_t:
+                case kDouble32_t:
+                    column = makeColumn(Double_t{}, Double_t{});
+                    break;
+                case kBool_t:
+                    // std::vector<bool> is not a plain array, store bytes instead
+                    column = makeColumn(UChar_t{}, Bool_t{});
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (column == nullptr)
+        {
+            R3BLOG(debug, fmt::format("Member {0} of {1} is not stored", realData->GetName(), fClass->GetName()));
+            continue;
+        }
+        fColumns.push_back(std::move(column));
+    }
+
+    if (fColumns.empty())
+    {
+        throw R3B::logic_error(fmt::format("Class {0} of branch {1} has no members of basic type to be stored",
+                                           fClass->GetName(),
+                                           fName));
+    }
+}
+
+void R3BColumnarBranch::CreateColumns(TTree& tree)
+{
+    for (auto& column : fColumns)
+    {
+        column->CreateBranch(tree);
+        column->SetConnected(true);
+    }
+}
+
+auto R3BColumnarBranch::ConnectColumns(TTree& tree, const std::vector<std::string>& selection) -> std::size_t
+{
+    auto const isSelected = [&](const Column& column)
+    {
+        return selection.empty() ||
+               std::any_of(selection.begin(),
+                           selection.end(),
+                           [&](const auto& name)
+                           { return name == fName || name == column.GetName() || name == column.GetMember(); });
+    };
+
+    auto nConnected = std::size_t{};
+    for (auto& column : fColumns)
+    {
+        auto const connect = isSelected(*column);
+        if (connect && tree.GetBranch(column->GetName().c_str()) == nullptr)
+        {
+            R3BLOG(warn, fmt::format("Column {} is not in the tree and keeps its default value", column->GetName()));
+            column->SetConnected(false);
+            continue;
+        }
+        if (connect)
+        {
+            column->SetBranchAddress(tree);
+            ++nConnected;
+        }
+        else
+        {
+            tree.SetBranchStatus(column->GetName().c_str(), false);
+        }
+        column->SetConnected(connect);
+    }
+    return nConnected;
+}
+
+void R3BColumnarBranch::Fill(const TClonesArray& array)
+{
+    if (array.GetClass() != fClass)
+    {
+        throw R3B::logic_error(fmt::format("Branch {0} holds {1} instead of {2}",
+                                           fName,
+                                           array.GetClass()->GetName(),
+                                           fClass->GetName()));
+    }
+    for (auto& column : fColumns)
+    {
+        column->Clear();
+    }
+    for (Int_t idx = 0; idx < array.GetEntriesFast(); ++idx)
+    {
+        // offsets of TRealData are counted from the beginning of the complete object
+        const auto* object = static_cast<const char*>(dynamic_cast<const void*>(array.UncheckedAt(idx)));
+        for (auto& column : fColumns)
+        {
+            column->Fill(object);
+        }
+    }
+}
+
+void R3BColumnarBranch::Restore(TClonesArray& array) const
+{
+    // Destroys the objects of the last event but keeps their memory. ConstructedAt() default constructs them again,
+    // such that members without a column, or whose column is not read, do not keep values of the last event.
+    array.Delete();
+
+    auto const firstConnected =
+        std::find_if(fColumns.begin(), fColumns.end(), [](const auto& column) { return column->IsConnected(); });
+    if (firstConnected == fColumns.end())
+    {
+        return;
+    }
+
+    auto const size = (*firstConnected)->GetSize();
+    for (std::size_t idx = 0; idx < size; ++idx)
+    {
+        auto* object = static_cast<char*>(dynamic_cast<void*>(array.ConstructedAt(static_cast<Int_t>(idx))));
+        for (const auto& column : fColumns)
+        {
+            if (column->IsConnected())
+            {
+                column->Restore(object, idx);
+            }
+        }
+    }
+}
+
+auto R3BColumnarBranch::GetColumnNames() const -> std::vector<std::string>
+{
+    auto names = std::vector<std::string>{};
+    names.reserve(fColumns.size());
+    for (const auto& column : fColumns)
+    {
+        names.push_back(column->GetName());
+    }
+    return names;
+}
+
+void R3BColumnarBranch::WriteBranchList(const std::vector<R3BColumnarBranch>& branches)
+{
+    auto branchList = TList{};
+    branchList.SetOwner(true);
+    for (const auto& branch : branches)
+    {
+        branchList.Add(new TNamed(branch.GetName().c_str(), branch.GetClass()->GetName())); // NOLINT
+    }
+    branchList.Write(R3B::Columnar::BranchListName, TObject::kSingleKey);
+}
+
+R3BColumnarReader::R3BColumnarReader(const std::string& fileName, const std::vector<std::string>& selection)
+    : fFileName(fileName)
+{
+    // the input file must not become the directory of objects created later
+    TDirectory::TContext const context{};
+    fFile = R3B::make_rootfile(fileName.c_str(), "READ");
+    if (fFile->IsZombie())
+    {
+        throw R3B::runtime_error(fmt::format("Cannot open columnar file {}", fileName));
+    }
+    fTree = fFile->Get<TTree>(R3B::Columnar::TreeName);
+    auto branchList = std::unique_ptr<TList>{ fFile->Get<TList>(R3B::Columnar::BranchListName) };
+    if (fTree == nullptr || branchList == nullptr)
+    {
+        throw R3B::runtime_error(fmt::format("File {} has not been written by R3BColumnarWriter", fileName));
+    }
+    branchList->SetOwner(true);
+
+    fTree->SetBranchStatus("*", false);
+    for (const auto* branch : TRangeDynCast<TNamed>(branchList.get()))
+    {
+        auto& columnar = fBranches.emplace_back(branch->GetName(), std::string{ branch->GetTitle() });
+        auto const nConnected = columnar.ConnectColumns(*fTree, selection);
+        R3BLOG(debug, fmt::format("Reading {0} columns of branch {1}", nConnected, columnar.GetName()));
+
+        auto& array = fArrays.emplace_back(std::make_unique<TClonesArray>(columnar.GetClass()));
+        array->SetName(columnar.GetName().c_str());
+    }
+}
+
+R3BColumnarReader::~R3BColumnarReader() = default;
+
+auto R3BColumnarReader::ReadEvent(int64_t entry) -> bool
+{
+    if (entry >= fTree->GetEntries() || fTree->GetEntry(entry) < 0)
+    {
+        return false;
+    }
+    for (std::size_t idx = 0; idx < fBranches.size(); ++idx)
+    {
+        fBranches[idx].Restore(*fArrays[idx]);
+    }
+    return true;
+}
+
+auto R3BColumnarReader::GetEntries() const -> int64_t { return fTree->GetEntries(); }
+
+auto R3BColumnarReader::GetBranchNames() const -> std::vector<std::string>
+{
+    auto names = std::vector<std::string>{};
+    names.reserve(fBranches.size());
+    for (const auto& branch : fBranches)
+    {
+        names.push_back(branch.GetName());
+    }
+    return names;
+}
+
+auto R3BColumnarReader::GetArray(std::string_view branchName) const -> TClonesArray*
+{
+    for (std::size_t idx = 0; idx < fBranches.size(); ++idx)
+    {
+        if (fBranches[idx].GetName() == branchName)
+        {
+            return fArrays[idx].get();
+        }
+    }
+    return nullptr;
+}
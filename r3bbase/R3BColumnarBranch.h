@@ -0,0 +1,125 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BCOLUMNARBRANCH_H
+#define R3BCOLUMNARBRANCH_H 1
+
+#include "R3BShared.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TClass;
+class TClonesArray;
+class TTree;
+
+/**
+ * Columnar (structure of arrays) representation of a TClonesArray branch.
+ *
+ * Every persistent data member of basic type of the stored class, e.g. fX of
+ * R3BTofdHitData, becomes one std::vector column named "<branch>.<member>",
+ * which holds the value of the member for all objects of one event. The
+ * columns are plain split branches of a TTree, such that they compress per
+ * member and can be read without the others and without any object streamer.
+ * Members of other types (arrays, pointers, objects) are not stored and keep
+ * the value given by the default constructor when the objects are restored.
+ */
+class R3BColumnarBranch
+{
+  public:
+    R3BColumnarBranch(std::string name, TClass* dataClass);
+    R3BColumnarBranch(std::string name, const std::string& className);
+    ~R3BColumnarBranch();
+    R3BColumnarBranch(const R3BColumnarBranch&) = delete;
+    R3BColumnarBranch(R3BColumnarBranch&&) noexcept;
+    R3BColumnarBranch& operator=(const R3BColumnarBranch&) = delete;
+    R3BColumnarBranch& operator=(R3BColumnarBranch&&) noexcept;
+
+    /** Creates one branch per column for writing. */
+    void CreateColumns(TTree& tree);
+
+    /**
+     * Connects the selected columns of the tree for reading and disables all others.
+     * A column is selected by its full name, by its member name or by the branch name.
+     * An empty selection connects all columns. Returns the number of connected columns.
+     */
+    auto ConnectColumns(TTree& tree, const std::vector<std::string>& selection = {}) -> std::size_t;
+
+    /** Copies the members of all objects in the array into the columns. */
+    void Fill(const TClonesArray& array);
+
+    /** Rebuilds the objects of the last read event from the connected columns, all other members are default. */
+    void Restore(TClonesArray& array) const;
+
+    [[nodiscard]] auto GetName() const -> const std::string& { return fName; }
+    [[nodiscard]] auto GetClass() const -> TClass* { return fClass; }
+    [[nodiscard]] auto GetColumnNames() const -> std::vector<std::string>;
+
+    /** Writes the names and classes of the branches into the current directory, next to the tree. */
+    static void WriteBranchList(const std::vector<R3BColumnarBranch>& branches);
+
+  private:
+    class Column;
+    template <typename Stored, typename Member = Stored>
+    class ColumnImpl;
+
+    std::string fName;
+    TClass* fClass = nullptr;
+    std::vector<std::unique_ptr<Column>> fColumns;
+
+    void AddColumns();
+};
+
+/**
+ * Reads the columnar branches of a file written by R3BColumnarWriter.
+ *
+ * Each branch is restored into its own TClonesArray, only from the columns
+ * given in the selection (all if empty).
+ */
+class R3BColumnarReader
+{
+  public:
+    explicit R3BColumnarReader(const std::string& fileName, const std::vector<std::string>& selection = {});
+    ~R3BColumnarReader();
+    R3BColumnarReader(const R3BColumnarReader&) = delete;
+    R3BColumnarReader(R3BColumnarReader&&) = delete;
+    R3BColumnarReader& operator=(const R3BColumnarReader&) = delete;
+    R3BColumnarReader& operator=(R3BColumnarReader&&) = delete;
+
+    /** Reads one entry and restores the objects of all branches. */
+    auto ReadEvent(int64_t entry) -> bool;
+
+    [[nodiscard]] auto GetEntries() const -> int64_t;
+    [[nodiscard]] auto GetFileName() const -> const std::string& { return fFileName; }
+    [[nodiscard]] auto GetBranchNames() const -> std::vector<std::string>;
+    [[nodiscard]] auto GetArray(std::string_view branchName) const -> TClonesArray*;
+
+  private:
+    std::string fFileName;
+    R3B::unique_rootfile fFile;
+    TTree* fTree = nullptr;
+    std::vector<R3BColumnarBranch> fBranches;
+    std::vector<std::unique_ptr<TClonesArray>> fArrays; // one per branch
+};
+
+namespace R3B::Columnar
+{
+    constexpr auto TreeName = "evt_columnar";
+    // TList of TNamed(branch name, class name)
+    constexpr auto BranchListName = "ColumnarBranchList";
+} // namespace R3B::Columnar
+
+#endif // R3BCOLUMNARBRANCH_H
@@ -0,0 +1,108 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BColumnarWriter.h"
+#include "R3BException.h"
+#include "R3BLogger.h"
+
+#include <FairRootManager.h>
+#include <TClonesArray.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+
+#include <fmt/format.h>
+
+R3BColumnarWriter::R3BColumnarWriter()
+    : R3BColumnarWriter("columnar.root", {})
+{
+}
+
+R3BColumnarWriter::R3BColumnarWriter(std::string fileName, std::vector<std::string> branchNames)
+    : FairTask("R3BColumnarWriter", 1)
+    , fFileName(std::move(fileName))
+    , fBranchNames(std::move(branchNames))
+{
+}
+
+R3BColumnarWriter::~R3BColumnarWriter() = default;
+
+InitStatus R3BColumnarWriter::Init()
+{
+    auto* rootMan = FairRootManager::Instance();
+    if (rootMan == nullptr)
+    {
+        R3BLOG(fatal, "FairRootManager not found");
+        return kFATAL;
+    }
+    if (fBranchNames.empty())
+    {
+        R3BLOG(error, "No branches to be written");
+        return kERROR;
+    }
+
+    // histograms and trees of later tasks must not end up in this file
+    TDirectory::TContext const context{};
+    fFile = R3B::make_rootfile(fFileName.c_str(), "RECREATE");
+    if (fFile->IsZombie())
+    {
+        R3BLOG(fatal, fmt::format("Cannot create file {}", fFileName));
+        return kFATAL;
+    }
+    if (fCompression >= 0)
+    {
+        fFile->SetCompressionSettings(fCompression);
+    }
+    fTree = new TTree(R3B::Columnar::TreeName, "R3B columnar data"); // owned by fFile
+    fTree->SetDirectory(fFile.get());
+
+    for (const auto& name : fBranchNames)
+    {
+        auto* input = dynamic_cast<TClonesArray*>(rootMan->GetObject(name.c_str()));
+        if (input == nullptr)
+        {
+            R3BLOG(fatal, fmt::format("Branch {} not found or not a TClonesArray", name));
+            return kFATAL;
+        }
+        auto& branch = fBranches.emplace_back(name, input->GetClass());
+        branch.CreateColumns(*fTree);
+        fInputs.push_back(input);
+        R3BLOG(info, fmt::format("Writing {0} columns of branch {1}", branch.GetColumnNames().size(), name));
+    }
+    return kSUCCESS;
+}
+
+void R3BColumnarWriter::Exec(Option_t* /*option*/)
+{
+    for (std::size_t idx = 0; idx < fBranches.size(); ++idx)
+    {
+        fBranches[idx].Fill(*fInputs[idx]);
+    }
+    fTree->Fill();
+}
+
+void R3BColumnarWriter::FinishTask()
+{
+    if (fFile == nullptr)
+    {
+        return;
+    }
+    TDirectory::TContext const context{ fFile.get() };
+    fTree->Write();
+    R3BColumnarBranch::WriteBranchList(fBranches);
+    R3BLOG(info, fmt::format("{0} events written to {1}", fTree->GetEntries(), fFileName));
+    fFile.reset();
+    fTree = nullptr;
+}
+
+ClassImp(R3BColumnarWriter);
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BCOLUMNARWRITER_H
+#define R3BCOLUMNARWRITER_H 1
+
+#include "FairTask.h"
+#include "R3BColumnarBranch.h"
+
+#include <Rtypes.h>
+#include <string>
+#include <vector>
+
+class TClonesArray;
+class TTree;
+
+/**
+ * Writes TClonesArray branches in columnar form (see R3BColumnarBranch) into
+ * a separate file, one entry per event.
+ *
+ * The task is added at the end of a run, after the tasks producing the
+ * branches. The file can be read again with
+ * R3BFileSource2::AddColumnarFile(), alongside the input file of the run:
+ *
+ *     run->AddTask(new R3BColumnarWriter("tofd_columnar.root", { "TofdHit", "TofdCal" }));
+ */
+class R3BColumnarWriter : public FairTask
+{
+  public:
+    R3BColumnarWriter();
+    R3BColumnarWriter(std::string fileName, std::vector<std::string> branchNames);
+    ~R3BColumnarWriter() override;
+    R3BColumnarWriter(const R3BColumnarWriter&) = delete;
+    R3BColumnarWriter(R3BColumnarWriter&&) = delete;
+    R3BColumnarWriter& operator=(const R3BColumnarWriter&) = delete;
+    R3BColumnarWriter& operator=(R3BColumnarWriter&&) = delete;
+
+    void AddBranch(std::string branchName) { fBranchNames.push_back(std::move(branchName)); }
+    // see TFile::SetCompressionSettings
+    void SetCompressionSettings(Int_t settings) { fCompression = settings; }
+
+    InitStatus Init() override;
+    void Exec(Option_t* option) override;
+    void FinishTask() override;
+
+  private:
+    std::string fFileName;
+    std::vector<std::string> fBranchNames;
+    Int_t fCompression = -1; // ROOT default
+
+    R3B::unique_rootfile fFile;                //!
+    TTree* fTree = nullptr;                    //!
+    std::vector<R3BColumnarBranch> fBranches;  //!
+    std::vector<TClonesArray*> fInputs;        //!
+
+  public:
+    ClassDefOverride(R3BColumnarWriter, 1)
+};
+
+#endif // R3BCOLUMNARWRITER_H
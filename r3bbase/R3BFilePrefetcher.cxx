@@ -0,0 +1,114 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BFilePrefetcher.h"
+#include "R3BLogger.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <fstream>
+
+namespace
+{
+    constexpr std::size_t BlockSize = 4UL << 20U; // 4 MiB
+} // namespace
+
+R3BFilePrefetcher::R3BFilePrefetcher(std::vector<std::vector<std::string>> fileGroups, unsigned int nAhead)
+    : fFileGroups(std::move(fileGroups))
+    , fNAhead(nAhead)
+{
+    fThread = std::thread([this]() { Run(); });
+}
+
+R3BFilePrefetcher::~R3BFilePrefetcher()
+{
+    {
+        auto lock = std::lock_guard{ fMutex };
+        fStop = true;
+    }
+    fCondition.notify_all();
+    fThread.join();
+}
+
+void R3BFilePrefetcher::SetCurrentGroup(int64_t group)
+{
+    if (group < 0)
+    {
+        return;
+    }
+    {
+        auto lock = std::lock_guard{ fMutex };
+        if (static_cast<std::size_t>(group) == fCurrentGroup)
+        {
+            return;
+        }
+        fCurrentGroup = static_cast<std::size_t>(group);
+        // the chain has already passed groups that were not read ahead in time
+        fNextGroup = std::max(fNextGroup, fCurrentGroup + 1);
+    }
+    fCondition.notify_all();
+}
+
+void R3BFilePrefetcher::Run()
+{
+    while (true)
+    {
+        auto group = std::size_t{};
+        {
+            auto lock = std::unique_lock{ fMutex };
+            fCondition.wait(lock,
+                            [this]()
+                            {
+                                return fStop || (fNextGroup < fFileGroups.size() &&
+                                                 fNextGroup <= fCurrentGroup + fNAhead);
+                            });
+            if (fStop)
+            {
+                return;
+            }
+            group = fNextGroup++;
+        }
+        for (const auto& fileName : fFileGroups[group])
+        {
+            ReadFile(fileName);
+        }
+    }
+}
+
+auto R3BFilePrefetcher::IsStopped() -> bool
+{
+    auto lock = std::lock_guard{ fMutex };
+    return fStop;
+}
+
+void R3BFilePrefetcher::ReadFile(const std::string& fileName)
+{
+    if (fileName.find("://") != std::string::npos)
+    {
+        R3BLOG(debug, fmt::format("Remote file {} is not read ahead", fileName));
+        return;
+    }
+    auto file = std::ifstream{ fileName, std::ios::binary };
+    if (!file)
+    {
+        R3BLOG(warn, fmt::format("Cannot read ahead file {}", fileName));
+        return;
+    }
+    auto buffer = std::vector<char>(BlockSize);
+    while (file && !IsStopped())
+    {
+        file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        fPrefetchedBytes += static_cast<uint64_t>(file.gcount());
+    }
+    R3BLOG(debug, fmt::format("Read ahead file {}", fileName));
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BFILEPREFETCHER_H
+#define R3BFILEPREFETCHER_H 1
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Reads input files ahead of the event loop on a background thread.
+ *
+ * The files are grouped by the tree number of the chain: group i contains
+ * the i-th file of the main chain and of each friend chain. While the chain
+ * reads the files of group i, the files of the groups up to i + nAhead are
+ * read in large blocks, so that they are already in the page cache of the
+ * (shared) file system when the chain opens them. The bytes are discarded,
+ * decompression is left to the TTreeCache of the chain.
+ *
+ * Only local paths are read ahead, remote URLs ("root://...") are skipped.
+ */
+class R3BFilePrefetcher
+{
+  public:
+    R3BFilePrefetcher(std::vector<std::vector<std::string>> fileGroups, unsigned int nAhead);
+    ~R3BFilePrefetcher();
+    R3BFilePrefetcher(const R3BFilePrefetcher&) = delete;
+    R3BFilePrefetcher(R3BFilePrefetcher&&) = delete;
+    R3BFilePrefetcher& operator=(const R3BFilePrefetcher&) = delete;
+    R3BFilePrefetcher& operator=(R3BFilePrefetcher&&) = delete;
+
+    /** Index of the file group read by the chain, i.e. TChain::GetTreeNumber(). */
+    void SetCurrentGroup(int64_t group);
+
+    [[nodiscard]] auto GetPrefetchedBytes() const -> uint64_t { return fPrefetchedBytes.load(); }
+
+  private:
+    std::vector<std::vector<std::string>> fFileGroups;
+    unsigned int fNAhead = 1;
+    std::size_t fCurrentGroup = 0;
+    std::size_t fNextGroup = 1; // the first group is opened by the chain right away
+    bool fStop = false;
+    std::atomic<uint64_t> fPrefetchedBytes = 0;
+    std::mutex fMutex;
+    std::condition_variable fCondition;
+    std::thread fThread;
+
+    void Run();
+    void ReadFile(const std::string& fileName);
+    auto IsStopped() -> bool;
+};
+
+#endif // R3BFILEPREFETCHER_H
@@ -19,11 +19,19 @@
 #include <FairRootManager.h>
 #include <TFolder.h>
 #include <TKey.h>
+#include <TROOT.h>
+#include <TTreeCacheUnzip.h>
+#include <algorithm>
+#include <future>
+#include <thread>
 #include <vector>
 
 namespace
 {
     constexpr auto DEFAULT_TITLE = "InputRootFile";
+    // opening files is latency bound, more threads than cores are still useful on shared file systems
+    constexpr unsigned int MAX_VALIDATION_THREADS = 16;
+    constexpr double MEGABYTE = 1024. * 1024.;
 
     template <typename ContainerType, typename DataType>
     auto Vector2TContainer(std::vector<DataType>& vec) -> std::unique_ptr<ContainerType>
@@ -160,24 +168,93 @@ auto R3BInputRootFiles::ExtractMainFolder(TFile* rootFile) -> std::optional<TKey
     return GetDataFromAnyFolder(rootFile, folderNames);
 }
 
-auto R3BInputRootFiles::ValidateFile(const std::string& filename) -> bool
+auto R3BInputRootFiles::AddFileNames(std::vector<std::string> fileNames, bool isConcurrent) -> Strings
 {
-    auto rootFile = R3B::make_rootfile(filename.c_str());
-    auto folderKey = ExtractMainFolder(rootFile.get());
-    auto res = folderKey.has_value() && HasBranchList(rootFile.get(), branchList_);
-    if (res)
+    auto rejected = Strings{};
+    auto next = fileNames.begin();
+    // the first file defines the branch list the others are compared with
+    for (; (fileNames_.empty() || !isConcurrent) && next != fileNames.end(); ++next)
     {
-        if (!folderName_.empty() && (folderKey.value()->GetName() != folderName_))
+        if (auto res = AddFileName(std::move(*next)); res.has_value())
         {
-            R3BLOG(warn, "Different folder name!");
+            rejected.push_back(std::move(res.value()));
         }
-        if (!is_friend_)
+    }
+
+    if (next == fileNames.end())
+    {
+        return rejected;
+    }
+
+    ROOT::EnableThreadSafety();
+    auto const nThreads = std::clamp(std::thread::hardware_concurrency(), 1U, MAX_VALIDATION_THREADS);
+    while (next != fileNames.end())
+    {
+        auto const nChecks = std::min(static_cast<std::ptrdiff_t>(nThreads), fileNames.end() - next);
+        auto checks = std::vector<std::future<std::optional<CheckedFile>>>{};
+        for (auto iter = next; iter != next + nChecks; ++iter)
         {
-            validRootFiles_.push_back(std::move(rootFile));
-            validMainFolders_.push_back((folderKey.value())->ReadObject<TFolder>());
+            R3BLOG(info, fmt::format("Adding {} to file source\n", *iter));
+            checks.push_back(std::async(std::launch::async, [this, iter]() { return CheckFile(*iter); }));
         }
+        // taken over in the order of the file names
+        for (auto& check : checks)
+        {
+            if (auto checkedFile = check.get(); checkedFile.has_value())
+            {
+                AcceptFile(std::move(checkedFile.value()));
+                fileNames_.push_back(std::move(*next));
+            }
+            else
+            {
+                rejected.push_back(std::move(*next));
+            }
+            ++next;
+        }
+    }
+    return rejected;
+}
+
+auto R3BInputRootFiles::CheckFile(const std::string& filename) const -> std::optional<CheckedFile>
+{
+    auto rootFile = R3B::make_rootfile(filename.c_str());
+    auto folderKey = ExtractMainFolder(rootFile.get());
+    if (!folderKey.has_value() || !HasBranchList(rootFile.get(), branchList_))
+    {
+        return {};
     }
-    return res;
+    auto checkedFile = CheckedFile{};
+    checkedFile.folderName = folderKey.value()->GetName();
+    if (!is_friend_)
+    {
+        checkedFile.folder = folderKey.value()->ReadObject<TFolder>();
+    }
+    checkedFile.file = std::move(rootFile);
+    return checkedFile;
+}
+
+void R3BInputRootFiles::AcceptFile(CheckedFile checkedFile)
+{
+    if (!folderName_.empty() && (checkedFile.folderName != folderName_))
+    {
+        R3BLOG(warn, "Different folder name!");
+    }
+    if (!is_friend_)
+    {
+        validRootFiles_.push_back(std::move(checkedFile.file));
+        validMainFolders_.push_back(checkedFile.folder);
+    }
+}
+
+auto R3BInputRootFiles::ValidateFile(const std::string& filename) -> bool
+{
+    auto checkedFile = CheckFile(filename);
+    if (!checkedFile.has_value())
+    {
+        return false;
+    }
+    AcceptFile(std::move(checkedFile.value()));
+    return true;
 }
 
 auto R3BInputRootFiles::ExtractRunId(TFile* rootFile) -> std::optional<uint>
@@ -255,14 +332,9 @@ R3BFileSource2::R3BFileSource2(std::vector<std::string> fileNames, std::string_v
     LOG(debug) << "Creating a new R3BFileSource!";
     inputDataFiles_.SetTitle(title);
     inputDataFiles_.SetFileHeaderName("FileHeader");
-    for (auto& name : fileNames)
-    {
-        if (name.empty())
-        {
-            continue;
-        }
-        AddFile(std::move(name));
-    }
+    fileNames.erase(std::remove_if(fileNames.begin(), fileNames.end(), [](const auto& name) { return name.empty(); }),
+                    fileNames.end());
+    AddFiles(std::move(fileNames));
 }
 
 R3BFileSource2::R3BFileSource2(std::string file, std::string_view title)
@@ -280,16 +352,22 @@ R3BFileSource2::R3BFileSource2()
 {
 }
 
-void R3BFileSource2::AddFile(std::string fileName)
-{
+void R3BFileSource2::AddFile(std::string fileName) { AddFiles({ std::move(fileName) }); }
 
-    if (auto const res = inputDataFiles_.AddFileName(std::move(fileName)); res.has_value())
+void R3BFileSource2::AddFiles(std::vector<std::string> fileNames)
+{
+    dataFileNames_.insert(dataFileNames_.end(), fileNames.begin(), fileNames.end());
+    for (auto const& name : inputDataFiles_.AddFileNames(std::move(fileNames), readAheadFiles_ > 0))
     {
         R3BLOG(error,
-               fmt::format(
-                   "Root file {0} is incompatible with the first root file {1}", res.value(), dataFileNames_.front()));
+               fmt::format("Root file {0} is incompatible with the first root file {1}", name, dataFileNames_.front()));
     }
-    dataFileNames_.emplace_back(fileName);
+}
+
+void R3BFileSource2::EnableReadAhead(unsigned int nFiles, int64_t cacheSize)
+{
+    readAheadFiles_ = nFiles;
+    cacheSize_ = cacheSize;
 }
 
 void R3BFileSource2::AddFriend(std::string_view fileName)
@@ -323,18 +401,122 @@ void R3BFileSource2::AddFriend(std::string_view fileName)
     }
 }
 
+void R3BFileSource2::AddColumnarFile(const std::string& fileName, const std::vector<std::string>& columns)
+{
+    R3BLOG(info, fmt::format("Adding columnar file {} to file source", fileName));
+    auto reader = std::make_unique<R3BColumnarReader>(fileName, columns);
+    for (auto const& branchName : reader->GetBranchNames())
+    {
+        if (FindColumnarInput(branchName) != nullptr)
+        {
+            throw R3B::logic_error(fmt::format("Branch {0} of {1} has already been added", branchName, fileName));
+        }
+    }
+    columnarInputs_.push_back(std::move(reader));
+}
+
 Bool_t R3BFileSource2::Init()
 {
-    inputDataFiles_.RegisterTo(FairRootManager::Instance());
+    auto* rootMan = FairRootManager::Instance();
+    inputDataFiles_.RegisterTo(rootMan);
 
     for (auto& friendGroup : inputFriendFiles_)
     {
         inputDataFiles_.SetFriend(friendGroup);
     }
 
+    if (readAheadFiles_ > 0)
+    {
+        InitReadAhead();
+    }
+
+    // FairRootManager looks up the objects of input branches in the list of folders
+    if (!columnarInputs_.empty())
+    {
+        columnarFolder_ = new TFolder("columnar", "columnar input"); // NOLINT
+        for (auto& reader : columnarInputs_)
+        {
+            if (reader->GetEntries() != inputDataFiles_.GetEntries())
+            {
+                R3BLOG(warn,
+                       fmt::format("Columnar file {0} has {1} entries instead of {2}",
+                                   reader->GetFileName(),
+                                   reader->GetEntries(),
+                                   inputDataFiles_.GetEntries()));
+            }
+            for (auto const& branchName : reader->GetBranchNames())
+            {
+                columnarFolder_->Add(reader->GetArray(branchName));
+                rootMan->AddBranchToList(branchName.c_str());
+            }
+        }
+        rootMan->GetListOfFolders()->Add(columnarFolder_);
+    }
+
     return true;
 }
 
+void R3BFileSource2::InitReadAhead()
+{
+    // the caches learn the read branches during the first entries
+    inputDataFiles_.GetChain()->SetCacheSize(cacheSize_);
+    for (auto& friendGroup : inputFriendFiles_)
+    {
+        friendGroup.GetChain()->SetCacheSize(cacheSize_);
+    }
+    if (ROOT::IsImplicitMTEnabled())
+    {
+        TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+    }
+
+    // files with the same tree number are read at the same time
+    auto fileGroups = std::vector<std::vector<std::string>>{};
+    for (auto const& fileName : inputDataFiles_.GetFileNames())
+    {
+        fileGroups.push_back({ fileName });
+    }
+    for (auto const& friendGroup : inputFriendFiles_)
+    {
+        auto const& friendNames = friendGroup.GetFileNames();
+        for (std::size_t idx = 0; idx < std::min(friendNames.size(), fileGroups.size()); ++idx)
+        {
+            fileGroups[idx].push_back(friendNames[idx]);
+        }
+    }
+    prefetcher_ = std::make_unique<R3BFilePrefetcher>(std::move(fileGroups), readAheadFiles_);
+    R3BLOG(info,
+           fmt::format("Reading {0} file(s) ahead with a cache of {1:.0f} MB",
+                       readAheadFiles_,
+                       static_cast<double>(cacheSize_) / MEGABYTE));
+}
+
+void R3BFileSource2::Close()
+{
+    if (readEvents_ > 0)
+    {
+        auto const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - readStart_).count();
+        auto const compressed = static_cast<double>(TFile::GetFileBytesRead() - readStartBytes_) / MEGABYTE;
+        auto const uncompressed = static_cast<double>(uncompressedBytes_) / MEGABYTE;
+        R3BLOG(info,
+               fmt::format("Read {0} events in {1:.1f} s: {2:.1f} MB from files ({3:.1f} MB/s), {4:.1f} MB "
+                           "uncompressed ({5:.1f} MB/s)",
+                           readEvents_,
+                           seconds,
+                           compressed,
+                           compressed / seconds,
+                           uncompressed,
+                           uncompressed / seconds));
+        if (prefetcher_ != nullptr)
+        {
+            R3BLOG(info,
+                   fmt::format("{:.1f} MB read ahead",
+                               static_cast<double>(prefetcher_->GetPrefetchedBytes()) / MEGABYTE));
+        }
+        readEvents_ = 0;
+    }
+    prefetcher_.reset();
+}
+
 void R3BFileSource2::FillEventHeader(FairEventHeader* evtHeader)
 {
     if (evtHeader == nullptr)
@@ -375,6 +557,14 @@ void R3BFileSource2::ReadBranchEvent(const char* BrName)
 
 void R3BFileSource2::ReadBranchEvent(const char* BrName, Int_t entryID)
 {
+    if (auto* reader = FindColumnarInput(BrName); reader != nullptr)
+    {
+        if (!reader->ReadEvent(entryID))
+        {
+            LOG(warn) << fmt::format("Failed to read the data of the event {0} from the branch {1}", entryID, BrName);
+        }
+        return;
+    }
     auto const read_bytes = inputDataFiles_.GetChain()->FindBranch(BrName)->GetEntry(entryID);
     if (read_bytes == 0)
     {
@@ -404,21 +594,60 @@ Int_t R3BFileSource2::ReadEvent(UInt_t eventID)
 
     // TODO: clean this mess
 
+    if (readEvents_ == 0)
+    {
+        readStart_ = std::chrono::steady_clock::now();
+        readStartBytes_ = TFile::GetFileBytesRead();
+    }
+
     auto read_bytes = chain->GetEntry(eventID);
     if (read_bytes == 0)
     {
         LOG(warn) << fmt::format("Failed to read the data of the event {0} from the source", eventID);
         return 1;
     }
+    ++readEvents_;
+    uncompressedBytes_ += read_bytes;
+    if (prefetcher_ != nullptr)
+    {
+        prefetcher_->SetCurrentGroup(chain->GetTreeNumber());
+    }
+    for (auto& reader : columnarInputs_)
+    {
+        if (!reader->ReadEvent(eventID))
+        {
+            LOG(warn) << fmt::format(
+                "Failed to read the data of the event {0} from the columnar file {1}", eventID, reader->GetFileName());
+            return 1;
+        }
+    }
     return 0;
 }
 
 Bool_t R3BFileSource2::ActivateObject(TObject** obj, const char* BrName)
 {
+    // the object has been taken from the columnar folder and is filled in ReadEvent
+    if (auto* reader = FindColumnarInput(BrName); reader != nullptr)
+    {
+        *obj = reader->GetArray(BrName);
+        return kTRUE;
+    }
     auto* chain = inputDataFiles_.GetChain();
     chain->SetBranchStatus(BrName, true);
     chain->SetBranchAddress(BrName, obj);
     return kTRUE;
 }
 
+auto R3BFileSource2::FindColumnarInput(std::string_view branchName) const -> R3BColumnarReader*
+{
+    for (const auto& reader : columnarInputs_)
+    {
+        if (reader->GetArray(branchName) != nullptr)
+        {
+            return reader.get();
+        }
+    }
+    return nullptr;
+}
+
 ClassImp(R3BFileSource2);
@@ -14,8 +14,11 @@
 #pragma once
 
 #include "FairSource.h"
+#include "R3BColumnarBranch.h"
+#include "R3BFilePrefetcher.h"
 #include "R3BShared.h"
 #include <TObjString.h>
+#include <chrono>
 #include <optional>
 
 class FairRootManager;
@@ -28,6 +31,9 @@ class R3BInputRootFiles
     using Strings = std::vector<std::string>;
     R3BInputRootFiles() = default;
     auto AddFileName(std::string name) -> std::optional<std::string>;
+    // Validates the files one by one, or concurrently after ROOT::EnableThreadSafety() if isConcurrent is set,
+    // and returns the names of the incompatible ones.
+    auto AddFileNames(std::vector<std::string> names, bool isConcurrent = false) -> Strings;
     void SetInputFileChain(TChain* chain);
     void RegisterTo(FairRootManager*);
 
@@ -37,6 +43,7 @@ class R3BInputRootFiles
     // Getters:
     [[nodiscard]] auto GetBranchListRef() const -> const auto& { return branchList_; }
     [[nodiscard]] auto GetBaseFileName() const -> const auto& { return fileNames_.front(); }
+    [[nodiscard]] auto GetFileNames() const -> const auto& { return fileNames_; }
     [[nodiscard]] auto GetTreeName() const -> const auto& { return treeName_; }
     [[nodiscard]] auto GetFolderName() const -> const auto& { return folderName_; }
     [[nodiscard]] auto GetTitle() const -> const auto& { return title_; }
@@ -57,6 +64,13 @@ class R3BInputRootFiles
     R3BInputRootFiles& operator=(R3BInputRootFiles&&) = default;
 
   private:
+    struct CheckedFile
+    {
+        R3B::unique_rootfile file;
+        std::string folderName;
+        TFolder* folder = nullptr; // only read for the main files
+    };
+
     bool is_friend_ = false;
     uint initial_RunID_ = 0;
     // title of each file group seems not necessary. Consider to remove it in the future.
@@ -73,6 +87,9 @@ class R3BInputRootFiles
 
     void Intitialize(std::string_view filename);
     auto ValidateFile(const std::string& filename) -> bool;
+    // thread safe part of ValidateFile
+    auto CheckFile(const std::string& filename) const -> std::optional<CheckedFile>;
+    void AcceptFile(CheckedFile checkedFile);
     static auto ExtractMainFolder(TFile*) -> std::optional<TKey*>;
     auto ExtractRunId(TFile* rootFile) -> std::optional<uint>;
 };
@@ -88,10 +105,22 @@ class R3BFileSource2 : public FairSource
 
     // public interface:
     void AddFile(std::string);
+    void AddFiles(std::vector<std::string> fileNames);
     void AddFriend(std::string_view);
+    // Adds a file of R3BColumnarWriter, of which only the selected columns (all if empty) are read.
+    void AddColumnarFile(const std::string& fileName, const std::vector<std::string>& columns = {});
     void SetFileHeaderName(std::string_view fileHeaderName) { inputDataFiles_.SetFileHeaderName(fileHeaderName); }
     void DisablePrint() { allow_print_ = false; }
     void EnablePrint() { allow_print_ = true; }
+    /**
+     * Reads the next nFiles input files (and their friends) ahead on a background thread and
+     * enables the TTreeCache of the chains with cacheSize bytes. The cached baskets are
+     * decompressed in parallel if ROOT::EnableImplicitMT() has been called before Init.
+     * Files added afterwards are validated concurrently, which enables ROOT::EnableThreadSafety().
+     */
+    void EnableReadAhead(unsigned int nFiles = 1, int64_t cacheSize = DefaultCacheSize);
+
+    static constexpr int64_t DefaultCacheSize = 100 * 1024 * 1024; // 100 MiB
 
   private:
     bool allow_print_ = false;
@@ -100,11 +129,22 @@ class R3BFileSource2 : public FairSource
     std::vector<R3BInputRootFiles> inputFriendFiles_;
     std::vector<std::string> dataFileNames_;
     std::vector<std::string> friendFileNames_;
+    std::vector<std::unique_ptr<R3BColumnarReader>> columnarInputs_;
+    TFolder* columnarFolder_ = nullptr; // handed over to FairRootManager like the main folders
+    unsigned int readAheadFiles_ = 0;
+    int64_t cacheSize_ = 0;
+    std::unique_ptr<R3BFilePrefetcher> prefetcher_;
+
+    // read statistics, reported at Close
+    int64_t readEvents_ = 0;
+    int64_t readStartBytes_ = 0;
+    int64_t uncompressedBytes_ = 0;
+    std::chrono::steady_clock::time_point readStart_;
 
     // virtual functions should be private!
     Bool_t Init() override;
     Int_t ReadEvent(UInt_t eventID = 0) override;
-    void Close() override {}
+    void Close() override;
     void Reset() override {}
     Bool_t InitUnpackers() override { return kTRUE; }
     Bool_t ReInitUnpackers() override { return kTRUE; }
@@ -119,6 +159,9 @@ class R3BFileSource2 : public FairSource
     // WTF is this?
     Bool_t SpecifyRunId() override { return ReadEvent(0) == 0; }
 
+    auto FindColumnarInput(std::string_view branchName) const -> R3BColumnarReader*;
+    void InitReadAhead();
+
   public:
     ClassDefOverride(R3BFileSource2, 0) // NOLINT
 };
@@ -0,0 +1,237 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BIONCHAMBERFIT_H
+#define R3BIONCHAMBERFIT_H 1
+
+#include "TSpline.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * Hit reconstruction kernel shared by the ionization chambers (TWIM, MUSIC, MUSLI).
+ *
+ * LineFit replaces the TMatrixD/TDecompSVD straight-line fit of the drift
+ * times against the anode positions. The positions are set once from the
+ * parameter containers, the fit of an event only adds up five sums and solves
+ * the normal equations in closed form, without any allocation:
+ *
+ *     fit.SetPositions(posAnodes, nAnodes); // SetParameter()
+ *     ...
+ *     fit.Clear();
+ *     fit.Add(anode, dt);                   // for each good anode
+ *     fit.Solve(offset, slope);
+ *
+ * Polynomial() evaluates the charge-Z calibration with Horner's method and
+ * Spline is a tabulated copy of a TSpline3 for the corrections in the event loop.
+ */
+namespace R3B::IonChamber
+{
+    /**
+     * Weighted least squares fit of t = offset + slope * z over the anodes of one chamber.
+     * The positions are stored relative to their mean, which keeps the normal equations
+     * well conditioned for anodes far away from z = 0. Offset is given at z = 0.
+     */
+    template <std::size_t MaxAnodes>
+    class LineFit
+    {
+      public:
+        // Positions of the anodes 0 .. size - 1, at most MaxAnodes
+        void SetPositions(const double* pos, std::size_t size)
+        {
+            fSize = std::min(size, MaxAnodes);
+            fRef = 0.;
+            for (std::size_t idx = 0; idx < fSize; ++idx)
+            {
+                fRef += pos[idx];
+            }
+            fRef = fSize > 0 ? fRef / static_cast<double>(fSize) : 0.;
+            for (std::size_t idx = 0; idx < fSize; ++idx)
+            {
+                fZ[idx] = pos[idx] - fRef;
+                fZZ[idx] = fZ[idx] * fZ[idx];
+            }
+            Clear();
+        }
+
+        void Clear()
+        {
+            fN = 0;
+            fS = 0.;
+            fSz = 0.;
+            fSzz = 0.;
+            fSt = 0.;
+            fSzt = 0.;
+        }
+
+        // A NaN time makes the result of the fit NaN, as with the SVD
+        void Add(std::size_t anode, double time, double weight = 1.)
+        {
+            ++fN;
+            fS += weight;
+            fSz += weight * fZ[anode];
+            fSzz += weight * fZZ[anode];
+            fSt += weight * time;
+            fSzt += weight * fZ[anode] * time;
+        }
+
+        /**
+         * Solves the normal equations. Returns false, leaving offset and slope
+         * untouched, if the anodes do not span at least two different positions.
+         */
+        auto Solve(double& offset, double& slope) const -> bool
+        {
+            const auto det = fS * fSzz - fSz * fSz;
+            if (fN < 2 || !(det > 0.))
+            {
+                return false;
+            }
+            slope = (fS * fSzt - fSz * fSt) / det;
+            offset = (fSt - slope * fSz) / fS - slope * fRef;
+            return true;
+        }
+
+        [[nodiscard]] auto GetN() const -> std::size_t { return fN; }
+        [[nodiscard]] auto GetSize() const -> std::size_t { return fSize; }
+        [[nodiscard]] auto GetPosition(std::size_t anode) const -> double { return fZ[anode] + fRef; }
+
+      private:
+        std::array<double, MaxAnodes> fZ{};  // position relative to fRef
+        std::array<double, MaxAnodes> fZZ{}; // its square
+        std::size_t fSize = 0;
+        double fRef = 0.;
+        std::size_t fN = 0;
+        double fS = 0.;
+        double fSz = 0.;
+        double fSzz = 0.;
+        double fSt = 0.;
+        double fSzt = 0.;
+    };
+
+    // coefficients[0] + coefficients[1] * x + ... + coefficients[size - 1] * x^(size - 1)
+    template <typename T>
+    [[nodiscard]] inline auto Polynomial(double x, const T* coefficients, std::size_t size) -> double
+    {
+        auto value = 0.;
+        for (std::size_t idx = size; idx > 0; --idx)
+        {
+            value = value * x + coefficients[idx - 1];
+        }
+        return value;
+    }
+
+    /**
+     * Knots and coefficients of a TSpline3 in one flat array. Eval() gives the
+     * same values as TSpline3::Eval, including the extrapolation with the first
+     * and last polynomial, but finds the interval without the virtual calls and
+     * indexes equidistant knots directly. An empty spline evaluates to NaN.
+     */
+    class Spline
+    {
+      public:
+        Spline() = default;
+        explicit Spline(const TSpline3& spline)
+        {
+            const auto size = spline.GetNp();
+            fKnots.resize(size > 0 ? size : 0);
+            for (Int_t idx = 0; idx < size; ++idx)
+            {
+                auto& knot = fKnots[idx];
+                spline.GetCoeff(idx, knot.x, knot.y, knot.b, knot.c, knot.d);
+            }
+            if (fKnots.size() < 2)
+            {
+                return;
+            }
+            const auto step = (fKnots.back().x - fKnots.front().x) / static_cast<double>(fKnots.size() - 1);
+            fEquidistant = step > 0.;
+            for (std::size_t idx = 1; idx < fKnots.size() && fEquidistant; ++idx)
+            {
+                fEquidistant = std::abs(fKnots[idx].x - fKnots[idx - 1].x - step) < 1e-9 * step;
+            }
+            fInvStep = fEquidistant ? 1. / step : 0.;
+        }
+
+        [[nodiscard]] auto Eval(double x) const -> double
+        {
+            if (fKnots.empty())
+            {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+            const auto last = fKnots.size() - 1;
+            auto low = std::size_t{};
+            if (x <= fKnots.front().x)
+            {
+                low = 0;
+            }
+            else if (x >= fKnots.back().x)
+            {
+                low = last;
+            }
+            else if (fEquidistant)
+            {
+                low = std::min(static_cast<std::size_t>((x - fKnots.front().x) * fInvStep), last);
+                // rounding at the knots
+                if (x < fKnots[low].x && low > 0)
+                {
+                    --low;
+                }
+                else if (low < last && x > fKnots[low + 1].x)
+                {
+                    ++low;
+                }
+            }
+            else
+            {
+                // last knot below x, as the bisection of TSpline3
+                low = static_cast<std::size_t>(
+                          std::lower_bound(fKnots.begin(),
+                                           fKnots.end(),
+                                           x,
+                                           [](const Knot& knot, double value) { return knot.x < value; }) -
+                          fKnots.begin()) -
+                      1;
+            }
+            if (low >= last && last > 0)
+            {
+                low = last - 1;
+            }
+            const auto& knot = fKnots[low];
+            const auto dx = x - knot.x;
+            return knot.y + dx * (knot.b + dx * (knot.c + dx * knot.d));
+        }
+
+        [[nodiscard]] auto GetNp() const -> std::size_t { return fKnots.size(); }
+        [[nodiscard]] auto IsEmpty() const -> bool { return fKnots.empty(); }
+
+      private:
+        struct Knot
+        {
+            double x = 0.;
+            double y = 0.;
+            double b = 0.;
+            double c = 0.;
+            double d = 0.;
+        };
+        std::vector<Knot> fKnots;
+        bool fEquidistant = false;
+        double fInvStep = 0.;
+    };
+} // namespace R3B::IonChamber
+
+#endif /* R3BIONCHAMBERFIT_H */
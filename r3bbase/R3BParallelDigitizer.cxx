@@ -0,0 +1,423 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BParallelDigitizer.h"
+#include "R3BException.h"
+#include "R3BLogger.h"
+#include "R3BShared.h"
+
+#include <FairFileHeader.h>
+#include <FairRootManager.h>
+#include <TBranchElement.h>
+#include <TClonesArray.h>
+#include <TFile.h>
+#include <TFolder.h>
+#include <TList.h>
+#include <TObjString.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <fmt/format.h>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    constexpr unsigned int BatchesPerThreadAndBlock = 4;
+    constexpr Int_t BufferSize = 32000;
+    constexpr Int_t SplitLevel = 99;
+
+    // splitmix64 finaliser
+    auto Mix(uint64_t value) -> uint64_t
+    {
+        value += 0x9E3779B97F4A7C15ULL;                           // NOLINT
+        value = (value ^ (value >> 30U)) * 0xBF58476D1CE4E5B9ULL; // NOLINT
+        value = (value ^ (value >> 27U)) * 0x94D049BB133111EBULL; // NOLINT
+        return value ^ (value >> 31U);                            // NOLINT
+    }
+} // namespace
+
+struct R3BParallelDigitizer::Event
+{
+    std::vector<std::unique_ptr<TClonesArray>> inputs;  // one per detector
+    std::vector<std::unique_ptr<TClonesArray>> outputs; // one per detector
+};
+
+struct R3BParallelDigitizer::Block
+{
+    int64_t firstEvent = 0; // multiple of the batch size
+    int64_t nEvents = 0;
+    std::vector<Event> events;
+};
+
+// Persistent worker threads, each with its own random generators and workers for all detectors
+class R3BParallelDigitizer::ThreadPool
+{
+  public:
+    ThreadPool(const R3BParallelDigitizer& digitizer, unsigned int nThreads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    // Starts the digitization of all batches of the block and returns immediately
+    void Start(Block* block);
+    // Waits for the block to be finished and rethrows the first exception of a worker
+    void Wait();
+
+  private:
+    struct WorkerThread
+    {
+        std::vector<std::unique_ptr<TRandom3>> rnds;
+        std::vector<std::unique_ptr<R3BDigitizingWorker>> workers;
+        std::thread thread;
+    };
+
+    const R3BParallelDigitizer& fDigitizer;
+    std::vector<WorkerThread> fThreads;
+
+    std::mutex fMutex;
+    std::condition_variable fStartCondition;
+    std::condition_variable fDoneCondition;
+    Block* fBlock = nullptr;
+    uint64_t fGeneration = 0;
+    unsigned int fNRunning = 0;
+    bool fStop = false;
+    std::exception_ptr fError;
+    std::atomic<int64_t> fNextBatch{ 0 };
+
+    void Loop(WorkerThread& worker);
+    void ProcessBatch(WorkerThread& worker, Block& block, int64_t batchInBlock) const;
+};
+
+R3BParallelDigitizer::ThreadPool::ThreadPool(const R3BParallelDigitizer& digitizer, unsigned int nThreads)
+    : fDigitizer(digitizer)
+    , fThreads(nThreads)
+{
+    // the workers are created here, i.e. on the main thread
+    for (auto& thread : fThreads)
+    {
+        for (const auto& detector : fDigitizer.fDetectors)
+        {
+            auto& rnd = thread.rnds.emplace_back(std::make_unique<TRandom3>(1));
+            auto worker = detector.factory(*rnd);
+            if (worker == nullptr)
+            {
+                throw R3B::logic_error(fmt::format("No digitizing worker for the branch {}", detector.inputBranch));
+            }
+            thread.workers.push_back(std::move(worker));
+        }
+    }
+    for (auto& thread : fThreads)
+    {
+        thread.thread = std::thread([this, &thread]() { Loop(thread); });
+    }
+}
+
+R3BParallelDigitizer::ThreadPool::~ThreadPool()
+{
+    {
+        auto lock = std::lock_guard<std::mutex>{ fMutex };
+        fStop = true;
+    }
+    fStartCondition.notify_all();
+    for (auto& thread : fThreads)
+    {
+        if (thread.thread.joinable())
+        {
+            thread.thread.join();
+        }
+    }
+}
+
+void R3BParallelDigitizer::ThreadPool::Start(Block* block)
+{
+    {
+        auto lock = std::lock_guard<std::mutex>{ fMutex };
+        fBlock = block;
+        fNextBatch = 0;
+        fNRunning = static_cast<unsigned int>(fThreads.size());
+        ++fGeneration;
+    }
+    fStartCondition.notify_all();
+}
+
+void R3BParallelDigitizer::ThreadPool::Wait()
+{
+    auto lock = std::unique_lock<std::mutex>{ fMutex };
+    fDoneCondition.wait(lock, [this]() { return fNRunning == 0; });
+    if (fError)
+    {
+        std::rethrow_exception(std::exchange(fError, nullptr));
+    }
+}
+
+void R3BParallelDigitizer::ThreadPool::Loop(WorkerThread& worker)
+{
+    auto generation = uint64_t{ 0 };
+    while (true)
+    {
+        Block* block = nullptr;
+        {
+            auto lock = std::unique_lock<std::mutex>{ fMutex };
+            fStartCondition.wait(lock, [this, generation]() { return fStop || fGeneration != generation; });
+            if (fStop)
+            {
+                return;
+            }
+            generation = fGeneration;
+            block = fBlock;
+        }
+
+        try
+        {
+            const auto batchSize = static_cast<int64_t>(fDigitizer.fBatchSize);
+            const auto nBatches = (block->nEvents + batchSize - 1) / batchSize;
+            for (auto batch = fNextBatch++; batch < nBatches; batch = fNextBatch++)
+            {
+                ProcessBatch(worker, *block, batch);
+            }
+        }
+        catch (...)
+        {
+            auto lock = std::lock_guard<std::mutex>{ fMutex };
+            if (!fError)
+            {
+                fError = std::current_exception();
+            }
+        }
+
+        auto lock = std::lock_guard<std::mutex>{ fMutex };
+        if (--fNRunning == 0)
+        {
+            fDoneCondition.notify_one();
+        }
+    }
+}
+
+void R3BParallelDigitizer::ThreadPool::ProcessBatch(WorkerThread& worker, Block& block, int64_t batchInBlock) const
+{
+    const auto batchSize = static_cast<int64_t>(fDigitizer.fBatchSize);
+    const auto batch = block.firstEvent / batchSize + batchInBlock;
+    for (size_t detector = 0; detector < worker.rnds.size(); ++detector)
+    {
+        worker.rnds[detector]->SetSeed(GetBatchSeed(fDigitizer.fSeed, batch, detector));
+    }
+
+    const auto first = batchInBlock * batchSize;
+    const auto last = std::min(first + batchSize, block.nEvents);
+    for (auto index = first; index < last; ++index)
+    {
+        auto& event = block.events[index];
+        for (size_t detector = 0; detector < worker.workers.size(); ++detector)
+        {
+            event.outputs[detector]->Clear("C");
+            worker.workers[detector]->Digitize(*event.inputs[detector], *event.outputs[detector]);
+        }
+    }
+}
+
+R3BParallelDigitizer::R3BParallelDigitizer(std::string inputFile, std::string outputFile)
+    : fInputFile(std::move(inputFile))
+    , fOutputFile(std::move(outputFile))
+{
+}
+
+R3BParallelDigitizer::~R3BParallelDigitizer() = default;
+
+void R3BParallelDigitizer::AddDetector(std::string inputBranch,
+                                       std::string outputBranch,
+                                       std::string outputClass,
+                                       WorkerFactory factory)
+{
+    fDetectors.push_back(
+        { std::move(inputBranch), std::move(outputBranch), std::move(outputClass), std::move(factory) });
+}
+
+auto R3BParallelDigitizer::GetBatchSeed(uint64_t seed, int64_t batch, size_t detector) -> uint32_t
+{
+    const auto mixed = Mix(Mix(Mix(seed) ^ static_cast<uint64_t>(batch)) ^ static_cast<uint64_t>(detector));
+    const auto result = static_cast<uint32_t>(mixed >> 32U);
+    // TRandom3::SetSeed(0) would use a random seed
+    return result != 0 ? result : 1;
+}
+
+void R3BParallelDigitizer::Run(int64_t nEvents)
+{
+    if (fDetectors.empty())
+    {
+        throw R3B::logic_error("R3BParallelDigitizer: No detector added");
+    }
+    ROOT::EnableThreadSafety();
+
+    auto inputFile = R3B::make_rootfile(fInputFile.c_str(), "READ");
+    if (inputFile->IsZombie())
+    {
+        throw R3B::runtime_error(fmt::format("R3BParallelDigitizer: Cannot open the input file {}", fInputFile));
+    }
+    auto* inputTree = inputFile->Get<TTree>(FairRootManager::GetTreeName());
+    if (inputTree == nullptr)
+    {
+        throw R3B::runtime_error(fmt::format(
+            "R3BParallelDigitizer: No tree {} in the input file {}", FairRootManager::GetTreeName(), fInputFile));
+    }
+    const auto nEntries = static_cast<int64_t>(inputTree->GetEntries());
+    const auto nTotal = nEvents > 0 ? std::min(nEvents, nEntries) : nEntries;
+
+    const auto nDetectors = fDetectors.size();
+    auto inputClasses = std::vector<std::string>{};
+    inputTree->SetBranchStatus("*", false);
+    for (const auto& detector : fDetectors)
+    {
+        auto* branch = dynamic_cast<TBranchElement*>(inputTree->GetBranch(detector.inputBranch.c_str()));
+        if (branch == nullptr || std::string{ branch->GetClassName() } != "TClonesArray")
+        {
+            throw R3B::runtime_error(
+                fmt::format("R3BParallelDigitizer: No TClonesArray branch {} in the input file", detector.inputBranch));
+        }
+        inputClasses.emplace_back(branch->GetClonesName());
+        inputTree->SetBranchStatus((detector.inputBranch + "*").c_str(), true);
+    }
+
+    const auto nThreads = fNThreads > 0 ? fNThreads : std::max(1U, std::thread::hardware_concurrency());
+    const auto eventsPerBlock = static_cast<int64_t>(fBatchSize) * nThreads * BatchesPerThreadAndBlock;
+    R3BLOG(info,
+           fmt::format("Digitizing {} events with {} threads in batches of {} events", nTotal, nThreads, fBatchSize));
+
+    auto blocks = std::array<Block, 2>{};
+    auto pool = ThreadPool{ *this, nThreads };
+
+    auto outputFile = R3B::make_rootfile(fOutputFile.c_str(), "RECREATE");
+    if (outputFile->IsZombie())
+    {
+        throw R3B::runtime_error(fmt::format("R3BParallelDigitizer: Cannot create the output file {}", fOutputFile));
+    }
+    auto* outputTree = new TTree(FairRootManager::GetTreeName(), "R3BParallelDigitizer"); // owned by the file
+    auto outputArrays = std::vector<std::unique_ptr<TClonesArray>>{};
+    auto outputAddresses = std::vector<TClonesArray*>(nDetectors, nullptr);
+    auto inputAddresses = std::vector<TClonesArray*>(nDetectors, nullptr);
+    for (size_t detector = 0; detector < nDetectors; ++detector)
+    {
+        const auto& branchName = fDetectors[detector].outputBranch;
+        const auto& className = fDetectors[detector].outputClass;
+        auto& array = outputArrays.emplace_back(std::make_unique<TClonesArray>(className.c_str()));
+        array->SetName(branchName.c_str());
+        outputAddresses[detector] = array.get();
+        outputTree->Branch(branchName.c_str(), &outputAddresses[detector], BufferSize, SplitLevel);
+    }
+
+    auto readBlock = [&](Block& block, int64_t firstEvent)
+    {
+        block.firstEvent = firstEvent;
+        block.nEvents = std::min(eventsPerBlock, nTotal - firstEvent);
+        while (static_cast<int64_t>(block.events.size()) < block.nEvents)
+        {
+            auto& event = block.events.emplace_back();
+            for (size_t detector = 0; detector < nDetectors; ++detector)
+            {
+                event.inputs.push_back(std::make_unique<TClonesArray>(inputClasses[detector].c_str()));
+                event.outputs.push_back(std::make_unique<TClonesArray>(fDetectors[detector].outputClass.c_str()));
+            }
+        }
+        for (int64_t index = 0; index < block.nEvents; ++index)
+        {
+            for (size_t detector = 0; detector < nDetectors; ++detector)
+            {
+                inputAddresses[detector] = block.events[index].inputs[detector].get();
+                inputTree->SetBranchAddress(fDetectors[detector].inputBranch.c_str(), &inputAddresses[detector]);
+            }
+            inputTree->GetEntry(firstEvent + index);
+        }
+    };
+
+    auto writeBlock = [&](const Block& block)
+    {
+        for (int64_t index = 0; index < block.nEvents; ++index)
+        {
+            for (size_t detector = 0; detector < nDetectors; ++detector)
+            {
+                outputAddresses[detector] = block.events[index].outputs[detector].get();
+                outputTree->SetBranchAddress(fDetectors[detector].outputBranch.c_str(), &outputAddresses[detector]);
+            }
+            outputTree->Fill();
+        }
+    };
+
+    const auto startTime = std::chrono::steady_clock::now();
+    auto* current = &blocks[0];
+    auto* next = &blocks[1];
+    readBlock(*current, 0);
+    while (current->nEvents > 0)
+    {
+        // the next block is read while the current one is digitized
+        pool.Start(current);
+        const auto nextEvent = current->firstEvent + current->nEvents;
+        next->nEvents = 0;
+        try
+        {
+            if (nextEvent < nTotal)
+            {
+                readBlock(*next, nextEvent);
+            }
+        }
+        catch (...)
+        {
+            pool.Wait();
+            throw;
+        }
+        pool.Wait();
+        writeBlock(*current);
+        R3BLOG(debug, fmt::format("{} of {} events digitized", nextEvent, nTotal));
+        std::swap(current, next);
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    inputTree->ResetBranchAddresses();
+    outputTree->ResetBranchAddresses();
+
+    // file structure of FairRootFileSink, such that the output can be added as a friend to R3BFileSource2
+    outputFile->cd();
+    outputTree->Write();
+    auto folder = TFolder(FairRootManager::GetFolderName(), "Main Folder");
+    auto branchList = TList{};
+    branchList.SetOwner(true);
+    for (auto& array : outputArrays)
+    {
+        folder.Add(array.get());
+        branchList.Add(new TObjString(array->GetName())); // NOLINT
+    }
+    folder.Write();
+    branchList.Write("BranchList", TObject::kSingleKey);
+    TList{}.Write("TimeBasedBranchList", TObject::kSingleKey);
+    if (auto* header = inputFile->Get<FairFileHeader>("FileHeader"); header != nullptr)
+    {
+        outputFile->cd();
+        header->Write("FileHeader");
+    }
+    outputFile.reset();
+
+    R3BLOG(info,
+           fmt::format("Digitized {} events in {:.1f} s ({:.1f} events/s), output written to {}",
+                       nTotal,
+                       seconds,
+                       seconds > 0. ? static_cast<double>(nTotal) / seconds : 0.,
+                       fOutputFile));
+}
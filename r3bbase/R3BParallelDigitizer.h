@@ -0,0 +1,118 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BPARALLELDIGITIZER_H
+#define R3BPARALLELDIGITIZER_H 1
+
+#include <TRandom3.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TClonesArray;
+
+/**
+ * Digitization of one detector in one worker thread of R3BParallelDigitizer.
+ *
+ * Each thread has its own worker, which may therefore keep state between
+ * events. Objects shared by the workers, e.g. parameter containers, must only
+ * be read. All random numbers have to be drawn from the generator given to the
+ * worker factory.
+ */
+class R3BDigitizingWorker
+{
+  public:
+    R3BDigitizingWorker() = default;
+    virtual ~R3BDigitizingWorker() = default;
+    R3BDigitizingWorker(const R3BDigitizingWorker&) = delete;
+    R3BDigitizingWorker(R3BDigitizingWorker&&) = delete;
+    R3BDigitizingWorker& operator=(const R3BDigitizingWorker&) = delete;
+    R3BDigitizingWorker& operator=(R3BDigitizingWorker&&) = delete;
+
+    /** Fills the (empty) output array with the digitized input of one event. */
+    virtual void Digitize(const TClonesArray& input, TClonesArray& output) = 0;
+};
+
+/**
+ * Event-parallel digitization of simulated point branches, outside of FairRunAna.
+ *
+ * The input tree is split into batches of fBatchSize consecutive events. The
+ * batches are digitized on fNThreads worker threads, while the main thread
+ * reads the next block of batches and writes the digitized events in their
+ * original order. Each detector has its own TRandom3 per thread, which is
+ * seeded with GetBatchSeed() at the beginning of every batch. The output hence
+ * depends only on the seed and the batch size, and is identical for any number
+ * of threads.
+ *
+ * The output file contains the output branches in the same entries as the
+ * input events together with a branch list and the file header of the input,
+ * so that it can be added as a friend to R3BFileSource2.
+ *
+ *     auto digitizer = R3BParallelDigitizer("sim.root", "digi.root");
+ *     digitizer.SetNThreads(8);
+ *     digitizer.AddDetector("NeulandPoints", "NeulandHits", "R3BNeulandHit",
+ *                           [&](TRandom3& rnd) { return std::make_unique<MyWorker>(rnd); });
+ *     digitizer.Run();
+ */
+class R3BParallelDigitizer
+{
+  public:
+    /** Creates the worker of one detector for one thread. Called on the main thread before the event loop. */
+    using WorkerFactory = std::function<std::unique_ptr<R3BDigitizingWorker>(TRandom3& rnd)>;
+
+    R3BParallelDigitizer(std::string inputFile, std::string outputFile);
+    ~R3BParallelDigitizer();
+    R3BParallelDigitizer(const R3BParallelDigitizer&) = delete;
+    R3BParallelDigitizer(R3BParallelDigitizer&&) = delete;
+    R3BParallelDigitizer& operator=(const R3BParallelDigitizer&) = delete;
+    R3BParallelDigitizer& operator=(R3BParallelDigitizer&&) = delete;
+
+    void AddDetector(std::string inputBranch, std::string outputBranch, std::string outputClass, WorkerFactory factory);
+
+    /** 0 uses all hardware threads. */
+    void SetNThreads(unsigned int nThreads) { fNThreads = nThreads; }
+    /** Number of consecutive events digitized with one random stream. Changes the output. */
+    void SetBatchSize(unsigned int nEvents) { fBatchSize = nEvents > 0 ? nEvents : 1; }
+    void SetSeed(uint64_t seed) { fSeed = seed; }
+
+    /** Digitizes the first nEvents of the input tree, all of them for nEvents <= 0. */
+    void Run(int64_t nEvents = 0);
+
+    /** Non-zero 32 bit seed of the TRandom3 of one detector in one batch. */
+    static auto GetBatchSeed(uint64_t seed, int64_t batch, size_t detector) -> uint32_t;
+
+  private:
+    struct Detector
+    {
+        std::string inputBranch;
+        std::string outputBranch;
+        std::string outputClass;
+        WorkerFactory factory;
+    };
+
+    struct Event;
+    struct Block;
+    class ThreadPool;
+
+    std::string fInputFile;
+    std::string fOutputFile;
+    std::vector<Detector> fDetectors;
+    unsigned int fNThreads = 1;
+    unsigned int fBatchSize = 100;
+    uint64_t fSeed = 1;
+};
+
+#endif // R3BPARALLELDIGITIZER_H
@@ -0,0 +1,143 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BShardedHistograms.h"
+#include "R3BException.h"
+
+#include "TH1.h"
+#include "TH2.h"
+#include "TROOT.h"
+
+R3BShardedHistograms::R3BShardedHistograms(std::chrono::milliseconds interval)
+    : fInterval(interval)
+    , fLastMerge(std::chrono::steady_clock::now())
+{
+    // TH1::Clone streams the histogram, which needs the thread safety of ROOT once the shards of several threads are
+    // created. It is enabled here, before any shard exists, as it must not be enabled while other threads use ROOT.
+    ROOT::EnableThreadSafety();
+}
+
+R3BShardedHistograms::~R3BShardedHistograms() = default;
+
+auto R3BShardedHistograms::Add(TH1* published) -> std::size_t
+{
+    if (published == nullptr)
+    {
+        throw R3B::logic_error("R3BShardedHistograms: Histogram is a nullptr");
+    }
+    auto lock = std::lock_guard{ fShardsMutex };
+    for (auto& [thread, shard] : fShards)
+    {
+        auto shardLock = std::lock_guard{ shard->mutex };
+        auto& histogram = shard->histograms.emplace_back(static_cast<TH1*>(published->Clone()));
+        histogram->SetDirectory(nullptr);
+        histogram->Reset();
+    }
+    fPublished.push_back(published);
+    return fPublished.size() - 1;
+}
+
+auto R3BShardedHistograms::MakeShard() const -> std::unique_ptr<Shard>
+{
+    auto shard = std::make_unique<Shard>();
+    shard->histograms.reserve(fPublished.size());
+    for (const auto* published : fPublished)
+    {
+        auto& histogram = shard->histograms.emplace_back(static_cast<TH1*>(published->Clone()));
+        histogram->SetDirectory(nullptr);
+        histogram->Reset();
+    }
+    return shard;
+}
+
+auto R3BShardedHistograms::GetFiller() -> Filler
+{
+    auto lock = std::lock_guard{ fShardsMutex };
+    auto& shard = fShards[std::this_thread::get_id()];
+    if (!shard)
+    {
+        shard = MakeShard();
+    }
+    return Filler{ *shard };
+}
+
+void R3BShardedHistograms::Merge()
+{
+    auto lock = std::lock_guard{ fShardsMutex };
+    for (auto& [thread, shard] : fShards)
+    {
+        auto shardLock = std::lock_guard{ shard->mutex };
+        for (std::size_t id = 0; id < fPublished.size(); ++id)
+        {
+            auto& histogram = shard->histograms[id];
+            if (histogram->GetEntries() > 0)
+            {
+                fPublished[id]->Add(histogram.get());
+                histogram->Reset();
+            }
+        }
+    }
+    fLastMerge = std::chrono::steady_clock::now();
+}
+
+auto R3BShardedHistograms::MergeIfDue() -> bool
+{
+    if (std::chrono::steady_clock::now() - fLastMerge < fInterval)
+    {
+        return false;
+    }
+    Merge();
+    return true;
+}
+
+void R3BShardedHistograms::Reset()
+{
+    auto lock = std::lock_guard{ fShardsMutex };
+    for (auto& [thread, shard] : fShards)
+    {
+        auto shardLock = std::lock_guard{ shard->mutex };
+        for (auto& histogram : shard->histograms)
+        {
+            histogram->Reset();
+        }
+    }
+}
+
+auto R3BShardedHistograms::GetNShards() const -> std::size_t
+{
+    auto lock = std::lock_guard{ fShardsMutex };
+    return fShards.size();
+}
+
+R3BShardedHistograms::Filler::Filler(Shard& shard)
+    : fShard(&shard)
+    , fLock(shard.mutex)
+{
+}
+
+void R3BShardedHistograms::Filler::Fill(std::size_t id, Double_t x)
+{
+    fShard->histograms[id]->Fill(x);
+}
+
+void R3BShardedHistograms::Filler::Fill(std::size_t id, Double_t x, Double_t value)
+{
+    // TH2 overrides the virtual TH1::Fill(x, weight) with Fill(x, y)
+    fShard->histograms[id]->Fill(x, value);
+}
+
+void R3BShardedHistograms::Filler::Fill(std::size_t id, Double_t x, Double_t y, Double_t weight)
+{
+    static_cast<TH2*>(fShard->histograms[id].get())->Fill(x, y, weight);
+}
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BSHARDEDHISTOGRAMS_H
+#define R3BSHARDEDHISTOGRAMS_H 1
+
+#include <RtypesCore.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class TH1;
+
+/**
+ * Thread-local shards of the histograms of an online task.
+ *
+ * The histograms published by the task, e.g. registered at the THttpServer of
+ * FairRunOnline, are only modified on the main thread by Merge(). Event
+ * processing on any thread fills private copies (shards) of them, without
+ * touching the published objects:
+ *
+ *     // Init(), main thread
+ *     fHistograms.SetInterval(std::chrono::milliseconds(500));
+ *     fEnergyId = fHistograms.Add(fh1_energy);
+ *
+ *     // any thread, the shard of the thread is locked by the filler
+ *     auto filler = fHistograms.GetFiller();
+ *     filler.Fill(fEnergyId, energy);
+ *
+ *     // FinishEvent(), main thread
+ *     fHistograms.MergeIfDue();
+ *
+ * A filler holds the lock of its shard until it is destroyed and should be
+ * kept for all fills of one event. A thread must not hold more than one
+ * filler, and the main thread must release its filler before merging.
+ * Merge() adds the shards to the published histograms and resets them, so
+ * that the published spectra always contain complete events.
+ *
+ * The constructor enables the thread safety of ROOT, so the object has to be
+ * created before other threads use ROOT, e.g. as a member of the task.
+ */
+class R3BShardedHistograms
+{
+  public:
+    class Filler;
+
+    explicit R3BShardedHistograms(std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+    ~R3BShardedHistograms();
+    R3BShardedHistograms(const R3BShardedHistograms&) = delete;
+    R3BShardedHistograms(R3BShardedHistograms&&) = delete;
+    R3BShardedHistograms& operator=(const R3BShardedHistograms&) = delete;
+    R3BShardedHistograms& operator=(R3BShardedHistograms&&) = delete;
+
+    /** Registers a published histogram (TH1 or TH2 of any type). Returns its id for Filler::Fill. */
+    auto Add(TH1* published) -> std::size_t;
+
+    /** Locks the shard of the calling thread for filling, creates it for a new thread. */
+    auto GetFiller() -> Filler;
+
+    /** Adds the content of all shards to the published histograms and resets the shards. Main thread only. */
+    void Merge();
+
+    /** Calls Merge() if the interval has passed since the last merge. Returns true if merged. */
+    auto MergeIfDue() -> bool;
+
+    /** Discards the content of all shards not merged yet, e.g. when the published histograms are reset. */
+    void Reset();
+
+    void SetInterval(std::chrono::milliseconds interval) { fInterval = interval; }
+    [[nodiscard]] auto GetNHistograms() const -> std::size_t { return fPublished.size(); }
+    [[nodiscard]] auto GetNShards() const -> std::size_t;
+
+  private:
+    struct Shard
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<TH1>> histograms; // same order as fPublished
+    };
+
+    std::vector<TH1*> fPublished;
+    std::unordered_map<std::thread::id, std::unique_ptr<Shard>> fShards;
+    mutable std::mutex fShardsMutex; // protects fShards and fPublished
+    std::chrono::milliseconds fInterval;
+    std::chrono::steady_clock::time_point fLastMerge;
+
+    auto MakeShard() const -> std::unique_ptr<Shard>;
+};
+
+class R3BShardedHistograms::Filler
+{
+  public:
+    // Same meaning as TH1::Fill of the registered histogram: (x, weight) for a TH1, (x, y) for a TH2
+    void Fill(std::size_t id, Double_t x);
+    void Fill(std::size_t id, Double_t x, Double_t value);
+    void Fill(std::size_t id, Double_t x, Double_t y, Double_t weight);
+
+  private:
+    friend class R3BShardedHistograms;
+    explicit Filler(Shard& shard);
+
+    Shard* fShard;
+    std::unique_lock<std::mutex> fLock;
+};
+
+#endif // R3BSHARDEDHISTOGRAMS_H
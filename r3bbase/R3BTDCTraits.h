@@ -0,0 +1,137 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BTDCTRAITS_H
+#define R3BTDCTRAITS_H 1
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Compile-time properties of the TDC modules used in R3B.
+ *
+ * Each module type carries its clock frequency, the number of clock cycles
+ * of its coarse counter and the direction of its fine time. The coarse time
+ * stitch between two modules only depends on these traits, so that it can be
+ * evaluated without any lookup:
+ *
+ *     auto dt = R3B::TDC::Stitch<R3B::TDC::Tamex, R3B::TDC::Vftx>(t1 - t2);
+ *
+ * R3BCoarseTimeStitch and R3BTCalEngine take their constants from here.
+ */
+namespace R3B::TDC
+{
+    // Fine time is counted forwards from the last clock edge or backwards from the next one
+    enum class FineTime
+    {
+        forward,
+        backward
+    };
+
+    struct Tamex
+    {
+        static constexpr unsigned int coarse_range = 2048;
+        static constexpr double clock_MHz = 200.;
+        static constexpr FineTime fine_time = FineTime::backward;
+    };
+
+    struct Trb
+    {
+        static constexpr unsigned int coarse_range = 2048;
+        static constexpr double clock_MHz = 200.;
+        static constexpr FineTime fine_time = FineTime::backward;
+    };
+
+    struct Vftx
+    {
+        static constexpr unsigned int coarse_range = 8192;
+        static constexpr double clock_MHz = 200.;
+        static constexpr FineTime fine_time = FineTime::backward;
+    };
+
+    // R3BTCalEngine::CTDC_8_12_FWD_250
+    struct ClockTDC
+    {
+        static constexpr unsigned int coarse_range = 4096;
+        static constexpr double clock_MHz = 250.;
+        static constexpr FineTime fine_time = FineTime::forward;
+    };
+
+    // R3BTCalEngine::CTDC_16_BWD_150
+    struct ClockTDC150
+    {
+        static constexpr unsigned int coarse_range = 4096;
+        static constexpr double clock_MHz = 150.;
+        static constexpr FineTime fine_time = FineTime::backward;
+    };
+
+    // No coarse counter, the times are not stitched
+    struct Tacquila
+    {
+        static constexpr unsigned int coarse_range = 0;
+        static constexpr double clock_MHz = 40.002903;
+        static constexpr FineTime fine_time = FineTime::backward;
+    };
+
+    // Clock cycle in [ns]
+    template <typename TDC>
+    inline constexpr double clock_ns = 1000. / TDC::clock_MHz;
+
+    // Range of the coarse counter in [ns]
+    template <typename TDC>
+    inline constexpr double range_ns = TDC::coarse_range * 1000. / TDC::clock_MHz;
+
+    // Period in [ns] over which times of the two modules are folded
+    template <typename TDC1, typename TDC2 = TDC1>
+    inline constexpr double stitch_range_ns = std::min(range_ns<TDC1>, range_ns<TDC2>);
+
+    // Larger range of the two modules, shifts the argument of the fold to positive values
+    template <typename TDC1, typename TDC2 = TDC1>
+    inline constexpr double stitch_shift_ns = std::max(range_ns<TDC1>, range_ns<TDC2>);
+
+    /**
+     * Folds a time difference into [-range / 2, range / 2), range being the
+     * smaller coarse counter range of the two modules.
+     */
+    template <typename TDC1, typename TDC2 = TDC1>
+    [[nodiscard]] inline auto Stitch(double time) -> double
+    {
+        constexpr auto range = stitch_range_ns<TDC1, TDC2>;
+        static_assert(range > 0., "TDC module without coarse counter");
+        return std::fmod(time + stitch_shift_ns<TDC1, TDC2> + range / 2., range) - range / 2.;
+    }
+
+    /**
+     * Stitch() over an array of finite times, input and output may be the same.
+     * The fold truncates through a 32 bit integer instead of calling fmod, which
+     * has no branches and lets the compiler vectorize the loop already with SSE2.
+     * It agrees with Stitch() up to rounding, except for times within rounding
+     * of the fold boundary.
+     */
+    template <typename TDC1, typename TDC2 = TDC1>
+    inline void Stitch(const double* input, double* output, std::size_t size)
+    {
+        constexpr auto range = stitch_range_ns<TDC1, TDC2>;
+        constexpr auto shift = stitch_shift_ns<TDC1, TDC2>;
+        static_assert(range > 0., "TDC module without coarse counter");
+        for (std::size_t idx = 0; idx < size; ++idx)
+        {
+            const auto shifted = input[idx] + shift + range / 2.;
+            output[idx] = shifted - range * static_cast<std::int32_t>(shifted / range) - range / 2.;
+        }
+    }
+} // namespace R3B::TDC
+
+#endif /* R3BTDCTRAITS_H */
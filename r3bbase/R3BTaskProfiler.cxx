@@ -0,0 +1,449 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BTaskProfiler.h"
+#include "R3BLogger.h"
+
+#include <FairRootManager.h>
+#include <FairRun.h>
+#include <FairRunOnline.h>
+#include <TClonesArray.h>
+#include <TFile.h>
+#include <TH1D.h>
+#include <THttpServer.h>
+#include <TList.h>
+#include <TObjString.h>
+#include <TString.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fmt/format.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define R3B_HAS_MALLINFO2 1
+#endif
+
+namespace
+{
+    constexpr Int_t NRateBins = 300;
+
+    int64_t ThreadCpuTime()
+    {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    int64_t HeapInUse()
+    {
+#ifdef R3B_HAS_MALLINFO2
+        const auto info = mallinfo2();
+        return static_cast<int64_t>(info.uordblks + info.hblkhd);
+#else
+        return 0;
+#endif
+    }
+
+    double SumEntries(const std::vector<TClonesArray*>& arrays)
+    {
+        double entries = 0.;
+        for (const auto* array : arrays)
+        {
+            entries += array->GetEntriesFast();
+        }
+        return entries;
+    }
+
+    // Bar histogram with one labelled bin per task
+    std::unique_ptr<TH1D> MakeTaskHistogram(const char* name, const char* title, const std::vector<TString>& labels)
+    {
+        const auto nBins = static_cast<Int_t>(std::max<size_t>(labels.size(), 1));
+        auto hist = std::make_unique<TH1D>(name, title, nBins, 0., nBins);
+        hist->SetDirectory(nullptr);
+        hist->SetStats(kFALSE);
+        for (Int_t bin = 0; bin < static_cast<Int_t>(labels.size()); bin++)
+        {
+            hist->GetXaxis()->SetBinLabel(bin + 1, labels[bin]);
+        }
+        return hist;
+    }
+} // namespace
+
+// ---- R3BProfiledTask -------------------------------------------------------
+
+R3BProfiledTask::R3BProfiledTask()
+    : FairTask("R3BProfiledTask", 0)
+{
+}
+
+R3BProfiledTask::R3BProfiledTask(FairTask* task, R3BTaskProfiler* profiler, Int_t index)
+    : FairTask(TString("Profiled_") + task->GetName(), 0)
+    , fTask(task)
+    , fProfiler(profiler)
+    , fIndex(index)
+{
+    Add(task);
+}
+
+InitStatus R3BProfiledTask::Init()
+{
+    // the wrapped task is initialised right after this, i.e. it registers the branches from here on
+    auto* list = FairRootManager::Instance()->GetBranchNameList();
+    fFirstBranch = list ? list->GetEntries() : 0;
+    return kSUCCESS;
+}
+
+void R3BProfiledTask::ExecuteTasks(Option_t* option)
+{
+    if (!fProfiler->IsEnabled())
+    {
+        FairTask::ExecuteTasks(option);
+        return;
+    }
+
+    const auto start = fProfiler->Start();
+    FairTask::ExecuteTasks(option);
+    fProfiler->Stop(fIndex, start);
+}
+
+// ---- R3BTaskProfiler -------------------------------------------------------
+
+void R3BTaskProfiler::Totals::Add(const Totals& other)
+{
+    nEvents += other.nEvents;
+    wall += other.wall;
+    cpu += other.cpu;
+    heap += other.heap;
+    entriesIn += other.entriesIn;
+    entriesOut += other.entriesOut;
+}
+
+R3BTaskProfiler::R3BTaskProfiler()
+    : R3BTaskProfiler("R3BTaskProfiler", 1)
+{
+}
+
+R3BTaskProfiler::R3BTaskProfiler(const TString& name, Int_t iVerbose)
+    : FairTask(name, iVerbose)
+{
+}
+
+R3BTaskProfiler::~R3BTaskProfiler() = default;
+
+void R3BTaskProfiler::Instrument(FairRun* run)
+{
+    R3BLOG_IF(fatal, !run, "FairRun not found.");
+    Instrument(run->GetMainTask());
+}
+
+void R3BTaskProfiler::Instrument(FairTask* mainTask)
+{
+    R3BLOG_IF(fatal, !mainTask, "Main task not found.");
+    R3BLOG_IF(fatal, !fProfiles.empty(), "Task chain is already instrumented.");
+
+    auto* list = mainTask->GetListOfTasks();
+    for (auto* link = list->FirstLink(); link; link = link->Next())
+    {
+        auto* task = dynamic_cast<FairTask*>(link->GetObject());
+        if (!task || task == this || dynamic_cast<R3BProfiledTask*>(task))
+        {
+            continue;
+        }
+        auto* proxy = new R3BProfiledTask(task, this, static_cast<Int_t>(fProfiles.size()));
+        link->SetObject(proxy);
+
+        auto& stat = fProfiles.emplace_back();
+        stat.proxy = proxy;
+        stat.name = task->GetName();
+    }
+
+    // inputs of tasks which are still unknown go back to fPendingInputs
+    auto pending = std::exchange(fPendingInputs, {});
+    for (const auto& [taskName, branchName] : pending)
+    {
+        AddInputBranch(taskName, branchName);
+    }
+
+    // the profiler has to be the last task, see Init()
+    list->Remove(this);
+    mainTask->Add(this);
+    R3BLOG(info, fmt::format("Profiling {} task(s)", fProfiles.size()));
+}
+
+void R3BTaskProfiler::AddInputBranch(const TString& taskName, const TString& branchName)
+{
+    auto stat =
+        std::find_if(fProfiles.begin(), fProfiles.end(), [&](const auto& task) { return task.name == taskName; });
+    if (stat == fProfiles.end())
+    {
+        // not instrumented yet
+        fPendingInputs.emplace_back(taskName, branchName);
+        return;
+    }
+    stat->inputNames.push_back(branchName);
+}
+
+InitStatus R3BTaskProfiler::Init()
+{
+    R3BLOG(info, "");
+    auto* mgr = FairRootManager::Instance();
+    R3BLOG_IF(fatal, !mgr, "FairRootManager not found.");
+
+    for (const auto& [taskName, branchName] : fPendingInputs)
+    {
+        R3BLOG(warn, "Task " << taskName << " is not profiled, input branch " << branchName << " ignored.");
+    }
+
+    // The wrappers are initialised in order and the profiler is the last task of the chain, hence the branches
+    // registered by task i are those between the first branches of the wrappers i and i + 1.
+    auto* branches = mgr->GetBranchNameList();
+    const Int_t nBranches = branches ? branches->GetEntries() : 0;
+    for (size_t idx = 0; idx < fProfiles.size(); idx++)
+    {
+        auto& stat = fProfiles[idx];
+        const auto last = idx + 1 < fProfiles.size() ? fProfiles[idx + 1].proxy->GetFirstBranch() : nBranches;
+        for (auto bIdx = stat.proxy->GetFirstBranch(); bIdx < last; bIdx++)
+        {
+            auto* name = dynamic_cast<TObjString*>(branches->At(bIdx));
+            auto* array = name ? dynamic_cast<TClonesArray*>(mgr->GetObject(name->GetName())) : nullptr;
+            if (array)
+            {
+                stat.outputs.push_back(array);
+            }
+        }
+
+        for (const auto& branchName : stat.inputNames)
+        {
+            auto* array = dynamic_cast<TClonesArray*>(mgr->GetObject(branchName));
+            R3BLOG_IF(warn, !array, "Input branch " << branchName << " of " << stat.name << " not found.");
+            if (array)
+            {
+                stat.inputs.push_back(array);
+            }
+        }
+    }
+
+    CreateHistograms();
+
+    if (auto* run = FairRunOnline::Instance(); run && run->GetHttpServer())
+    {
+        auto* server = run->GetHttpServer();
+        for (auto* hist : GetSummaryHistograms())
+        {
+            server->Register("/TaskProfiler", hist);
+        }
+        for (auto& stat : fProfiles)
+        {
+            server->Register("/TaskProfiler/WallTime", stat.hWallTime.get());
+        }
+    }
+
+    R3BLOG_IF(warn, fHeapTracking && HeapInUse() == 0, "Heap tracking needs glibc 2.33 or newer.");
+    fStartTime = Clock::now();
+    fIntervalTime = fStartTime;
+    return kSUCCESS;
+}
+
+R3BTaskProfiler::Sample R3BTaskProfiler::Start() const
+{
+    auto sample = Sample{};
+    if (fHeapTracking)
+    {
+        sample.heap = HeapInUse();
+    }
+    sample.cpu = ThreadCpuTime();
+    sample.wall = Clock::now();
+    return sample;
+}
+
+void R3BTaskProfiler::Stop(Int_t index, const Sample& start)
+{
+    const auto wallEnd = Clock::now();
+    const auto cpuEnd = ThreadCpuTime();
+    auto& stat = fProfiles[index];
+
+    const auto wall = std::chrono::duration<double, std::micro>(wallEnd - start.wall).count();
+    stat.interval.nEvents++;
+    stat.interval.wall += wall;
+    stat.interval.cpu += 1e-3 * static_cast<double>(cpuEnd - start.cpu);
+    if (fHeapTracking)
+    {
+        stat.interval.heap += static_cast<double>(HeapInUse() - start.heap);
+    }
+    stat.interval.entriesIn += SumEntries(stat.inputs);
+    stat.interval.entriesOut += SumEntries(stat.outputs);
+    stat.hWallTime->Fill(wall);
+}
+
+void R3BTaskProfiler::Exec(Option_t* /*option*/)
+{
+    if (!fEnabled)
+    {
+        return;
+    }
+    fNEvents++;
+    if (++fNIntervalEvents >= fUpdateInterval)
+    {
+        Update();
+    }
+}
+
+void R3BTaskProfiler::CreateHistograms()
+{
+    auto labels = std::vector<TString>{};
+    labels.reserve(fProfiles.size());
+    for (const auto& stat : fProfiles)
+    {
+        labels.push_back(stat.name);
+    }
+
+    fhWallTime = MakeTaskHistogram("TaskWallTime", "Mean wall time per event;;#mus", labels);
+    fhCpuTime = MakeTaskHistogram("TaskCpuTime", "Mean CPU time per event;;#mus", labels);
+    fhHeap = MakeTaskHistogram("TaskHeapGrowth", "Mean heap growth per event;;bytes", labels);
+    fhEntriesIn = MakeTaskHistogram("TaskEntriesIn", "Mean input entries per event", labels);
+    fhEntriesOut = MakeTaskHistogram("TaskEntriesOut", "Mean output entries per event", labels);
+
+    fhEventRate = std::make_unique<TH1D>(
+        "EventRate", Form("Event rate of the last %d updates;update;events/s", NRateBins), NRateBins, 0., NRateBins);
+    fhEventRate->SetDirectory(nullptr);
+    fhEventRate->SetStats(kFALSE);
+
+    // log binning from 0.1 us to 10 s
+    constexpr Int_t nBins = 140;
+    auto edges = std::vector<double>(nBins + 1);
+    for (Int_t bin = 0; bin <= nBins; bin++)
+    {
+        edges[bin] = std::pow(10., -1. + 8. * bin / nBins);
+    }
+    for (auto& stat : fProfiles)
+    {
+        stat.hWallTime = std::make_unique<TH1D>(
+            "WallTime_" + stat.name, "Wall time of " + stat.name + ";#mus;events", nBins, edges.data());
+        stat.hWallTime->SetDirectory(nullptr);
+    }
+}
+
+std::vector<TH1D*> R3BTaskProfiler::GetSummaryHistograms() const
+{
+    return {
+        fhWallTime.get(), fhCpuTime.get(), fhHeap.get(), fhEntriesIn.get(), fhEntriesOut.get(), fhEventRate.get()
+    };
+}
+
+void R3BTaskProfiler::Update()
+{
+    const auto now = Clock::now();
+    const auto seconds = std::chrono::duration<double>(now - fIntervalTime).count();
+
+    // rolling window: shift the event rate by one update
+    for (Int_t bin = 1; bin < NRateBins; bin++)
+    {
+        fhEventRate->SetBinContent(bin, fhEventRate->GetBinContent(bin + 1));
+    }
+    fhEventRate->SetBinContent(NRateBins, seconds > 0. ? static_cast<double>(fNIntervalEvents) / seconds : 0.);
+
+    for (size_t idx = 0; idx < fProfiles.size(); idx++)
+    {
+        auto& stat = fProfiles[idx];
+        const auto bin = static_cast<Int_t>(idx + 1);
+        const auto nEvents = std::max<double>(static_cast<double>(stat.interval.nEvents), 1.);
+        fhWallTime->SetBinContent(bin, stat.interval.wall / nEvents);
+        fhCpuTime->SetBinContent(bin, stat.interval.cpu / nEvents);
+        fhHeap->SetBinContent(bin, stat.interval.heap / nEvents);
+        fhEntriesIn->SetBinContent(bin, stat.interval.entriesIn / nEvents);
+        fhEntriesOut->SetBinContent(bin, stat.interval.entriesOut / nEvents);
+        stat.total.Add(stat.interval);
+        stat.interval = Totals{};
+    }
+
+    fNIntervalEvents = 0;
+    fIntervalTime = now;
+}
+
+void R3BTaskProfiler::Finish()
+{
+    if (fNIntervalEvents > 0)
+    {
+        Update();
+    }
+    PrintSummary();
+    WriteDumpFile();
+}
+
+void R3BTaskProfiler::PrintSummary() const
+{
+    const auto seconds = std::chrono::duration<double>(Clock::now() - fStartTime).count();
+    auto sumWall = 0.;
+    for (const auto& stat : fProfiles)
+    {
+        sumWall += stat.total.wall;
+    }
+
+    auto table = fmt::format("{} events in {:.1f} s ({:.1f} events/s)\n",
+                             fNEvents,
+                             seconds,
+                             seconds > 0. ? static_cast<double>(fNEvents) / seconds : 0.);
+    table += fmt::format("{:<40} {:>12} {:>12} {:>7} {:>12} {:>10} {:>10}\n",
+                         "task",
+                         "wall [us]",
+                         "cpu [us]",
+                         "share",
+                         "heap [B]",
+                         "in",
+                         "out");
+    for (const auto& stat : fProfiles)
+    {
+        const auto nEvents = std::max<double>(static_cast<double>(stat.total.nEvents), 1.);
+        table += fmt::format("{:<40} {:>12.2f} {:>12.2f} {:>6.1f}% {:>12.0f} {:>10.2f} {:>10.2f}\n",
+                             stat.name.Data(),
+                             stat.total.wall / nEvents,
+                             stat.total.cpu / nEvents,
+                             sumWall > 0. ? 100. * stat.total.wall / sumWall : 0.,
+                             stat.total.heap / nEvents,
+                             stat.total.entriesIn / nEvents,
+                             stat.total.entriesOut / nEvents);
+    }
+    R3BLOG(info, "Task profile:\n" << table);
+}
+
+void R3BTaskProfiler::WriteDumpFile() const
+{
+    if (fDumpFile.IsNull())
+    {
+        return;
+    }
+
+    auto file = std::unique_ptr<TFile>(TFile::Open(fDumpFile, "RECREATE"));
+    if (!file || file->IsZombie())
+    {
+        R3BLOG(error, "Cannot open the dump file " << fDumpFile);
+        return;
+    }
+    for (auto* hist : GetSummaryHistograms())
+    {
+        hist->Write();
+    }
+    auto* dir = file->mkdir("WallTime");
+    dir->cd();
+    for (const auto& stat : fProfiles)
+    {
+        stat.hWallTime->Write();
+    }
+    file->Close();
+    R3BLOG(info, "Task profile written to " << fDumpFile);
+}
+
+ClassImp(R3BProfiledTask);
+ClassImp(R3BTaskProfiler);
@@ -0,0 +1,179 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BTASKPROFILER_H
+#define R3BTASKPROFILER_H 1
+
+#include "FairTask.h"
+#include <Rtypes.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class FairRun;
+class TClonesArray;
+class TH1D;
+class R3BTaskProfiler;
+
+/**
+ * Transparent wrapper around one task of the main task list, created by
+ * R3BTaskProfiler::Instrument(). The wrapped task is its only sub-task, hence
+ * SetParContainers, Init, ReInit, FinishEvent and Finish are forwarded by
+ * FairTask itself and only the execution of the sub-task tree is timed.
+ */
+class R3BProfiledTask : public FairTask
+{
+  public:
+    R3BProfiledTask();
+    R3BProfiledTask(FairTask* task, R3BTaskProfiler* profiler, Int_t index);
+    ~R3BProfiledTask() override = default;
+
+    void ExecuteTasks(Option_t* option) override;
+
+    FairTask* GetTask() const { return fTask; }
+    Int_t GetFirstBranch() const { return fFirstBranch; }
+
+  protected:
+    InitStatus Init() override;
+
+  private:
+    FairTask* fTask = nullptr;            //! owned by the list of sub-tasks
+    R3BTaskProfiler* fProfiler = nullptr; //!
+    Int_t fIndex = -1;                    //!
+    Int_t fFirstBranch = 0;               //! size of the branch list before the wrapped task was initialised
+
+  public:
+    ClassDefOverride(R3BProfiledTask, 0)
+};
+
+/**
+ * Event-rate and per-task timing of a task chain.
+ *
+ * For every task of the main task list the wall time, the CPU time of the
+ * thread, the heap growth (optional) and the entries of its input and output
+ * TClonesArrays are recorded for each event. Output arrays are the branches
+ * registered by the task in its Init, input arrays have to be declared with
+ * AddInputBranch(). Every fUpdateInterval events the means over the last
+ * interval and the event rate are filled into summary histograms, which are
+ * registered to the THttpServer of FairRunOnline (folder TaskProfiler) and
+ * written to the dump file at the end of the run together with the per-task
+ * wall time distributions. A summary table is printed in Finish.
+ *
+ * Usage, after the last AddTask() and before run->Init():
+ *
+ *     auto profiler = new R3BTaskProfiler();
+ *     profiler->SetDumpFile("task_profile.root");
+ *     profiler->Instrument(run);
+ *
+ * Without Instrument() nothing is measured, and SetEnabled(false) reduces the
+ * cost of an instrumented chain to one branch per task and event. Since the
+ * tasks are moved into wrappers, FairRun::GetTask() does not find them anymore
+ * after Instrument().
+ */
+class R3BTaskProfiler : public FairTask
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Sample
+    {
+        Clock::time_point wall;
+        int64_t cpu = 0;  // ns
+        int64_t heap = 0; // bytes
+    };
+
+    R3BTaskProfiler();
+    explicit R3BTaskProfiler(const TString& name, Int_t iVerbose = 1);
+    ~R3BTaskProfiler() override;
+
+    /** Wraps all tasks of the main task list and appends the profiler itself. */
+    void Instrument(FairRun* run);
+    void Instrument(FairTask* mainTask);
+
+    void SetEnabled(bool enabled) { fEnabled = enabled; }
+    bool IsEnabled() const { return fEnabled; }
+
+    /** Number of events over which the summary histograms are averaged. */
+    void SetUpdateInterval(UInt_t nEvents) { fUpdateInterval = nEvents > 0 ? nEvents : 1; }
+    /** Heap growth from mallinfo2(), which walks all malloc arenas and is therefore off by default. */
+    void SetHeapTracking(bool enabled) { fHeapTracking = enabled; }
+    void SetDumpFile(const TString& fileName) { fDumpFile = fileName; }
+    void AddInputBranch(const TString& taskName, const TString& branchName);
+    /** Input branches of tasks which are not profiled, reported in Init(). */
+    size_t GetNPendingInputs() const { return fPendingInputs.size(); }
+
+    InitStatus Init() override;
+    void Exec(Option_t* option) override;
+    void Finish() override;
+
+    Sample Start() const;
+    void Stop(Int_t index, const Sample& start);
+
+  private:
+    struct Totals
+    {
+        uint64_t nEvents = 0;
+        double wall = 0.; // us
+        double cpu = 0.;  // us
+        double heap = 0.; // bytes
+        double entriesIn = 0.;
+        double entriesOut = 0.;
+
+        void Add(const Totals& other);
+    };
+
+    struct TaskStat
+    {
+        R3BProfiledTask* proxy = nullptr;
+        TString name;
+        std::vector<TString> inputNames;
+        std::vector<TClonesArray*> inputs;
+        std::vector<TClonesArray*> outputs;
+        Totals interval;
+        Totals total;
+        std::unique_ptr<TH1D> hWallTime;
+    };
+
+    bool fEnabled = true;
+    bool fHeapTracking = false;
+    UInt_t fUpdateInterval = 1000;
+    TString fDumpFile;
+    std::vector<TaskStat> fProfiles;                         //!
+    std::vector<std::pair<TString, TString>> fPendingInputs; //!
+
+    uint64_t fNEvents = 0;
+    uint64_t fNIntervalEvents = 0;
+    Clock::time_point fStartTime;    //!
+    Clock::time_point fIntervalTime; //!
+
+    std::unique_ptr<TH1D> fhWallTime;   //!
+    std::unique_ptr<TH1D> fhCpuTime;    //!
+    std::unique_ptr<TH1D> fhHeap;       //!
+    std::unique_ptr<TH1D> fhEntriesIn;  //!
+    std::unique_ptr<TH1D> fhEntriesOut; //!
+    std::unique_ptr<TH1D> fhEventRate;  //!
+
+    void CreateHistograms();
+    std::vector<TH1D*> GetSummaryHistograms() const;
+    void Update();
+    void PrintSummary() const;
+    void WriteDumpFile() const;
+
+  public:
+    ClassDefOverride(R3BTaskProfiler, 0)
+};
+
+#endif // R3BTASKPROFILER_H
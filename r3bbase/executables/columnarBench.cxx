@@ -0,0 +1,175 @@
+#include "R3BColumnarBranch.h"
+#include "R3BShared.h"
+#include "TBranchElement.h"
+#include "TClonesArray.h"
+#include "TFile.h"
+#include "TStopwatch.h"
+#include "TTree.h"
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    auto Split(const std::string& list) -> std::vector<std::string>
+    {
+        auto items = std::vector<std::string>{};
+        auto stream = std::istringstream{ list };
+        for (auto item = std::string{}; std::getline(stream, item, ',');)
+        {
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    void PrintRead(std::string_view name, int64_t nEvents, TStopwatch& timer)
+    {
+        fmt::print("{0:<28} {1:>10.3f} s {2:>12.0f} events/s\n",
+                   name,
+                   timer.RealTime(),
+                   static_cast<double>(nEvents) / timer.RealTime());
+    }
+} // namespace
+
+// Compares file size and read throughput of TClonesArray branches with their columnar form of R3BColumnarBranch.
+// The columnar file is written from the input file and can be used as input of R3BFileSource2::AddColumnarFile.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of columnar data files" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()(
+        "inputFile", po::value<std::string>()->default_value("digi.root"), "set the filename of the input");
+    desc.add_options()(
+        "outputFile", po::value<std::string>()->default_value("columnar.root"), "set the filename of columnar output");
+    desc.add_options()("branches",
+                       po::value<std::string>()->default_value("NeulandHits"),
+                       "set comma separated names of TClonesArray branches");
+    desc.add_options()("columns",
+                       po::value<std::string>()->default_value(""),
+                       R"(set comma separated columns for a partial read, e.g. "fT,fE")");
+    desc.add_options()("treeName", po::value<std::string>()->default_value("evt"), "set the name of the input tree");
+    desc.add_options()("eventNum,n", po::value<int>()->default_value(0), "set total event number (0: all)");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "columnarBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    auto const inputFileName = varMap["inputFile"].as<std::string>();
+    auto const outputFileName = varMap["outputFile"].as<std::string>();
+    auto const treeName = varMap["treeName"].as<std::string>();
+    auto const eventNum = varMap["eventNum"].as<int>();
+
+    auto const branchNames = Split(varMap["branches"].as<std::string>());
+    auto inputFile = R3B::make_rootfile(inputFileName.c_str(), "READ");
+    auto* inputTree = inputFile->Get<TTree>(treeName.c_str());
+    if (inputTree == nullptr || branchNames.empty())
+    {
+        std::cerr << "columnarBench: No tree " << treeName << " or no branches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto nEvents = static_cast<int64_t>(inputTree->GetEntries());
+    if (eventNum > 0)
+    {
+        nEvents = std::min(nEvents, static_cast<int64_t>(eventNum));
+    }
+
+    // addresses of the arrays must not move after SetBranchAddress
+    auto arrays = std::vector<TClonesArray*>(branchNames.size(), nullptr);
+    auto columnar = std::vector<R3BColumnarBranch>{};
+    auto inputZipBytes = Long64_t{};
+    auto inputTotBytes = Long64_t{};
+    inputTree->SetBranchStatus("*", false);
+    for (std::size_t idx = 0; idx < branchNames.size(); ++idx)
+    {
+        auto* branch = dynamic_cast<TBranchElement*>(inputTree->GetBranch(branchNames[idx].c_str()));
+        if (branch == nullptr || std::string_view{ branch->GetClonesName() }.empty())
+        {
+            std::cerr << "columnarBench: " << branchNames[idx] << " is not a TClonesArray branch" << std::endl;
+            return EXIT_FAILURE;
+        }
+        inputZipBytes += branch->GetZipBytes("*");
+        inputTotBytes += branch->GetTotBytes("*");
+        arrays[idx] = new TClonesArray(branch->GetClonesName()); // NOLINT
+        inputTree->SetBranchStatus(fmt::format("{}*", branchNames[idx]).c_str(), true);
+        inputTree->SetBranchAddress(branchNames[idx].c_str(), &arrays[idx]);
+        columnar.emplace_back(branchNames[idx], branch->GetClonesName());
+    }
+
+    // TClonesArray reading, then conversion
+    auto timer = TStopwatch{};
+    timer.Start();
+    for (int64_t entry = 0; entry < nEvents; ++entry)
+    {
+        inputTree->GetEntry(entry);
+    }
+    timer.Stop();
+    auto readTimer = timer;
+
+    {
+        auto outputFile = R3B::make_rootfile(outputFileName.c_str(), "RECREATE");
+        auto* outputTree = new TTree(R3B::Columnar::TreeName, "R3B columnar data"); // NOLINT owned by outputFile
+        outputTree->SetDirectory(outputFile.get());
+        for (auto& branch : columnar)
+        {
+            branch.CreateColumns(*outputTree);
+        }
+        for (int64_t entry = 0; entry < nEvents; ++entry)
+        {
+            inputTree->GetEntry(entry);
+            for (std::size_t idx = 0; idx < columnar.size(); ++idx)
+            {
+                columnar[idx].Fill(*arrays[idx]);
+            }
+            outputTree->Fill();
+        }
+        outputFile->cd();
+        outputTree->Write();
+        R3BColumnarBranch::WriteBranchList(columnar);
+
+        fmt::print("{0} events of {1}\n\n", nEvents, fmt::join(branchNames, ", "));
+        fmt::print("{0:<28} {1:>14} {2:>14}\n", "size", "compressed", "uncompressed");
+        fmt::print("{0:<28} {1:>12} B {2:>12} B\n", "TClonesArray branches", inputZipBytes, inputTotBytes);
+        fmt::print(
+            "{0:<28} {1:>12} B {2:>12} B\n", "columnar", outputTree->GetZipBytes(), outputTree->GetTotBytes());
+        fmt::print("\n");
+    }
+
+    PrintRead("read TClonesArray", nEvents, readTimer);
+
+    auto const readColumnar = [&](std::string_view name, const std::vector<std::string>& columns)
+    {
+        auto reader = R3BColumnarReader{ outputFileName, columns };
+        timer.Start();
+        for (int64_t entry = 0; entry < nEvents; ++entry)
+        {
+            reader.ReadEvent(entry);
+        }
+        timer.Stop();
+        PrintRead(name, nEvents, timer);
+    };
+    readColumnar("read columnar, all columns", {});
+    if (auto const columns = Split(varMap["columns"].as<std::string>()); !columns.empty())
+    {
+        readColumnar(fmt::format("read columnar, {} columns", columns.size()), columns);
+    }
+    return 0;
+}
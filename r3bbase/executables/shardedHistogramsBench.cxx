@@ -0,0 +1,181 @@
+#include "R3BShardedHistograms.h"
+#include "TH1F.h"
+#include "TH2F.h"
+#include "TRandom3.h"
+#include <atomic>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fmt/format.h>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Spectra
+    {
+        std::vector<std::unique_ptr<TH1>> histograms;
+        std::vector<bool> is2D;
+    };
+
+    auto MakeSpectra(int nHistograms, const char* prefix) -> Spectra
+    {
+        auto spectra = Spectra{};
+        for (int idx = 0; idx < nHistograms; ++idx)
+        {
+            auto name = fmt::format("{}_{}", prefix, idx);
+            // one third 2D, like the energy correlations of the online tasks
+            if (idx % 3 == 2)
+            {
+                spectra.histograms.push_back(std::make_unique<TH2F>(name.c_str(), "", 200, 0., 1., 200, 0., 1.));
+                spectra.is2D.push_back(true);
+            }
+            else
+            {
+                spectra.histograms.push_back(std::make_unique<TH1F>(name.c_str(), "", 1000, 0., 1.));
+                spectra.is2D.push_back(false);
+            }
+            spectra.histograms.back()->SetDirectory(nullptr);
+        }
+        return spectra;
+    }
+
+    void Print(std::string_view name, int64_t nEvents, double seconds, double triggerRate)
+    {
+        const auto rate = static_cast<double>(nEvents) / seconds;
+        fmt::print("{0:<24} {1:>10.3f} s {2:>12.0f} events/s {3:>8.2f} x {4:.0f} Hz\n",
+                   name,
+                   seconds,
+                   rate,
+                   rate / triggerRate,
+                   triggerRate);
+    }
+} // namespace
+
+// Event rate of the online spectra filled directly on the main thread and through R3BShardedHistograms
+// on several threads. The published histograms are merged on the main thread at the given interval,
+// as FinishEvent of an online task would do between the requests of the THttpServer.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of sharded online histograms" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("histograms", po::value<int>()->default_value(300), "set number of histograms");
+    desc.add_options()("fills", po::value<int>()->default_value(200), "set number of fills per event");
+    desc.add_options()("eventNum,n", po::value<int>()->default_value(200000), "set number of events");
+    desc.add_options()("threads,t", po::value<int>()->default_value(8), "set maximum number of filling threads");
+    desc.add_options()("interval", po::value<int>()->default_value(500), "set merge interval in ms");
+    desc.add_options()("rate", po::value<double>()->default_value(50000.), "set trigger rate to compare with in Hz");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "shardedHistogramsBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto nHistograms = varMap["histograms"].as<int>();
+    const auto nFills = varMap["fills"].as<int>();
+    const auto eventNum = varMap["eventNum"].as<int>();
+    const auto threadNum = varMap["threads"].as<int>();
+    const auto interval = varMap["interval"].as<int>();
+    const auto triggerRate = varMap["rate"].as<double>();
+
+    const auto nEvents = static_cast<int64_t>(eventNum);
+    const auto fillEvent = [&](auto&& fill, const Spectra& spectra, TRandom3& rnd)
+    {
+        for (int idx = 0; idx < nFills; ++idx)
+        {
+            const auto id = static_cast<std::size_t>(rnd.Integer(nHistograms));
+            if (spectra.is2D[id])
+            {
+                fill(id, rnd.Rndm(), rnd.Rndm());
+            }
+            else
+            {
+                fill(id, rnd.Rndm());
+            }
+        }
+    };
+
+    fmt::print("{0} events, {1} fills per event into {2} histograms\n\n", nEvents, nFills, nHistograms);
+
+    {
+        auto spectra = MakeSpectra(nHistograms, "direct");
+        auto rnd = TRandom3{ 1 };
+        const auto start = std::chrono::steady_clock::now();
+        for (int64_t event = 0; event < nEvents; ++event)
+        {
+            fillEvent([&](std::size_t id, auto... values) { spectra.histograms[id]->Fill(values...); }, spectra, rnd);
+        }
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Print("direct, main thread", nEvents, seconds, triggerRate);
+    }
+
+    for (int nThreads = 1; nThreads <= threadNum; nThreads *= 2)
+    {
+        auto spectra = MakeSpectra(nHistograms, fmt::format("sharded{}", nThreads).c_str());
+        auto histograms = R3BShardedHistograms{ std::chrono::milliseconds(interval) };
+        for (auto& histogram : spectra.histograms)
+        {
+            histograms.Add(histogram.get());
+        }
+
+        auto nextEvent = std::atomic<int64_t>{ 0 };
+        auto nRunning = std::atomic<int>{ nThreads };
+        auto nMerges = 0;
+        const auto start = std::chrono::steady_clock::now();
+        auto threads = std::vector<std::thread>{};
+        for (int thread = 0; thread < nThreads; ++thread)
+        {
+            threads.emplace_back(
+                [&, thread]()
+                {
+                    auto rnd = TRandom3{ static_cast<UInt_t>(thread + 1) };
+                    for (auto event = nextEvent++; event < nEvents; event = nextEvent++)
+                    {
+                        auto filler = histograms.GetFiller();
+                        fillEvent([&](std::size_t id, auto... values) { filler.Fill(id, values...); }, spectra, rnd);
+                    }
+                    --nRunning;
+                });
+        }
+        while (nRunning > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            nMerges += histograms.MergeIfDue() ? 1 : 0;
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        histograms.Merge();
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Print(fmt::format("sharded, {} threads", nThreads), nEvents, seconds, triggerRate);
+
+        auto entries = 0.;
+        for (auto& histogram : spectra.histograms)
+        {
+            entries += histogram->GetEntries();
+        }
+        if (static_cast<int64_t>(entries) != nEvents * nFills)
+        {
+            fmt::print(stderr, "shardedHistogramsBench: {} entries published, {} filled\n", entries, nEvents * nFills);
+            return EXIT_FAILURE;
+        }
+        fmt::print("{0:<24} {1:>10} merges\n", "", nMerges + 1);
+    }
+    return 0;
+}
@@ -0,0 +1,168 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BCalifaClusterData.h"
+#include "R3BColumnarBranch.h"
+#include "R3BException.h"
+#include "R3BNeulandHit.h"
+#include "gtest/gtest.h"
+#include <TClonesArray.h>
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+    constexpr auto FileName = "testColumnarBranch.root";
+    constexpr int NEvents = 20;
+
+    auto MakeHit(int event, int index) -> R3BNeulandHit
+    {
+        const auto value = 10. * event + index;
+        const auto position = TVector3{ value, -value, 2. * value };
+        const auto pixel = TVector3{ 1., 2., 3. };
+        return R3BNeulandHit(event + index,
+                             value + 0.1, // NOLINT
+                             value + 0.2, // NOLINT
+                             value + 0.3, // NOLINT
+                             value + 0.4, // NOLINT
+                             value + 0.5, // NOLINT
+                             value + 0.6, // NOLINT
+                             position,
+                             pixel);
+    }
+
+    void WriteFile()
+    {
+        auto file = R3B::make_rootfile(FileName, "RECREATE");
+        auto* tree = new TTree(R3B::Columnar::TreeName, "test"); // NOLINT
+        tree->SetDirectory(file.get());
+        auto branches = std::vector<R3BColumnarBranch>{};
+        branches.emplace_back("NeulandHits", "R3BNeulandHit");
+        branches.front().CreateColumns(*tree);
+
+        auto hits = TClonesArray{ "R3BNeulandHit" };
+        for (int event = 0; event < NEvents; ++event)
+        {
+            hits.Clear();
+            for (int index = 0; index < event % 4; ++index)
+            {
+                new (hits[index]) R3BNeulandHit(MakeHit(event, index));
+            }
+            branches.front().Fill(hits);
+            tree->Fill();
+        }
+        file->cd();
+        tree->Write();
+        R3BColumnarBranch::WriteBranchList(branches);
+    }
+
+    TEST(testColumnarBranch, columns)
+    {
+        auto branch = R3BColumnarBranch{ "NeulandHits", "R3BNeulandHit" };
+        auto const names = branch.GetColumnNames();
+        EXPECT_NE(std::find(names.begin(), names.end(), "NeulandHits.fPaddle"), names.end());
+        EXPECT_NE(std::find(names.begin(), names.end(), "NeulandHits.fPosition.fZ"), names.end());
+        EXPECT_EQ(std::find(names.begin(), names.end(), "NeulandHits.fUniqueID"), names.end());
+        EXPECT_THROW(R3BColumnarBranch("NeulandHits", "std::string"), R3B::logic_error);
+    }
+
+    TEST(testColumnarBranch, read_all_columns)
+    {
+        WriteFile();
+        auto reader = R3BColumnarReader{ FileName };
+        ASSERT_EQ(reader.GetEntries(), NEvents);
+        auto* hits = reader.GetArray("NeulandHits");
+        ASSERT_NE(hits, nullptr);
+
+        for (int event = 0; event < NEvents; ++event)
+        {
+            ASSERT_TRUE(reader.ReadEvent(event));
+            ASSERT_EQ(hits->GetEntriesFast(), event % 4);
+            for (int index = 0; index < event % 4; ++index)
+            {
+                const auto& hit = *static_cast<R3BNeulandHit*>(hits->At(index));
+                const auto expected = MakeHit(event, index);
+                EXPECT_EQ(hit.GetPaddle(), expected.GetPaddle());
+                EXPECT_EQ(hit.GetT(), expected.GetT());
+                EXPECT_EQ(hit.GetE(), expected.GetE());
+                EXPECT_EQ(hit.GetPosition(), expected.GetPosition());
+                EXPECT_EQ(hit.GetPixel(), expected.GetPixel());
+            }
+        }
+        EXPECT_FALSE(reader.ReadEvent(NEvents));
+        std::remove(FileName);
+    }
+
+    TEST(testColumnarBranch, read_selected_columns)
+    {
+        WriteFile();
+        auto reader = R3BColumnarReader{ FileName, { "fE", "NeulandHits.fPaddle" } };
+        auto* hits = reader.GetArray("NeulandHits");
+
+        ASSERT_TRUE(reader.ReadEvent(7));
+        ASSERT_EQ(hits->GetEntriesFast(), 3);
+        for (int index = 0; index < 3; ++index)
+        {
+            const auto& hit = *static_cast<R3BNeulandHit*>(hits->At(index));
+            EXPECT_EQ(hit.GetPaddle(), MakeHit(7, index).GetPaddle());
+            EXPECT_EQ(hit.GetE(), MakeHit(7, index).GetE());
+        }
+        std::remove(FileName);
+    }
+
+    TEST(testColumnarBranch, restore_resets_members_without_column)
+    {
+        // the crystal list of R3BCalifaClusterData is a std::vector and has no column
+        auto branch = R3BColumnarBranch{ "CalifaClusterData", "R3BCalifaClusterData" };
+        auto clusters = TClonesArray{ "R3BCalifaClusterData" };
+        for (int index = 0; index < 3; ++index)
+        {
+            new (clusters[index]) R3BCalifaClusterData({ 1, 2, 3 }, 10. * index, 0., 0., 0.5, 1.5, 100, 1);
+        }
+        auto tree = TTree{ "columns", "test" };
+        tree.SetDirectory(nullptr);
+        branch.CreateColumns(tree);
+        branch.Fill(clusters);
+
+        // the objects of the previous event are still in the array
+        branch.Restore(clusters);
+        ASSERT_EQ(clusters.GetEntriesFast(), 3);
+        for (int index = 0; index < 3; ++index)
+        {
+            const auto& cluster = *static_cast<R3BCalifaClusterData*>(clusters.At(index));
+            EXPECT_EQ(cluster.GetEnergy(), 10. * index);
+            EXPECT_EQ(cluster.GetTheta(), 0.5);
+            EXPECT_EQ(cluster.GetTime(), 100U);
+            EXPECT_TRUE(cluster.GetCrystalList().empty());
+        }
+    }
+
+    TEST(testColumnarBranch, reader_keeps_current_directory)
+    {
+        WriteFile();
+        gROOT->cd();
+        auto* const directory = gDirectory;
+        {
+            auto reader = R3BColumnarReader{ FileName };
+            EXPECT_EQ(gDirectory, directory);
+            ASSERT_TRUE(reader.ReadEvent(3));
+            EXPECT_EQ(gDirectory, directory);
+        }
+        EXPECT_EQ(gDirectory, directory);
+        std::remove(FileName);
+    }
+} // namespace
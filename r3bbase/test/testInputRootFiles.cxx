@@ -0,0 +1,113 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BFileSource2.h"
+#include "gtest/gtest.h"
+#include <FairRootManager.h>
+#include <TFile.h>
+#include <TFolder.h>
+#include <TList.h>
+#include <TObjString.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const auto BranchNames = std::vector<std::string>{ "NeulandPoints", "NeulandHits" };
+
+    void WriteList(const char* listName, const std::vector<std::string>& names)
+    {
+        auto list = TList{};
+        list.SetOwner(true);
+        for (const auto& name : names)
+        {
+            list.Add(new TObjString(name.c_str())); // NOLINT
+        }
+        list.Write(listName, TObject::kSingleKey);
+    }
+
+    // Only the objects of an output file of FairRootManager the validation looks at
+    void WriteFile(const std::string& fileName, const std::vector<std::string>& branchNames, bool hasFolder = true)
+    {
+        auto file = R3B::make_rootfile(fileName.c_str(), "RECREATE");
+        if (hasFolder)
+        {
+            TFolder folder{ FairRootManager::GetFolderName(), "main folder" };
+            folder.Write();
+        }
+        WriteList("BranchList", branchNames);
+        WriteList("TimeBasedBranchList", {});
+    }
+
+    class testInputRootFiles : public ::testing::Test
+    {
+      protected:
+        void SetUp() override
+        {
+            for (int idx = 0; idx < 6; ++idx)
+            {
+                fileNames_.push_back("testInputRootFiles_" + std::to_string(idx) + ".root");
+            }
+            WriteFile(fileNames_[0], BranchNames);
+            WriteFile(fileNames_[1], BranchNames);
+            WriteFile(fileNames_[2], { "NeulandPoints" });
+            WriteFile(fileNames_[3], BranchNames);
+            WriteFile(fileNames_[4], BranchNames, false);
+            WriteFile(fileNames_[5], BranchNames);
+        }
+
+        void TearDown() override
+        {
+            for (const auto& fileName : fileNames_)
+            {
+                std::remove(fileName.c_str());
+            }
+        }
+
+        std::vector<std::string> fileNames_; // NOLINT
+    };
+
+    TEST_F(testInputRootFiles, concurrent_validation_rejects_same_files)
+    {
+        // serial path: one file after the other
+        auto serialFiles = R3BInputRootFiles{};
+        auto serialRejected = R3BInputRootFiles::Strings{};
+        for (const auto& fileName : fileNames_)
+        {
+            if (auto res = serialFiles.AddFileName(fileName); res.has_value())
+            {
+                serialRejected.push_back(res.value());
+            }
+        }
+        EXPECT_EQ(serialRejected, (R3BInputRootFiles::Strings{ fileNames_[2], fileNames_[4] }));
+
+        auto concurrentFiles = R3BInputRootFiles{};
+        const auto concurrentRejected = concurrentFiles.AddFileNames(fileNames_, true);
+        EXPECT_EQ(concurrentRejected, serialRejected);
+        EXPECT_EQ(concurrentFiles.GetFileNames(), serialFiles.GetFileNames());
+
+        auto defaultFiles = R3BInputRootFiles{};
+        EXPECT_EQ(defaultFiles.AddFileNames(fileNames_), serialRejected);
+        EXPECT_EQ(defaultFiles.GetFileNames(), serialFiles.GetFileNames());
+    }
+
+    TEST_F(testInputRootFiles, first_file_defines_branch_list)
+    {
+        auto files = R3BInputRootFiles{};
+        const auto rejected = files.AddFileNames({ fileNames_[2], fileNames_[0], fileNames_[4], fileNames_[1] }, true);
+        EXPECT_EQ(rejected, (R3BInputRootFiles::Strings{ fileNames_[0], fileNames_[4], fileNames_[1] }));
+        EXPECT_EQ(files.GetFileNames(), (R3BInputRootFiles::Strings{ fileNames_[2] }));
+        EXPECT_EQ(files.GetBranchListRef(), (R3BInputRootFiles::Strings{ "NeulandPoints" }));
+    }
+} // namespace
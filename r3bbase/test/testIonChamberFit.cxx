@@ -0,0 +1,196 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BIonChamberFit.h"
+#include "TDecompSVD.h"
+#include "TMath.h"
+#include "TMatrixD.h"
+#include "TRandom3.h"
+#include "TSpline.h"
+#include "TVectorD.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    constexpr auto NAnodes = 16;
+
+    // Straight-line fit of the Cal2Hit tasks before the closed form
+    void SvdFit(std::vector<double> pos, std::vector<double> dt, double& offset, double& slope)
+    {
+        const auto size = static_cast<Int_t>(pos.size());
+        TVectorD posZ;
+        posZ.Use(size, pos.data());
+        TMatrixD A(size, 2);
+        TMatrixDColumn(A, 0) = 1.0;
+        TMatrixDColumn(A, 1) = posZ;
+        TDecompSVD svd(A);
+        Bool_t ok = kFALSE;
+        TVectorD dt_r;
+        dt_r.Use(size, dt.data());
+        TVectorD c_svd_r = svd.Solve(dt_r, ok);
+        offset = c_svd_r[0];
+        slope = c_svd_r[1];
+    }
+
+    auto AnodePositions() -> std::vector<double>
+    {
+        // TWIM like, anodes of 25 mm far away from z = 0
+        auto pos = std::vector<double>(NAnodes);
+        for (Int_t j = 0; j < NAnodes; j++)
+        {
+            pos[j] = 1812.5 + 25. * j;
+        }
+        return pos;
+    }
+
+    TEST(testIonChamberFit, LineFitAsSVD)
+    {
+        const auto pos = AnodePositions();
+        auto fit = R3B::IonChamber::LineFit<NAnodes>{};
+        fit.SetPositions(pos.data(), pos.size());
+
+        auto rnd = TRandom3{ 4551 };
+        for (Int_t event = 0; event < 1000; event++)
+        {
+            const auto slope = rnd.Uniform(-0.05, 0.05);
+            const auto offset = rnd.Uniform(-60., 60.) - slope * pos[7];
+            auto good_pos = std::vector<double>{};
+            auto good_dt = std::vector<double>{};
+            fit.Clear();
+            for (Int_t j = 0; j < NAnodes; j++)
+            {
+                if (rnd.Uniform() < 0.2)
+                {
+                    continue; // anode not in use
+                }
+                const auto dt = offset + slope * pos[j] + rnd.Gaus(0., 0.3);
+                good_pos.push_back(pos[j]);
+                good_dt.push_back(dt);
+                fit.Add(j, dt);
+            }
+            if (good_pos.size() < 3)
+            {
+                continue;
+            }
+            auto svdOffset = 0.;
+            auto svdSlope = 0.;
+            SvdFit(good_pos, good_dt, svdOffset, svdSlope);
+
+            auto fitOffset = 0.;
+            auto fitSlope = 0.;
+            ASSERT_TRUE(fit.Solve(fitOffset, fitSlope));
+            EXPECT_EQ(fit.GetN(), good_pos.size());
+            EXPECT_NEAR(fitSlope, svdSlope, 1e-12);
+            EXPECT_NEAR(fitOffset, svdOffset, 1e-8 * std::abs(svdOffset) + 1e-9);
+        }
+    }
+
+    TEST(testIonChamberFit, WeightsAndFailures)
+    {
+        const auto pos = AnodePositions();
+        auto fit = R3B::IonChamber::LineFit<NAnodes>{};
+        fit.SetPositions(pos.data(), pos.size());
+        auto twice = fit;
+
+        const double dt[3] = { 1., 2.5, 3. };
+        for (Int_t j = 0; j < 3; j++)
+        {
+            fit.Add(j, dt[j], 2.);
+            twice.Add(j, dt[j]);
+            twice.Add(j, dt[j]);
+        }
+        auto offset = 0.;
+        auto slope = 0.;
+        auto offset2 = 0.;
+        auto slope2 = 0.;
+        ASSERT_TRUE(fit.Solve(offset, slope));
+        ASSERT_TRUE(twice.Solve(offset2, slope2));
+        EXPECT_NEAR(slope, slope2, 1e-14);
+        EXPECT_NEAR(offset, offset2, 1e-10);
+
+        // a missing drift time gives NaN, as the SVD did
+        fit.Add(4, std::numeric_limits<double>::quiet_NaN());
+        ASSERT_TRUE(fit.Solve(offset, slope));
+        EXPECT_TRUE(std::isnan(slope));
+        EXPECT_TRUE(std::isnan(offset));
+
+        // one position only, the result is left untouched
+        fit.Clear();
+        fit.Add(5, 1.);
+        fit.Add(5, 2.);
+        offset = -5000.;
+        slope = -5000.;
+        EXPECT_FALSE(fit.Solve(offset, slope));
+        EXPECT_EQ(offset, -5000.);
+        EXPECT_EQ(slope, -5000.);
+    }
+
+    TEST(testIonChamberFit, PolynomialAsPower)
+    {
+        const Float_t par[5] = { 1.2f, 0.35f, 1.7e-3f, -2.1e-5f, 4.3e-8f };
+        for (auto ene = 0.; ene < 5000.; ene += 7.3)
+        {
+            // R3BTwimCal2Hit::S4551
+            const auto zhit = par[0] + par[1] * TMath::Sqrt(ene) + par[2] * ene +
+                              par[3] * TMath::Power(ene, 3. / 2.) + par[4] * TMath::Power(ene, 2.);
+            EXPECT_NEAR(R3B::IonChamber::Polynomial(std::sqrt(ene), par, 5), zhit, 1e-12 * (1. + std::abs(zhit)));
+        }
+        EXPECT_EQ(R3B::IonChamber::Polynomial(2., par, 0), 0.);
+        EXPECT_TRUE(std::isnan(R3B::IonChamber::Polynomial(std::sqrt(-1.), par, 3)));
+    }
+
+    void ExpectSameAsTSpline3(TSpline3& spline)
+    {
+        const auto tabulated = R3B::IonChamber::Spline{ spline };
+        ASSERT_EQ(tabulated.GetNp(), spline.GetNp());
+        const auto xmin = spline.GetXmin();
+        const auto xmax = spline.GetXmax();
+        // including the extrapolation and the knots themselves
+        for (auto x = xmin - 20.; x <= xmax + 20.; x += (xmax - xmin) / 997.)
+        {
+            EXPECT_NEAR(tabulated.Eval(x), spline.Eval(x), 1e-9) << "x = " << x;
+        }
+        for (Int_t k = 0; k < spline.GetNp(); k++)
+        {
+            Double_t x = 0., y = 0., b = 0., c = 0., d = 0.;
+            spline.GetCoeff(k, x, y, b, c, d);
+            EXPECT_NEAR(tabulated.Eval(x), spline.Eval(x), 1e-9) << "knot " << k;
+        }
+    }
+
+    TEST(testIonChamberFit, SplineAsTSpline3)
+    {
+        // energy vs drift time correction, non-equidistant knots
+        auto rnd = TRandom3{ 467 };
+        auto x = std::vector<double>{};
+        auto y = std::vector<double>{};
+        for (auto dt = -60.; dt < 60.; dt += rnd.Uniform(1., 6.))
+        {
+            x.push_back(dt);
+            y.push_back(1500. + 0.8 * dt - 0.02 * dt * dt + rnd.Gaus(0., 3.));
+        }
+        auto spline = TSpline3("spline", x.data(), y.data(), static_cast<Int_t>(x.size()));
+        ExpectSameAsTSpline3(spline);
+
+        // equidistant knots
+        auto equidistant = TSpline3("equidistant", -60., 60., y.data(), 25);
+        ExpectSameAsTSpline3(equidistant);
+
+        const auto empty = R3B::IonChamber::Spline{};
+        EXPECT_TRUE(empty.IsEmpty());
+        EXPECT_TRUE(std::isnan(empty.Eval(0.)));
+    }
+} // namespace
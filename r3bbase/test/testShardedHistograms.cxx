@@ -0,0 +1,127 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BShardedHistograms.h"
+#include "gtest/gtest.h"
+#include <TH1F.h>
+#include <TH2F.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr int NThreads = 4;
+    constexpr int NEvents = 2000;
+
+    auto Value(int thread, int event) -> double { return (thread * NEvents + event) % 100; }
+
+    TEST(testShardedHistograms, parallel_fill_equals_sequential_fill)
+    {
+        auto published1D = TH1F("testShardedHistograms_1D", "", 100, 0., 100.);
+        auto published2D = TH2F("testShardedHistograms_2D", "", 10, 0., 100., 10, 0., 100.);
+        published1D.SetDirectory(nullptr);
+        published2D.SetDirectory(nullptr);
+        auto expected1D = TH1F("testShardedHistograms_expected1D", "", 100, 0., 100.);
+        auto expected2D = TH2F("testShardedHistograms_expected2D", "", 10, 0., 100., 10, 0., 100.);
+        expected1D.SetDirectory(nullptr);
+        expected2D.SetDirectory(nullptr);
+
+        auto histograms = R3BShardedHistograms{};
+        const auto id1D = histograms.Add(&published1D);
+        const auto id2D = histograms.Add(&published2D);
+        EXPECT_EQ(histograms.GetNHistograms(), 2);
+
+        // Shards belong to thread ids, which can be reused once a thread has finished. All threads stay alive until
+        // every one has filled, such that each of them gets its own shard.
+        auto mutex = std::mutex{};
+        auto allFilled = std::condition_variable{};
+        auto nFilled = 0;
+        auto threads = std::vector<std::thread>{};
+        for (int thread = 0; thread < NThreads; ++thread)
+        {
+            threads.emplace_back(
+                [&, thread]()
+                {
+                    for (int event = 0; event < NEvents; ++event)
+                    {
+                        auto filler = histograms.GetFiller();
+                        filler.Fill(id1D, Value(thread, event));
+                        filler.Fill(id1D, Value(thread, event), 2.);
+                        filler.Fill(id2D, Value(thread, event), 99. - Value(thread, event));
+                    }
+                    auto lock = std::unique_lock{ mutex };
+                    ++nFilled;
+                    allFilled.notify_all();
+                    allFilled.wait(lock, [&]() { return nFilled == NThreads; });
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(histograms.GetNShards(), NThreads);
+        // nothing is published before the merge
+        EXPECT_EQ(published1D.GetEntries(), 0.);
+
+        histograms.Merge();
+        for (int thread = 0; thread < NThreads; ++thread)
+        {
+            for (int event = 0; event < NEvents; ++event)
+            {
+                expected1D.Fill(Value(thread, event));
+                expected1D.Fill(Value(thread, event), 2.);
+                expected2D.Fill(Value(thread, event), 99. - Value(thread, event));
+            }
+        }
+        EXPECT_EQ(published1D.GetEntries(), expected1D.GetEntries());
+        EXPECT_EQ(published2D.GetEntries(), expected2D.GetEntries());
+        for (int bin = 0; bin < published1D.GetNcells(); ++bin)
+        {
+            EXPECT_EQ(published1D.GetBinContent(bin), expected1D.GetBinContent(bin)) << "bin " << bin;
+        }
+        for (int bin = 0; bin < published2D.GetNcells(); ++bin)
+        {
+            EXPECT_EQ(published2D.GetBinContent(bin), expected2D.GetBinContent(bin)) << "bin " << bin;
+        }
+
+        // the shards are empty after the merge
+        histograms.Merge();
+        EXPECT_EQ(published1D.GetEntries(), expected1D.GetEntries());
+    }
+
+    TEST(testShardedHistograms, merge_interval_and_reset)
+    {
+        auto published = TH1F("testShardedHistograms_interval", "", 10, 0., 10.);
+        published.SetDirectory(nullptr);
+        auto histograms = R3BShardedHistograms{ std::chrono::hours(1) };
+        const auto id = histograms.Add(&published);
+
+        histograms.GetFiller().Fill(id, 1.);
+        EXPECT_FALSE(histograms.MergeIfDue());
+        EXPECT_EQ(published.GetEntries(), 0.);
+
+        histograms.SetInterval(std::chrono::milliseconds(0));
+        EXPECT_TRUE(histograms.MergeIfDue());
+        EXPECT_EQ(published.GetEntries(), 1.);
+
+        histograms.GetFiller().Fill(id, 2.);
+        histograms.Reset();
+        histograms.Merge();
+        EXPECT_EQ(published.GetEntries(), 1.);
+        EXPECT_EQ(published.GetBinContent(published.FindBin(2.)), 0.);
+    }
+} // namespace
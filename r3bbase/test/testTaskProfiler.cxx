@@ -0,0 +1,42 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BTaskProfiler.h"
+#include "gtest/gtest.h"
+#include <FairTask.h>
+
+namespace
+{
+    TEST(testTaskProfiler, input_of_unknown_task_stays_pending)
+    {
+        // the main task owns all sub-tasks, including the profiler and the wrappers
+        auto mainTask = FairTask("testTaskProfiler_main");
+        mainTask.Add(new FairTask("testTaskProfiler_first"));  // NOLINT
+        mainTask.Add(new FairTask("testTaskProfiler_second")); // NOLINT
+        auto* profiler = new R3BTaskProfiler();                // NOLINT
+        mainTask.Add(profiler);
+
+        profiler->AddInputBranch("testTaskProfiler_first", "NeulandHits");
+        profiler->AddInputBranch("testTaskProfiler_unknown", "NeulandPoints");
+        profiler->AddInputBranch("testTaskProfiler_second", "NeulandClusters");
+        EXPECT_EQ(profiler->GetNPendingInputs(), 3U);
+
+        profiler->Instrument(&mainTask);
+        EXPECT_EQ(profiler->GetNPendingInputs(), 1U);
+
+        // added after the instrumentation
+        profiler->AddInputBranch("testTaskProfiler_first", "NeulandDigis");
+        profiler->AddInputBranch("testTaskProfiler_unknown", "NeulandPrimaryTracks");
+        EXPECT_EQ(profiler->GetNPendingInputs(), 2U);
+    }
+} // namespace
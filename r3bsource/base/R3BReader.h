@@ -46,6 +46,10 @@ class R3BReader : public TNamed
     virtual Bool_t ReInit() { return kTRUE; }
     /* Read data from full event structure */
     virtual Bool_t R3BRead() = 0;
+    /* Whether R3BRead() only touches data owned by this reader, i.e. it may
+     * run concurrently with other readers. Readers which access the event
+     * header or other shared objects must keep the default. */
+    [[nodiscard]] virtual bool IsThreadSafe() const { return false; }
     /* Reset */
     virtual void Reset() = 0;
     /* Return actual name of the reader */
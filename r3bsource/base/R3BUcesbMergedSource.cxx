@@ -0,0 +1,117 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BUcesbMergedSource.h"
+#include <FairRootManager.h>
+#include <R3BEventHeader.h>
+#include <R3BException.h>
+#include <R3BLogger.h>
+#include <fmt/format.h>
+
+namespace R3B
+{
+    UcesbMergedSource::~UcesbMergedSource() = default;
+
+    auto UcesbMergedSource::AddStream(std::unique_ptr<UcesbSource> stream, size_t wr_offset, std::string_view name)
+        -> UcesbSource*
+    {
+        if (stream == nullptr)
+        {
+            throw R3B::logic_error("A stream of the merged ucesb source is a nullptr!");
+        }
+        auto* added = streams_.emplace_back(std::move(stream)).get();
+        merger_.AddStream([added]() { return added->FetchEvent(); },
+                          [added]() { added->ReadFetchedEvent(); },
+                          [added]() -> const void* { return added->GetEventStruct(); },
+                          wr_offset,
+                          name.empty() ? fmt::format("stream {}", streams_.size() - 1) : std::string{ name });
+        return added;
+    }
+
+    bool UcesbMergedSource::Init()
+    {
+        if (streams_.empty())
+        {
+            throw R3B::logic_error("No stream was added to the merged ucesb source!");
+        }
+        ForEachStream(
+            [](FairSource& stream)
+            {
+                if (!stream.Init())
+                {
+                    throw R3B::runtime_error("Init of a ucesb stream failed.");
+                }
+            });
+        return true;
+    }
+
+    bool UcesbMergedSource::InitUnpackers()
+    {
+        if (auto* frm = FairRootManager::Instance(); frm != nullptr)
+        {
+            event_header_ = dynamic_cast<R3BEventHeader*>(frm->GetObject("EventHeader."));
+        }
+        if (event_header_ == nullptr)
+        {
+            throw R3B::runtime_error("EventHeader. was not defined properly!");
+        }
+        ForEachStream([](FairSource& stream) { stream.InitUnpackers(); });
+        R3BLOG(info,
+               fmt::format("Merging {} ucesb streams with a coincidence window of {} ns",
+                           streams_.size(),
+                           merger_.GetCoincidenceWindow()));
+        return true;
+    }
+
+    bool UcesbMergedSource::ReInitUnpackers()
+    {
+        ForEachStream([](FairSource& stream) { stream.ReInitUnpackers(); });
+        return true;
+    }
+
+    void UcesbMergedSource::SetParUnpackers()
+    {
+        ForEachStream([](FairSource& stream) { stream.SetParUnpackers(); });
+    }
+
+    void UcesbMergedSource::Reset()
+    {
+        ForEachStream([](FairSource& stream) { stream.Reset(); });
+    }
+
+    void UcesbMergedSource::FillEventHeader(FairEventHeader* feh)
+    {
+        // all streams belong to the same run
+        static_cast<FairSource&>(*streams_.front()).FillEventHeader(feh);
+    }
+
+    int UcesbMergedSource::CheckMaxEventNo(int EvtEnd)
+    {
+        if (EvtEnd != 0)
+        {
+            merger_.SetMaxEvents(EvtEnd);
+        }
+        return static_cast<int>(merger_.GetMaxEvents());
+    }
+
+    int UcesbMergedSource::ReadEvent(unsigned int /*eventID*/)
+    {
+        if (!merger_.BuildEvent())
+        {
+            // ending event loop here
+            return 1;
+        }
+        event_header_->SetTimeStamp(merger_.GetEventTime());
+        return 0;
+    }
+} // namespace R3B
@@ -0,0 +1,108 @@
+#pragma once
+
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BUcesbEventMerger.h"
+#include "R3BUcesbSource2.h"
+#include <FairSource.h>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class R3BEventHeader;
+
+namespace R3B
+{
+    // Time-ordered event building from several ucesb streams with White Rabbit timestamps.
+    //
+    // Each stream is a complete R3B::UcesbSource with its own ucesb server, event structure and readers, which
+    // must include the White Rabbit reader of the stream (e.g. R3BWhiterabbitCalifaReader). The timestamp of
+    // every fetched event is taken from the White Rabbit block (ID, T1 .. T4) at the given offset of the event
+    // structure and the events are built by R3B::UcesbEventMerger. Only the readers of the streams in an event
+    // read their fetched events, the outputs of all other streams stay empty. The event header gets the time of
+    // the earliest fragment.
+    //
+    //     auto source = std::make_unique<R3BUcesbMergedSource>();
+    //     auto* califa = source->AddStream(std::make_unique<R3BUcesbSource2>(...), offsetof(EXT_STR_h101, wrcalifa));
+    //     califa->AddReader<R3BWhiterabbitCalifaReader>(...);
+    //     source->SetCoincidenceWindow(4000);
+    //
+    // Fragments without timestamp (ID 0) and fragments older than the last built event (late) are dropped.
+    class UcesbMergedSource : public FairSource
+    {
+      public:
+        using Statistics = UcesbEventMerger::Statistics;
+
+        UcesbMergedSource() = default;
+        // rule of five:
+        ~UcesbMergedSource() override;
+        UcesbMergedSource(const UcesbMergedSource&) = delete;
+        UcesbMergedSource(UcesbMergedSource&&) = delete;
+        UcesbMergedSource& operator=(const UcesbMergedSource&) = delete;
+        UcesbMergedSource& operator=(UcesbMergedSource&&) = delete;
+
+        // wr_offset: offset of the White Rabbit block in the event structure of the stream
+        auto AddStream(std::unique_ptr<UcesbSource> stream, size_t wr_offset, std::string_view name = "")
+            -> UcesbSource*;
+
+        // setters:
+        // in White Rabbit time units [ns]
+        void SetCoincidenceWindow(uint64_t window) { merger_.SetCoincidenceWindow(window); }
+        void SetMinFragments(size_t min_fragments) { merger_.SetMinFragments(min_fragments); }
+        void SetMaxEvents(unsigned int max_event_num) { merger_.SetMaxEvents(max_event_num); }
+
+        [[nodiscard]] auto GetStatistics() const -> const Statistics& { return merger_.GetStatistics(); }
+        // indices of the streams contributing to the last built event
+        [[nodiscard]] auto GetEventStreams() const -> const std::vector<size_t>& { return merger_.GetEventStreams(); }
+        void PrintStatistics() const { merger_.PrintStatistics(); }
+
+      private:
+        R3BEventHeader* event_header_ = nullptr; // non-owning
+        std::vector<std::unique_ptr<UcesbSource>> streams_;
+        UcesbEventMerger merger_;
+
+        // private non-virtual methods:
+        template <typename UnaryOp>
+        void ForEachStream(UnaryOp&& opt);
+
+        // private virtual methods:
+        bool Init() override;
+        bool InitUnpackers() override;
+        bool ReInitUnpackers() override;
+        void Close() override { PrintStatistics(); }
+        void SetParUnpackers() override;
+        void Reset() override;
+        void FillEventHeader(FairEventHeader* feh) override;
+        int ReadEvent(unsigned int eventID = 0) override;
+        int CheckMaxEventNo(int EvtEnd = 0) override;
+        bool SpecifyRunId() override { return true; }
+        Source_Type GetSourceType() override { return kONLINE; }
+
+      public:
+        ClassDefInlineOverride(R3B::UcesbMergedSource, 1);
+    };
+
+    template <typename UnaryOp>
+    void UcesbMergedSource::ForEachStream(UnaryOp&& opt)
+    {
+        for (auto& stream : streams_)
+        {
+            // the overrides of UcesbSource are private, FairSource is its interface
+            opt(static_cast<FairSource&>(*stream));
+        }
+    }
+} // namespace R3B
+
+using R3BUcesbMergedSource = R3B::UcesbMergedSource;
@@ -21,10 +21,67 @@
 
 #include "R3BEventHeader.h"
 #include "R3BLogger.h"
+#include "R3BReaderDispatcher.h"
+#include "R3BUcesbEventPrefetcher.h"
 #include "R3BUcesbSource.h"
 
 #include "ext_data_client.h"
 
+#include <cerrno>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    /* popen() for the prefetching, which also provides the process id of the
+     * shell. The shell leads its own process group, such that the prefetching
+     * can be interrupted by killing the group, also if the command is a
+     * pipeline. */
+    FILE* OpenPipe(const std::string& command, pid_t& pid)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            return nullptr;
+        }
+        pid = fork();
+        if (pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return nullptr;
+        }
+        if (pid == 0)
+        {
+            setpgid(0, 0);
+            dup2(fds[1], STDOUT_FILENO);
+            close(fds[0]);
+            close(fds[1]);
+            execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+            _exit(127);
+        }
+        setpgid(pid, pid);
+        close(fds[1]);
+        return fdopen(fds[0], "r");
+    }
+
+    /* pclose() for OpenPipe() */
+    int ClosePipe(FILE* file, pid_t pid)
+    {
+        fclose(file);
+        int status = 0;
+        while (waitpid(pid, &status, 0) == -1)
+        {
+            if (errno != EINTR)
+            {
+                return -1;
+            }
+        }
+        return status;
+    }
+} // namespace
+
 R3BUcesbSource::R3BUcesbSource(const TString& FileName,
                                const TString& NtupleOptions,
                                const TString& UcesbPath,
@@ -32,6 +89,7 @@ R3BUcesbSource::R3BUcesbSource(const TString& FileName,
                                size_t event_size)
     : FairSource()
     , fFd(nullptr)
+    , fUcesbPid(-1)
     , fClient()
     , fStructInfo()
     , fFileName(FileName)
@@ -45,12 +103,16 @@ R3BUcesbSource::R3BUcesbSource(const TString& FileName,
     , fInputFile()
     , fEntryMax(0)
     , fReaders(new TObjArray())
+    , fNReaderThreads(0)
+    , fPrefetchDepth(0)
 {
 }
 
 R3BUcesbSource::~R3BUcesbSource()
 {
     R3BLOG(debug1, "R3BUcesbSource destructor.");
+    // workers must be joined before the readers are deleted
+    fDispatcher.reset();
     if (fReaders)
     {
         fReaders->Delete();
@@ -91,7 +153,20 @@ Bool_t R3BUcesbSource::Init()
     LOG(info) << "Calling ucesb with command: " << command.str();
 
     /* Fork off ucesb (calls fork() and pipe()) */
-    fFd = popen(command.str().c_str(), "r");
+    if (fPrefetchDepth > 0)
+    {
+        if (fNtupleOptions.Contains("RAW"))
+        {
+            R3BLOG(warn, "Raw data printing is not available with event prefetching.");
+        }
+        pid_t pid = -1;
+        fFd = OpenPipe(command.str(), pid);
+        fUcesbPid = pid;
+    }
+    else
+    {
+        fFd = popen(command.str().c_str(), "r");
+    }
     if (nullptr == fFd)
     {
         R3BLOG(fatal, "popen() failed");
@@ -141,13 +216,23 @@ Bool_t R3BUcesbSource::InitUnpackers()
     }
 
     /* Initialize all readers */
+    fReaderList.clear();
+    fReaderList.reserve(fReaders->GetEntriesFast());
     for (int i = 0; i < fReaders->GetEntriesFast(); ++i)
     {
-        if (!(dynamic_cast<R3BReader*>(fReaders->At(i)))->Init(&fStructInfo))
+        auto reader = dynamic_cast<R3BReader*>(fReaders->At(i));
+        if (!reader->Init(&fStructInfo))
         {
             R3BLOG(fatal, "UCESB error: " << fClient.last_error());
             return kFALSE;
         }
+        fReaderList.push_back(reader);
+    }
+
+    if (fNReaderThreads > 0)
+    {
+        fDispatcher = std::make_unique<R3B::ReaderDispatcher>();
+        fDispatcher->Init(fReaderList, fNReaderThreads);
     }
 
     /* Setup client */
@@ -182,6 +267,21 @@ Bool_t R3BUcesbSource::InitUnpackers()
         return kFALSE;
     }
 
+    /* The client is owned by the prefetching thread from here on */
+    if (fPrefetchDepth > 0)
+    {
+        fPrefetcher = std::make_unique<R3B::UcesbEventPrefetcher>(&fClient);
+        fPrefetcher->SetInterrupt(
+            [this]()
+            {
+                if (fUcesbPid > 0)
+                {
+                    kill(-fUcesbPid, SIGTERM);
+                }
+            });
+        fPrefetcher->Start(fEventSize, fPrefetchDepth);
+    }
+
     return kTRUE;
 }
 
@@ -258,7 +358,14 @@ Int_t R3BUcesbSource::ReadEvent(UInt_t i)
     }
 
     /* Fetch data */
-    ret = fClient.fetch_event(fEvent, fEventSize);
+    if (fPrefetcher)
+    {
+        ret = fPrefetcher->Pop(fEvent);
+    }
+    else
+    {
+        ret = fClient.fetch_event(fEvent, fEventSize);
+    }
     if (0 == ret)
     {
         LOG(info) << "End of input";
@@ -268,26 +375,35 @@ Int_t R3BUcesbSource::ReadEvent(UInt_t i)
     {
         perror("ext_data_clnt::fetch_event()");
         R3BLOG(error, "ext_data_clnt::fetch_event() failed");
-        R3BLOG(fatal, "UCESB error: " << fClient.last_error());
+        R3BLOG(fatal, "UCESB error: " << (fPrefetcher ? fPrefetcher->GetLastError() : fClient.last_error()));
         return 0;
     }
 
-    /* Get raw data, if any */
-    ret = fClient.get_raw_data(&raw, &raw_words);
-    if (0 != ret)
+    /* Get raw data, if any. The client belongs to the prefetching thread otherwise. */
+    raw = nullptr;
+    if (!fPrefetcher)
     {
-        perror("ext_data_clnt::get_raw_data()");
-        R3BLOG(fatal, "Failed to get raw data.");
-        return 0;
+        ret = fClient.get_raw_data(&raw, &raw_words);
+        if (0 != ret)
+        {
+            perror("ext_data_clnt::get_raw_data()");
+            R3BLOG(fatal, "Failed to get raw data.");
+            return 0;
+        }
     }
 
     /* Run detector specific readers */
-    for (int r = 0; r < fReaders->GetEntriesFast(); ++r)
+    if (fDispatcher)
     {
-        R3BReader* reader = dynamic_cast<R3BReader*>(fReaders->At(r));
-
-        LOG(debug1) << "  Reading reader " << r << " (" << reader->GetName() << ")";
-        reader->R3BRead();
+        fDispatcher->Dispatch();
+    }
+    else
+    {
+        for (auto reader : fReaderList)
+        {
+            LOG(debug1) << "  Reading reader " << reader->GetName();
+            reader->R3BRead();
+        }
     }
 
     /* Display raw data */
@@ -313,6 +429,17 @@ void R3BUcesbSource::Close()
 {
     int ret;
 
+    if (fDispatcher)
+    {
+        fDispatcher->Stop();
+    }
+    if (fPrefetcher)
+    {
+        // must be finished before the client connection is closed
+        fPrefetcher->Stop();
+        fPrefetcher.reset();
+    }
+
     if (!fFd) // not open
         return;
     /* Close client connection */
@@ -325,7 +452,7 @@ void R3BUcesbSource::Close()
 
     /* Close pipe */
     int status;
-    status = pclose(fFd);
+    status = (fUcesbPid > 0) ? ClosePipe(fFd, fUcesbPid) : pclose(fFd);
     if (-1 == status)
     {
         // perror("pclose()");
@@ -333,6 +460,7 @@ void R3BUcesbSource::Close()
         abort();
     }
     fFd = nullptr;
+    fUcesbPid = -1;
 
     if (fInputFile.is_open())
         fInputFile.close();
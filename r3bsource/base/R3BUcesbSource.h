@@ -29,6 +29,8 @@
 
 #include <fstream>
 #include <list>
+#include <memory>
+#include <vector>
 
 /* External data client interface (ucesb) */
 #include "ext_data_clnt.hh"
@@ -43,6 +45,12 @@ typedef struct EXT_STR_h101_t EXT_STR_h101;
 
 class R3BEventHeader;
 
+namespace R3B
+{
+    class ReaderDispatcher;
+    class UcesbEventPrefetcher;
+} // namespace R3B
+
 class R3BUcesbSource : public FairSource
 {
   public:
@@ -78,9 +86,19 @@ class R3BUcesbSource : public FairSource
 
     void SetInputFileName(TString tstr) { fInputFileName = tstr; }
 
+    /* Run the thread-safe readers on n worker threads (0: serial, default).
+     * Must be called before InitUnpackers(). */
+    void SetNumberOfReaderThreads(UInt_t n) { fNReaderThreads = n; }
+
+    /* Fetch up to n events ahead on a separate thread (0: no prefetching,
+     * default). Raw data printing is not available in this mode. */
+    void SetPrefetchDepth(UInt_t n) { fPrefetchDepth = n; }
+
   private:
-    /* File descriptor returned from popen() */
+    /* File descriptor of the pipe from ucesb */
     FILE* fFd;
+    /* Process id of the ucesb shell, only with prefetching */
+    Int_t fUcesbPid; //!
     /* The ucesb interface class */
     ext_data_clnt fClient;
     /* The ucesb structure info class */
@@ -100,6 +118,14 @@ class R3BUcesbSource : public FairSource
     int fLastEventNo;
     /* The array of readers */
     TObjArray* fReaders;
+    /* Readers resolved once in InitUnpackers() */
+    std::vector<R3BReader*> fReaderList; //!
+    /* Parallel reader execution */
+    UInt_t fNReaderThreads;
+    std::unique_ptr<R3B::ReaderDispatcher> fDispatcher; //!
+    /* Event prefetching */
+    UInt_t fPrefetchDepth;
+    std::unique_ptr<R3B::UcesbEventPrefetcher> fPrefetcher; //!
     /* R3B header */
     R3BEventHeader* fEventHeader;
     Int_t ReadIntFromString(const std::string& wholestr, const std::string& pattern);
@@ -44,7 +44,12 @@ namespace R3B
         return true;
     }
 
-    UcesbSource::~UcesbSource() { ucesb_server_launcher_.Close(); }
+    UcesbSource::~UcesbSource()
+    {
+        // the prefetching thread must not use the client any more
+        event_prefetcher_.Stop();
+        ucesb_server_launcher_.Close();
+    }
 
     void UcesbSource::init_ucesb()
     {
@@ -73,6 +78,17 @@ namespace R3B
         init_readers();
         setup_ucesb();
 
+        if (prefetch_depth_ > 0)
+        {
+            if (has_raw_data_printing_)
+            {
+                R3BLOG(warn, "Raw data printing is not available with event prefetching.");
+                has_raw_data_printing_ = false;
+            }
+            event_prefetcher_.SetInterrupt([this]() { ucesb_server_launcher_.Terminate(); });
+            event_prefetcher_.Start(event_struct_size_, prefetch_depth_);
+        }
+
         return true;
     }
 
@@ -97,25 +113,42 @@ namespace R3B
 
     int UcesbSource::ReadEvent(unsigned int /*eventID*/)
     {
-        auto ret_val = ucesb_client_.fetch_event(event_struct_, event_struct_size_);
-        if (ret_val > 0)
-        {
-            ForEachReader([](auto& reader) { reader->R3BRead(); });
-        }
-        else if (ret_val == 0)
+        if (FetchEvent() == 0)
         {
             R3BLOG(info, "Reached the maximal event num on the ucesb server.");
             // ending event loop here
             return 1;
         }
-        else
+        ReadFetchedEvent();
+        return 0;
+    }
+
+    auto UcesbSource::FetchEvent() -> int
+    {
+        auto ret_val = fetch_event();
+        if (ret_val < 0)
         {
             R3BLOG(error, "ext_data_clnt::fetch_event() failed");
-            const auto* msg = (ucesb_client_.last_error() == nullptr) ? UCESB_NULL_STR_MSG : ucesb_client_.last_error();
+            const auto* msg = event_prefetcher_.IsRunning() ? event_prefetcher_.GetLastError()
+                              : (ucesb_client_.last_error() == nullptr) ? UCESB_NULL_STR_MSG
+                                                                        : ucesb_client_.last_error();
             throw R3B::runtime_error(fmt::format("UCESB error: {}", msg));
         }
+        return ret_val;
+    }
 
-        return 0;
+    void UcesbSource::ReadFetchedEvent()
+    {
+        ForEachReader([](auto& reader) { reader->R3BRead(); });
+    }
+
+    auto UcesbSource::fetch_event() -> int
+    {
+        if (event_prefetcher_.IsRunning())
+        {
+            return event_prefetcher_.Pop(event_struct_);
+        }
+        return ucesb_client_.fetch_event(event_struct_, event_struct_size_);
     }
 
     void print_uint32_with_size(const uint32_t* data, ssize_t size)
@@ -15,6 +15,7 @@
 
 #include "R3BReader.h"
 #include <FairSource.h>
+#include <R3BUcesbEventPrefetcher.h>
 #include <R3BUcesbLauncher.h>
 #include <R3BUcesbMappingFlag.h>
 #include <R3BUcesbStructInfo.h>
@@ -51,6 +52,8 @@ namespace R3B
         void SetEventStruct(EventStructType* event_struct) { event_struct_ = event_struct; }
         void SetRawDataPrint(bool print_raw_data) { has_raw_data_printing_ = print_raw_data; }
         void SetRunID(unsigned int run_id) { run_id_ = run_id; }
+        // number of events fetched ahead of the readers on a separate thread (0: no prefetching)
+        void SetPrefetchDepth(size_t depth) { prefetch_depth_ = depth; }
         void AllowExtraMap(UcesbMap flag) { ucesb_client_struct_info_.SetExtraMapFlags(flag); }
 
         template <typename ReaderType>
@@ -64,6 +67,14 @@ namespace R3B
         template <typename Predicate>
         auto FindReaderIf(Predicate&& pred) -> R3BReader*;
 
+        // Fetching and reading of an event are separate steps for R3B::UcesbMergedSource, which looks at the
+        // timestamp of the fetched event before reading it.
+        // returns the value of ext_data_clnt::fetch_event(): 0 at the end of the data, > 0 otherwise
+        auto FetchEvent() -> int;
+        // all readers read the last fetched event
+        void ReadFetchedEvent();
+        [[nodiscard]] auto GetEventStruct() const -> const EventStructType* { return event_struct_; }
+
         // deprecate the old API because of bad memory managerment
         [[deprecated("Please use smart pointer method to add a reader")]] auto* AddReader(R3BReader* a_reader)
         {
@@ -75,6 +86,7 @@ namespace R3B
         unsigned int run_id_ = 0;
         unsigned int max_event_num_ = 0;
         size_t event_struct_size_ = 0;
+        size_t prefetch_depth_ = 0;
         EventStructType* event_struct_ = nullptr; // non-owning
         R3BEventHeader* event_header_ = nullptr;  // non-owning
         std::vector<std::unique_ptr<R3BReader>> readers_;
@@ -85,6 +97,7 @@ namespace R3B
         ext_data_clnt ucesb_client_;
         UcesbStructInfo ucesb_client_struct_info_;
         UcesbServerLauncher ucesb_server_launcher_ = UcesbServerLauncher{ &ucesb_client_ };
+        UcesbEventPrefetcher event_prefetcher_ = UcesbEventPrefetcher{ &ucesb_client_ };
 
         // private non-virtual methods:
 
@@ -93,6 +106,7 @@ namespace R3B
         void init_ucesb_bp();
         void init_readers();
         void setup_ucesb();
+        auto fetch_event() -> int;
         void print_raw_data();
 
         // private virtual methods:
@@ -0,0 +1,182 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BReaderDispatcher.h"
+#include "R3BReader.h"
+#include <R3BLogger.h>
+#include <TROOT.h>
+#include <fmt/format.h>
+#include <utility>
+
+namespace R3B
+{
+    ReaderDispatcher::~ReaderDispatcher() { Stop(); }
+
+    void ReaderDispatcher::Init(const std::vector<R3BReader*>& readers, unsigned int n_threads)
+    {
+        Stop();
+        serial_readers_.clear();
+        parallel_readers_.clear();
+
+        for (auto* reader : readers)
+        {
+            if (n_threads > 0 && reader->IsThreadSafe())
+            {
+                parallel_readers_.push_back(reader);
+            }
+            else
+            {
+                serial_readers_.push_back(reader);
+            }
+        }
+
+        // a single parallel reader is better executed directly
+        if (parallel_readers_.size() < 2)
+        {
+            serial_readers_ = readers;
+            parallel_readers_.clear();
+            n_threads = 0;
+        }
+
+        if (n_threads > 0)
+        {
+            // TClonesArray and TObject constructors need ROOT's internal locks
+            ROOT::EnableThreadSafety();
+        }
+
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            is_stopping_ = false;
+            generation_ = 0;
+            n_busy_workers_ = 0;
+        }
+        workers_.reserve(n_threads);
+        for (auto idx = 0U; idx < n_threads; ++idx)
+        {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+
+        R3BLOG(info,
+               fmt::format("Reader dispatch with {} worker thread(s): {} parallel and {} serial reader(s)",
+                           workers_.size(),
+                           parallel_readers_.size(),
+                           serial_readers_.size()));
+    }
+
+    void ReaderDispatcher::Dispatch()
+    {
+        if (workers_.empty())
+        {
+            for (auto* reader : serial_readers_)
+            {
+                reader->R3BRead();
+            }
+            return;
+        }
+
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            next_reader_.store(0, std::memory_order_relaxed);
+            n_busy_workers_ = static_cast<unsigned int>(workers_.size());
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        // the calling thread takes care of the serial readers and then helps with the rest
+        try
+        {
+            for (auto* reader : serial_readers_)
+            {
+                reader->R3BRead();
+            }
+        }
+        catch (...)
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            if (not error_)
+            {
+                error_ = std::current_exception();
+            }
+        }
+        run_parallel_readers();
+
+        auto lock = std::unique_lock{ mutex_ };
+        done_cv_.wait(lock, [this]() { return n_busy_workers_ == 0; });
+        if (error_)
+        {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    void ReaderDispatcher::Stop()
+    {
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            is_stopping_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& worker : workers_)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        workers_.clear();
+    }
+
+    void ReaderDispatcher::worker_loop()
+    {
+        // generation_ is reset to zero before the workers are spawned
+        auto seen_generation = uint64_t{};
+        while (true)
+        {
+            {
+                auto lock = std::unique_lock{ mutex_ };
+                start_cv_.wait(lock, [&]() { return is_stopping_ || generation_ != seen_generation; });
+                if (is_stopping_)
+                {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+
+            run_parallel_readers();
+
+            auto lock = std::lock_guard{ mutex_ };
+            if (--n_busy_workers_ == 0)
+            {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+    void ReaderDispatcher::run_parallel_readers()
+    {
+        for (auto idx = next_reader_.fetch_add(1); idx < parallel_readers_.size(); idx = next_reader_.fetch_add(1))
+        {
+            try
+            {
+                parallel_readers_[idx]->R3BRead();
+            }
+            catch (...)
+            {
+                auto lock = std::lock_guard{ mutex_ };
+                if (not error_)
+                {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+} // namespace R3B
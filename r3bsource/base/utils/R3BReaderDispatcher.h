@@ -0,0 +1,70 @@
+#pragma once
+
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class R3BReader;
+
+namespace R3B
+{
+    // Runs R3BReader::R3BRead() of all readers of one event on a fixed pool of worker threads.
+    //
+    // Readers which report IsThreadSafe() are distributed over the workers. All the other readers are executed
+    // on the calling thread in the order in which they were registered. Dispatch() only returns after every
+    // reader has finished (per-event barrier), hence the event ordering seen by the task chain is unchanged.
+    class ReaderDispatcher
+    {
+      public:
+        ReaderDispatcher() = default;
+        // rule of five:
+        ~ReaderDispatcher();
+        ReaderDispatcher(const ReaderDispatcher&) = delete;
+        ReaderDispatcher(ReaderDispatcher&&) = delete;
+        ReaderDispatcher& operator=(const ReaderDispatcher&) = delete;
+        ReaderDispatcher& operator=(ReaderDispatcher&&) = delete;
+
+        // non-owning. The list must be fixed before the first call of Dispatch().
+        void Init(const std::vector<R3BReader*>& readers, unsigned int n_threads);
+        void Dispatch();
+        void Stop();
+
+        [[nodiscard]] auto GetNThreads() const -> unsigned int { return static_cast<unsigned int>(workers_.size()); }
+        [[nodiscard]] auto GetNParallelReaders() const -> size_t { return parallel_readers_.size(); }
+        [[nodiscard]] auto GetNSerialReaders() const -> size_t { return serial_readers_.size(); }
+
+      private:
+        std::vector<R3BReader*> serial_readers_;
+        std::vector<R3BReader*> parallel_readers_;
+        std::vector<std::thread> workers_;
+
+        std::mutex mutex_;
+        std::condition_variable start_cv_;
+        std::condition_variable done_cv_;
+        uint64_t generation_ = 0;
+        unsigned int n_busy_workers_ = 0;
+        bool is_stopping_ = false;
+        std::atomic<size_t> next_reader_{ 0 };
+        std::exception_ptr error_;
+
+        void worker_loop();
+        void run_parallel_readers();
+    };
+} // namespace R3B
@@ -0,0 +1,147 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BUcesbEventMerger.h"
+#include <R3BLogger.h>
+#include <array>
+#include <cstring>
+#include <fmt/format.h>
+
+namespace R3B
+{
+    void UcesbEventMerger::AddStream(FetchFunction fetch,
+                                     ReadFunction read,
+                                     EventStructFunction event_struct,
+                                     size_t wr_offset,
+                                     std::string name)
+    {
+        auto& added = streams_.emplace_back();
+        added.fetch = std::move(fetch);
+        added.read = std::move(read);
+        added.event_struct = std::move(event_struct);
+        added.wr_offset = wr_offset;
+        added.name = std::move(name);
+    }
+
+    auto UcesbEventMerger::GetTimestamp(const void* wr_block) -> std::optional<uint64_t>
+    {
+        // ID, T1, T2, T3, T4
+        auto words = std::array<uint32_t, 5>{};
+        std::memcpy(words.data(), wr_block, sizeof(words));
+        if (words[0] == 0)
+        {
+            return std::nullopt;
+        }
+        return (static_cast<uint64_t>(words[4]) << 48U) | (static_cast<uint64_t>(words[3]) << 32U) |
+               (static_cast<uint64_t>(words[2]) << 16U) | static_cast<uint64_t>(words[1]);
+    }
+
+    void UcesbEventMerger::fetch_next(size_t stream_index)
+    {
+        auto& stream = streams_[stream_index];
+        while (stream.fetch() > 0)
+        {
+            const auto timestamp =
+                GetTimestamp(reinterpret_cast<const char*>(stream.event_struct()) + stream.wr_offset);
+            if (!timestamp.has_value())
+            {
+                ++statistics_.n_untimed;
+                continue;
+            }
+            if (is_started_ && timestamp.value() < event_start_)
+            {
+                ++statistics_.n_late;
+                ++stream.n_late;
+                continue;
+            }
+            heads_.push(Head{ timestamp.value(), stream_index });
+            return;
+        }
+        R3BLOG(info, fmt::format("Reached the end of the ucesb {}.", stream.name));
+    }
+
+    auto UcesbEventMerger::BuildEvent() -> bool
+    {
+        if (!is_started_)
+        {
+            for (size_t stream_index = 0; stream_index < streams_.size(); ++stream_index)
+            {
+                fetch_next(stream_index);
+            }
+            is_started_ = true;
+        }
+
+        while (!heads_.empty())
+        {
+            if (max_event_num_ > 0 && statistics_.n_events >= max_event_num_)
+            {
+                R3BLOG(info, "Reached the maximal event num of the merged ucesb streams.");
+                return false;
+            }
+
+            // one fragment per stream, the next fragments of the same streams are fetched afterwards
+            event_start_ = heads_.top().timestamp;
+            event_streams_.clear();
+            while (!heads_.empty() && heads_.top().timestamp - event_start_ <= coincidence_window_)
+            {
+                event_streams_.push_back(heads_.top().stream);
+                heads_.pop();
+            }
+
+            const auto is_accepted = event_streams_.size() >= min_fragments_;
+            for (const auto stream_index : event_streams_)
+            {
+                if (is_accepted)
+                {
+                    streams_[stream_index].read();
+                    ++streams_[stream_index].n_fragments;
+                }
+                fetch_next(stream_index);
+            }
+
+            statistics_.n_orphans += (event_streams_.size() == 1) ? 1 : 0;
+            if (!is_accepted)
+            {
+                ++statistics_.n_rejected;
+                continue;
+            }
+            ++statistics_.n_events;
+            statistics_.n_fragments += event_streams_.size();
+            return true;
+        }
+
+        R3BLOG(info, "Reached the end of all ucesb streams.");
+        return false;
+    }
+
+    void UcesbEventMerger::PrintStatistics() const
+    {
+        R3BLOG(info,
+               fmt::format("Merged ucesb streams: {} events from {} fragments, {} orphans, {} rejected events, {} "
+                           "late and {} fragments without timestamp dropped",
+                           statistics_.n_events,
+                           statistics_.n_fragments,
+                           statistics_.n_orphans,
+                           statistics_.n_rejected,
+                           statistics_.n_late,
+                           statistics_.n_untimed));
+        for (const auto& stream : streams_)
+        {
+            R3BLOG(info,
+                   fmt::format("  {}: {} fragments in events, {} late",
+                               stream.name,
+                               stream.n_fragments,
+                               stream.n_late));
+        }
+    }
+} // namespace R3B
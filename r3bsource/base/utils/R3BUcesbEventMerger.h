@@ -0,0 +1,121 @@
+#pragma once
+
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace R3B
+{
+    // Event building of R3B::UcesbMergedSource: k-way merge of several event streams by their White Rabbit
+    // timestamps.
+    //
+    // The heads of all streams are kept in a heap ordered by their timestamps. An event is built from the earliest
+    // head and the heads of all other streams within the coincidence window after it. Only these streams read their
+    // fetched events, afterwards they fetch their next ones. Fragments without timestamp (ID 0) and fragments older
+    // than the last built event (late) are dropped.
+    class UcesbEventMerger
+    {
+      public:
+        // Same return value as ext_data_clnt::fetch_event(): positive for a fetched event
+        using FetchFunction = std::function<int()>;
+        // Reads the fetched event of a stream
+        using ReadFunction = std::function<void()>;
+        // Event structure the stream fetches into
+        using EventStructFunction = std::function<const void*()>;
+
+        struct Statistics
+        {
+            uint64_t n_events = 0;
+            uint64_t n_fragments = 0;
+            // events with a single fragment
+            uint64_t n_orphans = 0;
+            // events with fewer fragments than required, which are not passed to the tasks
+            uint64_t n_rejected = 0;
+            uint64_t n_late = 0;
+            uint64_t n_untimed = 0;
+        };
+
+        // wr_offset: offset of the White Rabbit block in the event structure of the stream
+        void AddStream(FetchFunction fetch,
+                       ReadFunction read,
+                       EventStructFunction event_struct,
+                       size_t wr_offset,
+                       std::string name);
+
+        // setters:
+        // in White Rabbit time units [ns]
+        void SetCoincidenceWindow(uint64_t window) { coincidence_window_ = window; }
+        void SetMinFragments(size_t min_fragments) { min_fragments_ = min_fragments; }
+        void SetMaxEvents(unsigned int max_event_num) { max_event_num_ = max_event_num; }
+
+        // Builds the next event and reads its fragments. Returns false at the end of all streams or once the maximal
+        // number of events is reached.
+        auto BuildEvent() -> bool;
+
+        [[nodiscard]] auto GetNStreams() const -> size_t { return streams_.size(); }
+        [[nodiscard]] auto GetCoincidenceWindow() const -> uint64_t { return coincidence_window_; }
+        [[nodiscard]] auto GetMaxEvents() const -> unsigned int { return max_event_num_; }
+        [[nodiscard]] auto GetStatistics() const -> const Statistics& { return statistics_; }
+        // time of the earliest fragment of the last built event
+        [[nodiscard]] auto GetEventTime() const -> uint64_t { return event_start_; }
+        // indices of the streams contributing to the last built event
+        [[nodiscard]] auto GetEventStreams() const -> const std::vector<size_t>& { return event_streams_; }
+        void PrintStatistics() const;
+
+        // Timestamp of a White Rabbit block (ID, T1 .. T4) of any EXT_STR_h101_WR* structure, with T1 as the lowest
+        // 16 bits. Returns std::nullopt for the ID 0.
+        static auto GetTimestamp(const void* wr_block) -> std::optional<uint64_t>;
+
+      private:
+        struct Stream
+        {
+            FetchFunction fetch;
+            ReadFunction read;
+            EventStructFunction event_struct;
+            size_t wr_offset = 0;
+            std::string name;
+            uint64_t n_fragments = 0;
+            uint64_t n_late = 0;
+        };
+
+        struct Head
+        {
+            uint64_t timestamp = 0;
+            size_t stream = 0;
+            // earliest first, ties in the order of the streams
+            auto operator>(const Head& other) const -> bool
+            {
+                return (timestamp != other.timestamp) ? timestamp > other.timestamp : stream > other.stream;
+            }
+        };
+
+        uint64_t coincidence_window_ = 0;
+        size_t min_fragments_ = 1;
+        unsigned int max_event_num_ = 0;
+        bool is_started_ = false;
+        uint64_t event_start_ = 0;
+        std::vector<Stream> streams_;
+        std::vector<size_t> event_streams_;
+        std::priority_queue<Head, std::vector<Head>, std::greater<>> heads_;
+        Statistics statistics_;
+
+        // private non-virtual methods:
+        void fetch_next(size_t stream_index);
+    };
+} // namespace R3B
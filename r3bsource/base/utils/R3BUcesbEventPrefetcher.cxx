@@ -0,0 +1,211 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BUcesbEventPrefetcher.h"
+#include <R3BException.h>
+#include <R3BLogger.h>
+#include <cstring>
+#include <fmt/format.h>
+
+#include <ext_data_clnt.hh>
+
+namespace
+{
+    auto to_ms(std::chrono::steady_clock::duration duration) -> double
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+} // namespace
+
+namespace R3B
+{
+    UcesbEventPrefetcher::UcesbEventPrefetcher(ext_data_clnt* client)
+        : UcesbEventPrefetcher{ [client](void* event_struct, size_t event_struct_size)
+                                { return client->fetch_event(event_struct, event_struct_size); },
+                                [client]() -> std::string
+                                {
+                                    const auto* msg = client->last_error();
+                                    return (msg == nullptr) ? "" : msg;
+                                } }
+    {
+    }
+
+    UcesbEventPrefetcher::UcesbEventPrefetcher(FetchFunction fetch, ErrorFunction last_error)
+        : fetch_{ std::move(fetch) }
+        , last_error_function_{ std::move(last_error) }
+    {
+    }
+
+    UcesbEventPrefetcher::~UcesbEventPrefetcher() { Stop(); }
+
+    void UcesbEventPrefetcher::Start(size_t event_struct_size, size_t depth)
+    {
+        if (IsRunning())
+        {
+            throw R3B::logic_error("Ucesb event prefetcher has already been started!");
+        }
+        if (depth == 0)
+        {
+            throw R3B::logic_error("Depth of the ucesb event prefetching ring must be larger than 0!");
+        }
+
+        event_struct_size_ = event_struct_size;
+        slots_.resize(depth);
+        for (auto& slot : slots_)
+        {
+            slot.buffer.assign(event_struct_size_, 0);
+        }
+        head_ = 0;
+        size_ = 0;
+        is_stopping_ = false;
+        is_finished_ = false;
+        is_producer_done_ = false;
+        statistics_ = Statistics{};
+
+        R3BLOG(info, fmt::format("Prefetching ucesb events with a ring depth of {}", depth));
+        producer_ = std::thread{ [this]()
+                                 {
+                                     produce();
+                                     auto lock = std::lock_guard{ mutex_ };
+                                     is_producer_done_ = true;
+                                     producer_done_cv_.notify_one();
+                                 } };
+    }
+
+    void UcesbEventPrefetcher::produce()
+    {
+        while (true)
+        {
+            auto tail = size_t{};
+            {
+                auto lock = std::unique_lock{ mutex_ };
+                if (size_ == slots_.size() && not is_stopping_)
+                {
+                    const auto start = Clock::now();
+                    ++statistics_.producer_stalls;
+                    not_full_cv_.wait(lock, [this]() { return size_ < slots_.size() || is_stopping_; });
+                    statistics_.producer_stall_time += Clock::now() - start;
+                }
+                if (is_stopping_)
+                {
+                    return;
+                }
+                tail = (head_ + size_) % slots_.size();
+            }
+
+            // the consumer never touches a slot which is not yet filled
+            auto& slot = slots_[tail];
+            const auto ret_val = fetch_(slot.buffer.data(), event_struct_size_);
+
+            auto lock = std::lock_guard{ mutex_ };
+            slot.status = ret_val;
+            if (ret_val < 0)
+            {
+                last_error_ = last_error_function_();
+            }
+            is_finished_ = (ret_val <= 0);
+            ++size_;
+            not_empty_cv_.notify_one();
+            if (is_finished_)
+            {
+                return;
+            }
+        }
+    }
+
+    auto UcesbEventPrefetcher::Pop(void* event_struct) -> int
+    {
+        auto lock = std::unique_lock{ mutex_ };
+        if (slots_.empty())
+        {
+            throw R3B::logic_error("Ucesb event prefetcher has not been started!");
+        }
+        if (size_ == 0)
+        {
+            const auto start = Clock::now();
+            ++statistics_.consumer_stalls;
+            not_empty_cv_.wait(lock, [this]() { return size_ > 0; });
+            statistics_.consumer_stall_time += Clock::now() - start;
+        }
+
+        const auto& slot = slots_[head_];
+        const auto ret_val = slot.status;
+        if (ret_val <= 0)
+        {
+            // keep the terminating slot such that further calls get the same answer
+            return ret_val;
+        }
+
+        lock.unlock();
+        std::memcpy(event_struct, slot.buffer.data(), event_struct_size_);
+        lock.lock();
+
+        head_ = (head_ + 1) % slots_.size();
+        --size_;
+        ++statistics_.n_events;
+        not_full_cv_.notify_one();
+        return ret_val;
+    }
+
+    void UcesbEventPrefetcher::Stop()
+    {
+        if (not IsRunning())
+        {
+            return;
+        }
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            is_stopping_ = true;
+        }
+        not_full_cv_.notify_one();
+        auto lock = std::unique_lock{ mutex_ };
+        if (not producer_done_cv_.wait_for(lock, stop_timeout_, [this]() { return is_producer_done_; }))
+        {
+            lock.unlock();
+            if (interrupt_)
+            {
+                R3BLOG(warn, "Ucesb event prefetcher is still waiting for the ucesb server. Interrupting it.");
+                interrupt_();
+            }
+            else
+            {
+                R3BLOG(warn, "Ucesb event prefetcher is still waiting for the ucesb server.");
+            }
+        }
+        else
+        {
+            lock.unlock();
+        }
+        producer_.join();
+        PrintStatistics();
+    }
+
+    auto UcesbEventPrefetcher::GetStatistics() const -> Statistics
+    {
+        auto lock = std::lock_guard{ mutex_ };
+        return statistics_;
+    }
+
+    void UcesbEventPrefetcher::PrintStatistics() const
+    {
+        const auto stats = GetStatistics();
+        R3BLOG(info,
+               fmt::format("Ucesb prefetching: {} events, producer stalled {} times ({:.1f} ms), consumer stalled {} "
+                           "times ({:.1f} ms)",
+                           stats.n_events,
+                           stats.producer_stalls,
+                           to_ms(stats.producer_stall_time),
+                           stats.consumer_stalls,
+                           to_ms(stats.consumer_stall_time)));
+    }
+} // namespace R3B
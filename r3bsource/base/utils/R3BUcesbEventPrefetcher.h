@@ -0,0 +1,117 @@
+#pragma once
+
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ext_data_clnt;
+
+namespace R3B
+{
+    // Bounded ring of pre-fetched ucesb event structures.
+    //
+    // A producer thread calls ext_data_clnt::fetch_event() into the free slots of the ring while the main thread
+    // runs the readers and the task chain on the previous events. Pop() copies the oldest slot into the event
+    // structure the readers are bound to. Once Start() is called, the ucesb client must not be used by anyone
+    // else until Stop() has returned.
+    //
+    // Stop() cannot cancel a fetch_event() call which waits for data from the ucesb server. If the producer has not
+    // returned within the stop timeout, the interrupt set with SetInterrupt() is called, which has to make the
+    // pending call return, e.g. by terminating the ucesb server such that the pipe reaches its end.
+    class UcesbEventPrefetcher
+    {
+      public:
+        using Clock = std::chrono::steady_clock;
+        // Same signature and return value as ext_data_clnt::fetch_event()
+        using FetchFunction = std::function<int(void* event_struct, size_t event_struct_size)>;
+        using ErrorFunction = std::function<std::string()>;
+        static constexpr auto DEFAULT_STOP_TIMEOUT = std::chrono::seconds(5);
+
+        struct Statistics
+        {
+            uint64_t n_events = 0;
+            // number of times the producer found the ring full (consumer is the bottleneck)
+            uint64_t producer_stalls = 0;
+            // number of times the consumer found the ring empty (ucesb is the bottleneck)
+            uint64_t consumer_stalls = 0;
+            Clock::duration producer_stall_time{};
+            Clock::duration consumer_stall_time{};
+        };
+
+        explicit UcesbEventPrefetcher(ext_data_clnt* client);
+        UcesbEventPrefetcher(FetchFunction fetch, ErrorFunction last_error);
+        // rule of five:
+        ~UcesbEventPrefetcher();
+        UcesbEventPrefetcher(const UcesbEventPrefetcher&) = delete;
+        UcesbEventPrefetcher(UcesbEventPrefetcher&&) = delete;
+        UcesbEventPrefetcher& operator=(const UcesbEventPrefetcher&) = delete;
+        UcesbEventPrefetcher& operator=(UcesbEventPrefetcher&&) = delete;
+
+        // Must only be called once the ucesb client has been set up successfully.
+        void Start(size_t event_struct_size, size_t depth);
+        // Same return value as ext_data_clnt::fetch_event(): positive for an event, 0 at the end of input and -1 on
+        // error. event_struct is only written for a positive return value.
+        auto Pop(void* event_struct) -> int;
+        // Blocks until the producer has returned from its current fetch_event() call, calling the interrupt if this
+        // takes longer than the stop timeout.
+        void Stop();
+        void SetInterrupt(std::function<void()> interrupt, Clock::duration timeout = DEFAULT_STOP_TIMEOUT)
+        {
+            interrupt_ = std::move(interrupt);
+            stop_timeout_ = timeout;
+        }
+
+        [[nodiscard]] auto IsRunning() const -> bool { return producer_.joinable(); }
+        [[nodiscard]] auto GetDepth() const -> size_t { return slots_.size(); }
+        [[nodiscard]] auto GetStatistics() const -> Statistics;
+        [[nodiscard]] auto GetLastError() const -> const char* { return last_error_.c_str(); }
+        void PrintStatistics() const;
+
+      private:
+        struct Slot
+        {
+            std::vector<char> buffer;
+            int status = 0;
+        };
+
+        FetchFunction fetch_;
+        ErrorFunction last_error_function_;
+        std::function<void()> interrupt_;
+        Clock::duration stop_timeout_ = DEFAULT_STOP_TIMEOUT;
+        size_t event_struct_size_ = 0;
+        std::vector<Slot> slots_;
+        size_t head_ = 0; // next slot to be consumed
+        size_t size_ = 0; // number of filled slots
+        bool is_stopping_ = false;
+        bool is_finished_ = false;
+        bool is_producer_done_ = false;
+        std::string last_error_;
+        Statistics statistics_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable not_full_cv_;
+        std::condition_variable not_empty_cv_;
+        std::condition_variable producer_done_cv_;
+        std::thread producer_;
+
+        void produce();
+    };
+} // namespace R3B
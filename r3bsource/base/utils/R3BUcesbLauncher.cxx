@@ -174,6 +174,16 @@ namespace R3B
 
     void UcesbServerLauncher::Setup(ext_data_struct_info& struct_info, size_t event_struct_size) {}
 
+    void UcesbServerLauncher::Terminate()
+    {
+        auto err_code = std::error_code{};
+        if (ucesb_server_ != nullptr && ucesb_server_->running(err_code))
+        {
+            R3BLOG(warn, "Killing Ucesb server");
+            ucesb_server_->terminate(err_code);
+        }
+    }
+
     void UcesbServerLauncher::Close()
     {
         if (auto ret_val = client_->close(); ret_val != 0)
@@ -30,6 +30,8 @@ namespace R3B
         void Launch(std::string command_string);
         void Setup(ext_data_struct_info& struct_info, size_t event_struct_size);
         void Close();
+        // Kills the ucesb server, such that a pending fetch from its pipe returns
+        void Terminate();
 
       private:
         ext_data_clnt* client_ = nullptr;
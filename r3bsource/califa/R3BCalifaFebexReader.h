@@ -48,6 +48,7 @@ class R3BCalifaFebexReader : public R3BReader
 
     // Read data from full event structure
     virtual Bool_t R3BRead() override;
+    [[nodiscard]] bool IsThreadSafe() const override { return true; }
 
     // Reset
     virtual void Reset() override;
@@ -166,6 +166,7 @@ class R3BBunchedFiberReader : public R3BReader
     R3BBunchedFiberReader(char const*, size_t, UInt_t, UInt_t, UInt_t);
     Bool_t Init(ext_data_struct_info*);
     Bool_t R3BRead();
+    [[nodiscard]] bool IsThreadSafe() const override { return true; }
     void Reset();
 
   protected:
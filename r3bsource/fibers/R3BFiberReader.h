@@ -239,6 +239,7 @@ class R3BFiberReader : public R3BReader
 
     // Read data from full event structure
     virtual Bool_t R3BRead() override;
+    [[nodiscard]] bool IsThreadSafe() const override { return true; }
 
     // Reset
     virtual void Reset() override;
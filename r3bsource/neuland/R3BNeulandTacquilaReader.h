@@ -60,6 +60,7 @@ class R3BNeulandTacquilaReader : public R3BReader
      * Makes data conversion.
      */
     Bool_t R3BRead();
+    [[nodiscard]] bool IsThreadSafe() const override { return true; }
 
     /**
      * Method for clearing the output array.
@@ -38,6 +38,7 @@ class R3BNeulandTamexReader : public R3BReader
 
     // Read data from full event structure
     virtual Bool_t R3BRead() override;
+    [[nodiscard]] bool IsThreadSafe() const override { return true; }
 
     // Reset
     virtual void Reset() override;
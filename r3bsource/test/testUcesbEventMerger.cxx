@@ -0,0 +1,194 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BUcesbEventMerger.h"
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using R3B::UcesbEventMerger;
+
+    // upper bits of all timestamps, such that all four 16 bit words are used
+    constexpr auto TIME_BASE = uint64_t{ 0x0123'4567'0000'0000 };
+
+    // Layout of an event structure with a White Rabbit block (ID, T1 .. T4) behind other data
+    struct EventStruct
+    {
+        uint32_t trigger = 0;
+        uint32_t wr_id = 0;
+        uint32_t wr_t1 = 0;
+        uint32_t wr_t2 = 0;
+        uint32_t wr_t3 = 0;
+        uint32_t wr_t4 = 0;
+    };
+
+    auto MakeEvent(uint64_t timestamp, uint32_t wr_id = 1) -> EventStruct
+    {
+        auto event = EventStruct{};
+        event.wr_id = wr_id;
+        event.wr_t1 = static_cast<uint32_t>(timestamp & 0xffffU);
+        event.wr_t2 = static_cast<uint32_t>((timestamp >> 16U) & 0xffffU);
+        event.wr_t3 = static_cast<uint32_t>((timestamp >> 32U) & 0xffffU);
+        event.wr_t4 = static_cast<uint32_t>((timestamp >> 48U) & 0xffffU);
+        return event;
+    }
+
+    // Stands in for a ucesb stream: fetches the given events one after the other and records the timestamps of the
+    // events its readers read.
+    class FakeStream
+    {
+      public:
+        explicit FakeStream(std::vector<EventStruct> events)
+            : events_{ std::move(events) }
+        {
+        }
+
+        void AddTo(UcesbEventMerger& merger, const std::string& name)
+        {
+            merger.AddStream([this]() { return Fetch(); },
+                             [this]() { read_times_.push_back(*UcesbEventMerger::GetTimestamp(&event_struct_.wr_id)); },
+                             [this]() -> const void* { return &event_struct_; },
+                             offsetof(EventStruct, wr_id),
+                             name);
+        }
+
+        [[nodiscard]] auto GetReadTimes() const -> const std::vector<uint64_t>& { return read_times_; }
+
+      private:
+        std::vector<EventStruct> events_;
+        size_t next_ = 0;
+        EventStruct event_struct_;
+        std::vector<uint64_t> read_times_;
+
+        auto Fetch() -> int
+        {
+            if (next_ == events_.size())
+            {
+                return 0;
+            }
+            event_struct_ = events_[next_++];
+            return 1;
+        }
+    };
+
+    auto BuildAll(UcesbEventMerger& merger) -> std::vector<std::pair<uint64_t, std::vector<size_t>>>
+    {
+        auto events = std::vector<std::pair<uint64_t, std::vector<size_t>>>{};
+        while (merger.BuildEvent())
+        {
+            events.emplace_back(merger.GetEventTime() - TIME_BASE, merger.GetEventStreams());
+        }
+        return events;
+    }
+
+    TEST(testUcesbEventMerger, timestamp_from_wr_words)
+    {
+        const auto event = MakeEvent(0x0123'4567'89ab'cdef);
+        EXPECT_EQ(event.wr_t1, 0xcdefU);
+        EXPECT_EQ(event.wr_t4, 0x0123U);
+        EXPECT_EQ(UcesbEventMerger::GetTimestamp(&event.wr_id), uint64_t{ 0x0123'4567'89ab'cdef });
+
+        // only the lower 16 bits of the words are set by ucesb
+        const auto max_event = MakeEvent(UINT64_MAX);
+        EXPECT_EQ(UcesbEventMerger::GetTimestamp(&max_event.wr_id), UINT64_MAX);
+
+        const auto untimed = MakeEvent(0x0123'4567'89ab'cdef, 0);
+        EXPECT_FALSE(UcesbEventMerger::GetTimestamp(&untimed.wr_id).has_value());
+    }
+
+    TEST(testUcesbEventMerger, interleaved_streams_in_time_order)
+    {
+        auto main_daq = FakeStream{ { MakeEvent(TIME_BASE + 1000),
+                                      MakeEvent(TIME_BASE + 2000),
+                                      MakeEvent(TIME_BASE + 3000),
+                                      MakeEvent(TIME_BASE + 4000) } };
+        auto califa = FakeStream{ { MakeEvent(TIME_BASE + 1020),
+                                    MakeEvent(TIME_BASE + 2500),
+                                    MakeEvent(TIME_BASE + 2990),
+                                    MakeEvent(TIME_BASE + 0x1'0000) } };
+        auto merger = UcesbEventMerger{};
+        main_daq.AddTo(merger, "main DAQ");
+        califa.AddTo(merger, "CALIFA");
+        merger.SetCoincidenceWindow(50);
+
+        using Events = std::vector<std::pair<uint64_t, std::vector<size_t>>>;
+        EXPECT_EQ(BuildAll(merger),
+                  (Events{ { 1000, { 0, 1 } },
+                           { 2000, { 0 } },
+                           { 2500, { 1 } },
+                           { 2990, { 1, 0 } },
+                           { 4000, { 0 } },
+                           { 0x1'0000, { 1 } } }));
+        EXPECT_EQ(main_daq.GetReadTimes(),
+                  (std::vector<uint64_t>{ TIME_BASE + 1000, TIME_BASE + 2000, TIME_BASE + 3000, TIME_BASE + 4000 }));
+        EXPECT_EQ(califa.GetReadTimes(),
+                  (std::vector<uint64_t>{
+                      TIME_BASE + 1020, TIME_BASE + 2500, TIME_BASE + 2990, TIME_BASE + 0x1'0000 }));
+
+        const auto& statistics = merger.GetStatistics();
+        EXPECT_EQ(statistics.n_events, 6);
+        EXPECT_EQ(statistics.n_fragments, 8);
+        EXPECT_EQ(statistics.n_orphans, 4);
+        EXPECT_EQ(statistics.n_late, 0);
+        EXPECT_FALSE(merger.BuildEvent());
+    }
+
+    TEST(testUcesbEventMerger, drop_late_untimed_and_rejected_fragments)
+    {
+        auto main_daq = FakeStream{ { MakeEvent(TIME_BASE + 1000),
+                                      MakeEvent(TIME_BASE + 2000),
+                                      MakeEvent(TIME_BASE + 3000) } };
+        auto califa = FakeStream{ { MakeEvent(TIME_BASE + 1010),
+                                    MakeEvent(TIME_BASE + 900),
+                                    MakeEvent(TIME_BASE + 2000, 0),
+                                    MakeEvent(TIME_BASE + 2500),
+                                    MakeEvent(TIME_BASE + 3010) } };
+        auto merger = UcesbEventMerger{};
+        main_daq.AddTo(merger, "main DAQ");
+        califa.AddTo(merger, "CALIFA");
+        merger.SetCoincidenceWindow(50);
+        merger.SetMinFragments(2);
+
+        using Events = std::vector<std::pair<uint64_t, std::vector<size_t>>>;
+        EXPECT_EQ(BuildAll(merger), (Events{ { 1000, { 0, 1 } }, { 3000, { 0, 1 } } }));
+        // the fragments of the rejected events are not read
+        EXPECT_EQ(main_daq.GetReadTimes(), (std::vector<uint64_t>{ TIME_BASE + 1000, TIME_BASE + 3000 }));
+        EXPECT_EQ(califa.GetReadTimes(), (std::vector<uint64_t>{ TIME_BASE + 1010, TIME_BASE + 3010 }));
+
+        const auto& statistics = merger.GetStatistics();
+        EXPECT_EQ(statistics.n_events, 2);
+        EXPECT_EQ(statistics.n_rejected, 2);
+        EXPECT_EQ(statistics.n_late, 1);
+        EXPECT_EQ(statistics.n_untimed, 1);
+    }
+
+    TEST(testUcesbEventMerger, stop_at_max_events)
+    {
+        auto main_daq = FakeStream{ { MakeEvent(TIME_BASE + 1000), MakeEvent(TIME_BASE + 3000) } };
+        auto califa = FakeStream{ { MakeEvent(TIME_BASE + 2000), MakeEvent(TIME_BASE + 4000) } };
+        auto merger = UcesbEventMerger{};
+        main_daq.AddTo(merger, "main DAQ");
+        califa.AddTo(merger, "CALIFA");
+        merger.SetMaxEvents(3);
+
+        using Events = std::vector<std::pair<uint64_t, std::vector<size_t>>>;
+        EXPECT_EQ(BuildAll(merger), (Events{ { 1000, { 0 } }, { 2000, { 1 } }, { 3000, { 0 } } }));
+        EXPECT_EQ(califa.GetReadTimes(), (std::vector<uint64_t>{ TIME_BASE + 2000 }));
+    }
+} // namespace
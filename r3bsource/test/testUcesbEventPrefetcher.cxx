@@ -0,0 +1,164 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BException.h"
+#include "R3BUcesbEventPrefetcher.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    using R3B::UcesbEventPrefetcher;
+
+    // Stands in for the ucesb server: delivers the event numbers 1 to n_events, then blocks
+    // until it is interrupted if is_blocking is set, or reports the end of input otherwise.
+    class FakeServer
+    {
+      public:
+        FakeServer(int n_events, bool is_blocking)
+            : n_events_{ n_events }
+            , is_blocking_{ is_blocking }
+        {
+        }
+
+        auto Fetch(void* event_struct, size_t event_struct_size) -> int
+        {
+            ++n_fetches_;
+            if (n_sent_ < n_events_)
+            {
+                ++n_sent_;
+                std::memcpy(event_struct, &n_sent_, std::min(sizeof(n_sent_), event_struct_size));
+                return 1;
+            }
+            if (not is_blocking_)
+            {
+                return 0;
+            }
+            auto lock = std::unique_lock{ mutex_ };
+            interrupt_cv_.wait(lock, [this]() { return is_interrupted_; });
+            return -1;
+        }
+
+        void Interrupt()
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            is_interrupted_ = true;
+            interrupt_cv_.notify_one();
+        }
+
+        auto MakePrefetcher() -> UcesbEventPrefetcher
+        {
+            return UcesbEventPrefetcher{ [this](void* event_struct, size_t event_struct_size)
+                                         { return Fetch(event_struct, event_struct_size); },
+                                         []() -> std::string { return "server interrupted"; } };
+        }
+
+        [[nodiscard]] auto GetNFetches() const -> int { return n_fetches_; }
+        [[nodiscard]] auto IsInterrupted() -> bool
+        {
+            auto lock = std::lock_guard{ mutex_ };
+            return is_interrupted_;
+        }
+
+      private:
+        int n_events_ = 0;
+        int n_sent_ = 0;
+        bool is_blocking_ = false;
+        bool is_interrupted_ = false;
+        std::atomic<int> n_fetches_ = 0;
+        std::mutex mutex_;
+        std::condition_variable interrupt_cv_;
+    };
+
+    TEST(testUcesbEventPrefetcher, start_and_pop_in_order)
+    {
+        constexpr auto n_events = 100;
+        auto server = FakeServer{ n_events, false };
+        auto prefetcher = server.MakePrefetcher();
+        prefetcher.Start(sizeof(int), 4);
+
+        auto event = 0;
+        for (auto expected = 1; expected <= n_events; ++expected)
+        {
+            ASSERT_EQ(prefetcher.Pop(&event), 1);
+            EXPECT_EQ(event, expected);
+        }
+        EXPECT_EQ(prefetcher.Pop(&event), 0);
+        // the end of input is kept for further calls
+        EXPECT_EQ(prefetcher.Pop(&event), 0);
+        EXPECT_EQ(event, n_events);
+
+        prefetcher.Stop();
+        EXPECT_FALSE(prefetcher.IsRunning());
+        EXPECT_EQ(prefetcher.GetStatistics().n_events, n_events);
+    }
+
+    TEST(testUcesbEventPrefetcher, early_stop_with_full_ring)
+    {
+        auto server = FakeServer{ 1000, true };
+        auto prefetcher = server.MakePrefetcher();
+        prefetcher.SetInterrupt([&server]() { server.Interrupt(); });
+        prefetcher.Start(sizeof(int), 2);
+
+        auto event = 0;
+        ASSERT_EQ(prefetcher.Pop(&event), 1);
+        prefetcher.Stop();
+        EXPECT_FALSE(prefetcher.IsRunning());
+        // the producer waited for a free slot, not for the server
+        EXPECT_FALSE(server.IsInterrupted());
+    }
+
+    TEST(testUcesbEventPrefetcher, early_stop_while_waiting_for_server)
+    {
+        auto server = FakeServer{ 3, true };
+        auto prefetcher = server.MakePrefetcher();
+        prefetcher.SetInterrupt([&server]() { server.Interrupt(); }, std::chrono::milliseconds(10));
+        prefetcher.Start(sizeof(int), 8);
+
+        auto event = 0;
+        for (auto expected = 1; expected <= 3; ++expected)
+        {
+            ASSERT_EQ(prefetcher.Pop(&event), 1);
+        }
+        // wait for the producer to block in the fetch of the fourth event
+        while (server.GetNFetches() < 4)
+        {
+            std::this_thread::yield();
+        }
+        prefetcher.Stop();
+        EXPECT_FALSE(prefetcher.IsRunning());
+        EXPECT_TRUE(server.IsInterrupted());
+        EXPECT_EQ(prefetcher.Pop(&event), -1);
+        EXPECT_STREQ(prefetcher.GetLastError(), "server interrupted");
+    }
+
+    TEST(testUcesbEventPrefetcher, not_started_after_failed_setup)
+    {
+        // the sources only start the prefetcher after the client setup succeeded
+        auto server = FakeServer{ 10, false };
+        {
+            auto prefetcher = server.MakePrefetcher();
+            EXPECT_FALSE(prefetcher.IsRunning());
+            auto event = 0;
+            EXPECT_THROW(prefetcher.Pop(&event), R3B::logic_error);
+            prefetcher.Stop();
+        }
+        EXPECT_EQ(server.GetNFetches(), 0);
+    }
+} // namespace
@@ -37,6 +37,7 @@ class R3BTofdReader : public R3BReader
 
     // Read data from full event structure
     Bool_t R3BRead() override;
+    [[nodiscard]] bool IsThreadSafe() const override { return true; }
 
     // Reset
     void Reset() override;
@@ -162,7 +162,7 @@ void R3BRpcCal2Hit::Exec(Option_t* opt)
 
                 double time = (time_left + time_right) / 2. - fParCont3->GetAt(inum);
 
-                auto tof = fTimeStitch->GetTime(time - fR3BEventHeader->GetTStart());
+                auto tof = fTimeStitch->GetTime<R3B::TDC::Tamex>(time - fR3BEventHeader->GetTStart());
                 AddHitStrip(iDetector, ichn_right, time, position, charge, tof);
             }
         }
@@ -175,7 +175,7 @@ void R3BRpcCal2Hit::Exec(Option_t* opt)
 
             double time = (map1->GetTimeR_B() + map1->GetTimeL_T()) / 2.;
 
-            auto tof = fTimeStitch->GetTime(time - fR3BEventHeader->GetTStart());
+            auto tof = fTimeStitch->GetTime<R3B::TDC::Tamex>(time - fR3BEventHeader->GetTStart());
 
             AddHitStrip(iDetector, map1->GetChannelId(), time, position, charge, tof);
         }
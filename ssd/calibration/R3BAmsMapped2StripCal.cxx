@@ -138,6 +138,9 @@ void R3BAmsMapped2StripCal::SetParameter()
         }
         LOG(info) << "R3BAmsMapped2StripCal: Nb of dead strips in AMS detector " << d << ": " << numdeadstrips;
     }
+
+    // Pedestal and sigma as second and third parameter
+    fEngine.SetParameters(NumDets, NumStrips, *CalParams, NumParams, 1, 2);
 }
 
 // -----   Public method Init   --------------------------------------------
@@ -201,90 +204,28 @@ void R3BAmsMapped2StripCal::Exec(Option_t* option)
     if (!nHits)
         return;
 
-    R3BAmsMappedData** mappedData;
-    mappedData = new R3BAmsMappedData*[nHits];
-    Int_t detId;
-    Int_t sideId;
-    Int_t stripId;
-    Double_t energy;
-    Double_t pedestal = 0.;
-    Double_t sigma = 0.;
-    // Double_t SynAdcs[16*NumDets];
-
-    // Look for ADC baselines
-    // for(Int_t i = 0; i < 16*NumDets; i++)SynAdcs[i]=0.;
-
-    Int_t nbadc = 0;
-    Int_t minnb = 4;
-    Double_t h = 0;
-    /*
-    for(Int_t i = 0; i < nHits; i++) {
-      mappedData[i] = (R3BAmsMappedData*)(fAmsMappedDataCA->At(i));
-
-      detId   = mappedData[i]->GetDetectorId();
-      stripId = mappedData[i]->GetStripId();
-
-      pedestal=CalParams->GetAt(NumParams*stripId+1);
-      sigma=CalParams->GetAt(NumParams*stripId+2);
-      energy  = mappedData[i]->GetEnergy()-pedestal;
-
-  //LOG(warn)<<  pedestal << " "<<  sigma << " " <<  energy << " "<<nbadc;
-
-      if(energy<sigma*3. && i<64*(nbadc+1)){
-       if(pedestal>-1){
-        SynAdcs[nbadc]=SynAdcs[nbadc]+energy;
-        h=h+1.;
-        if(h==minnb){
-         SynAdcs[nbadc]=SynAdcs[nbadc]/h;
-         nbadc++;
-         i=64*nbadc-1;
-         h=0;
-        }
-       }
-      }else{
-       SynAdcs[nbadc]=0.;
-       LOG(warn) << "R3BAmsMapped2StripCal: NO baseline found for ADC "<<nbadc;
-       nbadc++;
-      }
-    }
-    */
-
-    nbadc = 0;
+    // Dense ADC arrays per detector, filled in the order of the unpacker
+    fEngine.Clear();
     for (Int_t i = 0; i < nHits; i++)
     {
-        mappedData[i] = dynamic_cast<R3BAmsMappedData*>(fAmsMappedDataCA->At(i));
-        detId = mappedData[i]->GetDetectorId();
-        stripId = mappedData[i]->GetStripId();
-
-        pedestal = CalParams->GetAt(NumParams * stripId + 1 + detId * NumStrips * NumParams);
-        sigma = CalParams->GetAt(NumParams * stripId + 2 + detId * NumStrips * NumParams);
+        auto* mappedData = static_cast<R3BAmsMappedData*>(fAmsMappedDataCA->At(i));
+        fEngine.Fill(mappedData->GetDetectorId(), mappedData->GetStripId(), mappedData->GetEnergy());
+    }
 
-        if (stripId < NumStripsS)
+    // We accept the hit if the energy is larger than 5 times the sigma of the pedestal
+    // and the strip is not dead
+    fEngine.SubtractThreshold(fTimesSigma);
+    for (const auto& hit : fEngine.GetHits())
+    {
+        if (hit.strip < NumStripsS)
         {
-            sideId = 0;
+            AddCalData(hit.det, 0, hit.strip, hit.energy);
         }
         else
         {
-            sideId = 1;
-            stripId = stripId - NumStripsS;
-        }
-        /*        if (i % 63 == 0 && i > 0)
-                {
-                    nbadc++;
-                }
-        */
-        energy = mappedData[i]->GetEnergy() - pedestal - fTimesSigma * sigma; //-SynAdcs[nbadc];
-
-        // We accept the hit if the energy is larger than 5 times the sigma of the pedestal
-        // and the strip is not dead
-        if (energy > 0. && pedestal != -1)
-        {
-            AddCalData(detId, sideId, stripId, energy);
+            AddCalData(hit.det, 1, hit.strip - NumStripsS, hit.energy);
         }
     }
-
-    if (mappedData)
-        delete[] mappedData;
     return;
 }
 
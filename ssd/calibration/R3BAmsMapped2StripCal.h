@@ -25,6 +25,7 @@
 #include "R3BAmsMapped2StripCalPar.h"
 #include "R3BAmsMappedData.h"
 #include "R3BAmsStripCalData.h"
+#include "R3BSsdStripCalEngine.h"
 
 #include <Rtypes.h>
 #include <TRandom.h>
@@ -87,6 +88,7 @@ class R3BAmsMapped2StripCal : public FairTask
     R3BAmsStripCalPar* fCal_Par;      /**< Parameter container. >*/
     TClonesArray* fAmsMappedDataCA;   /**< Array with AMS Mapped input data. >*/
     TClonesArray* fAmsStripCalDataCA; /**< Array with AMS Cal output data. >*/
+    R3BSsdStripCalEngine fEngine;     //! Pedestal and threshold subtraction
 
     /** Private method AddCalData **/
     //** Adds a AmsStripCalData to the StripCalCollection
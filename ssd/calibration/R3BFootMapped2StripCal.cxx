@@ -109,6 +109,9 @@ void R3BFootMapped2StripCal::SetParameter()
         }
         LOG(info) << "R3BFootMapped2StripCal::Nb of dead strips in FOOT detector " << d + 1 << ": " << numdeadstrips;
     }
+
+    // Pedestal and sigma as first and second parameter
+    fEngine.SetParameters(NumDets, NumStrips, *CalParams, NumParams, 0, 1);
 }
 
 // -----   Public method Init   --------------------------------------------
@@ -159,137 +162,20 @@ void R3BFootMapped2StripCal::Exec(Option_t* option)
     if (nHits == 0)
         return;
 
-    R3BFootMappedData** mappedData = new R3BFootMappedData*[nHits];
-    Int_t detId;
-    Int_t stripId;
-    Double_t energy;
-    Double_t pedestal = 0.;
-    Double_t sigma = 0.;
-    Int_t StripNAve[(Int_t)fCal_Par->GetNumDets()];            // Number of Strips to compute average for each detector
-    Double_t Ave[(Int_t)fCal_Par->GetNumDets()];               // Average ADC value for each detector
-    Double_t StripNAveASIC[(Int_t)fCal_Par->GetNumDets()][10]; // Number of Strips to compute average for each ASICS
-    Double_t StripNAveASIC_fine[(Int_t)fCal_Par->GetNumDets()][10];
-    Double_t AveASIC[(Int_t)fCal_Par->GetNumDets()][10]; // Average ADC value for each ASICS
-    Double_t asic_offset_fine[(Int_t)fCal_Par->GetNumDets()][10];
-    Int_t StripCounter[(Int_t)fCal_Par->GetNumDets()]; // Counter to disregard events with baseline jumps
-    for (Int_t i = 0; i < fCal_Par->GetNumDets(); i++)
-    {
-        StripCounter[i] = 0;
-        Ave[i] = 0.;
-        StripNAve[i] = 0;
-        for (Int_t j = 0; j < 10; j++)
-        {
-            AveASIC[i][j] = 0.;
-            StripNAveASIC[i][j] = 0;
-        }
-    }
-
-    // Pedestal substraction
-    for (Int_t i = 0; i < nHits; i++)
-    {
-        mappedData[i] = dynamic_cast<R3BFootMappedData*>(fFootMappedData->At(i));
-        detId = mappedData[i]->GetDetId() - 1;
-        stripId = mappedData[i]->GetStripId() - 1;
-
-        if (CalParams)
-        {
-            pedestal = CalParams->GetAt(NumParams * stripId + detId * NumParams * NumStrips);
-            sigma = CalParams->GetAt(NumParams * stripId + 1 + detId * NumParams * NumStrips);
-        }
-
-        energy = mappedData[i]->GetEnergy() - pedestal;
-
-        // only use strips with signal below threshold for correction
-        if (energy < fTimesSigma * sigma)
-        {
-            Ave[detId] += energy;
-            StripNAve[detId]++;
-        }
-    }
-
-    for (Int_t i = 0; i < fCal_Par->GetNumDets(); i++)
-    {
-        Ave[i] = Ave[i] / StripNAve[i];
-    }
-
-    // Average correction
-    for (Int_t i = 0; i < nHits; i++)
-    {
-
-        detId = mappedData[i]->GetDetId() - 1;
-        stripId = mappedData[i]->GetStripId() - 1;
-
-        if (CalParams)
-        {
-            pedestal = CalParams->GetAt(NumParams * stripId + detId * NumParams * NumStrips);
-            sigma = CalParams->GetAt(NumParams * stripId + 1 + detId * NumParams * NumStrips);
-        }
-
-        energy = mappedData[i]->GetEnergy() - pedestal - Ave[detId];
-
-        // only use strips with signal below threshold for correction
-        if (energy < fTimesSigma * sigma)
-        {
-            Int_t ASIC = (Double_t)stripId / 64.;
-            AveASIC[detId][ASIC] += energy;
-            StripNAveASIC[detId][ASIC]++;
-        }
-    }
-
-    for (Int_t i = 0; i < fCal_Par->GetNumDets(); i++)
-    {
-        for (Int_t j = 0; j < 10; j++)
-        {
-            AveASIC[i][j] = AveASIC[i][j] / StripNAveASIC[i][j];
-        }
-    }
-
-    // ASIC Average correction
+    // Dense ADC arrays per detector, filled in the order of the unpacker
+    fEngine.Clear();
     for (Int_t i = 0; i < nHits; i++)
     {
-
-        detId = mappedData[i]->GetDetId() - 1;
-        stripId = mappedData[i]->GetStripId() - 1;
-
-        if (CalParams)
-        {
-            pedestal = CalParams->GetAt(NumParams * stripId + detId * NumParams * NumStrips);
-            sigma = CalParams->GetAt(NumParams * stripId + 1 + detId * NumParams * NumStrips);
-        }
-
-        Int_t ASIC1 = (Double_t)stripId / 64.;
-
-        energy = mappedData[i]->GetEnergy() - pedestal - Ave[detId] - AveASIC[detId][ASIC1];
-
-        if (energy > 0. && pedestal != -1)
-        {
-            StripCounter[detId]++;
-        }
+        auto* mappedData = static_cast<R3BFootMappedData*>(fFootMappedData->At(i));
+        fEngine.Fill(mappedData->GetDetId() - 1, mappedData->GetStripId() - 1, mappedData->GetEnergy());
     }
 
-    for (Int_t i = 0; i < nHits; i++)
+    // Pedestal substraction, detector and ASIC average correction
+    fEngine.CommonModeCorrect(fTimesSigma, fNStrip);
+    for (const auto& hit : fEngine.GetHits())
     {
-
-        detId = mappedData[i]->GetDetId() - 1;
-        stripId = mappedData[i]->GetStripId() - 1;
-
-        if (CalParams)
-        {
-            pedestal = CalParams->GetAt(NumParams * stripId + detId * NumParams * NumStrips);
-            sigma = CalParams->GetAt(NumParams * stripId + 1 + detId * NumParams * NumStrips);
-        }
-
-        Int_t ASIC3 = (Double_t)stripId / 64.;
-
-        energy = mappedData[i]->GetEnergy() - pedestal - Ave[detId] - AveASIC[detId][ASIC3];
-
-        if (energy > fTimesSigma * sigma && pedestal != -1 && StripCounter[detId] < fNStrip)
-        {
-            AddCalData(detId + 1, stripId + 1, energy);
-        }
+        AddCalData(hit.det + 1, hit.strip + 1, hit.energy);
     }
-    if (mappedData)
-        delete[] mappedData;
     return;
 }
 
@@ -22,6 +22,7 @@
 #include "FairTask.h"
 
 #include "R3BFootCalData.h"
+#include "R3BSsdStripCalEngine.h"
 
 #include <Rtypes.h>
 
@@ -84,6 +85,7 @@ class R3BFootMapped2StripCal : public FairTask
     R3BFootCalPar* fCal_Par;       // Parameter container
     TClonesArray* fFootMappedData; // Array with FOOT Mapped input data
     TClonesArray* fFootCalData;    // Array with FOOT Cal output data
+    R3BSsdStripCalEngine fEngine;  //! Pedestal and common-mode correction
 
     // Private method AddCalData
     R3BFootCalData* AddCalData(Int_t detid, Int_t stripid, Double_t energy);
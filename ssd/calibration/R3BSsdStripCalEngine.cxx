@@ -0,0 +1,177 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BSsdStripCalEngine.h"
+#include "R3BLogger.h"
+
+#include "TArrayF.h"
+
+#include <algorithm>
+
+void R3BSsdStripCalEngine::SetParameters(Int_t nDets,
+                                         Int_t nStrips,
+                                         const TArrayF& params,
+                                         Int_t nParams,
+                                         Int_t pedestalIndex,
+                                         Int_t sigmaIndex)
+{
+    fNDets = nDets;
+    fNStrips = nStrips;
+    fNAsics = (nStrips + StripsPerAsic - 1) / StripsPerAsic;
+    const auto size = static_cast<std::size_t>(nDets) * nStrips;
+    if (params.GetSize() < nParams * static_cast<Int_t>(size))
+    {
+        R3BLOG(error, "Parameter array of size " << params.GetSize() << " for " << size << " strips");
+    }
+
+    fPedestal.assign(size, 0.F);
+    fSigma.assign(size, 0.F);
+    for (std::size_t idx = 0; idx < size; ++idx)
+    {
+        const auto offset = nParams * static_cast<Int_t>(idx);
+        if (offset + std::max(pedestalIndex, sigmaIndex) < params.GetSize())
+        {
+            fPedestal[idx] = params.At(offset + pedestalIndex);
+            fSigma[idx] = params.At(offset + sigmaIndex);
+        }
+    }
+    fAdc.assign(size, 0.);
+    fFilled.assign(size, 0);
+    fFilledDets.clear();
+    fEnergy.assign(nStrips, 0.);
+    fAsicAverage.assign(fNAsics, 0.);
+    fAsicCount.assign(fNAsics, 0.);
+    fHits.clear();
+}
+
+void R3BSsdStripCalEngine::Clear()
+{
+    for (auto det : fFilledDets)
+    {
+        std::fill_n(fFilled.begin() + det * fNStrips, fNStrips, 0);
+    }
+    fFilledDets.clear();
+    fHits.clear();
+}
+
+void R3BSsdStripCalEngine::Fill(Int_t det, Int_t strip, Double_t adc)
+{
+    if (det < 0 || det >= fNDets || strip < 0 || strip >= fNStrips)
+    {
+        R3BLOG(error, "Strip " << strip << " of detector " << det << " out of range");
+        return;
+    }
+    const auto idx = det * fNStrips + strip;
+    if (std::find(fFilledDets.begin(), fFilledDets.end(), det) == fFilledDets.end())
+    {
+        fFilledDets.push_back(det);
+    }
+    fAdc[idx] = adc;
+    fFilled[idx] = 1;
+}
+
+void R3BSsdStripCalEngine::CommonModeCorrect(Double_t timesSigma, Double_t maxStrips)
+{
+    fHits.clear();
+    auto* energy = fEnergy.data();
+    for (auto det : fFilledDets)
+    {
+        const auto* adc = &fAdc[det * fNStrips];
+        const auto* filled = &fFilled[det * fNStrips];
+        const auto* pedestal = &fPedestal[det * fNStrips];
+        const auto* sigma = &fSigma[det * fNStrips];
+
+        // Pedestal substraction
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            energy[strip] = adc[strip] - pedestal[strip];
+        }
+
+        // only use strips with signal below threshold for correction
+        Double_t average = 0.;
+        Int_t count = 0;
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            const auto isBaseline = filled[strip] != 0 && energy[strip] < timesSigma * sigma[strip];
+            average += isBaseline ? energy[strip] : 0.;
+            count += isBaseline ? 1 : 0;
+        }
+        average = average / count;
+
+        // Average correction
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            energy[strip] = energy[strip] - average;
+        }
+
+        std::fill(fAsicAverage.begin(), fAsicAverage.end(), 0.);
+        std::fill(fAsicCount.begin(), fAsicCount.end(), 0.);
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            const auto isBaseline = filled[strip] != 0 && energy[strip] < timesSigma * sigma[strip];
+            fAsicAverage[strip / StripsPerAsic] += isBaseline ? energy[strip] : 0.;
+            fAsicCount[strip / StripsPerAsic] += isBaseline ? 1. : 0.;
+        }
+        for (Int_t asic = 0; asic < fNAsics; ++asic)
+        {
+            fAsicAverage[asic] = fAsicAverage[asic] / fAsicCount[asic];
+        }
+
+        // ASIC Average correction, strips above 0 to disregard events with baseline jumps
+        Int_t nAboveZero = 0;
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            energy[strip] = energy[strip] - fAsicAverage[strip / StripsPerAsic];
+            nAboveZero += (filled[strip] != 0 && energy[strip] > 0. && pedestal[strip] != -1) ? 1 : 0;
+        }
+        if (nAboveZero >= maxStrips)
+        {
+            continue;
+        }
+
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            if (filled[strip] != 0 && energy[strip] > timesSigma * sigma[strip] && pedestal[strip] != -1)
+            {
+                fHits.push_back({ det, strip, energy[strip] });
+            }
+        }
+    }
+}
+
+void R3BSsdStripCalEngine::SubtractThreshold(Double_t timesSigma)
+{
+    fHits.clear();
+    auto* energy = fEnergy.data();
+    for (auto det : fFilledDets)
+    {
+        const auto* adc = &fAdc[det * fNStrips];
+        const auto* filled = &fFilled[det * fNStrips];
+        const auto* pedestal = &fPedestal[det * fNStrips];
+        const auto* sigma = &fSigma[det * fNStrips];
+
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            energy[strip] = adc[strip] - pedestal[strip] - timesSigma * sigma[strip];
+        }
+
+        // We accept the hit if the energy is larger than the threshold and the strip is not dead
+        for (Int_t strip = 0; strip < fNStrips; ++strip)
+        {
+            if (filled[strip] != 0 && energy[strip] > 0. && pedestal[strip] != -1)
+            {
+                fHits.push_back({ det, strip, energy[strip] });
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#ifndef R3BSSDSTRIPCALENGINE_H
+#define R3BSSDSTRIPCALENGINE_H 1
+
+#include <Rtypes.h>
+
+#include <vector>
+
+class TArrayF;
+
+/**
+ * Pedestal subtraction, common-mode correction and zero suppression of the
+ * strips of FOOT and AMS detectors.
+ *
+ * The ADC values of an event are filled into one dense array per detector,
+ * next to contiguous pedestal and sigma vectors in the same strip order.
+ * Each step is a loop over the strips of one detector, which the compiler
+ * vectorizes. The common-mode sums run in strip order, the order of the
+ * mapped data of the unpackers, so that the results are identical to the
+ * former per-hit implementation. Detectors and strips start at 0.
+ */
+class R3BSsdStripCalEngine
+{
+  public:
+    struct Hit
+    {
+        Int_t det;
+        Int_t strip;
+        Double_t energy;
+    };
+
+    /**
+     * Copies pedestal and sigma of each strip out of the parameter array,
+     * laid out as params[nParams * (det * nStrips + strip) + index].
+     */
+    void SetParameters(Int_t nDets,
+                       Int_t nStrips,
+                       const TArrayF& params,
+                       Int_t nParams,
+                       Int_t pedestalIndex,
+                       Int_t sigmaIndex);
+
+    /** Empties the detectors filled in the last event. */
+    void Clear();
+
+    /** Sets the ADC value of one strip. */
+    void Fill(Int_t det, Int_t strip, Double_t adc);
+
+    /**
+     * FOOT: subtracts the pedestal and the average of the strips below
+     * timesSigma * sigma, first of the whole detector, then of each ASIC.
+     * Strips above timesSigma * sigma are kept, for detectors with less
+     * than maxStrips strips above 0 (no baseline jump).
+     */
+    void CommonModeCorrect(Double_t timesSigma, Double_t maxStrips);
+
+    /** AMS: keeps the strips above pedestal + timesSigma * sigma, energy relative to this threshold. */
+    void SubtractThreshold(Double_t timesSigma);
+
+    /** Hits of the last correction, by detector in the order of filling, then by strip. */
+    const std::vector<Hit>& GetHits() const { return fHits; }
+
+    Int_t GetNumDets() const { return fNDets; }
+    Int_t GetNumStrips() const { return fNStrips; }
+
+    static constexpr Int_t StripsPerAsic = 64;
+
+  private:
+    Int_t fNDets = 0;
+    Int_t fNStrips = 0;
+    Int_t fNAsics = 0;
+    std::vector<Float_t> fPedestal; // [det * fNStrips + strip]
+    std::vector<Float_t> fSigma;    // [det * fNStrips + strip]
+    std::vector<Double_t> fAdc;     // [det * fNStrips + strip]
+    std::vector<UChar_t> fFilled;   // [det * fNStrips + strip]
+    std::vector<Int_t> fFilledDets;
+    std::vector<Double_t> fEnergy; // one detector
+    std::vector<Double_t> fAsicAverage;
+    std::vector<Double_t> fAsicCount;
+    std::vector<Hit> fHits;
+};
+
+#endif /* R3BSSDSTRIPCALENGINE_H */
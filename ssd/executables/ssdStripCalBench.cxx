@@ -0,0 +1,196 @@
+#include "R3BSsdStripCalEngine.h"
+#include "TArrayF.h"
+#include <algorithm>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fmt/format.h>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr auto NStrips = 640;
+    constexpr auto NParams = 2;
+    constexpr auto TimesSigma = 5.;
+    constexpr auto MaxStrips = 100.;
+
+    struct Mapped
+    {
+        int det;
+        int strip;
+        double adc;
+    };
+
+    // Per-hit correction of R3BFootMapped2StripCal before the dense engine
+    auto ReferenceFoot(const std::vector<Mapped>& hits, const TArrayF& params, int nDets) -> std::size_t
+    {
+        auto ave = std::vector<double>(nDets, 0.);
+        auto nAve = std::vector<int>(nDets, 0);
+        auto aveAsic = std::vector<std::vector<double>>(nDets, std::vector<double>(10, 0.));
+        auto nAveAsic = std::vector<std::vector<double>>(nDets, std::vector<double>(10, 0.));
+        auto counter = std::vector<int>(nDets, 0);
+        auto pedestal = [&](const Mapped& hit) -> double
+        { return params.GetAt(NParams * hit.strip + hit.det * NParams * NStrips); };
+        auto sigma = [&](const Mapped& hit) -> double
+        { return params.GetAt(NParams * hit.strip + 1 + hit.det * NParams * NStrips); };
+
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit);
+            if (energy < TimesSigma * sigma(hit))
+            {
+                ave[hit.det] += energy;
+                nAve[hit.det]++;
+            }
+        }
+        for (int det = 0; det < nDets; ++det)
+        {
+            ave[det] = ave[det] / nAve[det];
+        }
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit) - ave[hit.det];
+            if (energy < TimesSigma * sigma(hit))
+            {
+                aveAsic[hit.det][hit.strip / 64] += energy;
+                nAveAsic[hit.det][hit.strip / 64]++;
+            }
+        }
+        for (int det = 0; det < nDets; ++det)
+        {
+            for (int asic = 0; asic < 10; ++asic)
+            {
+                aveAsic[det][asic] = aveAsic[det][asic] / nAveAsic[det][asic];
+            }
+        }
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit) - ave[hit.det] - aveAsic[hit.det][hit.strip / 64];
+            if (energy > 0. && pedestal(hit) != -1)
+            {
+                counter[hit.det]++;
+            }
+        }
+        auto nHits = std::size_t{};
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit) - ave[hit.det] - aveAsic[hit.det][hit.strip / 64];
+            if (energy > TimesSigma * sigma(hit) && pedestal(hit) != -1 && counter[hit.det] < MaxStrips)
+            {
+                ++nHits;
+            }
+        }
+        return nHits;
+    }
+
+    // Full occupancy in the order of the unpacker, pedestal noise, common mode per ASIC and a few signals
+    auto MakeEvent(std::mt19937& random, const TArrayF& params, int nDets) -> std::vector<Mapped>
+    {
+        auto noise = std::normal_distribution<double>{ 0., 3. };
+        auto uniform = std::uniform_real_distribution<double>{ 0., 1. };
+        auto event = std::vector<Mapped>{};
+        event.reserve(static_cast<std::size_t>(nDets) * NStrips);
+        for (int det = 0; det < nDets; ++det)
+        {
+            auto commonMode = 0.;
+            for (int strip = 0; strip < NStrips; ++strip)
+            {
+                if (strip % 64 == 0)
+                {
+                    commonMode = 20. * (uniform(random) - 0.5);
+                }
+                const auto signal = uniform(random) < 0.02 ? 500. * uniform(random) : 0.;
+                const auto pedestal = std::max(params[NParams * (det * NStrips + strip)], 0.F);
+                event.push_back({ det, strip, pedestal + commonMode + noise(random) + signal });
+            }
+        }
+        return event;
+    }
+} // namespace
+
+// Time per event of the common mode correction of the FOOT detectors, per hit as in R3BFootMapped2StripCal
+// before and with R3BSsdStripCalEngine, at full occupancy.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of the SSD strip calibration" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("dets", po::value<int>()->default_value(16), "set number of detectors");
+    desc.add_options()("eventNum,n", po::value<int>()->default_value(200), "set number of events");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "ssdStripCalBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto nDets = varMap["dets"].as<int>();
+    const auto nEvents = varMap["eventNum"].as<int>();
+
+    auto random = std::mt19937{ 7 };
+    auto uniform = std::uniform_real_distribution<double>{ 0., 1. };
+    auto params = TArrayF{};
+    params.Set(nDets * NStrips * NParams);
+    for (int idx = 0; idx < nDets * NStrips; ++idx)
+    {
+        const auto dead = uniform(random) < 0.01;
+        params[NParams * idx] = dead ? -1.F : static_cast<Float_t>(200. + 100. * uniform(random));
+        params[NParams * idx + 1] = static_cast<Float_t>(2. + 3. * uniform(random));
+    }
+    auto engine = R3BSsdStripCalEngine{};
+    engine.SetParameters(nDets, NStrips, params, NParams, 0, 1);
+
+    auto events = std::vector<std::vector<Mapped>>{};
+    for (int event = 0; event < nEvents; ++event)
+    {
+        events.push_back(MakeEvent(random, params, nDets));
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto nReference = std::size_t{};
+    const auto startReference = Clock::now();
+    for (const auto& event : events)
+    {
+        nReference += ReferenceFoot(event, params, nDets);
+    }
+    const auto timeReference = Clock::now() - startReference;
+
+    auto nEngine = std::size_t{};
+    const auto startEngine = Clock::now();
+    for (const auto& event : events)
+    {
+        engine.Clear();
+        for (const auto& hit : event)
+        {
+            engine.Fill(hit.det, hit.strip, hit.adc);
+        }
+        engine.CommonModeCorrect(TimesSigma, MaxStrips);
+        nEngine += engine.GetHits().size();
+    }
+    const auto timeEngine = Clock::now() - startEngine;
+
+    if (nReference != nEngine)
+    {
+        std::cerr << "ssdStripCalBench: The engine found " << nEngine << " instead of " << nReference << " hits"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    using us = std::chrono::duration<double, std::micro>;
+    fmt::print("{} x {} strips\n", nDets, NStrips);
+    fmt::print("{:<22} {:>10.1f} us/event\n", "per-hit correction", us(timeReference).count() / nEvents);
+    fmt::print("{:<22} {:>10.1f} us/event\n", "R3BSsdStripCalEngine", us(timeEngine).count() / nEvents);
+    return 0;
+}
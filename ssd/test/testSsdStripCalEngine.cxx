@@ -0,0 +1,197 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BSsdStripCalEngine.h"
+#include "TArrayF.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr auto NDets = 16;
+    constexpr auto NStrips = 640;
+    constexpr auto NParams = 2;
+    constexpr auto TimesSigma = 5.;
+    constexpr auto MaxStrips = 100.;
+
+    struct Mapped
+    {
+        int det;
+        int strip;
+        double adc;
+    };
+
+    // Per-hit correction of R3BFootMapped2StripCal before the dense engine, as reference
+    auto ReferenceFoot(const std::vector<Mapped>& hits, const TArrayF& params)
+    {
+        auto ave = std::vector<double>(NDets, 0.);
+        auto nAve = std::vector<int>(NDets, 0);
+        auto aveAsic = std::vector<std::vector<double>>(NDets, std::vector<double>(10, 0.));
+        auto nAveAsic = std::vector<std::vector<double>>(NDets, std::vector<double>(10, 0.));
+        auto counter = std::vector<int>(NDets, 0);
+        auto pedestal = [&](const Mapped& hit) -> double
+        { return params.GetAt(NParams * hit.strip + hit.det * NParams * NStrips); };
+        auto sigma = [&](const Mapped& hit) -> double
+        { return params.GetAt(NParams * hit.strip + 1 + hit.det * NParams * NStrips); };
+
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit);
+            if (energy < TimesSigma * sigma(hit))
+            {
+                ave[hit.det] += energy;
+                nAve[hit.det]++;
+            }
+        }
+        for (int det = 0; det < NDets; ++det)
+        {
+            ave[det] = ave[det] / nAve[det];
+        }
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit) - ave[hit.det];
+            if (energy < TimesSigma * sigma(hit))
+            {
+                aveAsic[hit.det][hit.strip / 64] += energy;
+                nAveAsic[hit.det][hit.strip / 64]++;
+            }
+        }
+        for (int det = 0; det < NDets; ++det)
+        {
+            for (int asic = 0; asic < 10; ++asic)
+            {
+                aveAsic[det][asic] = aveAsic[det][asic] / nAveAsic[det][asic];
+            }
+        }
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit) - ave[hit.det] - aveAsic[hit.det][hit.strip / 64];
+            if (energy > 0. && pedestal(hit) != -1)
+            {
+                counter[hit.det]++;
+            }
+        }
+        auto result = std::vector<R3BSsdStripCalEngine::Hit>{};
+        for (const auto& hit : hits)
+        {
+            const auto energy = hit.adc - pedestal(hit) - ave[hit.det] - aveAsic[hit.det][hit.strip / 64];
+            if (energy > TimesSigma * sigma(hit) && pedestal(hit) != -1 && counter[hit.det] < MaxStrips)
+            {
+                result.push_back({ hit.det, hit.strip, energy });
+            }
+        }
+        return result;
+    }
+
+    class testSsdStripCalEngine : public ::testing::Test
+    {
+      protected:
+        void SetUp() override
+        {
+            auto uniform = std::uniform_real_distribution<double>{ 0., 1. };
+            params_.Set(NDets * NStrips * NParams);
+            for (int idx = 0; idx < NDets * NStrips; ++idx)
+            {
+                const auto dead = uniform(random_) < 0.01;
+                params_[NParams * idx] = dead ? -1.F : static_cast<Float_t>(200. + 100. * uniform(random_));
+                params_[NParams * idx + 1] = static_cast<Float_t>(2. + 3. * uniform(random_));
+            }
+            engine_.SetParameters(NDets, NStrips, params_, NParams, 0, 1);
+        }
+
+        // Full occupancy in the order of the unpacker, pedestal noise, common mode per ASIC and a few signals
+        auto MakeEvent(int nDets = NDets) -> std::vector<Mapped>
+        {
+            auto noise = std::normal_distribution<double>{ 0., 3. };
+            auto uniform = std::uniform_real_distribution<double>{ 0., 1. };
+            auto event = std::vector<Mapped>{};
+            event.reserve(static_cast<std::size_t>(nDets) * NStrips);
+            for (int det = 0; det < nDets; ++det)
+            {
+                auto commonMode = 0.;
+                for (int strip = 0; strip < NStrips; ++strip)
+                {
+                    if (strip % 64 == 0)
+                    {
+                        commonMode = 20. * (uniform(random_) - 0.5);
+                    }
+                    const auto signal = uniform(random_) < 0.02 ? 500. * uniform(random_) : 0.;
+                    const auto pedestal = std::max(params_[NParams * (det * NStrips + strip)], 0.F);
+                    event.push_back({ det, strip, pedestal + commonMode + noise(random_) + signal });
+                }
+            }
+            return event;
+        }
+
+        auto RunEngine(const std::vector<Mapped>& event) -> const std::vector<R3BSsdStripCalEngine::Hit>&
+        {
+            engine_.Clear();
+            for (const auto& hit : event)
+            {
+                engine_.Fill(hit.det, hit.strip, hit.adc);
+            }
+            engine_.CommonModeCorrect(TimesSigma, MaxStrips);
+            return engine_.GetHits();
+        }
+
+        std::mt19937 random_{ 7 };    // NOLINT
+        TArrayF params_;              // NOLINT
+        R3BSsdStripCalEngine engine_; // NOLINT
+    };
+
+    TEST_F(testSsdStripCalEngine, common_mode_identical)
+    {
+        for (int event = 0; event < 20; ++event)
+        {
+            const auto mapped = MakeEvent();
+            const auto expected = ReferenceFoot(mapped, params_);
+            const auto& hits = RunEngine(mapped);
+            ASSERT_EQ(hits.size(), expected.size()) << "event " << event;
+            for (std::size_t idx = 0; idx < hits.size(); ++idx)
+            {
+                EXPECT_EQ(hits[idx].det, expected[idx].det);
+                EXPECT_EQ(hits[idx].strip, expected[idx].strip);
+                EXPECT_EQ(hits[idx].energy, expected[idx].energy);
+            }
+        }
+    }
+
+    TEST_F(testSsdStripCalEngine, baseline_jump)
+    {
+        auto mapped = MakeEvent(1);
+        for (auto& hit : mapped)
+        {
+            hit.adc += hit.strip < NStrips / 2 ? 1000. : 0.;
+        }
+        EXPECT_TRUE(ReferenceFoot(mapped, params_).empty());
+        EXPECT_TRUE(RunEngine(mapped).empty());
+    }
+
+    TEST_F(testSsdStripCalEngine, subtract_threshold)
+    {
+        engine_.Clear();
+        engine_.Fill(2, 10, params_[NParams * (2 * NStrips + 10)] + 100.);
+        engine_.Fill(2, 11, params_[NParams * (2 * NStrips + 11)]);
+        engine_.Fill(NDets, 0, 1000.);
+        engine_.SubtractThreshold(TimesSigma);
+
+        const auto& hits = engine_.GetHits();
+        ASSERT_EQ(hits.size(), 1U);
+        EXPECT_EQ(hits[0].det, 2);
+        EXPECT_EQ(hits[0].strip, 10);
+        EXPECT_FLOAT_EQ(hits[0].energy, 100. - TimesSigma * params_[NParams * (2 * NStrips + 10) + 1]);
+    }
+} // namespace
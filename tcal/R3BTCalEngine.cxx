@@ -11,7 +11,13 @@
  * or submit itself to any jurisdiction.                                      *
  ******************************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "TH1F.h"
 #include "TMath.h"
@@ -20,23 +26,132 @@
 
 #include "R3BLogger.h"
 #include "R3BTCalEngine.h"
+#include "R3BTDCTraits.h"
 
-R3BTCalEngine::R3BTCalEngine(R3BTCalPar* param, Int_t minStats)
-    : fMinStats(minStats)
-    , fCal_Par(param)
-    , fClockFreq(0.)
+// The clock macros of R3BTCalEngine.h are still used directly by many detectors
+static_assert(TACQUILA_CLOCK_MHZ == R3B::TDC::Tacquila::clock_MHz, "TacQuila clock differs from R3BTDCTraits.h");
+static_assert(VFTX_CLOCK_MHZ == R3B::TDC::Vftx::clock_MHz, "VFTX clock differs from R3BTDCTraits.h");
+static_assert(CTDC_16_CLOCK_MHZ == R3B::TDC::ClockTDC150::clock_MHz, "CTDC clock differs from R3BTDCTraits.h");
+
+namespace
 {
-    for (Int_t i = 0; i < N_PLANE_MAX; i++)
+    // TDC values 0 .. 4096 in the bins 1 .. 4097, underflow in bin 0 and overflow in bin 4098
+    constexpr Int_t NBINS = 4097;
+    constexpr Int_t NROW = NBINS + 2;
+    constexpr Int_t NMODULES = N_PLANE_MAX * N_PADDLE_MAX * N_SIDE_MAX;
+
+    Int_t GetModuleIndex(Int_t plane, Int_t paddle, Int_t side)
     {
-        for (Int_t j = 0; j < N_PADDLE_MAX; j++)
+        return ((plane - 1) * N_PADDLE_MAX + (paddle - 1)) * N_SIDE_MAX + (side - 1);
+    }
+
+    template <typename Function>
+    void ParallelFor(std::size_t size, UInt_t nThreads, Function&& function)
+    {
+        if (nThreads == 0)
+        {
+            nThreads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        nThreads = static_cast<UInt_t>(std::min<std::size_t>(nThreads, size));
+        if (nThreads <= 1)
         {
-            for (Int_t k = 0; k < N_SIDE_MAX; k++)
+            for (std::size_t idx = 0; idx < size; ++idx)
             {
-                fhData[i][j][k] = NULL;
-                fhTime[i][j][k] = NULL;
+                function(idx);
             }
+            return;
+        }
+
+        // the first exception of the workers is rethrown on the calling thread
+        auto next = std::atomic<std::size_t>{ 0 };
+        auto exception = std::exception_ptr{};
+        auto exceptionMutex = std::mutex{};
+        auto threads = std::vector<std::thread>{};
+        for (UInt_t thread = 0; thread < nThreads; ++thread)
+        {
+            threads.emplace_back(
+                [&]()
+                {
+                    try
+                    {
+                        for (auto idx = next++; idx < size; idx = next++)
+                        {
+                            function(idx);
+                        }
+                    }
+                    catch (...)
+                    {
+                        auto lock = std::lock_guard{ exceptionMutex };
+                        if (!exception)
+                        {
+                            exception = std::current_exception();
+                        }
+                        next = size;
+                    }
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        if (exception)
+        {
+            std::rethrow_exception(exception);
         }
     }
+} // namespace
+
+R3BTCalEngine::Distribution::Distribution(const UInt_t* counts)
+    : fCounts(counts)
+    , fCumulative(NROW)
+{
+    auto sum = ULong64_t{};
+    auto sumInRange = ULong64_t{};
+    auto sumTdc = ULong64_t{};
+    for (Int_t bin = 0; bin < NROW; ++bin)
+    {
+        sum += counts[bin];
+        fCumulative[bin] = sum;
+        if (bin >= 1 && bin <= NBINS)
+        {
+            sumInRange += counts[bin];
+            sumTdc += static_cast<ULong64_t>(counts[bin]) * (bin - 1);
+        }
+    }
+    fEntries = static_cast<Double_t>(sum);
+    fMean = sumInRange > 0 ? static_cast<Double_t>(sumTdc) / static_cast<Double_t>(sumInRange) : 0.;
+}
+
+// Same bounds as TH1::Integral(binx1, binx2)
+Double_t R3BTCalEngine::Distribution::Integral(Int_t first, Int_t last) const
+{
+    first = std::max(first, 0);
+    last = std::min(last, NROW - 1);
+    if (last < first)
+    {
+        return 0.;
+    }
+    return static_cast<Double_t>(fCumulative[last] - (first > 0 ? fCumulative[first - 1] : 0));
+}
+
+R3BTCalEngine::R3BTCalEngine(R3BTCalPar* param, Int_t minStats)
+    : fMinStats(minStats)
+    , fRows(NMODULES, -1)
+    , fCal_Par(param)
+    , fClockFreq(0.)
+{
+}
+
+UInt_t* R3BTCalEngine::GetRow(Int_t module)
+{
+    auto& row = fRows[module];
+    if (row < 0)
+    {
+        row = static_cast<Int_t>(fModules.size());
+        fModules.push_back(module);
+        fCounts.resize(fCounts.size() + NROW, 0);
+    }
+    return &fCounts[static_cast<std::size_t>(row) * NROW];
 }
 
 void R3BTCalEngine::Fill(Int_t plane, Int_t paddle, Int_t side, Int_t tdc)
@@ -47,18 +162,21 @@ void R3BTCalEngine::Fill(Int_t plane, Int_t paddle, Int_t side, Int_t tdc)
         R3BLOG(error, "ranges: " << N_PLANE_MAX << " / " << N_PADDLE_MAX << " / " << N_SIDE_MAX);
         return;
     }
-    if (NULL == fhData[plane - 1][paddle - 1][side - 1])
+    auto const bin = tdc < 0 ? 0 : std::min(tdc + 1, NBINS + 1);
+    ++GetRow(GetModuleIndex(plane, paddle, side))[bin];
+}
+
+void R3BTCalEngine::Add(const R3BTCalEngine& other)
+{
+    for (std::size_t row = 0; row < other.fModules.size(); ++row)
     {
-        char strName[255];
-        sprintf(strName, "%s_tcaldata_%d_%d_%d", fCal_Par->GetName(), plane, paddle, side);
-        fhData[plane - 1][paddle - 1][side - 1] = new TH1F(strName, "", 4097, -0.5, 4096.5);
-        sprintf(strName, "%s_time_%d_%d_%d", fCal_Par->GetName(), plane, paddle, side);
-        fhTime[plane - 1][paddle - 1][side - 1] = new TH1F(strName, "", 4097, -0.5, 4096.5);
+        auto* counts = GetRow(other.fModules[row]);
+        const auto* otherCounts = &other.fCounts[row * NROW];
+        for (Int_t bin = 0; bin < NROW; ++bin)
+        {
+            counts[bin] += otherCounts[bin];
+        }
     }
-    fhData[plane - 1][paddle - 1][side - 1]->Fill(tdc);
-
-    //  LOG(info) << "R3BTCalEngine:: " << plane << " " << paddle<< " "<<side<<" "<< fhData[plane - 1][paddle - 1][side
-    //  - 1]->GetEntries();
 }
 
 void R3BTCalEngine::CalculateParamClockTDC(enum CTDCVariant a_variant)
@@ -66,303 +184,272 @@ void R3BTCalEngine::CalculateParamClockTDC(enum CTDCVariant a_variant)
     switch (a_variant)
     {
         case CTDC_8_12_FWD_250:
-            fClockFreq = 1000. / 250;
+            fClockFreq = R3B::TDC::clock_ns<R3B::TDC::ClockTDC>;
             break;
         case CTDC_16_BWD_150:
-            fClockFreq = 1000. / CTDC_16_CLOCK_MHZ;
+            fClockFreq = R3B::TDC::clock_ns<R3B::TDC::ClockTDC150>;
             break;
         default:
             assert(0 && "Invalid CTDC variant!");
     }
-
-    for (Int_t i = 0; i < N_PLANE_MAX; i++)
-    {
-        for (Int_t j = 0; j < N_PADDLE_MAX; j++)
-        {
-            for (Int_t k = 0; k < N_SIDE_MAX; k++)
-            {
-                if (NULL == fhData[i][j][k])
-                {
-                    continue;
-                }
-                if (fhData[i][j][k]->GetEntries() < fMinStats)
-                {
-                    continue;
-                }
-
-                // Define range of channels
-                Int_t ic, iMin, iMax;
-                FindRange(fhData[i][j][k], ic, iMin, iMax);
-                if (iMin < 0 || iMax > 4097)
-                {
-                    return;
-                }
-                R3BLOG(info, "Range of channels: " << iMin << " - " << iMax);
-
-                Int_t nparam = 0;
-                auto pTCal = new R3BTCalModulePar;
-                pTCal->SetPlane(i + 1);
-                pTCal->SetPaddle(j + 1);
-                pTCal->SetSide(k + 1);
-
-                Double_t total = fhData[i][j][k]->Integral(iMin, iMax);
-                for (Int_t ii = iMin; ii < iMax; ii++)
-                {
-                    auto bin_mid = fhData[i][j][k]->Integral(iMin, ii) + fhData[i][j][k]->GetBinContent(1 + ii) * 0.5;
-                    auto time_ns = bin_mid / total * fClockFreq;
-
-                    fhTime[i][j][k]->SetBinContent(1 + ii, time_ns);
-
-                    pTCal->SetBinLowAt(ii, nparam);
-                    pTCal->SetOffsetAt(time_ns, nparam);
-                    pTCal->IncrementNofChannels();
-                    nparam++;
-                }
-                fCal_Par->AddModulePar(pTCal);
-
-                R3BLOG(info, "Number of parameters: " << nparam);
-
-                fhData[i][j][k]->Write();
-                fhTime[i][j][k]->Write();
-
-                R3BLOG(info, "Module: " << (i + 1) << " / " << (j + 1) << " / " << (k + 1) << " is calibrated.");
-            }
-        }
-    }
-
-    fCal_Par->setChanged();
+    CalculateParam(&R3BTCalEngine::CalibrateClockTDC);
 }
 
 void R3BTCalEngine::CalculateParamTacquila()
 {
-    fClockFreq = 1. / TACQUILA_CLOCK_MHZ * 1000.;
+    fClockFreq = 1. / R3B::TDC::Tacquila::clock_MHz * 1000.;
+    CalculateParam(&R3BTCalEngine::CalibrateTacquila);
+}
+
+void R3BTCalEngine::CalculateParamVFTX()
+{
+    fClockFreq = 1. / R3B::TDC::Vftx::clock_MHz * 1000.;
+    CalculateParam(&R3BTCalEngine::CalibrateVFTX);
+}
 
-    for (Int_t i = 0; i < N_PLANE_MAX; i++)
+void R3BTCalEngine::CalculateParam(Calibrator calibrator)
+{
+    // rows in the order of the modules
+    auto rows = std::vector<Int_t>{};
+    for (auto row : fRows)
     {
-        for (Int_t j = 0; j < N_PADDLE_MAX; j++)
+        if (row >= 0)
         {
-            for (Int_t k = 0; k < N_SIDE_MAX; k++)
-            {
-                if (NULL == fhData[i][j][k])
-                {
-                    continue;
-                }
-                if (fhData[i][j][k]->GetEntries() < fMinStats)
-                {
-                    continue;
-                }
-
-                // Define range of channels
-                Int_t ic, iMin, iMax;
-                FindRange(fhData[i][j][k], ic, iMin, iMax);
-                if (iMin < 0 || iMax > 4097)
-                {
-                    return;
-                }
-                R3BLOG(info, "Range of channels: " << iMin << " - " << iMax);
-
-                Double_t total = fhData[i][j][k]->Integral(iMin, iMax);
-                for (Int_t ii = iMin; ii <= iMax; ii++)
-                {
-                    fhTime[i][j][k]->SetBinContent(ii, fhData[i][j][k]->Integral(iMin, ii) / total * fClockFreq);
-                }
-
-                Int_t nparam = 0;
-
-                R3BTCalModulePar* pTCal = NULL;
-                pTCal = new R3BTCalModulePar();
-                pTCal->SetPlane(i + 1);
-                pTCal->SetPaddle(j + 1);
-                pTCal->SetSide(k + 1);
-
-                Int_t il = ic - 10 + 1;
-                Int_t ih = ic;
-                while (il > iMin)
-                {
-                    Double_t slope = 0, offset = 0;
-                    LinearDown(fhData[i][j][k], iMin, iMax, il, ih, slope, offset);
-
-                    pTCal->SetBinLowAt(il, nparam);
-                    pTCal->SetBinUpAt(ih, nparam);
-                    pTCal->SetSlopeAt(slope, nparam);
-                    pTCal->SetOffsetAt(offset, nparam);
-                    pTCal->IncrementNofChannels();
-
-                    nparam += 1;
-
-                    ih = il;
-                    il = ih - 10 + 1;
-                }
+            rows.push_back(row);
+        }
+    }
 
-                if (ih > iMin)
-                {
-                    Double_t slope = 0, offset = 0;
-                    Double_t tot = fhData[i][j][k]->Integral(iMin, iMax);
-                    Double_t t1 = 0.;
-                    Double_t t2 = fhData[i][j][k]->Integral(iMin, ih) / tot * fClockFreq;
-                    slope = (t2 - t1) / (Double_t)(ih - iMin);
-                    offset = t1;
-
-                    pTCal->SetBinLowAt(iMin, nparam);
-                    pTCal->SetBinUpAt(ih, nparam);
-                    pTCal->SetSlopeAt(slope, nparam);
-                    pTCal->SetOffsetAt(offset, nparam);
-                    pTCal->IncrementNofChannels();
-
-                    nparam += 1;
-                }
-
-                il = ic;
-                ih = ic + 10 - 1;
-                while (ih <= iMax)
+    auto calibrations = std::vector<Calibration>(rows.size());
+    auto entries = std::vector<Double_t>(rows.size());
+    ParallelFor(rows.size(),
+                fNThreads,
+                [&](std::size_t idx)
                 {
-                    Double_t slope = 0, offset = 0;
-                    LinearUp(fhData[i][j][k], iMin, iMax, il, ih, slope, offset);
-
-                    pTCal->SetBinLowAt(il, nparam);
-                    pTCal->SetBinUpAt(ih, nparam);
-                    pTCal->SetSlopeAt(slope, nparam);
-                    pTCal->SetOffsetAt(offset, nparam);
-                    pTCal->IncrementNofChannels();
-
-                    nparam += 1;
-
-                    il = ih;
-                    if ((iMax - ih) < 100)
-                    {
-                        ih = il + 5 - 1;
-                    }
-                    else
+                    const auto data = Distribution(&fCounts[static_cast<std::size_t>(rows[idx]) * NROW]);
+                    entries[idx] = data.GetEntries();
+                    if (entries[idx] >= fMinStats)
                     {
-                        ih = il + 10 - 1;
+                        calibrations[idx] = (this->*calibrator)(data);
                     }
-                }
-
-                if (il < iMax)
-                {
-                    Double_t slope = 0, offset = 0;
-                    Double_t tot = fhData[i][j][k]->Integral(iMin, iMax);
-                    Double_t t1 = fhData[i][j][k]->Integral(iMin, il) / tot * fClockFreq;
-                    Double_t t2 = fClockFreq;
-                    slope = (t2 - t1) / (Double_t)(iMax - il);
-                    offset = t1;
-
-                    pTCal->SetBinLowAt(il, nparam);
-                    pTCal->SetBinUpAt(iMax, nparam);
-                    pTCal->SetSlopeAt(slope, nparam);
-                    pTCal->SetOffsetAt(offset, nparam);
-                    pTCal->IncrementNofChannels();
+                });
 
-                    nparam += 1;
-                }
-
-                fCal_Par->AddModulePar(pTCal);
-
-                R3BLOG(info, "Number of parameters: " << nparam);
+    for (std::size_t idx = 0; idx < rows.size(); ++idx)
+    {
+        if (entries[idx] < fMinStats)
+        {
+            continue;
+        }
+        const auto& calibration = calibrations[idx];
+        if (!calibration.error.empty())
+        {
+            R3BLOG(fatal, calibration.error);
+        }
+        if (!calibration.valid)
+        {
+            R3BLOG(warn, "Out of range, Min: " << calibration.binMin << " , Max: " << calibration.binMax);
+            return;
+        }
+        R3BLOG(info, "Range of channels: " << calibration.binMin << " - " << calibration.binMax);
+
+        const auto module = fModules[rows[idx]];
+        const auto side = module % N_SIDE_MAX + 1;
+        const auto paddle = module / N_SIDE_MAX % N_PADDLE_MAX + 1;
+        const auto plane = module / N_SIDE_MAX / N_PADDLE_MAX + 1;
+
+        auto pTCal = new R3BTCalModulePar;
+        pTCal->SetPlane(plane);
+        pTCal->SetPaddle(paddle);
+        pTCal->SetSide(side);
+        Int_t nparam = 0;
+        for (const auto& segment : calibration.segments)
+        {
+            pTCal->SetBinLowAt(segment.binLow, nparam);
+            if (calibration.linear)
+            {
+                pTCal->SetBinUpAt(segment.binUp, nparam);
+                pTCal->SetSlopeAt(segment.slope, nparam);
+            }
+            pTCal->SetOffsetAt(segment.offset, nparam);
+            pTCal->IncrementNofChannels();
+            nparam++;
+        }
+        fCal_Par->AddModulePar(pTCal);
 
-                fhData[i][j][k]->Write();
-                fhTime[i][j][k]->Write();
+        R3BLOG(info, "Number of parameters: " << nparam);
 
-                R3BLOG(info, "Module: " << (i + 1) << " / " << (j + 1) << " / " << (k + 1) << " is calibrated.");
-            }
+        // histograms of the former implementation, for inspection
+        char strName[255];
+        sprintf(strName, "%s_tcaldata_%d_%d_%d", fCal_Par->GetName(), plane, paddle, side);
+        auto hData = new TH1F(strName, "", NBINS, -0.5, 4096.5);
+        sprintf(strName, "%s_time_%d_%d_%d", fCal_Par->GetName(), plane, paddle, side);
+        auto hTime = new TH1F(strName, "", NBINS, -0.5, 4096.5);
+        const auto* counts = &fCounts[static_cast<std::size_t>(rows[idx]) * NROW];
+        for (Int_t bin = 0; bin < NROW; ++bin)
+        {
+            hData->SetBinContent(bin, counts[bin]);
+        }
+        hData->SetEntries(entries[idx]);
+        for (const auto& [bin, time] : calibration.time)
+        {
+            hTime->SetBinContent(bin, time);
         }
+        hData->Write();
+        hTime->Write();
+
+        R3BLOG(info, "Module: " << plane << " / " << paddle << " / " << side << " is calibrated.");
     }
+
     fCal_Par->setChanged();
 }
 
-void R3BTCalEngine::CalculateParamVFTX()
+R3BTCalEngine::Calibration R3BTCalEngine::CalibrateClockTDC(const Distribution& data) const
 {
-    fClockFreq = 1. / VFTX_CLOCK_MHZ * 1000.;
-
-    for (Int_t i = 0; i < N_PLANE_MAX; i++)
+    auto calibration = Calibration{};
+
+    // Define range of channels
+    Int_t ic, iMin, iMax;
+    FindRange(data, ic, iMin, iMax);
+    calibration.binMin = iMin;
+    calibration.binMax = iMax;
+    if (iMin < 0 || iMax > 4097)
     {
-        //  LOG(info) << "R3BTCalEngine::CalculateParamVFTX() : Plane: " << i;
-        for (Int_t j = 0; j < N_PADDLE_MAX; j++)
-        {
-            //	 LOG(info) << "R3BTCalEngine::CalculateParamVFTX() : Paddle: " << j;
+        return calibration;
+    }
+    calibration.valid = kTRUE;
 
-            for (Int_t k = 0; k < N_SIDE_MAX; k++)
-            {
+    Double_t total = data.Integral(iMin, iMax);
+    for (Int_t ii = iMin; ii < iMax; ii++)
+    {
+        auto bin_mid = data.Integral(iMin, ii) + data.GetBinContent(1 + ii) * 0.5;
+        auto time_ns = bin_mid / total * fClockFreq;
 
-                // if(i == 0)   LOG(info) << "R3BTCalEngine::CalculateParamVFTX() : Detector: "<<i<<", Channel: "<<j<<",
-                // Type: " << k;
+        calibration.time.emplace_back(1 + ii, time_ns);
+        calibration.segments.push_back({ ii, 0, 0., time_ns });
+    }
+    return calibration;
+}
 
-                if (NULL == fhData[i][j][k])
-                {
-                    //			LOG(info) << "R3BTCalEngine::CalculateParamVFTX() : NULL: " << fhData[i][j][k];
-                    continue;
-                }
-                if (fhData[i][j][k]->GetEntries() < fMinStats)
-                {
-                    //			LOG(info) << "R3BTCalEngine::CalculateParamVFTX() : fMinStatus: " <<
-                    // fhData[i][j][k]->GetEntries()<<", "<<fMinStats;
-                    continue;
-                }
-
-                // Define range of channels
-                Int_t ic, iMin, iMax;
-                FindRange(fhData[i][j][k], ic, iMin, iMax);
-                if (iMin < 0 || iMax > 4097)
-                {
-                    R3BLOG(warn, "Out of range, Min: " << iMin << " , Max: " << iMax);
-                    return;
-                }
-                R3BLOG(info, "Range of channels: " << iMin << " - " << iMax);
+R3BTCalEngine::Calibration R3BTCalEngine::CalibrateTacquila(const Distribution& data) const
+{
+    auto calibration = Calibration{};
+    calibration.linear = kTRUE;
+
+    // Define range of channels
+    Int_t ic, iMin, iMax;
+    FindRange(data, ic, iMin, iMax);
+    calibration.binMin = iMin;
+    calibration.binMax = iMax;
+    if (iMin < 0 || iMax > 4097)
+    {
+        return calibration;
+    }
+    calibration.valid = kTRUE;
 
-                Double_t total = fhData[i][j][k]->Integral(iMin, iMax);
-                for (Int_t ii = iMin; ii <= iMax; ii++)
-                {
-                    fhTime[i][j][k]->SetBinContent(ii, fhData[i][j][k]->Integral(iMin, ii) / total * fClockFreq);
-                }
+    Double_t total = data.Integral(iMin, iMax);
+    for (Int_t ii = iMin; ii <= iMax; ii++)
+    {
+        calibration.time.emplace_back(ii, data.Integral(iMin, ii) / total * fClockFreq);
+    }
 
-                Int_t nparam = 0;
+    Int_t il = ic - 10 + 1;
+    Int_t ih = ic;
+    while (il > iMin)
+    {
+        Double_t slope = 0, offset = 0;
+        LinearDown(data, iMin, iMax, il, ih, slope, offset);
+        calibration.segments.push_back({ il, ih, slope, offset });
 
-                R3BTCalModulePar* pTCal = NULL;
-                pTCal = new R3BTCalModulePar();
-                pTCal->SetPlane(i + 1);
-                pTCal->SetPaddle(j + 1);
-                pTCal->SetSide(k + 1);
+        ih = il;
+        il = ih - 10 + 1;
+    }
 
-                for (Int_t ibin = iMin; ibin <= iMax; ibin++)
-                {
-                    Double_t time = fhData[i][j][k]->Integral(iMin, ibin) / total;
-                    if (time > 1.)
-                    {
-                        LOG(fatal) << "Integration error.";
-                    }
-                    time *= fClockFreq;
+    if (ih > iMin)
+    {
+        Double_t t1 = 0.;
+        Double_t t2 = data.Integral(iMin, ih) / total * fClockFreq;
+        Double_t slope = (t2 - t1) / (Double_t)(ih - iMin);
+        calibration.segments.push_back({ iMin, ih, slope, t1 });
+    }
 
-                    pTCal->SetBinLowAt(ibin, nparam);
-                    pTCal->SetOffsetAt(time, nparam);
-                    pTCal->IncrementNofChannels();
-                    nparam += 1;
-                }
+    il = ic;
+    ih = ic + 10 - 1;
+    while (ih <= iMax)
+    {
+        Double_t slope = 0, offset = 0;
+        if (!LinearUp(data, iMin, iMax, il, ih, slope, offset))
+        {
+            calibration.error = "Integration error";
+            return calibration;
+        }
+        calibration.segments.push_back({ il, ih, slope, offset });
 
-                fCal_Par->AddModulePar(pTCal);
+        il = ih;
+        if ((iMax - ih) < 100)
+        {
+            ih = il + 5 - 1;
+        }
+        else
+        {
+            ih = il + 10 - 1;
+        }
+    }
 
-                R3BLOG(info, "Number of parameters: " << nparam);
+    if (il < iMax)
+    {
+        Double_t t1 = data.Integral(iMin, il) / total * fClockFreq;
+        Double_t t2 = fClockFreq;
+        Double_t slope = (t2 - t1) / (Double_t)(iMax - il);
+        calibration.segments.push_back({ il, iMax, slope, t1 });
+    }
+    return calibration;
+}
 
-                fhData[i][j][k]->Write();
-                fhTime[i][j][k]->Write();
+R3BTCalEngine::Calibration R3BTCalEngine::CalibrateVFTX(const Distribution& data) const
+{
+    auto calibration = Calibration{};
+
+    // Define range of channels
+    Int_t ic, iMin, iMax;
+    FindRange(data, ic, iMin, iMax);
+    calibration.binMin = iMin;
+    calibration.binMax = iMax;
+    if (iMin < 0 || iMax > 4097)
+    {
+        return calibration;
+    }
+    calibration.valid = kTRUE;
 
-                R3BLOG(info, "Module: " << (i + 1) << " / " << (j + 1) << " / " << (k + 1) << " is calibrated.");
-            }
+    Double_t total = data.Integral(iMin, iMax);
+    for (Int_t ibin = iMin; ibin <= iMax; ibin++)
+    {
+        Double_t time = data.Integral(iMin, ibin) / total;
+        if (time > 1.)
+        {
+            calibration.error = "Integration error.";
+            return calibration;
         }
+        time *= fClockFreq;
+
+        calibration.time.emplace_back(ibin, time);
+        calibration.segments.push_back({ ibin, 0, 0., time });
     }
-    fCal_Par->setChanged();
+    return calibration;
 }
 
 // iMin == left side of fine times.
 // iMax == right side of fine times.
 // I.e. iMin <= fine-time <= iMax-1.
-void R3BTCalEngine::FindRange(TH1F* h1, Int_t& ic, Int_t& iMin, Int_t& iMax)
+void R3BTCalEngine::FindRange(const Distribution& data, Int_t& ic, Int_t& iMin, Int_t& iMax) const
 {
-    Double_t mean = h1->GetMean();
+    Double_t mean = data.GetMean();
     ic = (Int_t)(mean + 0.5);
 
+    // an empty range is rejected by the callers
+    iMin = -1;
+    iMax = -1;
     for (Int_t i = 1; i <= 4097; i++)
     {
-        if (h1->GetBinContent(i) > 0)
+        if (data.GetBinContent(i) > 0)
         {
             iMin = i - 1;
             break;
@@ -371,7 +458,7 @@ void R3BTCalEngine::FindRange(TH1F* h1, Int_t& ic, Int_t& iMin, Int_t& iMax)
 
     for (Int_t i = 4097; i >= 1; i--)
     {
-        if (h1->GetBinContent(i) > 0)
+        if (data.GetBinContent(i) > 0)
         {
             iMax = i;
             break;
@@ -379,21 +466,27 @@ void R3BTCalEngine::FindRange(TH1F* h1, Int_t& ic, Int_t& iMin, Int_t& iMax)
     }
 }
 
-void R3BTCalEngine::LinearUp(TH1F* h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t& ih, Double_t& slope, Double_t& offset)
+Bool_t R3BTCalEngine::LinearUp(const Distribution& data,
+                               Int_t iMin,
+                               Int_t iMax,
+                               Int_t& il,
+                               Int_t& ih,
+                               Double_t& slope,
+                               Double_t& offset) const
 {
-    Double_t tot = h1->Integral(iMin, iMax);
-    Double_t t1 = h1->Integral(iMin, il) / tot; // * fClockFreq;
-    Double_t t2 = h1->Integral(iMin, ih) / tot; // * fClockFreq;
+    Double_t tot = data.Integral(iMin, iMax);
+    Double_t t1 = data.Integral(iMin, il) / tot; // * fClockFreq;
+    Double_t t2 = data.Integral(iMin, ih) / tot; // * fClockFreq;
     if (t1 > 1. || t2 > 1.)
     {
-        R3BLOG(fatal, "Integration error");
+        return kFALSE;
     }
     t1 *= fClockFreq;
     t2 *= fClockFreq;
     slope = (t2 - t1) / (Double_t)(ih - il);
     offset = t1;
 
-    Double_t prec = 3. / TMath::Sqrt(h1->GetEntries());
+    Double_t prec = 3. / TMath::Sqrt(data.GetEntries());
 
     Double_t slope1;
 
@@ -405,7 +498,7 @@ void R3BTCalEngine::LinearUp(TH1F* h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t&
         {
             break;
         }
-        Double_t t21 = h1->Integral(iMin, ih_next) / tot * fClockFreq;
+        Double_t t21 = data.Integral(iMin, ih_next) / tot * fClockFreq;
         slope1 = (t21 - t1) / (Double_t)(ih_next - il);
 
         Double_t dev = TMath::Abs(slope1 - slope) / TMath::Abs(slope);
@@ -419,23 +512,24 @@ void R3BTCalEngine::LinearUp(TH1F* h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t&
             break;
         }
     }
+    return kTRUE;
 }
 
-void R3BTCalEngine::LinearDown(TH1F* h1,
+void R3BTCalEngine::LinearDown(const Distribution& data,
                                Int_t iMin,
                                Int_t iMax,
                                Int_t& il,
                                Int_t& ih,
                                Double_t& slope,
-                               Double_t& offset)
+                               Double_t& offset) const
 {
-    Double_t tot = h1->Integral(iMin, iMax);
-    Double_t t1 = h1->Integral(iMin, il) / tot * fClockFreq;
-    Double_t t2 = h1->Integral(iMin, ih) / tot * fClockFreq;
+    Double_t tot = data.Integral(iMin, iMax);
+    Double_t t1 = data.Integral(iMin, il) / tot * fClockFreq;
+    Double_t t2 = data.Integral(iMin, ih) / tot * fClockFreq;
     slope = (t2 - t1) / (Double_t)(ih - il);
     offset = t1;
 
-    Double_t prec = 3. / TMath::Sqrt(h1->GetEntries());
+    Double_t prec = 3. / TMath::Sqrt(data.GetEntries());
 
     Double_t slope1;
     Double_t offset1;
@@ -448,8 +542,8 @@ void R3BTCalEngine::LinearDown(TH1F* h1,
         {
             break;
         }
-        Double_t t11 = h1->Integral(iMin, il_next) / tot * fClockFreq;
-        Double_t t21 = h1->Integral(iMin, ih_next) / tot * fClockFreq;
+        Double_t t11 = data.Integral(iMin, il_next) / tot * fClockFreq;
+        Double_t t21 = data.Integral(iMin, ih_next) / tot * fClockFreq;
         slope1 = (t21 - t11) / (Double_t)(ih_next - il_next);
         offset1 = t11;
 
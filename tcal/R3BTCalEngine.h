@@ -26,7 +26,8 @@
 #include "R3BTCalPar.h"
 #include "TObject.h"
 
-class TH1F;
+#include <string>
+#include <vector>
 
 /**
  * Class with implementation of TCAL time calibration.
@@ -35,13 +36,15 @@ class TH1F;
  * clock cycle in ns is calculated from it.
  * Recommended value of minimum statistics per module is
  * 10000 entries.
+ * The raw TDC counts of all filled modules are kept in one
+ * contiguous matrix, the modules are calibrated in parallel.
  * @author D. Kresan
  * @since September 4, 2015
  */
 class R3BTCalEngine : public TObject
 {
   public:
-    // CTDC variants.
+    // CTDC variants, R3B::TDC::ClockTDC and R3B::TDC::ClockTDC150 in R3BTDCTraits.h.
     enum CTDCVariant
     {
         // To make sure the user doesn't just put a 0...
@@ -79,6 +82,19 @@ class R3BTCalEngine : public TObject
      */
     void Fill(Int_t plane, Int_t paddle, Int_t side, Int_t tdc);
 
+    /**
+     * A method to add the TDC distributions of another engine, e.g.
+     * one filled on another thread.
+     * @param other an engine with the same binning.
+     */
+    void Add(const R3BTCalEngine& other);
+
+    /**
+     * Sets the number of threads used to calibrate the modules.
+     * @param nThreads a number of threads, 0 uses all cores.
+     */
+    void SetNThreads(UInt_t nThreads) { fNThreads = nThreads; }
+
     /**
      * A method to calculate calibration parameters for clock TDC
      * electronics. Parameters will be automatically stored.
@@ -101,32 +117,82 @@ class R3BTCalEngine : public TObject
     void CalculateParamVFTX();
 
   protected:
+    /**
+     * Raw TDC distribution of one module with the binning of the former
+     * TH1F(4097, -0.5, 4096.5), including the underflow (0) and overflow
+     * (4098) bins. Integrals are taken from cumulative sums.
+     */
+    class Distribution
+    {
+      public:
+        explicit Distribution(const UInt_t* counts);
+        Double_t GetBinContent(Int_t bin) const { return fCounts[bin]; }
+        Double_t Integral(Int_t first, Int_t last) const;
+        Double_t GetEntries() const { return fEntries; }
+        Double_t GetMean() const { return fMean; }
+
+      private:
+        const UInt_t* fCounts;
+        std::vector<ULong64_t> fCumulative; // sum of the bins 0 .. i
+        Double_t fEntries = 0.;
+        Double_t fMean = 0.; // of the entries without under- and overflow
+    };
+
+    /**
+     * Linear segments of the calibration of one module and the
+     * bin-by-bin calibration of its distribution.
+     */
+    struct Calibration
+    {
+        struct Segment
+        {
+            Int_t binLow;
+            Int_t binUp;
+            Double_t slope;
+            Double_t offset;
+        };
+        Bool_t valid = kFALSE;  /**< kFALSE if the range of the distribution is invalid. */
+        Bool_t linear = kFALSE; /**< Segments with an upper bound and a slope. */
+        Int_t binMin = -1;      /**< Range of channels of the distribution. */
+        Int_t binMax = -1;
+        std::vector<Segment> segments;
+        std::vector<std::pair<Int_t, Double_t>> time; /**< bin and time [ns] */
+        std::string error; /**< Logged on the calling thread, empty if the calibration succeeded. */
+    };
+
     /**
      * A method to determine the range of a TDC distribution.
-     * @param h1 a pointer to the histogram with data.
+     * @param data the distribution.
      * @param ic output: center of distribution.
      * @param iMin output: lower bound.
      * @param iMax output: upper bound.
      */
-    void FindRange(TH1F* h1, Int_t& ic, Int_t& iMin, Int_t& iMax);
+    void FindRange(const Distribution& data, Int_t& ic, Int_t& iMin, Int_t& iMax) const;
 
     /**
      * A method to interpolate a section of the raw TDC distribution
      * starting from the middle towards the lower bound.
-     * @param h1 a pointer to the histogram with data.
+     * @param data the distribution.
      * @param iMin a lower bound.
      * @param iMax an upper bound.
      * @param il an initial value and output of a lower bound of the section.
      * @param ih an initial value and output of an upper bound of the section.
      * @param slope output: a slope of linear interpolation.
      * @param offset output: an offset of linear interpolation (value at il).
+     * @return kFALSE on an integration error.
      */
-    void LinearUp(TH1F* h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t& ih, Double_t& slope, Double_t& offset);
+    Bool_t LinearUp(const Distribution& data,
+                    Int_t iMin,
+                    Int_t iMax,
+                    Int_t& il,
+                    Int_t& ih,
+                    Double_t& slope,
+                    Double_t& offset) const;
 
     /**
      * A method to interpolate a section of the raw TDC distribution
      * starting from the middle towards the upper bound.
-     * @param h1 a pointer to the histogram with data.
+     * @param data the distribution.
      * @param iMin a lower bound.
      * @param iMax an upper bound.
      * @param il an initial value and output of a lower bound of the section.
@@ -134,18 +200,40 @@ class R3BTCalEngine : public TObject
      * @param slope output: a slope of linear interpolation.
      * @param offset output: an offset of linear interpolation (value at il).
      */
-    void LinearDown(TH1F* h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t& ih, Double_t& slope, Double_t& offset);
+    void LinearDown(const Distribution& data,
+                    Int_t iMin,
+                    Int_t iMax,
+                    Int_t& il,
+                    Int_t& ih,
+                    Double_t& slope,
+                    Double_t& offset) const;
 
   private:
-    Int_t fMinStats; /**< Minimum number of entries in raw TDC distribution per module */
-    TH1F* fhData[N_PLANE_MAX][N_PADDLE_MAX][N_SIDE_MAX]; /**< An array of histograms to store raw TDC distributions. */
-    TH1F* fhTime[N_PLANE_MAX][N_PADDLE_MAX]
-                [N_SIDE_MAX]; /**< An array of histograms to store unparametrized bin-by-bin calibration. */
-    R3BTCalPar* fCal_Par;     /**< A pointer to the parameter container. */
-    Double_t fClockFreq;      /**< A clock cycle in [ns]. */
+    using Calibrator = Calibration (R3BTCalEngine::*)(const Distribution&) const;
+
+    Calibration CalibrateClockTDC(const Distribution& data) const;
+    Calibration CalibrateTacquila(const Distribution& data) const;
+    Calibration CalibrateVFTX(const Distribution& data) const;
+
+    /**
+     * Calibrates all modules with enough entries in parallel and stores
+     * the parameters and histograms in the order of the modules. Errors
+     * of the calibrations are logged afterwards, on the calling thread.
+     */
+    void CalculateParam(Calibrator calibrator);
+
+    Int_t fMinStats;             /**< Minimum number of entries in raw TDC distribution per module */
+    UInt_t fNThreads = 0;        /**< Number of threads for the calibration, 0 for all cores. */
+    std::vector<UInt_t> fCounts; //! Raw TDC distributions, one row of bins per filled module
+    std::vector<Int_t> fRows;    //! Row in fCounts of each module, -1 if not filled
+    std::vector<Int_t> fModules; //! Module of each row
+    R3BTCalPar* fCal_Par;        /**< A pointer to the parameter container. */
+    Double_t fClockFreq;         /**< A clock cycle in [ns]. */
+
+    UInt_t* GetRow(Int_t module);
 
   public:
-    ClassDef(R3BTCalEngine, 1)
+    ClassDef(R3BTCalEngine, 2)
 };
 
 #endif
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BTCalLookup.h"
+#include "R3BLogger.h"
+#include "R3BTCalModulePar.h"
+#include "R3BTCalPar.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Number of fine time values [0, size) which can match a bin of the module.
+    Int_t GetTableSize(const R3BTCalModulePar* par, R3BTCalLookup::Type type)
+    {
+        Int_t maxBin = 0;
+        for (Int_t i = 0; i < par->GetNofChannels(); i++)
+        {
+            const auto bin = (type == R3BTCalLookup::Type::Tacquila) ? par->GetBinUpAt(i) : par->GetBinLowAt(i);
+            maxBin = std::max(maxBin, bin);
+        }
+        // ClockTDC matches tdc == bin, VFTX and Tacquila match tdc + 1 == bin
+        return (type == R3BTCalLookup::Type::ClockTDC) ? maxBin + 1 : maxBin;
+    }
+
+    Double_t GetModuleTime(R3BTCalModulePar* par, R3BTCalLookup::Type type, Int_t tdc)
+    {
+        switch (type)
+        {
+            case R3BTCalLookup::Type::ClockTDC:
+                return par->GetTimeClockTDC(tdc);
+            case R3BTCalLookup::Type::Tacquila:
+                return par->GetTimeTacquila(tdc);
+            case R3BTCalLookup::Type::VFTX:
+            default:
+                return par->GetTimeVFTX(tdc);
+        }
+    }
+} // namespace
+
+Bool_t R3BTCalLookup::Build(R3BTCalPar* par, Type type)
+{
+    Clear();
+    if (!par || par->GetNumModulePar() == 0)
+    {
+        R3BLOG(error, "No TCal parameters to build the lookup table from");
+        return kFALSE;
+    }
+    fType = type;
+
+    auto* modules = par->GetListOfModulePar();
+    std::vector<R3BTCalModulePar*> valid;
+    valid.reserve(modules->GetEntries());
+    for (Int_t i = 0; i < modules->GetEntries(); i++)
+    {
+        auto* module = dynamic_cast<R3BTCalModulePar*>(modules->At(i));
+        if (!module)
+        {
+            continue;
+        }
+        if (module->GetPlane() < 1 || module->GetPlane() > N_PLANE_MAX || module->GetPaddle() < 1 ||
+            module->GetPaddle() > N_PADDLE_MAX || module->GetSide() < 1 || module->GetSide() > N_SIDE_MAX)
+        {
+            R3BLOG(error,
+                   "error in plane/paddle/side indexing. " << module->GetPlane() << " / " << module->GetPaddle()
+                                                           << " / " << module->GetSide());
+            continue;
+        }
+        fNofPlanes = std::max(fNofPlanes, module->GetPlane());
+        fNofPaddles = std::max(fNofPaddles, module->GetPaddle());
+        fNofSides = std::max(fNofSides, module->GetSide());
+        valid.push_back(module);
+    }
+
+    fChannels.assign(fNofPlanes * fNofPaddles * fNofSides, Channel{ 0, 0, nullptr });
+    for (auto* module : valid)
+    {
+        auto& channel = fChannels[GetIndex(module->GetPlane(), module->GetPaddle(), module->GetSide())];
+        if (channel.par)
+        {
+            // same behaviour as R3BTCalPar::GetModuleParAt(), the first one wins
+            R3BLOG(error,
+                   "parameter found more than once. " << module->GetPlane() << " / " << module->GetPaddle() << " / "
+                                                      << module->GetSide());
+            continue;
+        }
+        channel.offset = static_cast<Int_t>(fTimes.size());
+        channel.size = GetTableSize(module, fType);
+        channel.par = module;
+        for (Int_t tdc = 0; tdc < channel.size; tdc++)
+        {
+            fTimes.push_back(GetModuleTime(module, fType, tdc));
+        }
+    }
+
+    R3BLOG(info,
+           "Built TCal lookup table for " << valid.size() << " channels with " << fTimes.size() << " fine time values");
+    return kTRUE;
+}
+
+void R3BTCalLookup::Clear()
+{
+    fNofPlanes = fNofPaddles = fNofSides = 0;
+    fChannels.clear();
+    fTimes.clear();
+}
+
+Double_t R3BTCalLookup::GetTimeFromPar(const Channel& channel, Int_t tdc) const
+{
+    return GetModuleTime(channel.par, fType, tdc);
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BTCALLOOKUP_H
+#define R3BTCALLOOKUP_H 1
+
+#include "Rtypes.h"
+#include <vector>
+
+class R3BTCalPar;
+class R3BTCalModulePar;
+
+/**
+ * Flat lookup table of the fine time calibration of all channels in a
+ * R3BTCalPar container. For every (plane, paddle, side) the time in [ns] of
+ * each fine time value is evaluated once through R3BTCalModulePar and stored
+ * in one contiguous array, such that the calibration of a hit is a table load
+ * instead of a map lookup followed by a scan over all bins.
+ * The table is meant to be (re)built from Init()/ReInit() of a task.
+ * Results are identical to the corresponding R3BTCalModulePar::GetTime*().
+ */
+class R3BTCalLookup
+{
+  public:
+    /** Electronics type, selects the R3BTCalModulePar::GetTime* method to tabulate. */
+    enum class Type
+    {
+        ClockTDC,
+        Tacquila,
+        VFTX
+    };
+
+    /** Parameters of a single channel. */
+    struct Channel
+    {
+        Int_t offset;          /**< first entry of the channel in the time table */
+        Int_t size;            /**< number of tabulated fine time values */
+        R3BTCalModulePar* par; /**< module parameters, used outside of the tabulated range */
+    };
+
+    /** Value returned by R3BTCalModulePar if no bin matches. */
+    static constexpr Double_t kNoTime = -10000.;
+
+    R3BTCalLookup() = default;
+
+    /**
+     * Method to (re)build the table.
+     * @param par a pointer to the parameter container.
+     * @param type electronics type of the container.
+     * @return kFALSE if the container is missing or empty.
+     */
+    Bool_t Build(R3BTCalPar* par, Type type);
+
+    /** Method to release the table. */
+    void Clear();
+
+    /** @return kTRUE if the table has been built. */
+    Bool_t IsBuilt() const { return !fChannels.empty(); }
+
+    /**
+     * Method to get the parameters of a channel.
+     * @return a nullptr if no parameters exist for this channel.
+     */
+    const Channel* GetChannel(Int_t plane, Int_t paddle, Int_t side) const
+    {
+        if (plane < 1 || plane > fNofPlanes || paddle < 1 || paddle > fNofPaddles || side < 1 || side > fNofSides)
+        {
+            return nullptr;
+        }
+        const auto& channel = fChannels[GetIndex(plane, paddle, side)];
+        return (channel.par == nullptr) ? nullptr : &channel;
+    }
+
+    /**
+     * Method to convert a fine time value to [ns].
+     * @param channel a channel obtained from GetChannel().
+     * @param tdc the raw fine time.
+     */
+    Double_t GetTime(const Channel& channel, Int_t tdc) const
+    {
+        if (tdc >= 0 && tdc < channel.size)
+        {
+            return fTimes[channel.offset + tdc];
+        }
+        return GetTimeFromPar(channel, tdc);
+    }
+
+    /**
+     * Method to convert a fine time value to [ns].
+     * @return kNoTime if no parameters exist for this channel.
+     */
+    Double_t GetTime(Int_t plane, Int_t paddle, Int_t side, Int_t tdc) const
+    {
+        const auto* channel = GetChannel(plane, paddle, side);
+        return (channel == nullptr) ? kNoTime : GetTime(*channel, tdc);
+    }
+
+  private:
+    Int_t GetIndex(Int_t plane, Int_t paddle, Int_t side) const
+    {
+        return ((plane - 1) * fNofPaddles + paddle - 1) * fNofSides + side - 1;
+    }
+    Double_t GetTimeFromPar(const Channel& channel, Int_t tdc) const;
+
+    Type fType = Type::VFTX;
+    Int_t fNofPlanes = 0;
+    Int_t fNofPaddles = 0;
+    Int_t fNofSides = 0;
+    std::vector<Channel> fChannels; /**< dense (plane, paddle, side) index */
+    std::vector<Double_t> fTimes;   /**< fine time tables of all channels */
+};
+
+#endif /* !R3BTCALLOOKUP_H */
@@ -0,0 +1,148 @@
+#include "R3BTCalLookup.h"
+#include "R3BTCalModulePar.h"
+#include "R3BTCalPar.h"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fmt/format.h>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Hit
+    {
+        int plane;
+        int paddle;
+        int side;
+        int tdc;
+    };
+
+    // VFTX style parameters: one bin per fine time, skipping a few unpopulated bins
+    void FillParameters(R3BTCalPar& par,
+                        std::vector<std::unique_ptr<R3BTCalModulePar>>& modules,
+                        int nPlanes,
+                        int nPaddles,
+                        int nSides,
+                        int nFineBins)
+    {
+        for (auto plane = 1; plane <= nPlanes; ++plane)
+        {
+            for (auto paddle = 1; paddle <= nPaddles; ++paddle)
+            {
+                for (auto side = 1; side <= nSides; ++side)
+                {
+                    auto& module = modules.emplace_back(std::make_unique<R3BTCalModulePar>());
+                    module->SetPlane(plane);
+                    module->SetPaddle(paddle);
+                    module->SetSide(side);
+                    for (auto bin = 0; bin < nFineBins; ++bin)
+                    {
+                        if (bin % 97 == 5)
+                        {
+                            continue;
+                        }
+                        const auto idx = module->GetNofChannels();
+                        module->SetBinLowAt(bin + 1, idx);
+                        module->SetBinUpAt(bin + 1, idx);
+                        module->SetOffsetAt(0.008 * bin + 0.001 * plane + 0.0001 * paddle, idx);
+                        module->IncrementNofChannels();
+                    }
+                    par.AddModulePar(module.get());
+                }
+            }
+        }
+    }
+} // namespace
+
+// Time per hit of R3BTCalPar::GetModuleParAt with R3BTCalModulePar::GetTimeVFTX, as used by the TCal tasks
+// before, and of R3BTCalLookup for a random hit pattern.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of the TCal lookup" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("hitNum,n", po::value<int>()->default_value(1000000), "set number of hits");
+    desc.add_options()("planes", po::value<int>()->default_value(4), "set number of planes");
+    desc.add_options()("paddles", po::value<int>()->default_value(44), "set number of paddles per plane");
+    desc.add_options()("fineBins", po::value<int>()->default_value(600), "set number of fine time bins");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "tcalLookupBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto hitNum = varMap["hitNum"].as<int>();
+    const auto nPlanes = varMap["planes"].as<int>();
+    const auto nPaddles = varMap["paddles"].as<int>();
+    const auto nFineBins = varMap["fineBins"].as<int>();
+    constexpr auto nSides = 2;
+
+    auto modules = std::vector<std::unique_ptr<R3BTCalModulePar>>{};
+    auto par = R3BTCalPar{ "BenchTCalPar" };
+    FillParameters(par, modules, nPlanes, nPaddles, nSides, nFineBins);
+    auto lookup = R3BTCalLookup{};
+    if (!lookup.Build(&par, R3BTCalLookup::Type::VFTX))
+    {
+        std::cerr << "tcalLookupBench: Failed to build the lookup" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto engine = std::mt19937{ 42 };
+    auto hits = std::vector<Hit>{};
+    hits.reserve(hitNum);
+    for (auto idx = 0; idx < hitNum; ++idx)
+    {
+        hits.push_back({ static_cast<int>(engine() % nPlanes) + 1,
+                         static_cast<int>(engine() % nPaddles) + 1,
+                         static_cast<int>(engine() % nSides) + 1,
+                         static_cast<int>(engine() % nFineBins) });
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto sumPar = 0.;
+    const auto startPar = Clock::now();
+    for (const auto& hit : hits)
+    {
+        if (auto* module = par.GetModuleParAt(hit.plane, hit.paddle, hit.side); module != nullptr)
+        {
+            sumPar += module->GetTimeVFTX(hit.tdc);
+        }
+    }
+    const auto timePar = Clock::now() - startPar;
+
+    auto sumLookup = 0.;
+    const auto startLookup = Clock::now();
+    for (const auto& hit : hits)
+    {
+        if (const auto* channel = lookup.GetChannel(hit.plane, hit.paddle, hit.side); channel != nullptr)
+        {
+            sumLookup += lookup.GetTime(*channel, hit.tdc);
+        }
+    }
+    const auto timeLookup = Clock::now() - startLookup;
+
+    if (sumPar != sumLookup)
+    {
+        std::cerr << "tcalLookupBench: The lookup gives different times than the parameters" << std::endl;
+        return EXIT_FAILURE;
+    }
+    using ns = std::chrono::duration<double, std::nano>;
+    fmt::print("{:<30} {:>8.2f} ns/hit\n", "GetModuleParAt + GetTimeVFTX", ns(timePar).count() / hitNum);
+    fmt::print("{:<30} {:>8.2f} ns/hit\n", "R3BTCalLookup", ns(timeLookup).count() / hitNum);
+    return 0;
+}
@@ -0,0 +1,387 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BTCalEngine.h"
+#include "R3BTCalModulePar.h"
+#include "R3BTCalPar.h"
+#include "R3BTDCTraits.h"
+#include "TDirectory.h"
+#include "TH1F.h"
+#include "TMath.h"
+#include "TMemFile.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    struct Hit
+    {
+        Int_t plane;
+        Int_t paddle;
+        Int_t side;
+        Int_t tdc;
+    };
+
+    auto MakeHits() -> std::vector<Hit>
+    {
+        auto engine = std::mt19937{ 1 };
+        auto fineTime = std::normal_distribution<double>{ 250., 80. };
+        auto hits = std::vector<Hit>{};
+        for (auto plane = 1; plane <= 3; ++plane)
+        {
+            for (auto paddle = 1; paddle <= 20; ++paddle)
+            {
+                for (auto side = 1; side <= 2; ++side)
+                {
+                    for (auto entry = 0; entry < 2000; ++entry)
+                    {
+                        // no underflow, which would shift the first offset
+                        const auto tdc = std::clamp(static_cast<Int_t>(fineTime(engine)), 1, 600);
+                        hits.push_back({ plane, paddle, side, tdc });
+                    }
+                }
+            }
+        }
+        return hits;
+    }
+
+    void ExpectEqual(R3BTCalPar& expected, R3BTCalPar& par)
+    {
+        ASSERT_EQ(par.GetNumModulePar(), expected.GetNumModulePar());
+        for (auto idx = 0; idx < par.GetNumModulePar(); ++idx)
+        {
+            auto* expectedModule = static_cast<R3BTCalModulePar*>(expected.GetListOfModulePar()->At(idx));
+            auto* module = static_cast<R3BTCalModulePar*>(par.GetListOfModulePar()->At(idx));
+            EXPECT_EQ(module->GetPlane(), expectedModule->GetPlane());
+            EXPECT_EQ(module->GetPaddle(), expectedModule->GetPaddle());
+            EXPECT_EQ(module->GetSide(), expectedModule->GetSide());
+            ASSERT_EQ(module->GetNofChannels(), expectedModule->GetNofChannels());
+            for (auto channel = 0; channel < module->GetNofChannels(); ++channel)
+            {
+                EXPECT_EQ(module->GetBinLowAt(channel), expectedModule->GetBinLowAt(channel));
+                EXPECT_EQ(module->GetBinUpAt(channel), expectedModule->GetBinUpAt(channel));
+                EXPECT_EQ(module->GetSlopeAt(channel), expectedModule->GetSlopeAt(channel));
+                EXPECT_EQ(module->GetOffsetAt(channel), expectedModule->GetOffsetAt(channel));
+            }
+        }
+    }
+
+    // The calibration of R3BTCalEngine before the cumulative sums, on one TH1F per module
+    class TH1Calibration
+    {
+      public:
+        explicit TH1Calibration(Double_t clockFreq)
+            : fClockFreq(clockFreq)
+        {
+        }
+
+        void Fill(const std::vector<Hit>& hits)
+        {
+            for (const auto& hit : hits)
+            {
+                auto& hist = fHists[{ hit.plane, hit.paddle, hit.side }];
+                if (!hist)
+                {
+                    // not owned by the output file
+                    TDirectory::TContext const context{ nullptr };
+                    hist = std::make_unique<TH1F>("", "", 4097, -0.5, 4096.5);
+                }
+                hist->Fill(hit.tdc);
+            }
+        }
+
+        void CalculateParamClockTDC(R3BTCalPar& par) const
+        {
+            Calculate(par,
+                      [this](TH1F& h1, Int_t, Int_t iMin, Int_t iMax, R3BTCalModulePar& module)
+                      {
+                          const auto total = h1.Integral(iMin, iMax);
+                          for (auto ii = iMin; ii < iMax; ++ii)
+                          {
+                              const auto binMid = h1.Integral(iMin, ii) + h1.GetBinContent(1 + ii) * 0.5;
+                              AddChannel(module, ii, -1, 0., binMid / total * fClockFreq);
+                          }
+                      });
+        }
+
+        void CalculateParamVFTX(R3BTCalPar& par) const
+        {
+            Calculate(par,
+                      [this](TH1F& h1, Int_t, Int_t iMin, Int_t iMax, R3BTCalModulePar& module)
+                      {
+                          const auto total = h1.Integral(iMin, iMax);
+                          for (auto ibin = iMin; ibin <= iMax; ++ibin)
+                          {
+                              AddChannel(module, ibin, -1, 0., h1.Integral(iMin, ibin) / total * fClockFreq);
+                          }
+                      });
+        }
+
+        void CalculateParamTacquila(R3BTCalPar& par) const
+        {
+            Calculate(par,
+                      [this](TH1F& h1, Int_t ic, Int_t iMin, Int_t iMax, R3BTCalModulePar& module)
+                      {
+                          const auto tot = h1.Integral(iMin, iMax);
+                          Int_t il = ic - 10 + 1;
+                          Int_t ih = ic;
+                          while (il > iMin)
+                          {
+                              Double_t slope = 0, offset = 0;
+                              LinearDown(h1, iMin, iMax, il, ih, slope, offset);
+                              AddChannel(module, il, ih, slope, offset);
+                              ih = il;
+                              il = ih - 10 + 1;
+                          }
+                          if (ih > iMin)
+                          {
+                              const auto t2 = h1.Integral(iMin, ih) / tot * fClockFreq;
+                              AddChannel(module, iMin, ih, t2 / (Double_t)(ih - iMin), 0.);
+                          }
+
+                          il = ic;
+                          ih = ic + 10 - 1;
+                          while (ih <= iMax)
+                          {
+                              Double_t slope = 0, offset = 0;
+                              LinearUp(h1, iMin, iMax, il, ih, slope, offset);
+                              AddChannel(module, il, ih, slope, offset);
+                              il = ih;
+                              ih = (iMax - ih) < 100 ? il + 5 - 1 : il + 10 - 1;
+                          }
+                          if (il < iMax)
+                          {
+                              const auto t1 = h1.Integral(iMin, il) / tot * fClockFreq;
+                              AddChannel(module, il, iMax, (fClockFreq - t1) / (Double_t)(iMax - il), t1);
+                          }
+                      });
+        }
+
+      private:
+        using Calibrator = std::function<void(TH1F&, Int_t, Int_t, Int_t, R3BTCalModulePar&)>;
+
+        static void AddChannel(R3BTCalModulePar& module, Int_t binLow, Int_t binUp, Double_t slope, Double_t offset)
+        {
+            const auto channel = module.GetNofChannels();
+            module.SetBinLowAt(binLow, channel);
+            if (binUp >= 0)
+            {
+                module.SetBinUpAt(binUp, channel);
+                module.SetSlopeAt(slope, channel);
+            }
+            module.SetOffsetAt(offset, channel);
+            module.IncrementNofChannels();
+        }
+
+        void Calculate(R3BTCalPar& par, const Calibrator& calibrator) const
+        {
+            for (const auto& [key, hist] : fHists)
+            {
+                Int_t ic = 0, iMin = 0, iMax = 0;
+                FindRange(*hist, ic, iMin, iMax);
+                auto* module = new R3BTCalModulePar; // NOLINT
+                module->SetPlane(std::get<0>(key));
+                module->SetPaddle(std::get<1>(key));
+                module->SetSide(std::get<2>(key));
+                calibrator(*hist, ic, iMin, iMax, *module);
+                par.AddModulePar(module);
+            }
+        }
+
+        static void FindRange(TH1F& h1, Int_t& ic, Int_t& iMin, Int_t& iMax)
+        {
+            ic = (Int_t)(h1.GetMean() + 0.5);
+            for (Int_t i = 1; i <= 4097; i++)
+            {
+                if (h1.GetBinContent(i) > 0)
+                {
+                    iMin = i - 1;
+                    break;
+                }
+            }
+            for (Int_t i = 4097; i >= 1; i--)
+            {
+                if (h1.GetBinContent(i) > 0)
+                {
+                    iMax = i;
+                    break;
+                }
+            }
+        }
+
+        void LinearUp(TH1F& h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t& ih, Double_t& slope, Double_t& offset) const
+        {
+            Double_t tot = h1.Integral(iMin, iMax);
+            Double_t t1 = h1.Integral(iMin, il) / tot * fClockFreq;
+            Double_t t2 = h1.Integral(iMin, ih) / tot * fClockFreq;
+            slope = (t2 - t1) / (Double_t)(ih - il);
+            offset = t1;
+
+            Double_t prec = 3. / TMath::Sqrt(h1.GetEntries());
+            Int_t iter = 1;
+            while (ih <= iMax)
+            {
+                Int_t ih_next = ih + iter;
+                if (ih_next > iMax)
+                {
+                    break;
+                }
+                Double_t t21 = h1.Integral(iMin, ih_next) / tot * fClockFreq;
+                Double_t slope1 = (t21 - t1) / (Double_t)(ih_next - il);
+                Double_t dev = TMath::Abs(slope1 - slope) / TMath::Abs(slope);
+                ih = ih_next;
+                iter += 1;
+                slope = slope1;
+                if (dev > prec)
+                {
+                    break;
+                }
+            }
+        }
+
+        void LinearDown(TH1F& h1, Int_t iMin, Int_t iMax, Int_t& il, Int_t& ih, Double_t& slope, Double_t& offset) const
+        {
+            Double_t tot = h1.Integral(iMin, iMax);
+            Double_t t1 = h1.Integral(iMin, il) / tot * fClockFreq;
+            Double_t t2 = h1.Integral(iMin, ih) / tot * fClockFreq;
+            slope = (t2 - t1) / (Double_t)(ih - il);
+            offset = t1;
+
+            Double_t prec = 3. / TMath::Sqrt(h1.GetEntries());
+            Int_t iter = 1;
+            while (il >= iMin)
+            {
+                Int_t il_next = il - iter;
+                if (il_next < iMin)
+                {
+                    break;
+                }
+                Double_t t11 = h1.Integral(iMin, il_next) / tot * fClockFreq;
+                Double_t slope1 = (t2 - t11) / (Double_t)(ih - il_next);
+                Double_t dev = TMath::Abs(slope1 - slope) / TMath::Abs(slope);
+                il = il_next;
+                iter += 1;
+                slope = slope1;
+                offset = t11;
+                if (dev > prec)
+                {
+                    break;
+                }
+            }
+        }
+
+        Double_t fClockFreq;
+        std::map<std::tuple<Int_t, Int_t, Int_t>, std::unique_ptr<TH1F>> fHists;
+    };
+
+    TEST(testTCalEngine, vftx)
+    {
+        auto file = TMemFile("testTCalEngine.root", "RECREATE");
+        auto par = R3BTCalPar{ "TestTCalPar" };
+        auto engine = R3BTCalEngine{ &par, 1000 };
+        engine.Fill(4, 1, 1, 10);
+        for (const auto& hit : MakeHits())
+        {
+            engine.Fill(hit.plane, hit.paddle, hit.side, hit.tdc);
+        }
+        engine.CalculateParamVFTX();
+
+        // module 4 / 1 / 1 is below the minimum statistics
+        ASSERT_EQ(par.GetNumModulePar(), 3 * 20 * 2);
+        for (auto idx = 0; idx < par.GetNumModulePar(); ++idx)
+        {
+            auto* module = static_cast<R3BTCalModulePar*>(par.GetListOfModulePar()->At(idx));
+            ASSERT_GT(module->GetNofChannels(), 1);
+            const auto last = module->GetNofChannels() - 1;
+            EXPECT_EQ(module->GetOffsetAt(0), 0.);
+            EXPECT_DOUBLE_EQ(module->GetOffsetAt(last), 1000. / VFTX_CLOCK_MHZ);
+            for (auto channel = 1; channel <= last; ++channel)
+            {
+                EXPECT_GE(module->GetOffsetAt(channel), module->GetOffsetAt(channel - 1));
+            }
+        }
+    }
+
+    TEST(testTCalEngine, add_and_threads)
+    {
+        auto file = TMemFile("testTCalEngine.root", "RECREATE");
+        const auto hits = MakeHits();
+
+        auto expected = R3BTCalPar{ "TestTCalPar" };
+        auto engine = R3BTCalEngine{ &expected, 1000 };
+        engine.SetNThreads(1);
+        for (const auto& hit : hits)
+        {
+            engine.Fill(hit.plane, hit.paddle, hit.side, hit.tdc);
+        }
+        engine.CalculateParamTacquila();
+
+        // the same hits in two accumulators, filled in reverse order
+        auto par = R3BTCalPar{ "TestTCalPar" };
+        auto first = R3BTCalEngine{ &par, 1000 };
+        auto second = R3BTCalEngine{ &par, 1000 };
+        for (auto idx = hits.size(); idx > 0; --idx)
+        {
+            const auto& hit = hits[idx - 1];
+            (idx % 2 == 0 ? first : second).Fill(hit.plane, hit.paddle, hit.side, hit.tdc);
+        }
+        first.Add(second);
+        first.SetNThreads(4);
+        first.CalculateParamTacquila();
+
+        ExpectEqual(expected, par);
+    }
+
+    TEST(testTCalEngine, matches_former_th1_implementation)
+    {
+        auto file = TMemFile("testTCalEngine.root", "RECREATE");
+        const auto hits = MakeHits();
+        auto calculate = [&hits](auto calculateParam, auto calculateExpected)
+        {
+            auto par = R3BTCalPar{ "TestTCalPar" };
+            auto engine = R3BTCalEngine{ &par, 1000 };
+            for (const auto& hit : hits)
+            {
+                engine.Fill(hit.plane, hit.paddle, hit.side, hit.tdc);
+            }
+            calculateParam(engine);
+
+            auto expected = R3BTCalPar{ "TestTCalPar" };
+            calculateExpected(expected);
+            ExpectEqual(expected, par);
+        };
+
+        auto vftx = TH1Calibration{ 1. / R3B::TDC::Vftx::clock_MHz * 1000. };
+        vftx.Fill(hits);
+        calculate([](auto& engine) { engine.CalculateParamVFTX(); },
+                  [&vftx](auto& expected) { vftx.CalculateParamVFTX(expected); });
+
+        auto tacquila = TH1Calibration{ 1. / R3B::TDC::Tacquila::clock_MHz * 1000. };
+        tacquila.Fill(hits);
+        calculate([](auto& engine) { engine.CalculateParamTacquila(); },
+                  [&tacquila](auto& expected) { tacquila.CalculateParamTacquila(expected); });
+
+        auto clockTDC = TH1Calibration{ R3B::TDC::clock_ns<R3B::TDC::ClockTDC> };
+        clockTDC.Fill(hits);
+        calculate([](auto& engine) { engine.CalculateParamClockTDC(R3BTCalEngine::CTDC_8_12_FWD_250); },
+                  [&clockTDC](auto& expected) { clockTDC.CalculateParamClockTDC(expected); });
+    }
+} // namespace
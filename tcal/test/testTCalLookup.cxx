@@ -0,0 +1,141 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BTCalLookup.h"
+#include "R3BTCalModulePar.h"
+#include "R3BTCalPar.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr auto NPlanes = 4;
+    constexpr auto NPaddles = 44;
+    constexpr auto NSides = 2;
+    constexpr auto NFineBins = 600;
+
+    class testTCalLookup : public ::testing::Test
+    {
+      protected:
+        // modules must outlive the container
+        std::vector<std::unique_ptr<R3BTCalModulePar>> modules_;
+        R3BTCalPar par_{ "TestTCalPar" };
+
+        void SetUp() override
+        {
+            for (auto plane = 1; plane <= NPlanes; ++plane)
+            {
+                for (auto paddle = 1; paddle <= NPaddles; ++paddle)
+                {
+                    for (auto side = 1; side <= NSides; ++side)
+                    {
+                        // leave a hole to test missing channels
+                        if (plane == 2 && paddle == 3 && side == 1)
+                        {
+                            continue;
+                        }
+                        auto& module = modules_.emplace_back(std::make_unique<R3BTCalModulePar>());
+                        module->SetPlane(plane);
+                        module->SetPaddle(paddle);
+                        module->SetSide(side);
+                        for (auto bin = 0; bin < NFineBins; ++bin)
+                        {
+                            // VFTX style: one bin per fine time, skipping a few unpopulated bins
+                            if (bin % 97 == 5)
+                            {
+                                continue;
+                            }
+                            const auto idx = module->GetNofChannels();
+                            module->SetBinLowAt(bin + 1, idx);
+                            module->SetBinUpAt(bin + 1, idx);
+                            module->SetOffsetAt(0.008 * bin + 0.001 * plane + 0.0001 * paddle, idx);
+                            module->IncrementNofChannels();
+                        }
+                        par_.AddModulePar(module.get());
+                    }
+                }
+            }
+        }
+    };
+
+    TEST_F(testTCalLookup, identical_to_module_par)
+    {
+        auto lookup = R3BTCalLookup{};
+        ASSERT_TRUE(lookup.Build(&par_, R3BTCalLookup::Type::VFTX));
+
+        for (auto plane = 0; plane <= NPlanes + 1; ++plane)
+        {
+            for (auto paddle = 0; paddle <= NPaddles + 1; ++paddle)
+            {
+                for (auto side = 0; side <= NSides + 1; ++side)
+                {
+                    const auto* channel = lookup.GetChannel(plane, paddle, side);
+                    auto* module = par_.GetModuleParAt(plane, paddle, side);
+                    ASSERT_EQ(channel == nullptr, module == nullptr);
+                    if (module == nullptr)
+                    {
+                        continue;
+                    }
+                    for (auto tdc = -2; tdc < NFineBins + 3; ++tdc)
+                    {
+                        EXPECT_EQ(lookup.GetTime(*channel, tdc), module->GetTimeVFTX(tdc));
+                        EXPECT_EQ(lookup.GetTime(plane, paddle, side, tdc), module->GetTimeVFTX(tdc));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_F(testTCalLookup, identical_for_clock_tdc_and_tacquila)
+    {
+        auto clock = R3BTCalLookup{};
+        auto tacquila = R3BTCalLookup{};
+        ASSERT_TRUE(clock.Build(&par_, R3BTCalLookup::Type::ClockTDC));
+        ASSERT_TRUE(tacquila.Build(&par_, R3BTCalLookup::Type::Tacquila));
+
+        auto* module = par_.GetModuleParAt(3, 7, 2);
+        ASSERT_NE(module, nullptr);
+        for (auto tdc = -2; tdc < NFineBins + 3; ++tdc)
+        {
+            EXPECT_EQ(clock.GetTime(3, 7, 2, tdc), module->GetTimeClockTDC(tdc));
+            EXPECT_EQ(tacquila.GetTime(3, 7, 2, tdc), module->GetTimeTacquila(tdc));
+        }
+    }
+
+    TEST_F(testTCalLookup, identical_to_module_par_for_random_hits)
+    {
+        constexpr auto NHits = 10000;
+        auto lookup = R3BTCalLookup{};
+        ASSERT_TRUE(lookup.Build(&par_, R3BTCalLookup::Type::VFTX));
+
+        auto engine = std::mt19937{ 42 };
+        for (auto idx = 0; idx < NHits; ++idx)
+        {
+            const auto plane = static_cast<int>(engine() % NPlanes) + 1;
+            const auto paddle = static_cast<int>(engine() % NPaddles) + 1;
+            const auto side = static_cast<int>(engine() % NSides) + 1;
+            const auto tdc = static_cast<int>(engine() % NFineBins);
+            auto* module = par_.GetModuleParAt(plane, paddle, side);
+            const auto* channel = lookup.GetChannel(plane, paddle, side);
+            ASSERT_EQ(channel == nullptr, module == nullptr);
+            if (module != nullptr)
+            {
+                EXPECT_EQ(lookup.GetTime(*channel, tdc), module->GetTimeVFTX(tdc));
+            }
+        }
+    }
+} // namespace
@@ -0,0 +1,92 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BCoarseTimeStitch.h"
+#include "R3BTCalEngine.h"
+#include "R3BTDCTraits.h"
+#include "gtest/gtest.h"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+    namespace TDC = R3B::TDC;
+
+    TEST(testTDCTraits, ranges)
+    {
+        EXPECT_EQ(TDC::range_ns<TDC::Tamex>, 2048 * 1000. / 200.);
+        EXPECT_EQ(TDC::range_ns<TDC::Vftx>, 8192 * 1000. / 200.);
+        EXPECT_EQ(TDC::range_ns<TDC::ClockTDC>, 4096 * 1000. / 250.);
+        EXPECT_EQ(TDC::range_ns<TDC::ClockTDC150>, 4096 * 1000. / 150.);
+        EXPECT_EQ(TDC::clock_ns<TDC::Vftx>, 1000. / VFTX_CLOCK_MHZ);
+        EXPECT_EQ(TDC::Tacquila::clock_MHz, TACQUILA_CLOCK_MHZ);
+        EXPECT_EQ((TDC::stitch_range_ns<TDC::Vftx, TDC::Tamex>), TDC::range_ns<TDC::Tamex>);
+    }
+
+    template <typename TDC1, typename TDC2>
+    void CompareWithStringInterface(const char* name1, const char* name2)
+    {
+        auto stitch = R3BCoarseTimeStitch{};
+        auto engine = std::mt19937{ 1 };
+        const auto range = std::max(TDC::range_ns<TDC1>, TDC::range_ns<TDC2>);
+        auto distribution = std::uniform_real_distribution<double>{ -range, range };
+
+        auto times = std::vector<double>(1000);
+        for (auto& time : times)
+        {
+            time = distribution(engine);
+        }
+        auto stitched = std::vector<double>(times.size());
+        TDC::Stitch<TDC1, TDC2>(times.data(), stitched.data(), times.size());
+
+        for (auto idx = std::size_t{}; idx < times.size(); ++idx)
+        {
+            const auto expected = stitch.GetTime(times[idx], name1, name2);
+            EXPECT_EQ((R3BCoarseTimeStitch::GetTime<TDC1, TDC2>(times[idx])), expected) << "time " << times[idx];
+            EXPECT_NEAR(stitched[idx], expected, 1e-9) << "time " << times[idx];
+        }
+    }
+
+    TEST(testTDCTraits, stitch_tamex)
+    {
+        CompareWithStringInterface<TDC::Tamex, TDC::Tamex>("tamex", "tamex");
+    }
+
+    TEST(testTDCTraits, stitch_tamex_vftx)
+    {
+        CompareWithStringInterface<TDC::Tamex, TDC::Vftx>("tamex", "vftx");
+        CompareWithStringInterface<TDC::Vftx, TDC::Tamex>("vftx", "tamex");
+    }
+
+    TEST(testTDCTraits, stitch_clocktdc)
+    {
+        CompareWithStringInterface<TDC::ClockTDC, TDC::ClockTDC>("clocktdc", "clocktdc");
+        CompareWithStringInterface<TDC::Vftx, TDC::ClockTDC>("vftx", "clocktdc");
+    }
+
+    TEST(testTDCTraits, stitch_in_place)
+    {
+        auto times = std::vector<double>{ -30000., -10240., -5120., -1., 0., 1., 5119., 5121., 10240., 30000. };
+        auto expected = std::vector<double>{};
+        for (auto time : times)
+        {
+            expected.push_back(TDC::Stitch<TDC::Tamex, TDC::Vftx>(time));
+        }
+        TDC::Stitch<TDC::Tamex, TDC::Vftx>(times.data(), times.data(), times.size());
+        for (auto idx = std::size_t{}; idx < times.size(); ++idx)
+        {
+            EXPECT_NEAR(times[idx], expected[idx], 1e-9);
+        }
+    }
+} // namespace
@@ -38,6 +38,7 @@
 #include "TMath.h"
 #include "TRandom3.h"
 
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <sstream>
@@ -60,6 +61,8 @@ R3BTofDCal2Hit::R3BTofDCal2Hit()
 
 R3BTofDCal2Hit::R3BTofDCal2Hit(const char* name, Int_t iVerbose)
     : FairTask(name, iVerbose)
+    , fNofSlotPlanes(0)
+    , fNofSlotPaddles(0)
     , fCalItems(NULL)
     , fCalTriggerItems(NULL)
     , fTimeStitch(nullptr)
@@ -178,9 +181,116 @@ void R3BTofDCal2Hit::SetParameter()
 
     R3BLOG(info, "Parameters in the tofdHitPar container: " << fNofHitPars);
 
+    // One slot per bar, indexed by (plane - 1) * fNofSlotPaddles + (bar - 1)
+    fNofSlotPlanes = fNofPlanes;
+    fNofSlotPaddles = fPaddlesPerPlane;
+    if (fMapPar)
+    {
+        fNofSlotPlanes = std::max(fNofSlotPlanes, static_cast<UInt_t>(fMapPar->GetNbPlanes()));
+        fNofSlotPaddles = std::max(fNofSlotPaddles, static_cast<UInt_t>(fMapPar->GetNbPaddles()));
+    }
+    fBarSlots.clear();
+    fBarSlots.resize(fNofSlotPlanes * fNofSlotPaddles);
+    fActiveBars.clear();
+    fActiveBars.reserve(fBarSlots.size());
+
+    Float_t paddle_width = 2.700;
+    Float_t air_gap_paddles = 0.04;
+    Float_t detector_width = fPaddlesPerPlane * paddle_width + (fPaddlesPerPlane - 1) * air_gap_paddles + paddle_width;
+
+    fPaddlePars.assign(fBarSlots.size(), PaddleParameters{});
+    for (UInt_t iPlane = 1; iPlane <= fNofSlotPlanes; iPlane++)
+    {
+        for (UInt_t iBar = 1; iBar <= fNofSlotPaddles; iBar++)
+        {
+            auto& cache = fPaddlePars[(iPlane - 1) * fNofSlotPaddles + (iBar - 1)];
+
+            if (fMapPar && iPlane <= static_cast<UInt_t>(fMapPar->GetNbPlanes()) &&
+                iBar <= static_cast<UInt_t>(fMapPar->GetNbPaddles()))
+            {
+                cache.trigTop = fMapPar->GetTrigMap(iPlane, iBar, 2);
+                cache.trigBot = fMapPar->GetTrigMap(iPlane, iBar, 1);
+            }
+
+            if (iPlane == 1 || iPlane == 3)
+            {
+                cache.hasX = kTRUE;
+                cache.xCenter = -detector_width / 2 + (paddle_width + air_gap_paddles) / 2 +
+                                (iBar - 1) * (paddle_width + air_gap_paddles);
+            }
+            if (iPlane == 2 || iPlane == 4)
+            {
+                cache.hasX = kTRUE;
+                cache.xCenter = -detector_width / 2 + (paddle_width + air_gap_paddles) +
+                                (iBar - 1) * (paddle_width + air_gap_paddles);
+            }
+
+            auto par = (fHitPar && iPlane <= N_TOFD_HIT_PLANE_MAX && iBar <= N_TOFD_HIT_PADDLE_MAX)
+                           ? fHitPar->GetModuleParAt(static_cast<Int_t>(iPlane), static_cast<Int_t>(iBar))
+                           : nullptr;
+            if (!par)
+            {
+                continue;
+            }
+            cache.valid = kTRUE;
+            cache.offset1 = par->GetOffset1();
+            cache.offset2 = par->GetOffset2();
+            cache.sync = par->GetSync();
+            cache.veff = par->GetVeff();
+            cache.lambda = par->GetLambda();
+            cache.totOffset1 = par->GetToTOffset1();
+            cache.totOffset2 = par->GetToTOffset2();
+            cache.tofSyncOffset = par->GetTofSyncOffset();
+            cache.hasWalk = par->GetPar1Walk() != 0. && par->GetPar2Walk() != 0. && par->GetPar3Walk() != 0. &&
+                            par->GetPar4Walk() != 0. && par->GetPar5Walk() != 0.;
+            cache.pol = { par->GetPola(), par->GetPolb(), par->GetPolc(), par->GetPold() };
+            cache.exp1 = { par->GetPar1a(), par->GetPar1b(), par->GetPar1c(), par->GetPar1d() };
+            cache.exp2 = { par->GetPar2a(), par->GetPar2b(), par->GetPar2c(), par->GetPar2d() };
+            cache.parz = { par->GetPar1za(), par->GetPar1zb(), par->GetPar1zc() };
+        }
+    }
+
     return;
 }
 
+UInt_t R3BTofDCal2Hit::FillBarSlots(const TClonesArray& calItems,
+                                    UInt_t nPlanes,
+                                    UInt_t nPaddles,
+                                    std::vector<BarSlot>& slots,
+                                    std::vector<UInt_t>& activeBars)
+{
+    for (auto idx : activeBars)
+    {
+        slots[idx].top.clear();
+        slots[idx].bot.clear();
+        slots[idx].nPairs = 0;
+    }
+    activeBars.clear();
+
+    UInt_t nSkipped = 0;
+    for (Int_t ihit = 0; ihit < calItems.GetEntriesFast(); ihit++)
+    {
+        auto* hit = static_cast<R3BTofdCalData*>(calItems.At(ihit));
+        const UInt_t plane = hit->GetDetectorId();
+        const UInt_t bar = hit->GetBarId();
+        if (plane < 1 || plane > nPlanes || bar < 1 || bar > nPaddles)
+        {
+            R3BLOG(error, "Cal hit out of range, Plane: " << plane << ", Bar: " << bar);
+            nSkipped++;
+            continue;
+        }
+        const UInt_t idx = (plane - 1) * nPaddles + (bar - 1);
+
+        auto& slot = slots[idx];
+        if (slot.top.empty() && slot.bot.empty())
+            activeBars.push_back(idx);
+        auto& vec = 1 == hit->GetSideId() ? slot.bot : slot.top;
+        vec.push_back(hit);
+    }
+    std::sort(activeBars.begin(), activeBars.end());
+    return nSkipped;
+}
+
 InitStatus R3BTofDCal2Hit::Init()
 {
     R3BLOG(info, "");
@@ -276,111 +386,51 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
 
     headertpat++;
     Double_t timeP0 = 0.;
-    Double_t randx;
-
-    UInt_t vmultihits[N_PLANE_MAX + 1][N_TOFD_HIT_PADDLE_MAX + 1];
-    for (Int_t i = 0; i <= fNofPlanes; i++)
-    {
-        for (Int_t j = 0; j <= N_TOFD_HIT_PADDLE_MAX; j++)
-        {
-            vmultihits[i][j] = 0;
-        }
-    }
-    struct hit
-    {
-        Double_t charge;
-        Double_t time;
-        Double_t xpos;
-        Double_t ypos;
-        Int_t plane;
-        Int_t bar;
-        Double_t time_raw;
-        Double_t tof;
-    };
 
-    //    std::cout<<"new event!*************************************\n";
-
-    std::vector<hit> event;
+    fEvent.clear();
 
     Int_t nHits = fCalItems->GetEntriesFast();
     LOG(debug) << "Leading and trailing edges in this event: " << nHits;
     if (nHits == 0)
         events_wo_tofd_hits++;
 
-    // Organize cals into bars.
-    struct Entry
-    {
-        std::vector<R3BTofdCalData*> top;
-        std::vector<R3BTofdCalData*> bot;
-    };
-    std::map<size_t, Entry> bar_map;
-    // puts("Event");
-    for (Int_t ihit = 0; ihit < nHits; ihit++)
-    {
-        auto* hit = dynamic_cast<R3BTofdCalData*>(fCalItems->At(ihit));
-        size_t idx = (hit->GetDetectorId() - 1) * fPaddlesPerPlane + (hit->GetBarId() - 1);
-
-        // std::cout << "Hits: " << hit->GetDetectorId() << ' ' << hit->GetBarId() << ' ' << hit->GetSideId() << '  '
-        //          << hit->GetTimeLeading_ns() << ' ' << hit->GetTimeTrailing_ns() << ' '
-        //          << hit->GetTimeTrailing_ns() - hit->GetTimeLeading_ns() << '\n';
-
-        auto ret = bar_map.insert(std::pair<size_t, Entry>(idx, Entry()));
-        auto& vec = 1 == hit->GetSideId() ? ret.first->second.bot : ret.first->second.top;
-        vec.push_back(hit);
-        events_in_cal_level++;
-    }
+    // Organize cals into bars, analyzed in the order of plane and bar number
+    events_in_cal_level += nHits;
+    FillBarSlots(*fCalItems, fNofSlotPlanes, fNofSlotPaddles, fBarSlots, fActiveBars);
 
     // Build trigger map.
-    std::vector<R3BTofdCalData const*> trig_map;
+    fTrigMap.clear();
     for (int i = 0; i < fCalTriggerItems->GetEntriesFast(); ++i)
     {
-        auto trig = dynamic_cast<R3BTofdCalData const*>(fCalTriggerItems->At(i));
-        if (trig_map.size() < trig->GetBarId())
+        auto trig = static_cast<R3BTofdCalData const*>(fCalTriggerItems->At(i));
+        if (fTrigMap.size() < trig->GetBarId())
         {
-            trig_map.resize(trig->GetBarId());
+            fTrigMap.resize(trig->GetBarId(), nullptr);
         }
-        trig_map.at(trig->GetBarId() - 1) = trig;
+        fTrigMap.at(trig->GetBarId() - 1) = trig;
     }
 
     bool s_was_trig_missing = false;
     // Find coincident PMT hits.
-    // std::cout << "Print:\n";
-    for (auto it = bar_map.begin(); bar_map.end() != it; ++it)
+    for (auto idx : fActiveBars)
     {
-        //    reset:
-        // for (auto it2 = it->second.top.begin(); it->second.top.end() != it2; ++it2) {
-        // std::cout << "Top: " << (*it2)->GetDetectorId() << ' ' << (*it2)->GetBarId() << ' ' <<
-        // (*it2)->GetTimeLeading_ns() << '\n';
-        // }
-        // for (auto it2 = it->second.bot.begin(); it->second.bot.end() != it2; ++it2) {
-        // std::cout << "Bot: " << (*it2)->GetDetectorId() << ' ' << (*it2)->GetBarId() << ' ' <<
-        // (*it2)->GetTimeLeading_ns() << '\n';
-        // }
-        auto const& top_vec = it->second.top;
-        auto const& bot_vec = it->second.bot;
+        auto& slot = fBarSlots[idx];
+        auto const& par = fPaddlePars[idx];
+        auto const& top_vec = slot.top;
+        auto const& bot_vec = slot.bot;
         size_t top_i = 0;
         size_t bot_i = 0;
         for (; top_i < top_vec.size() && bot_i < bot_vec.size();)
         {
-            auto top = top_vec.at(top_i);
-            auto bot = bot_vec.at(bot_i);
-
-            Int_t top_trig_i = 0;
-            Int_t bot_trig_i = 0;
-            if (fMapPar)
-            {
-                top_trig_i = fMapPar->GetTrigMap(top->GetDetectorId(), top->GetBarId(), top->GetSideId());
-                bot_trig_i = fMapPar->GetTrigMap(bot->GetDetectorId(), bot->GetBarId(), bot->GetSideId());
-            }
+            auto top = top_vec[top_i];
+            auto bot = bot_vec[bot_i];
 
             Double_t top_trig_ns = 0, bot_trig_ns = 0;
-            if (top_trig_i < trig_map.size() && trig_map.at(top_trig_i) && bot_trig_i < trig_map.size() &&
-                trig_map.at(bot_trig_i))
+            if (static_cast<size_t>(par.trigTop) < fTrigMap.size() && fTrigMap[par.trigTop] &&
+                static_cast<size_t>(par.trigBot) < fTrigMap.size() && fTrigMap[par.trigBot])
             {
-                auto top_trig = trig_map.at(top_trig_i);
-                auto bot_trig = trig_map.at(bot_trig_i);
-                top_trig_ns = top_trig->GetTimeLeading_ns();
-                bot_trig_ns = bot_trig->GetTimeLeading_ns();
+                top_trig_ns = fTrigMap[par.trigTop]->GetTimeLeading_ns();
+                bot_trig_ns = fTrigMap[par.trigBot]->GetTimeLeading_ns();
 
                 ++n1;
             }
@@ -398,8 +448,8 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
 
             // Shift the cyclic difference window by half a window-length and move it back,
             // this way the trigger time will be at 0.
-            auto top_ns = fTimeStitch->GetTime(top->GetTimeLeading_ns() - top_trig_ns);
-            auto bot_ns = fTimeStitch->GetTime(bot->GetTimeLeading_ns() - bot_trig_ns);
+            auto top_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(top->GetTimeLeading_ns() - top_trig_ns);
+            auto bot_ns = fTimeStitch->GetTime<R3B::TDC::Tamex>(bot->GetTimeLeading_ns() - bot_trig_ns);
 
             auto dt = top_ns - bot_ns;
             // Handle wrap-around.
@@ -412,20 +462,21 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                 // glue zero and the largest values together.
                 dt_mod -= c_range_ns;
             }
-            // std::cout << top_i << ' ' << bot_i << ": " << top_ns << ' ' << bot_ns << " = " << dt << ' ' <<
-            // std::abs(dt_mod) << '\n';
             if (std::abs(dt_mod) < c_bar_coincidence_ns)
             {
                 inbarcoincidence++;
                 // Hit!
                 Int_t iPlane = top->GetDetectorId(); // 1..n
                 Int_t iBar = top->GetBarId();        // 1..n
-                if (iPlane > fNofPlanes)             // this also errors for iDetector==0
+                // Both edges are used up, also when the pair can not be calibrated
+                ++top_i;
+                ++bot_i;
+                if (iPlane > fNofPlanes)
                 {
                     R3BLOG(error, "More detectors than expected! Det: " << iPlane << " allowed are 1.." << fNofPlanes);
                     continue;
                 }
-                if (iBar > fPaddlesPerPlane) // same here
+                if (iBar > fPaddlesPerPlane)
                 {
                     R3BLOG(error, "More bars then expected! Det: " << iBar << " allowed are 1.." << fPaddlesPerPlane);
                     continue;
@@ -436,45 +487,26 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
 
                 auto THit_raw = (bot->GetTimeLeading_ns() + top->GetTimeLeading_ns()) / 2.; // needed for TOF for ROLUs
 
-                // std::cout<<"ToT: "<<top_tot << " "<<bot_tot<<"\n";
-
                 // register multi hits
-                vmultihits[iPlane][iBar] += 1;
+                slot.nPairs += 1;
 
-                auto par = fHitPar->GetModuleParAt(iPlane, iBar);
-                if (!par)
+                if (!par.valid)
                 {
-                    R3BLOG(error, "Hit par not found, Plane: " << top->GetDetectorId() << ", Bar: " << top->GetBarId());
+                    R3BLOG(error, "Hit par not found, Plane: " << iPlane << ", Bar: " << iBar);
                     continue;
                 }
 
-                // walk corrections
-                if (par->GetPar1Walk() == 0. || par->GetPar2Walk() == 0. || par->GetPar3Walk() == 0. ||
-                    par->GetPar4Walk() == 0. || par->GetPar5Walk() == 0.)
+                // walk corrections are not applied to the times yet
+                if (!par.hasWalk)
                 {
                     R3BLOG(debug, "TofD walk correction not found");
                 }
-                else
-                {
-                    auto bot_ns_walk = bot_ns - walk(bot_tot,
-                                                     par->GetPar1Walk(),
-                                                     par->GetPar2Walk(),
-                                                     par->GetPar3Walk(),
-                                                     par->GetPar4Walk(),
-                                                     par->GetPar5Walk());
-                    auto top_ns_walk = top_ns - walk(top_tot,
-                                                     par->GetPar1Walk(),
-                                                     par->GetPar2Walk(),
-                                                     par->GetPar3Walk(),
-                                                     par->GetPar4Walk(),
-                                                     par->GetPar5Walk());
-                }
 
                 // calculate tdiff
-                auto tdiff = ((bot_ns + par->GetOffset1()) - (top_ns + par->GetOffset2()));
+                auto tdiff = ((bot_ns + par.offset1) - (top_ns + par.offset2));
 
                 // calculate time of hit
-                Double_t THit = (bot_ns + top_ns) / 2. - par->GetSync();
+                Double_t THit = (bot_ns + top_ns) / 2. - par.sync;
                 if (std::isnan(THit))
                 {
                     R3BLOG(fatal, "TofD THit not found");
@@ -482,49 +514,32 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                 if (timeP0 == 0.)
                     timeP0 = THit;
 
-                // calculate y-position
-                auto pos = ((bot_ns + par->GetOffset1()) - (top_ns + par->GetOffset2())) * par->GetVeff();
-
-                // calculate y-position from ToT
-                auto posToT =
-                    par->GetLambda() * log((top_tot * par->GetToTOffset2()) / (bot_tot * par->GetToTOffset1()));
-
+                // calculate y-position, from ToT if requested
+                Double_t pos = 0.;
                 if (fTofdTotPos)
                 {
-                    pos = posToT;
+                    pos = par.lambda * log((top_tot * par.totOffset2) / (bot_tot * par.totOffset1));
+                }
+                else
+                {
+                    pos = tdiff * par.veff;
                 }
 
+                // calculate x-position
                 Float_t paddle_width = 2.700;
-                Float_t air_gap_paddles = 0.04;
-                Float_t air_gap_layer = 5.;
-                Float_t detector_width =
-                    fPaddlesPerPlane * paddle_width + (fPaddlesPerPlane - 1) * air_gap_paddles + paddle_width;
                 Double_t xp = -1000.;
-                // calculate x-position
-                if (iPlane == 1 || iPlane == 3)
+                if (par.hasX)
                 {
-                    xp = -detector_width / 2 + (paddle_width + air_gap_paddles) / 2 +
-                         (iBar - 1) * (paddle_width + air_gap_paddles) +
-                         gRandom->Uniform(-paddle_width / 2., paddle_width / 2.);
-                }
-                if (iPlane == 2 || iPlane == 4)
-                {
-                    xp = -detector_width / 2 + (paddle_width + air_gap_paddles) +
-                         (iBar - 1) * (paddle_width + air_gap_paddles) +
-                         gRandom->Uniform(-paddle_width / 2., paddle_width / 2.);
+                    xp = par.xCenter + gRandom->Uniform(-paddle_width / 2., paddle_width / 2.);
                 }
 
-                Double_t para[4];
                 Double_t qb = 0.;
                 if (fTofdQ > 0)
                 {
                     if (fTofdTotPos)
                     {
                         // via pol3
-                        para[0] = par->GetPola();
-                        para[1] = par->GetPolb();
-                        para[2] = par->GetPolc();
-                        para[3] = par->GetPold();
+                        auto const& para = par.pol;
                         qb = TMath::Sqrt(top_tot * bot_tot) /
                              (para[0] + para[1] * pos + para[2] * pow(pos, 2) + para[3] * pow(pos, 3));
                         qb = qb * fTofdQ;
@@ -532,16 +547,10 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                     else
                     {
                         // via double exponential:
-                        para[0] = par->GetPar1a();
-                        para[1] = par->GetPar1b();
-                        para[2] = par->GetPar1c();
-                        para[3] = par->GetPar1d();
+                        auto const* para = par.exp1.data();
                         auto q1 = bot_tot /
                                   (para[0] * (exp(-para[1] * (pos + 100.)) + exp(-para[2] * (pos + 100.))) + para[3]);
-                        para[0] = par->GetPar2a();
-                        para[1] = par->GetPar2b();
-                        para[2] = par->GetPar2c();
-                        para[3] = par->GetPar2d();
+                        para = par.exp2.data();
                         auto q2 = top_tot /
                                   (para[0] * (exp(-para[1] * (pos + 100.)) + exp(-para[2] * (pos + 100.))) + para[3]);
                         q1 = q1 * fTofdQ;
@@ -554,52 +563,20 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                     qb = TMath::Sqrt(top_tot * bot_tot);
                 }
 
-                Double_t parz[3];
-                parz[0] = par->GetPar1za();
-                parz[1] = par->GetPar1zb();
-                parz[2] = par->GetPar1zc();
+                auto const& parz = par.parz;
 
-                if (parz[0] > 0 && parz[2] > 0)
-                    LOG(debug) << "Charges in this event " << parz[0] * TMath::Power(qb, parz[2]) + parz[1] << " plane "
-                               << iPlane << " ibar " << iBar;
-                else
-                    LOG(debug) << "Charges in this event " << qb << " plane " << iPlane << " ibar " << iBar;
+                LOG(debug) << "Charges in this event " << parz[0] + parz[1] * qb + parz[2] * qb * qb << " plane "
+                           << iPlane << " ibar " << iBar;
                 LOG(debug) << "Times in this event " << THit << " plane " << iPlane << " ibar " << iBar;
-                if (iPlane == 1 || iPlane == 3)
-                    LOG(debug) << "x in this event "
-                               << -detector_width / 2 + (paddle_width + air_gap_paddles) / 2 +
-                                      (iBar - 1) * (paddle_width + air_gap_paddles) - 0.04
-                               << " plane " << iPlane << " ibar " << iBar;
-                if (iPlane == 2 || iPlane == 4)
-                    LOG(debug) << "x in this event "
-                               << -detector_width / 2 + (paddle_width + air_gap_paddles) +
-                                      (iBar - 1) * (paddle_width + air_gap_paddles) - 0.04
-                               << " plane " << iPlane << " ibar " << iBar;
                 LOG(debug) << "y in this event " << pos << " plane " << iPlane << " ibar " << iBar << "\n";
 
                 // Tof with respect LOS detector
-                auto tof = fTimeStitch->GetTime((bot_ns + top_ns) / 2. - header->GetTStart(), "tamex", "vftx");
-                // auto tof_corr = par->GetTofSyncOffset() + par->GetTofSyncSlope() * tof;
-                auto tof_corr = tof - par->GetTofSyncOffset();
+                auto tof = fTimeStitch->GetTime<R3B::TDC::Tamex, R3B::TDC::Vftx>((bot_ns + top_ns) / 2. -
+                                                                                 header->GetTStart());
+                auto tof_corr = tof - par.tofSyncOffset;
 
-                // if (parz[1] > 0)
-                // {
-                event.push_back(
+                fEvent.push_back(
                     { parz[0] + parz[1] * qb + parz[2] * qb * qb, THit, xp, pos, iPlane, iBar, THit_raw, tof_corr });
-                // }
-
-                /* if (parz[0] > 0 && parz[2] > 0)
-                 {
-                     event.push_back(
-                         { parz[0] * TMath::Power(qb, parz[2]) + parz[1], THit, xp, pos, iPlane, iBar, THit_raw, tof });
-                 }
-                 else
-                 {
-                     parz[0] = 1.;
-                     parz[1] = 0.;
-                     parz[2] = 1.;
-                     event.push_back({ qb, THit, xp, pos, iPlane, iBar, THit_raw, tof });
-                 }*/
 
                 if (fTofdHisto)
                 {
@@ -607,18 +584,7 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                     fhTsync[iPlane - 1]->Fill(iBar, THit);
                     fhTdiff[iPlane - 1]->Fill(iBar, tdiff);
                     fhQvsPos[iPlane - 1][iBar - 1]->Fill(pos, parz[0] * TMath::Power(qb, parz[2]) + parz[1]);
-                    // fhQvsTHit[iPlane - 1][iBar - 1]->Fill(qb, THit);
-                    // fhTvsTHit[iPlane - 1][iBar - 1]->Fill(dt_mod, THit);
-                }
-
-                for (Int_t e = 0; e < event.size(); e++)
-                {
-                    LOG(debug) << event[e].charge << " " << event[e].time << " " << event[e].xpos << " "
-                               << event[e].ypos << " " << event[e].plane << " " << event[e].bar;
                 }
-
-                ++top_i;
-                ++bot_i;
             }
             else if (dt < 0 && dt > -c_range_ns / 2)
             {
@@ -635,38 +601,34 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
 
     // Now all hits in this event are analyzed
 
-    LOG(debug) << "Hits in this event: " << event.size();
-    Bool_t tArrU[event.size() + 1];
-    for (int i = 0; i < (event.size() + 1); i++)
+    LOG(debug) << "Hits in this event: " << fEvent.size();
+    Bool_t tArrU[fEvent.size() + 1];
+    for (int i = 0; i < (fEvent.size() + 1); i++)
         tArrU[i] = kFALSE;
 
-    for (Int_t i = 1; i <= fNofPlanes; i++)
+    for (auto idx : fActiveBars)
     {
-        for (Int_t j = 0; j < fPaddlesPerPlane + 1; j++)
+        if (fBarSlots[idx].nPairs > 1)
         {
-            if (vmultihits[i][j] > 1)
-            {
-                bars_with_multihit++;
-                multihit += vmultihits[i][j] - 1;
-                // if(vmultihits[i][j]>3)cout<<vmultihits[i][j] - 1<<"\n";
-            }
+            bars_with_multihit++;
+            multihit += fBarSlots[idx].nPairs - 1;
         }
     }
 
-    std::sort(event.begin(), event.end(), [](hit const& a, hit const& b) { return a.time < b.time; });
+    std::sort(fEvent.begin(), fEvent.end(), [](Hit const& a, Hit const& b) { return a.time < b.time; });
     // Now we have all hits in this event time sorted
 
     if (fTofdHisto)
     {
         LOG(debug) << "Charge Time xpos ypos plane bar";
-        for (Int_t hit = 0; hit < event.size(); hit++)
+        for (Int_t hit = 0; hit < fEvent.size(); hit++)
         {
-            LOG(debug) << event[hit].charge << " " << event[hit].time << " " << event[hit].xpos << " "
-                       << event[hit].ypos << " " << event[hit].plane << " " << event[hit].bar;
-            // if (event[hit].plane == 2 && (event[hit].bar < 21 || event[hit].bar > 24)) fhTvsQ[event[hit].plane -
-            // 1]->Fill(event[hit].time-event[0].time,event[hit].charge);
-            if (event[hit].plane == 2 && (event[hit].bar == 18))
-                fhTvsQ[event[hit].plane - 1]->Fill(event[hit].time - event[0].time, event[hit].charge);
+            LOG(debug) << fEvent[hit].charge << " " << fEvent[hit].time << " " << fEvent[hit].xpos << " "
+                       << fEvent[hit].ypos << " " << fEvent[hit].plane << " " << fEvent[hit].bar;
+            // if (fEvent[hit].plane == 2 && (fEvent[hit].bar < 21 || fEvent[hit].bar > 24)) fhTvsQ[fEvent[hit].plane -
+            // 1]->Fill(fEvent[hit].time-fEvent[0].time,fEvent[hit].charge);
+            if (fEvent[hit].plane == 2 && (fEvent[hit].bar == 18))
+                fhTvsQ[fEvent[hit].plane - 1]->Fill(fEvent[hit].time - fEvent[0].time, fEvent[hit].charge);
         }
     }
 
@@ -675,69 +637,59 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
     // select events with feasible times
     Double_t hit_coinc = 20.; // coincidence window for hits in one event in ns. physics says max 250 ps
     Double_t time0;
-    for (Int_t ihit = 0; ihit < event.size();)
+    for (Int_t ihit = 0; ihit < fEvent.size();)
     { // loop over all hits in this event
-        LOG(debug) << "Set new coincidence window: " << event[ihit].plane << " " << event[ihit].bar << " "
-                   << event[ihit].time << " " << event[ihit].charge;
-        time0 = event[ihit].time;              // time of first hit in coincidence window
-        Double_t charge0 = event[ihit].charge; // charge of first hit in coincidence window
-        Int_t plane0 = event[ihit].plane;      // plane of first hit in coincidence window
-        std::vector<Double_t> goodcharge;
-        std::vector<Double_t> goodplane;
-        std::vector<Double_t> goodbar;
-        struct goodhit
-        {
-            Double_t goodq;
-            Double_t goodp;
-            Double_t goodb;
-        };
-        struct by_charge
-        {
-            bool operator()(goodhit const& a, goodhit const& b) const noexcept { return a.goodq < b.goodq; }
-        };
-        std::vector<goodhit> goodevents;
-
-        while (event[ihit].time < time0 + hit_coinc)
+        LOG(debug) << "Set new coincidence window: " << fEvent[ihit].plane << " " << fEvent[ihit].bar << " "
+                   << fEvent[ihit].time << " " << fEvent[ihit].charge;
+        time0 = fEvent[ihit].time;              // time of first hit in coincidence window
+        Double_t charge0 = fEvent[ihit].charge; // charge of first hit in coincidence window
+        Int_t plane0 = fEvent[ihit].plane;      // plane of first hit in coincidence window
+        fGoodCharge.clear();
+        fGoodPlane.clear();
+        fGoodBar.clear();
+        fGoodEvents.clear();
+
+        while (fEvent[ihit].time < time0 + hit_coinc)
         { // check if in coincidence window
             if (fTofdHisto)
             {
-                if (event[ihit].plane == plane0 && charge0 != event[ihit].charge)
+                if (fEvent[ihit].plane == plane0 && charge0 != fEvent[ihit].charge)
                 {
-                    fhQ0Qt[event[ihit].plane - 1]->Fill(charge0, event[ihit].charge);
+                    fhQ0Qt[fEvent[ihit].plane - 1]->Fill(charge0, fEvent[ihit].charge);
                 }
             }
 
-            if ((event[ihit].charge > 5.5 && event[ihit].charge < 6.5) ||
-                (event[ihit].charge > 1.5 && event[ihit].charge < 2.5))
+            if ((fEvent[ihit].charge > 5.5 && fEvent[ihit].charge < 6.5) ||
+                (fEvent[ihit].charge > 1.5 && fEvent[ihit].charge < 2.5))
             {
-                goodcharge.push_back(event[ihit].charge);
-                goodplane.push_back(event[ihit].plane);
-                goodbar.push_back(event[ihit].bar);
+                fGoodCharge.push_back(fEvent[ihit].charge);
+                fGoodPlane.push_back(fEvent[ihit].plane);
+                fGoodBar.push_back(fEvent[ihit].bar);
             }
 
-            LOG(debug) << "Hit in coincidence window: " << event[ihit].plane << " " << event[ihit].bar << " "
-                       << event[ihit].time << " " << event[ihit].charge;
+            LOG(debug) << "Hit in coincidence window: " << fEvent[ihit].plane << " " << fEvent[ihit].bar << " "
+                       << fEvent[ihit].time << " " << fEvent[ihit].charge;
 
             ihit++;
-            if (ihit >= event.size())
+            if (ihit >= fEvent.size())
                 break;
         }
-        if (goodcharge.size() > 3)
+        if (fGoodCharge.size() > 3)
         {
-            if (goodcharge.size() == 4)
+            if (fGoodCharge.size() == 4)
             {
-                if (std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) > 14. &&
-                    std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) < 18.)
+                if (std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) > 14. &&
+                    std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) < 18.)
                 {
-                    if (std::accumulate(goodplane.begin(), goodplane.end(), 0) == 6.)
+                    if (std::accumulate(fGoodPlane.begin(), fGoodPlane.end(), 0) == 6.)
                     {
                         LOG(debug) << "Found good pair 2 times in all planes";
-                        for (Int_t g = 0; g < goodcharge.size(); g++)
+                        for (Int_t g = 0; g < fGoodCharge.size(); g++)
                         {
-                            LOG(debug) << goodcharge.at(g);
-                            LOG(debug) << goodplane.at(g);
-                            LOG(debug) << goodbar.at(g);
-                            goodevents.push_back({ goodcharge.at(g), goodplane.at(g), goodbar.at(g) });
+                            LOG(debug) << fGoodCharge.at(g);
+                            LOG(debug) << fGoodPlane.at(g);
+                            LOG(debug) << fGoodBar.at(g);
+                            fGoodEvents.push_back({ fGoodCharge.at(g), fGoodPlane.at(g), fGoodBar.at(g) });
                         }
                         goodpair++;
                         goodpair4++;
@@ -748,21 +700,21 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                     }
                 }
             }
-            else if (std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) > 14.)
+            else if (std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) > 14.)
                 goodpair6++;
         }
-        if (goodcharge.size() == 3)
+        if (fGoodCharge.size() == 3)
         {
-            if (std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) > 8.5 &&
-                std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) < 15.5)
+            if (std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) > 8.5 &&
+                std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) < 15.5)
             {
-                if (std::accumulate(goodplane.begin(), goodplane.end(), 0) == 4 ||
-                    std::accumulate(goodplane.begin(), goodplane.end(), 0) == 5)
+                if (std::accumulate(fGoodPlane.begin(), fGoodPlane.end(), 0) == 4 ||
+                    std::accumulate(fGoodPlane.begin(), fGoodPlane.end(), 0) == 5)
                 {
                     LOG(debug) << "Found good pair at least once in all planes";
-                    for (Int_t g = 0; g < goodcharge.size(); g++)
+                    for (Int_t g = 0; g < fGoodCharge.size(); g++)
                     {
-                        LOG(debug) << goodcharge.at(g);
+                        LOG(debug) << fGoodCharge.at(g);
                     }
                     goodpair++;
                     goodpair5++;
@@ -773,58 +725,59 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
                 }
             }
         }
-        if (goodcharge.size() == 2)
+        if (fGoodCharge.size() == 2)
         {
-            if (std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) > 7. &&
-                std::accumulate(goodcharge.begin(), goodcharge.end(), 0.0) < 9.)
+            if (std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) > 7. &&
+                std::accumulate(fGoodCharge.begin(), fGoodCharge.end(), 0.0) < 9.)
             {
-                if (std::accumulate(goodplane.begin(), goodplane.end(), 0) == 2. ||
-                    std::accumulate(goodplane.begin(), goodplane.end(), 0) == 4.)
+                if (std::accumulate(fGoodPlane.begin(), fGoodPlane.end(), 0) == 2. ||
+                    std::accumulate(fGoodPlane.begin(), fGoodPlane.end(), 0) == 4.)
                 {
                     LOG(debug) << "Found good pair in one plane";
-                    for (Int_t g = 0; g < goodcharge.size(); g++)
+                    for (Int_t g = 0; g < fGoodCharge.size(); g++)
                     {
-                        LOG(debug) << goodcharge.at(g);
+                        LOG(debug) << fGoodCharge.at(g);
                     }
                     goodpair++;
                     goodpair1++;
                 }
-                if (std::accumulate(goodplane.begin(), goodplane.end(), 0) == 3.)
+                if (std::accumulate(fGoodPlane.begin(), fGoodPlane.end(), 0) == 3.)
                 {
                     LOG(debug) << "Found good pair in different planes";
-                    for (Int_t g = 0; g < goodcharge.size(); g++)
+                    for (Int_t g = 0; g < fGoodCharge.size(); g++)
                     {
-                        LOG(debug) << goodcharge.at(g);
+                        LOG(debug) << fGoodCharge.at(g);
                     }
                     goodpair++;
                     goodpair2++;
                 }
             }
         }
-        std::sort(
-            goodevents.begin(), goodevents.end(), [](goodhit const& a, goodhit const& b) { return a.goodq < b.goodq; });
-        for (Int_t g = 0; g < goodevents.size(); g++)
+        std::sort(fGoodEvents.begin(),
+                  fGoodEvents.end(),
+                  [](GoodHit const& a, GoodHit const& b) { return a.goodq < b.goodq; });
+        for (Int_t g = 0; g < fGoodEvents.size(); g++)
         {
-            LOG(debug) << goodevents[g].goodq;
-            LOG(debug) << goodevents[g].goodp;
-            LOG(debug) << goodevents[g].goodb;
+            LOG(debug) << fGoodEvents[g].goodq;
+            LOG(debug) << fGoodEvents[g].goodp;
+            LOG(debug) << fGoodEvents[g].goodb;
         }
     }
 
     if (fTofdHisto)
     {
         size_t ihit = 0;
-        for (; ihit < event.size();)
-        {                                                                          // loop over all hits
-            fhQ[event[ihit].plane - 1]->Fill(event[ihit].bar, event[ihit].charge); // charge per plane
-            fhQvsEvent[event[ihit].plane - 1]->Fill(fnEvents, event[ihit].charge); // charge vs event #
-            fhxy[event[ihit].plane - 1]->Fill(event[ihit].bar, event[ihit].ypos);  // xy of plane
+        for (; ihit < fEvent.size();)
+        {                                                                             // loop over all hits
+            fhQ[fEvent[ihit].plane - 1]->Fill(fEvent[ihit].bar, fEvent[ihit].charge); // charge per plane
+            fhQvsEvent[fEvent[ihit].plane - 1]->Fill(fnEvents, fEvent[ihit].charge);  // charge vs event #
+            fhxy[fEvent[ihit].plane - 1]->Fill(fEvent[ihit].bar, fEvent[ihit].ypos);  // xy of plane
             ihit++;
         }
     }
 
     // store events
-    for (Int_t hit = 0; hit < event.size(); hit++)
+    for (Int_t hit = 0; hit < fEvent.size(); hit++)
     { // loop over hits
         if (tArrU[hit] == false)
         {
@@ -832,21 +785,21 @@ void R3BTofDCal2Hit::Exec(Option_t* option)
             tArrU[hit] = true;
             // store single hits
             singlehit++;
-            new ((*fHitItems)[fHitItems->GetEntriesFast()]) R3BTofdHitData(event[hit].time,
-                                                                           event[hit].xpos,
-                                                                           event[hit].ypos,
-                                                                           event[hit].charge,
+            new ((*fHitItems)[fHitItems->GetEntriesFast()]) R3BTofdHitData(fEvent[hit].time,
+                                                                           fEvent[hit].xpos,
+                                                                           fEvent[hit].ypos,
+                                                                           fEvent[hit].charge,
                                                                            -1.,
-                                                                           event[hit].charge,
-                                                                           event[hit].plane,
-                                                                           event[hit].bar,
-                                                                           event[hit].time_raw,
-                                                                           event[hit].tof);
+                                                                           fEvent[hit].charge,
+                                                                           fEvent[hit].plane,
+                                                                           fEvent[hit].bar,
+                                                                           fEvent[hit].time_raw,
+                                                                           fEvent[hit].tof);
         }
     }
 
     LOG(debug) << "Used up hits in this event:";
-    for (Int_t a = 0; a < event.size(); a++)
+    for (Int_t a = 0; a < fEvent.size(); a++)
     {
         LOG(debug) << "Event " << a << " " << tArrU[a] << " ";
         if (tArrU[a] != true)
@@ -20,12 +20,15 @@
 #include "FairTask.h"
 #include "THnSparse.h"
 
+#include <array>
+#include <vector>
+
 class TClonesArray;
 class R3BTofDHitPar;
 class R3BEventHeader;
 class R3BTofDMappingPar;
-class R3BTofDHitPar;
 class R3BCoarseTimeStitch;
+class R3BTofdCalData;
 class TH1F;
 class TH2F;
 
@@ -131,6 +134,29 @@ class R3BTofDCal2Hit : public FairTask
     // Method to setup online mode
     void SetOnline(Bool_t option) { fOnline = option; }
 
+    /**
+     * Cal items of one bar in the current event.
+     */
+    struct BarSlot
+    {
+        std::vector<R3BTofdCalData*> top;
+        std::vector<R3BTofdCalData*> bot;
+        UInt_t nPairs = 0; /**< Number of top-bottom coincidences. */
+    };
+
+    /**
+     * Method to sort the cal items of one event into the slots of their bars.
+     * The slot of a bar is (plane - 1) * nPaddles + (bar - 1). The slots listed
+     * in activeBars are emptied first, afterwards activeBars lists the used
+     * slots in the order of plane and bar. Items outside of the slots are skipped.
+     * @return the number of skipped items.
+     */
+    static UInt_t FillBarSlots(const TClonesArray& calItems,
+                               UInt_t nPlanes,
+                               UInt_t nPaddles,
+                               std::vector<BarSlot>& slots,
+                               std::vector<UInt_t>& activeBars);
+
   private:
     void SetParameter();
 
@@ -139,6 +165,64 @@ class R3BTofDCal2Hit : public FairTask
      */
     Double_t walk(Double_t Q, Double_t par1, Double_t par2, Double_t par3, Double_t par4, Double_t par5);
 
+    /**
+     * Hit parameters of one paddle, copied from R3BTofDHitModulePar
+     * in SetParameter() so that Exec needs no parameter lookups.
+     */
+    struct PaddleParameters
+    {
+        Bool_t valid = kFALSE; /**< kFALSE if the paddle has no hit parameters. */
+        Int_t trigTop = 0;     /**< Trigger channel of the PMT with side 2. */
+        Int_t trigBot = 0;     /**< Trigger channel of the PMT with side 1. */
+        Double_t offset1 = 0.;
+        Double_t offset2 = 0.;
+        Double_t sync = 0.;
+        Double_t veff = 0.;
+        Double_t lambda = 0.;
+        Double_t totOffset1 = 0.;
+        Double_t totOffset2 = 0.;
+        Double_t tofSyncOffset = 0.;
+        Bool_t hasWalk = kFALSE;        /**< kTRUE if all five walk parameters are set. */
+        std::array<Double_t, 4> pol{};  /**< pol3 charge correction with the ToT position. */
+        std::array<Double_t, 4> exp1{}; /**< Double exponential charge correction of PMT 1. */
+        std::array<Double_t, 4> exp2{}; /**< Double exponential charge correction of PMT 2. */
+        std::array<Double_t, 3> parz{}; /**< Charge calibration. */
+        Bool_t hasX = kFALSE;           /**< kFALSE for planes without x-position. */
+        Float_t xCenter = 0.;           /**< x-position of the paddle center in cm. */
+    };
+
+    struct Hit
+    {
+        Double_t charge;
+        Double_t time;
+        Double_t xpos;
+        Double_t ypos;
+        Int_t plane;
+        Int_t bar;
+        Double_t time_raw;
+        Double_t tof;
+    };
+
+    struct GoodHit
+    {
+        Double_t goodq;
+        Double_t goodp;
+        Double_t goodb;
+    };
+
+    // Per-event containers, they keep their capacity between events
+    UInt_t fNofSlotPlanes;
+    UInt_t fNofSlotPaddles;
+    std::vector<PaddleParameters> fPaddlePars;   //!
+    std::vector<BarSlot> fBarSlots;              //!
+    std::vector<UInt_t> fActiveBars;             //!
+    std::vector<R3BTofdCalData const*> fTrigMap; //!
+    std::vector<Hit> fEvent;                     //!
+    std::vector<Double_t> fGoodCharge;           //!
+    std::vector<Double_t> fGoodPlane;            //!
+    std::vector<Double_t> fGoodBar;              //!
+    std::vector<GoodHit> fGoodEvents;            //!
+
     R3BCoarseTimeStitch* fTimeStitch;
     R3BEventHeader* header; /**< Event header - input data. */
     R3BTofDHitPar* fHitPar; /**< Hit parameter container. */
@@ -105,6 +105,7 @@ void R3BTofDMapped2Cal::SetParameter()
 
     fNofTcalPars = fTcalPar->GetNumModulePar();
     R3BLOG_IF(fatal, fNofTcalPars == 0, "There are no TCal parameters in container TofdTCalPar");
+    fTcalLookup.Build(fTcalPar, R3BTCalLookup::Type::VFTX);
     return;
 }
 
@@ -191,7 +192,7 @@ void R3BTofDMapped2Cal::Exec(Option_t* option)
         }
 
         // Tcal parameters.
-        auto* par = fTcalPar->GetModuleParAt(
+        auto* par = fTcalLookup.GetChannel(
             mapped->GetDetectorId(), mapped->GetBarId(), 2 * mapped->GetSideId() + mapped->GetEdgeId() - 2);
         if (!par)
         {
@@ -203,7 +204,7 @@ void R3BTofDMapped2Cal::Exec(Option_t* option)
         }
 
         // Convert TDC to [ns] ...
-        Double_t time_ns = par->GetTimeVFTX(mapped->GetTimeFine());
+        Double_t time_ns = fTcalLookup.GetTime(*par, mapped->GetTimeFine());
         // ... and subtract it from the next clock cycle.
         time_ns = (mapped->GetTimeCoarse() + 1) * fClockFreq - time_ns;
 
@@ -288,7 +289,7 @@ void R3BTofDMapped2Cal::Exec(Option_t* option)
             }
 
             // Tcal parameters.
-            auto* par = fTcalPar->GetModuleParAt(mapped->GetDetectorId(), mapped->GetBarId(), 1);
+            auto* par = fTcalLookup.GetChannel(mapped->GetDetectorId(), mapped->GetBarId(), 1);
             if (!par)
             {
                 R3BLOG(warn,
@@ -298,7 +299,7 @@ void R3BTofDMapped2Cal::Exec(Option_t* option)
             }
 
             // Convert TDC to [ns] ...
-            Double_t time_ns = par->GetTimeVFTX(mapped->GetTimeFine());
+            Double_t time_ns = fTcalLookup.GetTime(*par, mapped->GetTimeFine());
             // ... and subtract it from the next clock cycle.
             time_ns = (mapped->GetTimeCoarse() + 1) * fClockFreq - time_ns;
 
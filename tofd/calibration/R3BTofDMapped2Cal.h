@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "FairTask.h"
+#include "R3BTCalLookup.h"
 
 class TClonesArray;
 class R3BTofDMappingPar;
@@ -107,8 +108,9 @@ class R3BTofDMapped2Cal : public FairTask
     TClonesArray* fCalItems;           /**< Array with cal items - output data. */
     TClonesArray* fCalTriggerItems;    /**< Array with cal trigger items - output data. */
 
-    R3BTCalPar* fTcalPar; /**< TCAL parameter container. */
-    UInt_t fNofTcalPars;  /**< Number of modules in parameter file. */
+    R3BTCalPar* fTcalPar;       /**< TCAL parameter container. */
+    R3BTCalLookup fTcalLookup;  //!< Flat TCAL table, rebuilt in Init()/ReInit().
+    UInt_t fNofTcalPars;        /**< Number of modules in parameter file. */
 
     UInt_t fNofPlanes;
     UInt_t fPaddlesPerPlane; /**< Number of paddles per plane. */
@@ -0,0 +1,136 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BTofDCal2Hit.h"
+#include "R3BTofdCalData.h"
+#include "gtest/gtest.h"
+#include <TClonesArray.h>
+#include <map>
+#include <vector>
+
+namespace
+{
+    constexpr UInt_t NPlanes = 4;
+    constexpr UInt_t NPaddles = 44;
+
+    // plane, bar, side and leading time of a cal item
+    struct Edge
+    {
+        UInt_t plane;
+        UInt_t bar;
+        UInt_t side;
+        Double_t lead;
+    };
+
+    // Grouping of the cal items as done by R3BTofDCal2Hit::Exec before the bar slots were introduced
+    struct Entry
+    {
+        std::vector<R3BTofdCalData*> top;
+        std::vector<R3BTofdCalData*> bot;
+    };
+
+    auto GroupWithMap(const TClonesArray& calItems) -> std::map<size_t, Entry>
+    {
+        auto bar_map = std::map<size_t, Entry>{};
+        for (Int_t ihit = 0; ihit < calItems.GetEntriesFast(); ihit++)
+        {
+            auto* hit = dynamic_cast<R3BTofdCalData*>(calItems.At(ihit));
+            size_t idx = (hit->GetDetectorId() - 1) * NPaddles + (hit->GetBarId() - 1);
+            auto ret = bar_map.insert(std::pair<size_t, Entry>(idx, Entry()));
+            auto& vec = 1 == hit->GetSideId() ? ret.first->second.bot : ret.first->second.top;
+            vec.push_back(hit);
+        }
+        return bar_map;
+    }
+
+    void FillEvent(TClonesArray& calItems, const std::vector<Edge>& edges)
+    {
+        calItems.Clear();
+        for (const auto& edge : edges)
+        {
+            new (calItems[calItems.GetEntriesFast()])
+                R3BTofdCalData(edge.plane, edge.bar, edge.side, edge.lead, edge.lead + 50.);
+        }
+    }
+
+    void ExpectSameGrouping(const TClonesArray& calItems,
+                            const std::vector<R3BTofDCal2Hit::BarSlot>& slots,
+                            const std::vector<UInt_t>& activeBars)
+    {
+        const auto bar_map = GroupWithMap(calItems);
+        ASSERT_EQ(activeBars.size(), bar_map.size());
+        auto active = activeBars.begin();
+        for (const auto& [idx, entry] : bar_map)
+        {
+            EXPECT_EQ(*active, idx);
+            EXPECT_EQ(slots[*active].top, entry.top);
+            EXPECT_EQ(slots[*active].bot, entry.bot);
+            EXPECT_EQ(slots[*active].nPairs, 0U);
+            ++active;
+        }
+    }
+
+    TEST(testTofDCal2Hit, bar_slots_as_map)
+    {
+        auto calItems = TClonesArray{ "R3BTofdCalData" };
+        auto slots = std::vector<R3BTofDCal2Hit::BarSlot>(NPlanes * NPaddles);
+        auto activeBars = std::vector<UInt_t>{};
+
+        // several hits per side, bars in arbitrary order
+        FillEvent(calItems,
+                  { { 2, 17, 1, 100. },
+                    { 1, 44, 2, 20. },
+                    { 2, 17, 2, 101. },
+                    { 4, 1, 1, 5. },
+                    { 2, 17, 1, 300. },
+                    { 1, 44, 1, 22. },
+                    { 2, 17, 2, 302. },
+                    { 1, 1, 2, 7. } });
+        EXPECT_EQ(R3BTofDCal2Hit::FillBarSlots(calItems, NPlanes, NPaddles, slots, activeBars), 0U);
+        ExpectSameGrouping(calItems, slots, activeBars);
+
+        // the slots of the last event are reused
+        slots[activeBars.front()].nPairs = 2;
+        FillEvent(calItems, { { 2, 17, 2, 40. }, { 3, 30, 1, 41. }, { 3, 30, 2, 42. }, { 2, 17, 1, 43. } });
+        EXPECT_EQ(R3BTofDCal2Hit::FillBarSlots(calItems, NPlanes, NPaddles, slots, activeBars), 0U);
+        ExpectSameGrouping(calItems, slots, activeBars);
+        EXPECT_TRUE(slots[0].top.empty());
+        EXPECT_EQ(slots[0].nPairs, 0U);
+        EXPECT_TRUE(slots[(4 - 1) * NPaddles].bot.empty());
+
+        FillEvent(calItems, {});
+        EXPECT_EQ(R3BTofDCal2Hit::FillBarSlots(calItems, NPlanes, NPaddles, slots, activeBars), 0U);
+        EXPECT_TRUE(activeBars.empty());
+        for (const auto& slot : slots)
+        {
+            EXPECT_TRUE(slot.top.empty());
+            EXPECT_TRUE(slot.bot.empty());
+        }
+    }
+
+    TEST(testTofDCal2Hit, bar_slots_skip_out_of_range)
+    {
+        auto calItems = TClonesArray{ "R3BTofdCalData" };
+        auto slots = std::vector<R3BTofDCal2Hit::BarSlot>(NPlanes * NPaddles);
+        auto activeBars = std::vector<UInt_t>{};
+
+        FillEvent(calItems,
+                  { { 0, 3, 1, 10. }, { 1, 3, 1, 11. }, { 5, 3, 2, 12. }, { 1, 45, 2, 13. }, { 1, 0, 2, 14. } });
+        EXPECT_EQ(R3BTofDCal2Hit::FillBarSlots(calItems, NPlanes, NPaddles, slots, activeBars), 4U);
+        ASSERT_EQ(activeBars.size(), 1U);
+        EXPECT_EQ(activeBars.front(), 2U);
+        ASSERT_EQ(slots[2].bot.size(), 1U);
+        EXPECT_EQ(slots[2].bot.front(), calItems.At(1));
+        EXPECT_TRUE(slots[2].top.empty());
+    }
+} // namespace
@@ -19,43 +19,90 @@
 
 #include "R3BFragmentFitterChi2.h"
 
+#include "Math/MinimizerOptions.h"
+#include "TROOT.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #define SPEED_OF_LIGHT 29.9792458 // cm/ns
 #define Amu 0.938272
 
-R3BTrackingParticle* gCandidate;
-R3BTrackingSetup* gSetup;
-R3BTPropagator* gProp;
+/*
+ * State of one fit: the candidate which is propagated, the setup with the hits
+ * of the candidate and the propagator. The chi2 functions of the different
+ * fits are its member functions, such that concurrent fits do not share any
+ * state except the propagator and the setup, which are only read.
+ */
+class R3BFragmentFitterChi2::Context
+{
+  public:
+    Context(R3BTrackingParticle* candidate, R3BTrackingSetup* setup, R3BTPropagator* propagator, Bool_t energyLoss)
+        : fCandidate(candidate)
+        , fSetup(setup)
+        , fPropagator(propagator)
+        , fEnergyLoss(energyLoss)
+    {
+        // Look up the hits once per fit instead of once per function call
+        for (auto const& det : fSetup->GetArray())
+        {
+            const std::string name = det->GetDetectorName().Data();
+            const Int_t hitIndex = fCandidate->GetHitIndexByName(name);
+            fHits.push_back(-1 == hitIndex ? nullptr : fSetup->GetHit(name, hitIndex));
+        }
+    }
 
-Bool_t gEnergyLoss;
+    // Start of Chi2Backward2D, Fi5 hit in global coordinates and the detector of which x is fitted
+    void SetBackward2DStart(const TVector3& posFi5, R3BTrackingDetector* fi6)
+    {
+        fPosFi5 = posFi5;
+        fFi6 = fi6;
+    }
 
-double Chi2(const double* xx)
+    double Chi2(const double* xx);
+    double Chi2Beta(const double* xx);
+    double Chi2Backward(const double* xx);
+    double Chi2Backward2D(const double* xx);
+
+  private:
+    R3BTrackingParticle* fCandidate;
+    R3BTrackingSetup* fSetup;
+    R3BTPropagator* fPropagator;
+    Bool_t fEnergyLoss;
+    std::vector<R3BHit*> fHits; // hit of the candidate per detector of the setup, nullptr if none
+    TVector3 fPosFi5;
+    R3BTrackingDetector* fFi6 = nullptr;
+};
+
+double R3BFragmentFitterChi2::Context::Chi2(const double* xx)
 {
-    // Bool_t result = kFALSE;
-    Double_t sdev = 0.;
     Double_t x_l = 0.;
     Double_t y_l = 0.;
     Double_t prev_l = 0.;
     Double_t time = 0.;
     Double_t chi2 = 0.;
-    Int_t nchi2 = 0;
 
-    gCandidate->SetMass(xx[0]);
-    gCandidate->UpdateMomentum();
+    fCandidate->SetMass(xx[0]);
+    fCandidate->UpdateMomentum();
 
-    gCandidate->Reset();
+    fCandidate->Reset();
 
     // Propagate through the setup, defined by array of detectors
-    for (auto const& det : gSetup->GetArray())
+    const auto& detectors = fSetup->GetArray();
+    for (std::size_t i = 0; i < detectors.size(); i++)
     {
+        auto det = detectors[i];
         if (kTarget != det->section)
         {
-            /*result = */ gProp->PropagateToDetector(gCandidate, det);
+            fPropagator->PropagateToDetector(fCandidate, det);
 
-            time += (gCandidate->GetLength() - prev_l) / (gCandidate->GetBeta() * SPEED_OF_LIGHT);
-            prev_l = gCandidate->GetLength();
+            time += (fCandidate->GetLength() - prev_l) / (fCandidate->GetBeta() * SPEED_OF_LIGHT);
+            prev_l = fCandidate->GetLength();
         }
 
-        if (gEnergyLoss)
+        if (fEnergyLoss)
         {
             if (kTof != det->section)
             {
@@ -64,29 +111,20 @@ double Chi2(const double* xx)
                 {
                     weight = 0.5;
                 }
-                gCandidate->PassThroughDetector(det, weight);
+                fCandidate->PassThroughDetector(det, weight);
             }
         }
 
         // Convert global track coordinates into local on the det plane
-        det->GlobalToLocal(gCandidate->GetPosition(), x_l, y_l);
-
-        R3BHit* hit =
-            gSetup->GetHit(det->GetDetectorName().Data(), gCandidate->GetHitIndexByName(det->GetDetectorName().Data()));
+        det->GlobalToLocal(fCandidate->GetPosition(), x_l, y_l);
 
-        // X deviation at the last detector
-        if (kAfterGlad == det->section)
+        R3BHit* hit = fHits[i];
+        if (!hit)
         {
-            sdev += TMath::Power(x_l - hit->GetX(), 2);
+            continue;
         }
 
-        // if(kTarget != det->section)
-        // if(kAfterGlad == det->section)
-        {
-            chi2 += TMath::Power((x_l - hit->GetX()) / det->res_x, 2);
-            // LOG(info) << nchi2 << "  " << chi2 << ",  dev: " << (x_l - det->hit_x);
-            nchi2 += 1;
-        }
+        chi2 += TMath::Power((x_l - hit->GetX()) / det->res_x, 2);
 
         if (kTof == det->section)
         {
@@ -94,282 +132,251 @@ double Chi2(const double* xx)
         }
     }
 
-    // sdev /= 2;
-    // sdev = TMath::Sqrt(sdev);
-
-    // chi2 /= nchi2;
-    gCandidate->SetChi2(chi2);
+    fCandidate->SetChi2(chi2);
 
     return chi2;
 }
 
-double Chi2Beta(const double* xx)
+double R3BFragmentFitterChi2::Context::Chi2Beta(const double* xx)
 {
-    // Bool_t result = kFALSE;
-    // Double_t sdev = 0.;
     Double_t x_l = 0.;
     Double_t y_l = 0.;
-    // Double_t prev_l = 0.;
-    // Double_t time = 0.;
     Double_t chi2 = 0.;
-    Int_t nchi2 = 0;
 
-    gCandidate->SetStartBeta(xx[0]);
-    gCandidate->UpdateMomentum();
+    fCandidate->SetStartBeta(xx[0]);
+    fCandidate->UpdateMomentum();
 
-    gCandidate->Reset();
+    fCandidate->Reset();
 
     // Propagate through the setup, defined by array of detectors
-    for (auto const& det : gSetup->GetArray())
+    const auto& detectors = fSetup->GetArray();
+    for (std::size_t i = 0; i < detectors.size(); i++)
     {
+        auto det = detectors[i];
         if (kTarget != det->section)
         {
-            /*result = */ gProp->PropagateToDetector(gCandidate, det);
+            fPropagator->PropagateToDetector(fCandidate, det);
 
-            // time += (gCandidate->GetLength() - prev_l) / (gCandidate->GetBeta() * SPEED_OF_LIGHT);
-            // prev_l = gCandidate->GetLength();
-
-            LOG(debug2) << " at " << det->GetDetectorName() << ", momentum:" << gCandidate->GetMomentum().X() << ","
-                        << gCandidate->GetMomentum().Y() << gCandidate->GetMomentum().Z();
+            LOG(debug2) << " at " << det->GetDetectorName() << ", momentum:" << fCandidate->GetMomentum().X() << ","
+                        << fCandidate->GetMomentum().Y() << fCandidate->GetMomentum().Z();
         }
 
-        if (gEnergyLoss)
+        if (fEnergyLoss)
         {
             Double_t weight = 1.;
             if (kTarget == det->section)
             {
                 weight = 0.5;
             }
-            gCandidate->PassThroughDetector(det, weight);
+            fCandidate->PassThroughDetector(det, weight);
         }
 
         // Convert global track coordinates into local on the det plane
-        det->GlobalToLocal(gCandidate->GetPosition(), x_l, y_l);
-
-        R3BHit* hit =
-            gSetup->GetHit(det->GetDetectorName().Data(), gCandidate->GetHitIndexByName(det->GetDetectorName().Data()));
+        det->GlobalToLocal(fCandidate->GetPosition(), x_l, y_l);
 
-        // if(kTarget != det->section)
-        // if(kAfterGlad == det->section)
+        if (R3BHit* hit = fHits[i])
         {
             chi2 += TMath::Power((x_l - hit->GetX()) / det->res_x, 2);
-            // LOG(info) << nchi2 << "  " << chi2 << ",  dev: " << (x_l - det->hit_x);
-            nchi2 += 1;
         }
-
-        //        if(kTof == det->section)
-        //        {
-        //            chi2 += TMath::Power((time - hit->GetTime()) / det->res_t, 2);
-        //        }
     }
 
-    // sdev /= 2;
-    // sdev = TMath::Sqrt(sdev);
-
-    // chi2 /= nchi2;
-    gCandidate->SetChi2(chi2);
+    fCandidate->SetChi2(chi2);
 
     return chi2;
 }
 
-double Chi2Backward(const double* xx)
+double R3BFragmentFitterChi2::Context::Chi2Backward(const double* xx)
 {
-    // Bool_t result = kFALSE;
-    // Double_t sdev = 0.;
     Double_t x_l = 0.;
     Double_t y_l = 0.;
-    // Double_t prev_l = 0.;
-    // Double_t time = 0.;
     Double_t chi2 = 0.;
-    Int_t nchi2 = 0;
 
-    gCandidate->SetMass(xx[0]);
-    gCandidate->UpdateMomentum();
+    fCandidate->SetMass(xx[0]);
+    fCandidate->UpdateMomentum();
 
-    gCandidate->Reset();
+    fCandidate->Reset();
 
     // Propagate through the setup, defined by array of detectors
-    for (Int_t i = (gSetup->GetArray().size() - 2); i >= 0; i--)
+    const auto& detectors = fSetup->GetArray();
+    const Int_t last = detectors.size() - 2;
+    for (Int_t i = last; i >= 0; i--)
     {
-        auto det = gSetup->GetArray().at(i);
+        auto det = detectors.at(i);
 
-        if (i < (gSetup->GetArray().size() - 2))
+        if (i < last)
         {
-            /*result = */ gProp->PropagateToDetectorBackward(gCandidate, det);
-
-            // time += (gCandidate->GetLength() - prev_l) / (gCandidate->GetBeta() * SPEED_OF_LIGHT);
-            // prev_l = gCandidate->GetLength();
+            fPropagator->PropagateToDetectorBackward(fCandidate, det);
 
-            LOG(debug2) << " at " << det->GetDetectorName() << ", momentum:" << gCandidate->GetMomentum().X() << ", "
-                        << gCandidate->GetMomentum().Y() << ", " << gCandidate->GetMomentum().Z();
+            LOG(debug2) << " at " << det->GetDetectorName() << ", momentum:" << fCandidate->GetMomentum().X() << ", "
+                        << fCandidate->GetMomentum().Y() << ", " << fCandidate->GetMomentum().Z();
         }
 
-        if (gEnergyLoss)
+        if (fEnergyLoss)
         {
             Double_t weight = 1.;
             if (kTarget == det->section)
             {
                 weight = 0.5;
             }
-            gCandidate->PassThroughDetectorBackward(det, weight);
+            fCandidate->PassThroughDetectorBackward(det, weight);
         }
 
         // Convert global track coordinates into local on the det plane
-        det->GlobalToLocal(gCandidate->GetPosition(), x_l, y_l);
+        det->GlobalToLocal(fCandidate->GetPosition(), x_l, y_l);
 
-        R3BHit* hit =
-            gSetup->GetHit(det->GetDetectorName().Data(), gCandidate->GetHitIndexByName(det->GetDetectorName().Data()));
-
-        // if(kTarget != det->section)
-        // if(kAfterGlad == det->section)
+        if (R3BHit* hit = fHits[i])
         {
             chi2 += TMath::Power((x_l - hit->GetX()) / det->res_x, 2);
-            // LOG(info) << nchi2 << "  " << chi2 << ",  dev: " << (x_l - det->hit_x);
-            nchi2 += 1;
         }
-
-        //        if(kTof == det->section)
-        //        {
-        //            chi2 += TMath::Power((time - hit->GetTime()) / det->res_t, 2);
-        //        }
     }
 
-    // sdev /= 2;
-    // sdev = TMath::Sqrt(sdev);
-
-    // chi2 /= nchi2;
-    gCandidate->SetChi2(chi2);
+    fCandidate->SetChi2(chi2);
 
     return chi2;
 }
 
-double Chi2Backward2D(const double* xx)
+double R3BFragmentFitterChi2::Context::Chi2Backward2D(const double* xx)
 {
-    // Require Fi5 to have hit
+    // Require Fi5 and Fi6 to have hits
     // for the initial position and direction
-    if (-1 == gCandidate->GetHitIndexByName("fi5"))
+    if (!fFi6)
         return 1e10;
 
-    // Bool_t result = kFALSE;
-    // Double_t sdev = 0.;
     Double_t x_l = 0.;
     Double_t y_l = 0.;
-    // Double_t prev_l = 0.;
-    // Double_t time = 0.;
     Double_t chi2 = 0.;
-    Int_t nchi2 = 0;
 
     double mass = xx[0];
     double x_fi6 = xx[1];
 
-    gCandidate->SetMass(mass);
-    gCandidate->UpdateMomentum();
+    fCandidate->SetMass(mass);
+    fCandidate->UpdateMomentum();
 
-    auto fi5 = gSetup->GetByName("fi5");
-    auto fi6 = gSetup->GetByName("fi6");
-
-    TVector3 pos2;
     TVector3 pos3;
-    fi5->LocalToGlobal(pos2, gSetup->GetHit("fi5", gCandidate->GetHitIndexByName("fi5"))->GetX(), 0.);
-    fi6->LocalToGlobal(pos3, x_fi6, 0.);
+    fFi6->LocalToGlobal(pos3, x_fi6, 0.);
 
-    TVector3 direction0 = (pos2 - pos3).Unit();
+    TVector3 direction0 = (fPosFi5 - pos3).Unit();
     TVector3 pos0 = pos3;
-    Double_t mom = gCandidate->GetMass() * gCandidate->GetStartBeta() * gCandidate->GetStartGamma();
+    Double_t mom = fCandidate->GetMass() * fCandidate->GetStartBeta() * fCandidate->GetStartGamma();
     TVector3 startMomentum(mom * direction0.X(), mom * direction0.Y(), mom * direction0.Z());
-    gCandidate->SetStartPosition(pos0);
-    gCandidate->SetStartMomentum(startMomentum);
-    gCandidate->Reset();
+    fCandidate->SetStartPosition(pos0);
+    fCandidate->SetStartMomentum(startMomentum);
+    fCandidate->Reset();
 
     // Propagate through the setup, defined by array of detectors
-    for (Int_t i = (gSetup->GetArray().size() - 2); i >= 0; i--)
+    const auto& detectors = fSetup->GetArray();
+    const Int_t last = detectors.size() - 2;
+    for (Int_t i = last; i >= 0; i--)
     {
-        auto det = gSetup->GetArray().at(i);
+        auto det = detectors.at(i);
 
-        if (i < (gSetup->GetArray().size() - 2))
+        if (i < last)
         {
-            /*result = */ gProp->PropagateToDetectorBackward(gCandidate, det);
-
-            // time += (gCandidate->GetLength() - prev_l) / (gCandidate->GetBeta() * SPEED_OF_LIGHT);
-            // prev_l = gCandidate->GetLength();
+            fPropagator->PropagateToDetectorBackward(fCandidate, det);
 
-            LOG(debug2) << " at " << det->GetDetectorName() << ", momentum:" << gCandidate->GetMomentum().X() << ","
-                        << gCandidate->GetMomentum().Y() << gCandidate->GetMomentum().Z();
+            LOG(debug2) << " at " << det->GetDetectorName() << ", momentum:" << fCandidate->GetMomentum().X() << ","
+                        << fCandidate->GetMomentum().Y() << fCandidate->GetMomentum().Z();
         }
 
-        if (gEnergyLoss)
+        if (fEnergyLoss)
         {
             Double_t weight = 1.;
             if (kTarget == det->section)
             {
                 weight = 0.5;
             }
-            gCandidate->PassThroughDetectorBackward(det, weight);
+            fCandidate->PassThroughDetectorBackward(det, weight);
         }
 
         // Convert global track coordinates into local on the det plane
-        det->GlobalToLocal(gCandidate->GetPosition(), x_l, y_l);
-
-        R3BHit* hit = nullptr;
-        Int_t hitIndex = gCandidate->GetHitIndexByName(det->GetDetectorName().Data());
-        if (-1 != hitIndex)
-            hit = gSetup->GetHit(det->GetDetectorName().Data(), hitIndex);
+        det->GlobalToLocal(fCandidate->GetPosition(), x_l, y_l);
 
         // Take into chi2 only if there is a hit and user specified SigmaX > 0.
+        R3BHit* hit = fHits[i];
         if (hit && det->res_x > 1e-6)
         {
             chi2 += TMath::Power((x_l - hit->GetX()) / det->res_x, 2);
-            // LOG(info) << nchi2 << "  " << chi2 << ",  dev: " << (x_l - det->hit_x);
-            nchi2 += 1;
         }
     }
 
-    gCandidate->SetChi2(chi2);
+    fCandidate->SetChi2(chi2);
 
     return chi2;
 }
 
-R3BFragmentFitterChi2::R3BFragmentFitterChi2() {}
+/*
+ * Minuit2 minimizers of finished fits, reused by the next ones. Creation
+ * through the plugin manager is not thread-safe and happens under the lock.
+ */
+class R3BFragmentFitterChi2::MinimizerPool
+{
+  public:
+    std::unique_ptr<ROOT::Math::Minimizer> Acquire(Double_t tolerance, Int_t strategy)
+    {
+        std::unique_ptr<ROOT::Math::Minimizer> minimizer;
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            if (fFree.empty())
+            {
+                minimizer.reset(ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad"));
+            }
+            else
+            {
+                minimizer = std::move(fFree.back());
+                fFree.pop_back();
+            }
+        }
+
+        // set tolerance , etc...
+        minimizer->Clear();
+        minimizer->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2
+        minimizer->SetMaxIterations(10000);      // for GSL
+        minimizer->SetTolerance(tolerance);
+        minimizer->SetPrintLevel(0);
+        minimizer->SetStrategy(strategy);
+        return minimizer;
+    }
+
+    void Release(std::unique_ptr<ROOT::Math::Minimizer> minimizer)
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fFree.push_back(std::move(minimizer));
+    }
+
+  private:
+    std::mutex fMutex;
+    std::vector<std::unique_ptr<ROOT::Math::Minimizer>> fFree;
+};
+
+R3BFragmentFitterChi2::R3BFragmentFitterChi2()
+    : fMinimizers(std::make_unique<MinimizerPool>())
+    , fPropagator(nullptr)
+    , fEnergyLoss(kTRUE)
+    , fNThreads(1)
+{
+}
 
 R3BFragmentFitterChi2::~R3BFragmentFitterChi2() {}
 
 void R3BFragmentFitterChi2::Init(R3BTPropagator* prop, Bool_t energyLoss)
 {
     fPropagator = prop;
-    gProp = prop;
-    gEnergyLoss = energyLoss;
-
-    fMinimum = ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad");
-
-    // set tolerance , etc...
-    fMinimum->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2
-    fMinimum->SetMaxIterations(10000);      // for GSL
-    fMinimum->SetTolerance(10.);
-    fMinimum->SetPrintLevel(0);
-    fMinimum->SetStrategy(0);
-
-    // create funciton wrapper for minmizer
-    // a IMultiGenFunction type
-    ROOT::Math::Functor* f = new ROOT::Math::Functor(&Chi2Backward2D, 2);
-
-    fMinimum->SetFunction(*f);
+    fEnergyLoss = energyLoss;
+    fThreadPropagators.clear();
+    if (fNThreads != 1)
+    {
+        ROOT::EnableThreadSafety();
+    }
 }
 
 Int_t R3BFragmentFitterChi2::FitTrack(R3BTrackingParticle* particle, R3BTrackingSetup* setup)
 {
-    gCandidate = particle;
-
-    ROOT::Math::Minimizer* minimum = ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad");
-
-    // set tolerance , etc...
-    minimum->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2
-    minimum->SetMaxIterations(10000);      // for GSL
-    minimum->SetTolerance(0.0001);
-    minimum->SetPrintLevel(0);
+    Context context(particle, setup, fPropagator, kTRUE);
+    auto minimum = fMinimizers->Acquire(0.0001, ROOT::Math::MinimizerOptions::DefaultStrategy());
 
     // create funciton wrapper for minmizer
     // a IMultiGenFunction type
-    ROOT::Math::Functor f(&Chi2, 1);
+    ROOT::Math::Functor f([&context](const double* xx) { return context.Chi2(xx); }, 1);
     double variable[1] = { particle->GetMass() };
     double step[1] = {
         0.001,
@@ -380,44 +387,31 @@ Int_t R3BFragmentFitterChi2::FitTrack(R3BTrackingParticle* particle, R3BTracking
     // Set the free variables to be minimized!
     minimum->SetLimitedVariable(0, "m", variable[0], step[0], variable[0] - 0.5, variable[0] + 0.5);
 
-    Int_t status = 0;
-
     // do the minimization
-    gEnergyLoss = kTRUE;
-
     minimum->Minimize();
 
-    status = minimum->Status();
-    if (0 != status)
+    Int_t status = minimum->Status();
+    if (0 == status)
     {
-        return status;
-    }
+        particle->SetMass(minimum->X()[0]);
+        particle->UpdateMomentum();
 
-    particle->SetMass(minimum->X()[0]);
-    particle->UpdateMomentum();
-
-    particle->Reset();
+        particle->Reset();
+    }
 
-    delete minimum;
+    fMinimizers->Release(std::move(minimum));
 
     return status;
 }
 
 Int_t R3BFragmentFitterChi2::FitTrackBeta(R3BTrackingParticle* particle, R3BTrackingSetup* setup)
 {
-    gCandidate = particle;
-
-    ROOT::Math::Minimizer* minimum = ROOT::Math::Factory::CreateMinimizer("Minuit2", "");
-
-    // set tolerance , etc...
-    minimum->SetMaxFunctionCalls(1000000); // for Minuit/Minuit2
-    minimum->SetMaxIterations(10000);      // for GSL
-    minimum->SetTolerance(0.001);
-    minimum->SetPrintLevel(0);
+    Context context(particle, setup, fPropagator, kTRUE);
+    auto minimum = fMinimizers->Acquire(0.001, ROOT::Math::MinimizerOptions::DefaultStrategy());
 
     // create funciton wrapper for minmizer
     // a IMultiGenFunction type
-    ROOT::Math::Functor f(&Chi2Beta, 1);
+    ROOT::Math::Functor f([&context](const double* xx) { return context.Chi2Beta(xx); }, 1);
     double variable[1] = { particle->GetStartBeta() };
     double step[1] = { 0.0001 };
 
@@ -426,211 +420,222 @@ Int_t R3BFragmentFitterChi2::FitTrackBeta(R3BTrackingParticle* particle, R3BTrac
     // Set the free variables to be minimized!
     minimum->SetLimitedVariable(0, "beta", variable[0], step[0], 0.5, 0.999);
 
-    Int_t status = 0;
-
     // do the minimization
-    gEnergyLoss = kTRUE;
-
     minimum->Minimize();
 
-    status = minimum->Status();
-    if (0 != status)
+    Int_t status = minimum->Status();
+    if (0 == status)
     {
-        return status;
-    }
-
-    particle->SetStartBeta(minimum->X()[0]);
-    particle->UpdateMomentum();
+        particle->SetStartBeta(minimum->X()[0]);
+        particle->UpdateMomentum();
 
-    particle->Reset();
+        particle->Reset();
+    }
 
-    delete minimum;
+    fMinimizers->Release(std::move(minimum));
 
     return status;
 }
 
 Int_t R3BFragmentFitterChi2::FitTrackBackward(R3BTrackingParticle* particle, R3BTrackingSetup* setup)
 {
-    // fPropagator->SetVis(kTRUE);
-
-    gCandidate = particle;
-    gSetup = setup;
-
-    auto fi4 = gSetup->GetByName("fi4");
-    auto fi5 = gSetup->GetByName("fi5");
-    auto fi6 = gSetup->GetByName("fi6");
-    // auto tof = gSetup->GetFirstByType(kTof);
-
-    double variable[1] = { 132. * amu };
-    double step[1] = { 0.01 };
+    Context context(particle, setup, fPropagator, fEnergyLoss);
 
-    // Set the free variables to be minimized!
-    fMinimum->SetLimitedVariable(0, "m", variable[0], step[0], 125. * amu, 133. * amu);
+    auto fi4 = setup->GetByName("fi4");
+    auto fi5 = setup->GetByName("fi5");
+    auto fi6 = setup->GetByName("fi6");
 
     TVector3 pos1;
     TVector3 pos2;
     TVector3 pos3;
-    fi4->LocalToGlobal(pos1, gSetup->GetHit("fi4", particle->GetHitIndexByName("fi4"))->GetX(), 0.);
-    fi5->LocalToGlobal(pos2, gSetup->GetHit("fi5", particle->GetHitIndexByName("fi5"))->GetX(), 0.);
-    fi6->LocalToGlobal(pos3, gSetup->GetHit("fi6", particle->GetHitIndexByName("fi6"))->GetX(), 0.);
-    /*Int_t np = 3;
-    Double_t x[] = {pos1.X(), pos2.X(), pos3.X()};
-    Double_t xe[] = {fi4->res_x, fi5->res_x, fi6->res_x};
-    Double_t z[] = {pos1.Z(), pos2.Z(), pos3.Z()};
-    TGraphErrors* gr = new TGraphErrors(np, x, z, xe, 0);
-    TF1* f1 = new TF1("f1", "[0]*x + [1]", -500., 500.);
-    TF1* f2 = new TF1("f1", "[0]*x + [1]", 0., 1000.);
-    f1->SetParameters(-1., 0.);
-    gr->Fit(f1, "QN");
-    f2->SetParameters(1./f1->GetParameter(0), -1.*f1->GetParameter(1)/f1->GetParameter(0));
-    TVector3 direction0 = ( TVector3(fi5->hit_x, 0., f1->Eval(fi5->hit_x)) - TVector3(fi6->hit_x, 0.,
-    f1->Eval(fi6->hit_x)) ).Unit(); TVector3 pos0(f2->Eval(fi6->pos0.Z()), 0., fi6->pos0.Z());*/
+    fi4->LocalToGlobal(pos1, setup->GetHit("fi4", particle->GetHitIndexByName("fi4"))->GetX(), 0.);
+    fi5->LocalToGlobal(pos2, setup->GetHit("fi5", particle->GetHitIndexByName("fi5"))->GetX(), 0.);
+    fi6->LocalToGlobal(pos3, setup->GetHit("fi6", particle->GetHitIndexByName("fi6"))->GetX(), 0.);
+
     TVector3 direction0 = (pos2 - pos3).Unit();
     TVector3 pos0 = pos3;
-    Double_t mom = gCandidate->GetMass() * gCandidate->GetStartBeta() * gCandidate->GetStartGamma();
+    Double_t mom = particle->GetMass() * particle->GetStartBeta() * particle->GetStartGamma();
     TVector3 startMomentum(mom * direction0.X(), mom * direction0.Y(), mom * direction0.Z());
-    gCandidate->SetStartPosition(pos0);
-    gCandidate->SetStartMomentum(startMomentum);
-    gCandidate->Reset();
-
-    // pos1.Print();
-    // startMomentum.Print();
+    particle->SetStartPosition(pos0);
+    particle->SetStartMomentum(startMomentum);
+    particle->Reset();
 
-    for (Int_t i = 0; i <= (gSetup->GetArray().size() - 2); i++)
+    for (Int_t i = 0; i <= (Int_t)(setup->GetArray().size() - 2); i++)
     {
-        auto det = gSetup->GetArray().at(i);
+        auto det = setup->GetArray().at(i);
 
-        if (gEnergyLoss)
+        if (fEnergyLoss)
         {
             Double_t weight = 1.;
             if (kTarget == det->section)
             {
                 weight = 0.5;
             }
-            gCandidate->PassThroughDetector(det, weight);
+            particle->PassThroughDetector(det, weight);
         }
     }
 
-    // LOG(info) << "1 Start beta:" << gCandidate->GetStartBeta()
-    //<< ",  Beta:" << gCandidate->GetBeta();
-
-    gCandidate->SetStartBeta(gCandidate->GetBeta());
-    gCandidate->SetCharge(-1. * gCandidate->GetCharge());
-    gCandidate->UpdateMomentum();
+    particle->SetStartBeta(particle->GetBeta());
+    particle->SetCharge(-1. * particle->GetCharge());
+    particle->UpdateMomentum();
 
-    // Double_t chi2 = Chi2Backward(variable);
+    auto minimum = fMinimizers->Acquire(10., 0);
 
-    // LOG(info) << "2 chi2 = " << chi2;
+    // create funciton wrapper for minmizer
+    // a IMultiGenFunction type
+    ROOT::Math::Functor f([&context](const double* xx) { return context.Chi2Backward(xx); }, 1);
+    minimum->SetFunction(f);
 
-    // return 0;
+    double variable[1] = { 132. * amu };
+    double step[1] = { 0.01 };
 
-    Int_t status = 0;
+    // Set the free variables to be minimized!
+    minimum->SetLimitedVariable(0, "m", variable[0], step[0], 125. * amu, 133. * amu);
 
     // do the minimization
-    fMinimum->Minimize();
+    minimum->Minimize();
 
-    gCandidate->SetCharge(-1. * gCandidate->GetCharge());
+    particle->SetCharge(-1. * particle->GetCharge());
 
-    status = fMinimum->Status();
-    if (0 != status)
+    Int_t status = minimum->Status();
+    if (0 == status)
     {
-        return status;
+        particle->SetMass(minimum->X()[0]);
+        particle->UpdateMomentum();
     }
 
-    particle->SetMass(fMinimum->X()[0]);
-    particle->UpdateMomentum();
-
-    fMinimum->Clear();
-
-    // candidate->Reset();
+    fMinimizers->Release(std::move(minimum));
 
     return status;
 }
 
 Int_t R3BFragmentFitterChi2::FitTrackBackward2D(R3BTrackingParticle* particle, R3BTrackingSetup* setup)
 {
-    // fPropagator->SetVis(kTRUE);
+    return FitTrackBackward2D(particle, setup, fPropagator);
+}
 
+Int_t R3BFragmentFitterChi2::FitTrackBackward2D(R3BTrackingParticle* particle,
+                                                R3BTrackingSetup* setup,
+                                                R3BTPropagator* propagator)
+{
     // Require Fi5 and Fi6 to have hits
     // for the initial position and direction
     if (-1 == particle->GetHitIndexByName("fi5") || -1 == particle->GetHitIndexByName("fi6"))
         return 10;
 
-    gCandidate = particle;
-    gSetup = setup;
+    Context context(particle, setup, propagator, fEnergyLoss);
 
-    auto fi5 = gSetup->GetByName("fi5");
-    auto fi6 = gSetup->GetByName("fi6");
-
-    double variable[2] = { 132. * amu, gSetup->GetHit("fi6", particle->GetHitIndexByName("fi6"))->GetX() };
-    double step[2] = { 0.01, 0.001 };
-
-    // Set the free variables to be minimized!
-    fMinimum->SetLimitedVariable(0, "m", variable[0], step[0], 125. * amu, 133. * amu);
-    fMinimum->SetLimitedVariable(1, "xfi6", variable[1], step[1], -100., 100.);
+    auto fi5 = setup->GetByName("fi5");
+    auto fi6 = setup->GetByName("fi6");
 
     TVector3 pos2;
     TVector3 pos3;
 
-    fi5->LocalToGlobal(pos2, gSetup->GetHit("fi5", particle->GetHitIndexByName("fi5"))->GetX(), 0.);
-    fi6->LocalToGlobal(pos3, gSetup->GetHit("fi6", particle->GetHitIndexByName("fi6"))->GetX(), 0.);
+    fi5->LocalToGlobal(pos2, setup->GetHit("fi5", particle->GetHitIndexByName("fi5"))->GetX(), 0.);
+    fi6->LocalToGlobal(pos3, setup->GetHit("fi6", particle->GetHitIndexByName("fi6"))->GetX(), 0.);
+    context.SetBackward2DStart(pos2, fi6);
 
     TVector3 direction0 = (pos2 - pos3).Unit();
     TVector3 pos0 = pos3;
-    Double_t mom = gCandidate->GetMass() * gCandidate->GetStartBeta() * gCandidate->GetStartGamma();
+    Double_t mom = particle->GetMass() * particle->GetStartBeta() * particle->GetStartGamma();
     TVector3 startMomentum(mom * direction0.X(), mom * direction0.Y(), mom * direction0.Z());
-    gCandidate->SetStartPosition(pos0);
-    gCandidate->SetStartMomentum(startMomentum);
-    gCandidate->Reset();
+    particle->SetStartPosition(pos0);
+    particle->SetStartMomentum(startMomentum);
+    particle->Reset();
 
-    for (Int_t i = 0; i <= (gSetup->GetArray().size() - 2); i++)
+    for (Int_t i = 0; i <= (Int_t)(setup->GetArray().size() - 2); i++)
     {
-        auto det = gSetup->GetArray().at(i);
+        auto det = setup->GetArray().at(i);
 
-        if (gEnergyLoss)
+        if (fEnergyLoss)
         {
             Double_t weight = 1.;
             if (kTarget == det->section)
             {
                 weight = 0.5;
             }
-            gCandidate->PassThroughDetector(det, weight);
+            particle->PassThroughDetector(det, weight);
         }
     }
 
-    // LOG(info) << "1 Start beta:" << gCandidate->GetStartBeta()
-    //<< ",  Beta:" << gCandidate->GetBeta();
-
-    gCandidate->SetStartBeta(gCandidate->GetBeta());
-    gCandidate->SetCharge(-1. * gCandidate->GetCharge());
-    gCandidate->UpdateMomentum();
+    particle->SetStartBeta(particle->GetBeta());
+    particle->SetCharge(-1. * particle->GetCharge());
+    particle->UpdateMomentum();
 
-    // Double_t chi2 = Chi2Backward(variable);
+    auto minimum = fMinimizers->Acquire(10., 0);
 
-    // LOG(info) << "2 chi2 = " << chi2;
+    // create funciton wrapper for minmizer
+    // a IMultiGenFunction type
+    ROOT::Math::Functor f([&context](const double* xx) { return context.Chi2Backward2D(xx); }, 2);
+    minimum->SetFunction(f);
 
-    // return 0;
+    double variable[2] = { 132. * amu, setup->GetHit("fi6", particle->GetHitIndexByName("fi6"))->GetX() };
+    double step[2] = { 0.01, 0.001 };
 
-    Int_t status = 0;
+    // Set the free variables to be minimized!
+    minimum->SetLimitedVariable(0, "m", variable[0], step[0], 125. * amu, 133. * amu);
+    minimum->SetLimitedVariable(1, "xfi6", variable[1], step[1], -100., 100.);
 
     // do the minimization
-    fMinimum->Minimize();
+    minimum->Minimize();
 
-    gCandidate->SetCharge(-1. * gCandidate->GetCharge());
+    particle->SetCharge(-1. * particle->GetCharge());
 
-    status = fMinimum->Status();
-    if (0 != status)
+    Int_t status = minimum->Status();
+    if (0 == status)
     {
-        return status;
+        particle->SetMass(minimum->X()[0]);
+        particle->UpdateMomentum();
     }
 
-    particle->SetMass(fMinimum->X()[0]);
-    particle->UpdateMomentum();
+    fMinimizers->Release(std::move(minimum));
 
-    fMinimum->Clear();
+    return status;
+}
 
-    // candidate->Reset();
+std::vector<Int_t> R3BFragmentFitterChi2::FitTracksBackward2D(const std::vector<R3BTrackingParticle*>& particles,
+                                                              R3BTrackingSetup* setup)
+{
+    std::vector<Int_t> status(particles.size(), 0);
+    UInt_t nThreads = fNThreads > 0 ? fNThreads : std::max(1U, std::thread::hardware_concurrency());
+    nThreads = static_cast<UInt_t>(std::min<std::size_t>(nThreads, particles.size()));
+    if (nThreads <= 1)
+    {
+        for (std::size_t i = 0; i < particles.size(); i++)
+        {
+            status[i] = FitTrackBackward2D(particles[i], setup, fPropagator);
+        }
+        return status;
+    }
 
+    // Every candidate is fitted on one thread with its own context and minimizer.
+    // The propagator is not shared between threads, each has a copy on the same field.
+    while (fThreadPropagators.size() < nThreads)
+    {
+        fThreadPropagators.push_back(std::make_unique<R3BTPropagator>(fPropagator->GetField()));
+    }
+    for (UInt_t thread = 0; thread < nThreads; thread++)
+    {
+        fThreadPropagators[thread]->SetTrajectoryTables(fPropagator->GetForwardTable(),
+                                                         fPropagator->GetBackwardTable());
+    }
+    std::atomic<std::size_t> next{ 0 };
+    std::vector<std::thread> threads;
+    for (UInt_t thread = 0; thread < nThreads; thread++)
+    {
+        threads.emplace_back(
+            [&, propagator = fThreadPropagators[thread].get()]()
+            {
+                for (auto i = next++; i < particles.size(); i = next++)
+                {
+                    status[i] = FitTrackBackward2D(particles[i], setup, propagator);
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
     return status;
 }
 
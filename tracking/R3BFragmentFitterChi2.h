@@ -21,6 +21,19 @@
 #include "Math/Minimizer.h"
 #include "Minuit2/Minuit2Minimizer.h"
 
+#include <memory>
+#include <vector>
+
+/**
+ * Fits mass, velocity or start position of fragment candidates with Minuit2.
+ *
+ * The chi2 functions work on a context object per fit, holding the
+ * candidate, the setup and the hits of the candidate. Minimizers are taken
+ * from a pool and reused for later fits. Fits of different candidates can
+ * therefore run concurrently; FitTracksBackward2D fits the candidates of an
+ * event on SetNThreads() threads, each with its own propagator on the same
+ * field. The setup is only read during the fits.
+ */
 class R3BFragmentFitterChi2 : public R3BFragmentFitterGeneric
 {
   public:
@@ -37,6 +50,13 @@ class R3BFragmentFitterChi2 : public R3BFragmentFitterGeneric
 
     Int_t FitTrackBackward2D(R3BTrackingParticle*, R3BTrackingSetup*);
 
+    std::vector<Int_t> FitTracksBackward2D(const std::vector<R3BTrackingParticle*>& particles,
+                                           R3BTrackingSetup* setup) override;
+
+    // Number of threads of FitTracksBackward2D, 1 (default) fits serially, 0 uses all cores.
+    // Must be called before Init().
+    void SetNThreads(UInt_t nThreads) { fNThreads = nThreads; }
+
     Double_t TrackFragment(R3BTrackingParticle* particle,
                            Bool_t energyLoss,
                            Double_t& devTof,
@@ -51,11 +71,19 @@ class R3BFragmentFitterChi2 : public R3BFragmentFitterGeneric
     Double_t Velocity(R3BTrackingParticle* candidate);
 
   private:
-    ROOT::Math::Minimizer* fMinimum;
+    class Context;
+    class MinimizerPool;
+
+    Int_t FitTrackBackward2D(R3BTrackingParticle*, R3BTrackingSetup*, R3BTPropagator* propagator);
+
+    std::unique_ptr<MinimizerPool> fMinimizers;                     //!
+    std::vector<std::unique_ptr<R3BTPropagator>> fThreadPropagators; //! one per thread of FitTracksBackward2D
     R3BTPropagator* fPropagator;
+    Bool_t fEnergyLoss;
+    UInt_t fNThreads;
     Double_t amu = 0.938272;
 
-    ClassDef(R3BFragmentFitterChi2, 1)
+    ClassDef(R3BFragmentFitterChi2, 2)
 };
 
 #endif
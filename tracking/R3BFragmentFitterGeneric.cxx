@@ -20,3 +20,15 @@ ClassImp(R3BFragmentFitterGeneric)
 }
 
 R3BFragmentFitterGeneric::~R3BFragmentFitterGeneric() {}
+
+std::vector<Int_t> R3BFragmentFitterGeneric::FitTracksBackward2D(const std::vector<R3BTrackingParticle*>& particles,
+                                                                 R3BTrackingSetup* setup)
+{
+    std::vector<Int_t> status;
+    status.reserve(particles.size());
+    for (auto* particle : particles)
+    {
+        status.push_back(FitTrackBackward2D(particle, setup));
+    }
+    return status;
+}
@@ -16,6 +16,8 @@
 
 #include "Rtypes.h"
 
+#include <vector>
+
 class R3BTrackingParticle;
 class R3BTrackingSetup;
 class R3BTPropagator;
@@ -36,6 +38,10 @@ class R3BFragmentFitterGeneric
 
     virtual Int_t FitTrackBackward2D(R3BTrackingParticle*, R3BTrackingSetup*) = 0;
 
+    // Fits all candidates of an event with FitTrackBackward2D, returns the status of each fit
+    virtual std::vector<Int_t> FitTracksBackward2D(const std::vector<R3BTrackingParticle*>& particles,
+                                                   R3BTrackingSetup* setup);
+
     ClassDef(R3BFragmentFitterGeneric, 1)
 };
 
@@ -31,6 +31,7 @@
 #include "R3BTrackingDetector.h"
 #include "R3BTrackingParticle.h"
 #include "R3BTrackingSetup.h"
+#include "R3BTrajectoryTable.h"
 
 #include "FairLogger.h"
 #include "FairRootManager.h"
@@ -39,6 +40,7 @@
 
 #include "TArc.h"
 #include "TClonesArray.h"
+#include "TFile.h"
 #include "TF1.h"
 #include "TGraphErrors.h"
 #include "TH1F.h"
@@ -256,8 +258,6 @@ void R3BFragmentTracker::Exec(const Option_t*)
     //    for (all tof hits)
     fPropagator->SetVis(kFALSE);
 
-    Int_t nCand = 0;
-
     Int_t ipsp = 0;
     Int_t ifi4 = 0;
     Int_t ifi5 = 0;
@@ -274,6 +274,12 @@ void R3BFragmentTracker::Exec(const Option_t*)
     if (0 == tof->hits.size())
         itof = -1;
 
+    tof->res_t = 0.03;
+
+    Double_t velocity0 = 0.8328 + 0.0003;
+
+    // Collect all combinations of hits first, the fitter can then fit them in parallel
+    std::vector<R3BTrackingParticle*> candidates;
     {
         do
         {
@@ -291,10 +297,6 @@ void R3BFragmentTracker::Exec(const Option_t*)
                     {
                         do
                         {
-                            tof->res_t = 0.03;
-
-                            Double_t velocity0 = 0.8328 + 0.0003;
-
                             // Create object for particle which will be fitted
                             R3BTrackingParticle* candidate = new R3BTrackingParticle(
                                 particle->GetCharge(), 0., 0., 0., 0., 0., 0., velocity0, 132. * Amu);
@@ -316,50 +318,8 @@ void R3BFragmentTracker::Exec(const Option_t*)
                             candidate->AddHit("fi6", ifi6);
                             candidate->AddHit("tofd", itof);
 
-                            // find momentum
-                            // momin is only a first guess
-                            Int_t status = fFitter->FitTrackBackward2D(candidate, fDetectors);
-
-                            nCand += 1;
-
-                            if (TMath::IsNaN(candidate->GetMomentum().Z()))
-                            {
-                                delete candidate;
-                                continue;
-                            }
-
-                            if (0 == status)
-                            {
-                                candidate->SetStartPosition(candidate->GetPosition());
-                                candidate->SetStartMomentum(-1. * candidate->GetMomentum());
-                                // candidate->SetStartBeta(0.8328);
-                                candidate->SetStartBeta(velocity0);
-                                candidate->UpdateMomentum();
-                                candidate->Reset();
-
-                                // candidate->GetStartPosition().Print();
-                                // candidate->GetStartMomentum().Print();
-                                // cout << "chi2: " << candidate->GetChi2() << endl;
-                                // status = FitFragment(candidate);
-
-                                if (0 == status)
-                                {
-                                    // if(candidate->GetChi2() < 3.)
-                                    {
-                                        fFragments.push_back(candidate);
-                                    }
-                                }
-                                else
-                                {
-                                    delete candidate;
-                                }
-                            }
-                            else
-                            {
-                                delete candidate;
-                            }
+                            candidates.push_back(candidate);
 
-                            // return;
                             itof += 1;
                         } while (itof < tof->hits.size());
                         ifi6 += 1;
@@ -372,6 +332,43 @@ void R3BFragmentTracker::Exec(const Option_t*)
         } while (ipsp < psp->hits.size());
     }
 
+    // find momentum
+    // momin is only a first guess
+    std::vector<Int_t> fitStatus = fFitter->FitTracksBackward2D(candidates, fDetectors);
+
+    Int_t nCand = candidates.size();
+
+    for (std::size_t i = 0; i < candidates.size(); i++)
+    {
+        R3BTrackingParticle* candidate = candidates[i];
+        Int_t status = fitStatus[i];
+
+        if (TMath::IsNaN(candidate->GetMomentum().Z()))
+        {
+            delete candidate;
+            continue;
+        }
+
+        if (0 == status)
+        {
+            candidate->SetStartPosition(candidate->GetPosition());
+            candidate->SetStartMomentum(-1. * candidate->GetMomentum());
+            // candidate->SetStartBeta(0.8328);
+            candidate->SetStartBeta(velocity0);
+            candidate->UpdateMomentum();
+            candidate->Reset();
+
+            // if(candidate->GetChi2() < 3.)
+            {
+                fFragments.push_back(candidate);
+            }
+        }
+        else
+        {
+            delete candidate;
+        }
+    }
+
     fh_ncand->Fill(nCand);
 
     R3BTrackingParticle* candidate = new R3BTrackingParticle();
@@ -628,6 +625,30 @@ Bool_t R3BFragmentTracker::InitPropagator()
             delete fPropagator;
         }
         fPropagator = new R3BTPropagator(gladField, fVis);
+
+        if (!fTrajectoryTableFile.IsNull())
+        {
+            auto file = std::unique_ptr<TFile>(TFile::Open(fTrajectoryTableFile));
+            if (!file || file->IsZombie())
+            {
+                LOG(error) << "Cannot open trajectory table file " << fTrajectoryTableFile;
+                return kFALSE;
+            }
+            fForwardTable.reset(file->Get<R3BTrajectoryTable>(R3BTrajectoryTable::ForwardName));
+            fBackwardTable.reset(file->Get<R3BTrajectoryTable>(R3BTrajectoryTable::BackwardName));
+            for (const auto* table : { fForwardTable.get(), fBackwardTable.get() })
+            {
+                if (table && !table->IsValidFor(*gladField))
+                {
+                    LOG(error) << "Trajectory table in " << fTrajectoryTableFile
+                               << " does not match the position, rotation or scale of the field";
+                    return kFALSE;
+                }
+            }
+            LOG(info) << "Using trajectory tables from " << fTrajectoryTableFile << ":"
+                      << (fForwardTable ? " forward" : "") << (fBackwardTable ? " backward" : "");
+            fPropagator->SetTrajectoryTables(fForwardTable.get(), fBackwardTable.get());
+        }
     }
     else
     {
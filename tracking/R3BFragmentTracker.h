@@ -16,6 +16,7 @@
 
 #include "FairTask.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@ class R3BTPropagator;
 class R3BTrackingDetector;
 class R3BTrackingParticle;
 class R3BTrackingSetup;
+class R3BTrajectoryTable;
 class R3BFragmentFitterGeneric;
 
 class TH1F;
@@ -46,12 +48,17 @@ class R3BFragmentTracker : public FairTask
 
     void SetFragmentFitter(R3BFragmentFitterGeneric* fitter) { fFitter = fitter; }
     void SetEnergyLoss(Bool_t energyLoss) { fEnergyLoss = energyLoss; }
+    // File with the R3BTrajectoryTable of the field, used instead of Runge-Kutta inside of it
+    void SetTrajectoryTableFile(const TString& fileName) { fTrajectoryTableFile = fileName; }
 
   private:
     Bool_t InitPropagator();
 
     R3BFieldPar* fFieldPar;
     R3BTPropagator* fPropagator;
+    TString fTrajectoryTableFile;
+    std::unique_ptr<R3BTrajectoryTable> fForwardTable;  //!
+    std::unique_ptr<R3BTrajectoryTable> fBackwardTable; //!
     TClonesArray* fArrayMCTracks; // simulation output??? To compare?
     R3BTrackingSetup* fDetectors; // array of R3BTrackingDetector
     std::vector<R3BTrackingParticle*> fFragments;
@@ -89,7 +96,7 @@ class R3BFragmentTracker : public FairTask
     TH1F* fh_vz_res;
     TH1F* fh_beta_res;
 
-    ClassDef(R3BFragmentTracker, 1)
+    ClassDef(R3BFragmentTracker, 2)
 };
 
 #endif
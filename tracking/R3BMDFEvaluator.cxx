@@ -0,0 +1,198 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BMDFEvaluator.h"
+#include "R3BLogger.h"
+#include "R3BMDFWrapper.h"
+#include "TString.h"
+#include <algorithm>
+#include <utility>
+
+size_t R3BMDFEvaluator::AddFunction(const R3BMDFWrapper& mdf)
+{
+    const auto nVariables = static_cast<size_t>(mdf.GetNVariables());
+    if (fFunctions.empty())
+    {
+        fNVariables = nVariables;
+    }
+    else if (nVariables != fNVariables)
+    {
+        R3BLOG(fatal,
+               Form("MDF function with %zu variables does not match the %zu variables of the others",
+                    nVariables,
+                    fNVariables));
+    }
+
+    Function function;
+    function.dMean = mdf.GetDMean();
+    function.firstTerm = fCoefficients.size();
+    for (int coef = 0; coef < mdf.GetNCoefficients(); coef++)
+    {
+        fCoefficients.push_back(mdf.GetCoefficient(coef));
+        for (size_t var = 0; var < nVariables; var++)
+        {
+            const auto power = mdf.GetPower(coef, static_cast<int>(var));
+            if (power < 1)
+            {
+                R3BLOG(fatal, Form("MDF function with invalid power %d", power));
+            }
+            if (power == 1)
+            {
+                continue;
+            }
+            const auto basis = FindBasis(var,
+                                         mdf.GetXMin(static_cast<int>(var)),
+                                         mdf.GetXMax(static_cast<int>(var)),
+                                         mdf.GetPolyType(),
+                                         mdf.GetPolyType() == 2 ? coef : -1);
+            fBases[basis].maxPower = std::max(fBases[basis].maxPower, power);
+            fFactorBasis.push_back(basis);
+            fFactorPower.push_back(power);
+            if (std::find(function.bases.cbegin(), function.bases.cend(), basis) == function.bases.cend())
+            {
+                function.bases.push_back(basis);
+            }
+        }
+        fFactorEnd.push_back(fFactorBasis.size());
+    }
+    function.lastTerm = fCoefficients.size();
+    fFunctions.push_back(std::move(function));
+
+    UpdateLayout();
+    return fFunctions.size() - 1;
+}
+
+void R3BMDFEvaluator::Clear()
+{
+    fNVariables = 0;
+    fNBasisValues = 0;
+    fBases.clear();
+    fAllBases.clear();
+    fFunctions.clear();
+    fCoefficients.clear();
+    fFactorEnd.clear();
+    fFactorBasis.clear();
+    fFactorPower.clear();
+    fFactorIndex.clear();
+}
+
+size_t R3BMDFEvaluator::FindBasis(size_t variable, double xMin, double xMax, int polyType, int legendreIndex)
+{
+    for (size_t idx = 0; idx < fBases.size(); idx++)
+    {
+        const auto& basis = fBases[idx];
+        if (basis.variable == variable && basis.xMin == xMin && basis.xMax == xMax && basis.polyType == polyType &&
+            basis.legendreIndex == legendreIndex)
+        {
+            return idx;
+        }
+    }
+    fBases.push_back(Basis{ variable, xMin, xMax, polyType, legendreIndex, 1, 0 });
+    return fBases.size() - 1;
+}
+
+void R3BMDFEvaluator::UpdateLayout()
+{
+    fNBasisValues = 0;
+    fAllBases.resize(fBases.size());
+    for (size_t idx = 0; idx < fBases.size(); idx++)
+    {
+        fBases[idx].offset = fNBasisValues;
+        fNBasisValues += fBases[idx].maxPower;
+        fAllBases[idx] = idx;
+    }
+    fFactorIndex.resize(fFactorBasis.size());
+    for (size_t idx = 0; idx < fFactorBasis.size(); idx++)
+    {
+        fFactorIndex[idx] = fBases[fFactorBasis[idx]].offset + fFactorPower[idx] - 1;
+    }
+}
+
+// Same recursion as in R3BMDFWrapper::MDF(), the table holds the values for the powers 1 ... maxPower
+void R3BMDFEvaluator::FillBases(const std::vector<size_t>& bases, const double* x, double* table) const
+{
+    for (const auto idx : bases)
+    {
+        const auto& basis = fBases[idx];
+        double* values = table + basis.offset;
+        const double v = 1 + 2. / (basis.xMax - basis.xMin) * (x[basis.variable] - basis.xMax);
+        const int i = basis.legendreIndex;
+        double p1 = 1, p2 = v, p3 = 0;
+        values[0] = 1;
+        values[1] = v;
+        for (int k = 3; k <= basis.maxPower; k++)
+        {
+            p3 = p2 * v;
+
+            if (basis.polyType == 2) // kLegendre
+                p3 = ((2 * i - 3) * p2 * v - (i - 2) * p1) / (i - 1);
+
+            if (basis.polyType == 1) // kChebyshev
+                p3 = 2 * v * p2 - p1;
+
+            p1 = p2;
+            p2 = p3;
+            values[k - 1] = p3;
+        }
+    }
+}
+
+double R3BMDFEvaluator::EvaluateFunction(const Function& function, const double* table) const
+{
+    double returnValue = function.dMean;
+    size_t factor = function.firstTerm == 0 ? 0 : fFactorEnd[function.firstTerm - 1];
+    for (size_t term = function.firstTerm; term < function.lastTerm; term++)
+    {
+        double value = fCoefficients[term];
+        for (; factor < fFactorEnd[term]; factor++)
+        {
+            value *= table[fFactorIndex[factor]];
+        }
+        returnValue += value;
+    }
+    return returnValue;
+}
+
+void R3BMDFEvaluator::Evaluate(const double* x, double* out) const { EvaluateBatch(x, 1, out); }
+
+double R3BMDFEvaluator::Evaluate(size_t function, const double* x) const
+{
+    double out = 0;
+    EvaluateBatch(function, x, 1, &out);
+    return out;
+}
+
+void R3BMDFEvaluator::EvaluateBatch(const double* x, size_t nEvents, double* out) const
+{
+    std::vector<double> table(fNBasisValues);
+    for (size_t event = 0; event < nEvents; event++)
+    {
+        FillBases(fAllBases, x + event * fNVariables, table.data());
+        for (size_t idx = 0; idx < fFunctions.size(); idx++)
+        {
+            out[event * fFunctions.size() + idx] = EvaluateFunction(fFunctions[idx], table.data());
+        }
+    }
+}
+
+void R3BMDFEvaluator::EvaluateBatch(size_t function, const double* x, size_t nEvents, double* out) const
+{
+    const auto& func = fFunctions.at(function);
+    std::vector<double> table(fNBasisValues);
+    for (size_t event = 0; event < nEvents; event++)
+    {
+        FillBases(func.bases, x + event * fNVariables, table.data());
+        out[event] = EvaluateFunction(func, table.data());
+    }
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BMDFEVALUATOR_H
+#define R3BMDFEVALUATOR_H
+
+#include <cstddef>
+#include <vector>
+
+class R3BMDFWrapper;
+
+// Evaluates several MDF functions (R3BMDFWrapper) which take the same input vector.
+//
+// R3BMDFWrapper::MDF() recomputes the polynomial of every variable for every coefficient. Here the
+// polynomials of each variable are tabulated once per input for all powers in use and shared by all
+// terms and all functions with the same variable range and polynomial type. Every term is then a
+// product of table lookups. The operations per term are the same as in R3BMDFWrapper::MDF(), hence the
+// results are identical.
+//
+// The evaluation methods are const and only use local buffers, they may be called concurrently.
+class R3BMDFEvaluator
+{
+  public:
+    R3BMDFEvaluator() = default;
+
+    // Copies the parameters of the function, returns its index in the output arrays.
+    // All functions must have the same number of variables.
+    size_t AddFunction(const R3BMDFWrapper& mdf);
+    void Clear();
+
+    size_t GetNFunctions() const { return fFunctions.size(); }
+    size_t GetNVariables() const { return fNVariables; }
+    size_t GetNBasisValues() const { return fNBasisValues; }
+
+    // All functions for one input: x[GetNVariables()] -> out[GetNFunctions()]
+    void Evaluate(const double* x, double* out) const;
+    // One function for one input
+    double Evaluate(size_t function, const double* x) const;
+
+    // All functions for nEvents inputs: x[nEvents][GetNVariables()] -> out[nEvents][GetNFunctions()]
+    void EvaluateBatch(const double* x, size_t nEvents, double* out) const;
+    // One function for nEvents inputs: x[nEvents][GetNVariables()] -> out[nEvents]
+    void EvaluateBatch(size_t function, const double* x, size_t nEvents, double* out) const;
+
+  private:
+    // Polynomials of one variable, tabulated for powers 1 ... maxPower
+    struct Basis
+    {
+        size_t variable;
+        double xMin;
+        double xMax;
+        int polyType;
+        int legendreIndex; // the Legendre recursion of R3BMDFWrapper::MDF() depends on the coefficient index
+        int maxPower;
+        size_t offset; // position of power 1 in the table
+    };
+
+    struct Function
+    {
+        double dMean;
+        size_t firstTerm;
+        size_t lastTerm;
+        std::vector<size_t> bases; // bases used by this function
+    };
+
+    size_t fNVariables = 0;
+    size_t fNBasisValues = 0;
+    std::vector<Basis> fBases;
+    std::vector<size_t> fAllBases;
+    std::vector<Function> fFunctions;
+
+    // Terms of all functions: coefficient and the factors with power > 1 (power 1 is the constant 1)
+    std::vector<double> fCoefficients;
+    std::vector<size_t> fFactorEnd;   // end of the factors of each term
+    std::vector<size_t> fFactorBasis; // basis of each factor
+    std::vector<int> fFactorPower;    // power of each factor
+    std::vector<size_t> fFactorIndex; // table index of each factor
+
+    size_t FindBasis(size_t variable, double xMin, double xMax, int polyType, int legendreIndex);
+    void UpdateLayout();
+    void FillBases(const std::vector<size_t>& bases, const double* x, double* table) const;
+    double EvaluateFunction(const Function& function, const double* table) const;
+};
+
+#endif // R3BMDFEVALUATOR_H
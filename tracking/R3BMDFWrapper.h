@@ -36,9 +36,18 @@ class R3BMDFWrapper : public TObject
     void PrintPCA();
     void X2P(Double_t* x, Double_t* p);
     void P2X(Double_t* p, Double_t* x, Int_t nTest);
-    int GetNVariables() { return mdf_NVariables; }
+    int GetNVariables() const { return mdf_NVariables; }
     Double_t MDF(Double_t* x);
 
+    // Read access to the MDF parameters, e.g. for R3BMDFEvaluator
+    int GetNCoefficients() const { return mdf_NCoefficients; }
+    int GetPolyType() const { return mdf_PolyType; }
+    double GetDMean() const { return mdf_DMean; }
+    double GetXMin(int var) const { return mdf_XMin[var]; }
+    double GetXMax(int var) const { return mdf_XMax[var]; }
+    double GetCoefficient(int coef) const { return mdf_Coefficient[coef]; }
+    int GetPower(int coef, int var) const { return mdf_Power[mdf_NVariables * coef + var]; }
+
   private:
     // MDF data
     int mdf_NVariables;
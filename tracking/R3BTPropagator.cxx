@@ -16,6 +16,7 @@
 #include "R3BTGeoPar.h"
 #include "R3BTrackingDetector.h"
 #include "R3BTrackingParticle.h"
+#include "R3BTrajectoryTable.h"
 
 #include "FairLogger.h"
 #include "FairRKPropagator.h"
@@ -29,6 +30,8 @@ R3BTPropagator::R3BTPropagator(R3BGladFieldMap* field, Bool_t vis)
     , fField(field)
     , fmTofGeo(NULL)
     , fVis(vis)
+    , fForwardTable(nullptr)
+    , fBackwardTable(nullptr)
 {
     // Define magnetic field boundaries ------------------------------------
     TVector3 pos(field->GetPositionX(), field->GetPositionY(), field->GetPositionZ());
@@ -72,7 +75,33 @@ R3BTPropagator::R3BTPropagator(R3BGladFieldMap* field, Bool_t vis)
     }
 }
 
-R3BTPropagator::~R3BTPropagator() {}
+R3BTPropagator::~R3BTPropagator() { delete fFairProp; }
+
+R3BGladFieldMap* R3BTPropagator::GetField() const { return static_cast<R3BGladFieldMap*>(fField); }
+
+void R3BTPropagator::SetTrajectoryTables(const R3BTrajectoryTable* forward, const R3BTrajectoryTable* backward)
+{
+    for (const auto* table : { forward, backward })
+    {
+        if (table && !table->IsValidFor(*GetField()))
+        {
+            LOG(warn) << "R3BTPropagator: Trajectory table was generated for another setting of the field";
+        }
+    }
+    fForwardTable = forward;
+    fBackwardTable = backward;
+}
+
+Bool_t R3BTPropagator::PropagateThroughField(R3BTrackingParticle* particle, Bool_t backward)
+{
+    const R3BTrajectoryTable* table = backward ? fBackwardTable : fForwardTable;
+    if (table && table->Propagate(particle))
+    {
+        return kTRUE;
+    }
+    return backward ? PropagateToPlaneRK(particle, fPlane1[0], fPlane1[2], fPlane1[1])
+                    : PropagateToPlaneRK(particle, fPlane2[0], fPlane2[1], fPlane2[2]);
+}
 
 Bool_t R3BTPropagator::PropagateToDetector(R3BTrackingParticle* particle, R3BTrackingDetector* detector)
 {
@@ -153,7 +182,7 @@ Bool_t R3BTPropagator::PropagateToPlane(R3BTrackingParticle* particle,
         }
         LOG(debug2) << "Propagating to exit from magnetic field.";
         tpos = particle->GetPosition();
-        result = PropagateToPlaneRK(particle, fPlane2[0], fPlane2[1], fPlane2[2]);
+        result = PropagateThroughField(particle, kFALSE);
         if (fVis)
         {
             TLine* l1 = new TLine(-tpos.X(), tpos.Z(), -particle->GetX(), particle->GetZ());
@@ -251,7 +280,7 @@ Bool_t R3BTPropagator::PropagateToPlaneBackward(R3BTrackingParticle* particle,
         }
         LOG(debug2) << "Propagating to entrance of magnetic field.";
         tpos = particle->GetPosition();
-        result = PropagateToPlaneRK(particle, fPlane1[0], fPlane1[2], fPlane1[1]);
+        result = PropagateThroughField(particle, kTRUE);
         if (fVis)
         {
             TLine* l1 = new TLine(-tpos.X(), tpos.Z(), -particle->GetX(), particle->GetZ());
@@ -24,6 +24,7 @@ class R3BTGeoPar;
 class FairField;
 class R3BTrackingParticle;
 class R3BTrackingDetector;
+class R3BTrajectoryTable;
 
 constexpr int N_PARTICLE_INFO = 7;
 
@@ -75,7 +76,21 @@ class R3BTPropagator : public TObject
 
     void SetVis(Bool_t vis = kTRUE) { fVis = vis; }
 
+    R3BGladFieldMap* GetField() const;
+
+    /**
+     * Tables used instead of the Runge-Kutta propagation from one boundary of
+     * the field to the other, downstream and upstream. Either may be nullptr.
+     * Tracks outside of a table are still propagated with Runge-Kutta.
+     * The tables are not owned and must outlive the propagator.
+     */
+    void SetTrajectoryTables(const R3BTrajectoryTable* forward, const R3BTrajectoryTable* backward);
+    const R3BTrajectoryTable* GetForwardTable() const { return fForwardTable; }
+    const R3BTrajectoryTable* GetBackwardTable() const { return fBackwardTable; }
+
   private:
+    Bool_t PropagateThroughField(R3BTrackingParticle* particle, Bool_t backward);
+
     FairRKPropagator* fFairProp;
 
     FairField* fField;
@@ -91,6 +106,9 @@ class R3BTPropagator : public TObject
 
     TCanvas* fc4;
 
+    const R3BTrajectoryTable* fForwardTable;  //!
+    const R3BTrajectoryTable* fBackwardTable; //!
+
     ClassDef(R3BTPropagator, 1)
 };
 
@@ -143,6 +143,19 @@ InitStatus R3BTrackingS515::Init()
     LOG(info) << "Reading MDF function for TY1";
     MDF_TY1 = new R3BMDFWrapper(MDF_TY1_filename.Data());
 
+    // same order as in MDFFunctions
+    MDF_Evaluator.Clear();
+    MDF_Evaluator.AddFunction(*MDF_PoQ);
+    MDF_Evaluator.AddFunction(*MDF_TX0);
+    MDF_Evaluator.AddFunction(*MDF_TX1);
+    MDF_Evaluator.AddFunction(*MDF_TY0);
+    MDF_Evaluator.AddFunction(*MDF_TY1);
+    MDF_Evaluator.AddFunction(*MDF_FlightPath);
+    if (MDF_Evaluator.GetNVariables() != sizeof(mdf_data) / sizeof(mdf_data[0]))
+    {
+        R3BLOG(fatal, Form("MDF functions with %zu instead of 8 variables", MDF_Evaluator.GetNVariables()));
+    }
+
     // linking to global pointer (needed by alignment)
     gMDFTracker = this;
 
@@ -291,11 +304,12 @@ void R3BTrackingS515::Exec(Option_t* option)
     mdf_data[6] = f11_point.Z();
     mdf_data[7] = (f12_point.Y() - mwpc_point.Y()) / (f12_point.Z() - mwpc_point.Z());
 
-    PoQ = MDF_PoQ->MDF(mdf_data) * GladCurrent / GladReferenceCurrent;
-    TX0 = MDF_TX0->MDF(mdf_data);
-    TX1 = MDF_TX1->MDF(mdf_data);
-    TY0 = MDF_TY0->MDF(mdf_data);
-    TY1 = MDF_TY1->MDF(mdf_data);
+    MDF_Evaluator.Evaluate(mdf_data, mdf_values);
+    PoQ = mdf_values[MDF_POQ] * GladCurrent / GladReferenceCurrent;
+    TX0 = mdf_values[MDF_TX0];
+    TX1 = mdf_values[MDF_TX1];
+    TY0 = mdf_values[MDF_TY0];
+    TY1 = mdf_values[MDF_TY1];
 
     //----- Calculate additional FlightPath from MWPC to the target
     double targ_dx = mwpc_position.Z() * TX0;
@@ -308,7 +322,7 @@ void R3BTrackingS515::Exec(Option_t* option)
     double fp_f11_to_tofd = vec_f11_to_tofd.Mag();
 
     // Final flight path from target to tofd
-    FlightPath = MDF_FlightPath->MDF(mdf_data) + fp_mwpc_to_target + fp_f11_to_tofd;
+    FlightPath = mdf_values[MDF_FLIGHTPATH] + fp_mwpc_to_target + fp_f11_to_tofd;
 
     //----- Calculate Beta
     // ToF = tofd_hit->GetTof() + tof_offset;
@@ -527,13 +541,19 @@ double R3BTrackingS515::AlignmentErrorS515(const double* par)
     gMDFTracker->f12_ang_offset.SetXYZ(0, par[15], par[16]);
     gMDFTracker->f12_pos_offset.SetXYZ(par[17], par[18], par[19]);
 
-    Double_t mdf_input[8]; // data container for the MDF function
+    // MDF inputs of all reference tracks, evaluated in one batch below
+    auto& mdf_batch_data = gMDFTracker->mdf_batch_data;
+    auto& mdf_batch_values = gMDFTracker->mdf_batch_values;
+    mdf_batch_data.resize(8 * gMDFTracker->det_points_vec.size());
+    mdf_batch_values.resize(gMDFTracker->det_points_vec.size());
 
     double v2 = 0;
     double v = 0;
     int counter = 0;
     for (auto& d : (gMDFTracker->det_points_vec))
     {
+        Double_t* mdf_input = &mdf_batch_data[8 * counter];
+
         gMDFTracker->mwpc_point = d.mwpc;
         gMDFTracker->f10_point = d.f10;
         gMDFTracker->f11_point = d.f11;
@@ -565,9 +585,13 @@ double R3BTrackingS515::AlignmentErrorS515(const double* par)
         mdf_input[6] = gMDFTracker->f11_point.Z();
         mdf_input[7] = (gMDFTracker->f12_point.Y() - mdf_input[1]) / (gMDFTracker->f12_point.Z() - mdf_input[2]);
 
-        v2 += pow((gMDFTracker->Get_MDF_PoQ()->MDF(mdf_input) - gMDFTracker->GetReferencePoQ()), 2);
         counter++;
     }
+    gMDFTracker->MDF_Evaluator.EvaluateBatch(MDF_POQ, mdf_batch_data.data(), counter, mdf_batch_values.data());
+    for (const auto poq : mdf_batch_values)
+    {
+        v2 += pow((poq - gMDFTracker->GetReferencePoQ()), 2);
+    }
     v2 /= counter;
     v = sqrt(v2);
     // std::cout << "\nReturning error: " << v;
@@ -18,6 +18,7 @@
 
 #include "FairTask.h"
 #include "R3BEventHeader.h"
+#include "R3BMDFEvaluator.h"
 #include "R3BMDFWrapper.h"
 #include "R3BTrack.h"
 #include "TCanvas.h"
@@ -196,6 +197,22 @@ class R3BTrackingS515 : public FairTask
     TString MDF_TX1_filename;
     TString MDF_TY1_filename;
 
+    // All MDF functions share the input variables and are evaluated together
+    enum MDFFunctions
+    {
+        MDF_POQ,
+        MDF_TX0,
+        MDF_TX1,
+        MDF_TY0,
+        MDF_TY1,
+        MDF_FLIGHTPATH,
+        MDF_NFUNCTIONS
+    };
+    R3BMDFEvaluator MDF_Evaluator;          //!
+    Double_t mdf_values[MDF_NFUNCTIONS];    //! results of the MDF functions
+    std::vector<Double_t> mdf_batch_data;   //! MDF inputs of all reference tracks (alignment)
+    std::vector<Double_t> mdf_batch_values; //! PoQ of all reference tracks (alignment)
+
     Double_t mdf_data[8];   // data container for the MDF function
     unsigned long fNEvents; // Event counter
     Int_t fTrigger;
@@ -0,0 +1,353 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BTrajectoryTable.h"
+#include "R3BException.h"
+#include "R3BGladFieldMap.h"
+#include "R3BTPropagator.h"
+#include "R3BTrackingParticle.h"
+
+#include "FairLogger.h"
+
+#include "TMath.h"
+#include "TROOT.h"
+#include "TVector3.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace
+{
+    // Particles are put onto the planes by straight lines, up to rounding
+    constexpr Double_t kPlaneTolerance = 1e-3; // [cm]
+
+    // Differences of the field setting below which a table is still valid
+    constexpr Double_t kFieldTolerance = 1e-6;
+
+    // Track on a plane of constant z in the frame of the field
+    void ToState(const TVector3& direction, Double_t k, const TVector3& position, Double_t* state)
+    {
+        state[R3BTrajectoryTable::kX] = position.X();
+        state[R3BTrajectoryTable::kY] = position.Y();
+        state[R3BTrajectoryTable::kTx] = direction.X() / direction.Z();
+        state[R3BTrajectoryTable::kTy] = direction.Y() / direction.Z();
+        state[R3BTrajectoryTable::kK] = k;
+    }
+} // namespace
+
+R3BTrajectoryTable::R3BTrajectoryTable()
+    : fBackward(kFALSE)
+    , fPosition{ 0., 0., 0. }
+    , fYAngle(0.)
+    , fScale(0.)
+    , fZEntrance(0.)
+    , fZExit(0.)
+    , fNNodes{}
+    , fMin{}
+    , fMax{}
+{
+}
+
+R3BTrajectoryTable::R3BTrajectoryTable(const R3BGladFieldMap& field, Bool_t backward)
+    : fBackward(backward)
+    , fPosition{ field.GetPositionX(), field.GetPositionY(), field.GetPositionZ() }
+    , fYAngle(field.GetYAngle())
+    , fScale(field.GetScale())
+    , fZEntrance(backward ? field.GetZmax() : field.GetZmin())
+    , fZExit(backward ? field.GetZmin() : field.GetZmax())
+    , fNNodes{}
+    , fMin{}
+    , fMax{}
+{
+}
+
+void R3BTrajectoryTable::SetAxis(Variable variable, Int_t nNodes, Double_t min, Double_t max)
+{
+    if (variable < kX || variable >= kNVariables)
+    {
+        throw R3B::runtime_error("R3BTrajectoryTable::SetAxis: Unknown variable");
+    }
+    if (nNodes < 2 || !(min < max))
+    {
+        throw R3B::runtime_error("R3BTrajectoryTable::SetAxis: An axis needs at least 2 nodes and min < max");
+    }
+    fNNodes[variable] = nNodes;
+    fMin[variable] = min;
+    fMax[variable] = max;
+    fData.clear();
+}
+
+Int_t R3BTrajectoryTable::GetNNodes() const
+{
+    Int_t nNodes = 1;
+    for (Int_t v = 0; v < kNVariables; v++)
+    {
+        nNodes *= fNNodes[v];
+    }
+    return nNodes;
+}
+
+void R3BTrajectoryTable::GetNode(Int_t node, Double_t* state) const
+{
+    for (Int_t v = 0; v < kNVariables; v++)
+    {
+        const Int_t index = node % fNNodes[v];
+        node /= fNNodes[v];
+        state[v] = fMin[v] + (fMax[v] - fMin[v]) * index / (fNNodes[v] - 1);
+    }
+}
+
+void R3BTrajectoryTable::Generate(const R3BTPropagator& propagator, UInt_t nThreads)
+{
+    nThreads = nThreads > 0 ? nThreads : std::max(1U, std::thread::hardware_concurrency());
+    if (nThreads > 1)
+    {
+        ROOT::EnableThreadSafety();
+    }
+
+    // Each thread steps with its own propagator on the same field
+    auto* field = propagator.GetField();
+    std::vector<std::unique_ptr<R3BTPropagator>> propagators;
+    for (UInt_t thread = 0; thread < nThreads; thread++)
+    {
+        propagators.push_back(std::make_unique<R3BTPropagator>(field));
+    }
+
+    const TVector3 position(fPosition[0], fPosition[1], fPosition[2]);
+    const Double_t angle = fYAngle * TMath::DegToRad();
+    const auto toGlobal = [&](TVector3 vector, Bool_t isPoint)
+    {
+        vector.RotateY(angle);
+        return isPoint ? vector + position : vector;
+    };
+    const auto toLocal = [&](TVector3 vector, Bool_t isPoint)
+    {
+        if (isPoint)
+        {
+            vector -= position;
+        }
+        vector.RotateY(-angle);
+        return vector;
+    };
+
+    const TVector3 exit[3] = { toGlobal(TVector3(0., 0., fZExit), kTRUE),
+                               toGlobal(TVector3(fBackward ? 0. : 1., fBackward ? 1. : 0., fZExit), kTRUE),
+                               toGlobal(TVector3(fBackward ? 1. : 0., fBackward ? 0. : 1., fZExit), kTRUE) };
+    const TVector3 normal = ((exit[1] - exit[0]).Cross(exit[2] - exit[0])).Unit();
+    const Double_t sense = fBackward ? -1. : 1.;
+
+    Fill(
+        [&](UInt_t thread, const Double_t* state, Double_t* outputs)
+        {
+            auto* prop = propagators[thread].get();
+            const Double_t k = state[kK];
+            const TVector3 start = toGlobal(TVector3(state[kX], state[kY], fZEntrance), kTRUE);
+            const TVector3 direction = toGlobal(sense * TVector3(state[kTx], state[kTy], 1.).Unit(), kFALSE);
+
+            // Straight line for k = 0, charge 0 and any momentum
+            const Double_t mom = k != 0. ? 1. / TMath::Abs(k) : 1.;
+            const Double_t charge = k > 0. ? 1. : (k < 0. ? -1. : 0.);
+            R3BTrackingParticle particle(charge,
+                                         start.X(),
+                                         start.Y(),
+                                         start.Z(),
+                                         mom * direction.X(),
+                                         mom * direction.Y(),
+                                         mom * direction.Z(),
+                                         0.,
+                                         0.);
+            if (charge != 0. && !prop->PropagateToPlaneRK(&particle, exit[0], exit[1], exit[2]))
+            {
+                return kFALSE;
+            }
+
+            // Runge-Kutta stops just before the plane
+            TVector3 intersect;
+            if (!prop->LineIntersectPlane(particle.GetPosition(), particle.GetMomentum(), exit[0], normal, intersect))
+            {
+                return kFALSE;
+            }
+            const Double_t length = particle.GetLength() + (intersect - particle.GetPosition()).Mag();
+            ToState(toLocal(particle.GetMomentum(), kFALSE), k, toLocal(intersect, kTRUE), outputs);
+            outputs[4] = length;
+            return kTRUE;
+        },
+        nThreads);
+}
+
+void R3BTrajectoryTable::Generate(const std::function<Bool_t(const Double_t* state, Double_t* outputs)>& transport,
+                                  UInt_t nThreads)
+{
+    nThreads = nThreads > 0 ? nThreads : std::max(1U, std::thread::hardware_concurrency());
+    Fill([&](UInt_t, const Double_t* state, Double_t* outputs) { return transport(state, outputs); }, nThreads);
+}
+
+void R3BTrajectoryTable::Fill(
+    const std::function<Bool_t(UInt_t thread, const Double_t* state, Double_t* outputs)>& transport,
+    UInt_t nThreads)
+{
+    for (Int_t v = 0; v < kNVariables; v++)
+    {
+        if (fNNodes[v] < 2)
+        {
+            throw R3B::runtime_error("R3BTrajectoryTable::Generate: Not all axes are set");
+        }
+    }
+
+    const Int_t nNodes = GetNNodes();
+    fData.assign(static_cast<std::size_t>(nNodes) * NOutputs, std::numeric_limits<Float_t>::quiet_NaN());
+    std::atomic<Int_t> next{ 0 };
+    std::atomic<Int_t> nFailed{ 0 };
+    const auto work = [&](UInt_t thread)
+    {
+        Double_t state[kNVariables];
+        Double_t outputs[NOutputs];
+        for (auto node = next++; node < nNodes; node = next++)
+        {
+            GetNode(node, state);
+            if (!transport(thread, state, outputs))
+            {
+                nFailed++;
+                continue;
+            }
+            std::copy(outputs, outputs + NOutputs, fData.begin() + static_cast<std::size_t>(node) * NOutputs);
+        }
+    };
+
+    nThreads = std::min<UInt_t>(nThreads, nNodes);
+    if (nThreads <= 1)
+    {
+        work(0);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        for (UInt_t thread = 0; thread < nThreads; thread++)
+        {
+            threads.emplace_back(work, thread);
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    LOG(info) << "R3BTrajectoryTable: Generated " << nNodes << " nodes" << (fBackward ? " backward" : "") << ", "
+              << nFailed << " failed";
+}
+
+Bool_t R3BTrajectoryTable::Interpolate(const Double_t* state, Double_t* outputs) const
+{
+    if (fData.empty())
+    {
+        return kFALSE;
+    }
+
+    Int_t base = 0;
+    Int_t stride[kNVariables];
+    Double_t fraction[kNVariables];
+    for (Int_t v = 0, s = 1; v < kNVariables; s *= fNNodes[v], v++)
+    {
+        const Double_t u = (state[v] - fMin[v]) / (fMax[v] - fMin[v]) * (fNNodes[v] - 1);
+        if (!(u >= 0. && u <= fNNodes[v] - 1))
+        {
+            return kFALSE;
+        }
+        const Int_t index = std::min(static_cast<Int_t>(u), fNNodes[v] - 2);
+        fraction[v] = u - index;
+        stride[v] = s;
+        base += index * s;
+    }
+
+    std::fill(outputs, outputs + NOutputs, 0.);
+    for (Int_t corner = 0; corner < (1 << kNVariables); corner++)
+    {
+        Double_t weight = 1.;
+        Int_t node = base;
+        for (Int_t v = 0; v < kNVariables; v++)
+        {
+            if (corner & (1 << v))
+            {
+                weight *= fraction[v];
+                node += stride[v];
+            }
+            else
+            {
+                weight *= 1. - fraction[v];
+            }
+        }
+        if (weight == 0.)
+        {
+            continue;
+        }
+        const Float_t* values = &fData[static_cast<std::size_t>(node) * NOutputs];
+        for (Int_t o = 0; o < NOutputs; o++)
+        {
+            outputs[o] += weight * values[o];
+        }
+    }
+    return !std::isnan(outputs[0]);
+}
+
+Bool_t R3BTrajectoryTable::Propagate(R3BTrackingParticle* particle) const
+{
+    const TVector3 position(fPosition[0], fPosition[1], fPosition[2]);
+    const Double_t angle = fYAngle * TMath::DegToRad();
+    TVector3 local = particle->GetPosition() - position;
+    local.RotateY(-angle);
+    TVector3 direction = particle->GetMomentum();
+    direction.RotateY(-angle);
+
+    const Double_t mom = direction.Mag();
+    if (TMath::Abs(local.Z() - fZEntrance) > kPlaneTolerance || mom == 0. ||
+        (fBackward ? direction.Z() >= 0. : direction.Z() <= 0.))
+    {
+        return kFALSE;
+    }
+
+    Double_t state[kNVariables];
+    Double_t outputs[NOutputs];
+    ToState(direction, particle->GetCharge() / mom, local, state);
+    if (!Interpolate(state, outputs))
+    {
+        return kFALSE;
+    }
+
+    TVector3 exit(outputs[kX], outputs[kY], fZExit);
+    exit.RotateY(angle);
+    TVector3 exitDirection(outputs[kTx], outputs[kTy], 1.);
+    exitDirection.SetMag(fBackward ? -mom : mom);
+    exitDirection.RotateY(angle);
+    particle->SetPosition(exit + position);
+    particle->SetMomentum(exitDirection);
+    particle->AddStep(outputs[4]);
+    return kTRUE;
+}
+
+Bool_t R3BTrajectoryTable::IsValidFor(const R3BGladFieldMap& field) const
+{
+    return TMath::Abs(fPosition[0] - field.GetPositionX()) < kFieldTolerance &&
+           TMath::Abs(fPosition[1] - field.GetPositionY()) < kFieldTolerance &&
+           TMath::Abs(fPosition[2] - field.GetPositionZ()) < kFieldTolerance &&
+           TMath::Abs(fYAngle - field.GetYAngle()) < kFieldTolerance &&
+           TMath::Abs(fScale - field.GetScale()) < kFieldTolerance &&
+           TMath::Abs(fZEntrance - (fBackward ? field.GetZmax() : field.GetZmin())) < kFieldTolerance &&
+           TMath::Abs(fZExit - (fBackward ? field.GetZmin() : field.GetZmax())) < kFieldTolerance;
+}
+
+ClassImp(R3BTrajectoryTable)
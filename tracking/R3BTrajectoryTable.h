@@ -0,0 +1,125 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#ifndef R3BTRAJECTORYTABLE_H
+#define R3BTRAJECTORYTABLE_H 1
+
+#include "TObject.h"
+
+#include <functional>
+#include <vector>
+
+class R3BGladFieldMap;
+class R3BTPropagator;
+class R3BTrackingParticle;
+
+/**
+ * Transfer map of the GLAD field between the entrance and the exit plane of
+ * the field map, tabulated with the Runge-Kutta propagation of R3BTPropagator.
+ *
+ * The track state on a plane is given in the frame of the field map, i.e.
+ * rotated by its Y angle around its centre: position x, y [cm], slopes
+ * dx/dz, dy/dz and k = charge / momentum [e / (GeV/c)]. For each node of a
+ * grid in these five variables the table holds the state on the other plane
+ * and the track length, in between it is interpolated multilinearly. Since
+ * tracks are straight lines outside of the field, this gives the crossing
+ * with every detector plane behind the field. A table covers one direction,
+ * downstream from the entrance or upstream from the exit plane (backward).
+ *
+ * Generated once per field setting and written to a ROOT file:
+ *
+ *     auto table = R3BTrajectoryTable{ *field };
+ *     table.SetAxis(R3BTrajectoryTable::kX, 13, -30., 30.);
+ *     ...
+ *     table.Generate(propagator);
+ *     table.Write(R3BTrajectoryTable::ForwardName);
+ *
+ * R3BTPropagator::SetTrajectoryTables then replaces the Runge-Kutta
+ * integration through the field for all tracks inside the grid.
+ */
+class R3BTrajectoryTable : public TObject
+{
+  public:
+    enum Variable
+    {
+        kX,
+        kY,
+        kTx,
+        kTy,
+        kK,
+        kNVariables
+    };
+
+    // x, y, dx/dz, dy/dz on the exit plane and the track length
+    static constexpr Int_t NOutputs = 5;
+
+    static constexpr const char* ForwardName = "TrajectoryTableForward";
+    static constexpr const char* BackwardName = "TrajectoryTableBackward";
+
+    R3BTrajectoryTable();
+    explicit R3BTrajectoryTable(const R3BGladFieldMap& field, Bool_t backward = kFALSE);
+
+    /** Sets nNodes equidistant nodes from min to max, at least 2. */
+    void SetAxis(Variable variable, Int_t nNodes, Double_t min, Double_t max);
+
+    /** Fills the nodes with the Runge-Kutta propagation of the propagator, on nThreads threads (0: all cores). */
+    void Generate(const R3BTPropagator& propagator, UInt_t nThreads = 0);
+
+    /**
+     * Fills the nodes with any thread-safe transport from the state on the
+     * entrance plane to the outputs. Nodes for which it returns false are not
+     * used by Interpolate.
+     */
+    void Generate(const std::function<Bool_t(const Double_t* state, Double_t* outputs)>& transport,
+                  UInt_t nThreads = 0);
+
+    /** Interpolates the outputs, false outside of the grid or next to a failed node. */
+    Bool_t Interpolate(const Double_t* state, Double_t* outputs) const;
+
+    /**
+     * Moves a particle from the entrance to the exit plane. Returns false and
+     * leaves the particle unchanged if it is not on the entrance plane, does
+     * not move towards the exit plane or is outside of the grid.
+     */
+    Bool_t Propagate(R3BTrackingParticle* particle) const;
+
+    /** Whether the table was generated for the position, rotation and scale of the field. */
+    Bool_t IsValidFor(const R3BGladFieldMap& field) const;
+
+    Bool_t IsBackward() const { return fBackward; }
+    Bool_t IsGenerated() const { return !fData.empty(); }
+    Int_t GetNNodes() const;
+    Double_t GetZEntrance() const { return fZEntrance; }
+    Double_t GetZExit() const { return fZExit; }
+
+  private:
+    Bool_t fBackward;
+    Double_t fPosition[3]; // centre of the field in the lab [cm]
+    Double_t fYAngle;      // rotation of the field [deg]
+    Double_t fScale;       // scale of the field
+    Double_t fZEntrance;   // entrance plane in the frame of the field [cm]
+    Double_t fZExit;       // exit plane in the frame of the field [cm]
+    Int_t fNNodes[kNVariables];
+    Double_t fMin[kNVariables];
+    Double_t fMax[kNVariables];
+    std::vector<Float_t> fData; // NOutputs per node, kX fastest, NaN for failed nodes
+
+    void GetNode(Int_t node, Double_t* state) const;
+    void Fill(const std::function<Bool_t(UInt_t thread, const Double_t* state, Double_t* outputs)>& transport,
+              UInt_t nThreads);
+
+    ClassDef(R3BTrajectoryTable, 1)
+};
+
+#endif /* R3BTRAJECTORYTABLE_H */
@@ -0,0 +1,167 @@
+#include "R3BMDFEvaluator.h"
+#include "R3BMDFWrapper.h"
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    auto SplitNames(const std::string& list) -> std::vector<std::string>
+    {
+        auto names = std::vector<std::string>{};
+        auto stream = std::istringstream{ list };
+        for (auto item = std::string{}; std::getline(stream, item, ',');)
+        {
+            names.push_back(item);
+        }
+        return names;
+    }
+
+    // Writes a random MDF parameter file in the format read by R3BMDFWrapper::InitMDF()
+    auto WriteMDFFile(const std::string& name, int nVariables, int nCoefficients, int polyType, std::mt19937& rng)
+        -> std::string
+    {
+        auto coefficient = std::uniform_real_distribution<double>(-1., 1.);
+        auto power = std::uniform_int_distribution<int>(1, 5);
+        auto file = std::ofstream(name);
+        file.precision(17);
+        file << nVariables << " " << nCoefficients << " " << nCoefficients << " " << coefficient(rng) << " "
+             << polyType << "\n";
+        for (int var = 0; var < nVariables; var++)
+        {
+            file << 0.1 * var << " ";
+        }
+        for (int var = 0; var < nVariables; var++)
+        {
+            file << -10. - var << " ";
+        }
+        for (int var = 0; var < nVariables; var++)
+        {
+            file << 10. + 2 * var << " ";
+        }
+        for (int coef = 0; coef < 2 * nCoefficients; coef++)
+        {
+            file << coefficient(rng) << " ";
+        }
+        for (int idx = 0; idx < nCoefficients * nVariables; idx++)
+        {
+            file << power(rng) << " ";
+        }
+        return name;
+    }
+} // namespace
+
+// Time per event of the MDF functions of the fragment tracking, evaluated one by one with R3BMDFWrapper::MDF
+// and together with R3BMDFEvaluator::EvaluateBatch, either for given MDF files or for random ones.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of the MDF evaluation" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("files",
+                       po::value<std::string>()->default_value(""),
+                       "use these comma separated MDF files instead of random ones");
+    desc.add_options()("functions", po::value<int>()->default_value(6), "set number of random functions");
+    desc.add_options()("variables", po::value<int>()->default_value(8), "set number of variables of random functions");
+    desc.add_options()("coefficients",
+                       po::value<int>()->default_value(150),
+                       "set number of coefficients of random functions");
+    desc.add_options()("polyType",
+                       po::value<int>()->default_value(1),
+                       "set polynomial type of random functions (0: monomials, 1: Chebyshev, 2: Legendre)");
+    desc.add_options()("eventNum,n", po::value<int>()->default_value(20000), "set number of events");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "mdfEvaluatorBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto fileList = varMap["files"].as<std::string>();
+    const auto functionNum = varMap["functions"].as<int>();
+    const auto variableNum = varMap["variables"].as<int>();
+    const auto coefficientNum = varMap["coefficients"].as<int>();
+    const auto polyType = varMap["polyType"].as<int>();
+    const auto eventNum = static_cast<std::size_t>(varMap["eventNum"].as<int>());
+
+    auto rng = std::mt19937{ 42 };
+    auto wrappers = std::vector<std::unique_ptr<R3BMDFWrapper>>{};
+    auto evaluator = R3BMDFEvaluator{};
+    if (fileList.empty())
+    {
+        for (int func = 0; func < functionNum; func++)
+        {
+            const auto fileName = WriteMDFFile(
+                fmt::format("mdfEvaluatorBench_{}.txt", func), variableNum, coefficientNum, polyType, rng);
+            wrappers.push_back(std::make_unique<R3BMDFWrapper>(fileName.c_str()));
+            std::remove(fileName.c_str());
+        }
+    }
+    else
+    {
+        for (const auto& fileName : SplitNames(fileList))
+        {
+            wrappers.push_back(std::make_unique<R3BMDFWrapper>(fileName.c_str()));
+        }
+    }
+    for (const auto& wrapper : wrappers)
+    {
+        evaluator.AddFunction(*wrapper);
+    }
+    const auto nFunctions = wrappers.size();
+    const auto nVariables = evaluator.GetNVariables();
+
+    auto dist = std::uniform_real_distribution<double>(-10., 10.);
+    auto inputs = std::vector<double>(eventNum * nVariables);
+    for (auto& value : inputs)
+    {
+        value = dist(rng);
+    }
+    auto outputs = std::vector<double>(eventNum * nFunctions);
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t event = 0; event < eventNum; event++)
+    {
+        for (std::size_t func = 0; func < nFunctions; func++)
+        {
+            outputs[event * nFunctions + func] = wrappers[func]->MDF(&inputs[event * nVariables]);
+        }
+    }
+    const auto wrapperTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    const auto wrapperSum = std::accumulate(outputs.cbegin(), outputs.cend(), 0.);
+
+    start = std::chrono::steady_clock::now();
+    evaluator.EvaluateBatch(inputs.data(), eventNum, outputs.data());
+    const auto batchTime = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+    if (std::accumulate(outputs.cbegin(), outputs.cend(), 0.) != wrapperSum)
+    {
+        std::cerr << "mdfEvaluatorBench: The evaluator gives different values than the wrappers" << std::endl;
+        return EXIT_FAILURE;
+    }
+    fmt::print("{} functions of {} variables, {} basis values\n", nFunctions, nVariables, evaluator.GetNBasisValues());
+    fmt::print("{:<32} {:>10.1f} ns/event\n", "R3BMDFWrapper::MDF", wrapperTime.count() / eventNum);
+    fmt::print("{:<32} {:>10.1f} ns/event\n", "R3BMDFEvaluator::EvaluateBatch", batchTime.count() / eventNum);
+    return 0;
+}
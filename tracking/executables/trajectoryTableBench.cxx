@@ -0,0 +1,386 @@
+#include "R3BGladFieldMap.h"
+#include "R3BShared.h"
+#include "R3BTPropagator.h"
+#include "R3BTrackingParticle.h"
+#include "R3BTrajectoryTable.h"
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TVector3.h"
+#include <algorithm>
+#include <array>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cmath>
+#include <fmt/format.h>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    using Table = R3BTrajectoryTable;
+
+    auto SplitNodes(const std::string& list) -> std::vector<int>
+    {
+        auto nodes = std::vector<int>{};
+        auto stream = std::istringstream{ list };
+        for (auto item = std::string{}; std::getline(stream, item, ',');)
+        {
+            nodes.push_back(std::stoi(item));
+        }
+        return nodes;
+    }
+
+    // Frame of the field: rotated by its Y angle around its centre
+    class FieldFrame
+    {
+      public:
+        explicit FieldFrame(const R3BGladFieldMap& field)
+            : fPosition(field.GetPositionX(), field.GetPositionY(), field.GetPositionZ())
+            , fAngle(field.GetYAngle() * TMath::DegToRad())
+        {
+        }
+
+        [[nodiscard]] auto ToGlobal(TVector3 vector, bool isPoint = true) const -> TVector3
+        {
+            vector.RotateY(fAngle);
+            return isPoint ? vector + fPosition : vector;
+        }
+
+        [[nodiscard]] auto ToLocal(TVector3 vector, bool isPoint = true) const -> TVector3
+        {
+            if (isPoint)
+            {
+                vector -= fPosition;
+            }
+            vector.RotateY(-fAngle);
+            return vector;
+        }
+
+        // Three points of the plane at z in the frame of the field
+        [[nodiscard]] auto Plane(double z) const -> std::array<TVector3, 3>
+        {
+            return { ToGlobal(TVector3(0., 0., z)), ToGlobal(TVector3(1., 0., z)), ToGlobal(TVector3(0., 1., z)) };
+        }
+
+        // x, y, dx/dz, dy/dz and charge / momentum of a particle on a plane of the field frame
+        [[nodiscard]] auto State(const R3BTrackingParticle& particle) const -> std::array<double, Table::kNVariables>
+        {
+            const auto position = ToLocal(particle.GetPosition());
+            const auto direction = ToLocal(particle.GetMomentum(), false);
+            return { position.X(),
+                     position.Y(),
+                     direction.X() / direction.Z(),
+                     direction.Y() / direction.Z(),
+                     particle.GetCharge() / particle.GetMomentum().Mag() };
+        }
+
+      private:
+        TVector3 fPosition;
+        double fAngle;
+    };
+
+    // Moves the particle along a straight line onto the plane, forwards or backwards
+    void MoveToPlane(R3BTPropagator& propagator, R3BTrackingParticle& particle, const std::array<TVector3, 3>& plane)
+    {
+        const auto normal = ((plane[1] - plane[0]).Cross(plane[2] - plane[0])).Unit();
+        auto intersect = TVector3{};
+        const auto& position = particle.GetPosition();
+        if (propagator.LineIntersectPlane(position, particle.GetMomentum(), plane[0], normal, intersect) ||
+            propagator.LineIntersectPlane(position, -1. * particle.GetMomentum(), plane[0], normal, intersect))
+        {
+            particle.SetPosition(intersect);
+        }
+    }
+
+    // Grid over the range of the states, with a margin of 5 % on each side
+    void SetAxes(Table& table,
+                 const std::vector<std::array<double, Table::kNVariables>>& states,
+                 const std::vector<int>& nodes)
+    {
+        for (int var = 0; var < Table::kNVariables; ++var)
+        {
+            auto [min, max] = std::minmax_element(
+                states.begin(), states.end(), [var](const auto& lhs, const auto& rhs) { return lhs[var] < rhs[var]; });
+            const auto margin = std::max(0.05 * ((*max)[var] - (*min)[var]), 1e-3);
+            table.SetAxis(static_cast<Table::Variable>(var), nodes[var], (*min)[var] - margin, (*max)[var] + margin);
+        }
+    }
+
+    struct Residuals
+    {
+        std::array<double, 4> sum{};
+        std::array<double, 4> sum2{};
+        std::array<double, 4> max{};
+        int64_t entries = 0;
+
+        void Add(const std::array<double, Table::kNVariables>& reference,
+                 const std::array<double, Table::kNVariables>& state)
+        {
+            for (std::size_t idx = 0; idx < sum.size(); ++idx)
+            {
+                const auto delta = state[idx] - reference[idx];
+                sum[idx] += delta;
+                sum2[idx] += delta * delta;
+                max[idx] = std::max(max[idx], std::abs(delta));
+            }
+            ++entries;
+        }
+
+        void Print(std::string_view name) const
+        {
+            static constexpr auto labels = std::array{ "x [cm]", "y [cm]", "dx/dz", "dy/dz" };
+            fmt::print("{0}, {1} tracks\n", name, entries);
+            for (std::size_t idx = 0; idx < sum.size(); ++idx)
+            {
+                const auto mean = entries > 0 ? sum[idx] / static_cast<double>(entries) : 0.;
+                const auto rms = entries > 0 ? std::sqrt(sum2[idx] / static_cast<double>(entries)) : 0.;
+                fmt::print(
+                    "  {0:<8} mean {1:>11.3e} rms {2:>11.3e} max {3:>11.3e}\n", labels[idx], mean, rms, max[idx]);
+            }
+        }
+    };
+
+    void PrintTime(std::string_view name, int64_t nTracks, double seconds)
+    {
+        fmt::print("{0:<28} {1:>10.3f} s {2:>10.2f} us/track\n",
+                   name,
+                   seconds,
+                   1e6 * seconds / static_cast<double>(std::max<int64_t>(nTracks, 1)));
+    }
+} // namespace
+
+// Compares the propagation of fragments through the GLAD field with Runge-Kutta and with R3BTrajectoryTable.
+// Tracks start at the target, the residuals are taken on the exit plane of the field and on a detector plane
+// behind it, and for the backward propagation on the target plane. The tables are generated over the range
+// of the simulated tracks and written to a file, which can be given to R3BFragmentTracker::SetTrajectoryTableFile.
+auto main(int argc, const char** argv) -> int
+{
+    namespace po = boost::program_options;
+    auto desc = po::options_description{ "options for the benchmark of trajectory tables" };
+    desc.add_options()("help,h", "help message");
+    desc.add_options()("fieldMap",
+                       po::value<std::string>()->default_value("R3BGladMap"),
+                       "set the name of the GLAD field map");
+    desc.add_options()("fieldType",
+                       po::value<std::string>()->default_value("R"),
+                       "set the type of the map file (A, R or B)");
+    desc.add_options()("scale", po::value<double>()->default_value(-0.6), "set the scale of the field");
+    desc.add_options()("nodes",
+                       po::value<std::string>()->default_value("13,5,9,3,13"),
+                       "set comma separated number of nodes in x, y, dx/dz, dy/dz and charge/momentum");
+    desc.add_options()("kMin", po::value<double>()->default_value(0.15), "set minimal charge/momentum in e/(GeV/c)");
+    desc.add_options()("kMax", po::value<double>()->default_value(0.45), "set maximal charge/momentum in e/(GeV/c)");
+    desc.add_options()("angle",
+                       po::value<double>()->default_value(0.03),
+                       "set maximal angle of the tracks at the target");
+    desc.add_options()("distance",
+                       po::value<double>()->default_value(400.),
+                       "set distance of the detector plane behind the field");
+    desc.add_options()("tracks,n", po::value<int>()->default_value(10000), "set number of tracks");
+    desc.add_options()("threads,t", po::value<int>()->default_value(0), "set number of threads (0: all cores)");
+    desc.add_options()("inputFile",
+                       po::value<std::string>()->default_value(""),
+                       "read the tables from this file instead");
+    desc.add_options()("outputFile",
+                       po::value<std::string>()->default_value("trajectoryTables.root"),
+                       "set the filename of the tables");
+
+    auto varMap = po::variables_map{};
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), varMap);
+        po::notify(varMap);
+    }
+    catch (const po::error& err)
+    {
+        std::cerr << "trajectoryTableBench: " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (varMap.count("help") != 0U)
+    {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    const auto mapName = varMap["fieldMap"].as<std::string>();
+    const auto mapType = varMap["fieldType"].as<std::string>();
+    const auto scale = varMap["scale"].as<double>();
+    const auto nodeList = varMap["nodes"].as<std::string>();
+    const auto kMin = varMap["kMin"].as<double>();
+    const auto kMax = varMap["kMax"].as<double>();
+    const auto angle = varMap["angle"].as<double>();
+    const auto distance = varMap["distance"].as<double>();
+    const auto trackNum = varMap["tracks"].as<int>();
+    const auto threadNum = varMap["threads"].as<int>();
+    const auto inputFileName = varMap["inputFile"].as<std::string>();
+    const auto outputFileName = varMap["outputFile"].as<std::string>();
+
+    const auto nodes = SplitNodes(nodeList);
+    if (nodes.size() != Table::kNVariables)
+    {
+        std::cerr << "trajectoryTableBench: Need " << Table::kNVariables << " numbers of nodes" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto field = R3BGladFieldMap(mapName.c_str(), mapType.c_str());
+    field.SetScale(scale);
+    field.Init();
+    const auto frame = FieldFrame{ field };
+    const auto entrance = frame.Plane(field.GetZmin());
+    const auto exit = frame.Plane(field.GetZmax());
+    const auto detector = frame.Plane(field.GetZmax() + distance);
+    const auto target = std::array{ TVector3(0., 0., 0.), TVector3(1., 0., 0.), TVector3(0., 1., 0.) };
+
+    auto rk = R3BTPropagator(&field);
+    auto rnd = TRandom3{ 1 };
+    auto tracks = std::vector<R3BTrackingParticle>{};
+    for (int idx = 0; idx < trackNum; ++idx)
+    {
+        const auto theta = angle * std::sqrt(rnd.Rndm());
+        const auto phi = TMath::TwoPi() * rnd.Rndm();
+        const auto momentum = 1. / (kMin + (kMax - kMin) * rnd.Rndm());
+        const auto direction =
+            TVector3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta)) * momentum;
+        tracks.emplace_back(
+            1., rnd.Gaus(0., 0.2), rnd.Gaus(0., 0.2), 0., direction.X(), direction.Y(), direction.Z(), 0., 0.);
+    }
+
+    // Runge-Kutta, also the reference for the residuals and the ranges of the tables
+    auto rkDetector = tracks;
+    auto rkForwardOk = std::vector<bool>(tracks.size());
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        rkForwardOk[idx] = rk.PropagateToPlane(&rkDetector[idx], detector[0], detector[1], detector[2]);
+    }
+    const auto rkForward = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Backward from the detector plane, with reversed momentum and charge as in R3BFragmentFitterChi2
+    auto reversed = std::vector<R3BTrackingParticle>{};
+    for (const auto& particle : rkDetector)
+    {
+        const auto momentum = -1. * particle.GetMomentum();
+        reversed.emplace_back(-particle.GetCharge(),
+                              particle.GetX(),
+                              particle.GetY(),
+                              particle.GetZ(),
+                              momentum.X(),
+                              momentum.Y(),
+                              momentum.Z(),
+                              0.,
+                              0.);
+    }
+    auto rkTarget = reversed;
+    auto rkBackwardOk = std::vector<bool>(tracks.size());
+    start = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        rkBackwardOk[idx] = rk.PropagateToPlaneBackward(&rkTarget[idx], target[0], target[1], target[2]);
+    }
+    const auto rkBackward = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // States of the tracks on the planes where the tables start
+    auto entranceStates = std::vector<std::array<double, Table::kNVariables>>{};
+    auto exitStates = std::vector<std::array<double, Table::kNVariables>>{};
+    auto rkExit = rkDetector;
+    for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        auto particle = tracks[idx];
+        MoveToPlane(rk, particle, entrance);
+        entranceStates.push_back(frame.State(particle));
+        MoveToPlane(rk, rkExit[idx], exit);
+        particle = reversed[idx];
+        MoveToPlane(rk, particle, exit);
+        exitStates.push_back(frame.State(particle));
+    }
+
+    auto forward = std::unique_ptr<Table>{};
+    auto backward = std::unique_ptr<Table>{};
+    if (!inputFileName.empty())
+    {
+        auto inputFile = R3B::make_rootfile(inputFileName.c_str(), "READ");
+        forward.reset(inputFile->Get<Table>(Table::ForwardName));
+        backward.reset(inputFile->Get<Table>(Table::BackwardName));
+        if (!forward || !backward || !forward->IsValidFor(field) || !backward->IsValidFor(field))
+        {
+            std::cerr << "trajectoryTableBench: No tables for this field in " << inputFileName << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        forward = std::make_unique<Table>(field);
+        backward = std::make_unique<Table>(field, kTRUE);
+        SetAxes(*forward, entranceStates, nodes);
+        SetAxes(*backward, exitStates, nodes);
+        start = std::chrono::steady_clock::now();
+        forward->Generate(rk, static_cast<UInt_t>(threadNum));
+        backward->Generate(rk, static_cast<UInt_t>(threadNum));
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print("generated {0} + {1} nodes in {2:.1f} s\n", forward->GetNNodes(), backward->GetNNodes(), seconds);
+
+        auto outputFile = R3B::make_rootfile(outputFileName.c_str(), "RECREATE");
+        forward->Write(Table::ForwardName);
+        backward->Write(Table::BackwardName);
+        fmt::print("written to {}\n", outputFileName);
+    }
+
+    auto lut = R3BTPropagator(&field);
+    lut.SetTrajectoryTables(forward.get(), backward.get());
+
+    auto lutDetector = tracks;
+    auto lutForwardOk = std::vector<bool>(tracks.size());
+    start = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        lutForwardOk[idx] = lut.PropagateToPlane(&lutDetector[idx], detector[0], detector[1], detector[2]);
+    }
+    const auto lutForward = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto lutTarget = reversed;
+    auto lutBackwardOk = std::vector<bool>(tracks.size());
+    start = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        lutBackwardOk[idx] = lut.PropagateToPlaneBackward(&lutTarget[idx], target[0], target[1], target[2]);
+    }
+    const auto lutBackward = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto exitResiduals = Residuals{};
+    auto detectorResiduals = Residuals{};
+    auto targetResiduals = Residuals{};
+    auto nOutsideForward = int64_t{};
+    auto nOutsideBackward = int64_t{};
+    auto outputs = std::array<double, Table::NOutputs>{};
+    for (std::size_t idx = 0; idx < tracks.size(); ++idx)
+    {
+        nOutsideForward += forward->Interpolate(entranceStates[idx].data(), outputs.data()) ? 0 : 1;
+        nOutsideBackward += backward->Interpolate(exitStates[idx].data(), outputs.data()) ? 0 : 1;
+        if (rkForwardOk[idx] && lutForwardOk[idx])
+        {
+            detectorResiduals.Add(frame.State(rkDetector[idx]), frame.State(lutDetector[idx]));
+            MoveToPlane(lut, lutDetector[idx], exit);
+            exitResiduals.Add(frame.State(rkExit[idx]), frame.State(lutDetector[idx]));
+        }
+        if (rkBackwardOk[idx] && lutBackwardOk[idx])
+        {
+            targetResiduals.Add(frame.State(rkTarget[idx]), frame.State(lutTarget[idx]));
+        }
+    }
+
+    const auto nTracks = static_cast<int64_t>(tracks.size());
+    fmt::print("\n{0} tracks, outside of the tables (Runge-Kutta): {1} forward, {2} backward\n\n",
+               nTracks,
+               nOutsideForward,
+               nOutsideBackward);
+    PrintTime("forward, Runge-Kutta", nTracks, rkForward);
+    PrintTime("forward, table", nTracks, lutForward);
+    PrintTime("backward, Runge-Kutta", nTracks, rkBackward);
+    PrintTime("backward, table", nTracks, lutBackward);
+    fmt::print("speedup forward {0:.1f}, backward {1:.1f}\n\n", rkForward / lutForward, rkBackward / lutBackward);
+    exitResiduals.Print("table - Runge-Kutta at the exit of the field");
+    detectorResiduals.Print(fmt::format("table - Runge-Kutta at {} cm behind the field", distance));
+    targetResiduals.Print("table - Runge-Kutta backward at the target");
+    return 0;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BFieldGrid.h"
+#include "R3BFieldMapFile.h"
+#include "R3BFragmentFitterChi2.h"
+#include "R3BGladFieldMap.h"
+#include "R3BHit.h"
+#include "R3BTGeoPar.h"
+#include "R3BTPropagator.h"
+#include "R3BTrackingDetector.h"
+#include "R3BTrackingParticle.h"
+#include "R3BTrackingSetup.h"
+#include "TVector3.h"
+#include "gtest/gtest.h"
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr auto AMU = 0.938272;
+    constexpr auto CHARGE = 50.;
+    constexpr auto BETA = 0.8;
+
+    // Uniform field of 1 T in y between z = 100 cm and z = 300 cm, mapped from a binary field map
+    class testFragmentFitterChi2 : public ::testing::Test
+    {
+      protected:
+        std::filesystem::path work_dir_ = std::filesystem::temp_directory_path() / "testFragmentFitterChi2";
+        std::unique_ptr<R3BGladFieldMap> field_;
+        std::vector<std::unique_ptr<R3BTGeoPar>> geo_pars_;
+        std::vector<std::unique_ptr<R3BHit>> hits_;
+        R3BTrackingSetup setup_;
+
+        void SetUp() override
+        {
+            const auto map_dir = work_dir_ / "field" / "magField" / "R3B";
+            std::filesystem::create_directories(map_dir);
+            const double min[3] = { -150., -50., 100. };
+            const double max[3] = { 150., 50., 300. };
+            const double step[3] = { 10., 10., 10. };
+            auto grid = R3BFieldGrid{};
+            grid.init(31, 11, 21, min, max, step);
+            for (int ix = 0; ix < 31; ix++)
+                for (int iy = 0; iy < 11; iy++)
+                    for (int iz = 0; iz < 21; iz++)
+                        grid.set_node(ix, iy, iz, 0., 1., 0.);
+            R3BFieldMapFile::write((map_dir / "testFragmentFitterChi2.fmap").string(), grid);
+
+            setenv("VMCWORKDIR", work_dir_.c_str(), 1);
+            field_ = std::make_unique<R3BGladFieldMap>("testFragmentFitterChi2", "B");
+            field_->Init();
+
+            AddDetector("target", kTarget, 0., 0.1);
+            AddDetector("fi4", kAfterGlad, 500., 0.02);
+            AddDetector("fi5", kAfterGlad, 600., 0.02);
+            AddDetector("fi6", kAfterGlad, 700., 0.02);
+            AddDetector("tofd", kTof, 800., 1.);
+        }
+
+        void TearDown() override { std::filesystem::remove_all(work_dir_); }
+
+        void AddDetector(const std::string& name, EDetectorType type, double posZ, double sigmaX)
+        {
+            auto& geo_par = geo_pars_.emplace_back(std::make_unique<R3BTGeoPar>(name.c_str()));
+            geo_par->SetPosXYZ(0., 0., posZ);
+            geo_par->SetRotXYZ(0., 0., 0.);
+            geo_par->SetDimXYZ(300., 100., 0.1);
+            geo_par->SetSigmaXY(sigmaX, sigmaX);
+            setup_.AddDetector(name, type, name);
+            auto* detector = setup_.GetByName(name);
+            detector->fGeo = geo_par.get();
+            detector->Init();
+        }
+
+        // Hits of fragments of different masses and directions, which are propagated from the target through the
+        // setup. Every fragment has its own hits.
+        void AddHits(R3BTPropagator& propagator, std::size_t size)
+        {
+            auto engine = std::mt19937{ 1 };
+            auto mass = std::uniform_real_distribution<double>{ 127., 132. };
+            auto angle = std::uniform_real_distribution<double>{ -0.01, 0.01 };
+            const auto momentum_factor = BETA / std::sqrt(1. - BETA * BETA);
+            for (std::size_t fragment = 0; fragment < size; fragment++)
+            {
+                const auto fragment_mass = mass(engine) * AMU;
+                auto direction = TVector3(angle(engine), angle(engine), 1.).Unit() * fragment_mass * momentum_factor;
+                auto particle = R3BTrackingParticle(
+                    CHARGE, 0., 0., 0., direction.X(), direction.Y(), direction.Z(), BETA, fragment_mass);
+                for (auto* detector : setup_.GetArray())
+                {
+                    if (kTarget != detector->section)
+                    {
+                        propagator.PropagateToDetector(&particle, detector);
+                    }
+                    auto x_local = 0.;
+                    auto y_local = 0.;
+                    detector->GlobalToLocal(particle.GetPosition(), x_local, y_local);
+                    auto& hit = hits_.emplace_back(std::make_unique<R3BHit>(0, x_local, y_local, 0., 0.));
+                    detector->hits.push_back(hit.get());
+                }
+            }
+        }
+
+        // Candidates as built by R3BFragmentTracker, starting from the nominal mass
+        [[nodiscard]] auto MakeCandidates(std::size_t size) const -> std::vector<std::unique_ptr<R3BTrackingParticle>>
+        {
+            auto candidates = std::vector<std::unique_ptr<R3BTrackingParticle>>{};
+            for (std::size_t fragment = 0; fragment < size; fragment++)
+            {
+                auto& candidate = candidates.emplace_back(
+                    std::make_unique<R3BTrackingParticle>(CHARGE, 0., 0., 0., 0., 0., 0., BETA, 132. * AMU));
+                for (const auto* detector : setup_.GetArray())
+                {
+                    candidate->AddHit(detector->GetDetectorName().Data(), static_cast<Int_t>(fragment));
+                }
+            }
+            return candidates;
+        }
+
+        auto Fit(UInt_t nThreads, std::vector<std::unique_ptr<R3BTrackingParticle>>& candidates) -> std::vector<Int_t>
+        {
+            auto propagator = R3BTPropagator(field_.get());
+            auto fitter = R3BFragmentFitterChi2{};
+            fitter.SetNThreads(nThreads);
+            fitter.Init(&propagator, kFALSE);
+            auto particles = std::vector<R3BTrackingParticle*>{};
+            for (auto& candidate : candidates)
+            {
+                particles.push_back(candidate.get());
+            }
+            return fitter.FitTracksBackward2D(particles, &setup_);
+        }
+    };
+
+    TEST_F(testFragmentFitterChi2, threads_identical)
+    {
+        constexpr auto size = std::size_t{ 16 };
+        auto propagator = R3BTPropagator(field_.get());
+        AddHits(propagator, size);
+
+        auto serial = MakeCandidates(size);
+        auto threaded = MakeCandidates(size);
+        const auto serial_status = Fit(1, serial);
+        const auto threaded_status = Fit(4, threaded);
+
+        ASSERT_EQ(serial_status.size(), size);
+        EXPECT_EQ(serial_status, threaded_status);
+        for (std::size_t fragment = 0; fragment < size; fragment++)
+        {
+            EXPECT_EQ(serial[fragment]->GetMass(), threaded[fragment]->GetMass());
+            EXPECT_EQ(serial[fragment]->GetChi2(), threaded[fragment]->GetChi2());
+            EXPECT_EQ(serial[fragment]->GetMomentum(), threaded[fragment]->GetMomentum());
+            EXPECT_EQ(serial[fragment]->GetPosition(), threaded[fragment]->GetPosition());
+        }
+    }
+} // namespace
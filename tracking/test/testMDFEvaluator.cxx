@@ -0,0 +1,122 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+
+#include "R3BMDFEvaluator.h"
+#include "R3BMDFWrapper.h"
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int NVariables = 8;
+
+    // Writes a random MDF parameter file in the format read by R3BMDFWrapper::InitMDF()
+    std::string WriteMDFFile(const std::string& name, int nCoefficients, int polyType, int maxPower, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<double> coefficient(-1., 1.);
+        std::uniform_int_distribution<int> power(1, maxPower);
+        const auto filename = ::testing::TempDir() + name;
+        std::ofstream file(filename);
+        file.precision(17);
+        file << NVariables << " " << nCoefficients << " " << nCoefficients << " " << coefficient(rng) << " "
+             << polyType << "\n";
+        for (int var = 0; var < NVariables; var++)
+        {
+            file << 0.1 * var << " ";
+        }
+        for (int var = 0; var < NVariables; var++)
+        {
+            file << -10. - var << " ";
+        }
+        for (int var = 0; var < NVariables; var++)
+        {
+            file << 10. + 2 * var << " ";
+        }
+        for (int coef = 0; coef < 2 * nCoefficients; coef++)
+        {
+            file << coefficient(rng) << " ";
+        }
+        for (int idx = 0; idx < nCoefficients * NVariables; idx++)
+        {
+            file << power(rng) << " ";
+        }
+        return filename;
+    }
+
+    std::vector<double> RandomInputs(size_t nEvents, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<double> dist(-10., 10.);
+        std::vector<double> x(nEvents * NVariables);
+        for (auto& value : x)
+        {
+            value = dist(rng);
+        }
+        return x;
+    }
+
+    class MDFEvaluatorTest : public ::testing::TestWithParam<int>
+    {
+    };
+
+    TEST_P(MDFEvaluatorTest, identical_to_wrapper)
+    {
+        std::mt19937 rng(GetParam());
+        std::vector<std::unique_ptr<R3BMDFWrapper>> wrappers;
+        R3BMDFEvaluator evaluator;
+        for (int func = 0; func < 6; func++)
+        {
+            const auto filename =
+                WriteMDFFile("mdf_" + std::to_string(GetParam()) + "_" + std::to_string(func) + ".txt",
+                             40,
+                             GetParam(),
+                             6,
+                             rng);
+            wrappers.push_back(std::make_unique<R3BMDFWrapper>(filename.c_str()));
+            EXPECT_EQ(evaluator.AddFunction(*wrappers.back()), func);
+            std::remove(filename.c_str());
+        }
+        ASSERT_EQ(evaluator.GetNFunctions(), 6);
+        ASSERT_EQ(evaluator.GetNVariables(), NVariables);
+
+        constexpr size_t nEvents = 100;
+        auto x = RandomInputs(nEvents, rng);
+        std::vector<double> batch(nEvents * 6);
+        evaluator.EvaluateBatch(x.data(), nEvents, batch.data());
+        std::vector<double> single(nEvents);
+        evaluator.EvaluateBatch(2, x.data(), nEvents, single.data());
+
+        for (size_t event = 0; event < nEvents; event++)
+        {
+            double* input = &x[event * NVariables];
+            std::vector<double> all(6);
+            evaluator.Evaluate(input, all.data());
+            for (size_t func = 0; func < 6; func++)
+            {
+                const auto expected = wrappers[func]->MDF(input);
+                EXPECT_EQ(all[func], expected);
+                EXPECT_EQ(batch[event * 6 + func], expected);
+                EXPECT_EQ(evaluator.Evaluate(func, input), expected);
+            }
+            EXPECT_EQ(single[event], batch[event * 6 + 2]);
+        }
+    }
+
+    // kMonomials, kChebyshev, kLegendre
+    INSTANTIATE_TEST_SUITE_P(PolyTypes, MDFEvaluatorTest, ::testing::Values(0, 1, 2));
+} // namespace
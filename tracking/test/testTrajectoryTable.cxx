@@ -0,0 +1,194 @@
+/******************************************************************************
+ *   Copyright (C) 2019 GSI Helmholtzzentrum für Schwerionenforschung GmbH    *
+ *   Copyright (C) 2019-2024 Members of R3B Collaboration                     *
+ *                                                                            *
+ *             This software is distributed under the terms of the            *
+ *                 GNU General Public Licence (GPL) version 3,                *
+ *                    copied verbatim in the file "LICENSE".                  *
+ *                                                                            *
+ * In applying this license GSI does not waive the privileges and immunities  *
+ * granted to it by virtue of its status as an Intergovernmental Organization *
+ * or submit itself to any jurisdiction.                                      *
+ ******************************************************************************/
+
+#include "R3BException.h"
+#include "R3BTrajectoryTable.h"
+#include "TMemFile.h"
+#include "gtest/gtest.h"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+
+namespace
+{
+    using Table = R3BTrajectoryTable;
+
+    void SetAxes(Table& table)
+    {
+        table.SetAxis(Table::kX, 7, -30., 30.);
+        table.SetAxis(Table::kY, 5, -10., 10.);
+        table.SetAxis(Table::kTx, 6, 0.15, 0.35);
+        table.SetAxis(Table::kTy, 3, -0.05, 0.05);
+        table.SetAxis(Table::kK, 9, 0.15, 0.45);
+    }
+
+    // Multilinear in the state, reproduced exactly by the interpolation
+    Bool_t Multilinear(const Double_t* in, Double_t* out)
+    {
+        out[0] = in[0] + 200. * in[2] - 300. * in[4] + 0.5 * in[0] * in[4];
+        out[1] = in[1] + 200. * in[3] + in[1] * in[2] * in[4];
+        out[2] = in[2] - 0.8 * in[4];
+        out[3] = in[3] * (1. + in[4]);
+        out[4] = 300. + 0.01 * in[0] * in[1] + 5. * in[4];
+        return kTRUE;
+    }
+
+    // Bending in a uniform field of 200 cm: smooth, but not linear in k and tx
+    Bool_t Bending(const Double_t* in, Double_t* out)
+    {
+        const Double_t angle = std::atan(in[2]) - 0.6 * in[4];
+        out[0] = in[0] + 200. * (std::sin(std::atan(in[2])) + std::sin(0.6 * in[4]));
+        out[1] = in[1] + 200. * in[3];
+        out[2] = std::tan(angle);
+        out[3] = in[3];
+        out[4] = 200. / std::cos(angle);
+        return kTRUE;
+    }
+
+    std::vector<std::array<Double_t, Table::kNVariables>> RandomStates(std::size_t size)
+    {
+        auto engine = std::mt19937{ 1 };
+        auto uniform = std::uniform_real_distribution<Double_t>{ 0., 1. };
+        auto states = std::vector<std::array<Double_t, Table::kNVariables>>(size);
+        for (auto& state : states)
+        {
+            state = { -30. + 60. * uniform(engine),
+                      -10. + 20. * uniform(engine),
+                      0.15 + 0.2 * uniform(engine),
+                      -0.05 + 0.1 * uniform(engine),
+                      0.15 + 0.3 * uniform(engine) };
+        }
+        return states;
+    }
+
+    TEST(testTrajectoryTable, axes_required)
+    {
+        auto table = Table{};
+        table.SetAxis(Table::kX, 7, -30., 30.);
+        EXPECT_THROW(table.Generate(Multilinear, 1), R3B::runtime_error);
+        EXPECT_THROW(table.SetAxis(Table::kY, 1, -10., 10.), R3B::runtime_error);
+        EXPECT_THROW(table.SetAxis(Table::kY, 5, 10., -10.), R3B::runtime_error);
+        EXPECT_FALSE(table.IsGenerated());
+    }
+
+    TEST(testTrajectoryTable, multilinear_exact)
+    {
+        auto table = Table{};
+        SetAxes(table);
+        table.Generate(Multilinear, 1);
+        ASSERT_TRUE(table.IsGenerated());
+        EXPECT_EQ(table.GetNNodes(), 7 * 5 * 6 * 3 * 9);
+
+        Double_t expected[Table::NOutputs];
+        Double_t outputs[Table::NOutputs];
+        for (const auto& state : RandomStates(1000))
+        {
+            Multilinear(state.data(), expected);
+            ASSERT_TRUE(table.Interpolate(state.data(), outputs));
+            for (Int_t o = 0; o < Table::NOutputs; o++)
+            {
+                EXPECT_NEAR(outputs[o], expected[o], 1e-4 * (1. + std::abs(expected[o])));
+            }
+        }
+    }
+
+    TEST(testTrajectoryTable, bending_accuracy)
+    {
+        auto table = Table{};
+        SetAxes(table);
+        table.Generate(Bending);
+
+        Double_t expected[Table::NOutputs];
+        Double_t outputs[Table::NOutputs];
+        for (const auto& state : RandomStates(1000))
+        {
+            Bending(state.data(), expected);
+            ASSERT_TRUE(table.Interpolate(state.data(), outputs));
+            EXPECT_NEAR(outputs[0], expected[0], 0.05);
+            EXPECT_NEAR(outputs[1], expected[1], 1e-3);
+            EXPECT_NEAR(outputs[2], expected[2], 1e-3);
+            EXPECT_NEAR(outputs[4], expected[4], 0.1);
+        }
+    }
+
+    TEST(testTrajectoryTable, threads_identical)
+    {
+        auto single = Table{};
+        SetAxes(single);
+        single.Generate(Bending, 1);
+        auto threaded = Table{};
+        SetAxes(threaded);
+        threaded.Generate(Bending, 4);
+
+        Double_t outputs1[Table::NOutputs];
+        Double_t outputs2[Table::NOutputs];
+        for (const auto& state : RandomStates(100))
+        {
+            ASSERT_TRUE(single.Interpolate(state.data(), outputs1));
+            ASSERT_TRUE(threaded.Interpolate(state.data(), outputs2));
+            for (Int_t o = 0; o < Table::NOutputs; o++)
+            {
+                EXPECT_EQ(outputs1[o], outputs2[o]);
+            }
+        }
+    }
+
+    TEST(testTrajectoryTable, outside_and_failed_nodes)
+    {
+        auto table = Table{};
+        SetAxes(table);
+        // Transport fails for all nodes at x = 30 cm
+        table.Generate([](const Double_t* in, Double_t* out) { return in[0] < 29.9 && Multilinear(in, out); });
+
+        Double_t outputs[Table::NOutputs];
+        Double_t state[Table::kNVariables] = { 0., 0., 0.25, 0., 0.3 };
+        EXPECT_TRUE(table.Interpolate(state, outputs));
+        state[Table::kX] = 20.; // on the last good node
+        EXPECT_TRUE(table.Interpolate(state, outputs));
+        state[Table::kX] = 25.; // next to a failed node
+        EXPECT_FALSE(table.Interpolate(state, outputs));
+        state[Table::kX] = 0.;
+        state[Table::kK] = 0.5; // outside of the grid
+        EXPECT_FALSE(table.Interpolate(state, outputs));
+        state[Table::kK] = 0.3;
+        state[Table::kTy] = -0.06;
+        EXPECT_FALSE(table.Interpolate(state, outputs));
+    }
+
+    TEST(testTrajectoryTable, persistence)
+    {
+        auto table = Table{};
+        SetAxes(table);
+        table.Generate(Bending);
+
+        auto file = TMemFile("trajectoryTable.root", "RECREATE");
+        table.Write(Table::ForwardName);
+        auto read = std::unique_ptr<Table>(file.Get<Table>(Table::ForwardName));
+        ASSERT_NE(read, nullptr);
+        EXPECT_EQ(read->GetNNodes(), table.GetNNodes());
+        EXPECT_FALSE(read->IsBackward());
+
+        Double_t outputs1[Table::NOutputs];
+        Double_t outputs2[Table::NOutputs];
+        for (const auto& state : RandomStates(100))
+        {
+            ASSERT_TRUE(table.Interpolate(state.data(), outputs1));
+            ASSERT_TRUE(read->Interpolate(state.data(), outputs2));
+            for (Int_t o = 0; o < Table::NOutputs; o++)
+            {
+                EXPECT_EQ(outputs1[o], outputs2[o]);
+            }
+        }
+    }
+} // namespace
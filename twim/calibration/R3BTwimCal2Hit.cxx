@@ -19,14 +19,12 @@
 // ROOT headers
 #include <TCanvas.h>
 #include <TClonesArray.h>
-#include <TDecompSVD.h>
 #include <TH1F.h>
 #include <TH2F.h>
 #include <TMath.h>
-#include <TMatrixD.h>
 #include <TRandom.h>
 #include <TVector3.h>
-#include <TVectorD.h>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 
@@ -121,6 +119,13 @@ void R3BTwimCal2Hit::SetParameter()
             StatusAnodes[s][i] = fCal_Par->GetInUse(s + 1, i + 1);
         }
 
+    // Same anode positions in all sections
+    for (Int_t i = 0; i < fNumAnodes; i++)
+    {
+        fPosAnodes[i] = fCal_Par->GetAnodePos(i + 1);
+    }
+    fAngleFit.SetPositions(fPosAnodes, fNumAnodes);
+
     if (fHitItemsTofW)
     {
         R3BLOG(info, "Nb parameters for charge-Z vs Tof correction: " << fNumParamsTof);
@@ -130,6 +135,17 @@ void R3BTwimCal2Hit::SetParameter()
         CalZTofParams = fCal_Par->GetZTofHitPar(); // Array with the Cal parameters
     }
 
+    // Tabulated energy vs drift time corrections
+    fSplines.assign(fNumSec, {});
+    for (Int_t s = 0; s < fNumSec && fHitItemsTofW; s++)
+    {
+        if (auto* spline = fCal_Par->GetSpline(s + 1))
+        {
+            fSplines[s] = R3B::IonChamber::Spline(*spline);
+        }
+        R3BLOG_IF(warn, fExpId == 4551 && fSplines[s].IsEmpty(), "No spline for section " << s + 1);
+    }
+
     R3BLOG(info, "Nb parameters for charge-Z: " << fNumParams);
     CalZParams = new TArrayF();
     Int_t array_size = fNumSec * fNumParams;
@@ -140,6 +156,7 @@ void R3BTwimCal2Hit::SetParameter()
     for (Int_t s = 0; s < fNumSec; s++)
     {
         // Parameters detector
+        std::fill(std::begin(fZPar[s]), std::end(fZPar[s]), 0.f);
         fEmean_tof[s] = fCal_Par->GetEmean_tof(s + 1);
         fEmean_dt[s] = fCal_Par->GetEmean_dt(s + 1);
         if (fNumParams == 2)
@@ -147,8 +164,8 @@ void R3BTwimCal2Hit::SetParameter()
             R3BLOG(info,
                    "Parameters for charge-Z:" << CalZParams->GetAt(s * fNumParams) << " : "
                                               << CalZParams->GetAt(s * fNumParams + 1));
-            fZ0[s] = CalZParams->GetAt(s * fNumParams);
-            fZ1[s] = CalZParams->GetAt(s * fNumParams + 1);
+            fZPar[s][0] = CalZParams->GetAt(s * fNumParams);
+            fZPar[s][1] = CalZParams->GetAt(s * fNumParams + 1);
         }
         else if (fNumParams == 3)
         {
@@ -159,9 +176,9 @@ void R3BTwimCal2Hit::SetParameter()
                                                          << CalZParams->GetAt(s * fNumParams + 1) << " : "
                                                          << CalZParams->GetAt(s * fNumParams + 2));
             }
-            fZ0[s] = CalZParams->GetAt(s * fNumParams);
-            fZ1[s] = CalZParams->GetAt(s * fNumParams + 1);
-            fZ2[s] = CalZParams->GetAt(s * fNumParams + 2);
+            fZPar[s][0] = CalZParams->GetAt(s * fNumParams);
+            fZPar[s][1] = CalZParams->GetAt(s * fNumParams + 1);
+            fZPar[s][2] = CalZParams->GetAt(s * fNumParams + 2);
         }
         else if (fNumParams == 4)
         {
@@ -173,10 +190,10 @@ void R3BTwimCal2Hit::SetParameter()
                                                          << CalZParams->GetAt(s * fNumParams + 2) << " : "
                                                          << CalZParams->GetAt(s * fNumParams + 3));
             }
-            fZ0[s] = CalZParams->GetAt(s * fNumParams);
-            fZ1[s] = CalZParams->GetAt(s * fNumParams + 1);
-            fZ2[s] = CalZParams->GetAt(s * fNumParams + 2);
-            fZ3[s] = CalZParams->GetAt(s * fNumParams + 3);
+            fZPar[s][0] = CalZParams->GetAt(s * fNumParams);
+            fZPar[s][1] = CalZParams->GetAt(s * fNumParams + 1);
+            fZPar[s][2] = CalZParams->GetAt(s * fNumParams + 2);
+            fZPar[s][3] = CalZParams->GetAt(s * fNumParams + 3);
         }
         else if (fNumParams == 5)
         {
@@ -188,11 +205,11 @@ void R3BTwimCal2Hit::SetParameter()
                            << " : " << CalZParams->GetAt(s * fNumParams + 2) << " : "
                            << CalZParams->GetAt(s * fNumParams + 3) << " : " << CalZParams->GetAt(s * fNumParams + 4));
             }
-            fZ0[s] = CalZParams->GetAt(s * fNumParams);
-            fZ1[s] = CalZParams->GetAt(s * fNumParams + 1);
-            fZ2[s] = CalZParams->GetAt(s * fNumParams + 2);
-            fZ3[s] = CalZParams->GetAt(s * fNumParams + 3);
-            fZ4[s] = CalZParams->GetAt(s * fNumParams + 4);
+            fZPar[s][0] = CalZParams->GetAt(s * fNumParams);
+            fZPar[s][1] = CalZParams->GetAt(s * fNumParams + 1);
+            fZPar[s][2] = CalZParams->GetAt(s * fNumParams + 2);
+            fZPar[s][3] = CalZParams->GetAt(s * fNumParams + 3);
+            fZPar[s][4] = CalZParams->GetAt(s * fNumParams + 4);
         }
         else
             R3BLOG(warn, "Parameters for charge-Z cannot be used here, number of parameters: " << fNumParams);
@@ -458,6 +475,7 @@ void R3BTwimCal2Hit::S4551()
             fNumAnodesAngleFit = 0;
             Double_t dt_ref = 0.;
             Double_t Xfit[fNumAnodes];
+            fAngleFit.Clear();
 
             for (Int_t j = 0; j < fNumAnodes; j++)
             {
@@ -473,29 +491,18 @@ void R3BTwimCal2Hit::S4551()
                         if (j == 7)
                             dt_ref = dt[i][j];
                     }
-                    fPosAnodes[fNumAnodesAngleFit] = fCal_Par->GetAnodePos(j + 1);
+                    fAngleFit.Add(j, dt[i][j]);
                     fNumAnodesAngleFit++;
                     nba++;
                 }
             } // loop fNumAnodes
             if (nba > 3 && (Esum / nba) > 0.)
             {
-                if (fNumAnodesAngleFit > 8)
+                if (fNumAnodesAngleFit > 8 && fAngleFit.Solve(offset, theta))
                 {
-                    fPosZ.Use(fNumAnodesAngleFit, fPosAnodes);
-                    TMatrixD A(fNumAnodesAngleFit, 2);
-                    TMatrixDColumn(A, 0) = 1.0;
-                    TMatrixDColumn(A, 1) = fPosZ;
-                    TDecompSVD svd(A);
-                    Bool_t ok;
-                    TVectorD dt_r;
-                    dt_r.Use(fNumAnodesAngleFit, good_dt);
-                    TVectorD c_svd_r = svd.Solve(dt_r, ok);
-                    offset = c_svd_r[0];
-                    theta = c_svd_r[1];
                     for (Int_t y = 0; y < fNumAnodesAngleFit; y++)
                     {
-                        Xfit[y] = c_svd_r[0] + c_svd_r[1] * fPosAnodes[y];
+                        Xfit[y] = offset + theta * fPosAnodes[fIndex[y]];
                         if (fDebug)
                         {
                             dx[i * fNumAnodes + fIndex[y]]->Fill(Xfit[y] - good_dt[y]);
@@ -510,18 +517,15 @@ void R3BTwimCal2Hit::S4551()
                                 (CalZTofParams->GetAt(i * fNumParamsTof) +
                                  CalZTofParams->GetAt(i * fNumParamsTof + 1) * tof[i] +
                                  CalZTofParams->GetAt(i * fNumParamsTof + 2) * tof[i] * tof[i]);
-                    TSpline3* spl = fCal_Par->GetSpline(i + 1);
-                    Esum_mean = fEmean_dt[i] * Esum_mean / spl->Eval(dt_ref);
-                    Double_t zhit = fZ0[i] + fZ1[i] * TMath::Sqrt(Esum_mean) + fZ2[i] * Esum_mean +
-                                    fZ3[i] * TMath::Power(Esum_mean, 3. / 2.) + fZ4[i] * TMath::Power(Esum_mean, 2.);
+                    Esum_mean = fEmean_dt[i] * Esum_mean / fSplines[i].Eval(dt_ref);
+                    Double_t zhit = R3B::IonChamber::Polynomial(std::sqrt(Esum_mean), fZPar[i], 5);
                     if (zhit > 0)
                         AddHitData(i + 1, theta, zhit, dt_ref, offset, Esum_mean);
                 }
                 else
                 {
                     Double_t Esum_mean = Esum / nba;
-                    Double_t zhit = fZ0[i] + fZ1[i] * TMath::Sqrt(Esum_mean) + fZ2[i] * Esum_mean +
-                                    fZ3[i] * TMath::Power(Esum_mean, 3. / 2.) + fZ4[i] * TMath::Power(Esum_mean, 2.);
+                    Double_t zhit = R3B::IonChamber::Polynomial(std::sqrt(Esum_mean), fZPar[i], 5);
                     if (zhit > 0)
                         AddHitData(i + 1, theta, zhit, dt_ref, offset, Esum_mean);
                 }
@@ -619,6 +623,7 @@ void R3BTwimCal2Hit::S455()
     {
         Double_t nba = 0, offset = 0., theta = -5000., Esum = 0.;
         fNumAnodesAngleFit = 0;
+        fAngleFit.Clear();
         for (Int_t j = 0; j < fNumAnodes; j++)
         {
             // if(i==0){
@@ -631,9 +636,9 @@ void R3BTwimCal2Hit::S455()
                 Esum += energyperanode[i][j];
                 if (dt[i][j] > 0.)
                     good_dt[fNumAnodesAngleFit] = dt[i][j];
-                else if (dt[i + 1][j] > 0.)
+                else if (i + 1 < fNumSec && dt[i + 1][j] > 0.)
                     good_dt[fNumAnodesAngleFit] = dt[i + 1][j];
-                fPosAnodes[fNumAnodesAngleFit] = fCal_Par->GetAnodePos(j + 1);
+                fAngleFit.Add(j, good_dt[fNumAnodesAngleFit]);
                 fNumAnodesAngleFit++;
                 nba++;
                 // std::cout<< i <<" "<< j <<" "<< energyperanode[i][j] <<std::endl;
@@ -658,17 +663,7 @@ void R3BTwimCal2Hit::S455()
         {
             if (fNumAnodesAngleFit > 8)
             {
-                fPosZ.Use(fNumAnodesAngleFit, fPosAnodes);
-                TMatrixD A(fNumAnodesAngleFit, 2);
-                TMatrixDColumn(A, 0) = 1.0;
-                TMatrixDColumn(A, 1) = fPosZ;
-                TDecompSVD svd(A);
-                Bool_t ok;
-                TVectorD dt_r;
-                dt_r.Use(fNumAnodesAngleFit, good_dt);
-                TVectorD c_svd_r = svd.Solve(dt_r, ok);
-                offset = c_svd_r[0];
-                theta = c_svd_r[1];
+                fAngleFit.Solve(offset, theta);
             }
             if (CalZTofParams)
             {
@@ -682,7 +677,7 @@ void R3BTwimCal2Hit::S455()
                                              CalZTofParams->GetAt(i * fNumParams + 1) * tof[1] +
                                              CalZTofParams->GetAt(i * fNumParams + 2) * tof[1] * tof[1]);
 
-                Double_t zhit = fZ0[i] + fZ1[i] * TMath::Sqrt(Esum_mean) + fZ2[i] * Esum_mean;
+                Double_t zhit = R3B::IonChamber::Polynomial(std::sqrt(Esum_mean), fZPar[i], 3);
                 // if (zhit > 0 && theta > -5000.)
                 if (zhit > 0 && !TMath::IsNaN(good_dt[7]))
                     AddHitData(i + 1, theta, zhit, good_dt[7], offset, Esum_mean);
@@ -690,7 +685,7 @@ void R3BTwimCal2Hit::S455()
             else
             {
                 Double_t Esum_mean = Esum / nba;
-                Double_t zhit = fZ0[i] + fZ1[i] * TMath::Sqrt(Esum_mean) + fZ2[i] * Esum_mean;
+                Double_t zhit = R3B::IonChamber::Polynomial(std::sqrt(Esum_mean), fZPar[i], 3);
                 // if (zhit > 0 && theta > -5000.)
                 if (zhit > 0 && !TMath::IsNaN(good_dt[7]))
                     AddHitData(i + 1, theta, zhit, good_dt[7], offset, Esum_mean);
@@ -746,13 +741,14 @@ void R3BTwimCal2Hit::S467()
     {
         Double_t nba = 0., offset = 0., theta = -5000., Esum = 0.;
         fNumAnodesAngleFit = 0;
+        fAngleFit.Clear();
         for (Int_t j = 0; j < fNumAnodes; j++)
         {
             if (energyperanode[i][j] > 0 && energyperanode[i][j] < 8192 && StatusAnodes[i][j] == 1)
             {
                 Esum = Esum + energyperanode[i][j];
                 good_dt[fNumAnodesAngleFit] = dt[i][j];
-                fPosAnodes[fNumAnodesAngleFit] = fCal_Par->GetAnodePos(j + 1);
+                fAngleFit.Add(j, dt[i][j]);
                 fNumAnodesAngleFit++;
                 nba++;
             }
@@ -762,20 +758,9 @@ void R3BTwimCal2Hit::S467()
         {
             if (fNumAnodesAngleFit > 4)
             {
-                fPosZ.Use(fNumAnodesAngleFit, fPosAnodes);
-                TMatrixD A(fNumAnodesAngleFit, 2);
-                TMatrixDColumn(A, 0) = 1.0;
-                TMatrixDColumn(A, 1) = fPosZ;
-                TDecompSVD svd(A);
-                Bool_t ok;
-                TVectorD dt_r;
-                dt_r.Use(fNumAnodesAngleFit, good_dt);
-                TVectorD c_svd_r = svd.Solve(dt_r, ok);
-                offset = c_svd_r[0];
-                theta = c_svd_r[1];
+                fAngleFit.Solve(offset, theta);
             }
-            double zhit =
-                fZ0[i] + fZ1[i] * TMath::Sqrt(Esum / nba) + fZ2[i] * TMath::Sqrt(Esum / nba) * TMath::Sqrt(Esum / nba);
+            double zhit = R3B::IonChamber::Polynomial(std::sqrt(Esum / nba), fZPar[i], 3);
             if (zhit > 0 && theta > -5000. && good_dt[7] != std::nan("") && nba > 0) // NOLINT
                 AddHitData(i + 1, theta, zhit, good_dt[7], offset, Esum / nba);
         }
@@ -19,13 +19,14 @@
 #pragma once
 
 #include "FairTask.h"
+#include "R3BIonChamberFit.h"
 #include "R3BLogger.h"
 #include "R3BTwimHitData.h"
 #include "TCanvas.h"
 #include "TH1F.h"
 #include "TH2F.h"
-#include "TVectorD.h"
 #include <TRandom.h>
+#include <vector>
 
 class TClonesArray;
 class R3BTwimHitPar;
@@ -99,14 +100,15 @@ class R3BTwimCal2Hit : public FairTask
     Int_t fNumParamsTof;
     Int_t fNumParams;
     Int_t fMaxEnergyperanode;
-    Float_t fZ0[4], fZ1[4], fZ2[4], fZ3[4], fZ4[4];
+    Float_t fZPar[4][5];       // Charge-Z calibration, polynomial in sqrt(E)
     Int_t StatusAnodes[4][16]; // Sections and anodes
     Double_t fPosAnodes[16];   // Position-Z of each anode
     TArrayF* CalZTofParams;
     TArrayF* CalZParams;
     Float_t fEmean_tof[4];
     Float_t fEmean_dt[4];
-    TVectorD fPosZ;
+    R3B::IonChamber::LineFit<16> fAngleFit;       //! Drift time vs position of the anodes
+    std::vector<R3B::IonChamber::Spline> fSplines; //! Energy vs drift time corrections per section
 
     R3BTwimHitPar* fCal_Par;      /**< Parameter container. >*/
     TClonesArray* fTwimCalDataCA; /**< Array with Twim Cal-input data. >*/